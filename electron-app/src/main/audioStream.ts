@@ -0,0 +1,251 @@
+// 下发到设备的实时音频流（TTS 回复、音乐），设备端作为桌面音箱播放
+//
+// 帧格式 v1（二进制）:
+//   [0]    tag 0x41 ('A')
+//   [1]    streamId（audio_stream_start 中分配）
+//   [2]    flags: bit0 本流最后一帧
+//   [3]    保留 (0)
+//   [4..7] 帧号 (uint32 LE)，第 n 帧对应发送端第 n * frameSamples 个样本
+//   之后为一个 IMA-ADPCM 分片（单声道，见 imaAdpcm.ts）
+// 设备端按帧号放入抖动缓冲，并以帧号推算发送端时钟做漂移补偿，
+// 所以发送端必须按实时节奏发帧，不能一次性灌入。
+// 固件侧解析见 esp32-firmware/src/net/audio_stream.h，两边需保持一致。
+
+import { createImaAdpcmState, encodeImaAdpcmChunk, type ImaAdpcmState } from './imaAdpcm.js'
+
+export const AUDIO_STREAM_VERSION = 1
+export const AUDIO_STREAM_FRAME_TAG = 0x41
+export const AUDIO_STREAM_HEADER_BYTES = 8
+export const AUDIO_STREAM_FLAG_LAST = 0x01
+export const AUDIO_STREAM_CODEC = 'ima_adpcm'
+export const AUDIO_STREAM_DEFAULT_FRAME_MS = 20
+export const AUDIO_STREAM_DEFAULT_MAX_SAMPLE_RATE = 48000
+
+// 开头先连发几帧，设备更快攒够目标深度
+const PREROLL_FRAMES = 3
+const TICK_MS = 5
+
+export interface AudioStreamCaps {
+  maxSampleRate: number
+  frameMs: number
+}
+
+// 解析设备握手中的 audioStream 能力；不支持时返回 undefined
+export const parseAudioStreamCaps = (caps: any): AudioStreamCaps | undefined => {
+  if (Number(caps?.version) !== AUDIO_STREAM_VERSION) {
+    return undefined
+  }
+  const codecs: unknown[] = Array.isArray(caps?.codecs) ? caps.codecs : []
+  if (!codecs.includes(AUDIO_STREAM_CODEC)) {
+    return undefined
+  }
+  const maxSampleRate = Number(caps.maxSampleRate) || AUDIO_STREAM_DEFAULT_MAX_SAMPLE_RATE
+  const frameMs = Number(caps.frameMs) || AUDIO_STREAM_DEFAULT_FRAME_MS
+  return { maxSampleRate, frameMs }
+}
+
+export const buildAudioStreamFrame = (streamId: number, frame: number, last: boolean, chunk: Buffer): Buffer => {
+  const header = Buffer.alloc(AUDIO_STREAM_HEADER_BYTES)
+  header[0] = AUDIO_STREAM_FRAME_TAG
+  header[1] = streamId & 0xff
+  header[2] = last ? AUDIO_STREAM_FLAG_LAST : 0
+  header[3] = 0
+  header.writeUInt32LE(frame >>> 0, 4)
+  return Buffer.concat([header, chunk])
+}
+
+export interface PcmAudio {
+  sampleRate: number
+  samples: Int16Array // 单声道
+}
+
+// 解析 16 bit PCM WAV，多声道取平均混成单声道
+export const parseWavPcm16 = (data: Buffer): PcmAudio | null => {
+  if (data.length < 12 || data.toString('ascii', 0, 4) !== 'RIFF' || data.toString('ascii', 8, 12) !== 'WAVE') {
+    return null
+  }
+
+  let offset = 12
+  let sampleRate = 0
+  let channels = 0
+  let bits = 0
+  while (offset + 8 <= data.length) {
+    const id = data.toString('ascii', offset, offset + 4)
+    const size = data.readUInt32LE(offset + 4)
+    const body = offset + 8
+    if (id === 'fmt ' && size >= 16) {
+      const format = data.readUInt16LE(body)
+      channels = data.readUInt16LE(body + 2)
+      sampleRate = data.readUInt32LE(body + 4)
+      bits = data.readUInt16LE(body + 14)
+      if (format !== 1 && format !== 0xfffe) {
+        return null
+      }
+    } else if (id === 'data') {
+      if (bits !== 16 || channels <= 0 || sampleRate <= 0) {
+        return null
+      }
+      const end = Math.min(data.length, body + size)
+      const frames = Math.floor((end - body) / (2 * channels))
+      const samples = new Int16Array(frames)
+      for (let i = 0; i < frames; i += 1) {
+        let sum = 0
+        for (let c = 0; c < channels; c += 1) {
+          sum += data.readInt16LE(body + (i * channels + c) * 2)
+        }
+        samples[i] = Math.round(sum / channels)
+      }
+      return { sampleRate, samples }
+    }
+    offset = body + size + (size & 1)
+  }
+  return null
+}
+
+// 线性插值重采样，仅在源采样率超过设备上限时使用
+export const resamplePcm = (audio: PcmAudio, targetRate: number): PcmAudio => {
+  if (audio.sampleRate === targetRate || audio.samples.length === 0) {
+    return audio
+  }
+  const ratio = audio.sampleRate / targetRate
+  const length = Math.floor(audio.samples.length / ratio)
+  const out = new Int16Array(length)
+  for (let i = 0; i < length; i += 1) {
+    const pos = i * ratio
+    const index = Math.floor(pos)
+    const next = Math.min(index + 1, audio.samples.length - 1)
+    const frac = pos - index
+    out[i] = Math.round(audio.samples[index] * (1 - frac) + audio.samples[next] * frac)
+  }
+  return { sampleRate: targetRate, samples: out }
+}
+
+export interface AudioStreamSenderStats {
+  framesSent: number
+  bytesSent: number
+  stalls: number // 源数据未就绪导致的节奏重置次数
+  firstFrameAt: number // 首帧发出时间 (Date.now)，未发出为 0
+}
+
+// 按实时节奏发送音频帧。PCM 可以分批 push（例如边合成边播放），
+// 全部 push 完后调用 end()，最后一帧带 LAST 标记；发送结束或失败时回调 onFinished。
+export class AudioStreamSender {
+  private readonly frameSamples: number
+  private readonly frameMs: number
+  private readonly encoder: ImaAdpcmState = createImaAdpcmState()
+  private pending: Int16Array[] = []
+  private pendingSamples = 0
+  private pendingOffset = 0
+  private ended = false
+  private stalled = false
+  private frame = 0
+  private startedAt = 0
+  private timer: NodeJS.Timeout | null = null
+  private readonly stats: AudioStreamSenderStats = { framesSent: 0, bytesSent: 0, stalls: 0, firstFrameAt: 0 }
+
+  constructor(
+    readonly streamId: number,
+    readonly sampleRate: number,
+    frameMs: number,
+    private readonly send: (frame: Buffer) => boolean,
+    private readonly onFinished: (stats: AudioStreamSenderStats) => void,
+  ) {
+    this.frameSamples = Math.round((sampleRate * frameMs) / 1000)
+    this.frameMs = (this.frameSamples * 1000) / sampleRate
+  }
+
+  public get samplesPerFrame(): number {
+    return this.frameSamples
+  }
+
+  public push(samples: Int16Array): void {
+    if (this.ended || samples.length === 0) return
+    this.pending.push(samples)
+    this.pendingSamples += samples.length
+  }
+
+  public end(): void {
+    this.ended = true
+  }
+
+  public start(): void {
+    if (this.timer) return
+    this.startedAt = performance.now() - PREROLL_FRAMES * this.frameMs
+    this.timer = setInterval(() => this.tick(), TICK_MS)
+    this.tick()
+  }
+
+  public stop(): void {
+    if (this.timer) {
+      clearInterval(this.timer)
+      this.timer = null
+    }
+  }
+
+  public summary(): AudioStreamSenderStats {
+    return { ...this.stats }
+  }
+
+  private tick(): void {
+    const due = Math.floor((performance.now() - this.startedAt) / this.frameMs) + 1
+    while (this.frame < due) {
+      const available = this.pendingSamples - this.pendingOffset
+      if (available < this.frameSamples && !this.ended) {
+        // 源数据跟不上：节奏顺延，数据到达后立即续发而不是集中补发
+        this.startedAt = performance.now() - this.frame * this.frameMs
+        if (!this.stalled) {
+          this.stalled = true
+          this.stats.stalls += 1
+        }
+        return
+      }
+      this.stalled = false
+      if (available === 0) {
+        this.finish()
+        return
+      }
+
+      const count = Math.min(available, this.frameSamples)
+      const last = this.ended && available <= this.frameSamples
+      const chunk = encodeImaAdpcmChunk(this.encoder, this.take(count))
+      const payload = buildAudioStreamFrame(this.streamId, this.frame, last, chunk)
+      if (!this.send(payload)) {
+        this.finish()
+        return
+      }
+      if (this.stats.framesSent === 0) {
+        this.stats.firstFrameAt = Date.now()
+      }
+      this.stats.framesSent += 1
+      this.stats.bytesSent += payload.length
+      this.frame += 1
+      if (last) {
+        this.finish()
+        return
+      }
+    }
+  }
+
+  private take(count: number): Int16Array {
+    const out = new Int16Array(count)
+    let written = 0
+    while (written < count) {
+      const head = this.pending[0]
+      const n = Math.min(count - written, head.length - this.pendingOffset)
+      out.set(head.subarray(this.pendingOffset, this.pendingOffset + n), written)
+      written += n
+      this.pendingOffset += n
+      if (this.pendingOffset >= head.length) {
+        this.pending.shift()
+        this.pendingSamples -= head.length
+        this.pendingOffset = 0
+      }
+    }
+    return out
+  }
+
+  private finish(): void {
+    this.stop()
+    this.onFinished(this.summary())
+  }
+}
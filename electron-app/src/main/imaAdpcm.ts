@@ -0,0 +1,127 @@
+// IMA-ADPCM 编解码（4 bit/样本，约 4:1）：解码设备麦克风流，编码下发到设备的音频流
+//
+// 每个分片自带解码起点，丢片不会导致后续失步：
+//   [0..1] 分片起始预测值 (int16 LE)
+//   [2]    分片起始步长索引
+//   [3]    保留 (0)
+//   之后每字节两个样本，先低 4 位后高 4 位
+// 固件侧实现见 esp32-firmware/src/audio/ima_adpcm.h，两边需保持一致。
+
+export const VOICE_FORMAT_PCM = 'pcm_s16le'
+export const VOICE_FORMAT_IMA_ADPCM = 'ima_adpcm'
+export const VOICE_SUPPORTED_FORMATS = [VOICE_FORMAT_IMA_ADPCM, VOICE_FORMAT_PCM]
+
+export const IMA_ADPCM_HEADER_BYTES = 4
+
+const STEPS = [
+  7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+  50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+  253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+  1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+  3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+  11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+  32767,
+]
+
+const INDEX_ADJUST = [-1, -1, -1, -1, 2, 4, 6, 8]
+
+// 设备端期望的编码分片长度（samples 个样本）
+export const imaAdpcmChunkBytes = (samples: number): number =>
+  IMA_ADPCM_HEADER_BYTES + Math.ceil(samples / 2)
+
+// 返回 PCM s16le；分片格式错误返回 null
+export const decodeImaAdpcmChunk = (chunk: Buffer, samples: number): Buffer | null => {
+  if (chunk.length !== imaAdpcmChunkBytes(samples)) {
+    return null
+  }
+
+  let predictor = chunk.readInt16LE(0)
+  let index = chunk[2]
+  if (index > 88) {
+    return null
+  }
+
+  const out = Buffer.allocUnsafe(samples * 2)
+  for (let i = 0; i < samples; i += 1) {
+    const byte = chunk[IMA_ADPCM_HEADER_BYTES + (i >> 1)]
+    const code = (i & 1) === 0 ? byte & 0x0f : byte >> 4
+    const step = STEPS[index]
+
+    let delta = step >> 3
+    if (code & 4) delta += step
+    if (code & 2) delta += step >> 1
+    if (code & 1) delta += step >> 2
+    predictor += (code & 8) ? -delta : delta
+    predictor = Math.max(-32768, Math.min(32767, predictor))
+
+    index = Math.max(0, Math.min(88, index + INDEX_ADJUST[code & 7]))
+    out.writeInt16LE(predictor, i * 2)
+  }
+  return out
+}
+
+export interface ImaAdpcmState {
+  predictor: number
+  index: number
+}
+
+export const createImaAdpcmState = (): ImaAdpcmState => ({ predictor: 0, index: 0 })
+
+const encodeSample = (state: ImaAdpcmState, sample: number): number => {
+  const step = STEPS[state.index]
+  let diff = sample - state.predictor
+  let code = 0
+  if (diff < 0) {
+    code = 8
+    diff = -diff
+  }
+
+  // 与解码端相同的重建方式，保证两边预测值一致
+  let delta = step >> 3
+  if (diff >= step) {
+    code |= 4
+    diff -= step
+    delta += step
+  }
+  if (diff >= (step >> 1)) {
+    code |= 2
+    diff -= step >> 1
+    delta += step >> 1
+  }
+  if (diff >= (step >> 2)) {
+    code |= 1
+    delta += step >> 2
+  }
+
+  state.predictor = Math.max(-32768, Math.min(32767, state.predictor + ((code & 8) ? -delta : delta)))
+  state.index = Math.max(0, Math.min(88, state.index + INDEX_ADJUST[code & 7]))
+  return code
+}
+
+// 编码一个分片；state 跨分片延续，分片头记录起点以便单独解码
+export const encodeImaAdpcmChunk = (state: ImaAdpcmState, pcm: Int16Array): Buffer => {
+  const out = Buffer.alloc(imaAdpcmChunkBytes(pcm.length))
+  out.writeInt16LE(state.predictor, 0)
+  out[2] = state.index
+  out[3] = 0
+
+  for (let i = 0; i < pcm.length; i += 2) {
+    let packed = encodeSample(state, pcm[i])
+    if (i + 1 < pcm.length) {
+      packed |= encodeSample(state, pcm[i + 1]) << 4
+    }
+    out[IMA_ADPCM_HEADER_BYTES + (i >> 1)] = packed
+  }
+  return out
+}
+
+// 优先采用设备声明列表中服务端支持的第一个格式，旧固件只带 format 字段
+export const selectVoiceFormat = (offered: unknown, preferred: unknown): string => {
+  const candidates = Array.isArray(offered) ? offered : [preferred]
+  for (const candidate of candidates) {
+    if (typeof candidate === 'string' && VOICE_SUPPORTED_FORMATS.includes(candidate)) {
+      return candidate
+    }
+  }
+  return VOICE_FORMAT_PCM
+}
@@ -4,6 +4,7 @@ import path from 'path'
 import { fileURLToPath } from 'url'
 import { DeviceWebSocketServer, type PhotoFrameSettings } from './websocket.js'
 import { AISimulator } from './ai-simulator.js'
+import { parseWavPcm16 } from './audioStream.js'
 import fs from 'fs/promises'
 import { existsSync } from 'fs'
 import crypto from 'crypto'
@@ -659,17 +660,32 @@ function setupIpcHandlers() {
     const deviceId = typeof payload?.deviceId === 'string' ? payload.deviceId.trim() : undefined
 
     try {
-      const pageLimit = 24
+      const pageLimit = 64
       const maxPages = 10
       const sourceFiles: Array<Record<string, unknown>> = []
       let page = 0
       let requestOffset = 0
+      let requestCursor = ''
+      let cursorRestarts = 0
       let truncated = true
       let totalFromDevice = 0
       let activeDeviceId: string | undefined = undefined
 
       while (truncated && page < maxPages) {
-        const result = await wsServer.requestSdFileList(deviceId, 12000, requestOffset, pageLimit)
+        const result = await wsServer.requestSdFileList(deviceId, 12000, requestOffset, pageLimit, {
+          cursor: requestCursor,
+          dir: rootPath,
+        })
+        if (result?.cursorExpired && cursorRestarts < 1) {
+          // 设备端快照已变更，游标失效，从头重新分页
+          cursorRestarts += 1
+          sourceFiles.length = 0
+          requestOffset = 0
+          requestCursor = ''
+          totalFromDevice = 0
+          page = 0
+          continue
+        }
         if (!result?.success) {
           return {
             success: false,
@@ -706,6 +722,7 @@ function setupIpcHandlers() {
         }
 
         requestOffset += returned > 0 ? returned : batchFiles.length
+        requestCursor = typeof result.nextCursor === 'string' ? result.nextCursor : ''
         const totalRaw = Number(result.total)
         if (Number.isFinite(totalRaw) && totalRaw >= 0) {
           totalFromDevice = Math.max(totalFromDevice, Math.floor(totalRaw))
@@ -1158,6 +1175,43 @@ function setupIpcHandlers() {
       return { success: false, error: String(error) }
     }
   })
+
+  // 设备作为桌面音箱：把本地 WAV 实时推流到设备播放
+  ipcMain.handle('audio-stream-play-file', async (_event, payload: { filePath?: unknown; deviceId?: unknown } | undefined) => {
+    const filePath = typeof payload?.filePath === 'string' ? payload.filePath.trim() : ''
+    const deviceId = typeof payload?.deviceId === 'string' ? payload.deviceId.trim() : undefined
+    if (!filePath) {
+      return { success: false, error: 'filePath 为空' }
+    }
+
+    try {
+      const audio = parseWavPcm16(await fs.readFile(filePath))
+      if (!audio) {
+        return { success: false, error: '仅支持 16 bit PCM WAV' }
+      }
+      const result = await wsServer.playAudioOnDevice(audio, path.basename(filePath), deviceId)
+      return result?.success ? result : { ...result, success: false, error: result?.reason || '设备拒绝音频流' }
+    } catch (error) {
+      console.error('[AudioStream] 推流失败:', error)
+      return { success: false, error: String(error) }
+    }
+  })
+
+  ipcMain.handle('audio-stream-stop', async (_event, payload: { deviceId?: unknown } | undefined) => {
+    const deviceId = typeof payload?.deviceId === 'string' ? payload.deviceId.trim() : undefined
+    return { success: wsServer.stopAudioStream(deviceId) }
+  })
+
+  // 回复播报：文本合成语音后流式推送到设备
+  ipcMain.handle('tts-speak', async (_event, payload: { text?: unknown; deviceId?: unknown } | undefined) => {
+    const text = typeof payload?.text === 'string' ? payload.text : ''
+    const deviceId = typeof payload?.deviceId === 'string' ? payload.deviceId.trim() : undefined
+    try {
+      return await wsServer.speakOnDevice(text, deviceId)
+    } catch (error) {
+      return { success: false, reason: error instanceof Error ? error.message : String(error) }
+    }
+  })
 }
 
 app.on('window-all-closed', () => {
@@ -0,0 +1,108 @@
+// 紧凑的系统状态二进制流（握手协商后替代 JSON system_stats）
+//
+// 帧格式 v1:
+//   [0] tag 0x53 ('S')
+//   [1] flags: bit0 关键帧；bit1..4 字段存在位（cpu, memory, upload, download）
+//   [2] seq (uint8，每发送一帧 +1)
+//   之后按字段顺序：关键帧为无符号 LEB128 绝对值，增量帧为 zigzag LEB128 差值
+// 量化：cpu/memory 0.5% 一档，upload/download 0.1 KB/s 一档
+// 固件侧解码见 esp32-firmware/src/net/stats_stream.h，两边需保持一致。
+
+export const STATS_STREAM_VERSION = 1
+export const STATS_FRAME_TAG = 0x53
+export const STATS_FLAG_KEYFRAME = 0x01
+export const STATS_FIELD_COUNT = 4
+export const STATS_STREAM_MIN_RATE_HZ = 1
+export const STATS_STREAM_MAX_RATE_HZ = 10
+export const STATS_STREAM_DEFAULT_RATE_HZ = 2
+
+const MAX_PERCENT_Q = 200
+const MAX_RATE_Q = 10_000_000 // 1 GB/s 上限
+
+export interface StatsSample {
+  cpu: number
+  memory: number
+  upload: number
+  download: number
+}
+
+const clampQuantized = (value: number, scale: number, max: number): number => {
+  if (!Number.isFinite(value) || value <= 0) {
+    return 0
+  }
+  return Math.min(max, Math.round(value * scale))
+}
+
+export const quantizeStats = (sample: StatsSample): number[] => [
+  clampQuantized(sample.cpu, 2, MAX_PERCENT_Q),
+  clampQuantized(sample.memory, 2, MAX_PERCENT_Q),
+  clampQuantized(sample.upload, 10, MAX_RATE_Q),
+  clampQuantized(sample.download, 10, MAX_RATE_Q),
+]
+
+const pushVarint = (out: number[], value: number) => {
+  let v = value >>> 0
+  while (v >= 0x80) {
+    out.push((v & 0x7f) | 0x80)
+    v >>>= 7
+  }
+  out.push(v)
+}
+
+const zigzag = (value: number): number => ((value << 1) ^ (value >> 31)) >>> 0
+
+export const clampStatsRateHz = (value: unknown, fallback: number = STATS_STREAM_DEFAULT_RATE_HZ): number => {
+  const raw = Number(value)
+  if (!Number.isFinite(raw)) {
+    return fallback
+  }
+  return Math.max(STATS_STREAM_MIN_RATE_HZ, Math.min(STATS_STREAM_MAX_RATE_HZ, Math.round(raw)))
+}
+
+export class StatsStreamEncoder {
+  private last: number[] | null = null
+  private seq = 0
+  private framesSinceKeyframe = 0
+
+  constructor(private keyframeInterval: number) {}
+
+  public setKeyframeInterval(interval: number): void {
+    this.keyframeInterval = Math.max(1, Math.floor(interval))
+  }
+
+  public forceKeyframe(): void {
+    this.last = null
+  }
+
+  // 返回 null 表示无变化且未到关键帧周期，本次无需发送
+  public encode(sample: StatsSample): Buffer | null {
+    const values = quantizeStats(sample)
+    const keyframe = this.last === null || this.framesSinceKeyframe + 1 >= this.keyframeInterval
+
+    const body: number[] = []
+    let flags = keyframe ? STATS_FLAG_KEYFRAME : 0
+    for (let i = 0; i < STATS_FIELD_COUNT; i += 1) {
+      if (keyframe) {
+        flags |= 1 << (i + 1)
+        pushVarint(body, values[i])
+        continue
+      }
+      const delta = values[i] - (this.last as number[])[i]
+      if (delta !== 0) {
+        flags |= 1 << (i + 1)
+        pushVarint(body, zigzag(delta))
+      }
+    }
+
+    if (!keyframe && body.length === 0) {
+      this.framesSinceKeyframe += 1
+      return null
+    }
+
+    const frame = Buffer.from([STATS_FRAME_TAG, flags, this.seq & 0xff, ...body])
+    this.seq = (this.seq + 1) & 0xff
+    this.framesSinceKeyframe = keyframe ? 0 : this.framesSinceKeyframe + 1
+    this.last = values
+    return frame
+  }
+}
@@ -0,0 +1,109 @@
+// 回复语音合成（TTS）
+//
+// 引擎按块回调 PCM（单声道 s16），调用方拿到第一块就开始推流，
+// 不等整段合成完成。目前只有本地替身引擎：用合成的元音音节代替真实语音，
+// 节奏和分块方式接近流式云端 TTS，用来测端到端延迟。
+
+export interface TtsEngine {
+  readonly name: string
+  readonly sampleRate: number
+  // 每合成一块回调一次；signal 取消后尽快返回
+  synthesize(text: string, onChunk: (pcm: Int16Array) => void, signal: AbortSignal): Promise<void>
+}
+
+const CANNED_SAMPLE_RATE = 16000
+const CANNED_CHUNK_MS = 100
+const CANNED_FIRST_CHUNK_DELAY_MS = 60 // 模拟云端首包耗时
+const CANNED_CHUNK_DELAY_MS = 25 // 之后快于实时
+const CANNED_SYLLABLE_MS = 110
+const CANNED_GAP_MS = 70
+const CANNED_PAUSE_MS = 220
+const CANNED_MAX_MS = 15000
+
+// 几组元音共振峰 (F1, F2)
+const VOWELS: Array<[number, number]> = [
+  [730, 1090],
+  [530, 1840],
+  [270, 2290],
+  [570, 840],
+  [300, 870],
+]
+
+const sleep = (ms: number, signal: AbortSignal) =>
+  new Promise<void>((resolve) => {
+    if (signal.aborted) return resolve()
+    const timer = setTimeout(resolve, ms)
+    signal.addEventListener('abort', () => {
+      clearTimeout(timer)
+      resolve()
+    }, { once: true })
+  })
+
+// 每个字符一个音节，空格和标点为停顿
+export const renderCannedSpeech = (text: string, sampleRate: number = CANNED_SAMPLE_RATE): Int16Array => {
+  const parts: Int16Array[] = []
+  let total = 0
+  const push = (part: Int16Array) => {
+    parts.push(part)
+    total += part.length
+  }
+  const silence = (ms: number) => push(new Int16Array(Math.round((sampleRate * ms) / 1000)))
+
+  for (const ch of text.trim()) {
+    if (total >= (sampleRate * CANNED_MAX_MS) / 1000) break
+    if (/[\s]/.test(ch)) {
+      silence(CANNED_GAP_MS)
+      continue
+    }
+    if (/[,.!?;:，。！？；：、]/.test(ch)) {
+      silence(CANNED_PAUSE_MS)
+      continue
+    }
+
+    const code = ch.codePointAt(0) ?? 0
+    const [f1, f2] = VOWELS[code % VOWELS.length]
+    const pitch = 120 + (code % 7) * 6
+    const n = Math.round((sampleRate * CANNED_SYLLABLE_MS) / 1000)
+    const syllable = new Int16Array(n)
+    for (let i = 0; i < n; i += 1) {
+      const t = i / sampleRate
+      // 起音 10 ms、衰减到结尾，避免块边界爆音
+      const env = Math.min(1, i / (0.01 * sampleRate)) * (1 - i / n)
+      const f0 = pitch * (1 - 0.15 * (i / n))
+      let v = 0
+      for (let h = 1; h * f0 < 3500; h += 1) {
+        const f = h * f0
+        const gain = 1 / (1 + ((f - f1) / 120) ** 2) + 0.6 / (1 + ((f - f2) / 180) ** 2)
+        v += gain * Math.sin(2 * Math.PI * f * t)
+      }
+      syllable[i] = Math.max(-32768, Math.min(32767, Math.round(v * env * 5200)))
+    }
+    push(syllable)
+    silence(CANNED_GAP_MS / 2)
+  }
+
+  const out = new Int16Array(total)
+  let offset = 0
+  for (const part of parts) {
+    out.set(part, offset)
+    offset += part.length
+  }
+  return out
+}
+
+export class CannedTtsEngine implements TtsEngine {
+  readonly name = 'canned'
+  readonly sampleRate = CANNED_SAMPLE_RATE
+
+  async synthesize(text: string, onChunk: (pcm: Int16Array) => void, signal: AbortSignal): Promise<void> {
+    const pcm = renderCannedSpeech(text, this.sampleRate)
+    const chunkSamples = Math.round((this.sampleRate * CANNED_CHUNK_MS) / 1000)
+    await sleep(CANNED_FIRST_CHUNK_DELAY_MS, signal)
+    for (let offset = 0; offset < pcm.length && !signal.aborted; offset += chunkSamples) {
+      onChunk(pcm.subarray(offset, Math.min(pcm.length, offset + chunkSamples)))
+      await sleep(CANNED_CHUNK_DELAY_MS, signal)
+    }
+  }
+}
+
+export const createTtsEngine = (): TtsEngine => new CannedTtsEngine()
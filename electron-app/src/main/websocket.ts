@@ -3,8 +3,36 @@ import { SystemMonitor } from './system.js'
 import { exec, execFile } from 'child_process'
 import { promisify } from 'util'
 import { access, open as openFile, stat as statFile } from 'fs/promises'
-import { constants as fsConstants } from 'fs'
+import { appendFileSync, constants as fsConstants } from 'fs'
 import crypto from 'crypto'
+import {
+  STATS_STREAM_VERSION,
+  STATS_STREAM_MAX_RATE_HZ,
+  StatsStreamEncoder,
+  clampStatsRateHz,
+  type StatsSample,
+} from './statsStream.js'
+import {
+  WS_COMPRESSION_VERSION,
+  WS_COMPRESSION_CODEC_NAME,
+  WS_COMPRESSION_DEFAULT_MIN_BYTES,
+  WsMessageCompressor,
+} from './wsCompression.js'
+import {
+  VOICE_FORMAT_IMA_ADPCM,
+  decodeImaAdpcmChunk,
+  selectVoiceFormat,
+} from './imaAdpcm.js'
+import {
+  AUDIO_STREAM_CODEC,
+  AUDIO_STREAM_VERSION,
+  AudioStreamSender,
+  parseAudioStreamCaps,
+  resamplePcm,
+  type AudioStreamCaps,
+  type PcmAudio,
+} from './audioStream.js'
+import { createTtsEngine, type TtsEngine } from './tts.js'
 
 const execAsync = promisify(exec)
 const execFileAsync = promisify(execFile)
@@ -15,6 +43,37 @@ interface ClientInfo {
   deviceId?: string
   connectedAt: number
   lastHeartbeat: number
+  sdGeneration?: number
+  statsStream?: StatsStreamState
+  compressor?: WsMessageCompressor
+  audioStreamCaps?: AudioStreamCaps
+  audioSender?: AudioStreamSender
+  ttsReply?: TtsReplyState
+}
+
+// 一次语音回复的计时点（Date.now），用于拆分端到端延迟
+interface TtsReplyState {
+  abort: AbortController
+  sender?: AudioStreamSender
+  endpointAt: number // 设备语音端点到达服务端，0 表示非语音触发
+  requestedAt: number // 回复文本就绪
+  firstChunkAt: number // TTS 首块合成完成
+}
+
+interface StatsStreamState {
+  rateHz: number
+  maxRateHz: number
+  encoder: StatsStreamEncoder
+  timer: NodeJS.Timeout | null
+  framesSent: number
+  bytesSent: number
+}
+
+export interface SdListOptions {
+  cursor?: string
+  dir?: string
+  recursive?: boolean
+  refresh?: boolean
 }
 
 interface LaunchAppConfig {
@@ -84,6 +143,9 @@ interface VoiceCommandExecutionResult {
   timestamp: number
 }
 
+// 设置后记录发往设备的每条文本消息（JSONL），用于压缩回放基准
+const WS_TRACE_FILE = process.env.WS_TRACE_FILE?.trim() || ''
+
 const VOICE_OPEN_KEYWORDS = ['open', 'launch', 'start', 'run', '打开', '启动', '运行']
 
 const VOICE_PAGE_RULES: Array<{ page: string; keywords: string[] }> = [
@@ -211,6 +273,9 @@ interface VoiceStreamChunkMeta {
   seq: number
   len: number
   level: number
+  samples: number
+  overrunSamples: number
+  dmaOverruns: number
   timestamp: number
 }
 
@@ -218,12 +283,19 @@ interface VoiceStreamState {
   deviceId: string
   streamId: string
   sampleRate: number
+  format: string
   startedAt: number
   expectedSeq: number
   pendingMeta: VoiceStreamChunkMeta | null
   chunksReceived: number
   bytesReceived: number
   lastLevel: number
+  overrunSamples: number
+  dmaOverruns: number
+  pcmBytes: number
+  decodeUs: number
+  segments: number
+  endpointAt: number
   lastFinalText: string
   asr: AliyunSpeechTranscriber | null
 }
@@ -298,6 +370,7 @@ class AliyunSpeechTranscriber {
   private taskId = ''
   private ready = false
   private stopped = false
+  private finishTimer: NodeJS.Timeout | null = null
   private queue: Buffer[] = []
   private readonly queueLimit = 240
   private readonly appKey: string
@@ -421,6 +494,11 @@ class AliyunSpeechTranscriber {
               name,
             })
           }
+
+          // finish() 之后等到识别完成再关闭，最后一句不会丢
+          if (name === 'TranscriptionCompleted' && this.finishTimer) {
+            this.stop()
+          }
         } catch (error) {
           const reason = error instanceof Error ? error.message : String(error)
           this.onError(`asr parse failed: ${reason}`)
@@ -461,11 +539,38 @@ class AliyunSpeechTranscriber {
     return true
   }
 
+  // 设备端点检测到说话结束：请求识别收尾但保持连接，等待最终结果
+  public finish(timeoutMs: number): void {
+    if (this.stopped || this.finishTimer) {
+      return
+    }
+    this.flushQueue()
+    this.sendStopTranscription()
+    this.finishTimer = setTimeout(() => this.stop(), timeoutMs)
+  }
+
   public stop(): void {
     if (this.stopped) {
       return
     }
     this.stopped = true
+    const ws = this.socket
+    if (this.finishTimer) {
+      clearTimeout(this.finishTimer)
+    } else {
+      this.sendStopTranscription()
+    }
+    try {
+      ws?.close()
+    } catch {
+      // ignore close errors
+    }
+    this.ready = false
+    this.queue.length = 0
+    this.socket = null
+  }
+
+  private sendStopTranscription() {
     const ws = this.socket
     if (ws && ws.readyState === WebSocket.OPEN && this.taskId) {
       const stopMessage = {
@@ -484,14 +589,6 @@ class AliyunSpeechTranscriber {
         // ignore send error on shutdown
       }
     }
-    try {
-      ws?.close()
-    } catch {
-      // ignore close errors
-    }
-    this.ready = false
-    this.queue.length = 0
-    this.socket = null
   }
 
   private flushQueue() {
@@ -527,6 +624,7 @@ export class DeviceWebSocketServer {
   private systemMonitor: SystemMonitor
   private systemBroadcastInterval: NodeJS.Timeout | null = null
   private heartbeatMonitorInterval: NodeJS.Timeout | null = null
+  private statsSampleCache: { at: number; sample: Promise<StatsSample> } | null = null
   private customLaunchApps: LaunchAppConfig[] = []
   private photoFrameSettings: PhotoFrameSettings = { ...DEFAULT_PHOTO_FRAME_SETTINGS }
   private pendingSdListRequests: Map<string, PendingRequest<any>> = new Map()
@@ -537,6 +635,9 @@ export class DeviceWebSocketServer {
   private pendingSdPreviewRequests: Map<string, PendingRequest<any>> = new Map()
   private pendingSdPreviewRequestSockets: Map<string, WebSocket> = new Map()
   private pendingSdPreviewBinaryBySocket: Map<WebSocket, PendingSdPreviewBinary> = new Map()
+  private pendingAudioStreamAcks: Map<string, PendingRequest<any>> = new Map()
+  private audioStreamSeq = 0
+  private ttsEngine: TtsEngine = createTtsEngine()
 
   constructor(port: number = 8765) {
     this.wss = new WebSocketServer({ port })
@@ -597,6 +698,13 @@ export class DeviceWebSocketServer {
         this.pendingSdPreviewBinaryBySocket.delete(ws)
         const client = this.clients.get(ws)
         if (client) {
+          this.stopStatsStream(client)
+          client.ttsReply?.abort.abort()
+          client.audioSender?.stop()
+          client.audioSender = undefined
+          if (client.compressor) {
+            console.log(`[压缩] device=${client.deviceId} 统计:`, JSON.stringify(client.compressor.summary()))
+          }
           if (client.type === 'esp32_device' && client.deviceId) {
             console.log(`ESP32 设备已断开: ${client.deviceId}`)
             this.notifyDeviceDisconnected(client.deviceId)
@@ -727,7 +835,8 @@ export class DeviceWebSocketServer {
     targetDeviceId?: string,
     timeoutMs: number = 12000,
     offset: number = 0,
-    limit: number = 24
+    limit: number = 64,
+    options: SdListOptions = {}
   ): Promise<any> {
     const targetClient = this.findEsp32Client(targetDeviceId)
     if (!targetClient || !targetClient.ws || targetClient.ws.readyState !== WebSocket.OPEN) {
@@ -738,10 +847,13 @@ export class DeviceWebSocketServer {
     }
 
     const normalizedOffset = Number.isFinite(offset) ? Math.max(0, Math.floor(offset)) : 0
-    const normalizedLimit = Number.isFinite(limit) ? Math.max(1, Math.min(24, Math.floor(limit))) : 24
+    const normalizedLimit = Number.isFinite(limit) ? Math.max(1, Math.min(64, Math.floor(limit))) : 64
+    const cursor = typeof options.cursor === 'string' ? options.cursor.trim() : ''
+    const dir = typeof options.dir === 'string' && options.dir.startsWith('/') ? options.dir : '/'
+    const recursive = options.recursive !== false
     const requestId = `sd-list-${Date.now()}-${Math.random().toString(16).slice(2, 8)}`
     console.log(
-      `[SD] request list -> device=${targetClient.deviceId} requestId=${requestId} offset=${normalizedOffset} limit=${normalizedLimit} timeout=${timeoutMs}ms`
+      `[SD] request list -> device=${targetClient.deviceId} requestId=${requestId} dir=${dir} cursor=${cursor || '-'} offset=${normalizedOffset} limit=${normalizedLimit} timeout=${timeoutMs}ms`
     )
     return await new Promise((resolve, reject) => {
       const timeout = setTimeout(() => {
@@ -760,8 +872,12 @@ export class DeviceWebSocketServer {
         data: {
           requestId,
           deviceId: targetClient.deviceId,
+          dir,
+          recursive,
+          cursor,
           offset: normalizedOffset,
           limit: normalizedLimit,
+          refresh: options.refresh === true,
           timestamp: Date.now(),
         },
       })
@@ -1118,12 +1234,88 @@ export class DeviceWebSocketServer {
         }
       }
 
-      // 广播到所有客户端（ESP32 设备和控制面板）
+      // 广播到所有客户端（ESP32 设备和控制面板）；已协商二进制状态流的设备跳过
       console.log(`[广播] system_stats - CPU: ${systemInfo.cpu.usage.toFixed(1)}%, 内存: ${systemInfo.memory.percentage.toFixed(1)}%, 客户端数: ${this.clients.size}`)
-      this.broadcast(message)
+      this.clients.forEach((client, ws) => {
+        if (!client.statsStream) {
+          this.sendMessage(ws, message)
+        }
+      })
     }, 5000)
   }
 
+  // 多个设备同时订阅时共享一次采样，避免 systeminformation 被并发调用
+  private sampleSystemStats(): Promise<StatsSample> {
+    const now = Date.now()
+    const minGapMs = Math.floor(1000 / STATS_STREAM_MAX_RATE_HZ) - 10
+    if (this.statsSampleCache && now - this.statsSampleCache.at < minGapMs) {
+      return this.statsSampleCache.sample
+    }
+
+    const sample = this.systemMonitor.getSystemInfo().then((info) => ({
+      cpu: info.cpu.usage,
+      memory: info.memory.percentage,
+      upload: info.network.upload,
+      download: info.network.download,
+    }))
+    this.statsSampleCache = { at: now, sample }
+    return sample
+  }
+
+  private startStatsStream(ws: WebSocket, client: ClientInfo, rateHz: number) {
+    const state = client.statsStream
+    if (!state) return
+
+    if (state.timer) {
+      clearInterval(state.timer)
+    }
+    state.rateHz = Math.min(clampStatsRateHz(rateHz, state.rateHz), state.maxRateHz)
+    // 关键帧约每 2 秒一次，丢帧后设备最多等 2 秒恢复
+    state.encoder.setKeyframeInterval(state.rateHz * 2)
+    state.encoder.forceKeyframe()
+
+    let busy = false
+    state.timer = setInterval(async () => {
+      if (busy || ws.readyState !== WebSocket.OPEN) return
+      busy = true
+      try {
+        const frame = state.encoder.encode(await this.sampleSystemStats())
+        if (frame && ws.readyState === WebSocket.OPEN) {
+          ws.send(frame, { binary: true })
+          state.framesSent += 1
+          state.bytesSent += frame.length
+        }
+      } catch (error) {
+        console.error('[StatsStream] 采样失败:', error)
+      } finally {
+        busy = false
+      }
+    }, Math.round(1000 / state.rateHz))
+
+    console.log(`[StatsStream] device=${client.deviceId} rate=${state.rateHz}Hz`)
+  }
+
+  private stopStatsStream(client: ClientInfo) {
+    if (client.statsStream?.timer) {
+      clearInterval(client.statsStream.timer)
+      client.statsStream.timer = null
+    }
+  }
+
+  private handleStatsStreamConfig(ws: WebSocket, client: ClientInfo, message: any) {
+    if (client.type !== 'esp32_device' || !client.statsStream) return
+    const data = message?.data ?? {}
+
+    const rateHz = data.rateHz === undefined
+      ? client.statsStream.rateHz
+      : Math.min(clampStatsRateHz(data.rateHz), client.statsStream.maxRateHz)
+    if (rateHz !== client.statsStream.rateHz) {
+      this.startStatsStream(ws, client, rateHz)
+    } else if (data.keyframe === true) {
+      client.statsStream.encoder.forceKeyframe()
+    }
+  }
+
   private startHeartbeatMonitor() {
     // 每 10 秒检查一次设备心跳
     this.heartbeatMonitorInterval = setInterval(() => {
@@ -1203,6 +1395,10 @@ export class DeviceWebSocketServer {
         this.handleVoiceStreamChunkMeta(ws, client, message)
         break
 
+      case 'voice_stream_segment':
+        this.handleVoiceStreamSegment(ws, client, message)
+        break
+
       case 'voice_stream_stop':
         this.handleVoiceStreamStop(ws, client, message)
         break
@@ -1227,6 +1423,18 @@ export class DeviceWebSocketServer {
         this.handleSdDeleteResponse(client, message)
         break
 
+      case 'stats_stream_config':
+        this.handleStatsStreamConfig(ws, client, message)
+        break
+
+      case 'sd_subscribe_ack':
+        this.handleSdSubscribeAck(client, message)
+        break
+
+      case 'sd_changed':
+        this.handleSdChanged(client, message)
+        break
+
       case 'sd_upload_begin_ack':
         this.handleSdUploadBeginAck(client, message)
         break
@@ -1243,6 +1451,19 @@ export class DeviceWebSocketServer {
         this.handleSdPreviewResponse(client, message)
         break
 
+      case 'audio_stream_ack':
+        this.handleAudioStreamAck(client, message)
+        break
+
+      case 'audio_stream_stats':
+      case 'audio_stream_stopped':
+        this.handleAudioStreamStats(client, message)
+        break
+
+      case 'audio_stream_first_audio':
+        this.handleAudioStreamFirstAudio(client, message)
+        break
+
       default:
         console.log('未知消息类型:', message.type)
     }
@@ -1268,6 +1489,7 @@ export class DeviceWebSocketServer {
       success: boolean
       status: 'accepted' | 'ready' | 'stopped' | 'error'
       reason?: string
+      format?: string
       seq?: number
       expectedLen?: number
       actualLen?: number
@@ -1284,6 +1506,7 @@ export class DeviceWebSocketServer {
         success: payload.success,
         status: payload.status,
         reason: payload.reason || '',
+        format: payload.format,
         seq: payload.seq,
         expectedLen: payload.expectedLen,
         actualLen: payload.actualLen,
@@ -1354,7 +1577,28 @@ export class DeviceWebSocketServer {
       return
     }
 
-    if (!state.asr || !state.asr.pushAudio(data)) {
+    let pcm: Buffer | null = data
+    if (state.format === VOICE_FORMAT_IMA_ADPCM) {
+      const started = process.hrtime.bigint()
+      pcm = decodeImaAdpcmChunk(data, pendingMeta.samples)
+      state.decodeUs += Number(process.hrtime.bigint() - started) / 1000
+    }
+    if (!pcm) {
+      this.sendMessage(ws, {
+        type: 'voice_stream_chunk_ack',
+        data: {
+          streamId: state.streamId,
+          seq: pendingMeta.seq,
+          success: false,
+          reason: 'invalid adpcm chunk',
+          timestamp: Date.now(),
+        },
+      })
+      this.stopVoiceStreamSession(ws, 'invalid adpcm chunk', true)
+      return
+    }
+
+    if (!state.asr || !state.asr.pushAudio(pcm)) {
       this.sendMessage(ws, {
         type: 'voice_stream_chunk_ack',
         data: {
@@ -1371,7 +1615,16 @@ export class DeviceWebSocketServer {
 
     state.expectedSeq = pendingMeta.seq + 1
     state.lastLevel = pendingMeta.level
+    // 设备端采集丢样计数是累计值，增长即说明这段音频有缺口
+    if (pendingMeta.overrunSamples > state.overrunSamples || pendingMeta.dmaOverruns > state.dmaOverruns) {
+      console.warn(
+        `[VoiceStream] 采集溢出 device=${state.deviceId} seq=${pendingMeta.seq} ringDropped=${pendingMeta.overrunSamples} dmaOverruns=${pendingMeta.dmaOverruns}`
+      )
+      state.overrunSamples = pendingMeta.overrunSamples
+      state.dmaOverruns = pendingMeta.dmaOverruns
+    }
     state.bytesReceived += data.length
+    state.pcmBytes += pcm.length
     state.chunksReceived += 1
 
     this.sendMessage(ws, {
@@ -1417,12 +1670,19 @@ export class DeviceWebSocketServer {
       deviceId: client.deviceId || 'esp32-device',
       streamId,
       sampleRate,
+      format: selectVoiceFormat(data.formats, data.format),
       startedAt: Date.now(),
       expectedSeq: 0,
       pendingMeta: null,
       chunksReceived: 0,
       bytesReceived: 0,
       lastLevel: 0,
+      overrunSamples: 0,
+      dmaOverruns: 0,
+      pcmBytes: 0,
+      decodeUs: 0,
+      segments: 0,
+      endpointAt: 0,
       lastFinalText: '',
       asr: null,
     }
@@ -1431,7 +1691,9 @@ export class DeviceWebSocketServer {
       streamId,
       success: true,
       status: 'accepted',
+      format: state.format,
     })
+    console.log(`[VoiceStream] start device=${state.deviceId} streamId=${streamId} format=${state.format}`)
 
     const asr = new AliyunSpeechTranscriber({
       sampleRate,
@@ -1502,6 +1764,9 @@ export class DeviceWebSocketServer {
     const seqRaw = Number(data.seq)
     const lenRaw = Number(data.len)
     const levelRaw = Number(data.level)
+    const samplesRaw = Number(data.samples)
+    const overrunSamplesRaw = Number(data.overrunSamples)
+    const dmaOverrunsRaw = Number(data.dmaOverruns)
     const seq = Number.isFinite(seqRaw) ? Math.floor(seqRaw) : -1
     const len = Number.isFinite(lenRaw) ? Math.floor(lenRaw) : -1
     const level = Number.isFinite(levelRaw) ? Math.max(0, Math.min(100, Math.floor(levelRaw))) : 0
@@ -1569,6 +1834,9 @@ export class DeviceWebSocketServer {
       seq,
       len,
       level,
+      samples: Number.isFinite(samplesRaw) ? Math.max(0, Math.floor(samplesRaw)) : 0,
+      overrunSamples: Number.isFinite(overrunSamplesRaw) ? Math.max(0, Math.floor(overrunSamplesRaw)) : 0,
+      dmaOverruns: Number.isFinite(dmaOverrunsRaw) ? Math.max(0, Math.floor(dmaOverrunsRaw)) : 0,
       timestamp: Date.now(),
     }
   }
@@ -1601,9 +1869,45 @@ export class DeviceWebSocketServer {
     }
 
     const reason = typeof message?.data?.reason === 'string' ? message.data.reason : 'device stop'
+    this.logVoiceStreamStats(message?.data)
     this.stopVoiceStreamSession(ws, reason, true)
   }
 
+  // 设备端编码/VAD 统计：随 voice_stream_stop 或静音结束时的 "end" 分段上报
+  private logVoiceStreamStats(data: any) {
+    const encodeUsAvg = Number(data?.encodeUsAvg)
+    if (!Number.isFinite(encodeUsAvg)) {
+      return
+    }
+    console.log(
+      `[VoiceStream] 设备编码 format=${data.format} avg=${encodeUsAvg}us max=${Number(data.encodeUsMax) || 0}us / chunk, vad=${Number(data.vadUsAvg) || 0}us, speech=${Number(data.speechFrames) || 0}/${Number(data.vadFrames) || 0} frames`
+    )
+  }
+
+  private handleVoiceStreamSegment(ws: WebSocket, client: ClientInfo, message: any) {
+    if (client.type !== 'esp32_device') {
+      return
+    }
+
+    const state = this.voiceStreams.get(ws)
+    const data = message?.data ?? {}
+    const streamId = typeof data.streamId === 'string' ? data.streamId.trim() : ''
+    if (!state || streamId !== state.streamId) {
+      return
+    }
+
+    if (data.event === 'start') {
+      state.segments += 1
+      console.log(`[VoiceStream] 语音开始 device=${state.deviceId} seq=${data.seq}`)
+    } else if (data.event === 'end') {
+      // 设备端已判定说话结束并停止采集：立即让 ASR 收尾，不再等待云端自身的静音判断
+      state.endpointAt = Date.now()
+      console.log(`[VoiceStream] 语音结束 device=${state.deviceId} seq=${data.seq} speechFrames=${data.speechFrames}`)
+      this.logVoiceStreamStats(data)
+      state.asr?.finish(3000)
+    }
+  }
+
   private async handleVoiceStreamAsrPacket(ws: WebSocket, streamId: string, packet: VoiceRecognitionPacket) {
     const state = this.voiceStreams.get(ws)
     if (!state || state.streamId !== streamId) {
@@ -1632,6 +1936,9 @@ export class DeviceWebSocketServer {
       return
     }
     state.lastFinalText = recognizedText
+    if (state.endpointAt > 0) {
+      console.log(`[VoiceStream] 端点到最终结果 ${Date.now() - state.endpointAt}ms device=${state.deviceId}`)
+    }
 
     const result = await this.executeVoiceCommand(recognizedText)
     this.sendMessage(ws, {
@@ -1641,6 +1948,7 @@ export class DeviceWebSocketServer {
         source: 'esp32_mic',
       },
     })
+    this.speakVoiceCommandResult(state.deviceId, result, state.endpointAt)
     this.broadcastVoiceCommandEvent(state.deviceId, result)
   }
 
@@ -1656,7 +1964,7 @@ export class DeviceWebSocketServer {
     state.asr = null
 
     console.log(
-      `[VoiceStream] stop device=${state.deviceId} streamId=${state.streamId} chunks=${state.chunksReceived} bytes=${state.bytesReceived} reason=${reason}`
+      `[VoiceStream] stop device=${state.deviceId} streamId=${state.streamId} format=${state.format} segments=${state.segments} chunks=${state.chunksReceived} bytes=${state.bytesReceived} pcmBytes=${state.pcmBytes} decodeUs=${Math.round(state.decodeUs)} ringDropped=${state.overrunSamples} dmaOverruns=${state.dmaOverruns} reason=${reason}`
     )
 
     if (notifyClient) {
@@ -1790,7 +2098,7 @@ export class DeviceWebSocketServer {
         clearTimeout(pending.timeout)
         this.pendingSdListRequests.delete(requestId)
         console.log(
-          `[SD] list response <- device=${client.deviceId} requestId=${requestId} total=${data.total ?? '-'} returned=${data.returned ?? (Array.isArray(data.files) ? data.files.length : '-')}`
+          `[SD] list response <- device=${client.deviceId} requestId=${requestId} gen=${data.generation ?? '-'} total=${data.total ?? '-'} returned=${data.returned ?? (Array.isArray(data.files) ? data.files.length : '-')}`
         )
         pending.resolve({
           success: true,
@@ -1810,6 +2118,298 @@ export class DeviceWebSocketServer {
     })
   }
 
+  // 打开到设备的实时音频流。返回的 sender 可继续 push 单声道 PCM，结束时调用 end()；
+  // ack 在设备确认（或超时）后 resolve。
+  public openAudioStream(
+    sampleRate: number,
+    title: string,
+    targetDeviceId?: string,
+    options: { purpose?: 'media' | 'tts'; ackTimeoutMs?: number } = {},
+  ): { success: true; sender: AudioStreamSender; deviceId?: string; ack: Promise<any> } | { success: false; reason: string } {
+    const targetClient = this.findEsp32Client(targetDeviceId)
+    if (!targetClient || !targetClient.ws || targetClient.ws.readyState !== WebSocket.OPEN) {
+      return {
+        success: false,
+        reason: targetDeviceId ? `device not online: ${targetDeviceId}` : 'no online esp32 device',
+      }
+    }
+    const caps = targetClient.audioStreamCaps
+    if (!caps) {
+      return { success: false, reason: 'device does not support audio stream' }
+    }
+    if (!Number.isFinite(sampleRate) || sampleRate < 8000 || sampleRate > caps.maxSampleRate) {
+      return { success: false, reason: `unsupported sample rate: ${sampleRate}` }
+    }
+
+    this.stopAudioStream(targetClient.deviceId)
+    const ackTimeoutMs = options.ackTimeoutMs ?? 3000
+    const ws = targetClient.ws
+    const streamId = this.audioStreamSeq = (this.audioStreamSeq + 1) & 0xff
+    const sender = new AudioStreamSender(
+      streamId,
+      sampleRate,
+      caps.frameMs,
+      (frame) => {
+        if (ws.readyState !== WebSocket.OPEN) return false
+        ws.send(frame, { binary: true })
+        return true
+      },
+      (stats) => {
+        if (targetClient.audioSender === sender) {
+          targetClient.audioSender = undefined
+          // 数据已发完：通知设备播完缓冲后结束
+          if (ws.readyState === WebSocket.OPEN) {
+            this.sendMessage(ws, { type: 'audio_stream_stop', data: { streamId, drain: true } })
+          }
+        }
+        console.log(`[AudioStream] device=${targetClient.deviceId} stream=${streamId} 发送完成:`, JSON.stringify(stats))
+      },
+    )
+    targetClient.audioSender = sender
+
+    const ackKey = `${targetClient.deviceId}:${streamId}`
+    const ack = new Promise<any>((resolve, reject) => {
+      const timeout = setTimeout(() => {
+        this.pendingAudioStreamAcks.delete(ackKey)
+        resolve({ success: false, streamId, deviceId: targetClient.deviceId, reason: `audio stream ack timeout (${ackTimeoutMs}ms)` })
+      }, ackTimeoutMs)
+      this.pendingAudioStreamAcks.set(ackKey, { resolve, reject, timeout })
+    })
+
+    this.sendMessage(ws, {
+      type: 'audio_stream_start',
+      data: {
+        version: AUDIO_STREAM_VERSION,
+        streamId,
+        codec: AUDIO_STREAM_CODEC,
+        sampleRate,
+        channels: 1,
+        frameSamples: sender.samplesPerFrame,
+        title,
+        purpose: options.purpose ?? 'media',
+        timestamp: Date.now(),
+      },
+    })
+    // 不等 ack 直接开始发帧，设备按顺序先处理 start；被拒绝时在 ack 中停止
+    sender.start()
+    console.log(`[AudioStream] -> device=${targetClient.deviceId} stream=${streamId} ${sampleRate}Hz frame=${sender.samplesPerFrame}`)
+    return { success: true, sender, deviceId: targetClient.deviceId, ack }
+  }
+
+  // 播放一段完整 PCM；超过设备上限的采样率先重采样
+  public async playAudioOnDevice(audio: PcmAudio, title: string, targetDeviceId?: string): Promise<any> {
+    const caps = this.findEsp32Client(targetDeviceId)?.audioStreamCaps
+    const pcm = caps && audio.sampleRate > caps.maxSampleRate ? resamplePcm(audio, caps.maxSampleRate) : audio
+    const opened = this.openAudioStream(pcm.sampleRate, title, targetDeviceId)
+    if (!opened.success) {
+      return opened
+    }
+    opened.sender.push(pcm.samples)
+    opened.sender.end()
+    return {
+      ...(await opened.ack),
+      durationMs: Math.round((pcm.samples.length * 1000) / pcm.sampleRate),
+    }
+  }
+
+  // drain=true 时设备播完已缓冲的音频再停止
+  public stopAudioStream(targetDeviceId?: string, drain: boolean = false): boolean {
+    const targetClient = this.findEsp32Client(targetDeviceId)
+    const sender = targetClient?.audioSender
+    if (!targetClient || !sender) return false
+    sender.stop()
+    targetClient.audioSender = undefined
+    if (targetClient.ws.readyState === WebSocket.OPEN) {
+      this.sendMessage(targetClient.ws, { type: 'audio_stream_stop', data: { streamId: sender.streamId, drain } })
+    }
+    return true
+  }
+
+  private handleAudioStreamAck(client: ClientInfo, message: any) {
+    if (client.type !== 'esp32_device') return
+    const data = message?.data ?? {}
+    const streamId = Number(data.streamId)
+    const accepted = Boolean(data.accepted)
+    if (!accepted && client.audioSender?.streamId === streamId) {
+      client.audioSender.stop()
+      client.audioSender = undefined
+    }
+    console.log(`[AudioStream] ack <- device=${client.deviceId} stream=${streamId} accepted=${accepted} ${data.reason || ''}`)
+
+    const ackKey = `${client.deviceId}:${streamId}`
+    const pending = this.pendingAudioStreamAcks.get(ackKey)
+    if (!pending) return
+    clearTimeout(pending.timeout)
+    this.pendingAudioStreamAcks.delete(ackKey)
+    pending.resolve({
+      ...data,
+      success: accepted,
+      deviceId: client.deviceId,
+    })
+  }
+
+  // 设备周期性上报抖动缓冲状态，结束时再报一次
+  private handleAudioStreamStats(client: ClientInfo, message: any) {
+    if (client.type !== 'esp32_device') return
+    const data = message?.data ?? {}
+    // 设备侧主动结束（开麦打断、超时等）：停止继续发帧
+    if (message.type === 'audio_stream_stopped' && client.audioSender?.streamId === Number(data.streamId)) {
+      client.audioSender.stop()
+      client.audioSender = undefined
+      client.ttsReply?.abort.abort()
+    }
+    console.log(
+      `[AudioStream] ${message.type} <- device=${client.deviceId} stream=${data.streamId}`
+      + ` depth=${data.depthMs}ms target=${data.targetMs}ms jitter=${data.jitterMs}ms`
+      + ` lost=${data.lost} underruns=${data.underruns} drift=${data.correctionPpm}ppm`,
+    )
+    this.broadcastToControlPanels({
+      type: 'device_audio_stream',
+      data: {
+        ...data,
+        event: message.type,
+        deviceId: client.deviceId,
+        timestamp: Date.now(),
+      },
+    })
+  }
+
+  // 把回复文本合成为语音推送到设备：首块合成完成即开流，后续块边合成边发
+  public async speakOnDevice(text: string, targetDeviceId?: string, endpointAt: number = 0): Promise<any> {
+    const targetClient = this.findEsp32Client(targetDeviceId)
+    const trimmed = typeof text === 'string' ? text.trim() : ''
+    if (!targetClient || !targetClient.audioStreamCaps) {
+      return { success: false, reason: 'no device with audio stream support' }
+    }
+    if (!trimmed) {
+      return { success: false, reason: 'empty text' }
+    }
+
+    // 新回复打断上一条
+    const previous = targetClient.ttsReply
+    if (previous) {
+      previous.abort.abort()
+      if (previous.sender && targetClient.audioSender === previous.sender) {
+        this.stopAudioStream(targetClient.deviceId)
+      }
+    }
+    const state: TtsReplyState = {
+      abort: new AbortController(),
+      endpointAt,
+      requestedAt: Date.now(),
+      firstChunkAt: 0,
+    }
+    targetClient.ttsReply = state
+
+    let ack = null as Promise<any> | null
+    let failure = ''
+    try {
+      await this.ttsEngine.synthesize(trimmed, (pcm) => {
+        if (state.abort.signal.aborted) return
+        if (!state.sender) {
+          state.firstChunkAt = Date.now()
+          const opened = this.openAudioStream(this.ttsEngine.sampleRate, 'Voice reply', targetClient.deviceId, { purpose: 'tts' })
+          if (!opened.success) {
+            failure = opened.reason
+            state.abort.abort()
+            return
+          }
+          state.sender = opened.sender
+          ack = opened.ack
+        }
+        state.sender.push(pcm)
+      }, state.abort.signal)
+    } catch (error) {
+      failure = error instanceof Error ? error.message : String(error)
+    }
+    state.sender?.end()
+
+    if (!ack) {
+      return { success: false, reason: failure || 'tts produced no audio' }
+    }
+    return {
+      ...(await ack),
+      engine: this.ttsEngine.name,
+      firstChunkMs: state.firstChunkAt - state.requestedAt,
+    }
+  }
+
+  private speakVoiceCommandResult(deviceId: string | undefined, result: VoiceCommandExecutionResult, endpointAt: number = 0) {
+    const text = result.message || result.reason || ''
+    if (!deviceId || !text || !this.findEsp32Client(deviceId)?.audioStreamCaps) {
+      return
+    }
+    void this.speakOnDevice(text, deviceId, endpointAt).then((reply) => {
+      if (!reply?.success) {
+        console.log(`[TTS] 回复播报失败 device=${deviceId}: ${reply?.reason || 'unknown'}`)
+      }
+    })
+  }
+
+  // 设备首个回复样本写入 I2S 时上报；与服务端计时点合起来拆分延迟
+  private handleAudioStreamFirstAudio(client: ClientInfo, message: any) {
+    if (client.type !== 'esp32_device') return
+    const data = message?.data ?? {}
+    const tts = client.ttsReply
+    const sender = tts?.sender
+    const ownStream = Boolean(sender && sender.streamId === Number(data.streamId))
+    const firstFrameAt = ownStream ? sender!.summary().firstFrameAt : 0
+
+    const breakdown = {
+      endpointToTextMs: ownStream && tts!.endpointAt > 0 ? tts!.requestedAt - tts!.endpointAt : undefined,
+      textToFirstChunkMs: ownStream ? tts!.firstChunkAt - tts!.requestedAt : undefined,
+      firstChunkToFirstFrameMs: ownStream && firstFrameAt > 0 ? firstFrameAt - tts!.firstChunkAt : undefined,
+      deviceStartToAudioMs: data.startToAudioMs,
+      speechEndToAudioMs: data.speechEndToAudioMs,
+    }
+    console.log(`[TTS] 首个音频 device=${client.deviceId} stream=${data.streamId} purpose=${data.purpose}`, JSON.stringify(breakdown))
+
+    this.broadcastToControlPanels({
+      type: 'tts_latency',
+      data: {
+        deviceId: client.deviceId,
+        streamId: data.streamId,
+        purpose: data.purpose,
+        engine: this.ttsEngine.name,
+        ...breakdown,
+        timestamp: Date.now(),
+      },
+    })
+  }
+
+  public getSdGeneration(targetDeviceId?: string): number | undefined {
+    return this.findEsp32Client(targetDeviceId)?.sdGeneration
+  }
+
+  private handleSdSubscribeAck(client: ClientInfo, message: any) {
+    if (client.type !== 'esp32_device') return
+    const data = message?.data ?? {}
+    const generation = Number(data.generation)
+    if (Number.isFinite(generation)) {
+      client.sdGeneration = generation
+    }
+    console.log(`[SD] change subscription <- device=${client.deviceId} subscribed=${data.subscribed} gen=${data.generation ?? '-'}`)
+  }
+
+  private handleSdChanged(client: ClientInfo, message: any) {
+    if (client.type !== 'esp32_device') return
+    const data = message?.data ?? {}
+    const generation = Number(data.generation)
+    if (Number.isFinite(generation)) {
+      client.sdGeneration = generation
+    }
+    console.log(`[SD] changed <- device=${client.deviceId} gen=${data.generation ?? '-'} reason=${data.reason ?? '-'} path=${data.path ?? '-'}`)
+
+    this.broadcastToControlPanels({
+      type: 'sd_changed',
+      data: {
+        ...data,
+        deviceId: client.deviceId,
+        timestamp: Date.now(),
+      },
+    })
+  }
+
   private handleSdDeleteResponse(client: ClientInfo, message: any) {
     if (client.type !== 'esp32_device') return
     const data = message?.data ?? {}
@@ -1986,6 +2586,18 @@ export class DeviceWebSocketServer {
         timestamp: Date.now()
       }
     })
+
+    // 助手回复同时在设备扬声器上播报
+    const data = message?.data ?? {}
+    const text = typeof data.text === 'string' ? data.text : (typeof data.message === 'string' ? data.message : '')
+    if ((data.role ?? 'assistant') !== 'assistant' || !text.trim() || !client.audioStreamCaps) {
+      return
+    }
+    void this.speakOnDevice(text, client.deviceId).then((reply) => {
+      if (!reply?.success) {
+        console.log(`[TTS] AI 回复播报失败 device=${client.deviceId}: ${reply?.reason || 'unknown'}`)
+      }
+    })
   }
 
   private handleAIConfig(ws: WebSocket, client: ClientInfo, message: any) {
@@ -2306,6 +2918,7 @@ export class DeviceWebSocketServer {
       type: 'voice_command_result',
       data: result,
     })
+    this.speakVoiceCommandResult(client.deviceId, result)
     this.broadcastVoiceCommandEvent(client.deviceId, result)
   }
 
@@ -2342,6 +2955,7 @@ export class DeviceWebSocketServer {
       type: 'voice_command_result',
       data: resultForDevice,
     })
+    this.speakVoiceCommandResult(targetClient.deviceId, result)
 
     this.sendMessage(ws, {
       type: 'voice_command_dispatch_ack',
@@ -2427,15 +3041,75 @@ export class DeviceWebSocketServer {
 
       console.log(`ESP32 设备已连接: ${client.deviceId}`)
 
+      const statsCaps = message?.data?.capabilities?.statsStream
+      if (Number(statsCaps?.version) === STATS_STREAM_VERSION) {
+        const maxRateHz = clampStatsRateHz(statsCaps.maxRateHz, STATS_STREAM_MAX_RATE_HZ)
+        this.stopStatsStream(client)
+        client.statsStream = {
+          rateHz: clampStatsRateHz(statsCaps.rateHz),
+          maxRateHz,
+          encoder: new StatsStreamEncoder(1),
+          timer: null,
+          framesSent: 0,
+          bytesSent: 0,
+        }
+      }
+
+      const compressionCaps = message?.data?.capabilities?.compression
+      const codecs: unknown[] = Array.isArray(compressionCaps?.codecs) ? compressionCaps.codecs : []
+      const maxRawBytes = Number(compressionCaps?.maxRawBytes) || 0
+      client.compressor = Number(compressionCaps?.version) === WS_COMPRESSION_VERSION
+        && codecs.includes(WS_COMPRESSION_CODEC_NAME)
+        && maxRawBytes > 0
+        ? new WsMessageCompressor(WS_COMPRESSION_DEFAULT_MIN_BYTES, maxRawBytes)
+        : undefined
+      client.audioStreamCaps = parseAudioStreamCaps(message?.data?.capabilities?.audioStream)
+
+      // handshake_ack 本身始终以文本发送，压缩从下一条消息开始
+      const compressor = client.compressor
+      client.compressor = undefined
       this.sendMessage(ws, {
         type: 'handshake_ack',
         data: {
           serverVersion: '4.0.0',
           updateInterval: 5000,
           clientType: 'esp32_device',
-          deviceId: client.deviceId
+          deviceId: client.deviceId,
+          ...(client.statsStream
+            ? {
+                statsStream: {
+                  version: STATS_STREAM_VERSION,
+                  rateHz: Math.min(client.statsStream.rateHz, client.statsStream.maxRateHz),
+                },
+              }
+            : {}),
+          ...(compressor
+            ? {
+                compression: {
+                  version: WS_COMPRESSION_VERSION,
+                  codec: WS_COMPRESSION_CODEC_NAME,
+                  minBytes: WS_COMPRESSION_DEFAULT_MIN_BYTES,
+                  classes: compressor.enabledTypes(),
+                },
+              }
+            : {}),
         }
       })
+      client.compressor = compressor
+
+      if (client.statsStream) {
+        this.startStatsStream(ws, client, client.statsStream.rateHz)
+      }
+
+      // 订阅设备 SD 卡变更通知，避免轮询列表
+      this.sendMessage(ws, {
+        type: 'sd_subscribe',
+        data: {
+          requestId: `sd-sub-${Date.now()}`,
+          subscribe: true,
+          timestamp: Date.now(),
+        },
+      })
 
       // 通知所有控制面板有新设备连接
       if (client.deviceId) {
@@ -2448,7 +3122,20 @@ export class DeviceWebSocketServer {
     if (client.type !== 'esp32_device') return
 
     client.lastHeartbeat = Date.now()
-    const { deviceId, uptime, wifiSignal } = message.data
+    const {
+      deviceId,
+      uptime,
+      wifiSignal,
+      txQueueDepth,
+      txQueuePeak,
+      txDropped,
+      txCoalesced,
+      txDeferredLoops,
+      rxCompressedFrames,
+      rxCompressedRawBytes,
+      rxCompressedWireBytes,
+      rxDecodeUs,
+    } = message.data
 
     // 转发心跳数据到所有控制面板
     this.broadcastToControlPanels({
@@ -2457,6 +3144,16 @@ export class DeviceWebSocketServer {
         deviceId: deviceId || client.deviceId,
         uptime,
         wifiSignal,
+        txQueueDepth,
+        txQueuePeak,
+        txDropped,
+        txCoalesced,
+        txDeferredLoops,
+        rxCompressedFrames,
+        rxCompressedRawBytes,
+        rxCompressedWireBytes,
+        rxDecodeUs,
+        compression: client.compressor?.summary(),
         timestamp: Date.now()
       }
     })
@@ -2518,7 +3215,29 @@ export class DeviceWebSocketServer {
 
   public sendMessage(ws: WebSocket, message: any) {
     if (ws.readyState === WebSocket.OPEN) {
-      ws.send(JSON.stringify(message))
+      const text = JSON.stringify(message)
+      if (WS_TRACE_FILE && this.clients.get(ws)?.type === 'esp32_device') {
+        this.recordTrace(text)
+      }
+      const compressor = this.clients.get(ws)?.compressor
+      const frame = compressor && typeof message?.type === 'string'
+        ? compressor.encode(message.type, text)
+        : null
+      if (frame) {
+        ws.send(frame, { binary: true })
+      } else {
+        ws.send(text)
+      }
+    }
+  }
+
+  // 发往设备的文本消息逐行写入 WS_TRACE_FILE，供压缩回放基准使用
+  // （electron-app/test-ws-compression.js --trace <文件>）
+  private recordTrace(text: string) {
+    try {
+      appendFileSync(WS_TRACE_FILE, `${text}\n`)
+    } catch (error) {
+      console.error('[压缩] 写入消息记录失败:', error)
     }
   }
 
@@ -2552,6 +3271,7 @@ export class DeviceWebSocketServer {
     if (this.systemBroadcastInterval) {
       clearInterval(this.systemBroadcastInterval)
     }
+    this.clients.forEach((client) => this.stopStatsStream(client))
     if (this.heartbeatMonitorInterval) {
       clearInterval(this.heartbeatMonitorInterval)
     }
@@ -0,0 +1,224 @@
+// 服务端 → 设备的大文本消息压缩（握手协商后启用）
+//
+// 设备端 WebSocket 客户端不支持 permessage-deflate，这里在应用层压缩：
+// 超过阈值的 JSON 文本用 LZ4 block 格式压缩后以二进制帧发送。
+//
+// 帧格式 v1:
+//   [0] tag 0x5A ('Z')
+//   [1] codec（1 = LZ4 block）
+//   [2..] 原文长度（无符号 LEB128）
+//   之后为 LZ4 block 数据
+// 固件侧解码见 esp32-firmware/src/net/ws_compression.h，两边需保持一致。
+//
+// 每个消息类型（type 字段）单独统计原始字节、线上字节与编码耗时；
+// 试探若干条后压缩收益不足的类型自动关闭，只在划算的类型上保持压缩。
+
+export const WS_COMPRESSION_VERSION = 1
+export const WS_COMPRESSION_FRAME_TAG = 0x5a
+export const WS_COMPRESSION_CODEC_LZ4 = 1
+export const WS_COMPRESSION_CODEC_NAME = 'lz4'
+export const WS_COMPRESSION_DEFAULT_MIN_BYTES = 256
+
+// 默认参与压缩的消息类型：都是发往设备、体积较大的 JSON
+export const WS_COMPRESSION_DEFAULT_CLASSES = [
+  'app_list',
+  'weather_data',
+  'photo_settings',
+  'ai_config',
+  'voice_command_result',
+]
+
+const HASH_BITS = 12
+const MIN_MATCH = 4
+const LAST_LITERALS = 5
+const MF_LIMIT = 12
+const MAX_OFFSET = 65535
+
+// 试探样本数与保留阈值：线上字节 / 原始字节 高于该比例则视为不划算
+const PROBE_MESSAGES = 8
+const KEEP_RATIO = 0.85
+
+const writeLength = (out: Buffer, op: number, value: number): number => {
+  let rest = value
+  while (rest >= 255) {
+    out[op++] = 255
+    rest -= 255
+  }
+  out[op++] = rest
+  return op
+}
+
+const writeSequence = (
+  out: Buffer,
+  op: number,
+  input: Buffer,
+  literalStart: number,
+  literalEnd: number,
+  offset: number,
+  matchLength: number,
+): number => {
+  const literalLength = literalEnd - literalStart
+  const matchCode = matchLength - MIN_MATCH
+  out[op++] = (Math.min(literalLength, 15) << 4) | Math.min(matchCode, 15)
+  if (literalLength >= 15) {
+    op = writeLength(out, op, literalLength - 15)
+  }
+  op += input.copy(out, op, literalStart, literalEnd)
+  out[op++] = offset & 0xff
+  out[op++] = offset >> 8
+  if (matchCode >= 15) {
+    op = writeLength(out, op, matchCode - 15)
+  }
+  return op
+}
+
+// 贪心单哈希的 LZ4 block 编码，遵守 LZ4 末尾约束（最后 5 字节为字面量）
+export const compressLz4Block = (input: Buffer): Buffer => {
+  const n = input.length
+  const out = Buffer.allocUnsafe(n + Math.ceil(n / 255) + 16)
+  const table = new Int32Array(1 << HASH_BITS).fill(-1)
+  const matchLimit = n - LAST_LITERALS
+  const inputLimit = n - MF_LIMIT
+  let op = 0
+  let anchor = 0
+  let ip = 0
+
+  while (ip < inputLimit) {
+    const sequence = input.readUInt32LE(ip)
+    const hash = Math.imul(sequence, 2654435761) >>> (32 - HASH_BITS)
+    const ref = table[hash]
+    table[hash] = ip
+    if (ref < 0 || ip - ref > MAX_OFFSET || input.readUInt32LE(ref) !== sequence) {
+      ip += 1
+      continue
+    }
+
+    let start = ip
+    let matchRef = ref
+    while (start > anchor && matchRef > 0 && input[start - 1] === input[matchRef - 1]) {
+      start -= 1
+      matchRef -= 1
+    }
+    let end = ip + MIN_MATCH
+    while (end < matchLimit && input[end] === input[end - ip + ref]) {
+      end += 1
+    }
+
+    op = writeSequence(out, op, input, anchor, start, start - matchRef, end - start)
+    ip = end
+    anchor = end
+  }
+
+  const literalLength = n - anchor
+  out[op++] = Math.min(literalLength, 15) << 4
+  if (literalLength >= 15) {
+    op = writeLength(out, op, literalLength - 15)
+  }
+  op += input.copy(out, op, anchor, n)
+  return out.subarray(0, op)
+}
+
+const encodeVarint = (value: number): number[] => {
+  const bytes: number[] = []
+  let v = value >>> 0
+  while (v >= 0x80) {
+    bytes.push((v & 0x7f) | 0x80)
+    v >>>= 7
+  }
+  bytes.push(v)
+  return bytes
+}
+
+// 完整的压缩帧：帧头 + LZ4 block
+export const encodeCompressedFrame = (raw: Buffer): Buffer => {
+  const header = [WS_COMPRESSION_FRAME_TAG, WS_COMPRESSION_CODEC_LZ4, ...encodeVarint(raw.length)]
+  return Buffer.concat([Buffer.from(header), compressLz4Block(raw)])
+}
+
+export interface CompressionClassStats {
+  enabled: boolean
+  messages: number
+  compressed: number
+  rawBytes: number
+  wireBytes: number
+  encodeUs: number
+}
+
+export interface CompressionSummaryEntry extends CompressionClassStats {
+  type: string
+  ratio: number
+  avgEncodeUs: number
+}
+
+export class WsMessageCompressor {
+  private readonly classes = new Map<string, CompressionClassStats>()
+
+  constructor(
+    private readonly minBytes: number,
+    private readonly maxRawBytes: number,
+    enabledTypes: string[] = WS_COMPRESSION_DEFAULT_CLASSES,
+  ) {
+    for (const type of enabledTypes) {
+      this.classes.set(type, {
+        enabled: true,
+        messages: 0,
+        compressed: 0,
+        rawBytes: 0,
+        wireBytes: 0,
+        encodeUs: 0,
+      })
+    }
+  }
+
+  public enabledTypes(): string[] {
+    return Array.from(this.classes.entries())
+      .filter(([, stats]) => stats.enabled)
+      .map(([type]) => type)
+  }
+
+  // 返回 null 表示该条消息按原文本发送
+  public encode(type: string, text: string): Buffer | null {
+    const stats = this.classes.get(type)
+    if (!stats || !stats.enabled) {
+      return null
+    }
+
+    const raw = Buffer.from(text, 'utf8')
+    stats.messages += 1
+    if (raw.length < this.minBytes || raw.length > this.maxRawBytes) {
+      stats.rawBytes += raw.length
+      stats.wireBytes += raw.length
+      return null
+    }
+
+    const started = process.hrtime.bigint()
+    const frame = encodeCompressedFrame(raw)
+    stats.encodeUs += Number(process.hrtime.bigint() - started) / 1000
+
+    const useFrame = frame.length < raw.length
+    stats.rawBytes += raw.length
+    stats.wireBytes += useFrame ? frame.length : raw.length
+    if (useFrame) {
+      stats.compressed += 1
+    }
+
+    if (stats.messages === PROBE_MESSAGES && stats.wireBytes > stats.rawBytes * KEEP_RATIO) {
+      stats.enabled = false
+      console.log(`[压缩] ${type} 收益不足（${stats.wireBytes}/${stats.rawBytes} 字节），停用`)
+    }
+
+    return useFrame ? frame : null
+  }
+
+  public summary(): CompressionSummaryEntry[] {
+    return Array.from(this.classes.entries())
+      .filter(([, stats]) => stats.messages > 0)
+      .map(([type, stats]) => ({
+        type,
+        ...stats,
+        encodeUs: Math.round(stats.encodeUs),
+        ratio: stats.rawBytes > 0 ? Number((stats.wireBytes / stats.rawBytes).toFixed(3)) : 1,
+        avgEncodeUs: stats.compressed > 0 ? Math.round(stats.encodeUs / stats.compressed) : 0,
+      }))
+  }
+}
@@ -146,6 +146,7 @@ function App() {
             case 'photo_control_ack':
             case 'sd_list_response':
             case 'sd_delete_response':
+            case 'sd_changed':
               // 控制面板可接收这些消息，但目前无需在主面板展示
               break;
 
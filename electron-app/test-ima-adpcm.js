@@ -0,0 +1,105 @@
+// IMA-ADPCM conformance: imaAdpcm.ts against the shared vectors that the
+// firmware codec test (esp32-firmware/test/test_ima_adpcm) replays. Both
+// sides must produce the same chunks and decode them to the same PCM.
+// Then times one chunk each way. Run after `npm run build`:
+//   node test-ima-adpcm.js            check the vectors
+//   node test-ima-adpcm.js --update   rewrite the expected columns
+import { readFileSync, writeFileSync } from 'fs'
+import { fileURLToPath } from 'url'
+import { createImaAdpcmState, decodeImaAdpcmChunk, encodeImaAdpcmChunk } from './dist/main/imaAdpcm.js'
+
+const vectorsPath = fileURLToPath(new URL('../esp32-firmware/test/test_ima_adpcm/vectors.txt', import.meta.url))
+const update = process.argv.includes('--update')
+const REPEATS = 2000
+
+const fromHex = (hex) => (hex === '-' ? Buffer.alloc(0) : Buffer.from(hex, 'hex'))
+const toHex = (buf) => (buf.length === 0 ? '-' : buf.toString('hex'))
+const toPcm = (buf) => {
+  const pcm = new Int16Array(buf.length / 2)
+  for (let i = 0; i < pcm.length; i += 1) {
+    pcm[i] = buf.readInt16LE(i * 2)
+  }
+  return pcm
+}
+
+// vector <name> <predictor> <index> <pcm s16le hex | -> = <chunk hex> <decoded pcm hex | ->
+const lines = readFileSync(vectorsPath, 'utf8').split('\n')
+let failures = 0
+let vectors = 0
+
+const out = []
+for (const [index, line] of lines.entries()) {
+  const words = line.trim().split(/\s+/)
+  if (words[0] !== 'vector') {
+    out.push(line)
+    continue
+  }
+  const [, name, predictor, stepIndex, pcmHex] = words
+  const pcm = toPcm(fromHex(pcmHex))
+  const state = { predictor: Number(predictor), index: Number(stepIndex) }
+  const chunk = encodeImaAdpcmChunk(state, pcm)
+  const decoded = decodeImaAdpcmChunk(chunk, pcm.length)
+  const expected = `${toHex(chunk)} ${decoded ? toHex(decoded) : 'null'}`
+  vectors += 1
+  if (!update && `${words[6]} ${words[7]}` !== expected) {
+    failures += 1
+    console.error(`line ${index + 1}: ${name} expected\n  ${words[6]} ${words[7]}\n  encoder gave\n  ${expected}`)
+  }
+  // The decoder must end where the encoder's own reconstruction did.
+  if (decoded && pcm.length > 0 && decoded.readInt16LE(decoded.length - 2) !== state.predictor) {
+    failures += 1
+    console.error(`line ${index + 1}: ${name} decodes to ${decoded.readInt16LE(decoded.length - 2)}, encoder predicted ${state.predictor}`)
+  }
+  out.push(`vector ${name} ${predictor} ${stepIndex} ${pcmHex} = ${expected}`)
+}
+
+// Chunks the decoder must refuse: step index above 88, wrong length.
+const good = encodeImaAdpcmChunk(createImaAdpcmState(), new Int16Array(5))
+const badIndex = Buffer.from(good)
+badIndex[2] = 89
+for (const [label, chunk, samples] of [
+  ['index 89', badIndex, 5],
+  ['one byte short', good.subarray(0, good.length - 1), 5],
+  ['wrong sample count', good, 7],
+]) {
+  if (decodeImaAdpcmChunk(chunk, samples) !== null) {
+    failures += 1
+    console.error(`bad chunk accepted: ${label}`)
+  }
+}
+
+if (update) {
+  writeFileSync(vectorsPath, out.join('\n'))
+  console.log(`Updated ${vectorsPath} (${vectors} vectors)`)
+  process.exit(0)
+}
+if (failures > 0) {
+  console.error(`${failures} check(s) failed`)
+  process.exit(1)
+}
+console.log(`IMA-ADPCM vectors OK (${vectors} vectors)`)
+
+// Cost per chunk: the mic stream (40 ms at 16 kHz, the server decodes) and
+// the desktop audio stream (20 ms at 48 kHz, the server encodes).
+for (const [label, samples] of [
+  ['mic 40 ms @ 16 kHz', 640],
+  ['desktop 20 ms @ 48 kHz', 960],
+]) {
+  const pcm = new Int16Array(samples)
+  for (let i = 0; i < samples; i += 1) {
+    pcm[i] = Math.round(8000 * Math.sin((2 * Math.PI * 440 * i) / 16000) + 2000 * Math.sin(i * 1.7))
+  }
+  const state = createImaAdpcmState()
+  let chunk = encodeImaAdpcmChunk(state, pcm)
+  let started = process.hrtime.bigint()
+  for (let i = 0; i < REPEATS; i += 1) {
+    chunk = encodeImaAdpcmChunk(state, pcm)
+  }
+  const encodeUs = Number(process.hrtime.bigint() - started) / 1000 / REPEATS
+  started = process.hrtime.bigint()
+  for (let i = 0; i < REPEATS; i += 1) {
+    decodeImaAdpcmChunk(chunk, samples)
+  }
+  const decodeUs = Number(process.hrtime.bigint() - started) / 1000 / REPEATS
+  console.log(`${label.padEnd(24)} encode ${encodeUs.toFixed(1)} us, decode ${decodeUs.toFixed(1)} us per chunk`)
+}
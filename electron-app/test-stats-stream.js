@@ -0,0 +1,60 @@
+// Stats stream conformance: StatsStreamEncoder against the shared vectors
+// that the firmware decoder test (esp32-firmware/test/test_stats_stream)
+// replays. Run after `npm run build`:
+//   node test-stats-stream.js            check the encoder output
+//   node test-stats-stream.js --update   rewrite the expected columns
+import { readFileSync, writeFileSync } from 'fs'
+import { fileURLToPath } from 'url'
+import { StatsStreamEncoder, quantizeStats } from './dist/main/statsStream.js'
+
+const vectorsPath = fileURLToPath(
+  new URL('../esp32-firmware/test/test_stats_stream/vectors.txt', import.meta.url),
+)
+const update = process.argv.includes('--update')
+
+// sample <cpu> <memory> <upload> <download> = <q0> <q1> <q2> <q3> <frame hex | ->
+const lines = readFileSync(vectorsPath, 'utf8').split('\n')
+const encoder = new StatsStreamEncoder(1)
+let failures = 0
+let frames = 0
+
+const out = lines.map((line, index) => {
+  const words = line.trim().split(/\s+/)
+  if (words[0] === 'interval') {
+    encoder.setKeyframeInterval(Number(words[1]))
+    return line
+  }
+  if (words[0] === 'force') {
+    encoder.forceKeyframe()
+    return line
+  }
+  if (words[0] !== 'sample') {
+    return line
+  }
+
+  const [cpu, memory, upload, download] = words.slice(1, 5).map(Number)
+  const sample = { cpu, memory, upload, download }
+  const q = quantizeStats(sample)
+  const frame = encoder.encode(sample)
+  const hex = frame ? frame.toString('hex') : '-'
+  const expected = `${q.join(' ')} ${hex}`
+  const actual = words.slice(6).join(' ')
+  if (frame) {
+    frames += 1
+  }
+  if (!update && actual !== expected) {
+    failures += 1
+    console.error(`line ${index + 1}: expected "${actual}", encoder gave "${expected}"`)
+  }
+  return `sample ${words.slice(1, 5).join(' ')} = ${expected}`
+})
+
+if (update) {
+  writeFileSync(vectorsPath, out.join('\n'))
+  console.log(`Updated ${vectorsPath} (${frames} frames)`)
+} else if (failures > 0) {
+  console.error(`${failures} vector(s) differ`)
+  process.exit(1)
+} else {
+  console.log(`Stats stream vectors OK (${frames} frames)`)
+}
@@ -0,0 +1,133 @@
+// WebSocket compression: the LZ4 encoder against the shared vectors that the
+// firmware decoder test (esp32-firmware/test/test_ws_compression) replays,
+// then a replay benchmark over a message trace. Run after `npm run build`:
+//   node test-ws-compression.js                  check vectors, replay trace.jsonl
+//   node test-ws-compression.js --update         rewrite the expected frames
+//   node test-ws-compression.js --trace <file>   replay another trace
+// A trace is one device-bound JSON text per line, as the server writes it
+// with WS_TRACE_FILE set.
+import { readFileSync, writeFileSync } from 'fs'
+import { fileURLToPath } from 'url'
+import {
+  WS_COMPRESSION_DEFAULT_MIN_BYTES,
+  WsMessageCompressor,
+  compressLz4Block,
+  encodeCompressedFrame,
+} from './dist/main/wsCompression.js'
+
+const testDir = new URL('../esp32-firmware/test/test_ws_compression/', import.meta.url)
+const vectorsPath = fileURLToPath(new URL('vectors.txt', testDir))
+const update = process.argv.includes('--update')
+const traceArg = process.argv.indexOf('--trace')
+const tracePath = traceArg > 0 ? process.argv[traceArg + 1] : fileURLToPath(new URL('trace.jsonl', testDir))
+const MAX_RAW_BYTES = 16384 // WS_COMPRESSION_MAX_RAW_BYTES
+const REPEATS = 200
+
+const fromHex = (hex) => (hex === '-' ? Buffer.alloc(0) : Buffer.from(hex, 'hex'))
+const toHex = (buf) => (buf.length === 0 ? '-' : buf.toString('hex'))
+
+// vector <name> <raw hex | -> = <frame hex>
+// trace <line> = <frame hex>        (line of trace.jsonl, from 1)
+const defaultTrace = traceArg < 0
+const traceLines = readFileSync(tracePath, 'utf8').split('\n').filter((line) => line.trim().length > 0)
+const lines = readFileSync(vectorsPath, 'utf8').split('\n')
+let failures = 0
+let vectors = 0
+let traceFrames = 0
+
+const out = []
+for (const [index, line] of lines.entries()) {
+  const words = line.trim().split(/\s+/)
+  if (words[0] === 'trace') {
+    traceFrames += 1
+    if (defaultTrace && !update) {
+      const raw = Buffer.from(traceLines[Number(words[1]) - 1] ?? '', 'utf8')
+      const expected = toHex(encodeCompressedFrame(raw))
+      if (words[3] !== expected) {
+        failures += 1
+        console.error(`line ${index + 1}: trace ${words[1]} encodes differently`)
+      }
+    }
+    continue
+  }
+  if (words[0] !== 'vector') {
+    out.push(line)
+    continue
+  }
+  const expected = toHex(encodeCompressedFrame(fromHex(words[2])))
+  vectors += 1
+  if (!update && words[4] !== expected) {
+    failures += 1
+    console.error(`line ${index + 1}: ${words[1]} expected ${words[4]}, encoder gave ${expected}`)
+  }
+  out.push(`vector ${words[1]} ${words[2]} = ${expected}`)
+}
+
+if (update) {
+  while (out.length > 0 && out[out.length - 1].trim() === '') {
+    out.pop()
+  }
+  traceLines.forEach((text, i) => {
+    out.push(`trace ${i + 1} = ${toHex(encodeCompressedFrame(Buffer.from(text, 'utf8')))}`)
+  })
+  writeFileSync(vectorsPath, `${out.join('\n')}\n`)
+  console.log(`Updated ${vectorsPath} (${vectors} vectors, ${traceLines.length} trace frames)`)
+  process.exit(0)
+}
+if (defaultTrace && traceFrames !== traceLines.length) {
+  failures += 1
+  console.error(`vectors.txt has ${traceFrames} trace frames, trace.jsonl ${traceLines.length} messages`)
+}
+if (failures > 0) {
+  console.error(`${failures} vector(s) differ`)
+  process.exit(1)
+}
+console.log(`WS compression vectors OK (${vectors} vectors, ${traceLines.length} trace frames)`)
+
+// Replay: per message type, what LZ4 would save and what it costs to encode,
+// then what the server's policy (default classes, 256-byte threshold,
+// probe-and-disable) actually puts on air for this trace.
+const perType = new Map()
+for (const text of traceLines) {
+  const type = JSON.parse(text).type ?? '?'
+  const raw = Buffer.from(text, 'utf8')
+  const started = process.hrtime.bigint()
+  for (let i = 0; i < REPEATS; i += 1) {
+    compressLz4Block(raw)
+  }
+  const encodeUs = Number(process.hrtime.bigint() - started) / 1000 / REPEATS
+  const frame = encodeCompressedFrame(raw)
+  const entry = perType.get(type) ?? { messages: 0, rawBytes: 0, lz4Bytes: 0, encodeUs: 0 }
+  entry.messages += 1
+  entry.rawBytes += raw.length
+  entry.lz4Bytes += Math.min(frame.length, raw.length)
+  entry.encodeUs += encodeUs
+  perType.set(type, entry)
+}
+
+console.log(`\nReplay of ${tracePath} (${traceLines.length} messages)`)
+console.log('type                        msgs   raw B   lz4 B  ratio  encode us/msg')
+for (const [type, e] of [...perType.entries()].sort((a, b) => b[1].rawBytes - a[1].rawBytes)) {
+  console.log(
+    `${type.padEnd(26)} ${String(e.messages).padStart(5)} ${String(e.rawBytes).padStart(7)} ${String(e.lz4Bytes).padStart(7)}` +
+      `  ${(e.lz4Bytes / e.rawBytes).toFixed(3)}  ${(e.encodeUs / e.messages).toFixed(1).padStart(8)}`,
+  )
+}
+
+const compressor = new WsMessageCompressor(WS_COMPRESSION_DEFAULT_MIN_BYTES, MAX_RAW_BYTES)
+let rawTotal = 0
+let airTotal = 0
+for (const text of traceLines) {
+  const type = JSON.parse(text).type ?? '?'
+  const raw = Buffer.byteLength(text, 'utf8')
+  const frame = compressor.encode(type, text)
+  rawTotal += raw
+  airTotal += frame ? frame.length : raw
+}
+console.log(`\nServer policy: ${airTotal}/${rawTotal} bytes on air (${((airTotal / rawTotal) * 100).toFixed(1)}%)`)
+for (const entry of compressor.summary()) {
+  console.log(
+    `  ${entry.type.padEnd(22)} ${entry.enabled ? 'on ' : 'off'} ${entry.compressed}/${entry.messages} compressed` +
+      `  ratio ${entry.ratio}  ${entry.avgEncodeUs} us/msg`,
+  )
+}
@@ -59,6 +59,11 @@
         //#define LV_MEM_POOL_ALLOC   your_alloc          /* Uncomment if using an external allocator*/
     #endif
 
+#elif defined(UI_SIM_HOST)  /*Host simulator (env:native-sim): plain heap*/
+    #define LV_MEM_CUSTOM_INCLUDE <stdlib.h>
+    #define LV_MEM_CUSTOM_ALLOC   malloc
+    #define LV_MEM_CUSTOM_FREE    free
+    #define LV_MEM_CUSTOM_REALLOC realloc
 #else       /*LV_MEM_CUSTOM*/
     #define LV_MEM_CUSTOM_INCLUDE <esp_heap_caps.h>   /*Header for the dynamic memory function*/
     #define LV_MEM_CUSTOM_ALLOC(size)   heap_caps_malloc_prefer((size), 2, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT, MALLOC_CAP_8BIT)
@@ -86,7 +91,10 @@
 /*Use a custom tick source that tells the elapsed time in milliseconds.
  *It removes the need to manually update the tick with `lv_tick_inc()`)*/
 #define LV_TICK_CUSTOM 1
-#if LV_TICK_CUSTOM
+#if LV_TICK_CUSTOM && defined(UI_SIM_HOST)
+    #define LV_TICK_CUSTOM_INCLUDE "sim/sim_clock.h"   /*Virtual clock stepped by the benchmark script*/
+    #define LV_TICK_CUSTOM_SYS_TIME_EXPR (sim_millis())
+#elif LV_TICK_CUSTOM
     #define LV_TICK_CUSTOM_INCLUDE "Arduino.h"         /*Header for the system time function*/
     #define LV_TICK_CUSTOM_SYS_TIME_EXPR (millis())    /*Expression evaluating to current system time in ms*/
 #endif   /*LV_TICK_CUSTOM*/
@@ -242,8 +250,9 @@
  * Others
  *-----------*/
 
-/*1: Show CPU usage and FPS count*/
-#define LV_USE_PERF_MONITOR 1
+/*1: Show CPU usage and FPS count
+ *Off: scr_st77916.h draws its own monitor (LCD_PERF_MONITOR) that adds frame time*/
+#define LV_USE_PERF_MONITOR 0
 #if LV_USE_PERF_MONITOR
     #define LV_USE_PERF_MONITOR_POS LV_ALIGN_BOTTOM_RIGHT
 #endif
@@ -649,7 +658,7 @@
  *----------*/
 
 /*1: Enable API to take snapshot for object*/
-#define LV_USE_SNAPSHOT 0
+#define LV_USE_SNAPSHOT 1
 
 /*1: Enable Monkey test*/
 #define LV_USE_MONKEY   0
@@ -0,0 +1,151 @@
+#ifndef _GAPLESS_OUTPUT_H_
+#define _GAPLESS_OUTPUT_H_
+
+#include <Arduino.h>
+#include <AudioOutput.h>
+#include "spectrum.h"
+
+// Pass-through AudioOutput that keeps the sink open across tracks. Generators
+// call begin()/stop()/SetRate() on every track; on the I2S sink those restart
+// and zero the DMA ring, which is the audible gap between songs. Here only
+// the first begin(), real rate changes and an explicit close() reach the sink.
+//
+// It also counts DMA underruns. Generators return once the sink refuses a
+// sample, so after each pass the DMA queue is full; its depth is what the
+// first pass after a resync managed to queue. If more time than that depth
+// passes between two passes, the queue ran dry.
+//
+// An optional spectrum tap sees every sample the sink accepts.
+class AudioOutputGapless : public AudioOutput {
+public:
+  explicit AudioOutputGapless(AudioOutput *sink) : sink_(sink) {}
+
+  // Applied lazily on the next sample: MP3 begin() sets a 44.1 kHz default
+  // before the first frame header gives the real rate.
+  bool SetRate(int hz) override
+  {
+    rateHz_ = hz;
+    return true;
+  }
+  bool SetBitsPerSample(int bits) override { return sink_->SetBitsPerSample(bits); }
+  bool SetChannels(int chan) override { return sink_->SetChannels(chan); }
+  bool SetGain(float f) override { return sink_->SetGain(f); }
+
+  void setTap(SpectrumTap *tap)
+  {
+    tap_ = tap;
+    if (tap_ != nullptr && sinkRateHz_ > 0) {
+      tap_->rateHz.store((uint32_t)sinkRateHz_, std::memory_order_relaxed);
+    }
+  }
+
+  bool begin() override
+  {
+    if (!open_) {
+      sink_->SetRate(rateHz_);
+      sinkRateHz_ = rateHz_;
+      publishTapRate();
+      open_ = sink_->begin();
+      resync();
+    }
+    return open_;
+  }
+
+  bool ConsumeSample(int16_t sample[2]) override
+  {
+    applyRate();
+    if (!sink_->ConsumeSample(sample)) {
+      return false;
+    }
+    framesQueued_++;
+    if (tap_ != nullptr) {
+      spectrumTapPush(tap_, sample[0], sample[1]);
+    }
+    return true;
+  }
+
+  uint16_t ConsumeSamples(int16_t *samples, uint16_t count) override
+  {
+    applyRate();
+    const uint16_t n = sink_->ConsumeSamples(samples, count);
+    framesQueued_ += n;
+    if (tap_ != nullptr) {
+      for (uint16_t i = 0; i < n; ++i) {
+        spectrumTapPush(tap_, samples[2 * i], samples[2 * i + 1]);
+      }
+    }
+    return n;
+  }
+
+  // Per-track stop from a generator: keep the sink running.
+  bool stop() override { return true; }
+  bool loop() override { return sink_->loop(); }
+
+  bool close()
+  {
+    const bool ok = open_ ? sink_->stop() : true;
+    open_ = false;
+    resync();
+    return ok;
+  }
+
+  // Call after a pause or anything else that legitimately drains the DMA.
+  void resync()
+  {
+    framesQueued_ = 0;
+    depthFrames_ = 0;
+  }
+
+  // Call after each generator pass. Slack covers scheduling jitter.
+  void checkUnderrun()
+  {
+    const uint32_t now = micros();
+    if (!open_ || sinkRateHz_ <= 0) {
+      return;
+    }
+    if (depthFrames_ == 0) {
+      depthFrames_ = framesQueued_;
+      lastPassUs_ = now;
+      return;
+    }
+    const uint64_t elapsedFrames = (uint64_t)(uint32_t)(now - lastPassUs_) * (uint32_t)sinkRateHz_ / 1000000ULL;
+    const uint32_t slack = (uint32_t)sinkRateHz_ / 200;   // 5 ms
+    if (elapsedFrames > depthFrames_ + slack) {
+      underruns_++;
+    }
+    lastPassUs_ = now;
+  }
+
+  uint32_t underruns() const { return underruns_; }
+  bool isOpen() const { return open_; }
+
+private:
+  void applyRate()
+  {
+    if (rateHz_ != sinkRateHz_) {
+      sink_->SetRate(rateHz_);
+      sinkRateHz_ = rateHz_;
+      publishTapRate();
+      resync();
+    }
+  }
+
+  void publishTapRate()
+  {
+    if (tap_ != nullptr) {
+      tap_->rateHz.store((uint32_t)sinkRateHz_, std::memory_order_relaxed);
+    }
+  }
+
+  AudioOutput *sink_;
+  int rateHz_ = 44100;
+  int sinkRateHz_ = 0;
+  bool open_ = false;
+  uint32_t framesQueued_ = 0;   // since the last resync
+  uint32_t depthFrames_ = 0;
+  uint32_t lastPassUs_ = 0;
+  uint32_t underruns_ = 0;
+  SpectrumTap *tap_ = nullptr;
+};
+
+#endif
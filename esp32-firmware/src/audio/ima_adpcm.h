@@ -0,0 +1,137 @@
+#ifndef _IMA_ADPCM_H_
+#define _IMA_ADPCM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// IMA-ADPCM codec (4 bits per sample): the encoder feeds the mic stream, the
+// decoder the desktop audio stream. Must match electron-app/src/main/imaAdpcm.ts.
+// Each chunk is self-contained so a lost chunk does not desync the server:
+//   [0..1] predictor at chunk start (int16 LE)
+//   [2]    step index at chunk start
+//   [3]    reserved (0)
+//   then ceil(n / 2) bytes, first sample in the low nibble.
+#define IMA_ADPCM_HEADER_BYTES 4
+#define IMA_ADPCM_CHUNK_BYTES(samples) (IMA_ADPCM_HEADER_BYTES + ((samples) + 1) / 2)
+
+struct ImaAdpcmState {
+  int32_t predictor;
+  int8_t index;
+};
+
+static const int16_t IMA_ADPCM_STEPS[89] = {
+  7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+  50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190, 209, 230,
+  253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796, 876, 963,
+  1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+  3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442,
+  11487, 12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794,
+  32767,
+};
+
+static const int8_t IMA_ADPCM_INDEX_ADJUST[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+static inline void imaAdpcmReset(ImaAdpcmState *state)
+{
+  state->predictor = 0;
+  state->index = 0;
+}
+
+static inline uint8_t imaAdpcmEncodeSample(ImaAdpcmState *state, int16_t sample)
+{
+  const int32_t step = IMA_ADPCM_STEPS[state->index];
+  int32_t diff = (int32_t)sample - state->predictor;
+  uint8_t code = 0;
+  if (diff < 0) {
+    code = 8;
+    diff = -diff;
+  }
+
+  // Same rounding as the decoder's reconstruction, so both sides track.
+  int32_t delta = step >> 3;
+  if (diff >= step) {
+    code |= 4;
+    diff -= step;
+    delta += step;
+  }
+  if (diff >= (step >> 1)) {
+    code |= 2;
+    diff -= step >> 1;
+    delta += step >> 1;
+  }
+  if (diff >= (step >> 2)) {
+    code |= 1;
+    delta += step >> 2;
+  }
+
+  int32_t predictor = state->predictor + ((code & 8) ? -delta : delta);
+  if (predictor > 32767) {
+    predictor = 32767;
+  } else if (predictor < -32768) {
+    predictor = -32768;
+  }
+  state->predictor = predictor;
+
+  int32_t index = state->index + IMA_ADPCM_INDEX_ADJUST[code & 7];
+  state->index = (int8_t)((index < 0) ? 0 : (index > 88) ? 88 : index);
+  return code;
+}
+
+// Encodes one chunk into out (IMA_ADPCM_CHUNK_BYTES(count) bytes) and returns
+// the byte count. State carries across chunks for continuity.
+static size_t imaAdpcmEncodeChunk(ImaAdpcmState *state, const int16_t *pcm, size_t count, uint8_t *out)
+{
+  out[0] = (uint8_t)(state->predictor & 0xFF);
+  out[1] = (uint8_t)((state->predictor >> 8) & 0xFF);
+  out[2] = (uint8_t)state->index;
+  out[3] = 0;
+
+  uint8_t *dst = out + IMA_ADPCM_HEADER_BYTES;
+  for (size_t i = 0; i < count; i += 2) {
+    uint8_t packed = imaAdpcmEncodeSample(state, pcm[i]);
+    if (i + 1 < count) {
+      packed |= (uint8_t)(imaAdpcmEncodeSample(state, pcm[i + 1]) << 4);
+    }
+    *dst++ = packed;
+  }
+  return (size_t)(dst - out);
+}
+
+// Decodes one chunk of `count` samples. Returns false if the length or the
+// header is invalid.
+static bool imaAdpcmDecodeChunk(const uint8_t *in, size_t len, size_t count, int16_t *pcm)
+{
+  if (len != IMA_ADPCM_CHUNK_BYTES(count) || in[2] > 88) {
+    return false;
+  }
+
+  int32_t predictor = (int16_t)(in[0] | (in[1] << 8));
+  int32_t index = in[2];
+  const uint8_t *src = in + IMA_ADPCM_HEADER_BYTES;
+  for (size_t i = 0; i < count; ++i) {
+    const uint8_t code = (i & 1) ? (src[i >> 1] >> 4) : (src[i >> 1] & 0x0F);
+    const int32_t step = IMA_ADPCM_STEPS[index];
+    int32_t delta = step >> 3;
+    if (code & 4) {
+      delta += step;
+    }
+    if (code & 2) {
+      delta += step >> 1;
+    }
+    if (code & 1) {
+      delta += step >> 2;
+    }
+    predictor += (code & 8) ? -delta : delta;
+    if (predictor > 32767) {
+      predictor = 32767;
+    } else if (predictor < -32768) {
+      predictor = -32768;
+    }
+    index += IMA_ADPCM_INDEX_ADJUST[code & 7];
+    index = (index < 0) ? 0 : (index > 88) ? 88 : index;
+    pcm[i] = (int16_t)predictor;
+  }
+  return true;
+}
+
+#endif
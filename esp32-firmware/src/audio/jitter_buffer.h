@@ -0,0 +1,379 @@
+#ifndef _JITTER_BUFFER_H_
+#define _JITTER_BUFFER_H_
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Playout buffer for the desktop audio stream. The producer pushes decoded
+// mono frames tagged with the sender's frame number (frame n starts at sender
+// sample n * frameSamples); the consumer pulls samples at the I2S clock.
+//   - Target depth follows the measured inter-arrival jitter (RFC 3550 mean
+//     deviation plus a slowly decaying peak) and is raised after underruns.
+//   - Drift between the sender clock and the I2S clock shows up as a creeping
+//     fill level; it is trimmed by dropping or inserting one interpolated
+//     sample per frame until the averaged fill is back at the target. The
+//     fill is sampled on each arrival, counting the part of the current
+//     frame not yet played, so a creep shows well before a whole frame.
+//   - A missing frame is concealed by repeating the last good one under a
+//     fade-out; after JB_CONCEAL_FRAMES of starvation it rebuffers.
+// Pure C++ without Arduino dependencies so timing can be simulated on a host.
+// Not thread-safe: the caller serializes push and pull.
+#define JB_EMPTY_TAG 0xFFFFFFFFu
+#define JB_MIN_FRAMES 2
+#define JB_JITTER_MULT 4.0f
+#define JB_PEAK_DECAY 0.998f
+#define JB_FILL_SMOOTH 16.0f
+#define JB_DRIFT_ON_FRAMES 0.5f    // averaged fill this far off target: start trimming
+#define JB_DRIFT_OFF_FRAMES 0.2f
+#define JB_CATCHUP_FRAMES 4        // fill this far above target: drop whole frames
+#define JB_CONCEAL_FRAMES 3
+#define JB_FADE_IN_SAMPLES 64
+#define JB_FLOOR_DECAY_FRAMES 500  // clean frames before an underrun bump is undone
+
+enum JitterBufferState : uint8_t {
+  JB_STATE_IDLE = 0,
+  JB_STATE_BUFFERING,
+  JB_STATE_PLAYING,
+  JB_STATE_ENDED,
+};
+
+struct JitterBufferStats {
+  uint32_t received;
+  uint32_t late;
+  uint32_t duplicates;
+  uint32_t overflows;       // frames discarded because they arrived too far ahead
+  uint32_t lost;            // frames concealed while later frames were present
+  uint32_t concealed;       // all concealed frames, including starvation
+  uint32_t underruns;       // rebuffer events
+  uint32_t skipped;         // whole frames dropped to catch up
+  uint32_t samplesDropped;
+  uint32_t samplesInserted;
+  uint32_t samplesPlayed;
+};
+
+struct JitterBuffer {
+  int16_t *pcm;             // slots * maxFrameSamples, then one concealment frame
+  uint32_t *tags;           // frame number held by each slot
+  uint16_t slots;
+  uint16_t maxFrameSamples;
+
+  uint32_t sampleRate;
+  uint16_t frameSamples;
+  float frameMs;
+  JitterBufferState state;
+  bool ending;              // sender announced its last frame
+
+  uint32_t playFrame;
+  uint16_t playOffset;
+  uint32_t endFrame;        // one past the newest frame received
+  const int16_t *current;
+  bool currentReal;
+  bool holdFrame;           // starvation concealment does not consume sender time
+  uint8_t concealRun;
+  int32_t gainQ15;
+  int32_t gainStep;
+  int16_t lastOut;
+
+  bool haveArrival;
+  uint32_t lastArrivalMs;
+  uint32_t lastArrivalFrame;
+  float jitterMs;
+  float jitterPeakMs;
+  float fillAvg;
+  uint16_t floorFrames;
+  uint16_t targetFrames;
+  uint32_t cleanFrames;
+  int8_t driftStep;         // -1 drop, +1 insert, 0 off
+
+  JitterBufferStats stats;
+};
+
+static inline uint32_t jitterBufferStorageSamples(uint16_t slots, uint16_t maxFrameSamples)
+{
+  return (uint32_t)(slots + 1) * maxFrameSamples;
+}
+
+static void jitterBufferInit(JitterBuffer *jb, int16_t *pcm, uint32_t *tags, uint16_t slots, uint16_t maxFrameSamples)
+{
+  memset(jb, 0, sizeof(*jb));
+  jb->pcm = pcm;
+  jb->tags = tags;
+  jb->slots = slots;
+  jb->maxFrameSamples = maxFrameSamples;
+  jb->state = JB_STATE_IDLE;
+}
+
+static inline int16_t *jitterBufferConcealFrame(JitterBuffer *jb)
+{
+  return jb->pcm + (uint32_t)jb->slots * jb->maxFrameSamples;
+}
+
+static void jitterBufferUpdateTarget(JitterBuffer *jb)
+{
+  const float delayMs = fmaxf(JB_JITTER_MULT * jb->jitterMs, jb->jitterPeakMs);
+  uint32_t target = 1 + (uint32_t)ceilf(delayMs / jb->frameMs);
+  if (target < jb->floorFrames) {
+    target = jb->floorFrames;
+  }
+  if (target < JB_MIN_FRAMES) {
+    target = JB_MIN_FRAMES;
+  }
+  if (target > (uint32_t)jb->slots - 2) {
+    target = jb->slots - 2;
+  }
+  jb->targetFrames = (uint16_t)target;
+}
+
+// Resets for a new stream. Returns false if the frame does not fit the storage.
+static bool jitterBufferStart(JitterBuffer *jb, uint32_t sampleRate, uint16_t frameSamples)
+{
+  if (sampleRate == 0 || frameSamples == 0 || frameSamples > jb->maxFrameSamples || jb->slots < JB_MIN_FRAMES + 2) {
+    return false;
+  }
+  JitterBuffer fresh;
+  jitterBufferInit(&fresh, jb->pcm, jb->tags, jb->slots, jb->maxFrameSamples);
+  *jb = fresh;
+  for (uint16_t i = 0; i < jb->slots; ++i) {
+    jb->tags[i] = JB_EMPTY_TAG;
+  }
+  memset(jitterBufferConcealFrame(jb), 0, frameSamples * sizeof(int16_t));
+  jb->sampleRate = sampleRate;
+  jb->frameSamples = frameSamples;
+  jb->frameMs = frameSamples * 1000.0f / sampleRate;
+  jb->state = JB_STATE_BUFFERING;
+  jb->floorFrames = JB_MIN_FRAMES;
+  jitterBufferUpdateTarget(jb);
+  jb->fillAvg = jb->targetFrames;
+  return true;
+}
+
+static inline uint32_t jitterBufferFill(const JitterBuffer *jb)
+{
+  const int32_t ahead = (int32_t)(jb->endFrame - jb->playFrame);
+  return (ahead > 0) ? (uint32_t)ahead : 0;
+}
+
+// Buffered audio ahead of the playout point, in milliseconds.
+static inline uint32_t jitterBufferDepthMs(const JitterBuffer *jb)
+{
+  return (uint32_t)(jitterBufferFill(jb) * jb->frameMs);
+}
+
+// Net sample correction applied so far, in parts per million of playback.
+static inline int32_t jitterBufferCorrectionPpm(const JitterBuffer *jb)
+{
+  if (jb->stats.samplesPlayed == 0) {
+    return 0;
+  }
+  const int64_t net = (int64_t)jb->stats.samplesInserted - (int64_t)jb->stats.samplesDropped;
+  return (int32_t)(net * 1000000LL / (int64_t)jb->stats.samplesPlayed);
+}
+
+// Producer side. `count` may be short on the final frame; the rest is silence.
+static void jitterBufferPush(JitterBuffer *jb, uint32_t frame, const int16_t *pcm, uint16_t count, uint32_t nowMs)
+{
+  if (jb->state == JB_STATE_IDLE || jb->state == JB_STATE_ENDED || count > jb->frameSamples) {
+    return;
+  }
+
+  if (jb->stats.received == 0) {
+    jb->playFrame = frame;
+    jb->endFrame = frame;
+  }
+  jb->stats.received++;
+
+  if (jb->haveArrival) {
+    const float transit = (float)(int32_t)(nowMs - jb->lastArrivalMs) -
+                          (float)(int32_t)(frame - jb->lastArrivalFrame) * jb->frameMs;
+    const float d = fabsf(transit);
+    jb->jitterMs += (d - jb->jitterMs) / 16.0f;
+    jb->jitterPeakMs = fmaxf(d, jb->jitterPeakMs * JB_PEAK_DECAY);
+    jitterBufferUpdateTarget(jb);
+  }
+  jb->haveArrival = true;
+  jb->lastArrivalMs = nowMs;
+  jb->lastArrivalFrame = frame;
+
+  const int32_t ahead = (int32_t)(frame - jb->playFrame);
+  if (ahead < 0 || (ahead == 0 && jb->playOffset > 0 && !jb->holdFrame)) {
+    jb->stats.late++;
+    return;
+  }
+  if (ahead >= jb->slots) {
+    // Far ahead of playout (sender burst after a stall): restart the
+    // playout point so the newest frame lands at the target depth.
+    jb->stats.overflows += (uint32_t)ahead - jb->slots + 1;
+    const uint32_t newPlay = frame - (jb->targetFrames - 1);
+    while ((int32_t)(newPlay - jb->playFrame) > 0) {
+      const uint16_t slot = (uint16_t)(jb->playFrame % jb->slots);
+      if (jb->tags[slot] == jb->playFrame) {
+        jb->tags[slot] = JB_EMPTY_TAG;
+      }
+      jb->playFrame++;
+    }
+    jb->playOffset = 0;
+  }
+
+  const uint16_t slot = (uint16_t)(frame % jb->slots);
+  if (jb->tags[slot] == frame) {
+    jb->stats.duplicates++;
+    return;
+  }
+  int16_t *dst = jb->pcm + (uint32_t)slot * jb->maxFrameSamples;
+  memcpy(dst, pcm, count * sizeof(int16_t));
+  if (count < jb->frameSamples) {
+    memset(dst + count, 0, (jb->frameSamples - count) * sizeof(int16_t));
+  }
+  jb->tags[slot] = frame;
+  if ((int32_t)(frame + 1 - jb->endFrame) > 0) {
+    jb->endFrame = frame + 1;
+    if (jb->state == JB_STATE_PLAYING) {
+      const float fill = (float)jitterBufferFill(jb) - (float)jb->playOffset / jb->frameSamples;
+      jb->fillAvg += (fill - jb->fillAvg) / JB_FILL_SMOOTH;
+    }
+  }
+
+  if (jb->state == JB_STATE_BUFFERING && jitterBufferFill(jb) >= jb->targetFrames) {
+    jb->state = JB_STATE_PLAYING;
+  }
+}
+
+// The sender has no more frames: play out what is buffered, then end.
+static inline void jitterBufferMarkEnd(JitterBuffer *jb)
+{
+  jb->ending = true;
+  if (jb->state == JB_STATE_BUFFERING && jb->stats.received > 0) {
+    jb->state = JB_STATE_PLAYING;
+  }
+}
+
+// Picks the source for the frame at playFrame. Returns false if playback
+// stopped (rebuffering or end of stream).
+static bool jitterBufferBeginFrame(JitterBuffer *jb)
+{
+  for (;;) {
+    const uint16_t slot = (uint16_t)(jb->playFrame % jb->slots);
+    if (jb->tags[slot] == jb->playFrame) {
+      const uint32_t fill = jitterBufferFill(jb);
+      if (fill > (uint32_t)jb->targetFrames + JB_CATCHUP_FRAMES) {
+        jb->tags[slot] = JB_EMPTY_TAG;
+        jb->playFrame++;
+        jb->stats.skipped++;
+        jb->fillAvg = fill - 1;
+        continue;
+      }
+
+      const float error = jb->fillAvg - jb->targetFrames;
+      if (error > JB_DRIFT_ON_FRAMES) {
+        jb->driftStep = -1;
+      } else if (error < -JB_DRIFT_ON_FRAMES) {
+        jb->driftStep = 1;
+      } else if (fabsf(error) < JB_DRIFT_OFF_FRAMES) {
+        jb->driftStep = 0;
+      }
+
+      jb->current = jb->pcm + (uint32_t)slot * jb->maxFrameSamples;
+      memcpy(jitterBufferConcealFrame(jb), jb->current, jb->frameSamples * sizeof(int16_t));
+      jb->currentReal = true;
+      jb->holdFrame = false;
+      jb->concealRun = 0;
+      jb->gainStep = 32768 / JB_FADE_IN_SAMPLES;
+      if (++jb->cleanFrames >= JB_FLOOR_DECAY_FRAMES && jb->floorFrames > JB_MIN_FRAMES) {
+        jb->floorFrames--;
+        jb->cleanFrames = 0;
+        jitterBufferUpdateTarget(jb);
+      }
+      return true;
+    }
+
+    const bool starved = (int32_t)(jb->endFrame - jb->playFrame) <= 0;
+    if (starved && jb->ending) {
+      jb->state = JB_STATE_ENDED;
+      return false;
+    }
+    if (starved && jb->concealRun >= JB_CONCEAL_FRAMES) {
+      jb->state = JB_STATE_BUFFERING;
+      jb->stats.underruns++;
+      jb->cleanFrames = 0;
+      if (jb->floorFrames < jb->slots - 2) {
+        jb->floorFrames++;
+      }
+      jitterBufferUpdateTarget(jb);
+      jb->fillAvg = jb->targetFrames;
+      jb->driftStep = 0;
+      return false;
+    }
+
+    if (!starved) {
+      jb->stats.lost++;
+    }
+    jb->stats.concealed++;
+    jb->concealRun++;
+    jb->current = jitterBufferConcealFrame(jb);
+    jb->currentReal = false;
+    jb->holdFrame = starved;
+    jb->gainStep = -(32768 / (JB_CONCEAL_FRAMES * (int32_t)jb->frameSamples)) - 1;
+    return true;
+  }
+}
+
+static void jitterBufferEndFrame(JitterBuffer *jb)
+{
+  if (jb->currentReal) {
+    const uint16_t slot = (uint16_t)(jb->playFrame % jb->slots);
+    jb->tags[slot] = JB_EMPTY_TAG;
+  }
+  if (!jb->holdFrame) {
+    jb->playFrame++;
+  }
+  jb->playOffset = 0;
+}
+
+// Consumer side: always writes `count` samples (silence while not playing).
+static void jitterBufferPull(JitterBuffer *jb, int16_t *out, uint32_t count)
+{
+  uint32_t produced = 0;
+  while (produced < count) {
+    if (jb->state != JB_STATE_PLAYING) {
+      memset(out + produced, 0, (count - produced) * sizeof(int16_t));
+      jb->lastOut = 0;
+      jb->gainQ15 = 0;
+      return;
+    }
+    if (jb->playOffset == 0 && !jitterBufferBeginFrame(jb)) {
+      continue;
+    }
+
+    int32_t s = jb->current[jb->playOffset++];
+    if (jb->driftStep != 0 && jb->currentReal && jb->playOffset == jb->frameSamples / 2) {
+      if (jb->driftStep < 0 && jb->playOffset < jb->frameSamples) {
+        // Drop: merge this sample with the next one.
+        s = (s + jb->current[jb->playOffset++]) / 2;
+        jb->stats.samplesDropped++;
+      } else if (jb->driftStep > 0 && produced + 1 < count) {
+        // Insert: an interpolated sample ahead of this one.
+        out[produced++] = (int16_t)((jb->lastOut + s * jb->gainQ15 / 32768) / 2);
+        jb->stats.samplesInserted++;
+      }
+    }
+
+    jb->gainQ15 += jb->gainStep;
+    if (jb->gainQ15 > 32768) {
+      jb->gainQ15 = 32768;
+    } else if (jb->gainQ15 < 0) {
+      jb->gainQ15 = 0;
+    }
+    s = s * jb->gainQ15 / 32768;
+    out[produced++] = (int16_t)s;
+    jb->lastOut = (int16_t)s;
+    jb->stats.samplesPlayed++;
+
+    if (jb->playOffset >= jb->frameSamples) {
+      jitterBufferEndFrame(jb);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef _KWS_FEATURES_H_
+#define _KWS_FEATURES_H_
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Keyword-spotting front end: 32 ms Hann window every 20 ms hop, 512-point
+// FFT, 32 log-mel bands, 10 MFCCs. No Arduino dependencies, so it builds on
+// a host for profiling against recorded audio.
+#define KWS_SAMPLE_RATE 16000
+#define KWS_HOP_SAMPLES 320
+#define KWS_FFT_SIZE 512
+#define KWS_FFT_BINS (KWS_FFT_SIZE / 2 + 1)
+#define KWS_MEL_BANDS 32
+#define KWS_MFCC_COUNT 10
+#define KWS_MEL_LOW_HZ 60.0f
+#define KWS_MEL_HIGH_HZ 7600.0f
+
+struct KwsFrontEnd {
+  float window[KWS_FFT_SIZE];
+  float cosTable[KWS_FFT_SIZE / 2];
+  float sinTable[KWS_FFT_SIZE / 2];
+  uint16_t bitrev[KWS_FFT_SIZE];
+  float melEdge[KWS_MEL_BANDS + 2];   // filter corners, in FFT bins
+  float dct[KWS_MFCC_COUNT][KWS_MEL_BANDS];
+  int16_t history[KWS_FFT_SIZE];
+  float re[KWS_FFT_SIZE];
+  float im[KWS_FFT_SIZE];
+  float logMel[KWS_MEL_BANDS];
+  uint32_t lastEnergy;                // mean |x| of the latest hop
+};
+
+static inline float kwsHzToMel(float hz) { return 1127.0f * logf(1.0f + hz / 700.0f); }
+static inline float kwsMelToHz(float mel) { return 700.0f * (expf(mel / 1127.0f) - 1.0f); }
+
+static void kwsFrontEndInit(KwsFrontEnd *fe)
+{
+  const float pi = 3.14159265358979f;
+  for (int i = 0; i < KWS_FFT_SIZE; ++i) {
+    fe->window[i] = 0.5f - 0.5f * cosf(2.0f * pi * i / KWS_FFT_SIZE);
+    fe->history[i] = 0;
+  }
+  for (int i = 0; i < KWS_FFT_SIZE / 2; ++i) {
+    fe->cosTable[i] = cosf(2.0f * pi * i / KWS_FFT_SIZE);
+    fe->sinTable[i] = -sinf(2.0f * pi * i / KWS_FFT_SIZE);
+  }
+
+  int bits = 0;
+  while ((1 << bits) < KWS_FFT_SIZE) {
+    bits++;
+  }
+  for (int i = 0; i < KWS_FFT_SIZE; ++i) {
+    int r = 0;
+    for (int b = 0; b < bits; ++b) {
+      r |= ((i >> b) & 1) << (bits - 1 - b);
+    }
+    fe->bitrev[i] = (uint16_t)r;
+  }
+
+  const float melLow = kwsHzToMel(KWS_MEL_LOW_HZ);
+  const float melHigh = kwsHzToMel(KWS_MEL_HIGH_HZ);
+  for (int m = 0; m < KWS_MEL_BANDS + 2; ++m) {
+    const float hz = kwsMelToHz(melLow + (melHigh - melLow) * m / (KWS_MEL_BANDS + 1));
+    fe->melEdge[m] = hz * KWS_FFT_SIZE / KWS_SAMPLE_RATE;
+  }
+
+  // Orthonormal DCT-II.
+  for (int c = 0; c < KWS_MFCC_COUNT; ++c) {
+    const float norm = (c == 0) ? sqrtf(1.0f / KWS_MEL_BANDS) : sqrtf(2.0f / KWS_MEL_BANDS);
+    for (int m = 0; m < KWS_MEL_BANDS; ++m) {
+      fe->dct[c][m] = norm * cosf(pi * c * (m + 0.5f) / KWS_MEL_BANDS);
+    }
+  }
+  fe->lastEnergy = 0;
+}
+
+static void kwsFft(KwsFrontEnd *fe)
+{
+  float *re = fe->re;
+  float *im = fe->im;
+  for (int i = 0; i < KWS_FFT_SIZE; ++i) {
+    const int j = fe->bitrev[i];
+    if (j > i) {
+      const float t = re[i];
+      re[i] = re[j];
+      re[j] = t;
+    }
+  }
+
+  for (int len = 2; len <= KWS_FFT_SIZE; len <<= 1) {
+    const int half = len >> 1;
+    const int step = KWS_FFT_SIZE / len;
+    for (int start = 0; start < KWS_FFT_SIZE; start += len) {
+      for (int k = 0; k < half; ++k) {
+        const float wr = fe->cosTable[k * step];
+        const float wi = fe->sinTable[k * step];
+        const int a = start + k;
+        const int b = a + half;
+        const float tr = re[b] * wr - im[b] * wi;
+        const float ti = re[b] * wi + im[b] * wr;
+        re[b] = re[a] - tr;
+        im[b] = im[a] - ti;
+        re[a] += tr;
+        im[a] += ti;
+      }
+    }
+  }
+}
+
+// Consumes one 20 ms hop and writes KWS_MFCC_COUNT coefficients.
+static void kwsFrontEndProcess(KwsFrontEnd *fe, const int16_t *hop, float *mfcc)
+{
+  memmove(fe->history, fe->history + KWS_HOP_SAMPLES, (KWS_FFT_SIZE - KWS_HOP_SAMPLES) * sizeof(int16_t));
+  memcpy(fe->history + KWS_FFT_SIZE - KWS_HOP_SAMPLES, hop, KWS_HOP_SAMPLES * sizeof(int16_t));
+
+  uint32_t absSum = 0;
+  for (int i = 0; i < KWS_HOP_SAMPLES; ++i) {
+    absSum += (uint32_t)((hop[i] >= 0) ? hop[i] : -hop[i]);
+  }
+  fe->lastEnergy = absSum / KWS_HOP_SAMPLES;
+
+  for (int i = 0; i < KWS_FFT_SIZE; ++i) {
+    fe->re[i] = fe->history[i] * fe->window[i] * (1.0f / 32768.0f);
+    fe->im[i] = 0.0f;
+  }
+  kwsFft(fe);
+
+  // Power spectrum in place.
+  for (int k = 0; k < KWS_FFT_BINS; ++k) {
+    fe->re[k] = fe->re[k] * fe->re[k] + fe->im[k] * fe->im[k];
+  }
+
+  for (int m = 0; m < KWS_MEL_BANDS; ++m) {
+    const float left = fe->melEdge[m];
+    const float center = fe->melEdge[m + 1];
+    const float right = fe->melEdge[m + 2];
+    int k = (int)ceilf(left);
+    const int kEnd = (int)right;
+    float sum = 0.0f;
+    for (; k <= kEnd && k < KWS_FFT_BINS; ++k) {
+      const float w = (k <= center) ? (k - left) / (center - left) : (right - k) / (right - center);
+      sum += w * fe->re[k];
+    }
+    fe->logMel[m] = logf(sum + 1e-6f);
+  }
+
+  for (int c = 0; c < KWS_MFCC_COUNT; ++c) {
+    float acc = 0.0f;
+    for (int m = 0; m < KWS_MEL_BANDS; ++m) {
+      acc += fe->dct[c][m] * fe->logMel[m];
+    }
+    mfcc[c] = acc;
+  }
+}
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef _KWS_MODEL_H_
+#define _KWS_MODEL_H_
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "kws_features.h"
+
+// Small int8 keyword model: a window of MFCC frames -> dense(hidden, ReLU)
+// -> dense(2). Trained offline and loaded from SD as one blob:
+//   "KWS1"
+//   uint16 frames, features, hidden, classes       (features = KWS_MFCC_COUNT, classes = 2)
+//   float  inputScale   mfcc -> int8: q = round(mfcc / inputScale)
+//   float  hiddenScale  int32 acc -> int8 hidden activation
+//   float  outputScale  int32 acc -> logit
+//   float  threshold    smoothed keyword probability that triggers
+//   int8   w1[hidden][frames * features], pad to 4
+//   int32  b1[hidden]
+//   int8   w2[classes][hidden], pad to 4
+//   int32  b2[classes]
+// All multi-byte fields little-endian. Class 1 is the keyword.
+#define KWS_MODEL_MAGIC "KWS1"
+#define KWS_MODEL_HEADER_BYTES 28
+#define KWS_MAX_FRAMES 64
+#define KWS_MAX_HIDDEN 64
+#define KWS_SMOOTH_FRAMES 4
+#define KWS_REFRACTORY_MS 1500
+
+struct KwsModel {
+  uint16_t frames;
+  uint16_t features;
+  uint16_t hidden;
+  uint16_t classes;
+  float inputScale;
+  float hiddenScale;
+  float outputScale;
+  float threshold;
+  const int8_t *w1;
+  const int32_t *b1;
+  const int8_t *w2;
+  const int32_t *b2;
+};
+
+struct KwsDetector {
+  int8_t window[KWS_MAX_FRAMES * KWS_MFCC_COUNT];  // oldest frame first
+  uint16_t filled;
+  float smooth[KWS_SMOOTH_FRAMES];
+  uint8_t smoothIndex;
+  float lastScore;
+  uint32_t lastTriggerMs;
+  bool triggeredOnce;
+};
+
+static inline size_t kwsAlign4(size_t n) { return (n + 3) & ~(size_t)3; }
+
+// The blob must stay alive (and 4-byte aligned) while the model is in use.
+static bool kwsModelParse(const uint8_t *blob, size_t len, KwsModel *model)
+{
+  if (blob == nullptr || len < KWS_MODEL_HEADER_BYTES || memcmp(blob, KWS_MODEL_MAGIC, 4) != 0 ||
+      ((uintptr_t)blob & 3) != 0) {
+    return false;
+  }
+
+  memcpy(&model->frames, blob + 4, 2);
+  memcpy(&model->features, blob + 6, 2);
+  memcpy(&model->hidden, blob + 8, 2);
+  memcpy(&model->classes, blob + 10, 2);
+  memcpy(&model->inputScale, blob + 12, 4);
+  memcpy(&model->hiddenScale, blob + 16, 4);
+  memcpy(&model->outputScale, blob + 20, 4);
+  memcpy(&model->threshold, blob + 24, 4);
+
+  if (model->frames == 0 || model->frames > KWS_MAX_FRAMES || model->features != KWS_MFCC_COUNT ||
+      model->hidden == 0 || model->hidden > KWS_MAX_HIDDEN || model->classes != 2 ||
+      !(model->inputScale > 0.0f) || !(model->hiddenScale > 0.0f) || !(model->outputScale > 0.0f) ||
+      !(model->threshold > 0.0f && model->threshold <= 1.0f)) {
+    return false;
+  }
+
+  const size_t inputs = (size_t)model->frames * model->features;
+  size_t offset = KWS_MODEL_HEADER_BYTES;
+  model->w1 = (const int8_t *)(blob + offset);
+  offset = kwsAlign4(offset + (size_t)model->hidden * inputs);
+  model->b1 = (const int32_t *)(blob + offset);
+  offset += (size_t)model->hidden * sizeof(int32_t);
+  model->w2 = (const int8_t *)(blob + offset);
+  offset = kwsAlign4(offset + (size_t)model->classes * model->hidden);
+  model->b2 = (const int32_t *)(blob + offset);
+  offset += (size_t)model->classes * sizeof(int32_t);
+  return offset <= len;
+}
+
+static void kwsDetectorReset(KwsDetector *det)
+{
+  memset(det, 0, sizeof(*det));
+}
+
+// Appends one MFCC frame to the sliding window.
+static void kwsDetectorPush(KwsDetector *det, const KwsModel *model, const float *mfcc)
+{
+  const size_t rowBytes = model->features;
+  const size_t windowBytes = (size_t)model->frames * rowBytes;
+  memmove(det->window, det->window + rowBytes, windowBytes - rowBytes);
+  int8_t *row = det->window + windowBytes - rowBytes;
+  for (size_t i = 0; i < rowBytes; ++i) {
+    const long q = lroundf(mfcc[i] / model->inputScale);
+    row[i] = (int8_t)((q > 127) ? 127 : (q < -128) ? -128 : q);
+  }
+  if (det->filled < model->frames) {
+    det->filled++;
+  }
+}
+
+// Keyword probability for the current window.
+static float kwsModelRun(const KwsModel *model, const int8_t *input)
+{
+  const size_t inputs = (size_t)model->frames * model->features;
+  int8_t hidden[KWS_MAX_HIDDEN];
+  for (uint16_t h = 0; h < model->hidden; ++h) {
+    const int8_t *w = model->w1 + (size_t)h * inputs;
+    int32_t acc = model->b1[h];
+    for (size_t i = 0; i < inputs; ++i) {
+      acc += (int32_t)w[i] * input[i];
+    }
+    const long q = (acc > 0) ? lroundf(acc * model->hiddenScale) : 0;
+    hidden[h] = (int8_t)((q > 127) ? 127 : q);
+  }
+
+  float logits[2];
+  for (uint16_t c = 0; c < 2; ++c) {
+    const int8_t *w = model->w2 + (size_t)c * model->hidden;
+    int32_t acc = model->b2[c];
+    for (uint16_t h = 0; h < model->hidden; ++h) {
+      acc += (int32_t)w[h] * hidden[h];
+    }
+    logits[c] = acc * model->outputScale;
+  }
+  return 1.0f / (1.0f + expf(logits[0] - logits[1]));
+}
+
+// Scores the window (score < 0 means "skipped, treat as silence") and returns
+// true once when the smoothed probability crosses the model threshold.
+static bool kwsDetectorUpdate(KwsDetector *det, const KwsModel *model, float score, uint32_t nowMs)
+{
+  det->lastScore = (score < 0.0f) ? 0.0f : score;
+  det->smooth[det->smoothIndex] = det->lastScore;
+  det->smoothIndex = (uint8_t)((det->smoothIndex + 1) % KWS_SMOOTH_FRAMES);
+  if (det->filled < model->frames) {
+    return false;
+  }
+
+  float mean = 0.0f;
+  for (int i = 0; i < KWS_SMOOTH_FRAMES; ++i) {
+    mean += det->smooth[i];
+  }
+  mean /= KWS_SMOOTH_FRAMES;
+
+  if (mean < model->threshold) {
+    return false;
+  }
+  if (det->triggeredOnce && (uint32_t)(nowMs - det->lastTriggerMs) < KWS_REFRACTORY_MS) {
+    return false;
+  }
+  det->triggeredOnce = true;
+  det->lastTriggerMs = nowMs;
+  for (int i = 0; i < KWS_SMOOTH_FRAMES; ++i) {
+    det->smooth[i] = 0.0f;
+  }
+  return true;
+}
+
+#endif
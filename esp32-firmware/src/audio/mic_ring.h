@@ -0,0 +1,103 @@
+#ifndef _MIC_RING_H_
+#define _MIC_RING_H_
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Single-producer / single-consumer sample ring between the mic capture task
+// (producer) and the loop task that sends voice chunks (consumer). Head is
+// only written by the producer and tail only by the consumer, so no lock is
+// needed; acquire/release ordering publishes the sample data.
+// Capacity must be a power of two.
+struct MicRing {
+  int16_t *samples;
+  uint32_t capacity;
+  std::atomic<uint32_t> head;
+  std::atomic<uint32_t> tail;
+  std::atomic<uint32_t> overrunSamples;
+  std::atomic<uint32_t> overrunEvents;
+  std::atomic<uint32_t> peakFill;
+};
+
+// Not thread-safe: call before the producer starts.
+static void micRingInit(MicRing *ring, int16_t *storage, uint32_t capacity)
+{
+  ring->samples = storage;
+  ring->capacity = capacity;
+  ring->head.store(0, std::memory_order_relaxed);
+  ring->tail.store(0, std::memory_order_relaxed);
+  ring->overrunSamples.store(0, std::memory_order_relaxed);
+  ring->overrunEvents.store(0, std::memory_order_relaxed);
+  ring->peakFill.store(0, std::memory_order_relaxed);
+}
+
+static inline uint32_t micRingAvailable(const MicRing *ring)
+{
+  return ring->head.load(std::memory_order_acquire) - ring->tail.load(std::memory_order_acquire);
+}
+
+// Producer side. Samples that do not fit are dropped and counted as an overrun;
+// the consumer always sees a contiguous prefix of what was captured.
+static uint32_t micRingWrite(MicRing *ring, const int16_t *src, uint32_t count)
+{
+  const uint32_t head = ring->head.load(std::memory_order_relaxed);
+  const uint32_t tail = ring->tail.load(std::memory_order_acquire);
+  const uint32_t used = head - tail;
+  const uint32_t space = ring->capacity - used;
+  const uint32_t n = (count < space) ? count : space;
+
+  if (n < count) {
+    ring->overrunSamples.fetch_add(count - n, std::memory_order_relaxed);
+    ring->overrunEvents.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  const uint32_t mask = ring->capacity - 1;
+  const uint32_t start = head & mask;
+  const uint32_t first = (n < ring->capacity - start) ? n : ring->capacity - start;
+  memcpy(ring->samples + start, src, first * sizeof(int16_t));
+  memcpy(ring->samples, src + first, (n - first) * sizeof(int16_t));
+  ring->head.store(head + n, std::memory_order_release);
+
+  if (used + n > ring->peakFill.load(std::memory_order_relaxed)) {
+    ring->peakFill.store(used + n, std::memory_order_relaxed);
+  }
+  return n;
+}
+
+// Consumer side.
+static uint32_t micRingRead(MicRing *ring, int16_t *dst, uint32_t count)
+{
+  const uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+  const uint32_t head = ring->head.load(std::memory_order_acquire);
+  const uint32_t used = head - tail;
+  const uint32_t n = (count < used) ? count : used;
+
+  const uint32_t mask = ring->capacity - 1;
+  const uint32_t start = tail & mask;
+  const uint32_t first = (n < ring->capacity - start) ? n : ring->capacity - start;
+  memcpy(dst, ring->samples + start, first * sizeof(int16_t));
+  memcpy(dst + first, ring->samples, (n - first) * sizeof(int16_t));
+  ring->tail.store(tail + n, std::memory_order_release);
+  return n;
+}
+
+// Consumer side: drop everything captured so far.
+static inline void micRingDiscard(MicRing *ring)
+{
+  ring->tail.store(ring->head.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+// Consumer side: drop the oldest samples so at most `keep` remain. Unlike a
+// full ring (which drops the newest), this keeps a rolling recent window.
+static inline void micRingTrim(MicRing *ring, uint32_t keep)
+{
+  const uint32_t head = ring->head.load(std::memory_order_acquire);
+  const uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+  if (head - tail > keep) {
+    ring->tail.store(head - keep, std::memory_order_release);
+  }
+}
+
+#endif
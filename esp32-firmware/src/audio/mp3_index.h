@@ -0,0 +1,367 @@
+#ifndef _MP3_INDEX_H_
+#define _MP3_INDEX_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// MP3 duration and seek index. A Xing/Info or VBRI tag in the first frame
+// gives the frame count (exact duration) and usually a TOC; without one the
+// file is walked frame by frame once. Either way the result is a Xing-style
+// 100-entry table: toc[i] * dataBytes / 256 + dataStart is the byte offset
+// at i% of the duration. No SD/Arduino dependencies, so it builds on a host.
+#define MP3_TOC_ENTRIES 100
+#define MP3_SCAN_MARKS 256
+
+enum Mp3IndexSource : uint8_t {
+  MP3_INDEX_NONE = 0,
+  MP3_INDEX_XING,
+  MP3_INDEX_VBRI,
+  MP3_INDEX_SCAN,
+};
+
+struct Mp3FrameInfo {
+  bool mpeg1;
+  uint8_t layer;
+  uint8_t channels;
+  uint16_t bitrateKbps;
+  uint32_t sampleRate;
+  uint16_t samplesPerFrame;
+  uint16_t frameBytes;
+};
+
+struct Mp3SeekIndex {
+  uint32_t durationMs;
+  uint32_t dataStart;
+  uint32_t dataBytes;
+  uint8_t toc[MP3_TOC_ENTRIES];
+  uint8_t source;
+};
+
+// Incremental frame walk. Only headers are parsed; feed it data read from
+// nextOffset until done.
+struct Mp3FrameScanner {
+  uint32_t nextOffset;
+  uint32_t endOffset;      // exclusive (file size minus any ID3v1 tag)
+  uint32_t dataStart;
+  uint32_t frames;
+  uint32_t resyncs;
+  uint32_t sampleRate;
+  uint16_t samplesPerFrame;
+  uint32_t markStride;     // frames between marks; doubles when marks fill up
+  uint16_t markCount;
+  uint32_t marks[MP3_SCAN_MARKS];
+  bool done;
+};
+
+static inline uint32_t mp3ReadBe32(const uint8_t *p)
+{
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline uint16_t mp3ReadBe16(const uint8_t *p)
+{
+  return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+static bool mp3ParseFrameHeader(const uint8_t *h, Mp3FrameInfo *out)
+{
+  if (h[0] != 0xFF || (h[1] & 0xE0) != 0xE0) {
+    return false;
+  }
+  const int versionBits = (h[1] >> 3) & 0x03;   // 0 = 2.5, 2 = 2, 3 = 1
+  const int layerBits = (h[1] >> 1) & 0x03;
+  const int bitrateIdx = (h[2] >> 4) & 0x0F;
+  const int sampleRateIdx = (h[2] >> 2) & 0x03;
+  const int padding = (h[2] >> 1) & 0x01;
+  if (versionBits == 1 || layerBits == 0 || bitrateIdx == 0 || bitrateIdx == 15 || sampleRateIdx == 3) {
+    return false;
+  }
+
+  static const uint16_t BITRATES[5][15] = {
+    {0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448},   // MPEG1 L1
+    {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384},      // MPEG1 L2
+    {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320},       // MPEG1 L3
+    {0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256},      // MPEG2 L1
+    {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160},           // MPEG2 L2/L3
+  };
+  static const uint32_t SAMPLE_RATES[3] = {44100, 48000, 32000};
+
+  const bool mpeg1 = versionBits == 3;
+  const uint8_t layer = (uint8_t)(4 - layerBits);
+  const int table = mpeg1 ? (layer - 1) : ((layer == 1) ? 3 : 4);
+  const uint32_t bitrate = BITRATES[table][bitrateIdx];
+  uint32_t sampleRate = SAMPLE_RATES[sampleRateIdx];
+  if (versionBits == 2) {
+    sampleRate /= 2;
+  } else if (versionBits == 0) {
+    sampleRate /= 4;
+  }
+
+  uint32_t frameBytes;
+  uint16_t samples;
+  if (layer == 1) {
+    samples = 384;
+    frameBytes = (12 * bitrate * 1000 / sampleRate + padding) * 4;
+  } else if (layer == 2 || mpeg1) {
+    samples = 1152;
+    frameBytes = 144 * bitrate * 1000 / sampleRate + padding;
+  } else {
+    samples = 576;
+    frameBytes = 72 * bitrate * 1000 / sampleRate + padding;
+  }
+
+  out->mpeg1 = mpeg1;
+  out->layer = layer;
+  out->channels = (uint8_t)((((h[3] >> 6) & 0x03) == 3) ? 1 : 2);
+  out->bitrateKbps = (uint16_t)bitrate;
+  out->sampleRate = sampleRate;
+  out->samplesPerFrame = samples;
+  out->frameBytes = (uint16_t)frameBytes;
+  return true;
+}
+
+// Bytes taken by a leading ID3v2 tag, or 0. Needs the first 10 bytes.
+static uint32_t mp3Id3v2Size(const uint8_t *head)
+{
+  if (head[0] != 'I' || head[1] != 'D' || head[2] != '3') {
+    return 0;
+  }
+  uint32_t size = 10 + (((uint32_t)(head[6] & 0x7F) << 21) | ((uint32_t)(head[7] & 0x7F) << 14) |
+                        ((uint32_t)(head[8] & 0x7F) << 7) | (uint32_t)(head[9] & 0x7F));
+  if ((head[5] & 0x10) != 0) {
+    size += 10;   // footer
+  }
+  return size;
+}
+
+// First offset in buf holding a frame header whose successor (when it lies
+// inside buf) is also valid. Returns -1 if none.
+static int mp3FindFrame(const uint8_t *buf, size_t len, Mp3FrameInfo *info)
+{
+  for (size_t i = 0; i + 4 <= len; ++i) {
+    if (!mp3ParseFrameHeader(buf + i, info)) {
+      continue;
+    }
+    const size_t next = i + info->frameBytes;
+    Mp3FrameInfo nextInfo;
+    if (next + 4 > len || mp3ParseFrameHeader(buf + next, &nextInfo)) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+static void mp3TocLinear(Mp3SeekIndex *index)
+{
+  for (int i = 0; i < MP3_TOC_ENTRIES; ++i) {
+    index->toc[i] = (uint8_t)(i * 256 / MP3_TOC_ENTRIES);
+  }
+}
+
+static uint32_t mp3FramesToMs(uint64_t frames, uint32_t samplesPerFrame, uint32_t sampleRate)
+{
+  return (uint32_t)((frames * samplesPerFrame * 1000ULL + sampleRate / 2) / sampleRate);
+}
+
+// Looks for a Xing/Info or VBRI tag in the frame at frameOffset. frame holds
+// whatever of it was read; a missing TOC tail falls back to a linear table.
+// streamEnd is the file offset where audio ends.
+static bool mp3ParseVbrTag(const uint8_t *frame, size_t len, const Mp3FrameInfo &info,
+                           uint32_t frameOffset, uint32_t streamEnd, Mp3SeekIndex *out)
+{
+  const size_t sideInfo = info.mpeg1 ? ((info.channels == 1) ? 17 : 32) : ((info.channels == 1) ? 9 : 17);
+  const size_t xing = 4 + sideInfo;
+
+  if (len >= xing + 8 && (memcmp(frame + xing, "Xing", 4) == 0 || memcmp(frame + xing, "Info", 4) == 0)) {
+    const uint32_t flags = mp3ReadBe32(frame + xing + 4);
+    size_t pos = xing + 8;
+    uint32_t frames = 0;
+    uint32_t bytes = 0;
+    if (flags & 0x1) {
+      if (len < pos + 4) return false;
+      frames = mp3ReadBe32(frame + pos);
+      pos += 4;
+    }
+    if (flags & 0x2) {
+      if (len < pos + 4) return false;
+      bytes = mp3ReadBe32(frame + pos);
+      pos += 4;
+    }
+    if (frames == 0) {
+      return false;
+    }
+
+    // LAME counts the tag frame in "bytes"; the TOC is relative to it too.
+    out->dataStart = frameOffset;
+    out->dataBytes = (bytes != 0 && frameOffset + bytes <= streamEnd) ? bytes : streamEnd - frameOffset;
+    out->durationMs = mp3FramesToMs(frames, info.samplesPerFrame, info.sampleRate);
+    out->source = MP3_INDEX_XING;
+    if ((flags & 0x4) && len >= pos + MP3_TOC_ENTRIES) {
+      memcpy(out->toc, frame + pos, MP3_TOC_ENTRIES);
+    } else {
+      mp3TocLinear(out);
+    }
+    return true;
+  }
+
+  // VBRI (Fraunhofer) always sits 32 bytes after the frame header.
+  const size_t vbri = 4 + 32;
+  if (len < vbri + 26 || memcmp(frame + vbri, "VBRI", 4) != 0) {
+    return false;
+  }
+  const uint32_t bytes = mp3ReadBe32(frame + vbri + 10);
+  const uint32_t frames = mp3ReadBe32(frame + vbri + 14);
+  const uint16_t entries = mp3ReadBe16(frame + vbri + 18);
+  const uint16_t scale = mp3ReadBe16(frame + vbri + 20);
+  const uint16_t entryBytes = mp3ReadBe16(frame + vbri + 22);
+  const uint16_t framesPerEntry = mp3ReadBe16(frame + vbri + 24);
+  if (frames == 0) {
+    return false;
+  }
+
+  // Entries are segment sizes starting after the VBRI frame.
+  out->dataStart = frameOffset + info.frameBytes;
+  const uint32_t total = (bytes > info.frameBytes) ? bytes - info.frameBytes : 0;
+  out->dataBytes = (total != 0 && out->dataStart + total <= streamEnd) ? total : streamEnd - out->dataStart;
+  out->durationMs = mp3FramesToMs(frames, info.samplesPerFrame, info.sampleRate);
+  out->source = MP3_INDEX_VBRI;
+
+  const uint8_t *table = frame + vbri + 26;
+  if (entries == 0 || framesPerEntry == 0 || entryBytes == 0 || entryBytes > 4 ||
+      len < vbri + 26 + (size_t)entries * entryBytes) {
+    mp3TocLinear(out);
+    return true;
+  }
+
+  uint16_t entry = 0;
+  uint64_t entryStartPos = 0;
+  for (int i = 0; i < MP3_TOC_ENTRIES; ++i) {
+    const uint64_t targetFrame = (uint64_t)frames * i / MP3_TOC_ENTRIES;
+    uint64_t pos = entryStartPos;
+    while (entry < entries) {
+      uint32_t value = 0;
+      for (uint16_t b = 0; b < entryBytes; ++b) {
+        value = (value << 8) | table[(size_t)entry * entryBytes + b];
+      }
+      const uint64_t entryBytesTotal = (uint64_t)value * scale;
+      const uint64_t entryFirstFrame = (uint64_t)entry * framesPerEntry;
+      if (entryFirstFrame + framesPerEntry <= targetFrame) {
+        entryStartPos += entryBytesTotal;
+        entry++;
+        continue;
+      }
+      pos = entryStartPos + entryBytesTotal * (targetFrame - entryFirstFrame) / framesPerEntry;
+      break;
+    }
+    if (entry >= entries) {
+      pos = entryStartPos;
+    }
+    const uint64_t scaled = pos * 256 / (out->dataBytes ? out->dataBytes : 1);
+    out->toc[i] = (uint8_t)((scaled > 255) ? 255 : scaled);
+  }
+  return true;
+}
+
+static void mp3ScanBegin(Mp3FrameScanner *s, uint32_t dataStart, uint32_t endOffset)
+{
+  memset(s, 0, sizeof(*s));
+  s->nextOffset = dataStart;
+  s->dataStart = dataStart;
+  s->endOffset = endOffset;
+  s->markStride = 1;
+  s->done = dataStart + 4 > endOffset;
+}
+
+// buf holds file bytes starting at s->nextOffset. Frames whose header lies in
+// buf are counted; afterwards read again from s->nextOffset.
+static void mp3ScanFeed(Mp3FrameScanner *s, const uint8_t *buf, size_t len)
+{
+  size_t pos = 0;
+  while (!s->done && pos + 4 <= len) {
+    Mp3FrameInfo info;
+    if (!mp3ParseFrameHeader(buf + pos, &info) ||
+        (s->frames > 0 && (info.sampleRate != s->sampleRate || info.samplesPerFrame != s->samplesPerFrame))) {
+      const int found = mp3FindFrame(buf + pos + 1, len - pos - 1, &info);
+      s->resyncs++;
+      if (found < 0) {
+        pos = len - 3;   // keep the last bytes: a header may straddle the edge
+        break;
+      }
+      pos += (size_t)found + 1;
+      continue;
+    }
+
+    if (s->frames == 0) {
+      s->sampleRate = info.sampleRate;
+      s->samplesPerFrame = info.samplesPerFrame;
+    }
+    if (s->frames % s->markStride == 0) {
+      if (s->markCount == MP3_SCAN_MARKS) {
+        for (uint16_t i = 0; i < MP3_SCAN_MARKS / 2; ++i) {
+          s->marks[i] = s->marks[i * 2];
+        }
+        s->markCount = MP3_SCAN_MARKS / 2;
+        s->markStride *= 2;
+      }
+      if (s->frames % s->markStride == 0) {
+        s->marks[s->markCount++] = s->nextOffset + (uint32_t)pos;
+      }
+    }
+    s->frames++;
+    pos += info.frameBytes;
+    if (s->nextOffset + pos + 4 > s->endOffset) {
+      s->done = true;
+    }
+  }
+  s->nextOffset += (uint32_t)pos;
+  if (s->nextOffset + 4 > s->endOffset) {
+    s->done = true;
+  }
+}
+
+static bool mp3ScanFinish(const Mp3FrameScanner *s, Mp3SeekIndex *out)
+{
+  if (s->frames == 0 || s->sampleRate == 0 || s->markCount == 0) {
+    return false;
+  }
+  out->dataStart = s->marks[0];
+  out->dataBytes = s->endOffset - s->marks[0];
+  out->durationMs = mp3FramesToMs(s->frames, s->samplesPerFrame, s->sampleRate);
+  out->source = MP3_INDEX_SCAN;
+
+  for (int i = 0; i < MP3_TOC_ENTRIES; ++i) {
+    const uint64_t targetFrame = (uint64_t)s->frames * i / MP3_TOC_ENTRIES;
+    const uint32_t mark = (uint32_t)(targetFrame / s->markStride);
+    uint32_t pos;
+    if (mark + 1 < s->markCount) {
+      const uint32_t into = (uint32_t)(targetFrame - (uint64_t)mark * s->markStride);
+      pos = s->marks[mark] + (uint32_t)((uint64_t)(s->marks[mark + 1] - s->marks[mark]) * into / s->markStride);
+    } else {
+      pos = s->marks[(mark < s->markCount) ? mark : s->markCount - 1];
+    }
+    const uint64_t scaled = (uint64_t)(pos - out->dataStart) * 256 / (out->dataBytes ? out->dataBytes : 1);
+    out->toc[i] = (uint8_t)((scaled > 255) ? 255 : scaled);
+  }
+  return true;
+}
+
+// Byte offset to resume decoding at for a position in the track.
+static uint32_t mp3SeekOffset(const Mp3SeekIndex *index, uint32_t ms)
+{
+  if (index->durationMs == 0 || ms == 0) {
+    return index->dataStart;
+  }
+  if (ms >= index->durationMs) {
+    return index->dataStart + index->dataBytes;
+  }
+  const uint64_t percent256 = (uint64_t)ms * MP3_TOC_ENTRIES * 256 / index->durationMs;
+  const uint32_t i = (uint32_t)(percent256 >> 8);
+  const uint32_t a = index->toc[i];
+  const uint32_t b = (i + 1 < MP3_TOC_ENTRIES) ? index->toc[i + 1] : 256;
+  const uint32_t span = (b > a) ? b - a : 0;
+  const uint64_t pos65536 = (uint64_t)a * 256 + (uint64_t)span * (percent256 & 0xFF);
+  return index->dataStart + (uint32_t)(pos65536 * index->dataBytes >> 16);
+}
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef _PCM_CONDITION_H_
+#define _PCM_CONDITION_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Mic conditioning: 32-bit stereo I2S frames -> DC-blocked, gain-controlled
+// mono s16. Fixed-point throughout so the Xtensa and portable builds produce
+// identical output; the only target-specific piece is the saturate step.
+//
+// Scale: I2S samples carry 24 significant bits, so y is kept in 24-bit units.
+// out = sat16((y * gain) >> 16), gain in Q16.
+#define PCM_AGC_TARGET_PEAK 16384        // s16 peak the AGC aims for
+#define PCM_AGC_GATE_PEAK (1 << 12)      // 24-bit peak below which gain stops rising (max gain 4.0)
+#define PCM_AGC_RELEASE_SHIFT 4          // gain rises 1/16 of the gap per block
+#define PCM_CHANNEL_SWITCH_RATIO 2       // other channel must be 2x louder to switch
+
+struct PcmConditioner {
+  int32_t dcPrevIn;
+  int32_t dcPrevOut;
+  int32_t gainQ16;
+  uint8_t channel;     // 0 = left, 1 = right
+  uint32_t clipped;
+};
+
+static inline void pcmConditionReset(PcmConditioner *pc)
+{
+  pc->dcPrevIn = 0;
+  pc->dcPrevOut = 0;
+  pc->gainQ16 = (PCM_AGC_TARGET_PEAK << 16) / PCM_AGC_GATE_PEAK;
+  pc->channel = 0;
+  pc->clipped = 0;
+}
+
+static inline int32_t pcmAbs32(int32_t v)
+{
+  const int32_t sign = v >> 31;
+  return (v ^ sign) - sign;
+}
+
+static inline int32_t pcmSat16(int32_t v)
+{
+#if defined(__XTENSA__)
+  int32_t out;
+  __asm__("clamps %0, %1, 15" : "=a"(out) : "a"(v));
+  return out;
+#else
+  v = (v > 32767) ? 32767 : v;
+  return (v < -32768) ? -32768 : v;
+#endif
+}
+
+// Conditions one block. stereo is clobbered: the filtered mono signal is
+// written back into its first `frames` entries between the two passes.
+static void pcmConditionBlock(PcmConditioner *pc, int32_t *stereo, size_t frames, int16_t *out)
+{
+  if (frames == 0) {
+    return;
+  }
+
+  // The mic sits on one slot; pick it per block with hysteresis instead of
+  // per sample, which used to splice noise from the idle slot into the signal.
+  uint32_t sum[2] = {0, 0};
+  for (size_t i = 0; i < frames; ++i) {
+    sum[0] += (uint32_t)pcmAbs32(stereo[i * 2] >> 8) >> 4;
+    sum[1] += (uint32_t)pcmAbs32(stereo[i * 2 + 1] >> 8) >> 4;
+  }
+  const uint8_t other = pc->channel ^ 1;
+  if (sum[other] / PCM_CHANNEL_SWITCH_RATIO > sum[pc->channel]) {
+    pc->channel = other;
+  }
+
+  // Pass 1: DC blocker y[n] = x[n] - x[n-1] + y[n-1] * (1 - 1/256), ~10 Hz at
+  // 16 kHz. Track the block peak for the AGC.
+  int32_t x1 = pc->dcPrevIn;
+  int32_t y1 = pc->dcPrevOut;
+  int32_t peak = 0;
+  const int32_t *src = stereo + pc->channel;
+  for (size_t i = 0; i < frames; ++i) {
+    const int32_t x = src[i * 2] >> 8;
+    const int32_t y = x - x1 + y1 - (y1 >> 8);
+    x1 = x;
+    y1 = y;
+    stereo[i] = y;
+    const int32_t a = pcmAbs32(y);
+    peak = (a > peak) ? a : peak;
+  }
+  pc->dcPrevIn = x1;
+  pc->dcPrevOut = y1;
+
+  // AGC: drop to the target gain at once (no clipping on onsets), rise slowly.
+  const int32_t level = (peak > PCM_AGC_GATE_PEAK) ? peak : PCM_AGC_GATE_PEAK;
+  const int32_t target = (int32_t)(((int64_t)PCM_AGC_TARGET_PEAK << 16) / level);
+  const int32_t from = pc->gainQ16;
+  const int32_t to = (target < from) ? target : from + ((target - from) >> PCM_AGC_RELEASE_SHIFT);
+  pc->gainQ16 = to;
+
+  // Pass 2: a falling gain applies to the whole block (the peak is in it);
+  // a rising gain ramps across the block so it never steps. Then saturate.
+  const int32_t step = (to > from) ? (to - from) / (int32_t)frames : 0;
+  int32_t gain = (to > from) ? from : to;
+  uint32_t clipped = 0;
+  for (size_t i = 0; i < frames; ++i) {
+    gain += step;
+    const int32_t scaled = (int32_t)(((int64_t)stereo[i] * gain) >> 16);
+    const int32_t sat = pcmSat16(scaled);
+    clipped += (uint32_t)(sat != scaled);
+    out[i] = (int16_t)sat;
+  }
+  pc->clipped += clipped;
+}
+
+#endif
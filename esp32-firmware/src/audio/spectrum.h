@@ -0,0 +1,282 @@
+#ifndef _SPECTRUM_H_
+#define _SPECTRUM_H_
+
+#include <atomic>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Spectrum / VU analyzer for the audio player page. The output path pushes
+// every sample it hands to I2S into a tap ring; an analyzer task takes the
+// newest window about 30 times a second, runs a Q15 fixed-point FFT and
+// publishes smoothed band levels through a seqlock for the UI to draw.
+// No Arduino dependencies, so the kernel builds on a host for benchmarking.
+#define SPECTRUM_FFT_BITS 9
+#define SPECTRUM_FFT_SIZE (1 << SPECTRUM_FFT_BITS)
+#define SPECTRUM_BANDS 16
+#define SPECTRUM_TAP_SAMPLES 2048        // power of two, > 2 windows
+#define SPECTRUM_TAP_PUBLISH_MASK 31     // head is published every 32 samples
+#define SPECTRUM_LOW_HZ 50.0f
+#define SPECTRUM_HIGH_HZ 16000.0f
+// Display range, in log2 of power: 16ths of a bit, 3.01 dB per bit.
+#define SPECTRUM_BAND_FLOOR_LOG2 9       // 54 dB below a full-scale sine
+#define SPECTRUM_BAND_RANGE_LOG2 18
+#define SPECTRUM_VU_FLOOR_LOG2 14        // 48 dB below full scale
+#define SPECTRUM_VU_RANGE_LOG2 16
+#define SPECTRUM_DECAY 14                // level units per frame, ~0.6 s full fall at 30 Hz
+#define SPECTRUM_PEAK_HOLD_FRAMES 15
+#define SPECTRUM_PEAK_DECAY 5
+
+// Single producer (the audio engine task). The reader takes the newest
+// window by head and never blocks the producer; the ring is long enough that
+// the producer cannot lap a window while it is being copied.
+struct SpectrumTap {
+  int16_t samples[SPECTRUM_TAP_SAMPLES];
+  uint32_t writePos;                     // producer only
+  std::atomic<uint32_t> head;            // samples published
+  std::atomic<uint32_t> rateHz;
+};
+
+static void spectrumTapInit(SpectrumTap *tap)
+{
+  memset(tap->samples, 0, sizeof(tap->samples));
+  tap->writePos = 0;
+  tap->head.store(0, std::memory_order_relaxed);
+  tap->rateHz.store(44100, std::memory_order_relaxed);
+}
+
+static inline void spectrumTapPush(SpectrumTap *tap, int16_t left, int16_t right)
+{
+  const uint32_t pos = tap->writePos;
+  tap->samples[pos & (SPECTRUM_TAP_SAMPLES - 1)] = (int16_t)(((int32_t)left + right) >> 1);
+  tap->writePos = pos + 1;
+  if ((pos & SPECTRUM_TAP_PUBLISH_MASK) == SPECTRUM_TAP_PUBLISH_MASK) {
+    tap->head.store(pos + 1, std::memory_order_release);
+  }
+}
+
+// Copies the newest `count` published samples. Returns the head they end at.
+static uint32_t spectrumTapLatest(const SpectrumTap *tap, int16_t *out, uint32_t count)
+{
+  const uint32_t head = tap->head.load(std::memory_order_acquire);
+  const uint32_t start = head - count;
+  for (uint32_t i = 0; i < count; ++i) {
+    out[i] = tap->samples[(start + i) & (SPECTRUM_TAP_SAMPLES - 1)];
+  }
+  return head;
+}
+
+struct SpectrumFrame {
+  uint8_t bands[SPECTRUM_BANDS];         // 0..255
+  uint8_t peaks[SPECTRUM_BANDS];
+  uint8_t vu;
+};
+
+struct SpectrumAnalyzer {
+  int16_t window[SPECTRUM_FFT_SIZE];     // Hann, Q15
+  int16_t cosTable[SPECTRUM_FFT_SIZE / 2];
+  int16_t sinTable[SPECTRUM_FFT_SIZE / 2];   // -sin, Q15
+  uint16_t bitrev[SPECTRUM_FFT_SIZE];
+  uint16_t bandEdge[SPECTRUM_BANDS + 1]; // first FFT bin of each band
+  uint32_t bandRateHz;                   // rate bandEdge was built for
+  int16_t re[SPECTRUM_FFT_SIZE];
+  int16_t im[SPECTRUM_FFT_SIZE];
+  uint8_t peakHold[SPECTRUM_BANDS];
+  SpectrumFrame frame;
+};
+
+static inline int16_t spectrumQ15(float v)
+{
+  const float scaled = v * 32767.0f;
+  return (int16_t)(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+}
+
+// Log-spaced bands; low bands are widened to at least one bin each.
+static void spectrumAnalyzerSetRate(SpectrumAnalyzer *an, uint32_t rateHz)
+{
+  const float nyquist = rateHz * 0.5f;
+  const float high = (SPECTRUM_HIGH_HZ < nyquist) ? SPECTRUM_HIGH_HZ : nyquist;
+  const float ratio = high / SPECTRUM_LOW_HZ;
+  const int maxBin = SPECTRUM_FFT_SIZE / 2;
+  int prev = 0;
+  for (int b = 0; b <= SPECTRUM_BANDS; ++b) {
+    const float hz = SPECTRUM_LOW_HZ * powf(ratio, (float)b / SPECTRUM_BANDS);
+    int bin = (int)(hz * SPECTRUM_FFT_SIZE / rateHz + 0.5f);
+    if (bin <= prev) {
+      bin = prev + 1;
+    }
+    if (bin > maxBin - (SPECTRUM_BANDS - b)) {
+      bin = maxBin - (SPECTRUM_BANDS - b);
+    }
+    an->bandEdge[b] = (uint16_t)bin;
+    prev = bin;
+  }
+  an->bandRateHz = rateHz;
+}
+
+static void spectrumAnalyzerInit(SpectrumAnalyzer *an)
+{
+  const float pi = 3.14159265358979f;
+  for (int i = 0; i < SPECTRUM_FFT_SIZE; ++i) {
+    an->window[i] = spectrumQ15(0.5f - 0.5f * cosf(2.0f * pi * i / SPECTRUM_FFT_SIZE));
+    int r = 0;
+    for (int b = 0; b < SPECTRUM_FFT_BITS; ++b) {
+      r |= ((i >> b) & 1) << (SPECTRUM_FFT_BITS - 1 - b);
+    }
+    an->bitrev[i] = (uint16_t)r;
+  }
+  for (int i = 0; i < SPECTRUM_FFT_SIZE / 2; ++i) {
+    an->cosTable[i] = spectrumQ15(cosf(2.0f * pi * i / SPECTRUM_FFT_SIZE));
+    an->sinTable[i] = spectrumQ15(-sinf(2.0f * pi * i / SPECTRUM_FFT_SIZE));
+  }
+  memset(an->peakHold, 0, sizeof(an->peakHold));
+  memset(&an->frame, 0, sizeof(an->frame));
+  spectrumAnalyzerSetRate(an, 44100);
+}
+
+// In-place radix-2 FFT on Q15 data. Every stage halves its outputs, so the
+// result is X[k] / N and magnitudes never grow past the input range.
+static void spectrumFft(SpectrumAnalyzer *an)
+{
+  int16_t *re = an->re;
+  int16_t *im = an->im;
+  for (int i = 0; i < SPECTRUM_FFT_SIZE; ++i) {
+    const int j = an->bitrev[i];
+    if (j > i) {
+      const int16_t tr = re[i];
+      re[i] = re[j];
+      re[j] = tr;
+      const int16_t ti = im[i];
+      im[i] = im[j];
+      im[j] = ti;
+    }
+  }
+
+  for (int size = 2, step = SPECTRUM_FFT_SIZE / 2; size <= SPECTRUM_FFT_SIZE; size <<= 1, step >>= 1) {
+    const int half = size >> 1;
+    for (int k = 0; k < half; ++k) {
+      const int32_t wr = an->cosTable[k * step];
+      const int32_t wi = an->sinTable[k * step];
+      for (int a = k; a < SPECTRUM_FFT_SIZE; a += size) {
+        const int b = a + half;
+        const int32_t tr = (wr * re[b] - wi * im[b]) >> 15;
+        const int32_t ti = (wr * im[b] + wi * re[b]) >> 15;
+        const int32_t ar = re[a];
+        const int32_t ai = im[a];
+        re[a] = (int16_t)((ar + tr) >> 1);
+        im[a] = (int16_t)((ai + ti) >> 1);
+        re[b] = (int16_t)((ar - tr) >> 1);
+        im[b] = (int16_t)((ai - ti) >> 1);
+      }
+    }
+  }
+}
+
+// log2(x) in 16ths, linear between powers of two.
+static inline uint32_t spectrumLog2Q4(uint64_t x)
+{
+  if (x == 0) {
+    return 0;
+  }
+  const int msb = 63 - __builtin_clzll(x);
+  const uint32_t frac = (msb >= 4) ? (uint32_t)(x >> (msb - 4)) & 15 : (uint32_t)(x << (4 - msb)) & 15;
+  return (uint32_t)msb * 16 + frac;
+}
+
+static inline uint8_t spectrumScale(uint32_t log2Q4, uint32_t floorLog2, uint32_t rangeLog2)
+{
+  if (log2Q4 <= floorLog2 * 16) {
+    return 0;
+  }
+  const uint32_t v = (log2Q4 - floorLog2 * 16) * 255 / (rangeLog2 * 16);
+  return (uint8_t)(v > 255 ? 255 : v);
+}
+
+// Analyzes one window of SPECTRUM_FFT_SIZE mono samples (nullptr = silence)
+// and updates the smoothed frame: instant attack, linear release, peak caps.
+static void spectrumAnalyzerProcess(SpectrumAnalyzer *an, const int16_t *samples, uint32_t rateHz)
+{
+  if (rateHz != an->bandRateHz && rateHz >= 8000) {
+    spectrumAnalyzerSetRate(an, rateHz);
+  }
+
+  uint8_t bands[SPECTRUM_BANDS];
+  uint8_t vu = 0;
+  if (samples == nullptr) {
+    memset(bands, 0, sizeof(bands));
+  } else {
+    uint64_t energy = 0;
+    for (int i = 0; i < SPECTRUM_FFT_SIZE; ++i) {
+      const int32_t s = samples[i];
+      energy += (uint64_t)(s * s);
+      an->re[i] = (int16_t)((s * an->window[i]) >> 15);
+      an->im[i] = 0;
+    }
+    vu = spectrumScale(spectrumLog2Q4(energy / SPECTRUM_FFT_SIZE), SPECTRUM_VU_FLOOR_LOG2, SPECTRUM_VU_RANGE_LOG2);
+
+    spectrumFft(an);
+    for (int b = 0; b < SPECTRUM_BANDS; ++b) {
+      uint64_t power = 0;
+      for (int k = an->bandEdge[b]; k < an->bandEdge[b + 1]; ++k) {
+        power += (uint32_t)((int32_t)an->re[k] * an->re[k]) + (uint32_t)((int32_t)an->im[k] * an->im[k]);
+      }
+      bands[b] = spectrumScale(spectrumLog2Q4(power), SPECTRUM_BAND_FLOOR_LOG2, SPECTRUM_BAND_RANGE_LOG2);
+    }
+  }
+
+  SpectrumFrame *f = &an->frame;
+  for (int b = 0; b < SPECTRUM_BANDS; ++b) {
+    const uint8_t fallen = (f->bands[b] > SPECTRUM_DECAY) ? f->bands[b] - SPECTRUM_DECAY : 0;
+    f->bands[b] = (bands[b] > fallen) ? bands[b] : fallen;
+    if (f->bands[b] >= f->peaks[b]) {
+      f->peaks[b] = f->bands[b];
+      an->peakHold[b] = SPECTRUM_PEAK_HOLD_FRAMES;
+    } else if (an->peakHold[b] > 0) {
+      an->peakHold[b]--;
+    } else {
+      f->peaks[b] = (f->peaks[b] > SPECTRUM_PEAK_DECAY) ? f->peaks[b] - SPECTRUM_PEAK_DECAY : 0;
+    }
+  }
+  const uint8_t vuFallen = (f->vu > SPECTRUM_DECAY) ? f->vu - SPECTRUM_DECAY : 0;
+  f->vu = (vu > vuFallen) ? vu : vuFallen;
+}
+
+// Seqlock between the analyzer (writer) and the UI (reader): odd sequence
+// means a write is in progress; the reader retries instead of blocking.
+struct SpectrumShared {
+  std::atomic<uint32_t> seq;
+  SpectrumFrame frame;
+};
+
+static void spectrumPublish(SpectrumShared *shared, const SpectrumFrame *frame)
+{
+  const uint32_t seq = shared->seq.load(std::memory_order_relaxed);
+  shared->seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  memcpy(&shared->frame, frame, sizeof(*frame));
+  shared->seq.store(seq + 2, std::memory_order_release);
+}
+
+// Returns false when nothing newer than *lastSeq is available.
+static bool spectrumSnapshot(SpectrumShared *shared, SpectrumFrame *out, uint32_t *lastSeq)
+{
+  for (int attempt = 0; attempt < 3; ++attempt) {
+    const uint32_t before = shared->seq.load(std::memory_order_acquire);
+    if (before == *lastSeq) {
+      return false;
+    }
+    if (before & 1) {
+      continue;
+    }
+    memcpy(out, &shared->frame, sizeof(*out));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (shared->seq.load(std::memory_order_relaxed) == before) {
+      *lastSeq = before;
+      return true;
+    }
+  }
+  return false;
+}
+
+#endif
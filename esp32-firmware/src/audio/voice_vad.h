@@ -0,0 +1,165 @@
+#ifndef _VOICE_VAD_H_
+#define _VOICE_VAD_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Frame-level voice activity detector for the mic stream (one frame = one
+// 40 ms chunk). A frame counts as speech when its mean |x| clears an adaptive
+// noise floor; zero crossings reject hum/DC and let quieter fricatives through.
+// Onset needs a short run of speech frames, hangover keeps word tails, and a
+// longer silence run closes the segment.
+#define VOICE_VAD_ONSET_FRAMES 2        // 80 ms
+#define VOICE_VAD_HANGOVER_FRAMES 8     // 320 ms still sent after speech
+#define VOICE_VAD_ENDPOINT_FRAMES 20    // 800 ms silence ends the segment
+#define VOICE_VAD_CALIBRATION_FRAMES 3
+#define VOICE_VAD_MIN_ENERGY 120        // mean |x| floor, s16 scale
+#define VOICE_VAD_ZCR_MIN 6             // per frame; below this is hum
+#define VOICE_VAD_FRICATIVE_ZCR 160     // per frame; ~2 kHz and up
+#define VOICE_VAD_MIN_WINDOW_FRAMES 8   // 320 ms; two of them tell steady noise from speech
+
+enum VoiceVadEvent : uint8_t {
+  VOICE_VAD_NONE = 0,
+  VOICE_VAD_SPEECH_START,
+  VOICE_VAD_SPEECH_END,
+};
+
+struct VoiceVad {
+  uint32_t noiseFloor;
+  uint16_t lastEnergy;
+  uint16_t lastZcr;
+  uint8_t speechRun;
+  uint16_t silenceRun;
+  uint16_t windowMin;       // quietest and loudest frame in the current window
+  uint16_t windowMax;
+  uint16_t lastWindowMin;   // and in the one before
+  uint16_t lastWindowMax;
+  uint8_t windowFrames;
+  bool inSpeech;
+  uint32_t frames;
+  uint32_t speechFrames;
+  uint32_t segments;
+};
+
+static inline void voiceVadReset(VoiceVad *vad)
+{
+  vad->noiseFloor = 0;
+  vad->lastEnergy = 0;
+  vad->lastZcr = 0;
+  vad->speechRun = 0;
+  vad->silenceRun = 0;
+  vad->windowMin = 0xFFFF;
+  vad->windowMax = 0;
+  vad->lastWindowMin = 0xFFFF;
+  vad->lastWindowMax = 0;
+  vad->windowFrames = 0;
+  vad->inSpeech = false;
+  vad->frames = 0;
+  vad->speechFrames = 0;
+  vad->segments = 0;
+}
+
+// True while the current frame belongs to a segment (speech or hangover).
+static inline bool voiceVadShouldSend(const VoiceVad *vad)
+{
+  return vad->inSpeech && vad->silenceRun <= VOICE_VAD_HANGOVER_FRAMES;
+}
+
+static bool voiceVadIsSpeech(const VoiceVad *vad, uint32_t energy, uint32_t zcr)
+{
+  if (vad->frames <= VOICE_VAD_CALIBRATION_FRAMES || zcr < VOICE_VAD_ZCR_MIN) {
+    return false;
+  }
+  const uint32_t loud = vad->noiseFloor * 3;
+  const uint32_t soft = (vad->noiseFloor * 3) / 2;
+  if (energy >= VOICE_VAD_MIN_ENERGY && energy > loud) {
+    return true;
+  }
+  return energy >= VOICE_VAD_MIN_ENERGY / 2 && energy > soft && zcr >= VOICE_VAD_FRICATIVE_ZCR;
+}
+
+static VoiceVadEvent voiceVadProcess(VoiceVad *vad, const int16_t *pcm, size_t count)
+{
+  if (count == 0) {
+    return VOICE_VAD_NONE;
+  }
+
+  uint32_t absSum = 0;
+  uint32_t zcr = 0;
+  int16_t prev = pcm[0];
+  for (size_t i = 0; i < count; ++i) {
+    const int16_t s = pcm[i];
+    absSum += (uint32_t)((s >= 0) ? s : -s);
+    zcr += (uint32_t)((s ^ prev) < 0);
+    prev = s;
+  }
+  const uint32_t energy = absSum / count;
+  vad->lastEnergy = (uint16_t)((energy > 0xFFFF) ? 0xFFFF : energy);
+  vad->lastZcr = (uint16_t)zcr;
+  vad->frames++;
+
+  const bool speech = voiceVadIsSpeech(vad, energy, zcr);
+
+  // The floor falls fast and rises slowly: through non-speech it follows at
+  // 1/16 per frame, during speech it only creeps. The first frame seeds it,
+  // and on a wake-word stream that frame is the tail of the keyword, so a
+  // quieter frame pulls it halfway down at once; the pause before the
+  // command brings it to the room level within a few frames.
+  if (vad->frames == 1) {
+    vad->noiseFloor = energy;
+  } else if (energy < vad->noiseFloor) {
+    vad->noiseFloor -= (vad->noiseFloor - energy) / 2;
+  } else if (!speech) {
+    vad->noiseFloor += (energy - vad->noiseFloor) / 16;
+  } else {
+    vad->noiseFloor += (energy - vad->noiseFloor) / 512;
+  }
+
+  // Speech rises and falls by syllable; louder background noise holds
+  // steady. If the last two windows stayed within 2x of their quietest
+  // frame and that frame is well above the floor, the floor is stale: move
+  // it there so the noise reads as silence again and the segment can end.
+  if (vad->lastEnergy < vad->windowMin) {
+    vad->windowMin = vad->lastEnergy;
+  }
+  if (vad->lastEnergy > vad->windowMax) {
+    vad->windowMax = vad->lastEnergy;
+  }
+  if (++vad->windowFrames >= VOICE_VAD_MIN_WINDOW_FRAMES) {
+    const uint32_t quietest = (vad->windowMin < vad->lastWindowMin) ? vad->windowMin : vad->lastWindowMin;
+    const uint32_t loudest = (vad->windowMax > vad->lastWindowMax) ? vad->windowMax : vad->lastWindowMax;
+    if (vad->lastWindowMax != 0 && loudest < quietest * 2 && quietest > vad->noiseFloor * 3) {
+      vad->noiseFloor = quietest;
+    }
+    vad->lastWindowMin = vad->windowMin;
+    vad->lastWindowMax = vad->windowMax;
+    vad->windowMin = 0xFFFF;
+    vad->windowMax = 0;
+    vad->windowFrames = 0;
+  }
+
+  if (speech) {
+    vad->speechFrames++;
+  }
+
+  if (!vad->inSpeech) {
+    vad->speechRun = speech ? (uint8_t)(vad->speechRun + 1) : 0;
+    if (vad->speechRun >= VOICE_VAD_ONSET_FRAMES) {
+      vad->inSpeech = true;
+      vad->silenceRun = 0;
+      return VOICE_VAD_SPEECH_START;
+    }
+    return VOICE_VAD_NONE;
+  }
+
+  vad->silenceRun = speech ? 0 : (uint16_t)(vad->silenceRun + 1);
+  if (vad->silenceRun >= VOICE_VAD_ENDPOINT_FRAMES) {
+    vad->inSpeech = false;
+    vad->speechRun = 0;
+    vad->segments++;
+    return VOICE_VAD_SPEECH_END;
+  }
+  return VOICE_VAD_NONE;
+}
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef _CLOCK_FACE_H_
+#define _CLOCK_FACE_H_
+
+#include <lvgl.h>
+#include <string.h>
+
+// Digit sprites for the clock page. "0"-"9" and ":" are rendered once from
+// a font into true-colour+alpha cells (all digits as wide as the widest),
+// and a time string is shown as a row of lv_img cells. Changing a digit
+// swaps one cell's source, so only that cell is invalidated: the wallpaper
+// and shade under it are redrawn for a digit-sized box instead of the whole
+// label, and the other digits do not move (a proportional label re-centres
+// when "1" comes and goes). The blit is a plain alpha blend with no glyph
+// decoding.
+#define CLOCK_FACE_GLYPHS ":0123456789"
+#define CLOCK_FACE_GLYPH_COUNT 11
+#define CLOCK_FACE_MAX_CELLS 8
+
+struct ClockFaceSprites {
+  lv_img_dsc_t glyph[CLOCK_FACE_GLYPH_COUNT];
+  uint8_t *pixels;
+  lv_coord_t digitW;
+  lv_coord_t colonW;
+  lv_coord_t cellH;
+};
+
+struct ClockFaceRow {
+  lv_obj_t *cont;
+  lv_obj_t *cells[CLOCK_FACE_MAX_CELLS];
+  char shown[CLOCK_FACE_MAX_CELLS];
+  uint8_t count;
+};
+
+static inline int clockFaceGlyphIndex(char c)
+{
+  const char *p = strchr(CLOCK_FACE_GLYPHS, c);
+  return (c != '\0' && p != nullptr) ? (int)(p - CLOCK_FACE_GLYPHS) : -1;
+}
+
+// Alpha of pixel i of an LVGL glyph bitmap (rows packed without padding).
+static inline uint8_t clockFaceGlyphAlpha(const uint8_t *bitmap, uint32_t i, uint8_t bpp)
+{
+  const uint32_t bit = i * bpp;
+  const uint8_t v = (uint8_t)((bitmap[bit >> 3] >> (8 - bpp - (bit & 7))) & ((1 << bpp) - 1));
+  return (uint8_t)(v * 255 / ((1 << bpp) - 1));
+}
+
+// Renders the sprites in one colour. Digit cells are as wide as the widest
+// digit plus `spacing`, the colon cell as its own advance plus `spacing`,
+// and all are as tall as the font's line. Returns false when out of memory.
+static bool clockFaceBuildSprites(ClockFaceSprites *s, const lv_font_t *font, lv_color_t color, lv_coord_t spacing)
+{
+  memset(s, 0, sizeof(*s));
+  lv_font_glyph_dsc_t g;
+  lv_coord_t widest = 0;
+  for (int i = 1; i < CLOCK_FACE_GLYPH_COUNT; ++i) {
+    if (lv_font_get_glyph_dsc(font, &g, (uint32_t)CLOCK_FACE_GLYPHS[i], 0) && g.adv_w > widest) {
+      widest = g.adv_w;
+    }
+  }
+  s->digitW = widest + spacing;
+  s->colonW = (lv_font_get_glyph_dsc(font, &g, ':', 0) ? g.adv_w : widest / 2) + spacing;
+  s->cellH = font->line_height;
+  const size_t digitBytes = (size_t)s->digitW * s->cellH * LV_IMG_PX_SIZE_ALPHA_BYTE;
+  const size_t colonBytes = (size_t)s->colonW * s->cellH * LV_IMG_PX_SIZE_ALPHA_BYTE;
+  s->pixels = (uint8_t *)lv_mem_alloc(colonBytes + digitBytes * (CLOCK_FACE_GLYPH_COUNT - 1));
+  if (s->pixels == nullptr) {
+    return false;
+  }
+
+  uint8_t *cell = s->pixels;
+  for (int i = 0; i < CLOCK_FACE_GLYPH_COUNT; ++i) {
+    const lv_coord_t cellW = (i == 0) ? s->colonW : s->digitW;
+    const size_t cellBytes = (i == 0) ? colonBytes : digitBytes;
+    lv_img_dsc_t &img = s->glyph[i];
+    img.header.always_zero = 0;
+    img.header.cf = LV_IMG_CF_TRUE_COLOR_ALPHA;
+    img.header.w = cellW;
+    img.header.h = s->cellH;
+    img.data_size = cellBytes;
+    img.data = cell;
+    cell += cellBytes;
+
+    uint8_t *px = (uint8_t *)img.data;
+    for (lv_coord_t p = 0; p < cellW * s->cellH; ++p) {
+      memcpy(px + p * LV_IMG_PX_SIZE_ALPHA_BYTE, &color, sizeof(color));
+      px[p * LV_IMG_PX_SIZE_ALPHA_BYTE + LV_IMG_PX_SIZE_ALPHA_BYTE - 1] = 0;
+    }
+    if (!lv_font_get_glyph_dsc(font, &g, (uint32_t)CLOCK_FACE_GLYPHS[i], 0) || g.resolved_font == nullptr) {
+      continue;
+    }
+    const uint8_t *bitmap = lv_font_get_glyph_bitmap(g.resolved_font, (uint32_t)CLOCK_FACE_GLYPHS[i]);
+    if (bitmap == nullptr) {
+      continue;
+    }
+    // Same placement as lv_draw_letter(), centred in the cell.
+    const lv_font_t *rf = g.resolved_font;
+    const lv_coord_t x0 = (cellW - g.adv_w) / 2 + g.ofs_x;
+    const lv_coord_t y0 = (rf->line_height - rf->base_line) - g.box_h - g.ofs_y;
+    for (lv_coord_t y = 0; y < g.box_h; ++y) {
+      for (lv_coord_t x = 0; x < g.box_w; ++x) {
+        const lv_coord_t cx = x0 + x;
+        const lv_coord_t cy = y0 + y;
+        if (cx < 0 || cy < 0 || cx >= cellW || cy >= s->cellH) {
+          continue;
+        }
+        px[(cy * cellW + cx) * LV_IMG_PX_SIZE_ALPHA_BYTE + LV_IMG_PX_SIZE_ALPHA_BYTE - 1] =
+          clockFaceGlyphAlpha(bitmap, (uint32_t)(y * g.box_w + x), g.bpp);
+      }
+    }
+  }
+  return true;
+}
+
+// A row of cells laid out from `layout` ("00:00", ":00"): a colon-wide
+// cell for each ':' and a digit-wide cell for anything else. The container
+// is transparent and not clickable, so the page keeps its gestures.
+static lv_obj_t *clockFaceCreateRow(ClockFaceRow *row, lv_obj_t *parent, const ClockFaceSprites *s, const char *layout)
+{
+  memset(row, 0, sizeof(*row));
+  row->cont = lv_obj_create(parent);
+  lv_obj_remove_style_all(row->cont);
+  lv_obj_clear_flag(row->cont, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+  lv_coord_t x = 0;
+  for (; row->count < CLOCK_FACE_MAX_CELLS && layout[row->count] != '\0'; ++row->count) {
+    const lv_coord_t w = (layout[row->count] == ':') ? s->colonW : s->digitW;
+    lv_obj_t *cell = lv_img_create(row->cont);
+    lv_obj_set_pos(cell, x, 0);
+    lv_obj_set_size(cell, w, s->cellH);
+    lv_obj_clear_flag(cell, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_flag(cell, LV_OBJ_FLAG_HIDDEN);
+    row->cells[row->count] = cell;
+    x += w;
+  }
+  lv_obj_set_size(row->cont, x, s->cellH);
+  return row->cont;
+}
+
+// Shows `text` (digits and ':' in the row's layout; anything else is blank)
+// and touches only the cells whose character changed. Returns the number
+// of cells changed.
+static uint8_t clockFaceSetText(ClockFaceRow *row, const ClockFaceSprites *s, const char *text)
+{
+  uint8_t changed = 0;
+  bool ended = false;
+  for (uint8_t i = 0; i < row->count; ++i) {
+    ended = ended || text[i] == '\0';
+    const char c = ended ? ' ' : text[i];
+    if (row->shown[i] == c) {
+      continue;
+    }
+    row->shown[i] = c;
+    changed++;
+    const int glyph = clockFaceGlyphIndex(c);
+    if (glyph < 0) {
+      lv_obj_add_flag(row->cells[i], LV_OBJ_FLAG_HIDDEN);
+    } else {
+      lv_img_set_src(row->cells[i], &s->glyph[glyph]);
+      lv_obj_clear_flag(row->cells[i], LV_OBJ_FLAG_HIDDEN);
+    }
+  }
+  return changed;
+}
+
+#endif
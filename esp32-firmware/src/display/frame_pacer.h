@@ -0,0 +1,125 @@
+#ifndef _FRAME_PACER_H_
+#define _FRAME_PACER_H_
+
+#include <stdint.h>
+
+// Paces media frames (video, dynamic wallpaper) to a steady cadence. A
+// frame is decoded ahead, once its slot is closer than the recent decode
+// time, and presented when the slot comes, so the interval on screen no
+// longer follows how long each JPEG happened to take. Slots advance by
+// whole periods from the previous slot rather than from the present, so
+// small delays don't add up; a present more than a period late restarts
+// the clock instead of bursting to catch up.
+//
+// Each present interval is binned by how far it is from the period. Times
+// are microseconds on the caller's clock; no platform dependencies.
+#define FRAME_PACER_BINS 6
+#define FRAME_PACER_MARGIN_US 2000    // decode lead on top of the recent decode time
+
+// Upper edges of the jitter bins in ms; the last bin is open.
+static const uint8_t FRAME_PACER_BIN_MS[FRAME_PACER_BINS - 1] = {1, 2, 4, 8, 16};
+
+enum FramePacerSync : uint8_t {
+  FRAME_PACER_TIMER = 0,       // no TE line, presented on the slot
+  FRAME_PACER_TE = 1,          // presented on the panel's TE edge after the slot
+  FRAME_PACER_TE_MISSED = 2,   // TE wired but no edge within the timeout
+};
+
+struct FramePacerStats {
+  uint32_t presents;
+  uint32_t synced;
+  uint32_t teMissed;
+  uint32_t stalls;         // over two periods since the last present (pauses, slow SD); not binned
+  uint32_t jitterUsMax;
+  uint32_t hist[FRAME_PACER_BINS];
+};
+
+struct FramePacer {
+  uint32_t periodUs;
+  uint32_t slotUs;    // when the next frame is due
+  uint32_t lastUs;    // last present
+  uint32_t workUs;    // recent decode time, see framePacerNoteWork()
+  bool running;
+  FramePacerStats stats;
+};
+
+// The next frame goes out as soon as it is ready and starts a new cadence.
+static inline void framePacerReset(FramePacer *p)
+{
+  p->running = false;
+}
+
+// With a TE line the present lands on a panel refresh, so the period is
+// rounded to whole refreshes (quantumUs; 0 without TE) to keep every
+// interval the same length.
+static void framePacerSetPeriod(FramePacer *p, uint32_t periodMs, uint32_t quantumUs)
+{
+  uint32_t us = periodMs * 1000U;
+  if (quantumUs > 0) {
+    const uint32_t n = (us + quantumUs / 2) / quantumUs;
+    us = (n == 0 ? 1 : n) * quantumUs;
+  }
+  p->periodUs = us;
+}
+
+// Time to start decoding the next frame.
+static inline bool framePacerPrepareDue(const FramePacer *p, uint32_t nowUs)
+{
+  if (!p->running) {
+    return true;
+  }
+  uint32_t lead = p->workUs + FRAME_PACER_MARGIN_US;
+  if (lead > p->periodUs) {
+    lead = p->periodUs;
+  }
+  return (int32_t)(nowUs - (p->slotUs - lead)) >= 0;
+}
+
+// Records how long the last decode took. The estimate follows a slower
+// frame at once but only comes down over a few dozen frames: decoding early
+// costs nothing, decoding late shows up as jitter.
+static inline void framePacerNoteWork(FramePacer *p, uint32_t us)
+{
+  p->workUs = (us > p->workUs) ? us : p->workUs - (p->workUs - us) / 32;
+}
+
+// Time to present a decoded frame.
+static inline bool framePacerPresentDue(const FramePacer *p, uint32_t nowUs)
+{
+  return !p->running || (int32_t)(nowUs - p->slotUs) >= 0;
+}
+
+static void framePacerPresented(FramePacer *p, uint32_t nowUs, FramePacerSync sync)
+{
+  p->stats.presents++;
+  if (sync == FRAME_PACER_TE) {
+    p->stats.synced++;
+  } else if (sync == FRAME_PACER_TE_MISSED) {
+    p->stats.teMissed++;
+  }
+  if (p->running) {
+    const uint32_t interval = nowUs - p->lastUs;
+    if (interval > 2 * p->periodUs) {
+      p->stats.stalls++;
+    } else {
+      const uint32_t jitter = interval > p->periodUs ? interval - p->periodUs : p->periodUs - interval;
+      int bin = 0;
+      while (bin < FRAME_PACER_BINS - 1 && jitter >= FRAME_PACER_BIN_MS[bin] * 1000U) {
+        bin++;
+      }
+      p->stats.hist[bin]++;
+      if (jitter > p->stats.jitterUsMax) {
+        p->stats.jitterUsMax = jitter;
+      }
+    }
+  }
+  p->lastUs = nowUs;
+  if (!p->running || (int32_t)(nowUs - p->slotUs) > (int32_t)p->periodUs) {
+    p->slotUs = nowUs + p->periodUs;
+  } else {
+    p->slotUs += p->periodUs;
+  }
+  p->running = true;
+}
+
+#endif
@@ -0,0 +1,154 @@
+#ifndef _IMG_SCALE_H_
+#define _IMG_SCALE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Fixed-point RGB565 scaler. Geometry (zoom and a centred crop to the
+// output size) is resolved once into per-column and per-row lookup tables,
+// so the inner loop is table reads plus, for bilinear, a packed blend with
+// 5-bit weights. No LVGL or ESP-IDF dependencies, so it builds on a host
+// for benchmarking.
+//
+// Pixels may be byte-swapped (LV_COLOR_16_SWAP); nearest copies them as
+// they are, bilinear swaps around the blend.
+#define IMG_SCALE_MAX_DIM 1024
+
+enum ImgScaleFilter : uint8_t {
+  IMG_SCALE_NEAREST = 0,
+  IMG_SCALE_BILINEAR = 1,
+};
+
+struct ImgScaleAxis {
+  uint16_t idx[IMG_SCALE_MAX_DIM];    // first source sample
+  uint8_t frac[IMG_SCALE_MAX_DIM];    // weight of the next sample, 0..32
+};
+
+struct ImgScaleMap {
+  uint16_t srcW, srcH;
+  uint16_t dstW, dstH;
+  uint16_t zoom;    // 256 = 1:1, as lv_img_set_zoom()
+  ImgScaleAxis x;
+  ImgScaleAxis y;
+};
+
+// Size of the source scaled by zoom, before cropping.
+static inline uint16_t imgScaleZoomedSize(uint16_t src, uint16_t zoom)
+{
+  const uint32_t v = ((uint32_t)src * zoom + 128) >> 8;
+  return (uint16_t)(v == 0 ? 1 : (v > IMG_SCALE_MAX_DIM ? IMG_SCALE_MAX_DIM : v));
+}
+
+// Output pixel i of the zoomed image (after dropping `skip` pixels of
+// crop) samples the source at ((skip + i + 0.5) / zoom - 0.5), clamped.
+static inline void imgScaleAxisInit(ImgScaleAxis *a, uint16_t src, uint16_t dst, uint16_t skip, uint16_t zoom)
+{
+  for (uint16_t i = 0; i < dst; ++i) {
+    // 16.16 fixed point: (2 * (skip + i) + 1) * 128 / zoom - 0.5.
+    int64_t s = ((int64_t)(2 * (skip + i) + 1) << 23) / zoom - 32768;
+    if (s < 0) {
+      s = 0;
+    }
+    int32_t idx = (int32_t)(s >> 16);
+    int32_t frac = (int32_t)((s & 0xFFFF) + 0x400) >> 11;    // 0..32
+    if (idx >= src - 1) {
+      idx = src - 1;
+      frac = 0;
+    }
+    a->idx[i] = (uint16_t)idx;
+    a->frac[i] = (uint8_t)frac;
+  }
+}
+
+// Resolves a zoom of a srcW x srcH image, centred and cropped to at most
+// maxW x maxH. Returns false when the sizes are out of range.
+static inline bool imgScaleMapInit(ImgScaleMap *m, uint16_t srcW, uint16_t srcH, uint16_t zoom, uint16_t maxW, uint16_t maxH)
+{
+  if (srcW == 0 || srcH == 0 || zoom == 0 || maxW == 0 || maxH == 0 || srcW > IMG_SCALE_MAX_DIM ||
+      srcH > IMG_SCALE_MAX_DIM || maxW > IMG_SCALE_MAX_DIM || maxH > IMG_SCALE_MAX_DIM) {
+    return false;
+  }
+  const uint16_t zoomedW = imgScaleZoomedSize(srcW, zoom);
+  const uint16_t zoomedH = imgScaleZoomedSize(srcH, zoom);
+  m->srcW = srcW;
+  m->srcH = srcH;
+  m->zoom = zoom;
+  m->dstW = (zoomedW < maxW) ? zoomedW : maxW;
+  m->dstH = (zoomedH < maxH) ? zoomedH : maxH;
+  imgScaleAxisInit(&m->x, srcW, m->dstW, (uint16_t)((zoomedW - m->dstW) / 2), zoom);
+  imgScaleAxisInit(&m->y, srcH, m->dstH, (uint16_t)((zoomedH - m->dstH) / 2), zoom);
+  return true;
+}
+
+// RGB565 spread so each channel has 5 spare bits above it:
+// -----GGGGGG-----RRRRR------BBBBB.
+static inline uint32_t imgScaleSpread(uint16_t c)
+{
+  return ((uint32_t)c | ((uint32_t)c << 16)) & 0x07E0F81FU;
+}
+
+static inline uint16_t imgScalePack(uint32_t v)
+{
+  v &= 0x07E0F81FU;
+  return (uint16_t)(v | (v >> 16));
+}
+
+static inline uint16_t imgScaleSwap(uint16_t c)
+{
+  return (uint16_t)((c << 8) | (c >> 8));
+}
+
+// a + (b - a) * w / 32 on all three channels at once.
+static inline uint32_t imgScaleLerp(uint32_t a, uint32_t b, uint32_t w)
+{
+  return ((a * (32 - w) + b * w) >> 5) & 0x07E0F81FU;
+}
+
+static inline void imgScaleNearest(const ImgScaleMap *m, const uint16_t *src, uint16_t *dst)
+{
+  for (uint16_t y = 0; y < m->dstH; ++y) {
+    // The closer of the two samples the tables describe.
+    const uint16_t sy = (uint16_t)(m->y.idx[y] + (m->y.frac[y] >= 16 ? 1 : 0));
+    const uint16_t *row = src + (size_t)sy * m->srcW;
+    for (uint16_t x = 0; x < m->dstW; ++x) {
+      *dst++ = row[m->x.idx[x] + (m->x.frac[x] >= 16 ? 1 : 0)];
+    }
+  }
+}
+
+static inline void imgScaleBilinear(const ImgScaleMap *m, const uint16_t *src, uint16_t *dst, bool swapped)
+{
+  for (uint16_t y = 0; y < m->dstH; ++y) {
+    const uint16_t *row0 = src + (size_t)m->y.idx[y] * m->srcW;
+    const uint16_t *row1 = (m->y.idx[y] + 1 < m->srcH) ? row0 + m->srcW : row0;
+    const uint32_t wy = m->y.frac[y];
+    for (uint16_t x = 0; x < m->dstW; ++x) {
+      const uint16_t sx = m->x.idx[x];
+      const uint16_t sx1 = (uint16_t)(sx + 1 < m->srcW ? sx + 1 : sx);
+      const uint32_t wx = m->x.frac[x];
+      uint16_t p00 = row0[sx], p01 = row0[sx1], p10 = row1[sx], p11 = row1[sx1];
+      if (swapped) {
+        p00 = imgScaleSwap(p00);
+        p01 = imgScaleSwap(p01);
+        p10 = imgScaleSwap(p10);
+        p11 = imgScaleSwap(p11);
+      }
+      const uint32_t top = imgScaleLerp(imgScaleSpread(p00), imgScaleSpread(p01), wx);
+      const uint32_t bottom = imgScaleLerp(imgScaleSpread(p10), imgScaleSpread(p11), wx);
+      const uint16_t out = imgScalePack(imgScaleLerp(top, bottom, wy));
+      *dst++ = swapped ? imgScaleSwap(out) : out;
+    }
+  }
+}
+
+// Scales src (srcW x srcH, packed rows) into dst (dstW x dstH, packed rows).
+static inline void imgScaleRun(const ImgScaleMap *m, const uint16_t *src, uint16_t *dst, ImgScaleFilter filter, bool swapped)
+{
+  if (filter == IMG_SCALE_BILINEAR) {
+    imgScaleBilinear(m, src, dst, swapped);
+  } else {
+    imgScaleNearest(m, src, dst);
+  }
+}
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef _IMG_TRANSFORM_H_
+#define _IMG_TRANSFORM_H_
+
+#include <lvgl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "img_scale.h"
+#ifdef UI_SIM_HOST
+#include <time.h>
+#else
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+#endif
+
+// Zoomed images kept as plain RGB565. lv_img_set_zoom() makes LVGL run its
+// generic transform over the image for every area it redraws, so a label
+// or arc changing over a wallpaper re-samples the wallpaper under it each
+// time. Here the zoom is done once per source change by the fixed-point
+// scaler in img_scale.h, cropped to the viewport, and LVGL only blits.
+//
+// Each user (wallpaper, photo, video) has its own cache, keyed by the
+// source buffer, a generation the caller bumps whenever it decodes into
+// that buffer, the zoom and the viewport. Rotation is not handled; no page
+// rotates images. Used from the LVGL task only.
+#ifdef UI_SIM_HOST
+#define IMG_TRANSFORM_ALLOC(size) malloc(size)
+#else
+#define IMG_TRANSFORM_ALLOC(size) heap_caps_malloc((size), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#endif
+
+struct ImgTransformStats {
+  uint32_t hits;          // source, zoom and viewport unchanged
+  uint32_t rebuilds;
+  uint32_t passThrough;   // zoom 256, shown as is
+  uint32_t fallbacks;     // left to LVGL (not true colour, or out of memory)
+  uint32_t rebuildUsTotal;
+  uint32_t rebuildUsMax;
+};
+
+struct ImgTransformCache {
+  ImgScaleFilter filter;
+  bool valid;
+  bool mapValid;    // map matches the key's geometry
+  const void *srcData;
+  uint32_t srcGen;
+  uint16_t srcW, srcH;
+  uint16_t zoom;
+  uint16_t maxW, maxH;
+  ImgScaleMap *map;
+  uint8_t *buf;
+  size_t bufCapacity;
+  lv_img_dsc_t dsc;
+  ImgTransformStats stats;
+};
+
+static inline uint32_t imgTransformNowUs()
+{
+#ifdef UI_SIM_HOST
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL);
+#else
+  return (uint32_t)esp_timer_get_time();
+#endif
+}
+
+// An empty cache scaling with `filter`.
+static inline ImgTransformCache imgTransformCache(ImgScaleFilter filter)
+{
+  ImgTransformCache c = {};
+  c.filter = filter;
+  return c;
+}
+
+static void imgTransformFree(ImgTransformCache *c)
+{
+  free(c->map);
+  free(c->buf);
+  c->map = nullptr;
+  c->buf = nullptr;
+  c->bufCapacity = 0;
+  c->valid = false;
+  c->mapValid = false;
+}
+
+static inline size_t imgTransformRamBytes(const ImgTransformCache *c)
+{
+  return c->bufCapacity + (c->map != nullptr ? sizeof(ImgScaleMap) : 0);
+}
+
+// The image to show at zoom 256 for `src` at `zoom`, cropped to at most
+// maxW x maxH: src itself when zoom is 256, otherwise the cached transform,
+// rebuilt only when the key changed. nullptr means the caller should fall
+// back to lv_img_set_zoom().
+static const lv_img_dsc_t *imgTransformGet(ImgTransformCache *c, const lv_img_dsc_t *src, uint32_t srcGen, uint16_t zoom,
+                                           lv_coord_t maxW, lv_coord_t maxH)
+{
+  if (zoom == LV_IMG_ZOOM_NONE) {
+    c->stats.passThrough++;
+    return src;
+  }
+  if (LV_COLOR_DEPTH != 16 || src == nullptr || src->data == nullptr || src->header.cf != LV_IMG_CF_TRUE_COLOR ||
+      maxW <= 0 || maxH <= 0) {
+    c->stats.fallbacks++;
+    return nullptr;
+  }
+  if (c->valid && c->srcData == src->data && c->srcGen == srcGen && c->srcW == src->header.w &&
+      c->srcH == src->header.h && c->zoom == zoom && c->maxW == (uint16_t)maxW && c->maxH == (uint16_t)maxH) {
+    c->stats.hits++;
+    return &c->dsc;
+  }
+
+  const uint32_t start = imgTransformNowUs();
+  c->valid = false;
+  if (c->map == nullptr) {
+    c->map = (ImgScaleMap *)IMG_TRANSFORM_ALLOC(sizeof(ImgScaleMap));
+  }
+  // The tables only depend on the geometry, so a new frame at the same
+  // size reuses them.
+  const bool sameGeometry = c->mapValid && c->srcW == src->header.w && c->srcH == src->header.h && c->zoom == zoom &&
+                            c->maxW == (uint16_t)maxW && c->maxH == (uint16_t)maxH;
+  if (!sameGeometry) {
+    c->mapValid = c->map != nullptr && imgScaleMapInit(c->map, (uint16_t)src->header.w, (uint16_t)src->header.h, zoom,
+                                                       (uint16_t)maxW, (uint16_t)maxH);
+    if (!c->mapValid) {
+      c->stats.fallbacks++;
+      return nullptr;
+    }
+  }
+  const size_t bytes = (size_t)c->map->dstW * c->map->dstH * sizeof(lv_color_t);
+  if (c->bufCapacity < bytes) {
+    free(c->buf);
+    c->buf = (uint8_t *)IMG_TRANSFORM_ALLOC(bytes);
+    c->bufCapacity = (c->buf != nullptr) ? bytes : 0;
+    if (c->buf == nullptr) {
+      c->mapValid = false;
+      c->stats.fallbacks++;
+      return nullptr;
+    }
+  }
+
+  imgScaleRun(c->map, (const uint16_t *)src->data, (uint16_t *)c->buf, c->filter, LV_COLOR_16_SWAP != 0);
+  memset(&c->dsc, 0, sizeof(c->dsc));
+  c->dsc.header.always_zero = 0;
+  c->dsc.header.cf = LV_IMG_CF_TRUE_COLOR;
+  c->dsc.header.w = c->map->dstW;
+  c->dsc.header.h = c->map->dstH;
+  c->dsc.data_size = (uint32_t)bytes;
+  c->dsc.data = c->buf;
+
+  c->srcData = src->data;
+  c->srcGen = srcGen;
+  c->srcW = (uint16_t)src->header.w;
+  c->srcH = (uint16_t)src->header.h;
+  c->zoom = zoom;
+  c->maxW = (uint16_t)maxW;
+  c->maxH = (uint16_t)maxH;
+  c->valid = true;
+
+  const uint32_t us = imgTransformNowUs() - start;
+  c->stats.rebuilds++;
+  c->stats.rebuildUsTotal += us;
+  if (us > c->stats.rebuildUsMax) {
+    c->stats.rebuildUsMax = us;
+  }
+  return &c->dsc;
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef _LAYER_BLEND_H_
+#define _LAYER_BLEND_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "img_scale.h"
+
+// Pre-blended overlay for a changing background. Everything drawn over the
+// background (a shade, widgets, text) is kept per pixel as its colour
+// premultiplied by its coverage, plus how much of the background still
+// shows through (`keep`, 0..32). A new background frame is then
+// out = bg * keep / 32 + premul, one packed multiply-add per pixel, instead
+// of re-rendering the widgets over it. No LVGL or ESP-IDF dependencies, so
+// it builds on a host for benchmarking.
+//
+// Pixels may be byte-swapped (LV_COLOR_16_SWAP); premul and keep are kept
+// in native order, background and output are swapped around the blend.
+#define LAYER_BLEND_KEEP_MAX 32
+
+// Carry out of each channel of an imgScaleSpread() value, and half a step
+// of each channel after multiplying by keep.
+#define LAYER_BLEND_CARRY 0x08010020U
+#define LAYER_BLEND_HALF 0x02008010U
+
+// Splits the overlay rendered twice, once over black and once over white:
+// over black it is the premultiplied colour, and the difference between the
+// two is what the background contributes. Read on green, the widest channel.
+// overBlack may be the same buffer as premul.
+static void layerBlendSplit(const uint16_t *overBlack, const uint16_t *overWhite, uint16_t *premul, uint8_t *keep,
+                            size_t count, bool swapped)
+{
+  for (size_t i = 0; i < count; ++i) {
+    uint16_t b = overBlack[i];
+    uint16_t w = overWhite[i];
+    if (swapped) {
+      b = imgScaleSwap(b);
+      w = imgScaleSwap(w);
+    }
+    const uint32_t gb = (b >> 5) & 0x3F;
+    const uint32_t gw = (w >> 5) & 0x3F;
+    const uint32_t diff = gw > gb ? gw - gb : 0;
+    keep[i] = (uint8_t)((diff * LAYER_BLEND_KEEP_MAX + 31) / 63);
+    premul[i] = b;
+  }
+}
+
+// out = bg * keep / 32 + premul over `count` pixels. Rounding in the two
+// renders can push a channel one step past full, so sums saturate.
+static void layerBlendRun(const uint16_t *bg, const uint16_t *premul, const uint8_t *keep, uint16_t *out, size_t count,
+                          bool swapped)
+{
+  for (size_t i = 0; i < count; ++i) {
+    const uint32_t k = keep[i];
+    uint16_t px = premul[i];
+    if (k != 0) {
+      const uint16_t c = swapped ? imgScaleSwap(bg[i]) : bg[i];
+      uint32_t v = ((imgScaleSpread(c) * k + LAYER_BLEND_HALF) >> 5) & 0x07E0F81FU;
+      v += imgScaleSpread(px);
+      const uint32_t over = v & LAYER_BLEND_CARRY;
+      v |= (over - (over >> 5)) | (over >> 6);
+      px = imgScalePack(v);
+    }
+    out[i] = swapped ? imgScaleSwap(px) : px;
+  }
+}
+
+#endif
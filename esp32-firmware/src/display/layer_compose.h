@@ -0,0 +1,336 @@
+#ifndef _LAYER_COMPOSE_H_
+#define _LAYER_COMPOSE_H_
+
+#include <lvgl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "img_transform.h"
+#include "layer_blend.h"
+
+// Composes a page with a moving background (the dynamic wallpaper) from
+// two layers. Each wallpaper frame invalidates the whole screen, so without
+// this LVGL re-renders every shade, disc, shortcut button and label over
+// it for each frame. Here everything on the page except the background is
+// rendered once, twice in fact (over black and over white, see
+// layer_blend.h), into a pre-blended overlay, and each frame is composed as
+// background + overlay in one pass into an image placed on top of the page.
+// That image covers the page, so LVGL draws only it; the widgets under it
+// stay where they are and keep taking input (the image is not clickable).
+//
+// Changes to the widgets are caught at invalidation time through the
+// display's rounder_cb: anything invalidated on the page that is not ours
+// marks the overlay dirty, and layerComposeService() rebuilds it. When the
+// overlay changes about as often as the background (a sweeping seconds hand)
+// compositing costs more than it saves, so it backs off and leaves the page
+// to LVGL for a while. Used from the LVGL task only.
+#define LAYER_COMPOSE_BUSY_FRAMES 3    // frames in a row with an overlay change before backing off
+#define LAYER_COMPOSE_BACKOFF_MS 3000
+
+struct LayerComposeStats {
+  uint32_t frames;     // composed
+  uint32_t passes;     // left to LVGL (backing off, odd background, out of memory)
+  uint32_t rebuilds;
+  uint32_t backoffs;
+  uint32_t composeUsTotal;
+  uint32_t composeUsMax;
+  uint32_t rebuildUsTotal;
+  uint32_t rebuildUsMax;
+};
+
+struct LayerCompositor {
+  lv_obj_t *page;
+  lv_obj_t *under;    // the background image, left out of the overlay
+  lv_obj_t *top;      // the composed frame, last child of the page
+  uint16_t w, h;
+  uint16_t *premul;
+  uint8_t *keep;
+  uint16_t *frame;    // also holds the over-white render while rebuilding
+  const lv_img_dsc_t *bg;
+  lv_img_dsc_t dsc;
+  bool overlayValid;
+  bool overlayDirty;
+  bool quiet;         // set around our own invalidations
+  uint8_t busyFrames;
+  uint16_t rebuildsSinceFrame;
+  uint32_t backoffUntilUs;    // 0 when not backing off
+  LayerComposeStats stats;
+};
+
+static LayerCompositor *layer_compose_current = nullptr;
+
+static inline size_t layerComposeRamBytes(const LayerCompositor *c)
+{
+  return c->premul != nullptr ? (size_t)c->w * c->h * (2 * sizeof(uint16_t) + sizeof(uint8_t)) : 0;
+}
+
+static inline bool layerComposeShown(const LayerCompositor *c)
+{
+  return c->top != nullptr && !lv_obj_has_flag(c->top, LV_OBJ_FLAG_HIDDEN);
+}
+
+// True when `area` lies inside something drawn above the page rather than
+// on it: a sibling on the screen (the page indicator) or the top and system
+// layers (the perf overlay). LVGL still draws those over the composed frame.
+static bool layerComposeAbovePage(const LayerCompositor *c, const lv_area_t *area)
+{
+  lv_obj_t *roots[] = {lv_obj_get_screen(c->page), lv_layer_top(), lv_layer_sys()};
+  for (lv_obj_t *root : roots) {
+    const uint32_t count = lv_obj_get_child_cnt(root);
+    for (uint32_t i = 0; i < count; ++i) {
+      lv_obj_t *child = lv_obj_get_child(root, (int32_t)i);
+      if (child == c->page || lv_obj_has_flag(child, LV_OBJ_FLAG_HIDDEN)) {
+        continue;
+      }
+      lv_area_t coords;
+      lv_obj_get_coords(child, &coords);
+      const lv_coord_t ext = _lv_obj_get_ext_draw_size(child);
+      lv_area_increase(&coords, ext, ext);
+      if (_lv_area_is_in(area, &coords, 0)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// Installed as the display's rounder_cb; leaves the area as it is.
+static void layerComposeRounder(lv_disp_drv_t *drv, lv_area_t *area)
+{
+  (void)drv;
+  LayerCompositor *c = layer_compose_current;
+  if (c == nullptr || c->page == nullptr || c->quiet || c->overlayDirty) {
+    return;
+  }
+  // LVGL also rounds its own strips while rendering; those are not changes.
+  lv_disp_t *disp = lv_obj_get_disp(c->page);
+  if (disp == nullptr || disp->rendering_in_progress || !_lv_area_is_on(area, &c->page->coords) ||
+      layerComposeAbovePage(c, area)) {
+    return;
+  }
+  c->overlayDirty = true;
+}
+
+static void layerComposeHide(LayerCompositor *c)
+{
+  if (layerComposeShown(c)) {
+    c->quiet = true;
+    lv_obj_add_flag(c->top, LV_OBJ_FLAG_HIDDEN);
+    c->quiet = false;
+  }
+}
+
+// Stops compositing `page`, if it was: the composed image is deleted and the
+// overlay forgotten, the buffers are kept for the next attach.
+static void layerComposeDetach(LayerCompositor *c)
+{
+  if (c->top != nullptr) {
+    c->quiet = true;
+    lv_obj_del(c->top);
+    c->quiet = false;
+  }
+  c->page = nullptr;
+  c->under = nullptr;
+  c->top = nullptr;
+  c->bg = nullptr;
+  c->overlayValid = false;
+  c->overlayDirty = false;
+  c->busyFrames = 0;
+  c->rebuildsSinceFrame = 0;
+  if (layer_compose_current == c) {
+    layer_compose_current = nullptr;
+  }
+}
+
+static void layerComposeFreeBuffers(LayerCompositor *c)
+{
+  free(c->premul);
+  free(c->keep);
+  free(c->frame);
+  c->premul = nullptr;
+  c->keep = nullptr;
+  c->frame = nullptr;
+  c->bg = nullptr;
+  c->overlayValid = false;
+}
+
+static void layerComposeFree(LayerCompositor *c)
+{
+  layerComposeDetach(c);
+  layerComposeFreeBuffers(c);
+}
+
+// Composites `page` over its background image `under` from now on. The
+// composed image starts hidden; the first layerComposeFrame() shows it.
+static void layerComposeAttach(LayerCompositor *c, lv_obj_t *page, lv_obj_t *under)
+{
+  if (c->page == page && c->under == under && c->top != nullptr) {
+    return;
+  }
+  layerComposeDetach(c);
+  lv_disp_t *disp = lv_obj_get_disp(page);
+  if (disp->driver->rounder_cb != nullptr && disp->driver->rounder_cb != layerComposeRounder) {
+    return;    // the display rounds areas for its own reasons; changes can't be seen
+  }
+  disp->driver->rounder_cb = layerComposeRounder;
+  const uint16_t w = (uint16_t)lv_obj_get_width(page);
+  const uint16_t h = (uint16_t)lv_obj_get_height(page);
+  if (c->premul != nullptr && (c->w != w || c->h != h)) {
+    layerComposeFreeBuffers(c);
+  }
+  c->page = page;
+  c->under = under;
+  c->w = w;
+  c->h = h;
+  c->quiet = true;
+  c->top = lv_img_create(page);
+  lv_obj_clear_flag(c->top, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(c->top, LV_OBJ_FLAG_HIDDEN);
+  lv_obj_set_pos(c->top, 0, 0);
+  lv_obj_set_size(c->top, w, h);
+  c->quiet = false;
+  layer_compose_current = c;
+}
+
+// Renders the page without its background over black and over white and
+// splits the two into the overlay. False when out of memory.
+static bool layerComposeRebuild(LayerCompositor *c)
+{
+  const size_t count = (size_t)c->w * c->h;
+  if (c->premul == nullptr) {
+    c->premul = (uint16_t *)IMG_TRANSFORM_ALLOC(count * sizeof(uint16_t));
+    c->keep = (uint8_t *)IMG_TRANSFORM_ALLOC(count);
+    c->frame = (uint16_t *)IMG_TRANSFORM_ALLOC(count * sizeof(uint16_t));
+    if (c->premul == nullptr || c->keep == nullptr || c->frame == nullptr) {
+      layerComposeFreeBuffers(c);
+      return false;
+    }
+  }
+
+  const uint32_t start = imgTransformNowUs();
+  c->quiet = true;
+  const bool underHidden = lv_obj_has_flag(c->under, LV_OBJ_FLAG_HIDDEN);
+  const lv_opa_t bgOpa = lv_obj_get_style_bg_opa(c->page, LV_PART_MAIN);
+  const lv_color_t bgColor = lv_obj_get_style_bg_color(c->page, LV_PART_MAIN);
+  lv_obj_add_flag(c->under, LV_OBJ_FLAG_HIDDEN);
+  lv_obj_add_flag(c->top, LV_OBJ_FLAG_HIDDEN);
+  lv_obj_set_style_bg_opa(c->page, LV_OPA_COVER, LV_PART_MAIN);
+  lv_img_dsc_t shot;
+  const uint32_t bytes = (uint32_t)(count * sizeof(uint16_t));
+  lv_obj_set_style_bg_color(c->page, lv_color_black(), LV_PART_MAIN);
+  bool ok = lv_snapshot_take_to_buf(c->page, LV_IMG_CF_TRUE_COLOR, &shot, c->premul, bytes) == LV_RES_OK &&
+            shot.header.w == c->w && shot.header.h == c->h;
+  lv_obj_set_style_bg_color(c->page, lv_color_white(), LV_PART_MAIN);
+  ok = ok && lv_snapshot_take_to_buf(c->page, LV_IMG_CF_TRUE_COLOR, &shot, c->frame, bytes) == LV_RES_OK;
+  lv_obj_set_style_bg_opa(c->page, bgOpa, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(c->page, bgColor, LV_PART_MAIN);
+  if (!underHidden) {
+    lv_obj_clear_flag(c->under, LV_OBJ_FLAG_HIDDEN);
+  }
+  c->quiet = false;
+  if (!ok) {
+    return false;
+  }
+  layerBlendSplit(c->premul, c->frame, c->premul, c->keep, count, LV_COLOR_16_SWAP != 0);
+  c->overlayValid = true;
+  c->rebuildsSinceFrame++;
+
+  const uint32_t us = imgTransformNowUs() - start;
+  c->stats.rebuilds++;
+  c->stats.rebuildUsTotal += us;
+  if (us > c->stats.rebuildUsMax) {
+    c->stats.rebuildUsMax = us;
+  }
+  return true;
+}
+
+// Blends c->bg with the overlay and shows the result on top of the page.
+static void layerComposeShow(LayerCompositor *c)
+{
+  const uint32_t start = imgTransformNowUs();
+  const size_t count = (size_t)c->w * c->h;
+  layerBlendRun((const uint16_t *)c->bg->data, c->premul, c->keep, c->frame, count, LV_COLOR_16_SWAP != 0);
+  memset(&c->dsc, 0, sizeof(c->dsc));
+  c->dsc.header.always_zero = 0;
+  c->dsc.header.cf = LV_IMG_CF_TRUE_COLOR;
+  c->dsc.header.w = c->w;
+  c->dsc.header.h = c->h;
+  c->dsc.data_size = (uint32_t)(count * sizeof(uint16_t));
+  c->dsc.data = (const uint8_t *)c->frame;
+
+  c->quiet = true;
+  if (lv_obj_get_index(c->top) + 1 != lv_obj_get_child_cnt(c->page)) {
+    lv_obj_move_foreground(c->top);
+  }
+  lv_img_set_src(c->top, nullptr);
+  lv_img_set_src(c->top, &c->dsc);
+  lv_obj_clear_flag(c->top, LV_OBJ_FLAG_HIDDEN);
+  c->quiet = false;
+
+  const uint32_t us = imgTransformNowUs() - start;
+  c->stats.frames++;
+  c->stats.composeUsTotal += us;
+  if (us > c->stats.composeUsMax) {
+    c->stats.composeUsMax = us;
+  }
+}
+
+// A new background frame. `bg` is what `under` now shows at zoom 256 and
+// must cover the page exactly as plain true colour; anything else (or
+// nullptr, for a frame LVGL zooms itself) is left to LVGL. The caller
+// updates `under` with c->quiet set. Returns true when composed.
+static bool layerComposeFrame(LayerCompositor *c, const lv_img_dsc_t *bg)
+{
+  if (c->page == nullptr) {
+    return false;
+  }
+  const bool busy = c->overlayDirty || c->rebuildsSinceFrame > 0;
+  c->busyFrames = busy ? (uint8_t)(c->busyFrames + 1) : 0;
+  const uint32_t nowUs = imgTransformNowUs();
+  if (c->busyFrames >= LAYER_COMPOSE_BUSY_FRAMES) {
+    c->busyFrames = 0;
+    c->backoffUntilUs = (nowUs + LAYER_COMPOSE_BACKOFF_MS * 1000U) | 1U;
+    c->stats.backoffs++;
+  }
+  if (c->overlayDirty) {
+    c->overlayDirty = false;
+    c->overlayValid = false;
+  }
+
+  if (c->backoffUntilUs != 0 && (int32_t)(c->backoffUntilUs - nowUs) <= 0) {
+    c->backoffUntilUs = 0;
+  }
+
+  c->bg = nullptr;
+  const bool fits = LV_COLOR_DEPTH == 16 && bg != nullptr && bg->data != nullptr &&
+                    bg->header.cf == LV_IMG_CF_TRUE_COLOR && bg->header.w == c->w && bg->header.h == c->h;
+  const bool composed = fits && c->backoffUntilUs == 0 && (c->overlayValid || layerComposeRebuild(c));
+  c->rebuildsSinceFrame = 0;
+  if (!composed) {
+    layerComposeHide(c);
+    c->stats.passes++;
+    return false;
+  }
+  c->bg = bg;
+  layerComposeShow(c);
+  return true;
+}
+
+// Between frames: when a widget on the page changed under the composed
+// image, rebuilds the overlay and recomposes the last frame, so presses and
+// clock ticks show without waiting for the next wallpaper frame.
+static void layerComposeService(LayerCompositor *c)
+{
+  if (!c->overlayDirty || !layerComposeShown(c) || c->bg == nullptr) {
+    return;
+  }
+  c->overlayDirty = false;
+  if (!layerComposeRebuild(c)) {
+    c->overlayValid = false;
+    layerComposeHide(c);
+    return;
+  }
+  layerComposeShow(c);
+}
+
+#endif
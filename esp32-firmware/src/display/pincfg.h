@@ -11,6 +11,11 @@
 #define TFT_SDA1 12
 #define TFT_SDA2 13
 #define TFT_SDA3 14
+// Panel TE (tearing effect) output. Not routed on the JC3636W518C; set it
+// from build_flags on a board that wires it to a GPIO.
+#ifndef TFT_TE
+#define TFT_TE -1
+#endif
 #define BTN_PIN 0
 
 #define TOUCH_PIN_NUM_I2C_SCL 8
@@ -0,0 +1,219 @@
+#ifndef _ROUND_CLIP_H_
+#define _ROUND_CLIP_H_
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Geometry for a round panel driven as a square frame buffer. Each row has
+// one visible span [spanX1, spanX2]; rectangles are cut into horizontal
+// bands, each as wide as the widest span it covers, so the corners are
+// neither rendered nor sent. No LVGL or ESP-IDF dependencies, so it builds
+// on a host for counting pixels.
+#define ROUND_CLIP_MAX_RES 480
+#define ROUND_CLIP_MAX_BANDS 8
+#define ROUND_CLIP_MAX_CELLS 64
+
+struct RoundClipRect {
+  int16_t x1, y1, x2, y2;   // inclusive, like lv_area_t
+};
+
+struct RoundClip {
+  int16_t res;
+  int16_t spanX1[ROUND_CLIP_MAX_RES];
+  int16_t spanX2[ROUND_CLIP_MAX_RES];   // < spanX1 when the row is empty
+};
+
+static inline uint32_t roundClipRectSize(const RoundClipRect *r)
+{
+  return (uint32_t)(r->x2 - r->x1 + 1) * (uint32_t)(r->y2 - r->y1 + 1);
+}
+
+// A pixel is visible when its centre is within res/2 + marginPx of the
+// panel centre; a small margin keeps the anti-aliased rim.
+static void roundClipInit(RoundClip *rc, int16_t res, float marginPx)
+{
+  rc->res = res;
+  const float c = res * 0.5f;
+  const float r = c + marginPx;
+  for (int y = 0; y < res; ++y) {
+    const float dy = y + 0.5f - c;
+    const float d = r * r - dy * dy;
+    if (d < 0.0f) {
+      rc->spanX1[y] = res;
+      rc->spanX2[y] = -1;
+      continue;
+    }
+    const float hw = sqrtf(d);
+    int x1 = (int)ceilf(c - hw - 0.5f);
+    int x2 = (int)floorf(c + hw - 0.5f);
+    rc->spanX1[y] = (int16_t)(x1 < 0 ? 0 : x1);
+    rc->spanX2[y] = (int16_t)(x2 > res - 1 ? res - 1 : x2);
+  }
+}
+
+// Visible part of row y within [x1, x2]; false when there is none.
+static inline bool roundClipRowSpan(const RoundClip *rc, int y, int x1, int x2, int *outX1, int *outX2)
+{
+  if (y < 0 || y >= rc->res) {
+    return false;
+  }
+  const int a = (rc->spanX1[y] > x1) ? rc->spanX1[y] : x1;
+  const int b = (rc->spanX2[y] < x2) ? rc->spanX2[y] : x2;
+  if (a > b) {
+    return false;
+  }
+  *outX1 = a;
+  *outX2 = b;
+  return true;
+}
+
+// Cuts the visible part of `in` into at most maxBands bands whose edges fall
+// on multiples of `step` rows, minimizing covered pixels plus bandCostPx per
+// band (the fixed cost of one more LVGL area or one more bus transaction).
+// Returns the band count; 0 means `in` lies entirely in the corners.
+static int roundClipPlanBands(const RoundClip *rc, const RoundClipRect *in, int maxBands, uint32_t bandCostPx, int step,
+                              RoundClipRect *bands)
+{
+  // Visible rows of a rectangle and a disc are contiguous.
+  int ya = -1;
+  int yb = -1;
+  for (int y = in->y1; y <= in->y2; ++y) {
+    int a, b;
+    if (roundClipRowSpan(rc, y, in->x1, in->x2, &a, &b)) {
+      if (ya < 0) {
+        ya = y;
+      }
+      yb = y;
+    } else if (ya >= 0) {
+      break;
+    }
+  }
+  if (ya < 0) {
+    return 0;
+  }
+
+  if (maxBands > ROUND_CLIP_MAX_BANDS) {
+    maxBands = ROUND_CLIP_MAX_BANDS;
+  }
+  if (maxBands < 1) {
+    maxBands = 1;
+  }
+  const int rows = yb - ya + 1;
+  if (step < 1) {
+    step = 1;
+  }
+  while ((rows + step - 1) / step > ROUND_CLIP_MAX_CELLS) {
+    step *= 2;
+  }
+  const int cells = (rows + step - 1) / step;
+
+  int16_t cellX1[ROUND_CLIP_MAX_CELLS];
+  int16_t cellX2[ROUND_CLIP_MAX_CELLS];
+  for (int c = 0; c < cells; ++c) {
+    int lo = in->x2;
+    int hi = in->x1;
+    const int yEnd = (ya + (c + 1) * step - 1 < yb) ? ya + (c + 1) * step - 1 : yb;
+    for (int y = ya + c * step; y <= yEnd; ++y) {
+      int a = lo;    // rows in [ya, yb] are all visible; the defaults only quiet -Wmaybe-uninitialized
+      int b = hi;
+      roundClipRowSpan(rc, y, in->x1, in->x2, &a, &b);
+      lo = (a < lo) ? a : lo;
+      hi = (b > hi) ? b : hi;
+    }
+    cellX1[c] = (int16_t)lo;
+    cellX2[c] = (int16_t)hi;
+  }
+
+  // cost[k][j]: best cover of cells 0..j with k+1 bands; from[k][j]: first
+  // cell of the last band. Static to keep 2.5 KB off the caller's stack
+  // (the LVGL flush path); only the LVGL task calls this.
+  static uint32_t cost[ROUND_CLIP_MAX_BANDS][ROUND_CLIP_MAX_CELLS];
+  static uint8_t from[ROUND_CLIP_MAX_BANDS][ROUND_CLIP_MAX_CELLS];
+  for (int k = 0; k < maxBands; ++k) {
+    for (int j = 0; j < cells; ++j) {
+      cost[k][j] = UINT32_MAX;
+      int lo = cellX1[j];
+      int hi = cellX2[j];
+      for (int i = j; i >= 0; --i) {
+        lo = (cellX1[i] < lo) ? cellX1[i] : lo;
+        hi = (cellX2[i] > hi) ? cellX2[i] : hi;
+        const uint32_t prev = (i == 0) ? 0 : (k == 0 ? UINT32_MAX : cost[k - 1][i - 1]);
+        if (prev == UINT32_MAX) {
+          continue;
+        }
+        const int y1 = ya + i * step;
+        const int y2 = (ya + (j + 1) * step - 1 < yb) ? ya + (j + 1) * step - 1 : yb;
+        const uint32_t c = prev + (uint32_t)(hi - lo + 1) * (uint32_t)(y2 - y1 + 1) + bandCostPx;
+        if (c < cost[k][j]) {
+          cost[k][j] = c;
+          from[k][j] = (uint8_t)i;
+        }
+      }
+    }
+  }
+
+  int best = 0;
+  for (int k = 1; k < maxBands; ++k) {
+    if (cost[k][cells - 1] < cost[best][cells - 1]) {
+      best = k;
+    }
+  }
+
+  const int count = best + 1;
+  int j = cells - 1;
+  for (int k = best; k >= 0; --k) {
+    const int i = from[k][j];
+    int lo = cellX1[i];
+    int hi = cellX2[i];
+    for (int c = i + 1; c <= j; ++c) {
+      lo = (cellX1[c] < lo) ? cellX1[c] : lo;
+      hi = (cellX2[c] > hi) ? cellX2[c] : hi;
+    }
+    bands[k].x1 = (int16_t)lo;
+    bands[k].x2 = (int16_t)hi;
+    bands[k].y1 = (int16_t)(ya + i * step);
+    bands[k].y2 = (int16_t)((ya + (j + 1) * step - 1 < yb) ? ya + (j + 1) * step - 1 : yb);
+    j = i - 1;
+  }
+  return count;
+}
+
+// Repacks the bands of a rendered area, top to bottom, into a contiguous
+// run starting at buf so each band can be sent as its own bitmap. Works in
+// place: a band never lands past where its rows started. Each band starts
+// on a multiple of `align` bytes (a power of two) so the bus can DMA it
+// straight from the buffer. Returns the byte offset of each band in
+// offsets[], or false, with buf untouched, when a band's rows already sit
+// at an unaligned offset with nothing free ahead of them to shift into.
+static bool roundClipPackBands(uint8_t *buf, size_t pixelBytes, const RoundClipRect *area, const RoundClipRect *bands,
+                               int count, size_t align, size_t *offsets)
+{
+  const size_t areaW = (size_t)(area->x2 - area->x1 + 1);
+  size_t out = 0;
+  for (int b = 0; b < count; ++b) {
+    out = (out + align - 1) & ~(align - 1);
+    const size_t src = ((size_t)(bands[b].y1 - area->y1) * areaW + (size_t)(bands[b].x1 - area->x1)) * pixelBytes;
+    if (out > src) {
+      return false;
+    }
+    offsets[b] = out;
+    out += roundClipRectSize(&bands[b]) * pixelBytes;
+  }
+
+  for (int b = 0; b < count; ++b) {
+    const size_t bandW = (size_t)(bands[b].x2 - bands[b].x1 + 1);
+    out = offsets[b];
+    for (int y = bands[b].y1; y <= bands[b].y2; ++y) {
+      const size_t src = ((size_t)(y - area->y1) * areaW + (size_t)(bands[b].x1 - area->x1)) * pixelBytes;
+      if (src != out) {
+        memmove(buf + out, buf + src, bandW * pixelBytes);
+      }
+      out += bandW * pixelBytes;
+    }
+  }
+  return true;
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef _ROUND_REFR_H_
+#define _ROUND_REFR_H_
+
+#include <lvgl.h>
+#include <string.h>
+#include "round_clip.h"
+
+// LVGL side of round_clip.h, shared by the panel driver and the host
+// simulator (src/sim) so both render the same areas.
+//
+// Round panel: the corners of the 360x360 frame are never seen, about 21%
+// of it. Invalidated areas are cut into row bands that hug the circle before
+// LVGL renders them, areas entirely in a corner are dropped, and each flushed
+// strip is sent as bands too. Every band costs one more LVGL area or one
+// more QSPI transaction, so a split has to save at least that many pixels.
+#ifndef LCD_ROUND_CLIP
+#define LCD_ROUND_CLIP 1
+#endif
+#define LCD_ROUND_MARGIN_PX 1
+#define LCD_ROUND_AREA_MAX_BANDS 6
+#define LCD_ROUND_AREA_STEP 8          // area bands start on multiples of 8 rows
+#define LCD_ROUND_AREA_COST_PX 1500
+#define LCD_ROUND_FLUSH_MAX_BANDS 4
+#define LCD_ROUND_FLUSH_COST_PX 800
+#define LCD_ROUND_FLUSH_ALIGN 4        // SPI DMA bounces unaligned buffers through a malloc'd copy
+
+#if LCD_ROUND_CLIP
+static RoundClip lcd_round;
+
+// Wraps LVGL's refresh timer: rewrites the invalidated areas into bands
+// inside the circle just before they are joined and rendered. Bands stacked
+// on each other never get re-joined, since their bounding box is never
+// smaller than the two of them. Runs on the LVGL task only.
+static void lcd_round_refr_timer(lv_timer_t *timer)
+{
+  lv_disp_t *disp = (lv_disp_t *)timer->user_data;
+  static lv_area_t out[LV_INV_BUF_SIZE];
+  uint16_t n = 0;
+  for (uint16_t i = 0; i < disp->inv_p; ++i)
+  {
+    const lv_area_t *a = &disp->inv_areas[i];
+    const RoundClipRect rect = {(int16_t)a->x1, (int16_t)a->y1, (int16_t)a->x2, (int16_t)a->y2};
+    RoundClipRect bands[LCD_ROUND_AREA_MAX_BANDS];
+    // Leave room for the areas still to come, one slot each.
+    const int room = LV_INV_BUF_SIZE - n - (disp->inv_p - i - 1);
+    const int max_bands = room < LCD_ROUND_AREA_MAX_BANDS ? room : LCD_ROUND_AREA_MAX_BANDS;
+    const int count = roundClipPlanBands(&lcd_round, &rect, max_bands, LCD_ROUND_AREA_COST_PX, LCD_ROUND_AREA_STEP, bands);
+    for (int k = 0; k < count; ++k)
+    {
+      out[n].x1 = bands[k].x1;
+      out[n].y1 = bands[k].y1;
+      out[n].x2 = bands[k].x2;
+      out[n].y2 = bands[k].y2;
+      n++;
+    }
+  }
+  memcpy(disp->inv_areas, out, n * sizeof(lv_area_t));
+  memset(disp->inv_area_joined, 0, sizeof(disp->inv_area_joined));
+  disp->inv_p = n;
+  _lv_disp_refr_timer(timer);
+}
+#endif
+
+#endif
@@ -1,18 +1,48 @@
-#ifndef _SCR_ST77916_H_
-#define _SCR_ST77916_H_
-
+#ifndef _SCR_ST77916_H_
+#define _SCR_ST77916_H_
+
 #include "pincfg.h"
 #include <assert.h>
+#include <atomic>
 #include <lvgl.h>
 #include <ESP_Panel_Library.h>
+#include <esp_timer.h>
+#include "round_refr.h"
 
 #define SCREEN_RES_HOR 360
 #define SCREEN_RES_VER 360
 
+// LVGL draw buffers (DMA-capable internal RAM). With two, LVGL renders the
+// next strip while the previous one is still going out over QSPI; with one
+// it idles until each transfer finishes. LVGL 8 takes at most two. Both can
+// be overridden from build_flags; taller strips mean fewer flushes per frame
+// but more RAM, and a strip also has to fit the bus transaction queue or
+// drawBitmap() blocks part-way.
+#ifndef LCD_DRAW_BUF_COUNT
+#define LCD_DRAW_BUF_COUNT 2
+#endif
+#ifndef LCD_DRAW_BUF_ROWS
+#define LCD_DRAW_BUF_ROWS 40
+#endif
+#define LCD_DRAW_BUF_MIN_ROWS 10
+
+// Perf overlay: FPS and CPU like LVGL's monitor, plus frame time and how
+// long each frame spent in QSPI transfers and blocked waiting on them.
+#ifndef LCD_PERF_MONITOR
+#define LCD_PERF_MONITOR 1
+#endif
+#define LCD_PERF_PERIOD_MS 500
+
+// How long a media present waits for the panel's TE edge before going out
+// anyway. The ST77916 refreshes at about 60 Hz, so this is over a period.
+#define LCD_TE_TIMEOUT_MS 25
+
 #define EXAMPLE_TOUCH_I2C_SCL_PULLUP    (1)  // 0/1
 #define EXAMPLE_TOUCH_I2C_SDA_PULLUP    (1)  // 0/1
 
 static lv_color_t *disp_draw_buf;
+static lv_color_t *disp_draw_buf2;
+static size_t disp_draw_buf_rows = 0;
 static lv_disp_draw_buf_t draw_buf;
 static lv_disp_drv_t disp_drv;
 static lv_indev_t *indev_touchpad;
@@ -21,205 +51,284 @@ static ESP_PanelBacklightPWM_LEDC *backlight = NULL;
 static ESP_PanelLcd *lcd = NULL;
 static ESP_PanelTouch *touch = NULL;
 #define USE_CUSTOM_INIT_CMD 0 // 是否用自定义的初始化代码
-
-#if TOUCH_PIN_NUM_INT >= 0
-
-IRAM_ATTR bool onTouchInterruptCallback(void *user_data)
-{
-  return false;
-}
-
-#endif
-
-const esp_lcd_panel_vendor_init_cmd_t lcd_init_cmd[] = {
-     {0xF0, (uint8_t[]){0x28}, 1, 0},
-    {0xF2, (uint8_t[]){0x28}, 1, 0},
-    {0x73, (uint8_t[]){0xF0}, 1, 0},
-    {0x7C, (uint8_t[]){0xD1}, 1, 0},
-    {0x83, (uint8_t[]){0xE0}, 1, 0},
-    {0x84, (uint8_t[]){0x61}, 1, 0},
-    {0xF2, (uint8_t[]){0x82}, 1, 0},
-    {0xF0, (uint8_t[]){0x00}, 1, 0},
-    {0xF0, (uint8_t[]){0x01}, 1, 0},
-    {0xF1, (uint8_t[]){0x01}, 1, 0},
-    {0xB0, (uint8_t[]){0x56}, 1, 0},
-    {0xB1, (uint8_t[]){0x4D}, 1, 0},
-    {0xB2, (uint8_t[]){0x24}, 1, 0},
-    {0xB4, (uint8_t[]){0x87}, 1, 0},
-    {0xB5, (uint8_t[]){0x44}, 1, 0},
-    {0xB6, (uint8_t[]){0x8B}, 1, 0},
-    {0xB7, (uint8_t[]){0x40}, 1, 0},
-    {0xB8, (uint8_t[]){0x86}, 1, 0},
-    {0xBA, (uint8_t[]){0x00}, 1, 0},
-    {0xBB, (uint8_t[]){0x08}, 1, 0},
-    {0xBC, (uint8_t[]){0x08}, 1, 0},
-    {0xBD, (uint8_t[]){0x00}, 1, 0},
-    {0xC0, (uint8_t[]){0x80}, 1, 0},
-    {0xC1, (uint8_t[]){0x10}, 1, 0},
-    {0xC2, (uint8_t[]){0x37}, 1, 0},
-    {0xC3, (uint8_t[]){0x80}, 1, 0},
-    {0xC4, (uint8_t[]){0x10}, 1, 0},
-    {0xC5, (uint8_t[]){0x37}, 1, 0},
-    {0xC6, (uint8_t[]){0xA9}, 1, 0},
-    {0xC7, (uint8_t[]){0x41}, 1, 0},
-    {0xC8, (uint8_t[]){0x01}, 1, 0},
-    {0xC9, (uint8_t[]){0xA9}, 1, 0},
-    {0xCA, (uint8_t[]){0x41}, 1, 0},
-    {0xCB, (uint8_t[]){0x01}, 1, 0},
-    {0xD0, (uint8_t[]){0x91}, 1, 0},
-    {0xD1, (uint8_t[]){0x68}, 1, 0},
-    {0xD2, (uint8_t[]){0x68}, 1, 0},
-    {0xF5, (uint8_t[]){0x00, 0xA5}, 2, 0},
-    {0xDD, (uint8_t[]){0x4F}, 1, 0},
-    {0xDE, (uint8_t[]){0x4F}, 1, 0},
-    {0xF1, (uint8_t[]){0x10}, 1, 0},
-    {0xF0, (uint8_t[]){0x00}, 1, 0},
-    {0xF0, (uint8_t[]){0x02}, 1, 0},
-    {0xE0, (uint8_t[]){0xF0, 0x0A, 0x10, 0x09, 0x09, 0x36, 0x35, 0x33, 0x4A, 0x29, 0x15, 0x15, 0x2E, 0x34}, 14, 0},
-    {0xE1, (uint8_t[]){0xF0, 0x0A, 0x0F, 0x08, 0x08, 0x05, 0x34, 0x33, 0x4A, 0x39, 0x15, 0x15, 0x2D, 0x33}, 14, 0},
-    {0xF0, (uint8_t[]){0x10}, 1, 0},
-    {0xF3, (uint8_t[]){0x10}, 1, 0},
-    {0xE0, (uint8_t[]){0x07}, 1, 0},
-    {0xE1, (uint8_t[]){0x00}, 1, 0},
-    {0xE2, (uint8_t[]){0x00}, 1, 0},
-    {0xE3, (uint8_t[]){0x00}, 1, 0},
-    {0xE4, (uint8_t[]){0xE0}, 1, 0},
-    {0xE5, (uint8_t[]){0x06}, 1, 0},
-    {0xE6, (uint8_t[]){0x21}, 1, 0},
-    {0xE7, (uint8_t[]){0x01}, 1, 0},
-    {0xE8, (uint8_t[]){0x05}, 1, 0},
-    {0xE9, (uint8_t[]){0x02}, 1, 0},
-    {0xEA, (uint8_t[]){0xDA}, 1, 0},
-    {0xEB, (uint8_t[]){0x00}, 1, 0},
-    {0xEC, (uint8_t[]){0x00}, 1, 0},
-    {0xED, (uint8_t[]){0x0F}, 1, 0},
-    {0xEE, (uint8_t[]){0x00}, 1, 0},
-    {0xEF, (uint8_t[]){0x00}, 1, 0},
-    {0xF8, (uint8_t[]){0x00}, 1, 0},
-    {0xF9, (uint8_t[]){0x00}, 1, 0},
-    {0xFA, (uint8_t[]){0x00}, 1, 0},
-    {0xFB, (uint8_t[]){0x00}, 1, 0},
-    {0xFC, (uint8_t[]){0x00}, 1, 0},
-    {0xFD, (uint8_t[]){0x00}, 1, 0},
-    {0xFE, (uint8_t[]){0x00}, 1, 0},
-    {0xFF, (uint8_t[]){0x00}, 1, 0},
-    {0x60, (uint8_t[]){0x40}, 1, 0},
-    {0x61, (uint8_t[]){0x04}, 1, 0},
-    {0x62, (uint8_t[]){0x00}, 1, 0},
-    {0x63, (uint8_t[]){0x42}, 1, 0},
-    {0x64, (uint8_t[]){0xD9}, 1, 0},
-    {0x65, (uint8_t[]){0x00}, 1, 0},
-    {0x66, (uint8_t[]){0x00}, 1, 0},
-    {0x67, (uint8_t[]){0x00}, 1, 0},
-    {0x68, (uint8_t[]){0x00}, 1, 0},
-    {0x69, (uint8_t[]){0x00}, 1, 0},
-    {0x6A, (uint8_t[]){0x00}, 1, 0},
-    {0x6B, (uint8_t[]){0x00}, 1, 0},
-    {0x70, (uint8_t[]){0x40}, 1, 0},
-    {0x71, (uint8_t[]){0x03}, 1, 0},
-    {0x72, (uint8_t[]){0x00}, 1, 0},
-    {0x73, (uint8_t[]){0x42}, 1, 0},
-    {0x74, (uint8_t[]){0xD8}, 1, 0},
-    {0x75, (uint8_t[]){0x00}, 1, 0},
-    {0x76, (uint8_t[]){0x00}, 1, 0},
-    {0x77, (uint8_t[]){0x00}, 1, 0},
-    {0x78, (uint8_t[]){0x00}, 1, 0},
-    {0x79, (uint8_t[]){0x00}, 1, 0},
-    {0x7A, (uint8_t[]){0x00}, 1, 0},
-    {0x7B, (uint8_t[]){0x00}, 1, 0},
-    {0x80, (uint8_t[]){0x48}, 1, 0},
-    {0x81, (uint8_t[]){0x00}, 1, 0},
-    {0x82, (uint8_t[]){0x06}, 1, 0},
-    {0x83, (uint8_t[]){0x02}, 1, 0},
-    {0x84, (uint8_t[]){0xD6}, 1, 0},
-    {0x85, (uint8_t[]){0x04}, 1, 0},
-    {0x86, (uint8_t[]){0x00}, 1, 0},
-    {0x87, (uint8_t[]){0x00}, 1, 0},
-    {0x88, (uint8_t[]){0x48}, 1, 0},
-    {0x89, (uint8_t[]){0x00}, 1, 0},
-    {0x8A, (uint8_t[]){0x08}, 1, 0},
-    {0x8B, (uint8_t[]){0x02}, 1, 0},
-    {0x8C, (uint8_t[]){0xD8}, 1, 0},
-    {0x8D, (uint8_t[]){0x04}, 1, 0},
-    {0x8E, (uint8_t[]){0x00}, 1, 0},
-    {0x8F, (uint8_t[]){0x00}, 1, 0},
-    {0x90, (uint8_t[]){0x48}, 1, 0},
-    {0x91, (uint8_t[]){0x00}, 1, 0},
-    {0x92, (uint8_t[]){0x0A}, 1, 0},
-    {0x93, (uint8_t[]){0x02}, 1, 0},
-    {0x94, (uint8_t[]){0xDA}, 1, 0},
-    {0x95, (uint8_t[]){0x04}, 1, 0},
-    {0x96, (uint8_t[]){0x00}, 1, 0},
-    {0x97, (uint8_t[]){0x00}, 1, 0},
-    {0x98, (uint8_t[]){0x48}, 1, 0},
-    {0x99, (uint8_t[]){0x00}, 1, 0},
-    {0x9A, (uint8_t[]){0x0C}, 1, 0},
-    {0x9B, (uint8_t[]){0x02}, 1, 0},
-    {0x9C, (uint8_t[]){0xDC}, 1, 0},
-    {0x9D, (uint8_t[]){0x04}, 1, 0},
-    {0x9E, (uint8_t[]){0x00}, 1, 0},
-    {0x9F, (uint8_t[]){0x00}, 1, 0},
-    {0xA0, (uint8_t[]){0x48}, 1, 0},
-    {0xA1, (uint8_t[]){0x00}, 1, 0},
-    {0xA2, (uint8_t[]){0x05}, 1, 0},
-    {0xA3, (uint8_t[]){0x02}, 1, 0},
-    {0xA4, (uint8_t[]){0xD5}, 1, 0},
-    {0xA5, (uint8_t[]){0x04}, 1, 0},
-    {0xA6, (uint8_t[]){0x00}, 1, 0},
-    {0xA7, (uint8_t[]){0x00}, 1, 0},
-    {0xA8, (uint8_t[]){0x48}, 1, 0},
-    {0xA9, (uint8_t[]){0x00}, 1, 0},
-    {0xAA, (uint8_t[]){0x07}, 1, 0},
-    {0xAB, (uint8_t[]){0x02}, 1, 0},
-    {0xAC, (uint8_t[]){0xD7}, 1, 0},
-    {0xAD, (uint8_t[]){0x04}, 1, 0},
-    {0xAE, (uint8_t[]){0x00}, 1, 0},
-    {0xAF, (uint8_t[]){0x00}, 1, 0},
-    {0xB0, (uint8_t[]){0x48}, 1, 0},
-    {0xB1, (uint8_t[]){0x00}, 1, 0},
-    {0xB2, (uint8_t[]){0x09}, 1, 0},
-    {0xB3, (uint8_t[]){0x02}, 1, 0},
-    {0xB4, (uint8_t[]){0xD9}, 1, 0},
-    {0xB5, (uint8_t[]){0x04}, 1, 0},
-    {0xB6, (uint8_t[]){0x00}, 1, 0},
-    {0xB7, (uint8_t[]){0x00}, 1, 0},
-    {0xB8, (uint8_t[]){0x48}, 1, 0},
-    {0xB9, (uint8_t[]){0x00}, 1, 0},
-    {0xBA, (uint8_t[]){0x0B}, 1, 0},
-    {0xBB, (uint8_t[]){0x02}, 1, 0},
-    {0xBC, (uint8_t[]){0xDB}, 1, 0},
-    {0xBD, (uint8_t[]){0x04}, 1, 0},
-    {0xBE, (uint8_t[]){0x00}, 1, 0},
-    {0xBF, (uint8_t[]){0x00}, 1, 0},
-    {0xC0, (uint8_t[]){0x10}, 1, 0},
-    {0xC1, (uint8_t[]){0x47}, 1, 0},
-    {0xC2, (uint8_t[]){0x56}, 1, 0},
-    {0xC3, (uint8_t[]){0x65}, 1, 0},
-    {0xC4, (uint8_t[]){0x74}, 1, 0},
-    {0xC5, (uint8_t[]){0x88}, 1, 0},
-    {0xC6, (uint8_t[]){0x99}, 1, 0},
-    {0xC7, (uint8_t[]){0x01}, 1, 0},
-    {0xC8, (uint8_t[]){0xBB}, 1, 0},
-    {0xC9, (uint8_t[]){0xAA}, 1, 0},
-    {0xD0, (uint8_t[]){0x10}, 1, 0},
-    {0xD1, (uint8_t[]){0x47}, 1, 0},
-    {0xD2, (uint8_t[]){0x56}, 1, 0},
-    {0xD3, (uint8_t[]){0x65}, 1, 0},
-    {0xD4, (uint8_t[]){0x74}, 1, 0},
-    {0xD5, (uint8_t[]){0x88}, 1, 0},
-    {0xD6, (uint8_t[]){0x99}, 1, 0},
-    {0xD7, (uint8_t[]){0x01}, 1, 0},
-    {0xD8, (uint8_t[]){0xBB}, 1, 0},
-    {0xD9, (uint8_t[]){0xAA}, 1, 0},
-    {0xF3, (uint8_t[]){0x01}, 1, 0},
-    {0xF0, (uint8_t[]){0x00}, 1, 0},
-    {0x21, (uint8_t[]){0x00}, 1, 0},
-    {0x11, (uint8_t[]){0x00}, 1, 120},
-    {0x29, (uint8_t[]){0x00}, 1, 0}
-};
-
-#define TFT_SPI_FREQ_HZ (50 * 1000 * 1000)
-
+
+#if TOUCH_PIN_NUM_INT >= 0
+
+IRAM_ATTR bool onTouchInterruptCallback(void *user_data)
+{
+  return false;
+}
+
+#endif
+
+const esp_lcd_panel_vendor_init_cmd_t lcd_init_cmd[] = {
+     {0xF0, (uint8_t[]){0x28}, 1, 0},
+    {0xF2, (uint8_t[]){0x28}, 1, 0},
+    {0x73, (uint8_t[]){0xF0}, 1, 0},
+    {0x7C, (uint8_t[]){0xD1}, 1, 0},
+    {0x83, (uint8_t[]){0xE0}, 1, 0},
+    {0x84, (uint8_t[]){0x61}, 1, 0},
+    {0xF2, (uint8_t[]){0x82}, 1, 0},
+    {0xF0, (uint8_t[]){0x00}, 1, 0},
+    {0xF0, (uint8_t[]){0x01}, 1, 0},
+    {0xF1, (uint8_t[]){0x01}, 1, 0},
+    {0xB0, (uint8_t[]){0x56}, 1, 0},
+    {0xB1, (uint8_t[]){0x4D}, 1, 0},
+    {0xB2, (uint8_t[]){0x24}, 1, 0},
+    {0xB4, (uint8_t[]){0x87}, 1, 0},
+    {0xB5, (uint8_t[]){0x44}, 1, 0},
+    {0xB6, (uint8_t[]){0x8B}, 1, 0},
+    {0xB7, (uint8_t[]){0x40}, 1, 0},
+    {0xB8, (uint8_t[]){0x86}, 1, 0},
+    {0xBA, (uint8_t[]){0x00}, 1, 0},
+    {0xBB, (uint8_t[]){0x08}, 1, 0},
+    {0xBC, (uint8_t[]){0x08}, 1, 0},
+    {0xBD, (uint8_t[]){0x00}, 1, 0},
+    {0xC0, (uint8_t[]){0x80}, 1, 0},
+    {0xC1, (uint8_t[]){0x10}, 1, 0},
+    {0xC2, (uint8_t[]){0x37}, 1, 0},
+    {0xC3, (uint8_t[]){0x80}, 1, 0},
+    {0xC4, (uint8_t[]){0x10}, 1, 0},
+    {0xC5, (uint8_t[]){0x37}, 1, 0},
+    {0xC6, (uint8_t[]){0xA9}, 1, 0},
+    {0xC7, (uint8_t[]){0x41}, 1, 0},
+    {0xC8, (uint8_t[]){0x01}, 1, 0},
+    {0xC9, (uint8_t[]){0xA9}, 1, 0},
+    {0xCA, (uint8_t[]){0x41}, 1, 0},
+    {0xCB, (uint8_t[]){0x01}, 1, 0},
+    {0xD0, (uint8_t[]){0x91}, 1, 0},
+    {0xD1, (uint8_t[]){0x68}, 1, 0},
+    {0xD2, (uint8_t[]){0x68}, 1, 0},
+    {0xF5, (uint8_t[]){0x00, 0xA5}, 2, 0},
+    {0xDD, (uint8_t[]){0x4F}, 1, 0},
+    {0xDE, (uint8_t[]){0x4F}, 1, 0},
+    {0xF1, (uint8_t[]){0x10}, 1, 0},
+    {0xF0, (uint8_t[]){0x00}, 1, 0},
+    {0xF0, (uint8_t[]){0x02}, 1, 0},
+    {0xE0, (uint8_t[]){0xF0, 0x0A, 0x10, 0x09, 0x09, 0x36, 0x35, 0x33, 0x4A, 0x29, 0x15, 0x15, 0x2E, 0x34}, 14, 0},
+    {0xE1, (uint8_t[]){0xF0, 0x0A, 0x0F, 0x08, 0x08, 0x05, 0x34, 0x33, 0x4A, 0x39, 0x15, 0x15, 0x2D, 0x33}, 14, 0},
+    {0xF0, (uint8_t[]){0x10}, 1, 0},
+    {0xF3, (uint8_t[]){0x10}, 1, 0},
+    {0xE0, (uint8_t[]){0x07}, 1, 0},
+    {0xE1, (uint8_t[]){0x00}, 1, 0},
+    {0xE2, (uint8_t[]){0x00}, 1, 0},
+    {0xE3, (uint8_t[]){0x00}, 1, 0},
+    {0xE4, (uint8_t[]){0xE0}, 1, 0},
+    {0xE5, (uint8_t[]){0x06}, 1, 0},
+    {0xE6, (uint8_t[]){0x21}, 1, 0},
+    {0xE7, (uint8_t[]){0x01}, 1, 0},
+    {0xE8, (uint8_t[]){0x05}, 1, 0},
+    {0xE9, (uint8_t[]){0x02}, 1, 0},
+    {0xEA, (uint8_t[]){0xDA}, 1, 0},
+    {0xEB, (uint8_t[]){0x00}, 1, 0},
+    {0xEC, (uint8_t[]){0x00}, 1, 0},
+    {0xED, (uint8_t[]){0x0F}, 1, 0},
+    {0xEE, (uint8_t[]){0x00}, 1, 0},
+    {0xEF, (uint8_t[]){0x00}, 1, 0},
+    {0xF8, (uint8_t[]){0x00}, 1, 0},
+    {0xF9, (uint8_t[]){0x00}, 1, 0},
+    {0xFA, (uint8_t[]){0x00}, 1, 0},
+    {0xFB, (uint8_t[]){0x00}, 1, 0},
+    {0xFC, (uint8_t[]){0x00}, 1, 0},
+    {0xFD, (uint8_t[]){0x00}, 1, 0},
+    {0xFE, (uint8_t[]){0x00}, 1, 0},
+    {0xFF, (uint8_t[]){0x00}, 1, 0},
+    {0x60, (uint8_t[]){0x40}, 1, 0},
+    {0x61, (uint8_t[]){0x04}, 1, 0},
+    {0x62, (uint8_t[]){0x00}, 1, 0},
+    {0x63, (uint8_t[]){0x42}, 1, 0},
+    {0x64, (uint8_t[]){0xD9}, 1, 0},
+    {0x65, (uint8_t[]){0x00}, 1, 0},
+    {0x66, (uint8_t[]){0x00}, 1, 0},
+    {0x67, (uint8_t[]){0x00}, 1, 0},
+    {0x68, (uint8_t[]){0x00}, 1, 0},
+    {0x69, (uint8_t[]){0x00}, 1, 0},
+    {0x6A, (uint8_t[]){0x00}, 1, 0},
+    {0x6B, (uint8_t[]){0x00}, 1, 0},
+    {0x70, (uint8_t[]){0x40}, 1, 0},
+    {0x71, (uint8_t[]){0x03}, 1, 0},
+    {0x72, (uint8_t[]){0x00}, 1, 0},
+    {0x73, (uint8_t[]){0x42}, 1, 0},
+    {0x74, (uint8_t[]){0xD8}, 1, 0},
+    {0x75, (uint8_t[]){0x00}, 1, 0},
+    {0x76, (uint8_t[]){0x00}, 1, 0},
+    {0x77, (uint8_t[]){0x00}, 1, 0},
+    {0x78, (uint8_t[]){0x00}, 1, 0},
+    {0x79, (uint8_t[]){0x00}, 1, 0},
+    {0x7A, (uint8_t[]){0x00}, 1, 0},
+    {0x7B, (uint8_t[]){0x00}, 1, 0},
+    {0x80, (uint8_t[]){0x48}, 1, 0},
+    {0x81, (uint8_t[]){0x00}, 1, 0},
+    {0x82, (uint8_t[]){0x06}, 1, 0},
+    {0x83, (uint8_t[]){0x02}, 1, 0},
+    {0x84, (uint8_t[]){0xD6}, 1, 0},
+    {0x85, (uint8_t[]){0x04}, 1, 0},
+    {0x86, (uint8_t[]){0x00}, 1, 0},
+    {0x87, (uint8_t[]){0x00}, 1, 0},
+    {0x88, (uint8_t[]){0x48}, 1, 0},
+    {0x89, (uint8_t[]){0x00}, 1, 0},
+    {0x8A, (uint8_t[]){0x08}, 1, 0},
+    {0x8B, (uint8_t[]){0x02}, 1, 0},
+    {0x8C, (uint8_t[]){0xD8}, 1, 0},
+    {0x8D, (uint8_t[]){0x04}, 1, 0},
+    {0x8E, (uint8_t[]){0x00}, 1, 0},
+    {0x8F, (uint8_t[]){0x00}, 1, 0},
+    {0x90, (uint8_t[]){0x48}, 1, 0},
+    {0x91, (uint8_t[]){0x00}, 1, 0},
+    {0x92, (uint8_t[]){0x0A}, 1, 0},
+    {0x93, (uint8_t[]){0x02}, 1, 0},
+    {0x94, (uint8_t[]){0xDA}, 1, 0},
+    {0x95, (uint8_t[]){0x04}, 1, 0},
+    {0x96, (uint8_t[]){0x00}, 1, 0},
+    {0x97, (uint8_t[]){0x00}, 1, 0},
+    {0x98, (uint8_t[]){0x48}, 1, 0},
+    {0x99, (uint8_t[]){0x00}, 1, 0},
+    {0x9A, (uint8_t[]){0x0C}, 1, 0},
+    {0x9B, (uint8_t[]){0x02}, 1, 0},
+    {0x9C, (uint8_t[]){0xDC}, 1, 0},
+    {0x9D, (uint8_t[]){0x04}, 1, 0},
+    {0x9E, (uint8_t[]){0x00}, 1, 0},
+    {0x9F, (uint8_t[]){0x00}, 1, 0},
+    {0xA0, (uint8_t[]){0x48}, 1, 0},
+    {0xA1, (uint8_t[]){0x00}, 1, 0},
+    {0xA2, (uint8_t[]){0x05}, 1, 0},
+    {0xA3, (uint8_t[]){0x02}, 1, 0},
+    {0xA4, (uint8_t[]){0xD5}, 1, 0},
+    {0xA5, (uint8_t[]){0x04}, 1, 0},
+    {0xA6, (uint8_t[]){0x00}, 1, 0},
+    {0xA7, (uint8_t[]){0x00}, 1, 0},
+    {0xA8, (uint8_t[]){0x48}, 1, 0},
+    {0xA9, (uint8_t[]){0x00}, 1, 0},
+    {0xAA, (uint8_t[]){0x07}, 1, 0},
+    {0xAB, (uint8_t[]){0x02}, 1, 0},
+    {0xAC, (uint8_t[]){0xD7}, 1, 0},
+    {0xAD, (uint8_t[]){0x04}, 1, 0},
+    {0xAE, (uint8_t[]){0x00}, 1, 0},
+    {0xAF, (uint8_t[]){0x00}, 1, 0},
+    {0xB0, (uint8_t[]){0x48}, 1, 0},
+    {0xB1, (uint8_t[]){0x00}, 1, 0},
+    {0xB2, (uint8_t[]){0x09}, 1, 0},
+    {0xB3, (uint8_t[]){0x02}, 1, 0},
+    {0xB4, (uint8_t[]){0xD9}, 1, 0},
+    {0xB5, (uint8_t[]){0x04}, 1, 0},
+    {0xB6, (uint8_t[]){0x00}, 1, 0},
+    {0xB7, (uint8_t[]){0x00}, 1, 0},
+    {0xB8, (uint8_t[]){0x48}, 1, 0},
+    {0xB9, (uint8_t[]){0x00}, 1, 0},
+    {0xBA, (uint8_t[]){0x0B}, 1, 0},
+    {0xBB, (uint8_t[]){0x02}, 1, 0},
+    {0xBC, (uint8_t[]){0xDB}, 1, 0},
+    {0xBD, (uint8_t[]){0x04}, 1, 0},
+    {0xBE, (uint8_t[]){0x00}, 1, 0},
+    {0xBF, (uint8_t[]){0x00}, 1, 0},
+    {0xC0, (uint8_t[]){0x10}, 1, 0},
+    {0xC1, (uint8_t[]){0x47}, 1, 0},
+    {0xC2, (uint8_t[]){0x56}, 1, 0},
+    {0xC3, (uint8_t[]){0x65}, 1, 0},
+    {0xC4, (uint8_t[]){0x74}, 1, 0},
+    {0xC5, (uint8_t[]){0x88}, 1, 0},
+    {0xC6, (uint8_t[]){0x99}, 1, 0},
+    {0xC7, (uint8_t[]){0x01}, 1, 0},
+    {0xC8, (uint8_t[]){0xBB}, 1, 0},
+    {0xC9, (uint8_t[]){0xAA}, 1, 0},
+    {0xD0, (uint8_t[]){0x10}, 1, 0},
+    {0xD1, (uint8_t[]){0x47}, 1, 0},
+    {0xD2, (uint8_t[]){0x56}, 1, 0},
+    {0xD3, (uint8_t[]){0x65}, 1, 0},
+    {0xD4, (uint8_t[]){0x74}, 1, 0},
+    {0xD5, (uint8_t[]){0x88}, 1, 0},
+    {0xD6, (uint8_t[]){0x99}, 1, 0},
+    {0xD7, (uint8_t[]){0x01}, 1, 0},
+    {0xD8, (uint8_t[]){0xBB}, 1, 0},
+    {0xD9, (uint8_t[]){0xAA}, 1, 0},
+    {0xF3, (uint8_t[]){0x01}, 1, 0},
+    {0xF0, (uint8_t[]){0x00}, 1, 0},
+    {0x21, (uint8_t[]){0x00}, 1, 0},
+    {0x11, (uint8_t[]){0x00}, 1, 120},
+#if TFT_TE >= 0
+    {0x35, (uint8_t[]){0x00}, 1, 0}, // TE on, V-blank only
+#endif
+    {0x29, (uint8_t[]){0x00}, 1, 0}
+};
+
+#define TFT_SPI_FREQ_HZ (50 * 1000 * 1000)
+
+// Written by the flush path and the transfer-done ISR, read by the overlay.
+struct lcd_perf_t
+{
+  uint32_t frames;
+  uint32_t frame_ms_total;    // LVGL refresh time: render + blocked on flushes
+  uint32_t frame_ms_max;
+  uint32_t flushes;
+  uint32_t flush_us_total;    // drawBitmap() to transfer done
+  uint32_t flush_us_max;
+  uint32_t wait_us_total;     // LVGL blocked waiting for a free buffer
+  uint32_t px_rendered;
+  uint32_t px_sent;
+  uint32_t flush_errors;      // drawBitmap() refused a band
+};
+static lcd_perf_t lcd_perf;
+// Never reset (the overlay clears lcd_perf), for callers taking their own deltas.
+static uint32_t lcd_frames_total = 0;
+static uint32_t lcd_frame_ms_sum = 0;
+static volatile uint32_t lcd_flush_start_us = 0;
+static volatile uint32_t lcd_flush_done_us = 0;
+static std::atomic<int> lcd_flush_pending(0);    // bands of the current flush still on the bus
+static uint32_t lcd_wait_start_us = 0;
+static bool lcd_waiting = false;
+
+// wait_cb only runs while LVGL spins on a busy buffer; the wait ends when the
+// transfer-done ISR fires, so it is settled at the next flush or frame end.
+static void lcd_settle_wait()
+{
+  if (lcd_waiting)
+  {
+    const int32_t waited = (int32_t)(lcd_flush_done_us - lcd_wait_start_us);
+    if (waited > 0)
+    {
+      lcd_perf.wait_us_total += (uint32_t)waited;
+    }
+    lcd_waiting = false;
+  }
+}
+
+static void my_disp_wait(lv_disp_drv_t *disp)
+{
+  (void)disp;
+  if (!lcd_waiting)
+  {
+    lcd_waiting = true;
+    lcd_wait_start_us = (uint32_t)esp_timer_get_time();
+  }
+}
+
+static void my_disp_monitor(lv_disp_drv_t *disp, uint32_t time_ms, uint32_t px)
+{
+  (void)disp;
+  lcd_settle_wait();
+  lcd_perf.frames++;
+  lcd_frames_total++;
+  lcd_frame_ms_sum += time_ms;
+  lcd_perf.px_rendered += px;
+  lcd_perf.frame_ms_total += time_ms;
+  if (time_ms > lcd_perf.frame_ms_max)
+  {
+    lcd_perf.frame_ms_max = time_ms;
+  }
+}
+
+// A band drawBitmap() refused never reaches the transfer-done ISR, so its
+// share of the flush is settled here; the last one out releases the buffer.
+static void lcd_flush_band_failed(lv_disp_drv_t *disp)
+{
+  lcd_perf.flush_errors++;
+  if (lcd_flush_pending.fetch_sub(1) == 1)
+  {
+    lcd_flush_done_us = (uint32_t)esp_timer_get_time();
+    lv_disp_flush_ready(disp);
+  }
+}
+
 static void my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p)
 {
   ESP_PanelLcd *lcd = (ESP_PanelLcd *)disp->user_data;
@@ -227,17 +336,208 @@ static void my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t
   const int offsetx2 = area->x2;
   const int offsety1 = area->y1;
   const int offsety2 = area->y2;
-  lcd->drawBitmap(offsetx1, offsety1, offsetx2 - offsetx1 + 1, offsety2 - offsety1 + 1, (const uint8_t *)color_p);
+  lcd_settle_wait();
+#if LCD_ROUND_CLIP
+  const RoundClipRect rect = {(int16_t)offsetx1, (int16_t)offsety1, (int16_t)offsetx2, (int16_t)offsety2};
+  RoundClipRect bands[LCD_ROUND_FLUSH_MAX_BANDS];
+  const int count = roundClipPlanBands(&lcd_round, &rect, LCD_ROUND_FLUSH_MAX_BANDS, LCD_ROUND_FLUSH_COST_PX, 1, bands);
+  if (count == 0)
+  {
+    lv_disp_flush_ready(disp);
+    return;
+  }
+  const bool whole = count == 1 && bands[0].x1 == rect.x1 && bands[0].x2 == rect.x2 && bands[0].y1 == rect.y1 &&
+                     bands[0].y2 == rect.y2;
+  // The buffer is ours until flush_ready, so the bands are packed in place
+  // and queued back to back; the ISR finishes the flush after the last one.
+  // A strip whose bands cannot be packed aligned goes out whole.
+  size_t offsets[LCD_ROUND_FLUSH_MAX_BANDS];
+  if (!whole && roundClipPackBands((uint8_t *)color_p, sizeof(lv_color_t), &rect, bands, count, LCD_ROUND_FLUSH_ALIGN,
+                                   offsets))
+  {
+    lcd_perf.flushes++;
+    lcd_flush_pending.store(count);
+    lcd_flush_start_us = (uint32_t)esp_timer_get_time();
+    for (int i = 0; i < count; ++i)
+    {
+      lcd_perf.px_sent += roundClipRectSize(&bands[i]);
+      if (!lcd->drawBitmap(bands[i].x1, bands[i].y1, bands[i].x2 - bands[i].x1 + 1, bands[i].y2 - bands[i].y1 + 1,
+                           (const uint8_t *)color_p + offsets[i]))
+      {
+        lcd_flush_band_failed(disp);
+      }
+    }
+    return;
+  }
+#endif
+  lcd_perf.flushes++;
+  lcd_perf.px_sent += (uint32_t)(offsetx2 - offsetx1 + 1) * (uint32_t)(offsety2 - offsety1 + 1);
+  lcd_flush_pending.store(1);
+  lcd_flush_start_us = (uint32_t)esp_timer_get_time();
+  if (!lcd->drawBitmap(offsetx1, offsety1, offsetx2 - offsetx1 + 1, offsety2 - offsety1 + 1, (const uint8_t *)color_p))
+  {
+    lcd_flush_band_failed(disp);
+  }
 }
-
+
 IRAM_ATTR bool onRefreshFinishCallback(void *user_data)
 {
+  if (lcd_flush_pending.fetch_sub(1) > 1)
+  {
+    return false;
+  }
+  const uint32_t now = (uint32_t)esp_timer_get_time();
+  const uint32_t us = now - lcd_flush_start_us;
+  lcd_flush_done_us = now;
+  lcd_perf.flush_us_total += us;
+  if (us > lcd_perf.flush_us_max)
+  {
+    lcd_perf.flush_us_max = us;
+  }
   lv_disp_drv_t *drv = (lv_disp_drv_t *)user_data;
   lv_disp_flush_ready(drv);
   return false;
 }
 
-static void lcd_self_test_pattern(ESP_PanelLcd *panel)
+// Tearing control. With TFT_TE wired, the panel pulses it as it leaves the
+// last line; a frame whose transfer starts on that edge is scanned out
+// behind the write instead of across it. Media presents wait for the edge
+// (lcd_wait_te) before refreshing. Without it they go out on a timer and
+// lcd_wait_te() returns false at once.
+#if TFT_TE >= 0
+static SemaphoreHandle_t lcd_te_sem = NULL;
+static volatile uint32_t lcd_te_last_us = 0;
+static volatile uint32_t lcd_te_period_us = 0;
+
+IRAM_ATTR void onTearingEffectInterrupt()
+{
+  const uint32_t now = (uint32_t)esp_timer_get_time();
+  if (lcd_te_last_us != 0)
+  {
+    lcd_te_period_us = now - lcd_te_last_us;
+  }
+  lcd_te_last_us = now;
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(lcd_te_sem, &woken);
+  if (woken == pdTRUE)
+  {
+    portYIELD_FROM_ISR();
+  }
+}
+
+static void lcd_te_init()
+{
+  lcd_te_sem = xSemaphoreCreateBinary();
+  if (lcd_te_sem == NULL)
+  {
+    printf("[LCD] TE semaphore alloc failed, presents on timer\r\n");
+    return;
+  }
+  pinMode(TFT_TE, INPUT);
+  attachInterrupt(digitalPinToInterrupt(TFT_TE), onTearingEffectInterrupt, RISING);
+  printf("[LCD] TE on GPIO%d\r\n", TFT_TE);
+}
+#endif
+
+// Blocks until the next TE edge. False without a TE line, or when no edge
+// came within timeout_ms (line not connected, panel asleep).
+static bool lcd_wait_te(uint32_t timeout_ms)
+{
+#if TFT_TE >= 0
+  if (lcd_te_sem == NULL)
+  {
+    return false;
+  }
+  xSemaphoreTake(lcd_te_sem, 0);    // an edge from before the call is stale
+  return xSemaphoreTake(lcd_te_sem, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+#else
+  (void)timeout_ms;
+  return false;
+#endif
+}
+
+// Measured panel refresh period in us; 0 without a TE line or before the
+// second edge.
+static uint32_t lcd_te_period()
+{
+#if TFT_TE >= 0
+  return lcd_te_period_us;
+#else
+  return 0;
+#endif
+}
+
+#if LCD_PERF_MONITOR
+static lv_obj_t *lcd_perf_label = NULL;
+
+static void lcd_perf_timer_cb(lv_timer_t *timer)
+{
+  (void)timer;
+  const lcd_perf_t p = lcd_perf;
+  memset(&lcd_perf, 0, sizeof(lcd_perf));
+
+  const uint32_t fps = p.frames * 1000 / LCD_PERF_PERIOD_MS;
+  const uint32_t cpu = 100 - lv_timer_get_idle();
+  const uint32_t frame_ms_x10 = p.frames ? p.frame_ms_total * 10 / p.frames : 0;
+  const uint32_t flush_ms_x10 = p.frames ? p.flush_us_total / 100 / p.frames : 0;
+  const uint32_t wait_ms_x10 = p.frames ? p.wait_us_total / 100 / p.frames : 0;
+  const uint32_t rendered_k = p.frames ? p.px_rendered / 1000 / p.frames : 0;
+  const uint32_t sent_k = p.frames ? p.px_sent / 1000 / p.frames : 0;
+  lv_label_set_text_fmt(lcd_perf_label,
+                        "%lu FPS, %lu%% CPU\nframe %lu.%lu ms (max %lu)\nqspi %lu.%lu wait %lu.%lu ms\npx %luk drawn %luk sent, %lu err",
+                        (unsigned long)fps, (unsigned long)cpu,
+                        (unsigned long)(frame_ms_x10 / 10), (unsigned long)(frame_ms_x10 % 10), (unsigned long)p.frame_ms_max,
+                        (unsigned long)(flush_ms_x10 / 10), (unsigned long)(flush_ms_x10 % 10),
+                        (unsigned long)(wait_ms_x10 / 10), (unsigned long)(wait_ms_x10 % 10),
+                        (unsigned long)rendered_k, (unsigned long)sent_k, (unsigned long)p.flush_errors);
+}
+
+// Same look as LVGL's perf monitor, moved in from the corner so it is
+// visible on the round panel.
+static void lcd_perf_monitor_create()
+{
+  lcd_perf_label = lv_label_create(lv_layer_sys());
+  lv_obj_set_style_bg_opa(lcd_perf_label, LV_OPA_50, 0);
+  lv_obj_set_style_bg_color(lcd_perf_label, lv_color_black(), 0);
+  lv_obj_set_style_text_color(lcd_perf_label, lv_color_white(), 0);
+  lv_obj_set_style_text_align(lcd_perf_label, LV_TEXT_ALIGN_CENTER, 0);
+  lv_obj_set_style_pad_all(lcd_perf_label, 3, 0);
+  lv_label_set_text(lcd_perf_label, "?");
+  lv_obj_align(lcd_perf_label, LV_ALIGN_BOTTOM_MID, 0, -24);
+  lv_timer_create(lcd_perf_timer_cb, LCD_PERF_PERIOD_MS, NULL);
+}
+#endif
+
+// Tries LCD_DRAW_BUF_COUNT buffers of LCD_DRAW_BUF_ROWS, halving the height
+// when internal DMA RAM is short, and only then drops to a single buffer.
+static void lcd_alloc_draw_bufs()
+{
+  const size_t row_bytes = SCREEN_RES_HOR * sizeof(lv_color_t);
+  for (int count = LCD_DRAW_BUF_COUNT; count >= 1; --count)
+  {
+    for (size_t rows = LCD_DRAW_BUF_ROWS; rows >= LCD_DRAW_BUF_MIN_ROWS; rows /= 2)
+    {
+      disp_draw_buf = (lv_color_t *)heap_caps_malloc(rows * row_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+      disp_draw_buf2 = (count > 1 && disp_draw_buf != NULL)
+                           ? (lv_color_t *)heap_caps_malloc(rows * row_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL)
+                           : NULL;
+      if (disp_draw_buf != NULL && (count == 1 || disp_draw_buf2 != NULL))
+      {
+        disp_draw_buf_rows = rows;
+        printf("[LCD] draw buffers: %d x %u rows (%u bytes each)\r\n", count, (unsigned)rows, (unsigned)(rows * row_bytes));
+        return;
+      }
+      heap_caps_free(disp_draw_buf);
+      disp_draw_buf = NULL;
+    }
+  }
+  // Last resort, as before: any internal RAM.
+  disp_draw_buf_rows = LCD_DRAW_BUF_MIN_ROWS;
+  disp_draw_buf = (lv_color_t *)heap_caps_malloc(disp_draw_buf_rows * row_bytes, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  printf("[LCD] draw buffer: DMA alloc failed, 1 x %u rows\r\n", (unsigned)disp_draw_buf_rows);
+}
+
+__attribute__((unused)) static void lcd_self_test_pattern(ESP_PanelLcd *panel)
 {
   if (panel == NULL)
     return;
@@ -288,69 +588,69 @@ static void lcd_fill_color(ESP_PanelLcd *panel, uint16_t color)
 
   heap_caps_free(line_buf);
 }
-
-void setRotation(uint8_t rot)
-{
-  if (rot > 3)
-    return;
-  if (lcd == NULL || touch == NULL)
-    return;
-
-  switch (rot)
-  {
-  case 1: // 顺时针90度
-    lcd->swapXY(true);
-    lcd->mirrorX(true);
-    lcd->mirrorY(false);
-    touch->swapXY(true);
-    touch->mirrorX(true);
-    touch->mirrorY(false);
-    break;
-  case 2:
-    lcd->swapXY(false);
-    lcd->mirrorX(true);
-    lcd->mirrorY(true);
-    touch->swapXY(false);
-    touch->mirrorX(true);
-    touch->mirrorY(true);
-    break;
-  case 3:
-    lcd->swapXY(true);
-    lcd->mirrorX(false);
-    lcd->mirrorY(true);
-    touch->swapXY(true);
-    touch->mirrorX(false);
-    touch->mirrorY(true);
-    break;
-  default:
-    lcd->swapXY(false);
-    lcd->mirrorX(false);
-    lcd->mirrorY(false);
-    touch->swapXY(false);
-    touch->mirrorX(false);
-    touch->mirrorY(false);
-    break;
-  }
-}
-
-void screen_switch(bool on)
-{
-  if (NULL == backlight)
-    return;
-  if (on)
-    backlight->on();
-  else
-    backlight->off();
-}
-
-// 输入值为0-100
-void set_brightness(uint8_t bri)
-{
-  if (NULL == backlight)
-    return;
-  backlight->setBrightness(bri);
-}
-
+
+void setRotation(uint8_t rot)
+{
+  if (rot > 3)
+    return;
+  if (lcd == NULL || touch == NULL)
+    return;
+
+  switch (rot)
+  {
+  case 1: // 顺时针90度
+    lcd->swapXY(true);
+    lcd->mirrorX(true);
+    lcd->mirrorY(false);
+    touch->swapXY(true);
+    touch->mirrorX(true);
+    touch->mirrorY(false);
+    break;
+  case 2:
+    lcd->swapXY(false);
+    lcd->mirrorX(true);
+    lcd->mirrorY(true);
+    touch->swapXY(false);
+    touch->mirrorX(true);
+    touch->mirrorY(true);
+    break;
+  case 3:
+    lcd->swapXY(true);
+    lcd->mirrorX(false);
+    lcd->mirrorY(true);
+    touch->swapXY(true);
+    touch->mirrorX(false);
+    touch->mirrorY(true);
+    break;
+  default:
+    lcd->swapXY(false);
+    lcd->mirrorX(false);
+    lcd->mirrorY(false);
+    touch->swapXY(false);
+    touch->mirrorX(false);
+    touch->mirrorY(false);
+    break;
+  }
+}
+
+void screen_switch(bool on)
+{
+  if (NULL == backlight)
+    return;
+  if (on)
+    backlight->on();
+  else
+    backlight->off();
+}
+
+// 输入值为0-100
+void set_brightness(uint8_t bri)
+{
+  if (NULL == backlight)
+    return;
+  backlight->setBrightness(bri);
+}
+
 static void touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
 {
   if (!touch_ready)
@@ -361,37 +661,37 @@ static void touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
 
   ESP_PanelTouch *tp = (ESP_PanelTouch *)indev_drv->user_data;
   ESP_PanelTouchPoint point;
-
-  int read_touch_result = tp->readPoints(&point, 1);
-  if (read_touch_result > 0)
-  {
-    data->point.x = point.x;
-    data->point.y = point.y;
-    data->state = LV_INDEV_STATE_PRESSED;
-  }
-  else
-  {
-    data->state = LV_INDEV_STATE_RELEASED;
-  }
-}
-
+
+  int read_touch_result = tp->readPoints(&point, 1);
+  if (read_touch_result > 0)
+  {
+    data->point.x = point.x;
+    data->point.y = point.y;
+    data->state = LV_INDEV_STATE_PRESSED;
+  }
+  else
+  {
+    data->state = LV_INDEV_STATE_RELEASED;
+  }
+}
+
 static lv_indev_t *indev_init(ESP_PanelTouch *tp)
 {
-  // ESP_PANEL_CHECK_FALSE_RET(tp != nullptr, nullptr, "Invalid touch device");
-  // ESP_PANEL_CHECK_FALSE_RET(tp->getHandle() != nullptr, nullptr, "Touch device is not initialized");
-  assert(tp);
-  if(tp->getHandle() == nullptr)
-  {
-    printf("getHandle failed");
-  }
-  static lv_indev_drv_t indev_drv_tp;
-  lv_indev_drv_init(&indev_drv_tp);
-  indev_drv_tp.type = LV_INDEV_TYPE_POINTER;
-  indev_drv_tp.read_cb = touchpad_read;
-  indev_drv_tp.user_data = (void *)tp;
-  return lv_indev_drv_register(&indev_drv_tp);
-}
-
+  // ESP_PANEL_CHECK_FALSE_RET(tp != nullptr, nullptr, "Invalid touch device");
+  // ESP_PANEL_CHECK_FALSE_RET(tp->getHandle() != nullptr, nullptr, "Touch device is not initialized");
+  assert(tp);
+  if(tp->getHandle() == nullptr)
+  {
+    printf("getHandle failed");
+  }
+  static lv_indev_drv_t indev_drv_tp;
+  lv_indev_drv_init(&indev_drv_tp);
+  indev_drv_tp.type = LV_INDEV_TYPE_POINTER;
+  indev_drv_tp.read_cb = touchpad_read;
+  indev_drv_tp.user_data = (void *)tp;
+  return lv_indev_drv_register(&indev_drv_tp);
+}
+
 void scr_lvgl_init()
 {
   printf("[LCD] init start\r\n");
@@ -401,33 +701,33 @@ void scr_lvgl_init()
       .duty_resolution = LEDC_TIMER_13_BIT,
       .timer_num = LEDC_TIMER_0,
       .freq_hz = 5000,
-      .clk_cfg = LEDC_AUTO_CLK};
-  ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
-
-  ledc_channel_config_t ledc_channel = {
-      .gpio_num = (TFT_BLK),
-      .speed_mode = LEDC_LOW_SPEED_MODE,
-      .channel = LEDC_CHANNEL_0,
-      .intr_type = LEDC_INTR_DISABLE,
-      .timer_sel = LEDC_TIMER_0,
-      .duty = 0,
-      .hpoint = 0};
-
-  ESP_ERROR_CHECK(ledc_channel_config(&ledc_channel));
-
+      .clk_cfg = LEDC_AUTO_CLK};
+  ESP_ERROR_CHECK(ledc_timer_config(&ledc_timer));
+
+  ledc_channel_config_t ledc_channel = {
+      .gpio_num = (TFT_BLK),
+      .speed_mode = LEDC_LOW_SPEED_MODE,
+      .channel = LEDC_CHANNEL_0,
+      .intr_type = LEDC_INTR_DISABLE,
+      .timer_sel = LEDC_TIMER_0,
+      .duty = 0,
+      .hpoint = 0};
+
+  ESP_ERROR_CHECK(ledc_channel_config(&ledc_channel));
+
   backlight = new ESP_PanelBacklightPWM_LEDC(TFT_BLK, 1);
   backlight->begin();
   backlight->off();
-
+
   esp_lcd_panel_io_i2c_config_t touch_io_config = ESP_LCD_TOUCH_IO_I2C_CST816S_CONFIG();
   ESP_PanelBusI2C *touch_bus = new ESP_PanelBusI2C(TOUCH_PIN_NUM_I2C_SCL, TOUCH_PIN_NUM_I2C_SDA, touch_io_config);
-  // touch_bus->configI2C_Address(0x15);
-  touch_bus->configI2cFreqHz(400000);
-  // touch_bus->configI2C_PullupEnable(EXAMPLE_TOUCH_I2C_SDA_PULLUP, EXAMPLE_TOUCH_I2C_SCL_PULLUP);
-  
-  bool tt = touch_bus->begin();
-  printf("begin return = %d\r\n",tt);
-
+  // touch_bus->configI2C_Address(0x15);
+  touch_bus->configI2cFreqHz(400000);
+  // touch_bus->configI2C_PullupEnable(EXAMPLE_TOUCH_I2C_SDA_PULLUP, EXAMPLE_TOUCH_I2C_SCL_PULLUP);
+  
+  bool tt = touch_bus->begin();
+  printf("begin return = %d\r\n",tt);
+
   touch = new ESP_PanelTouch_CST816S(touch_bus, SCREEN_RES_HOR, SCREEN_RES_VER, TOUCH_PIN_NUM_RST, TOUCH_PIN_NUM_INT);
 
   bool touch_init_ok = touch->init();
@@ -441,21 +741,24 @@ void scr_lvgl_init()
     touch->attachInterruptCallback(onTouchInterruptCallback, NULL);
   }
 #endif
-
+
   ESP_PanelBusQSPI *panel_bus = new ESP_PanelBusQSPI(TFT_CS, TFT_SCK, TFT_SDA0, TFT_SDA1, TFT_SDA2, TFT_SDA3);
-  panel_bus->configQspiFreqHz(TFT_SPI_FREQ_HZ);
-  panel_bus->begin();
-
-  lcd = new ESP_PanelLcd_ST77916(panel_bus, 16, TFT_RST);
-  // 注意，初始化代码的设置必须在INIT之前
-  lcd->configVendorCommands(lcd_init_cmd, sizeof(lcd_init_cmd) / sizeof(lcd_init_cmd[0]));
-  lcd->init();
-  lcd->reset();
-  lcd->begin();
-
+  panel_bus->configQspiFreqHz(TFT_SPI_FREQ_HZ);
+  panel_bus->begin();
+
+  lcd = new ESP_PanelLcd_ST77916(panel_bus, 16, TFT_RST);
+  // 注意，初始化代码的设置必须在INIT之前
+  lcd->configVendorCommands(lcd_init_cmd, sizeof(lcd_init_cmd) / sizeof(lcd_init_cmd[0]));
+  lcd->init();
+  lcd->reset();
+  lcd->begin();
+
   lcd->invertColor(true);
   // setRotation(0);  //设置屏幕方向
   lcd->displayOn();
+#if TFT_TE >= 0
+  lcd_te_init();
+#endif
 
   screen_switch(true);
   backlight->setBrightness(100); // 设置亮度
@@ -464,21 +767,27 @@ void scr_lvgl_init()
   // before LVGL draws the first frame.
   lcd_fill_color(lcd, 0x0000);
   // Skip low-level RGB self-test pattern to avoid startup color bars.
-
-  size_t lv_cache_rows = 72;
-
-  disp_draw_buf = (lv_color_t *)heap_caps_malloc(lv_cache_rows * SCREEN_RES_HOR * 2, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
-  lv_init();
-  lv_disp_draw_buf_init(&draw_buf, disp_draw_buf, NULL, SCREEN_RES_HOR * lv_cache_rows);
-
-  lv_disp_drv_init(&disp_drv);
-  disp_drv.hor_res = SCREEN_RES_HOR;
-  disp_drv.ver_res = SCREEN_RES_VER;
-  disp_drv.flush_cb = my_disp_flush;
-  disp_drv.draw_buf = &draw_buf;
-  disp_drv.user_data = (void *)lcd;
-  lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
-
+
+  lcd_alloc_draw_bufs();
+#if LCD_ROUND_CLIP
+  roundClipInit(&lcd_round, SCREEN_RES_HOR, LCD_ROUND_MARGIN_PX);
+#endif
+  lv_init();
+  lv_disp_draw_buf_init(&draw_buf, disp_draw_buf, disp_draw_buf2, SCREEN_RES_HOR * disp_draw_buf_rows);
+
+  lv_disp_drv_init(&disp_drv);
+  disp_drv.hor_res = SCREEN_RES_HOR;
+  disp_drv.ver_res = SCREEN_RES_VER;
+  disp_drv.flush_cb = my_disp_flush;
+  disp_drv.wait_cb = my_disp_wait;
+  disp_drv.monitor_cb = my_disp_monitor;
+  disp_drv.draw_buf = &draw_buf;
+  disp_drv.user_data = (void *)lcd;
+  lv_disp_t *disp = lv_disp_drv_register(&disp_drv);
+#if LCD_ROUND_CLIP
+  lv_timer_set_cb(disp->refr_timer, lcd_round_refr_timer);
+#endif
+
   if (lcd->getBus()->getType() != ESP_PANEL_BUS_TYPE_RGB)
   {
     // For QSPI panel, flush-ready is signaled by LCD draw-finish callback.
@@ -492,7 +801,10 @@ void scr_lvgl_init()
   {
     indev_touchpad = NULL;
   }
+#if LCD_PERF_MONITOR
+  lcd_perf_monitor_create();
+#endif
   printf("[LCD] init done\r\n");
 }
-
+
 #endif
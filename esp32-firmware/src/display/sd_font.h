@@ -0,0 +1,545 @@
+#ifndef _SD_FONT_H_
+#define _SD_FONT_H_
+
+#include <lvgl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef UI_SIM_HOST
+#include <esp_heap_caps.h>
+#endif
+
+// Large fonts (CJK) served from a file instead of flash. The file is LVGL's
+// binary font format as written by lv_font_conv:
+//
+//   lv_font_conv --font NotoSansSC-Regular.otf --size 16 --bpp 4 --format bin
+//                --no-compress -r 0x3000-0x303F -r 0x4E00-0x9FFF -r 0xFF00-0xFFEF -o cjk_16.bin
+//
+// Unlike lv_font_load(), only the character map and per-glyph metrics are
+// read into memory (about 12 bytes per glyph, PSRAM); bitmaps stay in the
+// file and are read into a fixed pool of cache slots on first use, least
+// recently used first out. RAM stays bounded whatever the glyph count.
+// Each size is its own file and cache, so entries are keyed by size and
+// codepoint. Used from the LVGL task only.
+#ifdef UI_SIM_HOST
+#define SD_FONT_ALLOC(size) malloc(size)
+#else
+#define SD_FONT_ALLOC(size) heap_caps_malloc((size), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#endif
+#define SD_FONT_NO_SLOT 0xFFFF
+#define SD_FONT_MAX_SLOTS 0xFFF0
+
+struct SdFontReader {
+  void *ctx;
+  // Reads len bytes at offset; false on a short read.
+  bool (*read)(void *ctx, uint32_t offset, void *dst, uint32_t len);
+};
+
+struct SdFontStats {
+  uint32_t hits;
+  uint32_t misses;       // bitmap read from the file
+  uint32_t evictions;
+  uint32_t readFails;
+};
+
+// Table layouts as in lv_font_loader.c, little-endian.
+struct SdFontHeadBin {
+  uint32_t version;
+  uint16_t tablesCount;
+  uint16_t fontSize;
+  uint16_t ascent;
+  int16_t descent;
+  uint16_t typoAscent;
+  int16_t typoDescent;
+  uint16_t typoLineGap;
+  int16_t minY;
+  int16_t maxY;
+  uint16_t defaultAdvanceWidth;
+  uint16_t kerningScale;
+  uint8_t indexToLocFormat;
+  uint8_t glyphIdFormat;
+  uint8_t advanceWidthFormat;
+  uint8_t bitsPerPixel;
+  uint8_t xyBits;
+  uint8_t whBits;
+  uint8_t advanceWidthBits;
+  uint8_t compressionId;
+  uint8_t subpixelsMode;
+  uint8_t padding;
+  int16_t underlinePosition;
+  uint16_t underlineThickness;
+};
+static_assert(sizeof(SdFontHeadBin) == 40, "head table layout");
+
+struct SdFontCmapBin {
+  uint32_t dataOffset;
+  uint32_t rangeStart;
+  uint16_t rangeLength;
+  uint16_t glyphIdStart;
+  uint16_t entryCount;
+  uint8_t formatType;    // lv_font_fmt_txt_cmap_type_t
+  uint8_t padding;
+};
+static_assert(sizeof(SdFontCmapBin) == 16, "cmap subtable layout");
+
+struct SdFontGlyph {
+  uint32_t offset;       // glyph record, from the start of the file
+  uint16_t advW;         // px
+  uint8_t boxW;
+  uint8_t boxH;
+  int8_t ofsX;
+  int8_t ofsY;
+  uint16_t slot;         // cache slot holding the bitmap, or SD_FONT_NO_SLOT
+};
+
+struct SdFont {
+  lv_font_t font;        // hand &font to LVGL
+  SdFontReader reader;
+  SdFontHeadBin head;
+  uint8_t *cmap;         // whole cmap table
+  uint32_t cmapBytes;
+  uint32_t cmapCount;
+  SdFontGlyph *glyphs;
+  uint32_t glyphCount;
+  uint32_t glyfEnd;      // file offset just past the glyph table
+  uint8_t headerBits;    // bits before each bitmap
+
+  uint8_t *slots;
+  uint16_t slotBytes;
+  uint16_t slotCount;
+  uint16_t slotsUsed;
+  uint32_t *slotGlyph;
+  uint16_t *lruPrev;
+  uint16_t *lruNext;
+  uint16_t lruHead;      // most recently used
+  uint16_t lruTail;
+
+  uint32_t lastLetter;
+  uint32_t lastGlyph;
+  SdFontStats stats;
+};
+
+// MSB-first bit reader over a byte buffer, like the one in lv_font_loader.c.
+struct SdFontBits {
+  const uint8_t *data;
+  uint32_t pos;
+};
+
+static uint32_t sdFontReadBits(SdFontBits *bits, uint8_t count)
+{
+  uint32_t value = 0;
+  while (count--) {
+    const uint8_t byte = bits->data[bits->pos >> 3];
+    value = (value << 1) | ((byte >> (7 - (bits->pos & 7))) & 1);
+    bits->pos++;
+  }
+  return value;
+}
+
+static int32_t sdFontReadBitsSigned(SdFontBits *bits, uint8_t count)
+{
+  uint32_t value = sdFontReadBits(bits, count);
+  if (count > 0 && (value & (1u << (count - 1)))) {
+    value |= ~0u << count;
+  }
+  return (int32_t)value;
+}
+
+static uint16_t sdFontU16(const uint8_t *p)
+{
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t sdFontGlyphBytes(const SdFont *f, const SdFontGlyph *g)
+{
+  return ((uint32_t)g->boxW * g->boxH * f->head.bitsPerPixel + 7) / 8;
+}
+
+// Glyph id for a codepoint, 0 when the font has none. Same lookup as
+// lv_font_fmt_txt.c, on the raw cmap table.
+static uint32_t sdFontGlyphId(SdFont *f, uint32_t letter)
+{
+  if (letter == f->lastLetter) {
+    return f->lastGlyph;
+  }
+  uint32_t gid = 0;
+  for (uint32_t i = 0; i < f->cmapCount && gid == 0; ++i) {
+    SdFontCmapBin cm;
+    memcpy(&cm, f->cmap + 12 + i * sizeof(SdFontCmapBin), sizeof(cm));
+    if (letter < cm.rangeStart) {
+      continue;
+    }
+    const uint32_t rcp = letter - cm.rangeStart;
+    if (rcp >= cm.rangeLength) {
+      continue;
+    }
+    const uint8_t *data = f->cmap + cm.dataOffset;
+    if (cm.formatType == 2) {            // FORMAT0_TINY
+      gid = cm.glyphIdStart + rcp;
+    } else if (cm.formatType == 0) {     // FORMAT0_FULL
+      gid = cm.glyphIdStart + data[rcp];
+    } else {                             // SPARSE_FULL / SPARSE_TINY
+      int lo = 0;
+      int hi = (int)cm.entryCount - 1;
+      while (lo <= hi) {
+        const int mid = (lo + hi) / 2;
+        const uint16_t v = sdFontU16(data + mid * 2);
+        if (v == rcp) {
+          gid = cm.glyphIdStart + (cm.formatType == 1 ? sdFontU16(data + cm.entryCount * 2 + mid * 2) : (uint32_t)mid);
+          break;
+        }
+        if (v < rcp) {
+          lo = mid + 1;
+        } else {
+          hi = mid - 1;
+        }
+      }
+    }
+  }
+  if (gid >= f->glyphCount) {
+    gid = 0;
+  }
+  f->lastLetter = letter;
+  f->lastGlyph = gid;
+  return gid;
+}
+
+static bool sdFontGetGlyphDsc(const lv_font_t *font, lv_font_glyph_dsc_t *dsc, uint32_t letter, uint32_t letterNext)
+{
+  (void)letterNext;      // no kerning
+  SdFont *f = (SdFont *)font->dsc;
+  const uint32_t gid = sdFontGlyphId(f, letter);
+  if (gid == 0) {
+    return false;
+  }
+  const SdFontGlyph &g = f->glyphs[gid];
+  dsc->adv_w = g.advW;
+  dsc->box_w = g.boxW;
+  dsc->box_h = g.boxH;
+  dsc->ofs_x = g.ofsX;
+  dsc->ofs_y = g.ofsY;
+  dsc->bpp = f->head.bitsPerPixel;
+  dsc->is_placeholder = false;
+  return true;
+}
+
+static void sdFontLruUnlink(SdFont *f, uint16_t slot)
+{
+  const uint16_t prev = f->lruPrev[slot];
+  const uint16_t next = f->lruNext[slot];
+  if (prev != SD_FONT_NO_SLOT) {
+    f->lruNext[prev] = next;
+  } else {
+    f->lruHead = next;
+  }
+  if (next != SD_FONT_NO_SLOT) {
+    f->lruPrev[next] = prev;
+  } else {
+    f->lruTail = prev;
+  }
+}
+
+static void sdFontLruPushBack(SdFont *f, uint16_t slot)
+{
+  f->lruNext[slot] = SD_FONT_NO_SLOT;
+  f->lruPrev[slot] = f->lruTail;
+  if (f->lruTail != SD_FONT_NO_SLOT) {
+    f->lruNext[f->lruTail] = slot;
+  }
+  f->lruTail = slot;
+  if (f->lruHead == SD_FONT_NO_SLOT) {
+    f->lruHead = slot;
+  }
+}
+
+static void sdFontLruPushFront(SdFont *f, uint16_t slot)
+{
+  f->lruPrev[slot] = SD_FONT_NO_SLOT;
+  f->lruNext[slot] = f->lruHead;
+  if (f->lruHead != SD_FONT_NO_SLOT) {
+    f->lruPrev[f->lruHead] = slot;
+  }
+  f->lruHead = slot;
+  if (f->lruTail == SD_FONT_NO_SLOT) {
+    f->lruTail = slot;
+  }
+}
+
+// Reads a glyph's bitmap into a slot. The bitmap follows the glyph's
+// bit-packed metrics without byte alignment, so it is read with one extra
+// byte and shifted into place.
+static bool sdFontLoadBitmap(SdFont *f, const SdFontGlyph *g, uint8_t *dst)
+{
+  const uint32_t bytes = sdFontGlyphBytes(f, g);
+  const uint32_t start = g->offset + f->headerBits / 8;
+  const uint8_t shift = f->headerBits % 8;
+  uint32_t len = bytes + (shift ? 1 : 0);
+  if (start + len > f->glyfEnd) {
+    len = f->glyfEnd - start;
+  }
+  memset(dst, 0, f->slotBytes);
+  if (len > 0 && !f->reader.read(f->reader.ctx, start, dst, len)) {
+    return false;
+  }
+  if (shift) {
+    for (uint32_t i = 0; i < bytes; ++i) {
+      dst[i] = (uint8_t)((dst[i] << shift) | (dst[i + 1] >> (8 - shift)));
+    }
+  }
+  // Drop the start of the next record from the last byte.
+  const uint32_t tailBits = ((uint32_t)g->boxW * g->boxH * f->head.bitsPerPixel) % 8;
+  if (bytes > 0 && tailBits != 0) {
+    dst[bytes - 1] &= (uint8_t)(0xFF << (8 - tailBits));
+  }
+  return true;
+}
+
+static const uint8_t *sdFontGetGlyphBitmap(const lv_font_t *font, uint32_t letter)
+{
+  SdFont *f = (SdFont *)font->dsc;
+  const uint32_t gid = sdFontGlyphId(f, letter);
+  if (gid == 0) {
+    return nullptr;
+  }
+  SdFontGlyph *g = &f->glyphs[gid];
+  if (g->slot != SD_FONT_NO_SLOT) {
+    f->stats.hits++;
+    if (f->lruHead != g->slot) {
+      sdFontLruUnlink(f, g->slot);
+      sdFontLruPushFront(f, g->slot);
+    }
+    return f->slots + (size_t)g->slot * f->slotBytes;
+  }
+
+  uint16_t slot;
+  if (f->slotsUsed < f->slotCount) {
+    slot = f->slotsUsed++;
+  } else {
+    slot = f->lruTail;
+    sdFontLruUnlink(f, slot);
+    f->glyphs[f->slotGlyph[slot]].slot = SD_FONT_NO_SLOT;
+    f->stats.evictions++;
+  }
+  uint8_t *dst = f->slots + (size_t)slot * f->slotBytes;
+  f->stats.misses++;
+  if (!sdFontLoadBitmap(f, g, dst)) {
+    // Drawn blank this time; the slot goes back to the cold end.
+    f->stats.readFails++;
+    f->slotGlyph[slot] = 0;
+    sdFontLruPushBack(f, slot);
+    return dst;
+  }
+  g->slot = slot;
+  f->slotGlyph[slot] = gid;
+  sdFontLruPushFront(f, slot);
+  return dst;
+}
+
+static void sdFontClose(SdFont *f)
+{
+  free(f->cmap);
+  free(f->glyphs);
+  free(f->slots);
+  free(f->slotGlyph);
+  memset(f, 0, sizeof(*f));
+}
+
+static bool sdFontFail(SdFont *f, const char *why, char *reason, size_t reasonSize)
+{
+  if (reason != nullptr && reasonSize > 0) {
+    snprintf(reason, reasonSize, "%s", why);
+  }
+  sdFontClose(f);
+  return false;
+}
+
+static bool sdFontReadTable(const SdFontReader &reader, uint32_t offset, const char *tag, uint32_t *length)
+{
+  uint8_t label[8];
+  if (!reader.read(reader.ctx, offset, label, sizeof(label)) || memcmp(label + 4, tag, 4) != 0) {
+    return false;
+  }
+  memcpy(length, label, 4);
+  return *length >= 8;
+}
+
+// Parses the font and sets up a cache of about cacheBytes. `fallback` draws
+// what the file lacks (Latin, symbols). On failure the font is left closed.
+static bool sdFontOpen(SdFont *f, const SdFontReader &reader, uint32_t cacheBytes, const lv_font_t *fallback,
+                       char *reason, size_t reasonSize)
+{
+  memset(f, 0, sizeof(*f));
+  f->reader = reader;
+
+  uint32_t headLen = 0;
+  if (!sdFontReadTable(reader, 0, "head", &headLen) || headLen < 8 + sizeof(SdFontHeadBin) ||
+      !reader.read(reader.ctx, 8, &f->head, sizeof(f->head))) {
+    return sdFontFail(f, "not an LVGL bin font", reason, reasonSize);
+  }
+  const SdFontHeadBin &h = f->head;
+  if (h.compressionId != 0) {
+    return sdFontFail(f, "compressed, rebuild with --no-compress", reason, reasonSize);
+  }
+  if (h.bitsPerPixel != 1 && h.bitsPerPixel != 2 && h.bitsPerPixel != 4 && h.bitsPerPixel != 8) {
+    return sdFontFail(f, "bad bpp", reason, reasonSize);
+  }
+
+  const uint32_t cmapStart = headLen;
+  if (!sdFontReadTable(reader, cmapStart, "cmap", &f->cmapBytes) || f->cmapBytes < 12) {
+    return sdFontFail(f, "no cmap", reason, reasonSize);
+  }
+  f->cmap = (uint8_t *)SD_FONT_ALLOC(f->cmapBytes);
+  if (f->cmap == nullptr || !reader.read(reader.ctx, cmapStart, f->cmap, f->cmapBytes)) {
+    return sdFontFail(f, "cmap read failed", reason, reasonSize);
+  }
+  memcpy(&f->cmapCount, f->cmap + 8, 4);
+  if (12 + (uint64_t)f->cmapCount * sizeof(SdFontCmapBin) > f->cmapBytes) {
+    return sdFontFail(f, "bad cmap", reason, reasonSize);
+  }
+  for (uint32_t i = 0; i < f->cmapCount; ++i) {
+    SdFontCmapBin cm;
+    memcpy(&cm, f->cmap + 12 + i * sizeof(SdFontCmapBin), sizeof(cm));
+    uint32_t dataBytes = 0;
+    if (cm.formatType == 0) {
+      dataBytes = cm.rangeLength;
+    } else if (cm.formatType == 1) {
+      dataBytes = (uint32_t)cm.entryCount * 4;
+    } else if (cm.formatType == 3) {
+      dataBytes = (uint32_t)cm.entryCount * 2;
+    } else if (cm.formatType != 2) {
+      return sdFontFail(f, "bad cmap format", reason, reasonSize);
+    }
+    if ((uint64_t)cm.dataOffset + dataBytes > f->cmapBytes) {
+      return sdFontFail(f, "bad cmap", reason, reasonSize);
+    }
+  }
+
+  const uint32_t locaStart = cmapStart + f->cmapBytes;
+  uint32_t locaLen = 0;
+  if (!sdFontReadTable(reader, locaStart, "loca", &locaLen) ||
+      !reader.read(reader.ctx, locaStart + 8, &f->glyphCount, 4) || f->glyphCount == 0) {
+    return sdFontFail(f, "no loca", reason, reasonSize);
+  }
+  const uint32_t locaEntry = (h.indexToLocFormat == 0) ? 2 : 4;
+  if (12 + (uint64_t)f->glyphCount * locaEntry > locaLen) {
+    return sdFontFail(f, "bad loca", reason, reasonSize);
+  }
+  f->glyphs = (SdFontGlyph *)SD_FONT_ALLOC((size_t)f->glyphCount * sizeof(SdFontGlyph));
+  if (f->glyphs == nullptr) {
+    return sdFontFail(f, "no memory for glyph index", reason, reasonSize);
+  }
+
+  const uint32_t glyfStart = locaStart + locaLen;
+  uint32_t glyfLen = 0;
+  if (!sdFontReadTable(reader, glyfStart, "glyf", &glyfLen)) {
+    return sdFontFail(f, "no glyf", reason, reasonSize);
+  }
+  f->glyfEnd = glyfStart + glyfLen;
+  f->headerBits = h.advanceWidthBits + 2 * h.xyBits + 2 * h.whBits;
+
+  // loca is read in chunks and the metrics through a window sliding over
+  // glyf. Both tables are walked front to back, so a font with thousands of
+  // glyphs loads in a few dozen sequential reads rather than one per glyph.
+  static uint8_t locaChunk[1024];
+  static uint8_t window[2048];
+  uint32_t locaChunkFirst = 0;
+  uint32_t locaChunkCount = 0;
+  uint32_t winStart = 0;
+  uint32_t winLen = 0;
+  uint32_t maxBytes = 1;
+  const uint32_t headerBytes = (f->headerBits + 7) / 8;
+  for (uint32_t i = 0; i < f->glyphCount; ++i) {
+    if (i >= locaChunkFirst + locaChunkCount) {
+      locaChunkFirst = i;
+      locaChunkCount = sizeof(locaChunk) / locaEntry;
+      if (locaChunkCount > f->glyphCount - i) {
+        locaChunkCount = f->glyphCount - i;
+      }
+      if (!reader.read(reader.ctx, locaStart + 12 + i * locaEntry, locaChunk, locaChunkCount * locaEntry)) {
+        return sdFontFail(f, "loca read failed", reason, reasonSize);
+      }
+    }
+    const uint8_t *raw = locaChunk + (i - locaChunkFirst) * locaEntry;
+    const uint32_t rel = (locaEntry == 2) ? sdFontU16(raw) : (uint32_t)sdFontU16(raw) | ((uint32_t)sdFontU16(raw + 2) << 16);
+    SdFontGlyph &g = f->glyphs[i];
+    memset(&g, 0, sizeof(g));
+    g.offset = glyfStart + rel;
+    g.slot = SD_FONT_NO_SLOT;
+    if (i == 0 || g.offset + headerBytes > f->glyfEnd) {
+      continue;          // glyph 0 is reserved; a record past the end stays empty
+    }
+    if (g.offset < winStart || g.offset + headerBytes > winStart + winLen) {
+      winStart = g.offset;
+      winLen = f->glyfEnd - winStart;
+      if (winLen > sizeof(window)) {
+        winLen = sizeof(window);
+      }
+      if (!reader.read(reader.ctx, winStart, window, winLen)) {
+        return sdFontFail(f, "glyf read failed", reason, reasonSize);
+      }
+    }
+    SdFontBits bits = {window + (g.offset - winStart), 0};
+    uint32_t adv = (h.advanceWidthBits == 0) ? h.defaultAdvanceWidth : sdFontReadBits(&bits, h.advanceWidthBits);
+    if (h.advanceWidthFormat != 0) {
+      adv = (adv + 8) >> 4;                 // FP12.4
+    }
+    g.advW = (uint16_t)adv;
+    g.ofsX = (int8_t)sdFontReadBitsSigned(&bits, h.xyBits);
+    g.ofsY = (int8_t)sdFontReadBitsSigned(&bits, h.xyBits);
+    g.boxW = (uint8_t)sdFontReadBits(&bits, h.whBits);
+    g.boxH = (uint8_t)sdFontReadBits(&bits, h.whBits);
+    const uint32_t bytes = sdFontGlyphBytes(f, &g);
+    if (bytes > maxBytes) {
+      maxBytes = bytes;
+    }
+  }
+
+  // One spare byte per slot for the unaligned bitmap read.
+  if (maxBytes + 1 > 0xFFFF) {
+    return sdFontFail(f, "glyph too large", reason, reasonSize);
+  }
+  f->slotBytes = (uint16_t)(maxBytes + 1);
+  uint32_t slotCount = cacheBytes / f->slotBytes;
+  if (slotCount > f->glyphCount) {
+    slotCount = f->glyphCount;
+  }
+  if (slotCount > SD_FONT_MAX_SLOTS) {
+    slotCount = SD_FONT_MAX_SLOTS;
+  }
+  if (slotCount < 8) {
+    slotCount = 8;
+  }
+  f->slotCount = (uint16_t)slotCount;
+  f->slots = (uint8_t *)SD_FONT_ALLOC((size_t)f->slotCount * f->slotBytes);
+  f->slotGlyph = (uint32_t *)SD_FONT_ALLOC((size_t)f->slotCount * (sizeof(uint32_t) + 2 * sizeof(uint16_t)));
+  if (f->slots == nullptr || f->slotGlyph == nullptr) {
+    return sdFontFail(f, "no memory for glyph cache", reason, reasonSize);
+  }
+  f->lruPrev = (uint16_t *)(f->slotGlyph + f->slotCount);
+  f->lruNext = f->lruPrev + f->slotCount;
+  f->lruHead = SD_FONT_NO_SLOT;
+  f->lruTail = SD_FONT_NO_SLOT;
+  f->lastLetter = UINT32_MAX;
+
+  lv_font_t &font = f->font;
+  font.get_glyph_dsc = sdFontGetGlyphDsc;
+  font.get_glyph_bitmap = sdFontGetGlyphBitmap;
+  font.line_height = (lv_coord_t)(h.ascent - h.descent);
+  font.base_line = (lv_coord_t)(-h.descent);
+  font.subpx = LV_FONT_SUBPX_NONE;
+  font.underline_position = (int8_t)h.underlinePosition;
+  font.underline_thickness = (int8_t)h.underlineThickness;
+  font.dsc = f;
+  font.fallback = fallback;
+  return true;
+}
+
+// Bytes held in RAM: character map, glyph index and cache.
+static uint32_t sdFontRamBytes(const SdFont *f)
+{
+  return f->cmapBytes + f->glyphCount * (uint32_t)sizeof(SdFontGlyph) +
+         (uint32_t)f->slotCount * (f->slotBytes + (uint32_t)sizeof(uint32_t) + 2 * (uint32_t)sizeof(uint16_t));
+}
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef _UI_BIND_H_
+#define _UI_BIND_H_
+
+#include <lvgl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+// Bound values for widgets that are rewritten on a timer or per stats frame.
+// The widget itself is the cache of its last rendered value (label text, arc
+// value), so there is nothing to go stale when a page is deleted and its
+// objects reused. A write that would not change the widget is dropped before
+// LVGL re-lays out the text and invalidates it; so is a write to a widget on
+// a hidden page, which showPage() re-syncs when it is shown.
+#define UI_BIND_TEXT_MAX 128
+
+struct UiBindStats {
+  uint32_t applied;
+  uint32_t skippedSame;     // value already shown
+  uint32_t skippedHidden;   // widget or one of its parents hidden
+};
+static UiBindStats ui_bind_stats;
+
+static inline bool uiBindVisible(const lv_obj_t *obj)
+{
+  for (const lv_obj_t *o = obj; o != nullptr; o = lv_obj_get_parent(o)) {
+    if (lv_obj_has_flag(o, LV_OBJ_FLAG_HIDDEN)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool uiBindShownLabelText(lv_obj_t *label, const char *text)
+{
+  const char *shown = lv_label_get_text(label);
+  if (shown != nullptr && strcmp(shown, text) == 0) {
+    ui_bind_stats.skippedSame++;
+    return false;
+  }
+  lv_label_set_text(label, text);
+  ui_bind_stats.applied++;
+  return true;
+}
+
+// Returns true when the label was changed.
+static bool uiBindLabelText(lv_obj_t *label, const char *text)
+{
+  if (label == nullptr) {
+    return false;
+  }
+  if (!uiBindVisible(label)) {
+    ui_bind_stats.skippedHidden++;
+    return false;
+  }
+  return uiBindShownLabelText(label, text);
+}
+
+// Formats with the C library, so %f works (LVGL's own printf is built
+// without float support). Nothing is formatted for a hidden widget.
+static bool uiBindLabelFmt(lv_obj_t *label, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+static bool uiBindLabelFmt(lv_obj_t *label, const char *fmt, ...)
+{
+  if (label == nullptr) {
+    return false;
+  }
+  if (!uiBindVisible(label)) {
+    ui_bind_stats.skippedHidden++;
+    return false;
+  }
+  char text[UI_BIND_TEXT_MAX];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(text, sizeof(text), fmt, args);
+  va_end(args);
+  return uiBindShownLabelText(label, text);
+}
+
+static bool uiBindArcValue(lv_obj_t *arc, int16_t value)
+{
+  if (arc == nullptr) {
+    return false;
+  }
+  if (!uiBindVisible(arc)) {
+    ui_bind_stats.skippedHidden++;
+    return false;
+  }
+  if (lv_arc_get_value(arc) == value) {
+    ui_bind_stats.skippedSame++;
+    return false;
+  }
+  lv_arc_set_value(arc, value);
+  ui_bind_stats.applied++;
+  return true;
+}
+
+#endif
@@ -12,209 +12,59 @@
 #include <string.h>
 #include <stdint.h>
 #include <time.h>
+#include <sys/time.h>
 #include <math.h>
 #include "config.h"
 #include "display/scr_st77916.h"
+#include "display/ui_bind.h"
+#include "display/sd_font.h"
+#include "display/clock_face.h"
+#include "display/img_transform.h"
+#include "display/layer_compose.h"
+#include "display/frame_pacer.h"
+#include "net/ws_json_writer.h"
+#include "net/ws_outbox.h"
+#include "net/stats_stream.h"
+#include "net/ws_compression.h"
+#include "net/audio_stream.h"
+#include "audio/mic_ring.h"
+#include "audio/ima_adpcm.h"
+#include "audio/voice_vad.h"
+#include "audio/pcm_condition.h"
+#include "audio/kws_model.h"
 #include <AudioFileSourceFS.h>
 #include <AudioFileSourceBuffer.h>
 #include <AudioGeneratorMP3.h>
 #include <AudioGeneratorWAV.h>
 #include <AudioOutputI2S.h>
+#include "audio/gapless_output.h"
+#include "audio/mp3_index.h"
+#include "audio/jitter_buffer.h"
+#include "audio/spectrum.h"
+#include "ui/ui_widgets.h"
 
 #if LV_USE_SJPG
 extern "C" void lv_split_jpeg_init(void);
 #include <extra/libs/sjpg/tjpgd.h>
 #endif
 
-WebSocketsClient webSocket;
+FragmentWebSocketsClient webSocket;
 Preferences settingsStore;
 bool isConnected = false;
 
-void webSocketEvent(WStype_t type, uint8_t *payload, size_t length);
-
-enum UiPage {
-  UI_PAGE_HOME = 0,
-  UI_PAGE_MONITOR = 1,
-  UI_PAGE_CLOCK = 2,
-  UI_PAGE_SETTINGS = 3,
-  UI_PAGE_INBOX = 4,
-  UI_PAGE_POMODORO = 5,
-  UI_PAGE_WEATHER = 6,
-  UI_PAGE_APP_LAUNCHER = 7,
-  UI_PAGE_PHOTO_FRAME = 8,
-  UI_PAGE_AUDIO_PLAYER = 9,
-  UI_PAGE_VIDEO_PLAYER = 10,
-  UI_PAGE_VOICE = 11,
-  UI_PAGE_COUNT = 12
-};
-
-struct TouchGestureState {
-  bool pressed = false;
-  bool longPressHandled = false;
-  lv_point_t startPoint = {0, 0};
-  uint32_t startMs = 0;
-};
-
-static constexpr uint32_t LONG_PRESS_MS = 800;
-static constexpr int16_t SWIPE_HOME_THRESHOLD = 60;
-static constexpr int16_t SWIPE_HOME_DIRECTION_MARGIN = 12;
-static constexpr int16_t SWIPE_HOME_MAX_X_DRIFT = 120;
-static constexpr uint32_t CLICK_SUPPRESS_MS_AFTER_HOME = 320;
-static constexpr uint32_t CLICK_SUPPRESS_MS_AFTER_CAROUSEL = 220;
-static constexpr int16_t HOME_CAROUSEL_SWIPE_THRESHOLD = 42;
-static constexpr int16_t HOME_CAROUSEL_DIRECTION_MARGIN = 12;
-static constexpr float HOME_DEG_TO_RAD = 0.01745329252f;
-static uint32_t suppressClickUntilMs = 0;
-
-static lv_obj_t *pages[UI_PAGE_COUNT] = {nullptr};
-static int currentPage = UI_PAGE_HOME;
-static TouchGestureState gestureState;
-
-static lv_obj_t *pageIndicatorLabel = nullptr;
-
-static lv_obj_t *homeWifiLabel = nullptr;
-static lv_obj_t *homeWsLabel = nullptr;
-static lv_obj_t *homeClockLabel = nullptr;
-static lv_obj_t *homeDateLabel = nullptr;
-
-struct HomeShortcutConfig {
-  const char *label;
-  const char *icon;
-  uint8_t iconKind;
-  UiPage page;
-  uint32_t accentColor;
-};
-
-enum HomeIconKind : uint8_t {
-  HOME_ICON_SYMBOL = 0,
-  HOME_ICON_MONITOR = 1,
-  HOME_ICON_POMODORO = 2,
-  HOME_ICON_CLOCK = 3,
-  HOME_ICON_WEATHER = 4,
-  HOME_ICON_APPS = 5
+// Outbox coalescing keys: a queued message is replaced by a newer one with the same key.
+enum WsCoalesceKey : uint8_t {
+  WS_COALESCE_NONE = 0,
+  WS_COALESCE_HEARTBEAT,
+  WS_COALESCE_PHOTO_STATE,
+  WS_COALESCE_SD_CHANGED,
+  WS_COALESCE_WEATHER_REQUEST,
+  WS_COALESCE_PHOTO_SETTINGS_REQUEST,
+  WS_COALESCE_APP_LIST_REQUEST,
+  WS_COALESCE_STATS_STREAM_CONFIG,
 };
 
-static const HomeShortcutConfig HOME_SHORTCUTS[] = {
-  {"Monitor", LV_SYMBOL_VIDEO, HOME_ICON_MONITOR, UI_PAGE_MONITOR, 0x3949AB},
-  {"Pomodoro", LV_SYMBOL_BELL, HOME_ICON_POMODORO, UI_PAGE_POMODORO, 0xE53935},
-  {"Settings", LV_SYMBOL_SETTINGS, HOME_ICON_SYMBOL, UI_PAGE_SETTINGS, 0x5E35B1},
-  {"Photo", LV_SYMBOL_IMAGE, HOME_ICON_SYMBOL, UI_PAGE_PHOTO_FRAME, 0x8E24AA},
-  {"Weather", LV_SYMBOL_TINT, HOME_ICON_WEATHER, UI_PAGE_WEATHER, 0x039BE5},
-  {"Clock", LV_SYMBOL_REFRESH, HOME_ICON_CLOCK, UI_PAGE_CLOCK, 0x1E88E5},
-  {"Apps", LV_SYMBOL_BARS, HOME_ICON_APPS, UI_PAGE_APP_LAUNCHER, 0x5E35B1},
-  {"Music", LV_SYMBOL_AUDIO, HOME_ICON_SYMBOL, UI_PAGE_AUDIO_PLAYER, 0x43A047},
-  {"Video", LV_SYMBOL_PLAY, HOME_ICON_SYMBOL, UI_PAGE_VIDEO_PLAYER, 0xFB8C00},
-  {"Voice", LV_SYMBOL_CALL, HOME_ICON_SYMBOL, UI_PAGE_VOICE, 0x00897B},
-  {"Inbox", LV_SYMBOL_LIST, HOME_ICON_SYMBOL, UI_PAGE_INBOX, 0x546E7A},
-};
-
-static constexpr uint8_t HOME_SHORTCUT_COUNT = sizeof(HOME_SHORTCUTS) / sizeof(HOME_SHORTCUTS[0]);
-static constexpr uint8_t HOME_VISIBLE_SLOT_COUNT = 8;
-static lv_obj_t *homeShortcutSlots[HOME_VISIBLE_SLOT_COUNT] = {nullptr};
-static lv_obj_t *homeShortcutButtons[HOME_VISIBLE_SLOT_COUNT] = {nullptr};
-static lv_obj_t *homeShortcutIcons[HOME_VISIBLE_SLOT_COUNT] = {nullptr};
-static int8_t homeSlotToShortcut[HOME_VISIBLE_SLOT_COUNT] = {-1, -1, -1, -1, -1, -1, -1, -1};
-static lv_obj_t *homeCurrentShortcutLabel = nullptr;
-static lv_obj_t *homeSwipeHintLabel = nullptr;
-static int homeCarouselOffset = 0;
-
-static lv_obj_t *wifiLabel = nullptr;
-static lv_obj_t *wsLabel = nullptr;
-static lv_obj_t *statsLabel = nullptr;
-static lv_obj_t *cpuArc = nullptr;
-static lv_obj_t *memArc = nullptr;
-static lv_obj_t *cpuValueLabel = nullptr;
-static lv_obj_t *memValueLabel = nullptr;
-static lv_obj_t *upValueLabel = nullptr;
-static lv_obj_t *downValueLabel = nullptr;
-
-static lv_obj_t *clockLabel = nullptr;
-static lv_obj_t *clockSecondLabel = nullptr;
-static lv_obj_t *clockDateLabel = nullptr;
-static lv_obj_t *clockSecondArc = nullptr;
-
-static lv_obj_t *diagWifiLabel = nullptr;
-static lv_obj_t *diagWsLabel = nullptr;
-static lv_obj_t *diagNtpLabel = nullptr;
-static lv_obj_t *diagIpLabel = nullptr;
-static lv_obj_t *diagRssiLabel = nullptr;
-static lv_obj_t *diagUptimeLabel = nullptr;
-static lv_obj_t *diagServerLabel = nullptr;
-static lv_obj_t *diagSdLabel = nullptr;
-static lv_obj_t *diagSdRootLabel = nullptr;
-static lv_obj_t *diagActionLabel = nullptr;
-static lv_obj_t *brightnessSlider = nullptr;
-static lv_obj_t *brightnessValueLabel = nullptr;
-
-static lv_obj_t *inboxTypeLabel = nullptr;
-static lv_obj_t *inboxIndexLabel = nullptr;
-static lv_obj_t *inboxTitleLabel = nullptr;
-static lv_obj_t *inboxBodyLabel = nullptr;
-static lv_obj_t *inboxMetaLabel = nullptr;
-static lv_obj_t *inboxActionLabel = nullptr;
-static lv_obj_t *inboxAckBtn = nullptr;
-static lv_obj_t *inboxDoneBtn = nullptr;
-
-static lv_obj_t *pomodoroArc = nullptr;
-static lv_obj_t *pomodoroTimeLabel = nullptr;
-static lv_obj_t *pomodoroModeLabel = nullptr;
-static lv_obj_t *pomodoroCountLabel = nullptr;
-static lv_obj_t *pomodoroStatusLabel = nullptr;
-
-static lv_obj_t *weatherTempLabel = nullptr;
-static lv_obj_t *weatherConditionLabel = nullptr;
-static lv_obj_t *weatherCityLabel = nullptr;
-static lv_obj_t *weatherHumidityLabel = nullptr;
-static lv_obj_t *weatherFeelsLikeLabel = nullptr;
-
-static lv_obj_t *appLauncherList = nullptr;
-static lv_obj_t *appLauncherTitle = nullptr;
-static lv_obj_t *appLauncherPageLabel = nullptr;
-static lv_obj_t *appLauncherStatusLabel = nullptr;
-static lv_obj_t *appLauncherPrevBtn = nullptr;
-static lv_obj_t *appLauncherNextBtn = nullptr;
-static lv_timer_t *appLauncherStatusTimer = nullptr;
-
-static lv_obj_t *photoFrameRootLabel = nullptr;
-static lv_obj_t *photoFrameViewport = nullptr;
-static lv_obj_t *photoFrameStatusLabel = nullptr;
-static lv_obj_t *photoFrameImage = nullptr;
-static lv_obj_t *photoFrameNameLabel = nullptr;
-static lv_obj_t *photoFrameIndexLabel = nullptr;
-static lv_obj_t *photoFramePrevBtn = nullptr;
-static lv_obj_t *photoFrameReloadBtn = nullptr;
-static lv_obj_t *photoFrameNextBtn = nullptr;
-
-static lv_obj_t *audioStatusLabel = nullptr;
-static lv_obj_t *audioTrackLabel = nullptr;
-static lv_obj_t *audioTimeLabel = nullptr;
-static lv_obj_t *audioIndexLabel = nullptr;
-static lv_obj_t *audioPrevBtn = nullptr;
-static lv_obj_t *audioPlayBtn = nullptr;
-static lv_obj_t *audioPlayBtnLabel = nullptr;
-static lv_obj_t *audioNextBtn = nullptr;
-
-static lv_obj_t *homeWallpaperImage = nullptr;
-static lv_obj_t *clockWallpaperImage = nullptr;
-static lv_obj_t *homeWallpaperShade = nullptr;
-static lv_obj_t *clockWallpaperShade = nullptr;
-static lv_obj_t *bootSplashOverlay = nullptr;
-
-static lv_obj_t *videoStatusLabel = nullptr;
-static lv_obj_t *videoTrackLabel = nullptr;
-static lv_obj_t *videoHintLabel = nullptr;
-static lv_obj_t *videoIndexLabel = nullptr;
-static lv_obj_t *videoViewport = nullptr;
-static lv_obj_t *videoImage = nullptr;
-static lv_obj_t *videoPrevBtn = nullptr;
-static lv_obj_t *videoPlayBtn = nullptr;
-static lv_obj_t *videoPlayBtnLabel = nullptr;
-static lv_obj_t *videoNextBtn = nullptr;
-
-static lv_obj_t *voiceStatusLabel = nullptr;
-static lv_obj_t *voiceResultLabel = nullptr;
-static lv_obj_t *voiceMicToggleBtn = nullptr;
-static lv_obj_t *voiceMicToggleLabel = nullptr;
+void webSocketEvent(WStype_t type, uint8_t *payload, size_t length);
 
 static constexpr i2s_port_t VOICE_I2S_PORT = I2S_NUM_1;
 static constexpr uint32_t VOICE_SAMPLE_RATE = 16000;
@@ -228,25 +78,79 @@ static uint32_t voiceChunkSeq = 0;
 static uint32_t voiceChunksSent = 0;
 static uint32_t voiceBytesSent = 0;
 static uint32_t voiceLastChunkMs = 0;
+static uint32_t voiceSpeechEndMs = 0;   // when the user stopped talking, for reply latency
 static uint32_t voiceLastStartSentMs = 0;
 static uint8_t voiceLastLevelPercent = 0;
-static int32_t voiceRawChunk[VOICE_SAMPLES_PER_CHUNK * 2];
-static int32_t voiceMonoRaw[VOICE_SAMPLES_PER_CHUNK];
 static int16_t voicePcmChunk[VOICE_SAMPLES_PER_CHUNK];
 
-struct VoicePresetCommand {
-  const char *label;
-  const char *text;
-};
-
-static const VoicePresetCommand VOICE_PRESET_COMMANDS[] = {
-  {"Home", "go home"},
-  {"Monitor", "open monitor"},
-  {"Weather", "open weather"},
-  {"Clock", "open clock"},
-  {"Apps", "open apps"},
-  {"Safari", "open safari"},
+// Capture runs in its own task so loop() stalls (JPEG decode, SD scans) no
+// longer overrun the I2S DMA; the loop task drains the ring and sends.
+static constexpr size_t VOICE_CAPTURE_FRAMES = 320; // 20ms per I2S read
+static constexpr uint32_t VOICE_RING_SAMPLES = 16384; // ~1s @ 16kHz
+static constexpr uint8_t VOICE_MAX_CHUNKS_PER_LOOP = 4;
+static constexpr UBaseType_t VOICE_CAPTURE_TASK_PRIORITY = 10;
+static int32_t voiceRawChunk[VOICE_CAPTURE_FRAMES * 2];
+static PcmConditioner voiceConditioner;
+static uint32_t voiceConditionUsTotal = 0;   // capture task only; read once it has exited
+static uint32_t voiceConditionUsMax = 0;
+static uint32_t voiceConditionBlocks = 0;
+static int16_t voiceCapturePcm[VOICE_CAPTURE_FRAMES];
+static MicRing voiceMicRing;
+static int16_t *voiceRingStorage = nullptr;
+static QueueHandle_t voiceI2sEventQueue = nullptr;
+static TaskHandle_t volatile voiceCaptureTaskHandle = nullptr;
+static volatile bool voiceCaptureRun = false;
+static std::atomic<uint32_t> voiceDmaOverruns(0);
+
+// Wire format chosen by the server in the "accepted" voice_stream_ack.
+enum VoiceStreamFormat : uint8_t {
+  VOICE_FORMAT_PCM = 0,
+  VOICE_FORMAT_IMA_ADPCM,
 };
+static VoiceStreamFormat voiceStreamFormat = VOICE_FORMAT_PCM;
+static ImaAdpcmState voiceAdpcmState;
+static uint8_t voiceEncodedChunk[IMA_ADPCM_CHUNK_BYTES(VOICE_SAMPLES_PER_CHUNK)];
+static uint32_t voiceEncodeUsTotal = 0;
+static uint32_t voiceEncodeUsMax = 0;
+
+// Only speech segments are streamed; the stream ends on trailing silence.
+static constexpr uint8_t VOICE_PREROLL_CHUNKS = 3; // 120ms before onset
+static constexpr uint32_t VOICE_NO_SPEECH_TIMEOUT_MS = 8000;
+static VoiceVad voiceVad;
+static uint32_t voiceVadUsTotal = 0;
+static uint32_t voiceLastLabelMs = 0;
+static int16_t voicePreroll[VOICE_PREROLL_CHUNKS][VOICE_SAMPLES_PER_CHUNK];
+static uint8_t voicePrerollLevel[VOICE_PREROLL_CHUNKS];
+static uint8_t voicePrerollHead = 0;
+static uint8_t voicePrerollCount = 0;
+
+// Wake word: when /kws/model.bin is on the SD card the mic stays open and a
+// low-priority task on core 0 scores MFCC windows between streams. The stream
+// ring keeps the last 500ms so a wake-started stream opens with pre-roll.
+static constexpr const char *KWS_MODEL_PATH = "/kws/model.bin";
+static constexpr size_t KWS_MODEL_MAX_BYTES = 256 * 1024;
+static constexpr uint32_t KWS_RING_SAMPLES = 4096;
+static constexpr uint32_t KWS_PREROLL_SAMPLES = 8000; // 500ms @ 16kHz
+static constexpr uint32_t KWS_GATE_ENERGY = 200;      // mean |x|; quieter hops skip inference
+static constexpr uint8_t KWS_INFER_EVERY_HOPS = 2;    // score every 40ms
+static constexpr UBaseType_t KWS_TASK_PRIORITY = 3;
+static constexpr uint32_t KWS_STATS_LOG_INTERVAL_MS = 60000;
+static bool kwsEnabled = false;
+static uint8_t *kwsModelBlob = nullptr;
+static KwsModel kwsModel;
+static KwsFrontEnd *kwsFrontEnd = nullptr;
+static KwsDetector kwsDetector;
+static MicRing kwsRing;
+static int16_t *kwsRingStorage = nullptr;
+static TaskHandle_t kwsTaskHandle = nullptr;
+static std::atomic<bool> kwsTriggered(false);
+static std::atomic<uint32_t> kwsHops(0);
+static std::atomic<uint32_t> kwsInferences(0);
+static std::atomic<uint32_t> kwsDetections(0);
+static std::atomic<uint32_t> kwsFeatureUsTotal(0);
+static std::atomic<uint32_t> kwsInferUsTotal(0);
+static uint32_t kwsLastStatsLogMs = 0;
+static bool voiceWakeStarted = false;
 
 struct MacApp {
   char name[32];
@@ -294,6 +198,9 @@ static lv_img_dsc_t photoRawDsc;
 static uint8_t *photoDecodedData = nullptr;
 static size_t photoDecodedDataSize = 0;
 static lv_img_dsc_t photoDecodedDsc;
+static uint32_t photoDecodedGen = 0;
+// Photos change rarely, so they get the smoother filter.
+static ImgTransformCache photoFrameTransform = imgTransformCache(IMG_SCALE_BILINEAR);
 
 struct SdAudioFile {
   char path[192];
@@ -302,18 +209,111 @@ struct SdAudioFile {
   uint32_t durationSec;
   bool durationChecked;
   bool durationEstimated;
+  Mp3SeekIndex *seekIndex;   // PSRAM, MP3 only; null until indexed
 };
 
 static SdAudioFile sdAudioFiles[96];
 static int sdAudioCount = 0;
 static int sdAudioIndex = 0;
-static AudioFileSourceFS *audioFileSource = nullptr;
-static AudioFileSourceBuffer *audioBufferedSource = nullptr;
-static AudioGeneratorMP3 *audioMp3 = nullptr;
-static AudioGeneratorWAV *audioWav = nullptr;
 static AudioOutputI2S *audioOutput = nullptr;
 static bool audioOutputReady = false;
 static bool audioPaused = false;
+
+// Decoding runs on its own task so UI stalls (photo/wallpaper decode) cannot
+// starve it. The loop task takes the lock only to start, stop or pause; the
+// engine decodes, preloads the next track into the spare slot once the
+// current one is underway, and switches to it without closing the output.
+struct AudioTrackSlot {
+  AudioFileSourceFS *file;
+  AudioFileSourceBuffer *buffer;
+  AudioGenerator *generator;
+  uint8_t *storage;   // PSRAM read-ahead, kept across tracks
+  int index;
+};
+
+static constexpr uint32_t AUDIO_SOURCE_BUFFER_BYTES = 32 * 1024;
+static constexpr int AUDIO_DMA_BUF_COUNT = 16;
+static constexpr UBaseType_t AUDIO_ENGINE_TASK_PRIORITY = 5;
+static constexpr uint32_t AUDIO_PRELOAD_AFTER_MS = 1500;
+static AudioTrackSlot audioSlots[2] = {
+  {nullptr, nullptr, nullptr, nullptr, -1},
+  {nullptr, nullptr, nullptr, nullptr, -1},
+};
+static uint8_t audioCurrentSlot = 0;
+static AudioOutputGapless *audioGaplessOutput = nullptr;
+static SemaphoreHandle_t audioEngineLock = nullptr;
+static TaskHandle_t audioEngineTaskHandle = nullptr;
+static volatile bool audioEngineRunning = false;
+static int audioNextIndex = -1;   // preload target, written under the lock
+static uint32_t audioTrackStartedMs = 0;
+static std::atomic<int> audioEngineEnteredTrack(-1);   // engine -> loop: gapless switch
+static std::atomic<bool> audioEngineFinished(false);   // engine -> loop: nothing preloaded
+static uint32_t audioGaplessSwitches = 0;
+static uint32_t audioPreloadFailures = 0;
+static uint32_t audioEnginePassMaxUs = 0;
+static bool audioSeekDragging = false;
+
+// Desktop audio stream (TTS replies, music). ADPCM frames arrive on the loop
+// task and go into a jitter buffer; the engine task drains it into the same
+// gapless output, so the stream and SD playback never hold I2S at once.
+static constexpr uint16_t NET_AUDIO_SLOTS = 32;
+static constexpr uint16_t NET_AUDIO_MAX_FRAME_SAMPLES = AUDIO_STREAM_MAX_SAMPLE_RATE * AUDIO_STREAM_FRAME_MS / 1000;
+static constexpr uint16_t NET_AUDIO_PULL_SAMPLES = 128;
+static constexpr uint32_t NET_AUDIO_IDLE_TIMEOUT_MS = 3000;
+static constexpr uint32_t NET_AUDIO_STATS_LOG_INTERVAL_MS = 10000;
+static JitterBuffer netAudioJitter;
+static int16_t *netAudioStorage = nullptr;   // PSRAM
+static uint32_t netAudioTags[NET_AUDIO_SLOTS];
+static portMUX_TYPE netAudioMux = portMUX_INITIALIZER_UNLOCKED;   // guards netAudioJitter
+static int16_t netAudioDecodeBuffer[NET_AUDIO_MAX_FRAME_SAMPLES];
+static int16_t netAudioPullBuffer[NET_AUDIO_PULL_SAMPLES];   // engine side
+static uint16_t netAudioPullPos = NET_AUDIO_PULL_SAMPLES;
+static bool netAudioActive = false;              // loop side
+static volatile bool netAudioRunning = false;    // engine side, written under the lock
+static std::atomic<bool> netAudioDrained(false); // engine -> loop: last frame played
+static uint8_t netAudioStreamId = 0;
+static uint32_t netAudioStartedMs = 0;
+static uint32_t netAudioLastFrameMs = 0;
+static uint32_t netAudioLastStatsLogMs = 0;
+static uint32_t netAudioBadFrames = 0;
+static uint32_t netAudioUnderrunsTotal = 0;
+static bool netAudioIsReply = false;                // purpose "tts": spoken reply to a voice command
+static std::atomic<uint32_t> netAudioFirstAudioMs(0); // engine -> loop: first real sample written to I2S
+static bool netAudioFirstAudioReported = false;
+static constexpr uint32_t NET_AUDIO_REPLY_WINDOW_MS = 30000;  // speech end older than this is unrelated
+
+// Spectrum visualizer on the audio page. The gapless output taps what it
+// hands to I2S; a task on core 0, below the engine, runs the FFT at ~30 Hz;
+// the loop repaints only the changed rows of each bar in a small canvas and
+// invalidates just that area.
+static constexpr uint32_t SPECTRUM_INTERVAL_MS = 33;
+static constexpr UBaseType_t SPECTRUM_TASK_PRIORITY = 2;
+static SpectrumTap spectrumTap;                       // internal RAM, written per sample
+static SpectrumAnalyzer *spectrumAnalyzer = nullptr;  // internal RAM, analyzer task only
+static SpectrumShared spectrumShared;
+static TaskHandle_t spectrumTaskHandle = nullptr;
+static std::atomic<bool> spectrumWanted(false);
+static std::atomic<uint32_t> spectrumFramesTotal(0);
+static std::atomic<uint32_t> spectrumUsTotal(0);
+static std::atomic<uint32_t> spectrumUsMax(0);
+static SpectrumFrame spectrumDrawn;
+static uint32_t spectrumSeenSeq = 0;
+static bool spectrumVisible = false;
+static bool spectrumUnavailable = false;
+
+// MP3 files without a Xing/VBRI tag are indexed by walking their frame
+// headers, a slice per loop() so the UI never stalls on a long file.
+struct AudioIndexScanJob {
+  File file;
+  int index;
+  Mp3FrameScanner *scanner;   // PSRAM
+  uint8_t *buffer;            // PSRAM
+  uint32_t startedMs;
+};
+
+static constexpr size_t AUDIO_INDEX_SCAN_BLOCK_BYTES = 8 * 1024;
+static constexpr uint32_t AUDIO_INDEX_SCAN_BUDGET_MS = 4;
+static AudioIndexScanJob audioIndexScan = {File(), -1, nullptr, nullptr, 0};
 static uint32_t audioLastControlMs = 0;
 static uint32_t audioElapsedAccumMs = 0;
 static uint32_t audioPlaybackResumeMs = 0;
@@ -349,48 +349,66 @@ static size_t videoFrameDataSize = 0;
 static uint8_t *videoDecodedData = nullptr;
 static size_t videoDecodedCapacity = 0;
 static lv_img_dsc_t videoDecodedDsc;
+static uint32_t videoDecodedGen = 0;
+// Video and wallpapers rescale every decoded frame.
+static ImgTransformCache videoTransform = imgTransformCache(IMG_SCALE_NEAREST);
+static ImgTransformCache wallpaperTransform = imgTransformCache(IMG_SCALE_NEAREST);
+static constexpr uint32_t IMG_TRANSFORM_LOG_INTERVAL_MS = 60000;
+static uint32_t imgTransformLastLogMs = 0;
+static uint32_t imgTransformLoggedRebuilds = 0;
+// Home and clock: wallpaper frames composed under a cached overlay of the
+// page's shade and widgets. Set to false to let LVGL redraw them per frame.
+static constexpr bool WALLPAPER_COMPOSE_ENABLED = true;
+static LayerCompositor wallpaperCompositor = {};
+static uint32_t layerComposeLastLogMs = 0;
+static uint32_t layerComposeLoggedFrames = 0;
+// Video and wallpaper frames are decoded ahead and swapped in on a steady
+// cadence (display/frame_pacer.h), on the panel's TE edge when one is wired.
+struct PendingMediaFrame {
+  bool valid;
+  uint32_t gen;    // videoDecodedGen it was decoded at; both players share the buffer
+  lv_img_header_t header;
+  int32_t zoom;
+  int32_t viewportW;
+  int32_t viewportH;
+};
+static FramePacer videoPacer = {};
+static FramePacer wallpaperPacer = {};
+static PendingMediaFrame videoPendingFrame = {};
+static PendingMediaFrame wallpaperPendingFrame = {};
+static uint32_t framePacerLastLogMs = 0;
+static uint32_t framePacerLoggedPresents = 0;
 static uint32_t videoFrameIntervalMs = 100; // 10 FPS default
-static uint32_t videoLastFrameMs = 0;
 static uint32_t videoLastControlMs = 0;
 static constexpr uint32_t VIDEO_CONTROL_COOLDOWN_MS = 220;
 static constexpr size_t VIDEO_FRAME_MAX_BYTES = 512 * 1024;
 static constexpr uint8_t VIDEO_SCAN_MAX_DEPTH = 4;
 
-enum VideoControlAction {
-  VIDEO_CONTROL_NONE = -1,
-  VIDEO_CONTROL_PREV = 0,
-  VIDEO_CONTROL_TOGGLE = 1,
-  VIDEO_CONTROL_NEXT = 2,
-  VIDEO_CONTROL_RESCAN = 3,
-};
-
 static volatile int pendingVideoControlAction = VIDEO_CONTROL_NONE;
 
 struct DynamicWallpaperPlayer {
   char path[192];
   File file;
-  lv_obj_t *imageObj;
+  lv_obj_t **imageObj;    // homeWallpaperImage or clockWallpaperImage, nullptr until its page is built
   bool enabled;
   bool opened;
   uint16_t baseIntervalMs;
   uint16_t intervalMs;
-  uint32_t lastFrameMs;
   uint8_t slowScore;
   uint8_t fastScore;
   uint8_t failCount;
 };
 
 static DynamicWallpaperPlayer homeWallpaper = {
-  "", File(), nullptr, false, false, 140, 140, 0, 0, 0, 0
+  "", File(), &homeWallpaperImage, false, false, 140, 140, 0, 0, 0
 };
 static DynamicWallpaperPlayer clockWallpaper = {
-  "", File(), nullptr, false, false, 160, 160, 0, 0, 0, 0
+  "", File(), &clockWallpaperImage, false, false, 160, 160, 0, 0, 0
 };
 
 static uint8_t *wallpaperFrameData = nullptr;
 static size_t wallpaperFrameDataSize = 0;
 static uint32_t dynamicWallpaperPauseUntilMs = 0;
-static constexpr uint32_t DYNAMIC_WALLPAPER_TOUCH_PAUSE_MS = 1200;
 static constexpr uint16_t DYNAMIC_WALLPAPER_MIN_INTERVAL_MS = 333; // ~3 FPS
 
 struct PhotoFrameRemoteSettings {
@@ -405,6 +423,36 @@ struct PhotoFrameRemoteSettings {
   bool valid = false;
 };
 
+// CJK text: LVGL binary fonts on SD (/fonts/cjk_<size>.bin, see
+// display/sd_font.h) chained behind the built-in Montserrat of the same
+// size, so Latin text stays on the flash fonts and only the characters they
+// lack go to the card.
+static constexpr const char *UI_FONT_DIR = "/fonts";
+static constexpr uint32_t UI_FONT_CACHE_BYTES = 48 * 1024;  // per size, PSRAM
+static constexpr uint32_t UI_FONT_STATS_LOG_INTERVAL_MS = 60000;
+
+struct UiSdFontFile {
+  File file;
+  char path[32];
+};
+
+struct UiTextFont {
+  uint8_t size;
+  const lv_font_t *builtin;
+  lv_font_t font;         // copy of builtin, fallback -> sd.font
+  SdFont sd;
+  UiSdFontFile file;
+  bool sdLoaded;
+};
+
+static UiTextFont uiTextFonts[] = {
+  {14, &lv_font_montserrat_14, {}, {}, {}, false},
+  {16, &lv_font_montserrat_16, {}, {}, {}, false},
+  {22, &lv_font_montserrat_22, {}, {}, {}, false},
+};
+static uint32_t uiTextFontLastLogMs = 0;
+static uint32_t uiTextFontLoggedMisses = 0;
+
 struct SdBrowserFile {
   char path[192];
   char name[64];
@@ -414,8 +462,25 @@ struct SdBrowserFile {
 
 static SdBrowserFile sdBrowserFiles[120];
 static int sdBrowserFileCount = 0;
-static constexpr int SD_BROWSER_RESPONSE_MAX_FILES = 24;
-static StaticJsonDocument<8192> sdListResponseDoc;
+static constexpr int SD_BROWSER_RESPONSE_MAX_FILES = 64;
+
+// The browser list is a snapshot of the card: it is built once and paged
+// through with cursors until an upload/delete/remount marks it stale.
+static bool sdBrowserSnapshotValid = false;
+static uint32_t sdBrowserSnapshotGeneration = 1;
+static uint32_t sdBrowserSnapshotBuiltMs = 0;
+static bool sdChangeSubscribed = false;
+
+// Binary stats stream (negotiated in handshake_ack); replaces JSON system_stats.
+static StatsStreamDecoder statsStreamDecoder;
+static bool statsStreamActive = false;
+static uint8_t statsStreamRateHz = 0;
+static constexpr uint8_t STATS_STREAM_MONITOR_RATE_HZ = STATS_STREAM_MAX_RATE_HZ;
+static constexpr uint8_t STATS_STREAM_IDLE_RATE_HZ = 1;
+
+// Compressed server text (negotiated in handshake_ack); decoded into PSRAM.
+static bool wsCompressionActive = false;
+static uint8_t *wsCompressionBuffer = nullptr;
 
 struct SdUploadSession {
   bool active;
@@ -447,14 +512,10 @@ static char currentPhotoName[64] = "";
 static char currentPhotoPath[192] = "";
 static char currentPhotoDecoder[16] = "-";
 static bool currentPhotoValid = false;
+static const lv_img_dsc_t *currentPhotoSrc = nullptr;    // photoDecodedDsc or photoRawDsc while valid
+static lv_img_header_t currentPhotoHeader;
 static uint16_t sdPhotoLimitSkipped = 0;
 
-enum PomodoroMode {
-  POMODORO_WORK = 0,
-  POMODORO_SHORT_BREAK = 1,
-  POMODORO_LONG_BREAK = 2
-};
-
 enum PomodoroState {
   POMODORO_IDLE = 0,
   POMODORO_RUNNING = 1,
@@ -468,20 +529,9 @@ static uint32_t pomodoroElapsedMs = 0;
 static uint32_t pomodoroDurationMs = 25 * 60 * 1000; // 25 minutes
 static int pomodoroCompletedCount = 0;
 
-struct WeatherData {
-  float temperature = 0.0f;
-  float feelsLike = 0.0f;
-  int humidity = 0;
-  char condition[32] = "Loading...";
-  char city[32] = "Beijing";
-  char updateTime[32] = "";
-  bool valid = false;
-};
-
 static WeatherData currentWeather;
 static uint32_t lastWeatherUpdateMs = 0;
 static constexpr uint32_t WEATHER_UPDATE_INTERVAL_MS = 30 * 60 * 1000; // 30 minutes
-static const char *WEATHER_API_KEY = "598a41cf8b404383a148d15a41fa0b55";
 static const char *WEATHER_CITY_ID = "101010100"; // Beijing default
 
 static constexpr uint32_t NTP_RETRY_INTERVAL_MS = 30000;
@@ -492,25 +542,10 @@ static const char *NTP_SERVER_3 = "ntp.aliyun.com";
 static const char *WEEKDAY_SHORT[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
 static constexpr const char *PREF_NAMESPACE = "desktop";
 static constexpr const char *PREF_KEY_BRIGHTNESS = "brightness";
-
-enum SettingsAction {
-  SETTINGS_ACTION_NONE = 0,
-  SETTINGS_ACTION_WIFI_RECONNECT = 1,
-  SETTINGS_ACTION_WS_RECONNECT = 2,
-  SETTINGS_ACTION_NTP_SYNC = 3,
-  SETTINGS_ACTION_REBOOT = 4
-};
+static constexpr const char *PREF_KEY_CLOCK_SWEEP = "clockSweep";
 
 static volatile SettingsAction pendingAction = SETTINGS_ACTION_NONE;
 
-enum InboxAction {
-  INBOX_ACTION_NONE = 0,
-  INBOX_ACTION_PREV = 1,
-  INBOX_ACTION_NEXT = 2,
-  INBOX_ACTION_ACK = 3,
-  INBOX_ACTION_DONE = 4
-};
-
 struct InboxMessage {
   char category[12];
   char title[32];
@@ -530,11 +565,10 @@ static int inboxSelected = 0;
 static void updateClockDisplay();
 static void setWifiStatus(const String &text);
 static void setWsStatus(const String &text);
-static void gestureEventCallback(lv_event_t *e);
-static void attachGestureHandlers(lv_obj_t *obj);
+static void setStats(float cpu, float memory, float upload, float download);
 static void refreshInboxView();
 static void loadSdPhotoList();
-static void showCurrentPhotoFrame();
+static void showCurrentPhotoFrame(bool loadWithoutPage = false);
 static bool ensurePhotoDecoderReady();
 static void requestPhotoFrameSettings(bool force = false);
 static void processPhotoFrameAutoPlay();
@@ -545,7 +579,10 @@ static void showCurrentAudioTrack();
 static void processAudioPlayback();
 static void processPendingAudioControl();
 static bool startAudioPlayback(int index);
+static void audioEnterTrack(int index);
+static void cancelAudioIndexScan();
 static void stopAudioPlayback(bool keepStatus = false);
+static void stopNetAudioStream(const char *reason, bool notifyServer);
 static void refreshAudioTimeLabel(bool force = false);
 static bool isAudioRunning();
 static void loadSdVideoList();
@@ -562,7 +599,8 @@ static void prepareDynamicWallpaperForPage(int pageIndex, bool forceFrame = fals
 static void pauseDynamicWallpapersForMs(uint32_t durationMs);
 static bool showBootSplashFromSd(uint32_t holdMs);
 static void clearBootSplashOverlay();
-static void sendSdListResponse(const char *requestId, int offset, int limit);
+static void sendSdListResponse(const char *requestId, const char *dirPath, bool recursive, const char *cursor, int offset, int limit, bool refresh);
+static void markSdBrowserSnapshotStale(const char *reason, const char *path);
 static void sendSdDeleteResponse(const char *requestId, const char *targetPath, bool success, const char *reason);
 static void sendSdPreviewResponse(const char *requestId, const char *targetPath, bool success, uint32_t len, const char *reason);
 static void resetSdUploadSession(bool removeTempFile);
@@ -571,25 +609,22 @@ static void sendSdUploadBeginAck(const char *uploadId, bool success, const char
 static void sendSdUploadChunkAck(const char *uploadId, int seq, bool success, const char *reason);
 static void sendSdUploadCommitAck(const char *uploadId, bool success, const char *finalPath, const char *reason);
 static void sendVoiceCommand(const char *text);
+static void sendStatsStreamConfig(bool keyframe);
 static bool ensureVoiceMicReady(char *reason, size_t reasonSize);
 static void releaseVoiceMic();
 static void setVoiceMicStreaming(bool enabled, const char *reason, bool notifyServer = true);
 static void sendVoiceStreamStart();
 static void sendVoiceStreamStop(const char *reason);
-static void sendVoiceStreamChunkMeta(size_t byteLen, uint8_t levelPercent);
+static void sendVoiceStreamChunkMeta(size_t byteLen, size_t samples, uint8_t levelPercent);
 static void processVoiceMicStreaming();
+static void initWakeWord();
+static void processWakeWord();
 static int parseUiPageFromVoiceName(const char *name);
 static bool shouldSuppressClick();
-static void suppressClicksForMs(uint32_t durationMs);
-static void suppressClicksAfterHome();
-static void homeShortcutEventCallback(lv_event_t *e);
+static void showPage(int pageIndex);
 static void voiceCommandButtonCallback(lv_event_t *e);
 static void voiceMicToggleCallback(lv_event_t *e);
 static void videoControlCallback(lv_event_t *e);
-static void renderHomeShortcutIcon(uint8_t slotIdx, const HomeShortcutConfig &item);
-static void refreshHomeShortcutSlots();
-static void shiftHomeCarousel(int delta);
-static void layoutHomeShortcuts();
 
 static int clampPercent(float value) {
   int v = (int)(value + 0.5f);
@@ -605,7 +640,124 @@ static void copyText(char *dst, size_t dstSize, const char *src) {
   if (src == nullptr) {
     src = "";
   }
-  snprintf(dst, dstSize, "%s", src);
+  size_t len = 0;
+  for (; len + 1 < dstSize && src[len] != '\0'; ++len) {
+    dst[len] = src[len];
+  }
+  dst[len] = '\0';
+}
+
+static void rememberStatusText(UiStatusText &status, const char *text, lv_color_t color) {
+  copyText(status.text, sizeof(status.text), text);
+  status.color = color;
+  status.set = true;
+}
+
+static bool readUiSdFontFile(void *ctx, uint32_t offset, void *dst, uint32_t len) {
+  UiSdFontFile *font = (UiSdFontFile *)ctx;
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    if (!font->file) {
+      if (!sdMounted) {
+        return false;
+      }
+      font->file = SD_MMC.open(font->path, FILE_READ);
+      if (!font->file) {
+        return false;
+      }
+    }
+    if (font->file.seek(offset) && font->file.read((uint8_t *)dst, len) == len) {
+      return true;
+    }
+    // The handle goes stale when the card is remounted; reopen once.
+    font->file.close();
+  }
+  return false;
+}
+
+static void loadUiTextFonts() {
+  for (UiTextFont &t : uiTextFonts) {
+    t.font = *t.builtin;
+    t.font.fallback = nullptr;
+    t.sdLoaded = false;
+    if (!sdMounted) {
+      continue;
+    }
+    snprintf(t.file.path, sizeof(t.file.path), "%s/cjk_%u.bin", UI_FONT_DIR, (unsigned)t.size);
+    if (!SD_MMC.exists(t.file.path)) {
+      continue;
+    }
+
+    const uint32_t startMs = millis();
+    SdFontReader reader = {&t.file, readUiSdFontFile};
+    char reason[48];
+    if (!sdFontOpen(&t.sd, reader, UI_FONT_CACHE_BYTES, nullptr, reason, sizeof(reason))) {
+      Serial.printf("[Font] %s: %s\n", t.file.path, reason);
+      t.file.file.close();
+      continue;
+    }
+    t.sdLoaded = true;
+    t.font.fallback = &t.sd.font;
+    Serial.printf("[Font] %s: %lu glyphs, %u px %u bpp, %lu KB PSRAM (%u cache slots of %u B), %lu ms\n",
+                  t.file.path,
+                  (unsigned long)(t.sd.glyphCount - 1),
+                  (unsigned)t.sd.head.fontSize,
+                  (unsigned)t.sd.head.bitsPerPixel,
+                  (unsigned long)(sdFontRamBytes(&t.sd) / 1024),
+                  (unsigned)t.sd.slotCount,
+                  (unsigned)t.sd.slotBytes,
+                  (unsigned long)(millis() - startMs));
+  }
+}
+
+// Montserrat of that size, backed by the SD font when one was loaded.
+static const lv_font_t *uiTextFont(uint8_t size) {
+  for (UiTextFont &t : uiTextFonts) {
+    if (t.size == size) {
+      return &t.font;
+    }
+  }
+  return LV_FONT_DEFAULT;
+}
+
+static bool uiTextFontHasCjk(uint8_t size) {
+  for (const UiTextFont &t : uiTextFonts) {
+    if (t.size == size) {
+      return t.sdLoaded;
+    }
+  }
+  return false;
+}
+
+static void logUiTextFontStats() {
+  const uint32_t now = millis();
+  if ((uint32_t)(now - uiTextFontLastLogMs) < UI_FONT_STATS_LOG_INTERVAL_MS) {
+    return;
+  }
+  uiTextFontLastLogMs = now;
+  uint32_t misses = 0;
+  for (const UiTextFont &t : uiTextFonts) {
+    misses += t.sd.stats.misses;
+  }
+  if (misses == uiTextFontLoggedMisses) {
+    return;
+  }
+  uiTextFontLoggedMisses = misses;
+  for (const UiTextFont &t : uiTextFonts) {
+    if (!t.sdLoaded) {
+      continue;
+    }
+    const SdFontStats &st = t.sd.stats;
+    const uint32_t lookups = st.hits + st.misses;
+    Serial.printf("[Font] %u px: hits=%lu misses=%lu (%lu%% hit) evictions=%lu readFails=%lu cached=%u/%u\n",
+                  (unsigned)t.size,
+                  (unsigned long)st.hits,
+                  (unsigned long)st.misses,
+                  (unsigned long)(lookups ? (uint64_t)st.hits * 100 / lookups : 0),
+                  (unsigned long)st.evictions,
+                  (unsigned long)st.readFails,
+                  (unsigned)t.sd.slotsUsed,
+                  (unsigned)t.sd.slotCount);
+  }
 }
 
 static int inboxPhysicalIndex(int logicalIndex) {
@@ -659,20 +811,25 @@ static void sendInboxTaskAction(const char *action, const InboxMessage &msg) {
     return;
   }
 
-  StaticJsonDocument<320> doc;
-  doc["type"] = "task_action";
-  JsonObject data = doc.createNestedObject("data");
-  data["deviceId"] = DEVICE_ID;
-  data["action"] = action;
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_CONTROL, WS_COALESCE_NONE);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "task_action");
+  json.beginObject("data");
+  json.field("deviceId", DEVICE_ID);
+  json.field("action", action);
   if (msg.taskId[0] != '\0') {
-    data["taskId"] = msg.taskId;
+    json.field("taskId", msg.taskId);
   }
-  data["title"] = msg.title;
-  data["timestamp"] = millis();
+  json.field("title", msg.title);
+  json.field("timestamp", millis());
 
-  String output;
-  serializeJson(doc, output);
-  webSocket.sendTXT(output);
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
 }
 
 static void refreshInboxView() {
@@ -706,11 +863,11 @@ static void refreshInboxView() {
 
   uint32_t ageSec = (millis() - msg->createdMs) / 1000;
   if (ageSec < 60) {
-    lv_label_set_text_fmt(inboxMetaLabel, "%lus ago | %s", ageSec, msg->done ? "done" : (msg->actionable ? "pending" : "info"));
+    lv_label_set_text_fmt(inboxMetaLabel, "%lus ago | %s", (unsigned long)ageSec, msg->done ? "done" : (msg->actionable ? "pending" : "info"));
   } else if (ageSec < 3600) {
-    lv_label_set_text_fmt(inboxMetaLabel, "%lum ago | %s", ageSec / 60, msg->done ? "done" : (msg->actionable ? "pending" : "info"));
+    lv_label_set_text_fmt(inboxMetaLabel, "%lum ago | %s", (unsigned long)(ageSec / 60), msg->done ? "done" : (msg->actionable ? "pending" : "info"));
   } else {
-    lv_label_set_text_fmt(inboxMetaLabel, "%luh ago | %s", ageSec / 3600, msg->done ? "done" : (msg->actionable ? "pending" : "info"));
+    lv_label_set_text_fmt(inboxMetaLabel, "%luh ago | %s", (unsigned long)(ageSec / 3600), msg->done ? "done" : (msg->actionable ? "pending" : "info"));
   }
 
   if (inboxAckBtn != nullptr) {
@@ -776,25 +933,6 @@ static void inboxActionEventCallback(lv_event_t *e) {
   }
 }
 
-static lv_obj_t *createInboxButton(lv_obj_t *parent, const char *text, lv_coord_t x, lv_coord_t y, lv_coord_t w, InboxAction action) {
-  lv_obj_t *btn = lv_btn_create(parent);
-  lv_obj_set_size(btn, w, 34);
-  lv_obj_align(btn, LV_ALIGN_TOP_LEFT, x, y);
-  lv_obj_set_style_radius(btn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(btn, lv_color_hex(0x1E1E1E), LV_PART_MAIN);
-  lv_obj_set_style_bg_color(btn, lv_color_hex(0x2E2E2E), LV_PART_MAIN | LV_STATE_PRESSED);
-  lv_obj_set_style_border_color(btn, lv_color_hex(0x3A3A3A), LV_PART_MAIN);
-  lv_obj_set_style_border_width(btn, 1, LV_PART_MAIN);
-  lv_obj_add_flag(btn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
-  attachGestureHandlers(btn);
-  lv_obj_add_event_cb(btn, inboxActionEventCallback, LV_EVENT_CLICKED, (void *)((intptr_t)action));
-
-  lv_obj_t *label = lv_label_create(btn);
-  lv_label_set_text(label, text);
-  lv_obj_center(label);
-  return btn;
-}
-
 static void setupNtpTime() {
   configTzTime(NTP_TZ_INFO, NTP_SERVER_1, NTP_SERVER_2, NTP_SERVER_3);
   ntpConfigured = true;
@@ -815,6 +953,7 @@ static bool trySyncNtpTime(uint32_t waitMs) {
 }
 
 static void setActionStatus(const String &text) {
+  actionStatusText = text;
   if (diagActionLabel != nullptr) {
     lv_label_set_text(diagActionLabel, text.c_str());
   }
@@ -931,6 +1070,14 @@ static void scanSdRootDirectory() {
 }
 
 static void detectAndScanSdCard() {
+  // The audio engine reads the card from its own task; never remount under it.
+  if (isAudioRunning()) {
+    stopAudioPlayback(true);
+  }
+  cancelAudioIndexScan();
+  const bool wasMounted = sdMounted;
+  const uint64_t previousTotalBytes = sdTotalBytes;
+  const uint64_t previousUsedBytes = sdUsedBytes;
   sdInitAttempted = true;
   sdMounted = false;
   sdMode1Bit = false;
@@ -961,6 +1108,9 @@ static void detectAndScanSdCard() {
   if (!mounted) {
     copyText(sdMountReason, sizeof(sdMountReason), "mount failed");
     Serial.println("[SD] mount failed");
+    if (wasMounted) {
+      markSdBrowserSnapshotStale("unmounted", "/");
+    }
     refreshDynamicWallpaperSources();
     if (pages[UI_PAGE_HOME] != nullptr) {
       prepareDynamicWallpaperForPage(currentPage, true);
@@ -973,6 +1123,9 @@ static void detectAndScanSdCard() {
     SD_MMC.end();
     copyText(sdMountReason, sizeof(sdMountReason), "no card");
     Serial.println("[SD] no card");
+    if (wasMounted) {
+      markSdBrowserSnapshotStale("unmounted", "/");
+    }
     refreshDynamicWallpaperSources();
     if (pages[UI_PAGE_HOME] != nullptr) {
       prepareDynamicWallpaperForPage(currentPage, true);
@@ -985,6 +1138,9 @@ static void detectAndScanSdCard() {
   sdUsedBytes = SD_MMC.usedBytes();
   scanSdRootDirectory();
   copyText(sdMountReason, sizeof(sdMountReason), "ok");
+  if (!wasMounted || previousTotalBytes != sdTotalBytes || previousUsedBytes != sdUsedBytes) {
+    markSdBrowserSnapshotStale("remounted", "/");
+  }
 
   char totalText[16];
   char usedText[16];
@@ -1195,7 +1351,8 @@ static bool openDynamicWallpaper(DynamicWallpaperPlayer &player) {
   }
 
   player.opened = true;
-  player.lastFrameMs = 0;
+  framePacerReset(&wallpaperPacer);
+  wallpaperPendingFrame.valid = false;
   player.slowScore = 0;
   player.fastScore = 0;
   player.failCount = 0;
@@ -1203,12 +1360,154 @@ static bool openDynamicWallpaper(DynamicWallpaperPlayer &player) {
   return true;
 }
 
-static bool renderNextDynamicWallpaperFrame(DynamicWallpaperPlayer &player, bool allowLoop, char *reason, size_t reasonSize) {
+// Shows src (decoded size `header`) centred in img at `zoom`. The zoom is
+// applied once into `cache` (cropped to viewportW x viewportH) instead of
+// by LVGL on every redraw; lv_img_set_zoom() remains the fallback for
+// sources the cache can't take, such as JPEGs left to LVGL's decoder.
+// Returns what img shows at zoom 256, or nullptr when LVGL zooms it.
+static const lv_img_dsc_t *showZoomedImage(lv_obj_t *img, ImgTransformCache &cache, const lv_img_dsc_t *src,
+                                           uint32_t srcGen, const lv_img_header_t &header, int32_t zoom,
+                                           int32_t viewportW, int32_t viewportH) {
+  const lv_img_dsc_t *shown = imgTransformGet(&cache, src, srcGen, (uint16_t)zoom, viewportW, viewportH);
+  lv_img_set_src(img, nullptr);
+  if (shown != nullptr && shown != src) {
+    lv_img_set_src(img, shown);
+    lv_obj_set_size(img, shown->header.w, shown->header.h);
+    lv_img_set_pivot(img, shown->header.w / 2, shown->header.h / 2);
+    lv_img_set_zoom(img, LV_IMG_ZOOM_NONE);
+  } else {
+    lv_img_set_src(img, src);
+    lv_obj_set_size(img, header.w, header.h);
+    lv_img_set_pivot(img, header.w / 2, header.h / 2);
+    lv_img_set_zoom(img, (uint16_t)zoom);
+  }
+  lv_obj_center(img);
+  return shown;
+}
+
+// Decoding ahead overwrites the decode buffer. An image showing that buffer
+// as is (zoom 256, not composed) would pick the new frame up on any redraw
+// before its slot, so then the decode waits for the slot.
+static bool mediaPrepareDue(const FramePacer &pacer, lv_obj_t *img, uint32_t nowUs) {
+  if (img != nullptr && lv_img_get_src(img) == &videoDecodedDsc) {
+    return framePacerPresentDue(&pacer, nowUs);
+  }
+  return framePacerPrepareDue(&pacer, nowUs);
+}
+
+// A paced present waits for the TE edge when the panel has one and the image
+// is on screen; the caller then refreshes at once so the transfer starts at
+// the top of a panel refresh rather than on the next LVGL timer tick.
+static FramePacerSync waitMediaPresentSlot(lv_obj_t *img) {
+  if (TFT_TE < 0 || img == nullptr || !lv_obj_is_visible(img)) {
+    return FRAME_PACER_TIMER;
+  }
+  return lcd_wait_te(LCD_TE_TIMEOUT_MS) ? FRAME_PACER_TE : FRAME_PACER_TE_MISSED;
+}
+
+static void logImgTransformStats() {
+  const uint32_t now = millis();
+  if ((uint32_t)(now - imgTransformLastLogMs) < IMG_TRANSFORM_LOG_INTERVAL_MS) {
+    return;
+  }
+  imgTransformLastLogMs = now;
+  const uint32_t rebuilds = photoFrameTransform.stats.rebuilds + videoTransform.stats.rebuilds +
+                            wallpaperTransform.stats.rebuilds;
+  if (rebuilds == imgTransformLoggedRebuilds) {
+    return;
+  }
+  imgTransformLoggedRebuilds = rebuilds;
+  const struct {
+    const char *name;
+    const ImgTransformCache *cache;
+  } caches[] = {{"photo", &photoFrameTransform}, {"video", &videoTransform}, {"wallpaper", &wallpaperTransform}};
+  for (const auto &c : caches) {
+    const ImgTransformStats &st = c.cache->stats;
+    if (st.rebuilds == 0 && st.fallbacks == 0) {
+      continue;
+    }
+    Serial.printf("[ImgXform] %s: rebuilds=%lu (avg %lu us, max %lu us) hits=%lu as-is=%lu fallbacks=%lu ram=%u\n",
+                  c.name,
+                  (unsigned long)st.rebuilds,
+                  (unsigned long)(st.rebuilds ? st.rebuildUsTotal / st.rebuilds : 0),
+                  (unsigned long)st.rebuildUsMax,
+                  (unsigned long)st.hits,
+                  (unsigned long)st.passThrough,
+                  (unsigned long)st.fallbacks,
+                  (unsigned)imgTransformRamBytes(c.cache));
+  }
+}
+
+static void logLayerComposeStats() {
+  const uint32_t now = millis();
+  if ((uint32_t)(now - layerComposeLastLogMs) < IMG_TRANSFORM_LOG_INTERVAL_MS) {
+    return;
+  }
+  layerComposeLastLogMs = now;
+  const LayerComposeStats &st = wallpaperCompositor.stats;
+  if (st.frames + st.passes == layerComposeLoggedFrames) {
+    return;
+  }
+  layerComposeLoggedFrames = st.frames + st.passes;
+  Serial.printf("[Compose] wallpaper: frames=%lu (avg %lu us, max %lu us) rebuilds=%lu (avg %lu us, max %lu us) "
+                "passes=%lu backoffs=%lu ram=%u\n",
+                (unsigned long)st.frames,
+                (unsigned long)(st.frames ? st.composeUsTotal / st.frames : 0),
+                (unsigned long)st.composeUsMax,
+                (unsigned long)st.rebuilds,
+                (unsigned long)(st.rebuilds ? st.rebuildUsTotal / st.rebuilds : 0),
+                (unsigned long)st.rebuildUsMax,
+                (unsigned long)st.passes,
+                (unsigned long)st.backoffs,
+                (unsigned)layerComposeRamBytes(&wallpaperCompositor));
+}
+
+static void logFramePacerStats() {
+  const uint32_t now = millis();
+  if ((uint32_t)(now - framePacerLastLogMs) < IMG_TRANSFORM_LOG_INTERVAL_MS) {
+    return;
+  }
+  framePacerLastLogMs = now;
+  const uint32_t presents = videoPacer.stats.presents + wallpaperPacer.stats.presents;
+  if (presents == framePacerLoggedPresents) {
+    return;
+  }
+  framePacerLoggedPresents = presents;
+  const struct {
+    const char *name;
+    const FramePacer *pacer;
+  } pacers[] = {{"video", &videoPacer}, {"wallpaper", &wallpaperPacer}};
+  for (const auto &p : pacers) {
+    const FramePacerStats &st = p.pacer->stats;
+    if (st.presents == 0) {
+      continue;
+    }
+    Serial.printf("[Pacer] %s: period=%lu us presents=%lu te=%lu te-missed=%lu stalls=%lu jitter max %lu us, "
+                  "<1/<2/<4/<8/<16/>=16 ms: %lu/%lu/%lu/%lu/%lu/%lu\n",
+                  p.name,
+                  (unsigned long)p.pacer->periodUs,
+                  (unsigned long)st.presents,
+                  (unsigned long)st.synced,
+                  (unsigned long)st.teMissed,
+                  (unsigned long)st.stalls,
+                  (unsigned long)st.jitterUsMax,
+                  (unsigned long)st.hist[0],
+                  (unsigned long)st.hist[1],
+                  (unsigned long)st.hist[2],
+                  (unsigned long)st.hist[3],
+                  (unsigned long)st.hist[4],
+                  (unsigned long)st.hist[5]);
+  }
+}
+
+// Reads and decodes the player's next frame into wallpaperPendingFrame; it
+// is shown by presentDynamicWallpaperFrame().
+static bool prepareNextDynamicWallpaperFrame(DynamicWallpaperPlayer &player, bool allowLoop, char *reason, size_t reasonSize) {
   if (reason != nullptr && reasonSize > 0) {
     reason[0] = '\0';
   }
 
-  if (!player.enabled || player.imageObj == nullptr) {
+  if (!player.enabled || *player.imageObj == nullptr) {
     copyText(reason, reasonSize, "wallpaper disabled");
     return false;
   }
@@ -1247,8 +1546,6 @@ static bool renderNextDynamicWallpaperFrame(DynamicWallpaperPlayer &player, bool
   }
 
   wallpaperFrameDataSize = frameSize;
-  lv_img_set_src(player.imageObj, nullptr);
-  lv_img_set_src(player.imageObj, (const void *)&videoDecodedDsc);
 
   int32_t viewportW = 360;
   int32_t viewportH = 360;
@@ -1258,16 +1555,56 @@ static bool renderNextDynamicWallpaperFrame(DynamicWallpaperPlayer &player, bool
   if (zoom > 512) zoom = 512;
   if (zoom < 16) zoom = 16;
 
-  lv_obj_set_size(player.imageObj, frameHeader.w, frameHeader.h);
-  lv_img_set_pivot(player.imageObj, frameHeader.w / 2, frameHeader.h / 2);
-  lv_img_set_zoom(player.imageObj, (uint16_t)zoom);
-  lv_obj_center(player.imageObj);
+  wallpaperPendingFrame.valid = true;
+  wallpaperPendingFrame.gen = videoDecodedGen;
+  wallpaperPendingFrame.header = frameHeader;
+  wallpaperPendingFrame.zoom = zoom;
+  wallpaperPendingFrame.viewportW = viewportW;
+  wallpaperPendingFrame.viewportH = viewportH;
+  return true;
+}
+
+// Shows the prepared frame. A paced present goes out on the TE edge or the
+// slot and is refreshed at once; otherwise LVGL picks it up on its own
+// timer. False when there was nothing (still) valid to show.
+static bool presentDynamicWallpaperFrame(DynamicWallpaperPlayer &player, bool paced) {
+  PendingMediaFrame &frame = wallpaperPendingFrame;
+  const bool valid = frame.valid && frame.gen == videoDecodedGen && *player.imageObj != nullptr;
+  frame.valid = false;
+  if (!valid) {
+    return false;
+  }
+
+  lv_obj_t *page = lv_obj_get_parent(*player.imageObj);
+  if (WALLPAPER_COMPOSE_ENABLED && currentPage >= 0 && page == pages[currentPage]) {
+    layerComposeAttach(&wallpaperCompositor, page, *player.imageObj);
+  }
+  const FramePacerSync sync = paced ? waitMediaPresentSlot(*player.imageObj) : FRAME_PACER_TIMER;
+  const uint32_t presentUs = micros();
+  wallpaperCompositor.quiet = true;
+  const lv_img_dsc_t *shown = showZoomedImage(*player.imageObj, wallpaperTransform, &videoDecodedDsc, frame.gen,
+                                              frame.header, frame.zoom, frame.viewportW, frame.viewportH);
+  wallpaperCompositor.quiet = false;
+  layerComposeFrame(&wallpaperCompositor, shown);
+  if (paced) {
+    lv_refr_now(nullptr);
+  }
+  framePacerPresented(&wallpaperPacer, presentUs, sync);
+  return true;
+}
+
+static bool renderNextDynamicWallpaperFrame(DynamicWallpaperPlayer &player, bool allowLoop, char *reason, size_t reasonSize) {
+  if (!prepareNextDynamicWallpaperFrame(player, allowLoop, reason, reasonSize)) {
+    return false;
+  }
+  presentDynamicWallpaperFrame(player, false);
   return true;
 }
 
 static void resetDynamicWallpaperPlayer(DynamicWallpaperPlayer &player) {
   closeDynamicWallpaper(player);
-  player.lastFrameMs = 0;
+  framePacerReset(&wallpaperPacer);
+  wallpaperPendingFrame.valid = false;
   player.slowScore = 0;
   player.fastScore = 0;
   player.failCount = 0;
@@ -1528,6 +1865,7 @@ static bool decodePhotoJpegToTrueColor(lv_img_header_t *header, char *reason, si
   photoDecodedDsc.header.cf = LV_IMG_CF_TRUE_COLOR;
   photoDecodedDsc.data_size = (uint32_t)photoDecodedDataSize;
   photoDecodedDsc.data = photoDecodedData;
+  photoDecodedGen++;
 
   header->always_zero = 0;
   header->w = scaledW;
@@ -1564,6 +1902,7 @@ static bool validatePhotoRawSource(lv_img_header_t *header, char *reason, size_t
 }
 
 static void setPhotoFrameStatus(const char *text, lv_color_t color) {
+  rememberStatusText(photoFrameStatusText, text, color);
   if (photoFrameStatusLabel == nullptr) {
     return;
   }
@@ -1771,41 +2110,30 @@ static bool loadPhotoFileToMemory(const char *path, char *reason, size_t reasonS
   return true;
 }
 
-static void showCurrentPhotoFrame() {
-  if (photoFrameImage == nullptr || photoFrameNameLabel == nullptr || photoFrameIndexLabel == nullptr) {
-    return;
-  }
-
-  if (photoFrameRootLabel != nullptr) {
-    lv_label_set_text_fmt(photoFrameRootLabel, "Root: %s", sdRootPreview);
-  }
+static void clearCurrentPhoto() {
+  currentPhotoValid = false;
+  currentPhotoSrc = nullptr;
+  copyText(currentPhotoName, sizeof(currentPhotoName), "");
+  copyText(currentPhotoPath, sizeof(currentPhotoPath), "");
+  copyText(currentPhotoDecoder, sizeof(currentPhotoDecoder), "-");
+}
 
+// Loads sdPhotoIndex (or the first photo after it that decodes) into memory
+// and updates what photo_state reports. Needs no widgets, so remote control
+// works while the photo page is not built.
+static void loadCurrentPhotoFrame() {
   if (!sdMounted) {
     freePhotoRawData();
-    lv_img_set_src(photoFrameImage, nullptr);
-    lv_label_set_text(photoFrameNameLabel, "No SD card");
-    lv_label_set_text(photoFrameIndexLabel, "0/0");
     setPhotoFrameStatus("SD not mounted", lv_color_hex(0xEF5350));
-    currentPhotoValid = false;
-    copyText(currentPhotoName, sizeof(currentPhotoName), "");
-    copyText(currentPhotoPath, sizeof(currentPhotoPath), "");
-    copyText(currentPhotoDecoder, sizeof(currentPhotoDecoder), "-");
-    updatePhotoFrameNavButtons();
+    clearCurrentPhoto();
     sendPhotoFrameState("no_sd");
     return;
   }
 
   if (sdPhotoCount <= 0) {
     freePhotoRawData();
-    lv_img_set_src(photoFrameImage, nullptr);
-    lv_label_set_text(photoFrameNameLabel, "No JPG/JPEG/SJPG on SD");
-    lv_label_set_text(photoFrameIndexLabel, "0/0");
     setPhotoFrameStatus("Tap Reload to rescan", lv_color_hex(0xFFB74D));
-    currentPhotoValid = false;
-    copyText(currentPhotoName, sizeof(currentPhotoName), "");
-    copyText(currentPhotoPath, sizeof(currentPhotoPath), "");
-    copyText(currentPhotoDecoder, sizeof(currentPhotoDecoder), "-");
-    updatePhotoFrameNavButtons();
+    clearCurrentPhoto();
     sendPhotoFrameState("empty");
     return;
   }
@@ -1865,24 +2193,54 @@ static void showCurrentPhotoFrame() {
 
   if (shownIndex < 0 || shownSrc == nullptr) {
     freePhotoRawData();
-    lv_img_set_src(photoFrameImage, nullptr);
-    lv_label_set_text(photoFrameNameLabel, "No decodable image");
-    lv_label_set_text(photoFrameIndexLabel, "0/0");
     char status[96];
     snprintf(status, sizeof(status), "Decode failed: %s", failReason[0] == '\0' ? "unsupported files" : failReason);
     setPhotoFrameStatus(status, lv_color_hex(0xEF5350));
-    currentPhotoValid = false;
-    copyText(currentPhotoName, sizeof(currentPhotoName), "");
-    copyText(currentPhotoPath, sizeof(currentPhotoPath), "");
-    copyText(currentPhotoDecoder, sizeof(currentPhotoDecoder), "-");
-    updatePhotoFrameNavButtons();
+    clearCurrentPhoto();
     sendPhotoFrameState("decode_fail");
     return;
   }
 
   sdPhotoIndex = shownIndex;
   SdPhotoFile &photo = sdPhotoFiles[sdPhotoIndex];
-  lv_img_set_src(photoFrameImage, shownSrc);
+  Serial.printf("[Photo] loaded %d/%d %s (%dx%d decoder=%s)\n", sdPhotoIndex + 1, sdPhotoCount, photo.path,
+                shownHeader.w, shownHeader.h, shownDecoder);
+
+  char status[64];
+  snprintf(status, sizeof(status), "Photo loaded (%s)", shownDecoder);
+  setPhotoFrameStatus(status, lv_color_hex(0x81C784));
+  currentPhotoValid = true;
+  currentPhotoSrc = (const lv_img_dsc_t *)shownSrc;
+  currentPhotoHeader = shownHeader;
+  copyText(currentPhotoName, sizeof(currentPhotoName), photo.name);
+  copyText(currentPhotoPath, sizeof(currentPhotoPath), photo.path);
+  copyText(currentPhotoDecoder, sizeof(currentPhotoDecoder), shownDecoder);
+  sendPhotoFrameState("show");
+}
+
+// Puts the loaded photo, or why there is none, on the photo page.
+static void applyCurrentPhotoFrame() {
+  if (photoFrameImage == nullptr || photoFrameNameLabel == nullptr || photoFrameIndexLabel == nullptr) {
+    return;
+  }
+
+  if (photoFrameRootLabel != nullptr) {
+    lv_label_set_text_fmt(photoFrameRootLabel, "Root: %s", sdRootPreview);
+  }
+
+  if (!currentPhotoValid || currentPhotoSrc == nullptr) {
+    lv_img_set_src(photoFrameImage, nullptr);
+    if (!sdMounted) {
+      lv_label_set_text(photoFrameNameLabel, "No SD card");
+    } else if (sdPhotoCount <= 0) {
+      lv_label_set_text(photoFrameNameLabel, "No JPG/JPEG/SJPG on SD");
+    } else {
+      lv_label_set_text(photoFrameNameLabel, "No decodable image");
+    }
+    lv_label_set_text(photoFrameIndexLabel, "0/0");
+    updatePhotoFrameNavButtons();
+    return;
+  }
 
   int32_t viewportW = 288;
   int32_t viewportH = 202;
@@ -1893,40 +2251,31 @@ static void showCurrentPhotoFrame() {
     if (h > 0) viewportH = h;
   }
 
-  int32_t zoomW = (viewportW * 256) / shownHeader.w;
-  int32_t zoomH = (viewportH * 256) / shownHeader.h;
+  int32_t zoomW = (viewportW * 256) / currentPhotoHeader.w;
+  int32_t zoomH = (viewportH * 256) / currentPhotoHeader.h;
   int32_t zoom = (zoomW < zoomH) ? zoomW : zoomH;
   if (zoom > 256) zoom = 256;
   if (zoom < 16) zoom = 16;
 
-  lv_obj_set_size(photoFrameImage, shownHeader.w, shownHeader.h);
-  lv_img_set_pivot(photoFrameImage, shownHeader.w / 2, shownHeader.h / 2);
-  lv_img_set_zoom(photoFrameImage, (uint16_t)zoom);
-  lv_obj_center(photoFrameImage);
-  Serial.printf(
-    "[Photo] showing %d/%d %s (%dx%d zoom=%ld viewport=%ldx%ld decoder=%s)\n",
-    sdPhotoIndex + 1,
-    sdPhotoCount,
-    photo.path,
-    shownHeader.w,
-    shownHeader.h,
-    (long)zoom,
-    (long)viewportW,
-    (long)viewportH,
-    shownDecoder
-  );
+  showZoomedImage(photoFrameImage, photoFrameTransform, currentPhotoSrc, photoDecodedGen, currentPhotoHeader, zoom,
+                  viewportW, viewportH);
+  Serial.printf("[Photo] showing %s (zoom=%ld viewport=%ldx%ld)\n", currentPhotoPath, (long)zoom, (long)viewportW,
+                (long)viewportH);
 
-  lv_label_set_text(photoFrameNameLabel, photo.name);
+  lv_label_set_text(photoFrameNameLabel, currentPhotoName);
   lv_label_set_text_fmt(photoFrameIndexLabel, "%d/%d", sdPhotoIndex + 1, sdPhotoCount);
-  char status[64];
-  snprintf(status, sizeof(status), "Photo loaded (%s)", shownDecoder);
-  setPhotoFrameStatus(status, lv_color_hex(0x81C784));
-  currentPhotoValid = true;
-  copyText(currentPhotoName, sizeof(currentPhotoName), photo.name);
-  copyText(currentPhotoPath, sizeof(currentPhotoPath), photo.path);
-  copyText(currentPhotoDecoder, sizeof(currentPhotoDecoder), shownDecoder);
   updatePhotoFrameNavButtons();
-  sendPhotoFrameState("show");
+}
+
+// SD events only reload the photo while the page is built; the page loads
+// it when shown. Remote control passes loadWithoutPage so that photo_state
+// reports the photo it moved to.
+static void showCurrentPhotoFrame(bool loadWithoutPage) {
+  if (photoFrameImage == nullptr && !loadWithoutPage) {
+    return;
+  }
+  loadCurrentPhotoFrame();
+  applyCurrentPhotoFrame();
 }
 
 static void photoFrameControlCallback(lv_event_t *e) {
@@ -1964,6 +2313,7 @@ static void photoFrameControlCallback(lv_event_t *e) {
 }
 
 static void setVideoStatus(const char *text, lv_color_t color) {
+  rememberStatusText(videoStatusText, text, color);
   if (videoStatusLabel == nullptr) {
     return;
   }
@@ -2281,6 +2631,7 @@ static bool decodeVideoJpegToTrueColor(const uint8_t *jpegData, size_t jpegSize,
   videoDecodedDsc.header.cf = LV_IMG_CF_TRUE_COLOR;
   videoDecodedDsc.data_size = (uint32_t)requiredBytes;
   videoDecodedDsc.data = videoDecodedData;
+  videoDecodedGen++;
 
   header->always_zero = 0;
   header->w = scaledW;
@@ -2454,7 +2805,9 @@ static void clearBootSplashOverlay() {
   }
 }
 
-static bool renderNextVideoFrame(bool allowLoop, char *reason, size_t reasonSize) {
+// Reads and decodes the next frame into videoPendingFrame; it is shown by
+// presentVideoFrame().
+static bool prepareNextVideoFrame(bool allowLoop, char *reason, size_t reasonSize) {
   if (reason != nullptr && reasonSize > 0) {
     reason[0] = '\0';
   }
@@ -2494,10 +2847,10 @@ static bool renderNextVideoFrame(bool allowLoop, char *reason, size_t reasonSize
   }
 
   videoFrameDataSize = frameSize;
+  videoPendingFrame.valid = true;
+  videoPendingFrame.gen = videoDecodedGen;
+  videoPendingFrame.header = frameHeader;
   if (videoImage != nullptr) {
-    lv_img_set_src(videoImage, nullptr);
-    lv_img_set_src(videoImage, (const void *)&videoDecodedDsc);
-
     int32_t viewportW = 288;
     int32_t viewportH = 196;
     if (videoViewport != nullptr) {
@@ -2513,11 +2866,41 @@ static bool renderNextVideoFrame(bool allowLoop, char *reason, size_t reasonSize
     if (zoom > 256) zoom = 256;
     if (zoom < 16) zoom = 16;
 
-    lv_obj_set_size(videoImage, frameHeader.w, frameHeader.h);
-    lv_img_set_pivot(videoImage, frameHeader.w / 2, frameHeader.h / 2);
-    lv_img_set_zoom(videoImage, (uint16_t)zoom);
-    lv_obj_center(videoImage);
+    videoPendingFrame.zoom = zoom;
+    videoPendingFrame.viewportW = viewportW;
+    videoPendingFrame.viewportH = viewportH;
+  }
+  return true;
+}
+
+// Same as presentDynamicWallpaperFrame(), for the video page.
+static bool presentVideoFrame(bool paced) {
+  PendingMediaFrame &frame = videoPendingFrame;
+  const bool valid = frame.valid && frame.gen == videoDecodedGen;
+  frame.valid = false;
+  if (!valid) {
+    return false;
+  }
+
+  // Without the page built the frame is dropped but still keeps the cadence.
+  const FramePacerSync sync = paced ? waitMediaPresentSlot(videoImage) : FRAME_PACER_TIMER;
+  const uint32_t presentUs = micros();
+  if (videoImage != nullptr) {
+    showZoomedImage(videoImage, videoTransform, &videoDecodedDsc, frame.gen, frame.header, frame.zoom,
+                    frame.viewportW, frame.viewportH);
+    if (paced) {
+      lv_refr_now(nullptr);
+    }
+  }
+  framePacerPresented(&videoPacer, presentUs, sync);
+  return true;
+}
+
+static bool renderNextVideoFrame(bool allowLoop, char *reason, size_t reasonSize) {
+  if (!prepareNextVideoFrame(allowLoop, reason, reasonSize)) {
+    return false;
   }
+  presentVideoFrame(false);
   return true;
 }
 
@@ -2528,7 +2911,8 @@ static void stopVideoPlayback(bool keepStatus) {
   videoPlaying = false;
   videoPaused = false;
   videoFrameDataSize = 0;
-  videoLastFrameMs = 0;
+  framePacerReset(&videoPacer);
+  videoPendingFrame.valid = false;
   updateVideoControlButtons(sdVideoCount > 0);
 
   if (!keepStatus) {
@@ -2617,7 +3001,7 @@ static bool startVideoPlayback(int index) {
   sdVideoIndex = index;
   videoPlaying = true;
   videoPaused = false;
-  videoLastFrameMs = 0;
+  framePacerReset(&videoPacer);
 
   char reason[64];
   if (!renderNextVideoFrame(true, reason, sizeof(reason))) {
@@ -2629,7 +3013,6 @@ static bool startVideoPlayback(int index) {
   }
 
   showCurrentVideoTrack();
-  videoLastFrameMs = millis();
   pushInboxMessage("event", "Video playback", sdVideoFiles[sdVideoIndex].name);
   return true;
 }
@@ -2639,21 +3022,29 @@ static void processVideoPlayback() {
     return;
   }
 
-  uint32_t now = millis();
-  if (videoLastFrameMs != 0 && (uint32_t)(now - videoLastFrameMs) < videoFrameIntervalMs) {
-    return;
+  framePacerSetPeriod(&videoPacer, videoFrameIntervalMs, lcd_te_period());
+  if (videoPendingFrame.valid && videoPendingFrame.gen != videoDecodedGen) {
+    videoPendingFrame.valid = false;    // the wallpaper decoded over it
   }
-
-  char reason[64];
-  if (!renderNextVideoFrame(true, reason, sizeof(reason))) {
-    stopVideoPlayback(true);
-    char status[88];
-    snprintf(status, sizeof(status), "Playback stopped: %s", reason[0] == '\0' ? "decode error" : reason);
-    setVideoStatus(status, lv_color_hex(0xEF5350));
-    return;
+  if (!videoPendingFrame.valid) {
+    const uint32_t startUs = micros();
+    if (!mediaPrepareDue(videoPacer, videoImage, startUs)) {
+      return;
+    }
+    char reason[64];
+    if (!prepareNextVideoFrame(true, reason, sizeof(reason))) {
+      stopVideoPlayback(true);
+      char status[88];
+      snprintf(status, sizeof(status), "Playback stopped: %s", reason[0] == '\0' ? "decode error" : reason);
+      setVideoStatus(status, lv_color_hex(0xEF5350));
+      return;
+    }
+    framePacerNoteWork(&videoPacer, micros() - startUs);
   }
 
-  videoLastFrameMs = now;
+  if (framePacerPresentDue(&videoPacer, micros())) {
+    presentVideoFrame(true);
+  }
 }
 
 static void processPendingVideoControl() {
@@ -2696,7 +3087,7 @@ static void processPendingVideoControl() {
   if (videoPaused) {
     setVideoStatus("Paused", lv_color_hex(0xFFB74D));
   } else {
-    videoLastFrameMs = 0;
+    framePacerReset(&videoPacer);
     setVideoStatus("Playing MJPEG", lv_color_hex(0x81C784));
   }
   updateVideoControlButtons(true);
@@ -2848,9 +3239,13 @@ static void prepareDynamicWallpaperForPage(int pageIndex, bool forceFrame) {
     other = &homeWallpaper;
   }
 
+  // The overlay is rebuilt for the page on its first frame; widgets that
+  // changed while it was hidden were never seen invalidating.
+  layerComposeDetach(&wallpaperCompositor);
   if (target == nullptr) {
     resetDynamicWallpaperPlayer(homeWallpaper);
     resetDynamicWallpaperPlayer(clockWallpaper);
+    layerComposeFree(&wallpaperCompositor);
     return;
   }
 
@@ -2858,7 +3253,7 @@ static void prepareDynamicWallpaperForPage(int pageIndex, bool forceFrame) {
     closeDynamicWallpaper(*other);
   }
 
-  if (!target->enabled || target->path[0] == '\0' || target->imageObj == nullptr) {
+  if (!target->enabled || target->path[0] == '\0' || *target->imageObj == nullptr) {
     return;
   }
 
@@ -2868,17 +3263,18 @@ static void prepareDynamicWallpaperForPage(int pageIndex, bool forceFrame) {
 
   if (forceFrame) {
     char reason[64];
+    framePacerReset(&wallpaperPacer);
     if (!renderNextDynamicWallpaperFrame(*target, true, reason, sizeof(reason))) {
       Serial.printf("[Wallpaper] initial frame failed (%s): %s\n", target->path, reason);
       target->failCount = 1;
     } else {
-      target->lastFrameMs = millis();
       target->failCount = 0;
     }
   }
 }
 
 static void processDynamicWallpapers() {
+  layerComposeService(&wallpaperCompositor);
   DynamicWallpaperPlayer *player = nullptr;
   if (currentPage == UI_PAGE_HOME) {
     player = &homeWallpaper;
@@ -2888,7 +3284,7 @@ static void processDynamicWallpapers() {
     return;
   }
 
-  if (player == nullptr || !player->enabled || player->imageObj == nullptr) {
+  if (player == nullptr || !player->enabled || *player->imageObj == nullptr) {
     return;
   }
 
@@ -2906,26 +3302,40 @@ static void processDynamicWallpapers() {
     effectiveInterval = 280;
   }
 
-  if (player->lastFrameMs != 0 && (uint32_t)(now - player->lastFrameMs) < effectiveInterval) {
+  framePacerSetPeriod(&wallpaperPacer, effectiveInterval, lcd_te_period());
+  if (wallpaperPendingFrame.valid && wallpaperPendingFrame.gen != videoDecodedGen) {
+    wallpaperPendingFrame.valid = false;    // a video frame decoded over it
+  }
+  if (wallpaperPendingFrame.valid) {
+    if (framePacerPresentDue(&wallpaperPacer, micros())) {
+      presentDynamicWallpaperFrame(*player, true);
+    }
+    return;
+  }
+  if (!mediaPrepareDue(wallpaperPacer, *player->imageObj, micros())) {
     return;
   }
 
   uint32_t startMs = millis();
   char reason[64];
-  bool ok = renderNextDynamicWallpaperFrame(*player, true, reason, sizeof(reason));
+  bool ok = prepareNextDynamicWallpaperFrame(*player, true, reason, sizeof(reason));
   uint32_t decodeMs = millis() - startMs;
   if (!ok) {
     player->failCount++;
     if (player->failCount >= 3) {
       Serial.printf("[Wallpaper] disabled after repeated failure (%s): %s\n", player->path, reason);
       player->enabled = false;
+      layerComposeDetach(&wallpaperCompositor);
       closeDynamicWallpaper(*player);
     }
     return;
   }
 
   player->failCount = 0;
-  player->lastFrameMs = millis();
+  framePacerNoteWork(&wallpaperPacer, decodeMs * 1000U);
+  if (framePacerPresentDue(&wallpaperPacer, micros())) {
+    presentDynamicWallpaperFrame(*player, true);
+  }
 
   bool slowFrame = decodeMs >= (uint32_t)(effectiveInterval * 8 / 10) || decodeMs > 110;
   bool fastFrame = decodeMs <= (uint32_t)(effectiveInterval / 3);
@@ -2951,20 +3361,14 @@ static void processDynamicWallpapers() {
 }
 
 static bool isAudioRunning() {
-  if (audioMp3 != nullptr && audioMp3->isRunning()) {
-    return true;
-  }
-  if (audioWav != nullptr && audioWav->isRunning()) {
-    return true;
-  }
-  return false;
+  return audioEngineRunning;
 }
 
 static bool readFileExact(File &file, uint8_t *buf, size_t len) {
   if (buf == nullptr || len == 0) {
     return false;
   }
-  return file.read(buf, len) == (int)len;
+  return file.read(buf, len) == len;
 }
 
 static uint16_t readLe16(const uint8_t *buf) {
@@ -2987,119 +3391,137 @@ static void formatAudioTimeMMSS(uint32_t sec, char *out, size_t outSize) {
   snprintf(out, outSize, "%02u:%02u", (unsigned)m, (unsigned)s);
 }
 
-static int mp3BitrateKbpsFromHeader(const uint8_t h[4]) {
-  if (h == nullptr) {
-    return 0;
+static void cancelAudioIndexScan() {
+  if (audioIndexScan.index < 0) {
+    return;
   }
-  if (h[0] != 0xFF || (h[1] & 0xE0) != 0xE0) {
-    return 0;
+  audioIndexScan.file.close();
+  // Probe again next time the track is shown.
+  if (audioIndexScan.index < sdAudioCount) {
+    sdAudioFiles[audioIndexScan.index].durationChecked = false;
   }
+  audioIndexScan.index = -1;
+}
 
-  const int versionBits = (h[1] >> 3) & 0x03;
-  const int layerBits = (h[1] >> 1) & 0x03;
-  const int bitrateIdx = (h[2] >> 4) & 0x0F;
-  const int sampleRateIdx = (h[2] >> 2) & 0x03;
-  if (versionBits == 1 || layerBits == 0 || bitrateIdx == 0 || bitrateIdx == 15 || sampleRateIdx == 3) {
-    return 0;
+static bool ensureAudioIndexScanBuffers() {
+  if (audioIndexScan.scanner == nullptr) {
+    audioIndexScan.scanner = (Mp3FrameScanner *)heap_caps_malloc(sizeof(Mp3FrameScanner), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
   }
-
-  int layer = 0;
-  if (layerBits == 3) {
-    layer = 1;
-  } else if (layerBits == 2) {
-    layer = 2;
-  } else {
-    layer = 3;
+  if (audioIndexScan.buffer == nullptr) {
+    audioIndexScan.buffer = (uint8_t *)heap_caps_malloc(AUDIO_INDEX_SCAN_BLOCK_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
   }
+  return audioIndexScan.scanner != nullptr && audioIndexScan.buffer != nullptr;
+}
 
-  static const int BITRATE_MPEG1_L1[16] = {0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0};
-  static const int BITRATE_MPEG1_L2[16] = {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0};
-  static const int BITRATE_MPEG1_L3[16] = {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0};
-  static const int BITRATE_MPEG2_L1[16] = {0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0};
-  static const int BITRATE_MPEG2_L2L3[16] = {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0};
-
-  const bool isMpeg1 = versionBits == 3;
-  if (isMpeg1) {
-    if (layer == 1) return BITRATE_MPEG1_L1[bitrateIdx];
-    if (layer == 2) return BITRATE_MPEG1_L2[bitrateIdx];
-    return BITRATE_MPEG1_L3[bitrateIdx];
-  }
-
-  if (layer == 1) return BITRATE_MPEG2_L1[bitrateIdx];
-  return BITRATE_MPEG2_L2L3[bitrateIdx];
+static bool storeMp3SeekIndex(SdAudioFile &item, const Mp3SeekIndex &index) {
+  if (item.seekIndex == nullptr) {
+    item.seekIndex = (Mp3SeekIndex *)heap_caps_malloc(sizeof(Mp3SeekIndex), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (item.seekIndex == nullptr) {
+      return false;
+    }
+  }
+  *item.seekIndex = index;
+  item.durationSec = (index.durationMs + 500U) / 1000U;
+  item.durationEstimated = false;
+  return true;
 }
 
-static uint32_t estimateMp3DurationSec(const char *path, uint32_t fileSize, bool *estimated) {
-  if (estimated != nullptr) {
-    *estimated = true;
-  }
-  if (path == nullptr || path[0] == '\0' || fileSize == 0) {
+// Exact duration from a Xing/Info or VBRI tag when there is one. Otherwise
+// returns a CBR estimate from the first frame and queues a frame scan.
+static uint32_t probeMp3Duration(int index, bool *estimated) {
+  SdAudioFile &item = sdAudioFiles[index];
+  *estimated = true;
+  if (!ensureAudioIndexScanBuffers()) {
     return 0;
   }
+  cancelAudioIndexScan();
 
-  File file = SD_MMC.open(path, FILE_READ);
+  File file = SD_MMC.open(item.path, FILE_READ);
   if (!file) {
-    return (uint32_t)((fileSize * 8ULL + 64000ULL) / 128000ULL);
-  }
-
-  uint32_t payloadSize = fileSize;
-  uint8_t id3Head[10];
-  if (readFileExact(file, id3Head, sizeof(id3Head))) {
-    if (id3Head[0] == 'I' && id3Head[1] == 'D' && id3Head[2] == '3') {
-      uint32_t tagSize = ((uint32_t)(id3Head[6] & 0x7F) << 21)
-        | ((uint32_t)(id3Head[7] & 0x7F) << 14)
-        | ((uint32_t)(id3Head[8] & 0x7F) << 7)
-        | (uint32_t)(id3Head[9] & 0x7F);
-      uint32_t skip = 10 + tagSize;
-      if ((id3Head[5] & 0x10) != 0) {
-        skip += 10; // footer
-      }
-      if (skip < fileSize) {
-        payloadSize = fileSize - skip;
-      }
-      file.seek(skip);
-    } else {
-      file.seek(0);
-    }
-  } else {
-    file.seek(0);
+    return (uint32_t)((item.size * 8ULL + 64000ULL) / 128000ULL);
   }
 
-  int bitrateKbps = 0;
-  uint8_t scanBuf[768];
-  int carry = 0;
-  uint8_t header[4];
-  while (bitrateKbps <= 0 && file.available()) {
-    int n = file.read(scanBuf + carry, sizeof(scanBuf) - carry);
-    if (n <= 0) {
-      break;
-    }
-    n += carry;
+  uint8_t *buf = audioIndexScan.buffer;
+  uint32_t streamEnd = item.size;
+  if (item.size > 128 && file.seek(item.size - 128) && file.read(buf, 3) == 3 && memcmp(buf, "TAG", 3) == 0) {
+    streamEnd -= 128;
+  }
+  uint32_t start = 0;
+  if (file.seek(0) && readFileExact(file, buf, 10)) {
+    start = mp3Id3v2Size(buf);
+  }
+  if (start >= streamEnd || !file.seek(start)) {
+    file.close();
+    return 0;
+  }
 
-    for (int i = 0; i + 3 < n; ++i) {
-      header[0] = scanBuf[i];
-      header[1] = scanBuf[i + 1];
-      header[2] = scanBuf[i + 2];
-      header[3] = scanBuf[i + 3];
-      bitrateKbps = mp3BitrateKbpsFromHeader(header);
-      if (bitrateKbps > 0) {
-        break;
-      }
-    }
+  const int n = file.read(buf, AUDIO_INDEX_SCAN_BLOCK_BYTES);
+  Mp3FrameInfo info;
+  const int at = (n > 0) ? mp3FindFrame(buf, (size_t)n, &info) : -1;
+  if (at < 0) {
+    file.close();
+    return 0;
+  }
+
+  Mp3SeekIndex seekIndex;
+  const uint32_t frameOffset = start + (uint32_t)at;
+  if (mp3ParseVbrTag(buf + at, (size_t)(n - at), info, frameOffset, streamEnd, &seekIndex) &&
+      storeMp3SeekIndex(item, seekIndex)) {
+    file.close();
+    *estimated = false;
+    return item.durationSec;
+  }
+
+  mp3ScanBegin(audioIndexScan.scanner, frameOffset, streamEnd);
+  audioIndexScan.file = file;
+  audioIndexScan.index = index;
+  audioIndexScan.startedMs = millis();
+  const uint64_t bits = (uint64_t)(streamEnd - frameOffset) * 8ULL;
+  const uint64_t bitsPerSec = (uint64_t)info.bitrateKbps * 1000ULL;
+  return (uint32_t)((bits + bitsPerSec / 2ULL) / bitsPerSec);
+}
+
+static void processAudioIndexScan() {
+  if (audioIndexScan.index < 0) {
+    return;
+  }
 
-    carry = n >= 3 ? 3 : n;
-    if (carry > 0) {
-      memmove(scanBuf, scanBuf + n - carry, carry);
+  Mp3FrameScanner *scanner = audioIndexScan.scanner;
+  const uint32_t sliceStart = millis();
+  while (!scanner->done && (uint32_t)(millis() - sliceStart) < AUDIO_INDEX_SCAN_BUDGET_MS) {
+    if (!audioIndexScan.file.seek(scanner->nextOffset)) {
+      scanner->done = true;
+      break;
+    }
+    const int n = audioIndexScan.file.read(audioIndexScan.buffer, AUDIO_INDEX_SCAN_BLOCK_BYTES);
+    if (n < 4) {
+      scanner->done = true;
+      break;
     }
+    mp3ScanFeed(scanner, audioIndexScan.buffer, (size_t)n);
+  }
+  if (!scanner->done) {
+    return;
   }
-  file.close();
 
-  if (bitrateKbps <= 0) {
-    bitrateKbps = 128;
+  const int index = audioIndexScan.index;
+  audioIndexScan.file.close();
+  audioIndexScan.index = -1;
+  Mp3SeekIndex seekIndex;
+  if (index >= sdAudioCount || !mp3ScanFinish(scanner, &seekIndex) || !storeMp3SeekIndex(sdAudioFiles[index], seekIndex)) {
+    return;
+  }
+  Serial.printf(
+    "[Audio] indexed %s: frames=%lu resyncs=%lu duration=%lums in %lums\n",
+    sdAudioFiles[index].name,
+    (unsigned long)scanner->frames,
+    (unsigned long)scanner->resyncs,
+    (unsigned long)seekIndex.durationMs,
+    (unsigned long)(millis() - audioIndexScan.startedMs)
+  );
+  if (index == sdAudioIndex) {
+    refreshAudioTimeLabel(true);
   }
-  uint64_t bits = (uint64_t)payloadSize * 8ULL;
-  uint64_t denom = (uint64_t)bitrateKbps * 1000ULL;
-  return (uint32_t)((bits + denom / 2ULL) / denom);
 }
 
 static uint32_t wavDurationSec(const char *path, bool *estimated) {
@@ -3202,7 +3624,7 @@ static void ensureAudioTrackDuration(int index) {
   if (isWav) {
     duration = wavDurationSec(item.path, &estimated);
   } else {
-    duration = estimateMp3DurationSec(item.path, item.size, &estimated);
+    duration = probeMp3Duration(index, &estimated);
   }
 
   item.durationSec = duration;
@@ -3226,6 +3648,10 @@ static void refreshAudioTimeLabel(bool force) {
     lv_label_set_text(audioTimeLabel, "--:-- / --:--");
     audioShownElapsedSec = 0xFFFFFFFF;
     audioShownDurationSec = 0xFFFFFFFF;
+    if (audioSeekSlider != nullptr) {
+      lv_slider_set_value(audioSeekSlider, 0, LV_ANIM_OFF);
+      lv_obj_add_state(audioSeekSlider, LV_STATE_DISABLED);
+    }
     return;
   }
 
@@ -3262,9 +3688,74 @@ static void refreshAudioTimeLabel(bool force) {
   lv_label_set_text(audioTimeLabel, line);
   audioShownElapsedSec = elapsedSec;
   audioShownDurationSec = durationSec;
+
+  if (audioSeekSlider != nullptr) {
+    const bool seekable = isAudioRunning() && item.seekIndex != nullptr && item.seekIndex->durationMs > 0;
+    if (seekable) {
+      lv_obj_clear_state(audioSeekSlider, LV_STATE_DISABLED);
+    } else {
+      lv_obj_add_state(audioSeekSlider, LV_STATE_DISABLED);
+    }
+    if (!audioSeekDragging) {
+      uint32_t permille = 0;
+      if (seekable) {
+        const uint64_t elapsedMs = currentAudioElapsedMs();
+        permille = (uint32_t)(elapsedMs * 1000ULL / item.seekIndex->durationMs);
+      }
+      lv_slider_set_value(audioSeekSlider, (permille > 1000U) ? 1000 : (int32_t)permille, LV_ANIM_OFF);
+    }
+  }
+}
+
+// MP3 only: moves the read position of the playing track. The decoder
+// resyncs on the next frame header, so the jump may carry one bad frame.
+static bool seekAudioPlayback(uint32_t targetMs) {
+  if (!isAudioRunning() || sdAudioIndex < 0 || sdAudioIndex >= sdAudioCount) {
+    return false;
+  }
+  const Mp3SeekIndex *seekIndex = sdAudioFiles[sdAudioIndex].seekIndex;
+  if (seekIndex == nullptr) {
+    return false;
+  }
+
+  const uint32_t offset = mp3SeekOffset(seekIndex, targetMs);
+  xSemaphoreTake(audioEngineLock, portMAX_DELAY);
+  AudioTrackSlot &slot = audioSlots[audioCurrentSlot];
+  const bool ok = slot.index == sdAudioIndex && slot.buffer != nullptr && slot.buffer->seek((int32_t)offset, SEEK_SET);
+  xSemaphoreGive(audioEngineLock);
+  if (!ok) {
+    return false;
+  }
+
+  audioElapsedAccumMs = targetMs;
+  audioPlaybackResumeMs = audioPaused ? 0 : millis();
+  refreshAudioTimeLabel(true);
+  return true;
+}
+
+static void audioSeekSliderCallback(lv_event_t *e) {
+  const lv_event_code_t code = lv_event_get_code(e);
+  if (code == LV_EVENT_PRESSED) {
+    audioSeekDragging = true;
+    return;
+  }
+  if (code != LV_EVENT_RELEASED && code != LV_EVENT_PRESS_LOST) {
+    return;
+  }
+  audioSeekDragging = false;
+  if (sdAudioIndex < 0 || sdAudioIndex >= sdAudioCount || sdAudioFiles[sdAudioIndex].seekIndex == nullptr) {
+    return;
+  }
+
+  const int32_t permille = lv_slider_get_value(lv_event_get_target(e));
+  const uint32_t targetMs = (uint32_t)((uint64_t)sdAudioFiles[sdAudioIndex].seekIndex->durationMs * permille / 1000U);
+  if (!seekAudioPlayback(targetMs)) {
+    refreshAudioTimeLabel(true);
+  }
 }
 
 static void setAudioStatus(const char *text, lv_color_t color) {
+  rememberStatusText(audioStatusText, text, color);
   if (audioStatusLabel == nullptr) {
     return;
   }
@@ -3351,6 +3842,7 @@ static void addAudioCandidate(const char *path, uint32_t size) {
   sdAudioFiles[sdAudioCount].durationSec = 0;
   sdAudioFiles[sdAudioCount].durationChecked = false;
   sdAudioFiles[sdAudioCount].durationEstimated = true;
+  sdAudioFiles[sdAudioCount].seekIndex = nullptr;
   sdAudioCount++;
 }
 
@@ -3397,31 +3889,169 @@ static void scanAudioDirectoryRecursive(const char *dirPath, int depth) {
   dir.close();
 }
 
-static void stopAudioPlayback(bool keepStatus) {
-  if (audioMp3 != nullptr) {
-    if (audioMp3->isRunning()) {
-      audioMp3->stop();
+static bool audioPathIsWav(const char *path) {
+  return strstr(path, ".wav") != nullptr || strstr(path, ".WAV") != nullptr;
+}
+
+static void audioSlotRelease(AudioTrackSlot &slot) {
+  if (slot.generator != nullptr) {
+    if (slot.generator->isRunning()) {
+      slot.generator->stop();
     }
-    delete audioMp3;
-    audioMp3 = nullptr;
+    delete slot.generator;
+    slot.generator = nullptr;
   }
-  if (audioWav != nullptr) {
-    if (audioWav->isRunning()) {
-      audioWav->stop();
-    }
-    delete audioWav;
-    audioWav = nullptr;
+  if (slot.buffer != nullptr) {
+    delete slot.buffer;
+    slot.buffer = nullptr;
   }
-  if (audioFileSource != nullptr) {
-    delete audioFileSource;
-    audioFileSource = nullptr;
+  if (slot.file != nullptr) {
+    delete slot.file;
+    slot.file = nullptr;
   }
-  if (audioBufferedSource != nullptr) {
-    delete audioBufferedSource;
-    audioBufferedSource = nullptr;
+  slot.index = -1;
+}
+
+// Opens the file and read-ahead buffer and creates the decoder; begin() is
+// left to the caller so a preloaded slot can start exactly at the switch.
+static bool audioSlotOpen(AudioTrackSlot &slot, int index) {
+  const char *path = sdAudioFiles[index].path;
+  slot.file = new AudioFileSourceFS(SD_MMC, path);
+  if (slot.file == nullptr || !slot.file->isOpen()) {
+    audioSlotRelease(slot);
+    return false;
   }
 
-  if (audioOutputReady) {
+  if (slot.storage == nullptr) {
+    slot.storage = (uint8_t *)heap_caps_malloc(AUDIO_SOURCE_BUFFER_BYTES, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  }
+  slot.buffer = (slot.storage != nullptr)
+    ? new AudioFileSourceBuffer(slot.file, slot.storage, AUDIO_SOURCE_BUFFER_BYTES)
+    : new AudioFileSourceBuffer(slot.file, 4096);
+  if (audioPathIsWav(path)) {
+    slot.generator = new AudioGeneratorWAV();
+  } else {
+    slot.generator = new AudioGeneratorMP3();
+  }
+  if (slot.buffer == nullptr || slot.generator == nullptr) {
+    audioSlotRelease(slot);
+    return false;
+  }
+  slot.index = index;
+  return true;
+}
+
+// Engine side, lock held: the current track ended. Start the preloaded one
+// on the still-open output, or report the end to the loop task.
+static void audioEngineAdvance() {
+  const uint8_t nextSlot = audioCurrentSlot ^ 1;
+  AudioTrackSlot &next = audioSlots[nextSlot];
+  audioSlotRelease(audioSlots[audioCurrentSlot]);
+
+  if (next.generator != nullptr && next.generator->begin(next.buffer, audioGaplessOutput)) {
+    audioCurrentSlot = nextSlot;
+    audioNextIndex = -1;
+    audioTrackStartedMs = millis();
+    audioGaplessSwitches++;
+    audioEngineEnteredTrack.store(next.index, std::memory_order_release);
+    return;
+  }
+
+  audioSlotRelease(next);
+  audioEngineRunning = false;
+  audioEngineFinished.store(true, std::memory_order_release);
+}
+
+// Engine side, lock held: feeds the desktop stream until the DMA queue is full.
+static void netAudioFeed() {
+  for (;;) {
+    if (netAudioPullPos >= NET_AUDIO_PULL_SAMPLES) {
+      portENTER_CRITICAL(&netAudioMux);
+      jitterBufferPull(&netAudioJitter, netAudioPullBuffer, NET_AUDIO_PULL_SAMPLES);
+      const bool ended = netAudioJitter.state == JB_STATE_ENDED;
+      const bool playing = netAudioJitter.stats.samplesPlayed > 0;
+      portEXIT_CRITICAL(&netAudioMux);
+      netAudioPullPos = 0;
+      if (playing && netAudioFirstAudioMs.load(std::memory_order_relaxed) == 0) {
+        netAudioFirstAudioMs.store(millis() | 1, std::memory_order_release);
+      }
+      if (ended) {
+        netAudioDrained.store(true, std::memory_order_release);
+      }
+    }
+    int16_t sample[2] = {netAudioPullBuffer[netAudioPullPos], netAudioPullBuffer[netAudioPullPos]};
+    if (!audioGaplessOutput->ConsumeSample(sample)) {
+      return;
+    }
+    netAudioPullPos++;
+  }
+}
+
+static void audioEngineTask(void *arg) {
+  (void)arg;
+  for (;;) {
+    bool decoded = false;
+    xSemaphoreTake(audioEngineLock, portMAX_DELAY);
+    AudioTrackSlot &current = audioSlots[audioCurrentSlot];
+    if (netAudioRunning) {
+      netAudioFeed();
+      audioGaplessOutput->checkUnderrun();
+      decoded = true;
+    } else if (audioEngineRunning && !audioPaused && current.generator != nullptr) {
+      const uint32_t passStart = micros();
+      const bool more = current.generator->isRunning() && current.generator->loop();
+      const uint32_t passUs = micros() - passStart;
+      if (passUs > audioEnginePassMaxUs) {
+        audioEnginePassMaxUs = passUs;
+      }
+      audioGaplessOutput->checkUnderrun();
+      decoded = true;
+
+      AudioTrackSlot &next = audioSlots[audioCurrentSlot ^ 1];
+      if (!more) {
+        audioEngineAdvance();
+      } else if (audioNextIndex >= 0 && next.generator == nullptr &&
+                 (uint32_t)(millis() - audioTrackStartedMs) >= AUDIO_PRELOAD_AFTER_MS) {
+        if (audioSlotOpen(next, audioNextIndex)) {
+          next.buffer->loop();   // prime the read-ahead while the DMA is full
+        } else {
+          audioPreloadFailures++;
+          audioNextIndex = -1;
+        }
+      }
+    }
+    xSemaphoreGive(audioEngineLock);
+    // A pass returns once the DMA queue is full; one tick is well inside it.
+    vTaskDelay(decoded ? 1 : pdMS_TO_TICKS(20));
+  }
+}
+
+static void stopAudioPlayback(bool keepStatus) {
+  if (audioEngineLock != nullptr) {
+    xSemaphoreTake(audioEngineLock, portMAX_DELAY);
+    const bool wasRunning = audioEngineRunning;
+    audioEngineRunning = false;
+    audioSlotRelease(audioSlots[0]);
+    audioSlotRelease(audioSlots[1]);
+    audioNextIndex = -1;
+    if (audioGaplessOutput != nullptr && !netAudioRunning) {
+      audioGaplessOutput->close();
+    }
+    xSemaphoreGive(audioEngineLock);
+    audioEngineEnteredTrack.store(-1, std::memory_order_relaxed);
+    audioEngineFinished.store(false, std::memory_order_relaxed);
+    if (wasRunning) {
+      Serial.printf(
+        "[Audio] engine: underruns=%lu gapless=%lu preloadFail=%lu passMaxUs=%lu\n",
+        (unsigned long)audioGaplessOutput->underruns(),
+        (unsigned long)audioGaplessSwitches,
+        (unsigned long)audioPreloadFailures,
+        (unsigned long)audioEnginePassMaxUs
+      );
+    }
+  }
+
+  if (audioOutputReady && !netAudioActive) {
     digitalWrite(AUDIO_MUTE_PIN, LOW);
   }
   audioPaused = false;
@@ -3448,7 +4078,7 @@ static bool ensureAudioOutputReady() {
     audioOutput = nullptr;
   }
 
-  audioOutput = new AudioOutputI2S();
+  audioOutput = new AudioOutputI2S(0, AudioOutputI2S::EXTERNAL_I2S, AUDIO_DMA_BUF_COUNT);
   if (audioOutput == nullptr) {
     setAudioStatus("Audio output init failed", lv_color_hex(0xEF5350));
     return false;
@@ -3458,6 +4088,29 @@ static bool ensureAudioOutputReady() {
   audioOutput->SetGain(0.18f);
   pinMode(AUDIO_MUTE_PIN, OUTPUT);
   digitalWrite(AUDIO_MUTE_PIN, LOW);
+
+  if (audioGaplessOutput != nullptr) {
+    delete audioGaplessOutput;
+  }
+  audioGaplessOutput = new AudioOutputGapless(audioOutput);
+  if (audioEngineLock == nullptr) {
+    audioEngineLock = xSemaphoreCreateMutex();
+  }
+  if (audioGaplessOutput == nullptr || audioEngineLock == nullptr) {
+    setAudioStatus("Audio output init failed", lv_color_hex(0xEF5350));
+    return false;
+  }
+  // Core 0, away from LVGL and the mic capture task on core 1.
+  if (audioEngineTaskHandle == nullptr &&
+      xTaskCreatePinnedToCore(audioEngineTask, "audio_eng", 8192, nullptr, AUDIO_ENGINE_TASK_PRIORITY, &audioEngineTaskHandle, 0) != pdPASS) {
+    audioEngineTaskHandle = nullptr;
+    setAudioStatus("Audio task start failed", lv_color_hex(0xEF5350));
+    return false;
+  }
+  if (spectrumTap.rateHz.load(std::memory_order_relaxed) == 0) {
+    spectrumTapInit(&spectrumTap);
+  }
+  audioGaplessOutput->setTap(&spectrumTap);
   audioOutputReady = true;
   return true;
 }
@@ -3478,42 +4131,37 @@ static bool startAudioPlayback(int index) {
     return false;
   }
 
+  stopNetAudioStream("sd playback", true);
   stopAudioPlayback(true);
 
-  audioFileSource = new AudioFileSourceFS(SD_MMC, sdAudioFiles[index].path);
-  if (audioFileSource == nullptr) {
-    setAudioStatus("Open audio file failed", lv_color_hex(0xEF5350));
-    return false;
-  }
-
-  audioBufferedSource = new AudioFileSourceBuffer(audioFileSource, 4096);
-  AudioFileSource *decodeSource = audioBufferedSource != nullptr
-    ? static_cast<AudioFileSource *>(audioBufferedSource)
-    : static_cast<AudioFileSource *>(audioFileSource);
-
-  const char *path = sdAudioFiles[index].path;
-  bool ok = false;
-  if (strstr(path, ".wav") != nullptr || strstr(path, ".WAV") != nullptr) {
-    audioWav = new AudioGeneratorWAV();
-    if (audioWav != nullptr) {
-      ok = audioWav->begin(decodeSource, audioOutput);
-    }
+  xSemaphoreTake(audioEngineLock, portMAX_DELAY);
+  AudioTrackSlot &slot = audioSlots[audioCurrentSlot];
+  const bool opened = audioSlotOpen(slot, index);
+  const bool ok = opened && slot.generator->begin(slot.buffer, audioGaplessOutput);
+  if (ok) {
+    audioPaused = false;
+    audioEngineRunning = true;
+    audioTrackStartedMs = millis();
+    audioNextIndex = (sdAudioCount > 1) ? (index + 1) % sdAudioCount : -1;
   } else {
-    audioMp3 = new AudioGeneratorMP3();
-    if (audioMp3 != nullptr) {
-      ok = audioMp3->begin(decodeSource, audioOutput);
-    }
+    audioSlotRelease(slot);
   }
+  xSemaphoreGive(audioEngineLock);
 
   if (!ok) {
     stopAudioPlayback(true);
-    setAudioStatus("Decoder start failed", lv_color_hex(0xEF5350));
+    setAudioStatus(opened ? "Decoder start failed" : "Open audio file failed", lv_color_hex(0xEF5350));
     return false;
   }
 
+  audioEnterTrack(index);
+  return true;
+}
+
+// Loop side: the engine is now playing `index` (fresh start or gapless switch).
+static void audioEnterTrack(int index) {
   sdAudioIndex = index;
   ensureAudioTrackDuration(sdAudioIndex);
-  audioPaused = false;
   audioElapsedAccumMs = 0;
   audioPlaybackResumeMs = millis();
   audioLastTimeLabelRefreshMs = 0;
@@ -3530,53 +4178,545 @@ static bool startAudioPlayback(int index) {
   refreshAudioTimeLabel(true);
   setAudioStatus("Playing from SD", lv_color_hex(0x81C784));
   pushInboxMessage("event", "Audio playback", sdAudioFiles[sdAudioIndex].name);
-  return true;
 }
 
 static void processAudioPlayback() {
-  bool running = false;
-  bool loopOk = true;
+  const int entered = audioEngineEnteredTrack.exchange(-1, std::memory_order_acquire);
+  if (entered >= 0 && entered < sdAudioCount) {
+    xSemaphoreTake(audioEngineLock, portMAX_DELAY);
+    audioNextIndex = (sdAudioCount > 1) ? (entered + 1) % sdAudioCount : -1;
+    xSemaphoreGive(audioEngineLock);
+    audioEnterTrack(entered);
+  }
+
+  if (!audioEngineFinished.exchange(false, std::memory_order_acquire)) {
+    if (!isAudioRunning() || audioPaused) {
+      refreshAudioTimeLabel(false);
+      return;
+    }
+    uint32_t now = millis();
+    if ((uint32_t)(now - audioLastTimeLabelRefreshMs) >= 250) {
+      audioLastTimeLabelRefreshMs = now;
+      refreshAudioTimeLabel(false);
+    }
+    return;
+  }
+
+  // Ended without a preloaded successor (short track or preload failure).
+  stopAudioPlayback(true);
+  if (sdAudioCount > 1) {
+    int next = (sdAudioIndex + 1) % sdAudioCount;
+    startAudioPlayback(next);
+  } else {
+    updateAudioControlButtons(true, false);
+    setAudioStatus("Playback completed", lv_color_hex(0x90CAF9));
+  }
+}
+
+static void sendAudioStreamAck(int streamId, bool accepted, const char *reason) {
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_CONTROL, WS_COALESCE_NONE);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "audio_stream_ack");
+  json.beginObject("data");
+  json.field("deviceId", DEVICE_ID);
+  json.field("streamId", streamId);
+  json.field("accepted", accepted);
+  json.field("reason", reason == nullptr ? "" : reason);
+  json.field("maxFrameSamples", NET_AUDIO_MAX_FRAME_SAMPLES);
+  json.field("maxBufferMs", (uint32_t)NET_AUDIO_SLOTS * AUDIO_STREAM_FRAME_MS);
+  json.field("timestamp", millis());
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
+}
+
+static void sendAudioStreamStats(const char *type, const JitterBufferStats &stats, uint32_t depthMs, uint32_t targetMs,
+                                 float jitterMs, int32_t correctionPpm, const char *reason) {
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_CONTROL, WS_COALESCE_NONE);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", type);
+  json.beginObject("data");
+  json.field("deviceId", DEVICE_ID);
+  json.field("streamId", netAudioStreamId);
+  if (reason != nullptr) {
+    json.field("reason", reason);
+  }
+  json.field("received", stats.received);
+  json.field("late", stats.late);
+  json.field("lost", stats.lost);
+  json.field("concealed", stats.concealed);
+  json.field("underruns", stats.underruns);
+  json.field("skipped", stats.skipped);
+  json.field("badFrames", netAudioBadFrames);
+  json.field("depthMs", depthMs);
+  json.field("targetMs", targetMs);
+  json.field("jitterMs", (double)jitterMs, 1);
+  json.field("correctionPpm", correctionPpm);
+  json.field("timestamp", millis());
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
+}
+
+// Reports buffer health while streaming and once more when the stream ends.
+static void reportNetAudioStats(const char *type, const char *reason) {
+  portENTER_CRITICAL(&netAudioMux);
+  const JitterBufferStats stats = netAudioJitter.stats;
+  const uint32_t depthMs = jitterBufferDepthMs(&netAudioJitter);
+  const uint32_t targetMs = (uint32_t)(netAudioJitter.targetFrames * netAudioJitter.frameMs);
+  const float jitterMs = netAudioJitter.jitterMs;
+  const int32_t correctionPpm = jitterBufferCorrectionPpm(&netAudioJitter);
+  portEXIT_CRITICAL(&netAudioMux);
+
+  Serial.printf(
+    "[NetAudio] stream %u %s: rx=%lu late=%lu lost=%lu conceal=%lu underruns=%lu skipped=%lu depth=%lums target=%lums jitter=%.1fms drift=%ldppm\n",
+    (unsigned)netAudioStreamId,
+    reason != nullptr ? reason : "stats",
+    (unsigned long)stats.received,
+    (unsigned long)stats.late,
+    (unsigned long)stats.lost,
+    (unsigned long)stats.concealed,
+    (unsigned long)stats.underruns,
+    (unsigned long)stats.skipped,
+    (unsigned long)depthMs,
+    (unsigned long)targetMs,
+    jitterMs,
+    (long)correctionPpm
+  );
+  if (isConnected) {
+    sendAudioStreamStats(type, stats, depthMs, targetMs, jitterMs, correctionPpm, reason);
+  }
+}
+
+// Allocates the jitter buffer and brings up the I2S output ahead of time so
+// the first reply frame goes straight into the buffer chain.
+static bool prepareNetAudio() {
+  if (netAudioStorage == nullptr) {
+    const size_t bytes = jitterBufferStorageSamples(NET_AUDIO_SLOTS, NET_AUDIO_MAX_FRAME_SAMPLES) * sizeof(int16_t);
+    netAudioStorage = (int16_t *)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (netAudioStorage == nullptr) {
+      Serial.println("[NetAudio] jitter buffer alloc failed");
+      return false;
+    }
+  }
+  return ensureAudioOutputReady();
+}
 
-  if (audioMp3 != nullptr && audioMp3->isRunning()) {
-    running = true;
-    loopOk = audioMp3->loop();
-  } else if (audioWav != nullptr && audioWav->isRunning()) {
-    running = true;
-    loopOk = audioWav->loop();
+static bool startNetAudioStream(uint8_t streamId, uint32_t sampleRate, uint16_t frameSamples, const char *title, bool reply) {
+  stopNetAudioStream("replaced", true);
+  if (!prepareNetAudio()) {
+    return false;
   }
+  stopAudioPlayback(true);
 
-  if (!running) {
-    refreshAudioTimeLabel(false);
+  xSemaphoreTake(audioEngineLock, portMAX_DELAY);
+  jitterBufferInit(&netAudioJitter, netAudioStorage, netAudioTags, NET_AUDIO_SLOTS, NET_AUDIO_MAX_FRAME_SAMPLES);
+  bool ok = jitterBufferStart(&netAudioJitter, sampleRate, frameSamples);
+  if (ok) {
+    audioGaplessOutput->SetBitsPerSample(16);
+    audioGaplessOutput->SetChannels(1);
+    audioGaplessOutput->SetRate((int)sampleRate);
+    ok = audioGaplessOutput->begin();
+  }
+  netAudioPullPos = NET_AUDIO_PULL_SAMPLES;
+  netAudioDrained.store(false, std::memory_order_relaxed);
+  netAudioFirstAudioMs.store(0, std::memory_order_relaxed);
+  netAudioRunning = ok;
+  xSemaphoreGive(audioEngineLock);
+  if (!ok) {
+    return false;
+  }
+
+  netAudioActive = true;
+  netAudioStreamId = streamId;
+  netAudioStartedMs = millis();
+  netAudioLastFrameMs = netAudioStartedMs;
+  netAudioLastStatsLogMs = netAudioStartedMs;
+  netAudioBadFrames = 0;
+  netAudioIsReply = reply;
+  netAudioFirstAudioReported = false;
+  digitalWrite(AUDIO_MUTE_PIN, HIGH);
+  Serial.printf("[NetAudio] stream %u started: %luHz, %u samples/frame%s\n", (unsigned)streamId, (unsigned long)sampleRate,
+                (unsigned)frameSamples, reply ? ", reply" : "");
+
+  if (audioTrackLabel != nullptr) {
+    lv_label_set_text(audioTrackLabel, title);
+  }
+  if (audioIndexLabel != nullptr) {
+    lv_label_set_text(audioIndexLabel, "Live");
+  }
+  if (reply) {
+    // The reply text is already in the inbox from voice_command_result.
+    setAudioStatus("Speaking reply", lv_color_hex(0x81C784));
+  } else {
+    setAudioStatus("Streaming from desktop", lv_color_hex(0x81C784));
+    pushInboxMessage("event", "Desktop audio", title);
+  }
+  return true;
+}
+
+static void stopNetAudioStream(const char *reason, bool notifyServer) {
+  if (!netAudioActive) {
     return;
   }
 
-  if (audioPaused) {
-    refreshAudioTimeLabel(false);
+  xSemaphoreTake(audioEngineLock, portMAX_DELAY);
+  netAudioRunning = false;
+  audioGaplessOutput->close();
+  xSemaphoreGive(audioEngineLock);
+  netAudioActive = false;
+  digitalWrite(AUDIO_MUTE_PIN, LOW);
+
+  netAudioUnderrunsTotal += netAudioJitter.stats.underruns;
+  if (notifyServer) {
+    reportNetAudioStats("audio_stream_stopped", reason);
+  } else {
+    Serial.printf("[NetAudio] stream %u stopped: %s\n", (unsigned)netAudioStreamId, reason);
+  }
+  setAudioStatus("Desktop stream ended", lv_color_hex(0x90CAF9));
+  showCurrentAudioTrack();
+}
+
+static void handleAudioStreamStart(const JsonObjectConst &data) {
+  const int version = data["version"] | AUDIO_STREAM_VERSION;
+  const int streamId = data["streamId"] | -1;
+  const uint32_t sampleRate = data["sampleRate"] | 0;
+  const int frameSamples = data["frameSamples"] | 0;
+  const char *codec = data["codec"] | "";
+  const char *title = data["title"] | "Desktop audio";
+  const bool reply = strcmp(data["purpose"] | "media", "tts") == 0;
+
+  const char *reason = nullptr;
+  if (version != AUDIO_STREAM_VERSION) {
+    reason = "unsupported version";
+  } else if (strcmp(codec, "ima_adpcm") != 0) {
+    reason = "unsupported codec";
+  } else if (streamId < 0 || streamId > 255) {
+    reason = "invalid stream id";
+  } else if (sampleRate < AUDIO_STREAM_MIN_SAMPLE_RATE || sampleRate > AUDIO_STREAM_MAX_SAMPLE_RATE ||
+             frameSamples <= 0 || frameSamples > NET_AUDIO_MAX_FRAME_SAMPLES) {
+    reason = "unsupported format";
+  } else if (!startNetAudioStream((uint8_t)streamId, sampleRate, (uint16_t)frameSamples, title, reply)) {
+    reason = "audio output unavailable";
+  }
+  sendAudioStreamAck(streamId, reason == nullptr, reason);
+}
+
+static void handleAudioStreamStop(const JsonObjectConst &data) {
+  const int streamId = data["streamId"] | -1;
+  if (!netAudioActive || streamId != netAudioStreamId) {
     return;
   }
+  if (data["drain"] | false) {
+    portENTER_CRITICAL(&netAudioMux);
+    jitterBufferMarkEnd(&netAudioJitter);
+    portEXIT_CRITICAL(&netAudioMux);
+    return;
+  }
+  stopNetAudioStream("server stop", true);
+}
 
-  uint32_t now = millis();
-  if ((uint32_t)(now - audioLastTimeLabelRefreshMs) >= 250) {
-    audioLastTimeLabelRefreshMs = now;
-    refreshAudioTimeLabel(false);
+static void handleNetAudioFrame(const uint8_t *payload, size_t length) {
+  AudioStreamFrame frame;
+  if (!audioStreamParseFrame(payload, length, &frame) || frame.streamId != netAudioStreamId ||
+      frame.chunkLen <= IMA_ADPCM_HEADER_BYTES) {
+    netAudioBadFrames++;
+    return;
   }
 
-  if (loopOk) {
+  size_t samples = (frame.chunkLen - IMA_ADPCM_HEADER_BYTES) * 2;
+  if (samples > netAudioJitter.frameSamples) {
+    samples = netAudioJitter.frameSamples;
+  }
+  if (!imaAdpcmDecodeChunk(frame.chunk, frame.chunkLen, samples, netAudioDecodeBuffer)) {
+    netAudioBadFrames++;
     return;
   }
 
-  stopAudioPlayback(true);
-  if (sdAudioCount > 1) {
-    int next = (sdAudioIndex + 1) % sdAudioCount;
-    startAudioPlayback(next);
+  netAudioLastFrameMs = millis();
+  portENTER_CRITICAL(&netAudioMux);
+  jitterBufferPush(&netAudioJitter, frame.frame, netAudioDecodeBuffer, (uint16_t)samples, netAudioLastFrameMs);
+  if (frame.flags & AUDIO_STREAM_FLAG_LAST) {
+    jitterBufferMarkEnd(&netAudioJitter);
+  }
+  portEXIT_CRITICAL(&netAudioMux);
+}
+
+// Time to first audio, measured where the first real sample is handed to
+// I2S (the DMA queue adds up to AUDIO_DMA_BUF_COUNT buffers on top).
+static void reportNetAudioFirstAudio(uint32_t firstAudioMs) {
+  netAudioFirstAudioReported = true;
+  const uint32_t startToAudioMs = firstAudioMs - netAudioStartedMs;
+  const bool speechRecent = netAudioIsReply && voiceSpeechEndMs != 0 &&
+                            (uint32_t)(firstAudioMs - voiceSpeechEndMs) < NET_AUDIO_REPLY_WINDOW_MS;
+  const uint32_t speechEndToAudioMs = speechRecent ? firstAudioMs - voiceSpeechEndMs : 0;
+  if (speechRecent) {
+    Serial.printf("[NetAudio] stream %u first audio: %lums after start, %lums after end of speech\n",
+                  (unsigned)netAudioStreamId, (unsigned long)startToAudioMs, (unsigned long)speechEndToAudioMs);
   } else {
-    updateAudioControlButtons(true, false);
-    setAudioStatus("Playback completed", lv_color_hex(0x90CAF9));
+    Serial.printf("[NetAudio] stream %u first audio: %lums after start\n", (unsigned)netAudioStreamId, (unsigned long)startToAudioMs);
+  }
+
+  if (speechRecent && voiceStatusLabel != nullptr && !voiceMicStreaming) {
+    lv_label_set_text_fmt(voiceStatusLabel, "Reply audio in %lu ms", (unsigned long)speechEndToAudioMs);
+    lv_obj_set_style_text_color(voiceStatusLabel, lv_color_hex(0x90CAF9), LV_PART_MAIN);
+  }
+
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_CONTROL, WS_COALESCE_NONE);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "audio_stream_first_audio");
+  json.beginObject("data");
+  json.field("deviceId", DEVICE_ID);
+  json.field("streamId", netAudioStreamId);
+  json.field("purpose", netAudioIsReply ? "tts" : "media");
+  json.field("startToAudioMs", startToAudioMs);
+  if (speechRecent) {
+    json.field("speechEndToAudioMs", speechEndToAudioMs);
+  }
+  json.field("timestamp", millis());
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
+}
+
+static void processNetAudioStream() {
+  if (!netAudioActive) {
+    return;
+  }
+  if (!netAudioFirstAudioReported) {
+    const uint32_t firstAudioMs = netAudioFirstAudioMs.load(std::memory_order_acquire);
+    if (firstAudioMs != 0) {
+      reportNetAudioFirstAudio(firstAudioMs);
+    }
+  }
+  if (netAudioDrained.exchange(false, std::memory_order_acquire)) {
+    stopNetAudioStream("drained", true);
+    return;
+  }
+
+  const uint32_t now = millis();
+  if ((uint32_t)(now - netAudioLastFrameMs) >= NET_AUDIO_IDLE_TIMEOUT_MS) {
+    stopNetAudioStream("timeout", true);
+    return;
+  }
+  if ((uint32_t)(now - netAudioLastStatsLogMs) >= NET_AUDIO_STATS_LOG_INTERVAL_MS) {
+    netAudioLastStatsLogMs = now;
+    reportNetAudioStats("audio_stream_stats", nullptr);
+  }
+}
+
+static void spectrumTask(void *arg) {
+  (void)arg;
+  int16_t window[SPECTRUM_FFT_SIZE];
+  uint32_t lastHead = 0;
+  TickType_t wake = xTaskGetTickCount();
+
+  for (;;) {
+    if (!spectrumWanted.load(std::memory_order_acquire)) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      wake = xTaskGetTickCount();
+      continue;
+    }
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(SPECTRUM_INTERVAL_MS));
+
+    const uint32_t start = micros();
+    const uint32_t head = spectrumTapLatest(&spectrumTap, window, SPECTRUM_FFT_SIZE);
+    // A head that did not move means the output is starved; let the bars fall.
+    spectrumAnalyzerProcess(spectrumAnalyzer, (head != lastHead) ? window : nullptr,
+                            spectrumTap.rateHz.load(std::memory_order_relaxed));
+    lastHead = head;
+    spectrumPublish(&spectrumShared, &spectrumAnalyzer->frame);
+
+    const uint32_t us = micros() - start;
+    spectrumFramesTotal.fetch_add(1, std::memory_order_relaxed);
+    spectrumUsTotal.fetch_add(us, std::memory_order_relaxed);
+    if (us > spectrumUsMax.load(std::memory_order_relaxed)) {
+      spectrumUsMax.store(us, std::memory_order_relaxed);
+    }
+  }
+}
+
+static bool ensureSpectrumReady() {
+  if (spectrumTaskHandle != nullptr) {
+    return true;
+  }
+  if (spectrumCanvas == nullptr) {
+    return false;
+  }
+  if (spectrumAnalyzer == nullptr) {
+    spectrumAnalyzer = (SpectrumAnalyzer *)heap_caps_malloc(sizeof(SpectrumAnalyzer), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (spectrumAnalyzer == nullptr) {
+      Serial.println("[Spectrum] analyzer alloc failed");
+      return false;
+    }
+    spectrumAnalyzerInit(spectrumAnalyzer);
+  }
+  if (xTaskCreatePinnedToCore(spectrumTask, "spectrum", 4096, nullptr, SPECTRUM_TASK_PRIORITY, &spectrumTaskHandle, 0) != pdPASS) {
+    spectrumTaskHandle = nullptr;
+    Serial.println("[Spectrum] task start failed");
+    return false;
+  }
+  return true;
+}
+
+static void setSpectrumVisible(bool visible) {
+  if (visible == spectrumVisible) {
+    return;
+  }
+  if (visible) {
+    if (spectrumUnavailable || !ensureSpectrumReady()) {
+      spectrumUnavailable = true;
+      return;
+    }
+    const lv_color_t bg = lv_color_hex(0x111111);
+    for (size_t i = 0; i < (size_t)SPECTRUM_VIEW_W * SPECTRUM_VIEW_H; ++i) {
+      spectrumCanvasBuf[i] = bg;
+    }
+    memset(&spectrumDrawn, 0, sizeof(spectrumDrawn));
+    spectrumFramesTotal.store(0, std::memory_order_relaxed);
+    spectrumUsTotal.store(0, std::memory_order_relaxed);
+    spectrumUsMax.store(0, std::memory_order_relaxed);
+    lv_obj_add_flag(audioIconLabel, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_clear_flag(spectrumCanvas, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_invalidate(spectrumCanvas);
+    spectrumVisible = true;
+    spectrumWanted.store(true, std::memory_order_release);
+    xTaskNotifyGive(spectrumTaskHandle);
+    return;
+  }
+
+  spectrumWanted.store(false, std::memory_order_release);
+  spectrumVisible = false;
+  lv_obj_add_flag(spectrumCanvas, LV_OBJ_FLAG_HIDDEN);
+  lv_obj_clear_flag(audioIconLabel, LV_OBJ_FLAG_HIDDEN);
+  const uint32_t frames = spectrumFramesTotal.load(std::memory_order_relaxed);
+  if (frames > 0) {
+    Serial.printf("[Spectrum] %lu frames, analyze avg %lu us, max %lu us\n", (unsigned long)frames,
+                  (unsigned long)(spectrumUsTotal.load(std::memory_order_relaxed) / frames),
+                  (unsigned long)spectrumUsMax.load(std::memory_order_relaxed));
+  }
+}
+
+static inline lv_coord_t spectrumLevelToPx(uint8_t level, lv_coord_t full) {
+  return (lv_coord_t)((level * full + 127) / 255);
+}
+
+// Repaints rows [y0, y1) of one bar: cap row, gradient below the bar top,
+// background above.
+static void paintSpectrumBar(lv_coord_t x0, lv_coord_t y0, lv_coord_t y1, lv_coord_t barTop, lv_coord_t capY) {
+  const lv_color_t bg = lv_color_hex(0x111111);
+  const lv_color_t cap = lv_color_hex(0xE1F5FE);
+  for (lv_coord_t y = y0; y < y1; ++y) {
+    const lv_color_t c = (y == capY) ? cap : (y >= barTop ? spectrumRowColor[y] : bg);
+    lv_color_t *row = spectrumCanvasBuf + (size_t)y * SPECTRUM_VIEW_W + x0;
+    for (lv_coord_t x = 0; x < SPECTRUM_BAR_W; ++x) {
+      row[x] = c;
+    }
+  }
+}
+
+static void drawSpectrumFrame(const SpectrumFrame &frame) {
+  lv_coord_t dirtyX0 = SPECTRUM_VIEW_W, dirtyX1 = -1, dirtyY0 = SPECTRUM_VIEW_H, dirtyY1 = -1;
+  auto markDirty = [&](lv_coord_t x0, lv_coord_t x1, lv_coord_t y0, lv_coord_t y1) {
+    dirtyX0 = LV_MIN(dirtyX0, x0);
+    dirtyX1 = LV_MAX(dirtyX1, x1);
+    dirtyY0 = LV_MIN(dirtyY0, y0);
+    dirtyY1 = LV_MAX(dirtyY1, y1);
+  };
+
+  for (int b = 0; b < SPECTRUM_BANDS; ++b) {
+    const lv_coord_t oldTop = SPECTRUM_BAR_H - spectrumLevelToPx(spectrumDrawn.bands[b], SPECTRUM_BAR_H);
+    const lv_coord_t newTop = SPECTRUM_BAR_H - spectrumLevelToPx(frame.bands[b], SPECTRUM_BAR_H);
+    const lv_coord_t oldPeak = spectrumLevelToPx(spectrumDrawn.peaks[b], SPECTRUM_BAR_H);
+    const lv_coord_t newPeak = spectrumLevelToPx(frame.peaks[b], SPECTRUM_BAR_H);
+    const lv_coord_t oldCap = oldPeak > 0 ? LV_MAX(0, SPECTRUM_BAR_H - oldPeak - 1) : -1;
+    const lv_coord_t newCap = newPeak > 0 ? LV_MAX(0, SPECTRUM_BAR_H - newPeak - 1) : -1;
+    if (oldTop == newTop && oldCap == newCap) {
+      continue;
+    }
+
+    lv_coord_t y0 = LV_MIN(oldTop, newTop);
+    lv_coord_t y1 = LV_MAX(oldTop, newTop);
+    if (oldCap >= 0) {
+      y0 = LV_MIN(y0, oldCap);
+      y1 = LV_MAX(y1, oldCap + 1);
+    }
+    if (newCap >= 0) {
+      y0 = LV_MIN(y0, newCap);
+      y1 = LV_MAX(y1, newCap + 1);
+    }
+    const lv_coord_t x0 = b * (SPECTRUM_BAR_W + SPECTRUM_BAR_GAP);
+    paintSpectrumBar(x0, y0, y1, newTop, newCap);
+    markDirty(x0, x0 + SPECTRUM_BAR_W - 1, y0, y1 - 1);
+  }
+
+  const lv_coord_t oldVu = spectrumLevelToPx(spectrumDrawn.vu, SPECTRUM_VIEW_W);
+  const lv_coord_t newVu = spectrumLevelToPx(frame.vu, SPECTRUM_VIEW_W);
+  if (oldVu != newVu) {
+    const lv_coord_t x0 = LV_MIN(oldVu, newVu);
+    const lv_coord_t x1 = LV_MAX(oldVu, newVu);
+    for (lv_coord_t y = SPECTRUM_BAR_H + 1; y < SPECTRUM_VIEW_H; ++y) {
+      lv_color_t *row = spectrumCanvasBuf + (size_t)y * SPECTRUM_VIEW_W;
+      for (lv_coord_t x = x0; x < x1; ++x) {
+        if (x >= newVu) {
+          row[x] = lv_color_hex(0x111111);
+        } else if (x < SPECTRUM_VIEW_W * 7 / 10) {
+          row[x] = lv_color_hex(0x81C784);
+        } else if (x < SPECTRUM_VIEW_W * 9 / 10) {
+          row[x] = lv_color_hex(0xFFB74D);
+        } else {
+          row[x] = lv_color_hex(0xEF5350);
+        }
+      }
+    }
+    markDirty(x0, x1 - 1, SPECTRUM_BAR_H + 1, SPECTRUM_VIEW_H - 1);
+  }
+
+  spectrumDrawn = frame;
+  if (dirtyX1 < dirtyX0) {
+    return;
+  }
+  lv_area_t area;
+  lv_obj_get_coords(spectrumCanvas, &area);
+  area.x1 += dirtyX0;
+  area.y1 += dirtyY0;
+  area.x2 = area.x1 + (dirtyX1 - dirtyX0);
+  area.y2 = area.y1 + (dirtyY1 - dirtyY0);
+  lv_obj_invalidate_area(spectrumCanvas, &area);
+}
+
+static void processSpectrumView() {
+  const bool wanted = spectrumCanvas != nullptr && currentPage == UI_PAGE_AUDIO_PLAYER &&
+                      ((isAudioRunning() && !audioPaused) || netAudioActive);
+  setSpectrumVisible(wanted);
+  if (!spectrumVisible) {
+    return;
+  }
+  SpectrumFrame frame;
+  if (spectrumSnapshot(&spectrumShared, &frame, &spectrumSeenSeq)) {
+    drawSpectrumFrame(frame);
   }
 }
 
 static void loadSdAudioList() {
   stopAudioPlayback(true);
+  cancelAudioIndexScan();
+  for (int i = 0; i < sdAudioCount; ++i) {
+    heap_caps_free(sdAudioFiles[i].seekIndex);
+    sdAudioFiles[i].seekIndex = nullptr;
+  }
   sdAudioCount = 0;
   sdAudioIndex = 0;
 
@@ -3649,6 +4789,147 @@ static void scanSdBrowserFilesRecursive(const char *dirPath, int depth) {
   dir.close();
 }
 
+static void rebuildSdBrowserSnapshot() {
+  sdBrowserFileCount = 0;
+  if (sdMounted) {
+    scanSdBrowserFilesRecursive("/", 0);
+  }
+  sdBrowserSnapshotValid = sdMounted;
+  sdBrowserSnapshotBuiltMs = millis();
+  Serial.printf("[SD] browser snapshot gen=%lu files=%d\n", (unsigned long)sdBrowserSnapshotGeneration, sdBrowserFileCount);
+}
+
+static void sendSdChangedNotification(const char *reason, const char *path) {
+  if (!isConnected || !sdChangeSubscribed) {
+    return;
+  }
+
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_CONTROL, WS_COALESCE_SD_CHANGED);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "sd_changed");
+  json.beginObject("data");
+  json.field("deviceId", DEVICE_ID);
+  json.field("generation", sdBrowserSnapshotGeneration);
+  json.field("reason", reason == nullptr ? "" : reason);
+  json.field("path", path == nullptr ? "/" : path);
+  json.field("sdMounted", sdMounted);
+  json.field("timestamp", millis());
+
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
+}
+
+static void markSdBrowserSnapshotStale(const char *reason, const char *path) {
+  sdBrowserSnapshotValid = false;
+  sdBrowserSnapshotGeneration++;
+  Serial.printf(
+    "[SD] browser snapshot stale gen=%lu reason=%s path=%s\n",
+    (unsigned long)sdBrowserSnapshotGeneration,
+    reason == nullptr ? "-" : reason,
+    path == nullptr ? "/" : path
+  );
+  sendSdChangedNotification(reason, path);
+}
+
+// Cursor = "<generation>-<snapshot index>" in hex. The server treats it as opaque.
+static void formatSdListCursor(int scanIndex, char *out, size_t outSize) {
+  snprintf(out, outSize, "%lx-%x", (unsigned long)sdBrowserSnapshotGeneration, (unsigned)scanIndex);
+}
+
+static bool parseSdListCursor(const char *cursor, int *outScanIndex) {
+  if (cursor == nullptr || cursor[0] == '\0' || outScanIndex == nullptr) {
+    return false;
+  }
+
+  char *end = nullptr;
+  unsigned long generation = strtoul(cursor, &end, 16);
+  if (end == cursor || *end != '-') {
+    return false;
+  }
+  const char *indexText = end + 1;
+  unsigned long index = strtoul(indexText, &end, 16);
+  if (end == indexText || *end != '\0') {
+    return false;
+  }
+  if (generation != sdBrowserSnapshotGeneration || index > (unsigned long)sdBrowserFileCount) {
+    return false;
+  }
+
+  *outScanIndex = (int)index;
+  return true;
+}
+
+static void normalizeSdListDir(const char *dirPath, char *out, size_t outSize) {
+  if (dirPath == nullptr || dirPath[0] != '/') {
+    copyText(out, outSize, "/");
+    return;
+  }
+
+  copyText(out, outSize, dirPath);
+  size_t len = strlen(out);
+  while (len > 1 && out[len - 1] == '/') {
+    out[--len] = '\0';
+  }
+}
+
+// Returns the snapshot index of the next listing unit at or after scanIndex, or -1.
+// Non-recursive listings fold each subdirectory into a single unit; the scan is
+// depth-first so a subdirectory's files are contiguous and can be skipped as a run.
+static int nextSdBrowserListUnit(
+  const char *dirPath,
+  bool recursive,
+  int scanIndex,
+  int *outNextIndex,
+  char *subdirName,
+  size_t subdirNameSize
+) {
+  const bool atRoot = strcmp(dirPath, "/") == 0;
+  const size_t dirLen = strlen(dirPath);
+
+  for (int i = scanIndex; i < sdBrowserFileCount; ++i) {
+    const char *path = sdBrowserFiles[i].path;
+    const char *relative = nullptr;
+    if (atRoot) {
+      relative = path + 1;
+    } else if (strncmp(path, dirPath, dirLen) == 0 && path[dirLen] == '/') {
+      relative = path + dirLen + 1;
+    }
+    if (relative == nullptr) {
+      continue;
+    }
+
+    const char *slash = strchr(relative, '/');
+    if (recursive || slash == nullptr) {
+      subdirName[0] = '\0';
+      *outNextIndex = i + 1;
+      return i;
+    }
+
+    size_t nameLen = (size_t)(slash - relative);
+    if (nameLen >= subdirNameSize) {
+      nameLen = subdirNameSize - 1;
+    }
+    memcpy(subdirName, relative, nameLen);
+    subdirName[nameLen] = '\0';
+
+    const size_t prefixLen = (size_t)(slash - path) + 1;
+    int next = i + 1;
+    while (next < sdBrowserFileCount && strncmp(sdBrowserFiles[next].path, path, prefixLen) == 0) {
+      next++;
+    }
+    *outNextIndex = next;
+    return i;
+  }
+
+  *outNextIndex = sdBrowserFileCount;
+  return -1;
+}
+
 static void resetSdUploadSession(bool removeTempFile) {
   if (sdUploadSession.file) {
     sdUploadSession.file.close();
@@ -3740,21 +5021,26 @@ static void sendSdUploadBeginAck(const char *uploadId, bool success, const char
     return;
   }
 
-  StaticJsonDocument<384> doc;
-  doc["type"] = "sd_upload_begin_ack";
-  JsonObject data = doc.createNestedObject("data");
-  data["uploadId"] = uploadId == nullptr ? "" : uploadId;
-  data["deviceId"] = DEVICE_ID;
-  data["success"] = success;
-  data["received"] = sdUploadSession.receivedSize;
-  data["timestamp"] = millis();
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_CONTROL, WS_COALESCE_NONE);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "sd_upload_begin_ack");
+  json.beginObject("data");
+  json.field("uploadId", uploadId == nullptr ? "" : uploadId);
+  json.field("deviceId", DEVICE_ID);
+  json.field("success", success);
+  json.field("received", sdUploadSession.receivedSize);
+  json.field("timestamp", millis());
   if (reason != nullptr && reason[0] != '\0') {
-    data["reason"] = reason;
+    json.field("reason", reason);
   }
 
-  String output;
-  serializeJson(doc, output);
-  webSocket.sendTXT(output);
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
 }
 
 static void sendSdUploadChunkAck(const char *uploadId, int seq, bool success, const char *reason) {
@@ -3762,22 +5048,27 @@ static void sendSdUploadChunkAck(const char *uploadId, int seq, bool success, co
     return;
   }
 
-  StaticJsonDocument<448> doc;
-  doc["type"] = "sd_upload_chunk_ack";
-  JsonObject data = doc.createNestedObject("data");
-  data["uploadId"] = uploadId == nullptr ? "" : uploadId;
-  data["deviceId"] = DEVICE_ID;
-  data["seq"] = seq;
-  data["success"] = success;
-  data["received"] = sdUploadSession.receivedSize;
-  data["timestamp"] = millis();
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_CONTROL, WS_COALESCE_NONE);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "sd_upload_chunk_ack");
+  json.beginObject("data");
+  json.field("uploadId", uploadId == nullptr ? "" : uploadId);
+  json.field("deviceId", DEVICE_ID);
+  json.field("seq", seq);
+  json.field("success", success);
+  json.field("received", sdUploadSession.receivedSize);
+  json.field("timestamp", millis());
   if (reason != nullptr && reason[0] != '\0') {
-    data["reason"] = reason;
+    json.field("reason", reason);
   }
 
-  String output;
-  serializeJson(doc, output);
-  webSocket.sendTXT(output);
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
 }
 
 static void sendSdUploadCommitAck(const char *uploadId, bool success, const char *finalPath, const char *reason) {
@@ -3785,53 +5076,53 @@ static void sendSdUploadCommitAck(const char *uploadId, bool success, const char
     return;
   }
 
-  StaticJsonDocument<448> doc;
-  doc["type"] = "sd_upload_commit_ack";
-  JsonObject data = doc.createNestedObject("data");
-  data["uploadId"] = uploadId == nullptr ? "" : uploadId;
-  data["deviceId"] = DEVICE_ID;
-  data["success"] = success;
-  data["received"] = sdUploadSession.receivedSize;
-  data["timestamp"] = millis();
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_CONTROL, WS_COALESCE_NONE);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "sd_upload_commit_ack");
+  json.beginObject("data");
+  json.field("uploadId", uploadId == nullptr ? "" : uploadId);
+  json.field("deviceId", DEVICE_ID);
+  json.field("success", success);
+  json.field("received", sdUploadSession.receivedSize);
+  json.field("timestamp", millis());
   if (finalPath != nullptr && finalPath[0] != '\0') {
-    data["path"] = finalPath;
+    json.field("path", finalPath);
   }
   if (reason != nullptr && reason[0] != '\0') {
-    data["reason"] = reason;
+    json.field("reason", reason);
   }
 
-  String output;
-  serializeJson(doc, output);
-  webSocket.sendTXT(output);
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
 }
 
-static void sendSdListResponse(const char *requestId, int offset, int limit) {
-  if (!isConnected) {
-    return;
-  }
-
-  detectAndScanSdCard();
-  sdBrowserFileCount = 0;
-  if (sdMounted) {
-    scanSdBrowserFilesRecursive("/", 0);
+static void sendSdListResponse(
+  const char *requestId,
+  const char *dirPath,
+  bool recursive,
+  const char *cursor,
+  int offset,
+  int limit,
+  bool refresh
+) {
+  if (!isConnected) {
+    return;
   }
 
-  int imageCount = 0;
-  int audioCount = 0;
-  int videoCount = 0;
-  int otherCount = 0;
-  for (int i = 0; i < sdBrowserFileCount; ++i) {
-    const char *type = sdBrowserFiles[i].type;
-    if (strcmp(type, "image") == 0) {
-      imageCount++;
-    } else if (strcmp(type, "audio") == 0) {
-      audioCount++;
-    } else if (strcmp(type, "video") == 0) {
-      videoCount++;
-    } else {
-      otherCount++;
-    }
+  if (refresh || !sdMounted) {
+    detectAndScanSdCard();
   }
+  if (refresh || !sdBrowserSnapshotValid) {
+    rebuildSdBrowserSnapshot();
+  }
+
+  char listDir[192];
+  normalizeSdListDir(dirPath, listDir, sizeof(listDir));
 
   int pageLimit = limit;
   if (pageLimit <= 0) {
@@ -3841,64 +5132,168 @@ static void sendSdListResponse(const char *requestId, int offset, int limit) {
     pageLimit = SD_BROWSER_RESPONSE_MAX_FILES;
   }
 
-  int pageOffset = offset;
-  if (pageOffset < 0) {
-    pageOffset = 0;
-  }
-  if (pageOffset > sdBrowserFileCount) {
-    pageOffset = sdBrowserFileCount;
-  }
-
-  int responseFileCount = sdBrowserFileCount - pageOffset;
-  if (responseFileCount < 0) {
-    responseFileCount = 0;
-  }
-  if (responseFileCount > pageLimit) {
-    responseFileCount = pageLimit;
-  }
-  const bool truncated = (pageOffset + responseFileCount) < sdBrowserFileCount;
-
-  sdListResponseDoc.clear();
-  sdListResponseDoc["type"] = "sd_list_response";
-  JsonObject data = sdListResponseDoc.createNestedObject("data");
-  data["requestId"] = requestId == nullptr ? "" : requestId;
-  data["deviceId"] = DEVICE_ID;
-  data["sdMounted"] = sdMounted;
-  data["root"] = "/";
-  data["offset"] = pageOffset;
-  data["limit"] = pageLimit;
-  data["total"] = sdBrowserFileCount;
-  data["returned"] = responseFileCount;
-  data["truncated"] = truncated;
-  data["imageCount"] = imageCount;
-  data["audioCount"] = audioCount;
-  data["videoCount"] = videoCount;
-  data["otherCount"] = otherCount;
-  data["timestamp"] = millis();
+  const bool hasCursor = cursor != nullptr && cursor[0] != '\0';
+  int cursorIndex = 0;
+  const bool cursorValid = hasCursor && parseSdListCursor(cursor, &cursorIndex);
+  const bool cursorExpired = hasCursor && !cursorValid;
+
+  int pageOffset = (cursorValid || offset < 0) ? 0 : offset;
+  int startIndex = sdBrowserFileCount;
+  int total = 0;
+  int imageCount = 0;
+  int audioCount = 0;
+  int videoCount = 0;
+  int otherCount = 0;
+  char subdirName[64];
+
+  // Cheap in-memory pass: totals for this directory and the page start position.
+  int scanIndex = 0;
+  while (true) {
+    int nextIndex = 0;
+    int unitIndex = nextSdBrowserListUnit(listDir, recursive, scanIndex, &nextIndex, subdirName, sizeof(subdirName));
+    if (unitIndex < 0) {
+      break;
+    }
+    if (cursorValid) {
+      if (unitIndex < cursorIndex) {
+        pageOffset = total + 1;
+      } else if (startIndex == sdBrowserFileCount) {
+        startIndex = unitIndex;
+        pageOffset = total;
+      }
+    } else if (total == pageOffset) {
+      startIndex = unitIndex;
+    }
+
+    total++;
+    if (subdirName[0] == '\0') {
+      const char *type = sdBrowserFiles[unitIndex].type;
+      if (strcmp(type, "image") == 0) {
+        imageCount++;
+      } else if (strcmp(type, "audio") == 0) {
+        audioCount++;
+      } else if (strcmp(type, "video") == 0) {
+        videoCount++;
+      } else {
+        otherCount++;
+      }
+    }
+    scanIndex = nextIndex;
+  }
+  if (pageOffset > total) {
+    pageOffset = total;
+  }
+
+  WsJsonWriter json(webSocket);
+  json.beginObject();
+  json.field("type", "sd_list_response");
+  json.beginObject("data");
+  json.field("requestId", requestId == nullptr ? "" : requestId);
+  json.field("deviceId", DEVICE_ID);
+  json.field("sdMounted", sdMounted);
+  json.field("root", "/");
+  json.field("dir", listDir);
+  json.field("recursive", recursive);
+  json.field("generation", sdBrowserSnapshotGeneration);
+  json.field("snapshotAgeMs", millis() - sdBrowserSnapshotBuiltMs);
+  json.field("offset", pageOffset);
+  json.field("limit", pageLimit);
+  json.field("total", total);
+  json.field("imageCount", imageCount);
+  json.field("audioCount", audioCount);
+  json.field("videoCount", videoCount);
+  json.field("otherCount", otherCount);
+  json.field("timestamp", millis());
   if (!sdMounted) {
-    data["reason"] = sdMountReason;
+    json.field("reason", sdMountReason);
+  } else if (cursorExpired) {
+    json.field("success", false);
+    json.field("cursorExpired", true);
+    json.field("reason", "cursor expired");
+  }
+
+  json.beginArray("files");
+  int returned = 0;
+  scanIndex = startIndex;
+  if (!cursorExpired) {
+    while (returned < pageLimit) {
+      int nextIndex = 0;
+      int unitIndex = nextSdBrowserListUnit(listDir, recursive, scanIndex, &nextIndex, subdirName, sizeof(subdirName));
+      if (unitIndex < 0) {
+        break;
+      }
+
+      json.beginObject();
+      if (subdirName[0] != '\0') {
+        char subdirPath[192];
+        if (strcmp(listDir, "/") == 0) {
+          snprintf(subdirPath, sizeof(subdirPath), "/%s", subdirName);
+        } else {
+          snprintf(subdirPath, sizeof(subdirPath), "%s/%s", listDir, subdirName);
+        }
+        json.field("name", subdirName);
+        json.field("path", subdirPath);
+        json.field("type", "dir");
+        json.field("size", 0);
+      } else {
+        json.field("name", sdBrowserFiles[unitIndex].name);
+        json.field("path", sdBrowserFiles[unitIndex].path);
+        json.field("type", sdBrowserFiles[unitIndex].type);
+        json.field("size", sdBrowserFiles[unitIndex].size);
+      }
+      json.endObject();
+      returned++;
+      scanIndex = nextIndex;
+    }
   }
+  json.endArray();
 
-  JsonArray files = data.createNestedArray("files");
-  for (int i = 0; i < responseFileCount; ++i) {
-    const int fileIndex = pageOffset + i;
-    JsonObject item = files.createNestedObject();
-    item["name"] = sdBrowserFiles[fileIndex].name;
-    item["path"] = sdBrowserFiles[fileIndex].path;
-    item["type"] = sdBrowserFiles[fileIndex].type;
-    item["size"] = sdBrowserFiles[fileIndex].size;
+  const bool truncated = !cursorExpired && (pageOffset + returned) < total;
+  char nextCursor[24] = "";
+  if (truncated) {
+    formatSdListCursor(scanIndex, nextCursor, sizeof(nextCursor));
   }
+  json.field("returned", returned);
+  json.field("truncated", truncated);
+  json.field("nextCursor", nextCursor);
+  json.endObject();
+  json.endObject();
+  json.finish();
+  wsOutboxNoteSent(WS_CLASS_CONTROL, json.bytesWritten());
 
-  String output;
-  output.reserve(7000);
-  const size_t bytes = serializeJson(sdListResponseDoc, output);
   Serial.printf(
-    "[SD] list response: total=%d returned=%d bytes=%u\n",
-    sdBrowserFileCount,
-    responseFileCount,
-    (unsigned)bytes
+    "[SD] list response: dir=%s total=%d returned=%d gen=%lu bytes=%lu fragments=%lu\n",
+    listDir,
+    total,
+    returned,
+    (unsigned long)sdBrowserSnapshotGeneration,
+    (unsigned long)json.bytesWritten(),
+    (unsigned long)json.fragments()
   );
-  webSocket.sendTXT(output);
+}
+
+static void sendSdSubscribeAck(const char *requestId) {
+  if (!isConnected) {
+    return;
+  }
+
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_CONTROL, WS_COALESCE_NONE);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "sd_subscribe_ack");
+  json.beginObject("data");
+  json.field("requestId", requestId == nullptr ? "" : requestId);
+  json.field("deviceId", DEVICE_ID);
+  json.field("subscribed", sdChangeSubscribed);
+  json.field("generation", sdBrowserSnapshotGeneration);
+  json.field("timestamp", millis());
+
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
 }
 
 static void sendSdDeleteResponse(const char *requestId, const char *targetPath, bool success, const char *reason) {
@@ -3906,19 +5301,24 @@ static void sendSdDeleteResponse(const char *requestId, const char *targetPath,
     return;
   }
 
-  StaticJsonDocument<768> doc;
-  doc["type"] = "sd_delete_response";
-  JsonObject data = doc.createNestedObject("data");
-  data["requestId"] = requestId == nullptr ? "" : requestId;
-  data["deviceId"] = DEVICE_ID;
-  data["path"] = targetPath == nullptr ? "" : targetPath;
-  data["success"] = success;
-  data["reason"] = reason == nullptr ? "" : reason;
-  data["timestamp"] = millis();
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_CONTROL, WS_COALESCE_NONE);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "sd_delete_response");
+  json.beginObject("data");
+  json.field("requestId", requestId == nullptr ? "" : requestId);
+  json.field("deviceId", DEVICE_ID);
+  json.field("path", targetPath == nullptr ? "" : targetPath);
+  json.field("success", success);
+  json.field("reason", reason == nullptr ? "" : reason);
+  json.field("timestamp", millis());
 
-  String output;
-  serializeJson(doc, output);
-  webSocket.sendTXT(output);
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
 }
 
 static void sendSdPreviewResponse(const char *requestId, const char *targetPath, bool success, uint32_t len, const char *reason) {
@@ -3926,23 +5326,25 @@ static void sendSdPreviewResponse(const char *requestId, const char *targetPath,
     return;
   }
 
-  StaticJsonDocument<384> doc;
-  doc["type"] = "sd_preview_response";
-  JsonObject data = doc.createNestedObject("data");
-  data["requestId"] = requestId == nullptr ? "" : requestId;
-  data["deviceId"] = DEVICE_ID;
-  data["path"] = targetPath == nullptr ? "" : targetPath;
-  data["success"] = success;
-  data["len"] = len;
-  data["mime"] = "image/jpeg";
-  data["timestamp"] = millis();
+  WsJsonWriter json(webSocket);
+  json.beginObject();
+  json.field("type", "sd_preview_response");
+  json.beginObject("data");
+  json.field("requestId", requestId == nullptr ? "" : requestId);
+  json.field("deviceId", DEVICE_ID);
+  json.field("path", targetPath == nullptr ? "" : targetPath);
+  json.field("success", success);
+  json.field("len", len);
+  json.field("mime", "image/jpeg");
+  json.field("timestamp", millis());
   if (reason != nullptr && reason[0] != '\0') {
-    data["reason"] = reason;
+    json.field("reason", reason);
   }
 
-  String output;
-  serializeJson(doc, output);
-  webSocket.sendTXT(output);
+  json.endObject();
+  json.endObject();
+  json.finish();
+  wsOutboxNoteSent(WS_CLASS_CONTROL, json.bytesWritten());
 }
 
 static void processPendingAudioControl() {
@@ -3994,7 +5396,12 @@ static void processPendingAudioControl() {
 
   if (isAudioRunning()) {
     uint32_t now = millis();
+    xSemaphoreTake(audioEngineLock, portMAX_DELAY);
     audioPaused = !audioPaused;
+    if (!audioPaused) {
+      audioGaplessOutput->resync();
+    }
+    xSemaphoreGive(audioEngineLock);
     if (audioPaused) {
       if (audioPlaybackResumeMs != 0) {
         audioElapsedAccumMs += (uint32_t)(now - audioPlaybackResumeMs);
@@ -4057,11 +5464,57 @@ static void voiceCommandButtonCallback(lv_event_t *e) {
   pushInboxMessage("event", "Voice command", preset.text);
 }
 
+static void voiceCaptureTask(void *arg) {
+  (void)arg;
+  while (voiceCaptureRun) {
+    i2s_event_t event;
+    while (voiceI2sEventQueue != nullptr && xQueueReceive(voiceI2sEventQueue, &event, 0) == pdTRUE) {
+      if (event.type == I2S_EVENT_RX_Q_OVF) {
+        voiceDmaOverruns.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+
+    size_t bytesRead = 0;
+    esp_err_t err = i2s_read(VOICE_I2S_PORT, voiceRawChunk, sizeof(voiceRawChunk), &bytesRead, pdMS_TO_TICKS(50));
+    size_t framesRead = bytesRead / (sizeof(int32_t) * 2);
+    if (err != ESP_OK || framesRead == 0) {
+      continue;
+    }
+
+    const uint32_t conditionStart = micros();
+    pcmConditionBlock(&voiceConditioner, voiceRawChunk, framesRead, voiceCapturePcm);
+    const uint32_t conditionUs = micros() - conditionStart;
+    voiceConditionUsTotal += conditionUs;
+    if (conditionUs > voiceConditionUsMax) {
+      voiceConditionUsMax = conditionUs;
+    }
+    voiceConditionBlocks++;
+    micRingWrite(&voiceMicRing, voiceCapturePcm, (uint32_t)framesRead);
+    if (kwsEnabled && kwsTaskHandle != nullptr) {
+      micRingWrite(&kwsRing, voiceCapturePcm, (uint32_t)framesRead);
+      xTaskNotifyGive(kwsTaskHandle);
+    }
+  }
+
+  voiceCaptureTaskHandle = nullptr;
+  vTaskDelete(nullptr);
+}
+
 static bool ensureVoiceMicReady(char *reason, size_t reasonSize) {
   if (voiceMicInitialized) {
     return true;
   }
 
+  if (voiceRingStorage == nullptr) {
+    voiceRingStorage = (int16_t *)heap_caps_malloc(VOICE_RING_SAMPLES * sizeof(int16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (voiceRingStorage == nullptr) {
+      if (reason != nullptr && reasonSize > 0) {
+        snprintf(reason, reasonSize, "mic ring alloc failed");
+      }
+      return false;
+    }
+  }
+
   i2s_config_t micConfig = {};
   micConfig.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX);
   micConfig.sample_rate = VOICE_SAMPLE_RATE;
@@ -4081,7 +5534,7 @@ static bool ensureVoiceMicReady(char *reason, size_t reasonSize) {
   micConfig.bits_per_chan = I2S_BITS_PER_CHAN_32BIT;
 #endif
 
-  esp_err_t err = i2s_driver_install(VOICE_I2S_PORT, &micConfig, 0, nullptr);
+  esp_err_t err = i2s_driver_install(VOICE_I2S_PORT, &micConfig, 8, &voiceI2sEventQueue);
   if (err != ESP_OK) {
     if (reason != nullptr && reasonSize > 0) {
       snprintf(reason, reasonSize, "mic install err=0x%x", (unsigned int)err);
@@ -4106,6 +5559,26 @@ static bool ensureVoiceMicReady(char *reason, size_t reasonSize) {
 
   i2s_zero_dma_buffer(VOICE_I2S_PORT);
   i2s_start(VOICE_I2S_PORT);
+
+  micRingInit(&voiceMicRing, voiceRingStorage, VOICE_RING_SAMPLES);
+  pcmConditionReset(&voiceConditioner);
+  voiceConditionUsTotal = 0;
+  voiceConditionUsMax = 0;
+  voiceConditionBlocks = 0;
+  voiceDmaOverruns.store(0, std::memory_order_relaxed);
+  voiceCaptureRun = true;
+  TaskHandle_t handle = nullptr;
+  if (xTaskCreatePinnedToCore(voiceCaptureTask, "voice_cap", 4096, nullptr, VOICE_CAPTURE_TASK_PRIORITY, &handle, 1) != pdPASS) {
+    voiceCaptureRun = false;
+    i2s_stop(VOICE_I2S_PORT);
+    i2s_driver_uninstall(VOICE_I2S_PORT);
+    voiceI2sEventQueue = nullptr;
+    if (reason != nullptr && reasonSize > 0) {
+      snprintf(reason, reasonSize, "mic task create failed");
+    }
+    return false;
+  }
+  voiceCaptureTaskHandle = handle;
   voiceMicInitialized = true;
   return true;
 }
@@ -4114,9 +5587,199 @@ static void releaseVoiceMic() {
   if (!voiceMicInitialized) {
     return;
   }
+  // The capture task notices within one i2s_read timeout and deletes itself.
+  voiceCaptureRun = false;
+  const uint32_t waitStart = millis();
+  while (voiceCaptureTaskHandle != nullptr && (uint32_t)(millis() - waitStart) < 200) {
+    vTaskDelay(pdMS_TO_TICKS(5));
+  }
   i2s_stop(VOICE_I2S_PORT);
   i2s_driver_uninstall(VOICE_I2S_PORT);
+  voiceI2sEventQueue = nullptr;
   voiceMicInitialized = false;
+  Serial.printf(
+    "[Voice] mic released: ringDropped=%lu overruns=%lu dmaOverruns=%lu ringPeak=%lu clipped=%lu gainQ16=%ld conditionUs=%lu/%lu over %lu blocks\n",
+    (unsigned long)voiceMicRing.overrunSamples.load(),
+    (unsigned long)voiceMicRing.overrunEvents.load(),
+    (unsigned long)voiceDmaOverruns.load(),
+    (unsigned long)voiceMicRing.peakFill.load(),
+    (unsigned long)voiceConditioner.clipped,
+    (long)voiceConditioner.gainQ16,
+    (unsigned long)((voiceConditionBlocks > 0) ? voiceConditionUsTotal / voiceConditionBlocks : 0),
+    (unsigned long)voiceConditionUsMax,
+    (unsigned long)voiceConditionBlocks
+  );
+}
+
+static void kwsTask(void *arg) {
+  (void)arg;
+  int16_t hop[KWS_HOP_SAMPLES];
+  float mfcc[KWS_MFCC_COUNT];
+  uint8_t hopsSinceInfer = 0;
+  uint16_t quietHops = UINT16_MAX;
+  bool wasStreaming = false;
+
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(200));
+    while (micRingAvailable(&kwsRing) >= KWS_HOP_SAMPLES) {
+      micRingRead(&kwsRing, hop, KWS_HOP_SAMPLES);
+
+      // The stream owns the mic while it runs; start from a clean window after.
+      if (voiceMicStreaming) {
+        wasStreaming = true;
+        continue;
+      }
+      if (wasStreaming) {
+        wasStreaming = false;
+        kwsDetectorReset(&kwsDetector);
+        hopsSinceInfer = 0;
+        quietHops = UINT16_MAX;
+      }
+
+      const uint32_t featureStart = micros();
+      kwsFrontEndProcess(kwsFrontEnd, hop, mfcc);
+      kwsDetectorPush(&kwsDetector, &kwsModel, mfcc);
+      kwsFeatureUsTotal.fetch_add(micros() - featureStart, std::memory_order_relaxed);
+      kwsHops.fetch_add(1, std::memory_order_relaxed);
+
+      if (kwsFrontEnd->lastEnergy >= KWS_GATE_ENERGY) {
+        quietHops = 0;
+      } else if (quietHops < UINT16_MAX) {
+        quietHops++;
+      }
+      if (++hopsSinceInfer < KWS_INFER_EVERY_HOPS) {
+        continue;
+      }
+      hopsSinceInfer = 0;
+
+      // Only run the model while the window still holds a loud hop; silence
+      // costs just the front end.
+      float score = -1.0f;
+      if (quietHops < kwsModel.frames && kwsDetector.filled >= kwsModel.frames) {
+        const uint32_t inferStart = micros();
+        score = kwsModelRun(&kwsModel, kwsDetector.window);
+        kwsInferUsTotal.fetch_add(micros() - inferStart, std::memory_order_relaxed);
+        kwsInferences.fetch_add(1, std::memory_order_relaxed);
+      }
+      if (kwsDetectorUpdate(&kwsDetector, &kwsModel, score, millis())) {
+        kwsDetections.fetch_add(1, std::memory_order_relaxed);
+        kwsTriggered.store(true, std::memory_order_release);
+      }
+    }
+  }
+}
+
+static void freeWakeWordBuffers() {
+  heap_caps_free(kwsModelBlob);
+  heap_caps_free(kwsFrontEnd);
+  heap_caps_free(kwsRingStorage);
+  kwsModelBlob = nullptr;
+  kwsFrontEnd = nullptr;
+  kwsRingStorage = nullptr;
+}
+
+// Order matters for the failure paths: buffers, then the mic, then the task
+// last, so a failure never leaves a task running on freed buffers or a mic
+// nobody listens to. The capture task only feeds kwsRing once kwsEnabled is set.
+static void initWakeWord() {
+  if (!sdMounted || !SD_MMC.exists(KWS_MODEL_PATH)) {
+    Serial.println("[KWS] no model on SD, wake word disabled");
+    return;
+  }
+
+  File file = SD_MMC.open(KWS_MODEL_PATH, FILE_READ);
+  const size_t len = file ? (size_t)file.size() : 0;
+  if (len == 0 || len > KWS_MODEL_MAX_BYTES) {
+    Serial.printf("[KWS] bad model size: %u\n", (unsigned)len);
+    file.close();
+    return;
+  }
+  kwsModelBlob = (uint8_t *)heap_caps_malloc(len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  kwsFrontEnd = (KwsFrontEnd *)heap_caps_malloc(sizeof(KwsFrontEnd), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  kwsRingStorage = (int16_t *)heap_caps_malloc(KWS_RING_SAMPLES * sizeof(int16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  const bool allocated = kwsModelBlob != nullptr && kwsFrontEnd != nullptr && kwsRingStorage != nullptr;
+  const bool loaded = allocated && file.read(kwsModelBlob, len) == len;
+  file.close();
+  if (!loaded || !kwsModelParse(kwsModelBlob, len, &kwsModel)) {
+    Serial.printf("[KWS] model load failed (%s)\n", allocated ? "parse" : "alloc");
+    freeWakeWordBuffers();
+    return;
+  }
+
+  kwsFrontEndInit(kwsFrontEnd);
+  kwsDetectorReset(&kwsDetector);
+  micRingInit(&kwsRing, kwsRingStorage, KWS_RING_SAMPLES);
+
+  char reason[64] = "";
+  if (!ensureVoiceMicReady(reason, sizeof(reason))) {
+    Serial.printf("[KWS] mic init failed: %s\n", reason);
+    freeWakeWordBuffers();
+    return;
+  }
+
+  TaskHandle_t handle = nullptr;
+  if (xTaskCreatePinnedToCore(kwsTask, "kws", 4096, nullptr, KWS_TASK_PRIORITY, &handle, 0) != pdPASS) {
+    Serial.println("[KWS] task create failed");
+    if (!voiceMicStreaming) {
+      releaseVoiceMic();
+    }
+    freeWakeWordBuffers();
+    return;
+  }
+  kwsTaskHandle = handle;
+  kwsEnabled = true;
+  Serial.printf(
+    "[KWS] listening: frames=%u hidden=%u threshold=%.2f\n",
+    (unsigned)kwsModel.frames,
+    (unsigned)kwsModel.hidden,
+    kwsModel.threshold
+  );
+  kwsLastStatsLogMs = millis();
+}
+
+static void processWakeWord() {
+  if (!kwsEnabled) {
+    return;
+  }
+
+  const uint32_t now = millis();
+  if ((uint32_t)(now - kwsLastStatsLogMs) >= KWS_STATS_LOG_INTERVAL_MS) {
+    kwsLastStatsLogMs = now;
+    const uint32_t hops = kwsHops.load(std::memory_order_relaxed);
+    const uint32_t inferences = kwsInferences.load(std::memory_order_relaxed);
+    Serial.printf(
+      "[KWS] hops=%lu inferences=%lu detections=%lu featureUsAvg=%lu inferUsAvg=%lu dropped=%lu\n",
+      (unsigned long)hops,
+      (unsigned long)inferences,
+      (unsigned long)kwsDetections.load(std::memory_order_relaxed),
+      (unsigned long)(hops ? kwsFeatureUsTotal.load(std::memory_order_relaxed) / hops : 0),
+      (unsigned long)(inferences ? kwsInferUsTotal.load(std::memory_order_relaxed) / inferences : 0),
+      (unsigned long)kwsRing.overrunSamples.load(std::memory_order_relaxed)
+    );
+  }
+
+  if (!voiceMicStreaming) {
+    // Idle: keep only the pre-roll window for a wake-started stream.
+    micRingTrim(&voiceMicRing, KWS_PREROLL_SAMPLES);
+  }
+
+  if (!kwsTriggered.exchange(false, std::memory_order_acquire)) {
+    return;
+  }
+  Serial.printf("[KWS] wake word detected (score %.2f)\n", kwsDetector.lastScore);
+  if (voiceMicStreaming || !isConnected) {
+    return;
+  }
+
+  if (currentPage != UI_PAGE_VOICE) {
+    showPage(UI_PAGE_VOICE);
+  }
+  pushInboxMessage("event", "Wake word", "Listening...");
+  voiceWakeStarted = true;
+  setVoiceMicStreaming(true, "wake word");
+  if (!voiceMicStreaming) {
+    voiceWakeStarted = false;
+  }
 }
 
 static void sendVoiceStreamStart() {
@@ -4124,21 +5787,43 @@ static void sendVoiceStreamStart() {
     return;
   }
 
-  StaticJsonDocument<320> doc;
-  doc["type"] = "voice_stream_start";
-  JsonObject data = doc.createNestedObject("data");
-  data["deviceId"] = DEVICE_ID;
-  data["streamId"] = voiceActiveStreamId;
-  data["sampleRate"] = VOICE_SAMPLE_RATE;
-  data["channels"] = 1;
-  data["format"] = "pcm_s16le";
-  data["chunkSamples"] = (int)VOICE_SAMPLES_PER_CHUNK;
-  data["source"] = "esp32_mic";
-  data["timestamp"] = millis();
-
-  String output;
-  serializeJson(doc, output);
-  webSocket.sendTXT(output);
+  WsJsonWriter json(webSocket);
+  json.beginObject();
+  json.field("type", "voice_stream_start");
+  json.beginObject("data");
+  json.field("deviceId", DEVICE_ID);
+  json.field("streamId", voiceActiveStreamId);
+  json.field("sampleRate", VOICE_SAMPLE_RATE);
+  json.field("channels", 1);
+  json.field("format", "ima_adpcm");
+  json.beginArray("formats");
+  json.value("ima_adpcm");
+  json.value("pcm_s16le");
+  json.endArray();
+  json.field("chunkSamples", (int)VOICE_SAMPLES_PER_CHUNK);
+  json.field("source", "esp32_mic");
+  json.field("trigger", voiceWakeStarted ? "wake_word" : "manual");
+  json.field("timestamp", millis());
+
+  json.endObject();
+  json.endObject();
+  json.finish();
+  wsOutboxNoteSent(WS_CLASS_REALTIME, json.bytesWritten());
+}
+
+// Encoder and VAD totals for the session. Sent with voice_stream_stop, and
+// with the "end" segment when the device ends the stream on silence, since
+// no stop follows then.
+static void writeVoiceStreamStats(WsJsonWriter &json) {
+  json.field("chunksSent", voiceChunksSent);
+  json.field("bytesSent", voiceBytesSent);
+  json.field("format", (voiceStreamFormat == VOICE_FORMAT_IMA_ADPCM) ? "ima_adpcm" : "pcm_s16le");
+  json.field("encodeUsAvg", (voiceChunksSent > 0) ? voiceEncodeUsTotal / voiceChunksSent : 0);
+  json.field("encodeUsMax", voiceEncodeUsMax);
+  json.field("vadFrames", voiceVad.frames);
+  json.field("speechFrames", voiceVad.speechFrames);
+  json.field("segments", voiceVad.segments);
+  json.field("vadUsAvg", (voiceVad.frames > 0) ? voiceVadUsTotal / voiceVad.frames : 0);
 }
 
 static void sendVoiceStreamStop(const char *reason) {
@@ -4146,38 +5831,69 @@ static void sendVoiceStreamStop(const char *reason) {
     return;
   }
 
-  StaticJsonDocument<320> doc;
-  doc["type"] = "voice_stream_stop";
-  JsonObject data = doc.createNestedObject("data");
-  data["deviceId"] = DEVICE_ID;
-  data["streamId"] = voiceActiveStreamId;
-  data["reason"] = (reason == nullptr) ? "manual" : reason;
-  data["chunksSent"] = voiceChunksSent;
-  data["bytesSent"] = voiceBytesSent;
-  data["timestamp"] = millis();
+  WsJsonWriter json(webSocket);
+  json.beginObject();
+  json.field("type", "voice_stream_stop");
+  json.beginObject("data");
+  json.field("deviceId", DEVICE_ID);
+  json.field("streamId", voiceActiveStreamId);
+  json.field("reason", (reason == nullptr) ? "manual" : reason);
+  writeVoiceStreamStats(json);
+  json.field("timestamp", millis());
 
-  String output;
-  serializeJson(doc, output);
-  webSocket.sendTXT(output);
+  json.endObject();
+  json.endObject();
+  json.finish();
+  wsOutboxNoteSent(WS_CLASS_REALTIME, json.bytesWritten());
 }
 
-static void sendVoiceStreamChunkMeta(size_t byteLen, uint8_t levelPercent) {
+static void sendVoiceStreamChunkMeta(size_t byteLen, size_t samples, uint8_t levelPercent) {
   if (!isConnected || !voiceMicStreaming || voiceActiveStreamId[0] == '\0') {
     return;
   }
 
-  StaticJsonDocument<256> doc;
-  doc["type"] = "voice_stream_chunk_meta";
-  JsonObject data = doc.createNestedObject("data");
-  data["streamId"] = voiceActiveStreamId;
-  data["seq"] = voiceChunkSeq;
-  data["len"] = (int)byteLen;
-  data["level"] = levelPercent;
-  data["timestamp"] = millis();
+  WsJsonWriter json(webSocket);
+  json.beginObject();
+  json.field("type", "voice_stream_chunk_meta");
+  json.beginObject("data");
+  json.field("streamId", voiceActiveStreamId);
+  json.field("seq", voiceChunkSeq);
+  json.field("len", (int)byteLen);
+  json.field("samples", (int)samples);
+  json.field("level", levelPercent);
+  json.field("overrunSamples", voiceMicRing.overrunSamples.load(std::memory_order_relaxed));
+  json.field("dmaOverruns", voiceDmaOverruns.load(std::memory_order_relaxed));
+  json.field("timestamp", millis());
 
-  String output;
-  serializeJson(doc, output);
-  webSocket.sendTXT(output);
+  json.endObject();
+  json.endObject();
+  json.finish();
+  wsOutboxNoteSent(WS_CLASS_REALTIME, json.bytesWritten());
+}
+
+static void sendVoiceStreamSegment(const char *event) {
+  if (!isConnected || !voiceMicStreaming || voiceActiveStreamId[0] == '\0') {
+    return;
+  }
+
+  WsJsonWriter json(webSocket);
+  json.beginObject();
+  json.field("type", "voice_stream_segment");
+  json.beginObject("data");
+  json.field("streamId", voiceActiveStreamId);
+  json.field("event", event);
+  json.field("seq", voiceChunkSeq);
+  if (strcmp(event, "end") == 0) {
+    writeVoiceStreamStats(json);
+  } else {
+    json.field("speechFrames", voiceVad.speechFrames);
+  }
+  json.field("timestamp", millis());
+
+  json.endObject();
+  json.endObject();
+  json.finish();
+  wsOutboxNoteSent(WS_CLASS_REALTIME, json.bytesWritten());
 }
 
 static void setVoiceMicStreaming(bool enabled, const char *reason, bool notifyServer) {
@@ -4194,6 +5910,8 @@ static void setVoiceMicStreaming(bool enabled, const char *reason, bool notifySe
       return;
     }
 
+    // The speaker would feed straight back into the mic.
+    stopNetAudioStream("mic started", true);
     if (isAudioRunning()) {
       stopAudioPlayback(true);
       setAudioStatus("Audio paused by mic", lv_color_hex(0xFFB74D));
@@ -4216,9 +5934,16 @@ static void setVoiceMicStreaming(bool enabled, const char *reason, bool notifySe
     voiceLastChunkMs = millis();
     voiceLastStartSentMs = voiceLastChunkMs;
     voiceLastLevelPercent = 0;
+    voiceStreamFormat = VOICE_FORMAT_PCM;
+    imaAdpcmReset(&voiceAdpcmState);
+    voiceEncodeUsTotal = 0;
+    voiceEncodeUsMax = 0;
+    voiceVadReset(&voiceVad);
+    voiceVadUsTotal = 0;
+    voicePrerollHead = 0;
+    voicePrerollCount = 0;
     voiceStreamStartAcked = false;
     voiceMicStreaming = true;
-    i2s_zero_dma_buffer(VOICE_I2S_PORT);
     sendVoiceStreamStart();
 
     if (voiceStatusLabel != nullptr) {
@@ -4238,11 +5963,17 @@ static void setVoiceMicStreaming(bool enabled, const char *reason, bool notifySe
   bool wasStreaming = voiceMicStreaming;
   voiceMicStreaming = false;
   voiceStreamStartAcked = false;
+  if (wasStreaming) {
+    voiceSpeechEndMs = millis();
+  }
   if (notifyServer && wasStreaming) {
     sendVoiceStreamStop((reason == nullptr) ? "manual" : reason);
   }
   voiceActiveStreamId[0] = '\0';
-  releaseVoiceMic();
+  voiceWakeStarted = false;
+  if (!kwsEnabled) {
+    releaseVoiceMic();
+  }
 
   if (voiceMicToggleLabel != nullptr) {
     lv_label_set_text(voiceMicToggleLabel, "Start Mic");
@@ -4254,12 +5985,49 @@ static void setVoiceMicStreaming(bool enabled, const char *reason, bool notifySe
   }
 }
 
+static uint8_t voiceLevelPercent(uint32_t avgAbs) {
+  uint32_t scaled = (avgAbs * 100UL) / 4500UL;
+  return (uint8_t)((scaled > 100UL) ? 100UL : scaled);
+}
+
+static void sendVoiceChunk(const int16_t *pcm, size_t frames, uint8_t levelPercent) {
+  const uint8_t *wire = (const uint8_t *)pcm;
+  size_t wireBytes = frames * sizeof(int16_t);
+  if (voiceStreamFormat == VOICE_FORMAT_IMA_ADPCM) {
+    const uint32_t encodeStart = micros();
+    wireBytes = imaAdpcmEncodeChunk(&voiceAdpcmState, pcm, frames, voiceEncodedChunk);
+    wire = voiceEncodedChunk;
+    const uint32_t encodeUs = micros() - encodeStart;
+    voiceEncodeUsTotal += encodeUs;
+    if (encodeUs > voiceEncodeUsMax) {
+      voiceEncodeUsMax = encodeUs;
+    }
+  }
+
+  sendVoiceStreamChunkMeta(wireBytes, frames, levelPercent);
+  webSocket.sendBIN(wire, wireBytes);
+  wsOutboxNoteSent(WS_CLASS_REALTIME, wireBytes);
+
+  voiceChunkSeq++;
+  voiceChunksSent++;
+  voiceBytesSent += (uint32_t)wireBytes;
+  voiceLastChunkMs = millis();
+}
+
 static void processVoiceMicStreaming() {
   if (!voiceMicStreaming || !voiceMicInitialized || !isConnected) {
     return;
   }
 
   if (!voiceStreamStartAcked) {
+    // Server not ready yet: audio captured before the ack is not sent, except
+    // after a wake word, where it is held (keeping room for the capture task)
+    // so the command right after the keyword is not lost.
+    if (voiceWakeStarted) {
+      micRingTrim(&voiceMicRing, VOICE_RING_SAMPLES - 2 * VOICE_CAPTURE_FRAMES);
+    } else {
+      micRingDiscard(&voiceMicRing);
+    }
     uint32_t now = millis();
     if ((uint32_t)(now - voiceLastStartSentMs) >= 1200) {
       sendVoiceStreamStart();
@@ -4268,77 +6036,62 @@ static void processVoiceMicStreaming() {
     return;
   }
 
-  size_t bytesRead = 0;
-  esp_err_t err = i2s_read(VOICE_I2S_PORT, voiceRawChunk, sizeof(voiceRawChunk), &bytesRead, 0);
-  if (err != ESP_OK || bytesRead == 0) {
-    return;
-  }
-
-  size_t framesRead = bytesRead / (sizeof(int32_t) * 2);
-  if (framesRead == 0) {
-    return;
-  }
-  if (framesRead > VOICE_SAMPLES_PER_CHUNK) {
-    framesRead = VOICE_SAMPLES_PER_CHUNK;
-  }
-
-  uint32_t peakAbsRaw = 0;
-  for (size_t i = 0; i < framesRead; ++i) {
-    int32_t left = voiceRawChunk[i * 2];
-    int32_t right = voiceRawChunk[i * 2 + 1];
-
-    uint32_t leftAbs = (uint32_t)((left >= 0) ? left : -left);
-    uint32_t rightAbs = (uint32_t)((right >= 0) ? right : -right);
-    int32_t chosen = (leftAbs >= rightAbs) ? left : right;
-    voiceMonoRaw[i] = chosen;
-
-    uint32_t chosenAbs = (leftAbs >= rightAbs) ? leftAbs : rightAbs;
-    if (chosenAbs > peakAbsRaw) {
-      peakAbsRaw = chosenAbs;
+  // Catch up a few chunks per loop after a stall; the ring holds the rest.
+  for (uint8_t analyzed = 0; analyzed < VOICE_MAX_CHUNKS_PER_LOOP; ++analyzed) {
+    if (micRingAvailable(&voiceMicRing) < VOICE_SAMPLES_PER_CHUNK) {
+      break;
     }
-  }
+    const size_t framesRead = micRingRead(&voiceMicRing, voicePcmChunk, VOICE_SAMPLES_PER_CHUNK);
 
-  uint8_t shift = 0;
-  while (shift < 24 && (peakAbsRaw >> shift) > 24000UL) {
-    shift++;
-  }
+    const uint32_t vadStart = micros();
+    const VoiceVadEvent event = voiceVadProcess(&voiceVad, voicePcmChunk, framesRead);
+    voiceVadUsTotal += micros() - vadStart;
+    const uint8_t levelPercent = voiceLevelPercent(voiceVad.lastEnergy);
+    voiceLastLevelPercent = levelPercent;
 
-  uint64_t absSum = 0;
-  for (size_t i = 0; i < framesRead; ++i) {
-    int32_t scaled32 = (shift > 0) ? (voiceMonoRaw[i] >> shift) : voiceMonoRaw[i];
-    if (scaled32 > 32767) {
-      scaled32 = 32767;
-    } else if (scaled32 < -32768) {
-      scaled32 = -32768;
+    if (event == VOICE_VAD_SPEECH_START) {
+      sendVoiceStreamSegment("start");
+      // Pre-roll keeps the onset frames the detector needed to decide.
+      for (uint8_t i = 0; i < voicePrerollCount; ++i) {
+        const uint8_t slot = (uint8_t)((voicePrerollHead + VOICE_PREROLL_CHUNKS - voicePrerollCount + i) % VOICE_PREROLL_CHUNKS);
+        sendVoiceChunk(voicePreroll[slot], VOICE_SAMPLES_PER_CHUNK, voicePrerollLevel[slot]);
+      }
+      voicePrerollCount = 0;
     }
 
-    int16_t s16 = (int16_t)scaled32;
-    voicePcmChunk[i] = s16;
-    int32_t absVal = (s16 >= 0) ? s16 : -s16;
-    absSum += (uint32_t)absVal;
-  }
+    if (voiceVadShouldSend(&voiceVad)) {
+      sendVoiceChunk(voicePcmChunk, framesRead, levelPercent);
+    } else if (!voiceVad.inSpeech && framesRead == VOICE_SAMPLES_PER_CHUNK) {
+      memcpy(voicePreroll[voicePrerollHead], voicePcmChunk, sizeof(voicePcmChunk));
+      voicePrerollLevel[voicePrerollHead] = levelPercent;
+      voicePrerollHead = (uint8_t)((voicePrerollHead + 1) % VOICE_PREROLL_CHUNKS);
+      if (voicePrerollCount < VOICE_PREROLL_CHUNKS) {
+        voicePrerollCount++;
+      }
+    }
 
-  uint32_t avgAbs = (framesRead > 0) ? (uint32_t)(absSum / framesRead) : 0;
-  uint32_t scaled = (avgAbs * 100UL) / 4500UL;
-  if (scaled > 100UL) {
-    scaled = 100UL;
+    if (event == VOICE_VAD_SPEECH_END) {
+      // The end marker tells the server to finalize ASR; it closes the
+      // stream itself once the last result is in.
+      sendVoiceStreamSegment("end");
+      setVoiceMicStreaming(false, "End of speech", false);
+      // The user went quiet when the trailing silence began.
+      voiceSpeechEndMs = millis() - (uint32_t)VOICE_VAD_ENDPOINT_FRAMES * VOICE_SAMPLES_PER_CHUNK * 1000UL / VOICE_SAMPLE_RATE;
+      return;
+    }
+    if (voiceVad.segments == 0 && !voiceVad.inSpeech &&
+        voiceVad.frames >= (VOICE_NO_SPEECH_TIMEOUT_MS * VOICE_SAMPLE_RATE) / (1000UL * VOICE_SAMPLES_PER_CHUNK)) {
+      setVoiceMicStreaming(false, "No speech detected", true);
+      return;
+    }
   }
-  uint8_t levelPercent = (uint8_t)scaled;
-  voiceLastLevelPercent = levelPercent;
-
-  size_t pcmBytes = framesRead * sizeof(int16_t);
-  sendVoiceStreamChunkMeta(pcmBytes, levelPercent);
-  webSocket.sendBIN((uint8_t *)voicePcmChunk, pcmBytes);
-
-  voiceChunkSeq++;
-  voiceChunksSent++;
-  voiceBytesSent += (uint32_t)pcmBytes;
-  voiceLastChunkMs = millis();
 
-  if (voiceResultLabel != nullptr && (voiceChunksSent % 6) == 0) {
+  if (voiceResultLabel != nullptr && (uint32_t)(millis() - voiceLastLabelMs) >= 240) {
+    voiceLastLabelMs = millis();
     lv_label_set_text_fmt(
       voiceResultLabel,
-      "Level: %u%% | %lu chunks | %lu KB",
+      "%s | Level: %u%% | %lu chunks | %lu KB",
+      voiceVad.inSpeech ? "Speech" : "Listening",
       (unsigned int)voiceLastLevelPercent,
       (unsigned long)voiceChunksSent,
       (unsigned long)(voiceBytesSent / 1024)
@@ -4364,49 +6117,40 @@ static void beginWebSocketClient() {
 }
 
 static void updateDiagnosticStatus() {
-  if (diagNtpLabel != nullptr) {
-    lv_label_set_text(diagNtpLabel, ntpSynced ? "NTP: synced" : "NTP: syncing");
+  // Skip building the strings below (IP, SD summary) while the settings
+  // page is not on screen; showPage() re-syncs it.
+  if (pages[UI_PAGE_SETTINGS] == nullptr || !uiBindVisible(pages[UI_PAGE_SETTINGS])) {
+    ui_bind_stats.skippedHidden++;
+    return;
   }
 
-  if (diagIpLabel != nullptr) {
-    if (WiFi.status() == WL_CONNECTED) {
-      lv_label_set_text_fmt(diagIpLabel, "IP: %s", WiFi.localIP().toString().c_str());
-    } else {
-      lv_label_set_text(diagIpLabel, "IP: --");
-    }
-  }
+  uiBindLabelText(diagNtpLabel, ntpSynced ? "NTP: synced" : "NTP: syncing");
 
-  if (diagRssiLabel != nullptr) {
-    if (WiFi.status() == WL_CONNECTED) {
-      lv_label_set_text_fmt(diagRssiLabel, "RSSI: %d dBm", WiFi.RSSI());
-    } else {
-      lv_label_set_text(diagRssiLabel, "RSSI: --");
-    }
+  if (WiFi.status() == WL_CONNECTED) {
+    uiBindLabelFmt(diagIpLabel, "IP: %s", WiFi.localIP().toString().c_str());
+    uiBindLabelFmt(diagRssiLabel, "RSSI: %d dBm", WiFi.RSSI());
+  } else {
+    uiBindLabelText(diagIpLabel, "IP: --");
+    uiBindLabelText(diagRssiLabel, "RSSI: --");
   }
 
-  if (diagUptimeLabel != nullptr) {
-    uint32_t total = millis() / 1000;
-    uint32_t h = total / 3600;
-    uint32_t m = (total / 60) % 60;
-    uint32_t s = total % 60;
-    lv_label_set_text_fmt(diagUptimeLabel, "Uptime: %02lu:%02lu:%02lu", h, m, s);
-  }
+  uint32_t total = millis() / 1000;
+  uiBindLabelFmt(diagUptimeLabel, "Uptime: %02lu:%02lu:%02lu",
+                 (unsigned long)(total / 3600), (unsigned long)((total / 60) % 60), (unsigned long)(total % 60));
 
-  if (diagServerLabel != nullptr) {
-    lv_label_set_text_fmt(diagServerLabel, "Server: %s:%d", WS_SERVER_HOST, WS_SERVER_PORT);
-  }
+  uiBindLabelFmt(diagServerLabel, "Server: %s:%d", WS_SERVER_HOST, WS_SERVER_PORT);
 
   if (diagSdLabel != nullptr) {
     if (!sdInitAttempted) {
-      lv_label_set_text(diagSdLabel, "SD: checking...");
+      uiBindLabelText(diagSdLabel, "SD: checking...");
     } else if (!sdMounted) {
-      lv_label_set_text_fmt(diagSdLabel, "SD: %s", sdMountReason);
+      uiBindLabelFmt(diagSdLabel, "SD: %s", sdMountReason);
     } else {
       char totalText[16];
       char usedText[16];
       formatStorageSize(sdTotalBytes, totalText, sizeof(totalText));
       formatStorageSize(sdUsedBytes, usedText, sizeof(usedText));
-      lv_label_set_text_fmt(
+      uiBindLabelFmt(
         diagSdLabel,
         "SD: %s %s %s/%s D%lu F%lu",
         sdMode1Bit ? "1-bit" : "4-bit",
@@ -4419,19 +6163,47 @@ static void updateDiagnosticStatus() {
     }
   }
 
-  if (diagSdRootLabel != nullptr) {
-    if (!sdMounted) {
-      lv_label_set_text(diagSdRootLabel, "Root: --");
-    } else {
-      lv_label_set_text_fmt(diagSdRootLabel, "Root: %s", sdRootPreview);
-    }
+  if (!sdMounted) {
+    uiBindLabelText(diagSdRootLabel, "Root: --");
+  } else {
+    uiBindLabelFmt(diagSdRootLabel, "Root: %s", sdRootPreview);
   }
+
+  uiBindLabelFmt(
+    diagAudioLabel,
+    "Audio: UR %lu / GL %lu / JB %lu",
+    (unsigned long)((audioGaplessOutput != nullptr) ? audioGaplessOutput->underruns() : 0),
+    (unsigned long)audioGaplessSwitches,
+    (unsigned long)(netAudioUnderrunsTotal + (netAudioActive ? netAudioJitter.stats.underruns : 0))
+  );
+
+  // Video and wallpaper pacers summed; bins are <1/<2/<4/<8/<16/>=16 ms
+  // (FRAME_PACER_BIN_MS), [Pacer] on serial has them per pacer.
+  FramePacerStats pacer = videoPacer.stats;
+  const FramePacerStats &wp = wallpaperPacer.stats;
+  pacer.synced += wp.synced;
+  pacer.teMissed += wp.teMissed;
+  pacer.stalls += wp.stalls;
+  pacer.jitterUsMax = (wp.jitterUsMax > pacer.jitterUsMax) ? wp.jitterUsMax : pacer.jitterUsMax;
+  for (int i = 0; i < FRAME_PACER_BINS; ++i) {
+    pacer.hist[i] += wp.hist[i];
+  }
+  uiBindLabelFmt(diagPacerLabel, "TE %lu/%lu St %lu",
+                 (unsigned long)pacer.synced, (unsigned long)pacer.teMissed, (unsigned long)pacer.stalls);
+  uiBindLabelFmt(diagPacerHistLabel, "Jitter %lu/%lu/%lu/%lu/%lu/%lu max %lu.%lu ms",
+                 (unsigned long)pacer.hist[0], (unsigned long)pacer.hist[1], (unsigned long)pacer.hist[2],
+                 (unsigned long)pacer.hist[3], (unsigned long)pacer.hist[4], (unsigned long)pacer.hist[5],
+                 (unsigned long)(pacer.jitterUsMax / 1000), (unsigned long)((pacer.jitterUsMax % 1000) / 100));
 }
 
 static void diagnosticsTimerCallback(lv_timer_t *timer) {
   (void)timer;
   updateDiagnosticStatus();
   refreshInboxView();
+  logUiTextFontStats();
+  logImgTransformStats();
+  logLayerComposeStats();
+  logFramePacerStats();
 }
 
 static void reconnectWifiNow() {
@@ -4555,105 +6327,40 @@ static void settingsActionEventCallback(lv_event_t *e) {
     case SETTINGS_ACTION_REBOOT:
       setActionStatus("Queue: reboot");
       break;
-    default:
-      break;
-  }
-}
-
-static void brightnessSliderEventCallback(lv_event_t *e) {
-  lv_event_code_t code = lv_event_get_code(e);
-  if (code != LV_EVENT_VALUE_CHANGED && code != LV_EVENT_RELEASED) {
-    return;
-  }
-
-  lv_obj_t *slider = lv_event_get_target(e);
-  uint8_t value = (uint8_t)lv_slider_get_value(slider);
-  applyBrightness(value, code == LV_EVENT_RELEASED);
-  if (code == LV_EVENT_RELEASED) {
-    setActionStatus(String("Brightness saved: ") + value + "%");
-  }
-}
-
-static lv_obj_t *createSettingsButton(lv_obj_t *parent, const char *text, lv_coord_t x, lv_coord_t y, SettingsAction action) {
-  lv_obj_t *btn = lv_btn_create(parent);
-  lv_obj_set_size(btn, 136, 40);
-  lv_obj_align(btn, LV_ALIGN_TOP_LEFT, x, y);
-  lv_obj_set_style_radius(btn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(btn, lv_color_hex(0x1F1F1F), LV_PART_MAIN);
-  lv_obj_set_style_bg_color(btn, lv_color_hex(0x2B2B2B), LV_PART_MAIN | LV_STATE_PRESSED);
-  lv_obj_set_style_border_color(btn, lv_color_hex(0x3A3A3A), LV_PART_MAIN);
-  lv_obj_set_style_border_width(btn, 1, LV_PART_MAIN);
-  lv_obj_add_flag(btn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
-  attachGestureHandlers(btn);
-  lv_obj_add_event_cb(btn, settingsActionEventCallback, LV_EVENT_CLICKED, (void *)((intptr_t)action));
-
-  lv_obj_t *label = lv_label_create(btn);
-  lv_label_set_text(label, text);
-  lv_obj_center(label);
-  return btn;
-}
-
-static bool shouldSuppressClick() {
-  return (int32_t)(millis() - suppressClickUntilMs) < 0;
-}
-
-static void suppressClicksForMs(uint32_t durationMs) {
-  suppressClickUntilMs = millis() + durationMs;
-}
-
-static bool getActiveTouchPoint(lv_point_t *point) {
-  if (point == nullptr) {
-    return false;
-  }
-  lv_indev_t *indev = lv_indev_get_act();
-  if (indev == nullptr) {
-    return false;
-  }
-  lv_indev_get_point(indev, point);
-  return true;
-}
-
-static void suppressClicksAfterHome() {
-  suppressClicksForMs(CLICK_SUPPRESS_MS_AFTER_HOME);
-}
-
-static void updatePageIndicator() {
-  if (pageIndicatorLabel != nullptr) {
-    lv_obj_add_flag(pageIndicatorLabel, LV_OBJ_FLAG_HIDDEN);
+    default:
+      break;
   }
 }
 
-static void showPage(int pageIndex) {
-  if (pageIndex < 0) {
-    pageIndex += UI_PAGE_COUNT;
+static void brightnessSliderEventCallback(lv_event_t *e) {
+  lv_event_code_t code = lv_event_get_code(e);
+  if (code != LV_EVENT_VALUE_CHANGED && code != LV_EVENT_RELEASED) {
+    return;
   }
-  if (pageIndex >= UI_PAGE_COUNT) {
-    pageIndex %= UI_PAGE_COUNT;
+
+  lv_obj_t *slider = lv_event_get_target(e);
+  uint8_t value = (uint8_t)lv_slider_get_value(slider);
+  applyBrightness(value, code == LV_EVENT_RELEASED);
+  if (code == LV_EVENT_RELEASED) {
+    setActionStatus(String("Brightness saved: ") + value + "%");
   }
+}
 
-  int previousPage = currentPage;
-  if (previousPage == UI_PAGE_VOICE && pageIndex != UI_PAGE_VOICE && voiceMicStreaming) {
+// Firmware side of the page transitions in ui/ui_pages.h.
+static void pageLeaving(int previousPage, int nextPage) {
+  if (previousPage == UI_PAGE_VOICE && nextPage != UI_PAGE_VOICE && voiceMicStreaming) {
     setVoiceMicStreaming(false, "Mic stopped (leave page)", true);
   }
-  if (previousPage == UI_PAGE_VIDEO_PLAYER && pageIndex != UI_PAGE_VIDEO_PLAYER && videoPlaying) {
+  if (previousPage == UI_PAGE_VIDEO_PLAYER && nextPage != UI_PAGE_VIDEO_PLAYER && videoPlaying) {
     stopVideoPlayback(true);
   }
+}
 
-  currentPage = pageIndex;
-  for (int i = 0; i < UI_PAGE_COUNT; ++i) {
-    if (pages[i] == nullptr) {
-      continue;
-    }
-    if (i == currentPage) {
-      lv_obj_clear_flag(pages[i], LV_OBJ_FLAG_HIDDEN);
-    } else {
-      lv_obj_add_flag(pages[i], LV_OBJ_FLAG_HIDDEN);
-    }
-  }
-  if (currentPage == UI_PAGE_HOME) {
-    refreshHomeShortcutSlots();
+static void pageEntered(int previousPage, int page) {
+  if (page == UI_PAGE_MONITOR || previousPage == UI_PAGE_MONITOR) {
+    sendStatsStreamConfig(false);
   }
-  if (currentPage == UI_PAGE_PHOTO_FRAME) {
+  if (page == UI_PAGE_PHOTO_FRAME) {
     if (sdMounted && sdPhotoCount <= 0) {
       loadSdPhotoList();
     }
@@ -4661,385 +6368,42 @@ static void showPage(int pageIndex) {
     lastPhotoAutoAdvanceMs = millis();
     requestPhotoFrameSettings(true);
   }
-  if (currentPage == UI_PAGE_AUDIO_PLAYER) {
+  if (page == UI_PAGE_AUDIO_PLAYER) {
     if (sdMounted && sdAudioCount <= 0) {
       loadSdAudioList();
     }
     showCurrentAudioTrack();
   }
-  if (currentPage == UI_PAGE_VIDEO_PLAYER) {
+  if (page == UI_PAGE_VIDEO_PLAYER) {
     if (sdMounted && sdVideoCount <= 0) {
       loadSdVideoList();
     }
     showCurrentVideoTrack();
   }
-  prepareDynamicWallpaperForPage(currentPage, true);
-  updatePageIndicator();
-}
-
-static int wrapHomeShortcutIndex(int index) {
-  if (HOME_SHORTCUT_COUNT <= 0) {
-    return -1;
-  }
-
-  int wrapped = index % (int)HOME_SHORTCUT_COUNT;
-  if (wrapped < 0) {
-    wrapped += HOME_SHORTCUT_COUNT;
-  }
-  return wrapped;
-}
-
-static void renderHomeShortcutIcon(uint8_t slotIdx, const HomeShortcutConfig &item) {
-  if (slotIdx >= HOME_VISIBLE_SLOT_COUNT) {
-    return;
-  }
-
-  lv_obj_t *root = homeShortcutIcons[slotIdx];
-  if (root == nullptr) {
-    return;
-  }
-
-  lv_obj_clean(root);
-  lv_obj_set_style_bg_opa(root, LV_OPA_TRANSP, LV_PART_MAIN);
-
-  const lv_color_t fg = lv_color_hex(0xF5EEFF);
-
-  if (item.iconKind == HOME_ICON_SYMBOL) {
-    lv_obj_t *label = lv_label_create(root);
-    lv_label_set_text(label, item.icon);
-    lv_obj_set_style_text_color(label, fg, LV_PART_MAIN);
-    lv_obj_set_style_text_font(label, &lv_font_montserrat_22, LV_PART_MAIN);
-    lv_obj_center(label);
-    return;
-  }
-
-  if (item.iconKind == HOME_ICON_MONITOR) {
-    lv_obj_t *screen = lv_obj_create(root);
-    lv_obj_remove_style_all(screen);
-    lv_obj_set_size(screen, 24, 16);
-    lv_obj_align(screen, LV_ALIGN_CENTER, 0, -4);
-    lv_obj_set_style_radius(screen, 3, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(screen, LV_OPA_20, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(screen, fg, LV_PART_MAIN);
-    lv_obj_set_style_border_width(screen, 2, LV_PART_MAIN);
-    lv_obj_set_style_border_color(screen, fg, LV_PART_MAIN);
-
-    lv_obj_t *stem = lv_obj_create(root);
-    lv_obj_remove_style_all(stem);
-    lv_obj_set_size(stem, 4, 5);
-    lv_obj_align(stem, LV_ALIGN_CENTER, 0, 7);
-    lv_obj_set_style_bg_opa(stem, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(stem, fg, LV_PART_MAIN);
-    lv_obj_set_style_radius(stem, 1, LV_PART_MAIN);
-
-    lv_obj_t *base = lv_obj_create(root);
-    lv_obj_remove_style_all(base);
-    lv_obj_set_size(base, 16, 2);
-    lv_obj_align(base, LV_ALIGN_CENTER, 0, 11);
-    lv_obj_set_style_bg_opa(base, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(base, fg, LV_PART_MAIN);
-    lv_obj_set_style_radius(base, 1, LV_PART_MAIN);
-    return;
-  }
-
-  if (item.iconKind == HOME_ICON_POMODORO) {
-    lv_obj_t *fruit = lv_obj_create(root);
-    lv_obj_remove_style_all(fruit);
-    lv_obj_set_size(fruit, 22, 22);
-    lv_obj_align(fruit, LV_ALIGN_CENTER, 0, 2);
-    lv_obj_set_style_radius(fruit, 11, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(fruit, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(fruit, lv_color_hex(0xFF5252), LV_PART_MAIN);
-    lv_obj_set_style_border_width(fruit, 1, LV_PART_MAIN);
-    lv_obj_set_style_border_color(fruit, lv_color_hex(0xFFCDD2), LV_PART_MAIN);
-
-    lv_obj_t *leafL = lv_obj_create(root);
-    lv_obj_remove_style_all(leafL);
-    lv_obj_set_size(leafL, 7, 3);
-    lv_obj_align(leafL, LV_ALIGN_CENTER, -4, -9);
-    lv_obj_set_style_radius(leafL, 2, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(leafL, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(leafL, lv_color_hex(0x66BB6A), LV_PART_MAIN);
-
-    lv_obj_t *leafR = lv_obj_create(root);
-    lv_obj_remove_style_all(leafR);
-    lv_obj_set_size(leafR, 7, 3);
-    lv_obj_align(leafR, LV_ALIGN_CENTER, 4, -9);
-    lv_obj_set_style_radius(leafR, 2, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(leafR, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(leafR, lv_color_hex(0x66BB6A), LV_PART_MAIN);
-
-    lv_obj_t *stem = lv_obj_create(root);
-    lv_obj_remove_style_all(stem);
-    lv_obj_set_size(stem, 2, 4);
-    lv_obj_align(stem, LV_ALIGN_CENTER, 0, -11);
-    lv_obj_set_style_radius(stem, 1, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(stem, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(stem, lv_color_hex(0xA5D6A7), LV_PART_MAIN);
-    return;
-  }
-
-  if (item.iconKind == HOME_ICON_CLOCK) {
-    lv_obj_t *dial = lv_obj_create(root);
-    lv_obj_remove_style_all(dial);
-    lv_obj_set_size(dial, 24, 24);
-    lv_obj_align(dial, LV_ALIGN_CENTER, 0, 0);
-    lv_obj_set_style_radius(dial, 12, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(dial, LV_OPA_10, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(dial, fg, LV_PART_MAIN);
-    lv_obj_set_style_border_width(dial, 2, LV_PART_MAIN);
-    lv_obj_set_style_border_color(dial, fg, LV_PART_MAIN);
-
-    lv_obj_t *hourHand = lv_obj_create(root);
-    lv_obj_remove_style_all(hourHand);
-    lv_obj_set_size(hourHand, 7, 2);
-    lv_obj_align(hourHand, LV_ALIGN_CENTER, 2, 1);
-    lv_obj_set_style_radius(hourHand, 1, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(hourHand, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(hourHand, fg, LV_PART_MAIN);
-
-    lv_obj_t *minuteHand = lv_obj_create(root);
-    lv_obj_remove_style_all(minuteHand);
-    lv_obj_set_size(minuteHand, 2, 8);
-    lv_obj_align(minuteHand, LV_ALIGN_CENTER, 0, -3);
-    lv_obj_set_style_radius(minuteHand, 1, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(minuteHand, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(minuteHand, fg, LV_PART_MAIN);
-
-    lv_obj_t *centerDot = lv_obj_create(root);
-    lv_obj_remove_style_all(centerDot);
-    lv_obj_set_size(centerDot, 4, 4);
-    lv_obj_align(centerDot, LV_ALIGN_CENTER, 0, 1);
-    lv_obj_set_style_radius(centerDot, 2, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(centerDot, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(centerDot, fg, LV_PART_MAIN);
-    return;
-  }
-
-  if (item.iconKind == HOME_ICON_WEATHER) {
-    lv_obj_t *sun = lv_obj_create(root);
-    lv_obj_remove_style_all(sun);
-    lv_obj_set_size(sun, 11, 11);
-    lv_obj_align(sun, LV_ALIGN_CENTER, 7, -8);
-    lv_obj_set_style_radius(sun, 6, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(sun, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(sun, lv_color_hex(0xFFD54F), LV_PART_MAIN);
-
-    lv_obj_t *cloud1 = lv_obj_create(root);
-    lv_obj_remove_style_all(cloud1);
-    lv_obj_set_size(cloud1, 11, 11);
-    lv_obj_align(cloud1, LV_ALIGN_CENTER, -6, 1);
-    lv_obj_set_style_radius(cloud1, 6, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(cloud1, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(cloud1, fg, LV_PART_MAIN);
-
-    lv_obj_t *cloud2 = lv_obj_create(root);
-    lv_obj_remove_style_all(cloud2);
-    lv_obj_set_size(cloud2, 13, 13);
-    lv_obj_align(cloud2, LV_ALIGN_CENTER, 1, -1);
-    lv_obj_set_style_radius(cloud2, 7, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(cloud2, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(cloud2, fg, LV_PART_MAIN);
-
-    lv_obj_t *cloud3 = lv_obj_create(root);
-    lv_obj_remove_style_all(cloud3);
-    lv_obj_set_size(cloud3, 11, 11);
-    lv_obj_align(cloud3, LV_ALIGN_CENTER, 9, 2);
-    lv_obj_set_style_radius(cloud3, 6, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(cloud3, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(cloud3, fg, LV_PART_MAIN);
-
-    lv_obj_t *cloudBase = lv_obj_create(root);
-    lv_obj_remove_style_all(cloudBase);
-    lv_obj_set_size(cloudBase, 24, 8);
-    lv_obj_align(cloudBase, LV_ALIGN_CENTER, 1, 5);
-    lv_obj_set_style_radius(cloudBase, 4, LV_PART_MAIN);
-    lv_obj_set_style_bg_opa(cloudBase, LV_OPA_COVER, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(cloudBase, fg, LV_PART_MAIN);
-    return;
-  }
-
-  if (item.iconKind == HOME_ICON_APPS) {
-    static const lv_point_t line1[] = {{0, 14}, {14, 0}};
-    static const lv_point_t line2[] = {{0, 18}, {18, 0}};
-    static const lv_point_t line3[] = {{0, 22}, {22, 0}};
-
-    lv_obj_t *l1 = lv_line_create(root);
-    lv_line_set_points(l1, line1, 2);
-    lv_obj_set_size(l1, 16, 16);
-    lv_obj_align(l1, LV_ALIGN_CENTER, -4, -6);
-    lv_obj_set_style_line_color(l1, fg, LV_PART_MAIN);
-    lv_obj_set_style_line_width(l1, 2, LV_PART_MAIN);
-    lv_obj_set_style_line_rounded(l1, true, LV_PART_MAIN);
-
-    lv_obj_t *l2 = lv_line_create(root);
-    lv_line_set_points(l2, line2, 2);
-    lv_obj_set_size(l2, 20, 20);
-    lv_obj_align(l2, LV_ALIGN_CENTER, -1, -2);
-    lv_obj_set_style_line_color(l2, fg, LV_PART_MAIN);
-    lv_obj_set_style_line_width(l2, 2, LV_PART_MAIN);
-    lv_obj_set_style_line_rounded(l2, true, LV_PART_MAIN);
-
-    lv_obj_t *l3 = lv_line_create(root);
-    lv_line_set_points(l3, line3, 2);
-    lv_obj_set_size(l3, 24, 24);
-    lv_obj_align(l3, LV_ALIGN_CENTER, 2, 2);
-    lv_obj_set_style_line_color(l3, fg, LV_PART_MAIN);
-    lv_obj_set_style_line_width(l3, 2, LV_PART_MAIN);
-    lv_obj_set_style_line_rounded(l3, true, LV_PART_MAIN);
-    return;
-  }
-
-  lv_obj_t *fallback = lv_label_create(root);
-  lv_label_set_text(fallback, item.icon);
-  lv_obj_set_style_text_color(fallback, fg, LV_PART_MAIN);
-  lv_obj_set_style_text_font(fallback, &lv_font_montserrat_22, LV_PART_MAIN);
-  lv_obj_center(fallback);
-}
-
-static void refreshHomeShortcutSlots() {
-  uint8_t visible = HOME_VISIBLE_SLOT_COUNT;
-  if (visible > HOME_SHORTCUT_COUNT) {
-    visible = HOME_SHORTCUT_COUNT;
-  }
-
-  for (uint8_t i = 0; i < HOME_VISIBLE_SLOT_COUNT; ++i) {
-    if (homeShortcutSlots[i] == nullptr || homeShortcutButtons[i] == nullptr || homeShortcutIcons[i] == nullptr) {
-      continue;
-    }
-
-    if (i < visible) {
-      int shortcutIdx = wrapHomeShortcutIndex(homeCarouselOffset + i);
-      if (shortcutIdx < 0) {
-        lv_obj_add_flag(homeShortcutSlots[i], LV_OBJ_FLAG_HIDDEN);
-        homeSlotToShortcut[i] = -1;
-        continue;
-      }
-
-      const HomeShortcutConfig &item = HOME_SHORTCUTS[shortcutIdx];
-      homeSlotToShortcut[i] = (int8_t)shortcutIdx;
-      lv_obj_clear_flag(homeShortcutSlots[i], LV_OBJ_FLAG_HIDDEN);
-      lv_obj_set_style_bg_color(homeShortcutButtons[i], lv_color_hex(item.accentColor), LV_PART_MAIN);
-      lv_obj_set_style_shadow_color(homeShortcutButtons[i], lv_color_hex(item.accentColor), LV_PART_MAIN);
-      renderHomeShortcutIcon(i, item);
-
-      bool isFocused = (i == 0);
-      lv_obj_set_style_border_width(homeShortcutButtons[i], isFocused ? 2 : 1, LV_PART_MAIN);
-      lv_obj_set_style_border_color(homeShortcutButtons[i], isFocused ? lv_color_hex(0xF3E5FF) : lv_color_hex(0xD1C4E9), LV_PART_MAIN);
-      lv_obj_set_style_shadow_width(homeShortcutButtons[i], isFocused ? 18 : 12, LV_PART_MAIN);
-    } else {
-      homeSlotToShortcut[i] = -1;
-      lv_obj_add_flag(homeShortcutSlots[i], LV_OBJ_FLAG_HIDDEN);
-    }
-  }
-
-  if (homeCurrentShortcutLabel != nullptr) {
-    int idx = homeSlotToShortcut[0];
-    if (idx >= 0 && idx < HOME_SHORTCUT_COUNT) {
-      lv_label_set_text_fmt(homeCurrentShortcutLabel, "%s  (%d/%d)", HOME_SHORTCUTS[idx].label, idx + 1, HOME_SHORTCUT_COUNT);
-    } else {
-      lv_label_set_text(homeCurrentShortcutLabel, "--");
-    }
-  }
-}
-
-static void shiftHomeCarousel(int delta) {
-  if (HOME_SHORTCUT_COUNT <= 1) {
-    return;
-  }
-
-  homeCarouselOffset = wrapHomeShortcutIndex(homeCarouselOffset + delta);
-  refreshHomeShortcutSlots();
-}
-
-static void homeShortcutEventCallback(lv_event_t *e) {
-  if (lv_event_get_code(e) != LV_EVENT_CLICKED) {
-    return;
-  }
-  if (shouldSuppressClick()) {
-    return;
-  }
-
-  intptr_t slotRaw = (intptr_t)lv_event_get_user_data(e);
-  if (slotRaw < 0 || slotRaw >= HOME_VISIBLE_SLOT_COUNT) {
-    return;
-  }
-
-  int shortcutIdx = homeSlotToShortcut[slotRaw];
-  if (shortcutIdx < 0 || shortcutIdx >= HOME_SHORTCUT_COUNT) {
-    return;
-  }
-
-  UiPage page = HOME_SHORTCUTS[shortcutIdx].page;
-  if (page >= 0 && page < UI_PAGE_COUNT) {
-    showPage((int)page);
-  }
+  prepareDynamicWallpaperForPage(page, true);
 }
 
-static void layoutHomeShortcuts() {
-  lv_disp_t *disp = lv_disp_get_default();
-  if (disp == nullptr) {
-    return;
-  }
-
-  int16_t cx = lv_disp_get_hor_res(disp) / 2;
-  int16_t cy = lv_disp_get_ver_res(disp) / 2 + 4;
-  uint8_t visible = HOME_VISIBLE_SLOT_COUNT;
-  if (visible > HOME_SHORTCUT_COUNT) {
-    visible = HOME_SHORTCUT_COUNT;
-  }
-
-  for (uint8_t i = 0; i < HOME_VISIBLE_SLOT_COUNT; ++i) {
-    if (homeShortcutSlots[i] == nullptr || homeShortcutButtons[i] == nullptr || homeShortcutIcons[i] == nullptr) {
-      continue;
-    }
-
-    if (i >= visible) {
-      homeSlotToShortcut[i] = -1;
-      lv_obj_add_flag(homeShortcutSlots[i], LV_OBJ_FLAG_HIDDEN);
-      continue;
-    }
-
-    float angleDeg = -90.0f + (360.0f * (float)i / (float)visible);
-    float rad = angleDeg * HOME_DEG_TO_RAD;
-    int16_t slotSize = 64;
-    int16_t buttonSize = 52;
-    int16_t radius = 124;
-    int16_t x = cx + (int16_t)lroundf(cosf(rad) * radius) - slotSize / 2;
-    int16_t y = cy + (int16_t)lroundf(sinf(rad) * radius) - slotSize / 2;
-
-    lv_obj_clear_flag(homeShortcutSlots[i], LV_OBJ_FLAG_HIDDEN);
-    lv_obj_set_size(homeShortcutSlots[i], slotSize, slotSize);
-    lv_obj_set_pos(homeShortcutSlots[i], x, y);
-    lv_obj_set_size(homeShortcutButtons[i], buttonSize, buttonSize);
-    lv_obj_set_style_radius(homeShortcutButtons[i], buttonSize / 2, LV_PART_MAIN);
-    lv_obj_align(homeShortcutButtons[i], LV_ALIGN_CENTER, 0, 0);
-  }
-
-  refreshHomeShortcutSlots();
+// The decoded photo is reloaded from SD when the page is shown again; until
+// then photo_state reports nothing loaded.
+static void releasePhotoFrameMedia() {
+  freePhotoRawData();
+  clearCurrentPhoto();
+  imgTransformFree(&photoFrameTransform);
 }
 
-static void attachGestureHandlers(lv_obj_t *obj) {
-  if (obj == nullptr) {
-    return;
+// The MJPEG read buffer is re-created by ensureVideoFrameBuffer(); the decode
+// target stays, the dynamic wallpapers draw from it too.
+static void releaseVideoPlayerMedia() {
+  if (videoPlaying) {
+    stopVideoPlayback(true);
   }
-
-  lv_obj_add_event_cb(obj, gestureEventCallback, LV_EVENT_PRESSED, nullptr);
-  lv_obj_add_event_cb(obj, gestureEventCallback, LV_EVENT_PRESSING, nullptr);
-  lv_obj_add_event_cb(obj, gestureEventCallback, LV_EVENT_RELEASED, nullptr);
-  lv_obj_add_event_cb(obj, gestureEventCallback, LV_EVENT_PRESS_LOST, nullptr);
+  free(videoFrameData);
+  videoFrameData = nullptr;
+  videoFrameDataSize = 0;
+  imgTransformFree(&videoTransform);
 }
 
-static lv_obj_t *createBasePage() {
-  lv_obj_t *page = lv_obj_create(lv_scr_act());
-  lv_obj_remove_style_all(page);
-  lv_obj_set_size(page, lv_pct(100), lv_pct(100));
-  lv_obj_set_style_bg_opa(page, LV_OPA_TRANSP, LV_PART_MAIN);
-  lv_obj_clear_flag(page, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_add_flag(page, LV_OBJ_FLAG_CLICKABLE);
-  attachGestureHandlers(page);
-  return page;
-}
+#include "ui/ui_pages.h"
 
 static uint32_t getPomodoroModeDuration(PomodoroMode mode) {
   switch (mode) {
@@ -5115,28 +6479,21 @@ static void updatePomodoroDisplay() {
     remainingMs = pomodoroDurationMs;
   }
 
-  // Update time display
+  // Update time display. The state machine above runs at 10 Hz on any page;
+  // the widgets only change once a second and only while the page is shown.
   uint32_t remainingSec = remainingMs / 1000;
-  uint32_t minutes = remainingSec / 60;
-  uint32_t seconds = remainingSec % 60;
-  lv_label_set_text_fmt(pomodoroTimeLabel, "%02lu:%02lu", minutes, seconds);
+  uiBindLabelFmt(pomodoroTimeLabel, "%02lu:%02lu", (unsigned long)(remainingSec / 60), (unsigned long)(remainingSec % 60));
 
   // Update arc progress
   int progress = 100 - (int)((remainingMs * 100) / pomodoroDurationMs);
-  lv_arc_set_value(pomodoroArc, progress);
+  uiBindArcValue(pomodoroArc, progress);
 
   // Update count label
-  if (pomodoroCountLabel != nullptr) {
-    lv_label_set_text_fmt(pomodoroCountLabel, "Completed: %d", pomodoroCompletedCount);
-  }
+  uiBindLabelFmt(pomodoroCountLabel, "Completed: %d", pomodoroCompletedCount);
 
   // Update status label
-  if (pomodoroStatusLabel != nullptr && pomodoroState != POMODORO_IDLE) {
-    if (pomodoroState == POMODORO_RUNNING) {
-      lv_label_set_text(pomodoroStatusLabel, "Running...");
-    } else {
-      lv_label_set_text(pomodoroStatusLabel, "Paused");
-    }
+  if (pomodoroState != POMODORO_IDLE) {
+    uiBindLabelText(pomodoroStatusLabel, pomodoroState == POMODORO_RUNNING ? "Running..." : "Paused");
   }
 }
 
@@ -5227,7 +6584,9 @@ static void updateWeatherDisplay() {
 
   if (currentWeather.valid) {
     lv_label_set_text_fmt(weatherTempLabel, "%d", (int)currentWeather.temperature);
-    lv_label_set_text(weatherConditionLabel, translateWeatherCondition(currentWeather.condition));
+    // Shown as sent (usually Chinese) when the SD font can draw it.
+    lv_label_set_text(weatherConditionLabel,
+                      uiTextFontHasCjk(14) ? currentWeather.condition : translateWeatherCondition(currentWeather.condition));
     lv_label_set_text(weatherCityLabel, currentWeather.city);
     lv_label_set_text_fmt(weatherHumidityLabel, "%d%%", currentWeather.humidity);
     lv_label_set_text_fmt(weatherFeelsLikeLabel, "%d°", (int)currentWeather.feelsLike);
@@ -5249,16 +6608,21 @@ static void fetchWeatherData() {
   Serial.println("[Weather] Requesting weather via WebSocket...");
 
   // Send weather request to server
-  StaticJsonDocument<256> doc;
-  doc["type"] = "weather_request";
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_TELEMETRY, WS_COALESCE_WEATHER_REQUEST);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "weather_request");
 
-  JsonObject data = doc.createNestedObject("data");
-  data["deviceId"] = DEVICE_ID;
-  data["cityId"] = WEATHER_CITY_ID;
+  json.beginObject("data");
+  json.field("deviceId", DEVICE_ID);
+  json.field("cityId", WEATHER_CITY_ID);
 
-  String output;
-  serializeJson(doc, output);
-  webSocket.sendTXT(output);
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
 
   Serial.println("[Weather] Request sent");
 }
@@ -5448,14 +6812,19 @@ static void requestPhotoFrameSettings(bool force) {
   }
   lastPhotoSettingsRequestMs = now;
 
-  StaticJsonDocument<256> doc;
-  doc["type"] = "photo_settings_request";
-  JsonObject data = doc.createNestedObject("data");
-  data["deviceId"] = DEVICE_ID;
-  data["page"] = "photo_frame";
-  String output;
-  serializeJson(doc, output);
-  webSocket.sendTXT(output);
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_TELEMETRY, WS_COALESCE_PHOTO_SETTINGS_REQUEST);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "photo_settings_request");
+  json.beginObject("data");
+  json.field("deviceId", DEVICE_ID);
+  json.field("page", "photo_frame");
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
   Serial.println("[PhotoSettings] request sent");
 }
 
@@ -5496,29 +6865,34 @@ static void sendPhotoFrameState(const char *reason, bool force) {
   }
   lastPhotoStateEventMs = now;
 
-  StaticJsonDocument<512> doc;
-  doc["type"] = "photo_state";
-  JsonObject data = doc.createNestedObject("data");
-  data["deviceId"] = DEVICE_ID;
-  data["reason"] = (reason != nullptr) ? reason : "update";
-  data["pageActive"] = (currentPage == UI_PAGE_PHOTO_FRAME);
-  data["sdMounted"] = sdMounted;
-  data["total"] = sdPhotoCount;
-  data["index"] = (sdPhotoCount > 0) ? (sdPhotoIndex + 1) : 0;
-  data["autoPlay"] = photoFrameSettings.autoPlay;
-  data["slideshowInterval"] = photoFrameSettings.slideshowIntervalSec;
-  data["theme"] = photoFrameSettings.theme;
-  data["settingsSynced"] = photoFrameSettings.valid;
-  data["currentPhoto"] = currentPhotoName;
-  data["decoder"] = currentPhotoDecoder;
-  data["valid"] = currentPhotoValid;
-  data["maxPhotoCount"] = photoFrameSettings.maxPhotoCount;
-  data["skippedByLimit"] = sdPhotoLimitSkipped;
-  data["uptime"] = now / 1000;
-
-  String output;
-  serializeJson(doc, output);
-  webSocket.sendTXT(output);
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_TELEMETRY, WS_COALESCE_PHOTO_STATE);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "photo_state");
+  json.beginObject("data");
+  json.field("deviceId", DEVICE_ID);
+  json.field("reason", (reason != nullptr) ? reason : "update");
+  json.field("pageActive", (currentPage == UI_PAGE_PHOTO_FRAME));
+  json.field("sdMounted", sdMounted);
+  json.field("total", sdPhotoCount);
+  json.field("index", (sdPhotoCount > 0) ? (sdPhotoIndex + 1) : 0);
+  json.field("autoPlay", photoFrameSettings.autoPlay);
+  json.field("slideshowInterval", photoFrameSettings.slideshowIntervalSec);
+  json.field("theme", photoFrameSettings.theme);
+  json.field("settingsSynced", photoFrameSettings.valid);
+  json.field("currentPhoto", currentPhotoName);
+  json.field("decoder", currentPhotoDecoder);
+  json.field("valid", currentPhotoValid);
+  json.field("maxPhotoCount", photoFrameSettings.maxPhotoCount);
+  json.field("skippedByLimit", sdPhotoLimitSkipped);
+  json.field("uptime", now / 1000);
+
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
 }
 
 static void handlePhotoControlCommand(const JsonObjectConst &data) {
@@ -5531,7 +6905,7 @@ static void handlePhotoControlCommand(const JsonObjectConst &data) {
   if (strcmp(action, "prev") == 0) {
     if (sdPhotoCount > 0) {
       sdPhotoIndex = (sdPhotoIndex - 1 + sdPhotoCount) % sdPhotoCount;
-      showCurrentPhotoFrame();
+      showCurrentPhotoFrame(true);
       lastPhotoAutoAdvanceMs = millis();
       handled = true;
       if (currentPage == UI_PAGE_PHOTO_FRAME) {
@@ -5541,7 +6915,7 @@ static void handlePhotoControlCommand(const JsonObjectConst &data) {
   } else if (strcmp(action, "next") == 0) {
     if (sdPhotoCount > 0) {
       sdPhotoIndex = (sdPhotoIndex + 1) % sdPhotoCount;
-      showCurrentPhotoFrame();
+      showCurrentPhotoFrame(true);
       lastPhotoAutoAdvanceMs = millis();
       handled = true;
       if (currentPage == UI_PAGE_PHOTO_FRAME) {
@@ -5551,7 +6925,7 @@ static void handlePhotoControlCommand(const JsonObjectConst &data) {
   } else if (strcmp(action, "reload") == 0) {
     detectAndScanSdCard();
     loadSdPhotoList();
-    showCurrentPhotoFrame();
+    showCurrentPhotoFrame(true);
     lastPhotoAutoAdvanceMs = millis();
     handled = true;
     if (currentPage == UI_PAGE_PHOTO_FRAME) {
@@ -5694,15 +7068,20 @@ static void requestAppList() {
 
   Serial.println("[AppLauncher] Requesting app list...");
 
-  StaticJsonDocument<256> doc;
-  doc["type"] = "app_list_request";
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_CONTROL, WS_COALESCE_APP_LIST_REQUEST);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "app_list_request");
 
-  JsonObject data = doc.createNestedObject("data");
-  data["deviceId"] = DEVICE_ID;
+  json.beginObject("data");
+  json.field("deviceId", DEVICE_ID);
 
-  String output;
-  serializeJson(doc, output);
-  webSocket.sendTXT(output);
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
 }
 
 static bool launchApp(const char *appPath, const char *appName, char *reason, size_t reasonSize) {
@@ -5723,16 +7102,22 @@ static bool launchApp(const char *appPath, const char *appName, char *reason, si
 
   Serial.printf("[AppLauncher] Launching app: %s (%s)\n", appName == nullptr ? "App" : appName, appPath);
 
-  StaticJsonDocument<256> doc;
-  doc["type"] = "launch_app";
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_CONTROL, WS_COALESCE_NONE);
+  if (slot == nullptr) {
+    copyText(reason, reasonSize, "Send queue full");
+    return false;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "launch_app");
 
-  JsonObject data = doc.createNestedObject("data");
-  data["deviceId"] = DEVICE_ID;
-  data["appPath"] = appPath;
+  json.beginObject("data");
+  json.field("deviceId", DEVICE_ID);
+  json.field("appPath", appPath);
 
-  String output;
-  serializeJson(doc, output);
-  webSocket.sendTXT(output);
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
   return true;
 }
 
@@ -5868,1214 +7253,165 @@ static void appLauncherPageCallback(lv_event_t *e) {
   }
 }
 
+// Sprite rows count towards the same write/skip stats as bound labels.
+static void setClockFaceRow(ClockFaceRow &row, const ClockFaceSprites &sprites, const char *text) {
+  if (row.cont == nullptr) {
+    return;
+  }
+  if (!uiBindVisible(row.cont)) {
+    ui_bind_stats.skippedHidden++;
+    return;
+  }
+  const uint8_t changed = clockFaceSetText(&row, &sprites, text);
+  ui_bind_stats.applied += changed;
+  ui_bind_stats.skippedSame += row.count - changed;
+}
+
 static void updateClockDisplay() {
-  if (ntpConfigured) {
-    struct tm timeinfo;
-    if (getLocalTime(&timeinfo, 5)) {
-      ntpSynced = true;
-      if (clockLabel != nullptr) {
-        lv_label_set_text_fmt(clockLabel, "%02d:%02d", timeinfo.tm_hour, timeinfo.tm_min);
-      }
-      if (homeClockLabel != nullptr) {
-        lv_label_set_text_fmt(homeClockLabel, "%02d:%02d", timeinfo.tm_hour, timeinfo.tm_min);
-      }
-      if (homeDateLabel != nullptr) {
-        lv_label_set_text_fmt(homeDateLabel, "%02d/%02d", timeinfo.tm_mon + 1, timeinfo.tm_mday);
-      }
+  int hour = 0;
+  int minute = 0;
+  int second = 0;
+  char dateText[48];
+  struct tm timeinfo;
+  if (ntpConfigured && getLocalTime(&timeinfo, 5)) {
+    ntpSynced = true;
+    hour = timeinfo.tm_hour;
+    minute = timeinfo.tm_min;
+    second = timeinfo.tm_sec;
+    int wday = (timeinfo.tm_wday >= 0 && timeinfo.tm_wday < 7) ? timeinfo.tm_wday : 0;
+    snprintf(dateText, sizeof(dateText), "%04d-%02d-%02d %s", timeinfo.tm_year + 1900, timeinfo.tm_mon + 1,
+             timeinfo.tm_mday, WEEKDAY_SHORT[wday]);
+    uiBindLabelFmt(homeDateLabel, "%02d/%02d", timeinfo.tm_mon + 1, timeinfo.tm_mday);
+  } else {
+    uint32_t totalSeconds = millis() / 1000;
+    uint32_t days = totalSeconds / 86400;
+    hour = (int)((totalSeconds / 3600) % 24);
+    minute = (int)((totalSeconds / 60) % 60);
+    second = (int)(totalSeconds % 60);
+    snprintf(dateText, sizeof(dateText), "NTP syncing... Uptime %lud %02dh", (unsigned long)days, hour);
+    uiBindLabelText(homeDateLabel, "syncing...");
+  }
 
-      if (clockSecondLabel != nullptr) {
-        lv_label_set_text_fmt(clockSecondLabel, ":%02d", timeinfo.tm_sec);
-      }
-      if (clockDateLabel != nullptr) {
-        int wday = (timeinfo.tm_wday >= 0 && timeinfo.tm_wday < 7) ? timeinfo.tm_wday : 0;
-        lv_label_set_text_fmt(
-          clockDateLabel,
-          "%04d-%02d-%02d %s",
-          timeinfo.tm_year + 1900,
-          timeinfo.tm_mon + 1,
-          timeinfo.tm_mday,
-          WEEKDAY_SHORT[wday]
-        );
-      }
-      if (clockSecondArc != nullptr) {
-        lv_arc_set_value(clockSecondArc, timeinfo.tm_sec);
-      }
-      return;
-    }
+  char text[16];
+  snprintf(text, sizeof(text), "%02d:%02d", hour, minute);
+  uiBindLabelText(homeClockLabel, text);
+  setClockFaceRow(clockTimeRow, clockDigitSprites, text);
+  snprintf(text, sizeof(text), ":%02d", second);
+  setClockFaceRow(clockSecondRow, clockSecondSprites, text);
+  uiBindLabelText(clockDateLabel, dateText);
+  if (!clockSweepEnabled) {
+    uiBindArcValue(clockSecondArc, (int16_t)(second * 6));
   }
+}
+
+// Milliseconds into the current minute, from the same source as
+// updateClockDisplay(): wall time once NTP has synced, uptime before.
+static uint32_t clockMinuteMs() {
+  if (ntpSynced) {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    return (uint32_t)(tv.tv_sec % 60) * 1000 + (uint32_t)(tv.tv_usec / 1000);
+  }
+  return millis() % 60000;
+}
 
-  uint32_t totalSeconds = millis() / 1000;
-  uint32_t days = totalSeconds / 86400;
-  uint32_t h = (totalSeconds / 3600) % 24;
-  uint32_t m = (totalSeconds / 60) % 60;
-  uint32_t s = totalSeconds % 60;
-  if (clockLabel != nullptr) {
-    lv_label_set_text_fmt(clockLabel, "%02lu:%02lu", h, m);
+static void clockSweepGovern() {
+  const uint32_t now = millis();
+  if (clockSweepWindowStartMs == 0) {
+    clockSweepWindowStartMs = now;
+    clockSweepWindowFrames = lcd_frames_total;
+    clockSweepWindowFrameMs = lcd_frame_ms_sum;
+    return;
   }
-  if (homeClockLabel != nullptr) {
-    lv_label_set_text_fmt(homeClockLabel, "%02lu:%02lu", h, m);
+  if ((now - clockSweepWindowStartMs) < CLOCK_SWEEP_WINDOW_MS) {
+    return;
   }
-  if (homeDateLabel != nullptr) {
-    lv_label_set_text(homeDateLabel, "syncing...");
+  const uint32_t frames = lcd_frames_total - clockSweepWindowFrames;
+  const uint32_t frameMs = lcd_frame_ms_sum - clockSweepWindowFrameMs;
+  clockSweepWindowStartMs = 0;
+  if (frames == 0) {
+    return;
   }
 
-  if (clockSecondLabel != nullptr) {
-    lv_label_set_text_fmt(clockSecondLabel, ":%02lu", s);
-  }
-  if (clockDateLabel != nullptr) {
-    lv_label_set_text_fmt(clockDateLabel, "NTP syncing... Uptime %lud %02luh", days, h);
+  uint8_t level = clockSweepLevel;
+  if (frameMs > CLOCK_SWEEP_FRAME_BUDGET_MS * frames && level + 1 < CLOCK_SWEEP_LEVEL_COUNT) {
+    level++;
+  } else if (frameMs * 2 < CLOCK_SWEEP_FRAME_BUDGET_MS * frames && level > 0) {
+    level--;
   }
-  if (clockSecondArc != nullptr) {
-    lv_arc_set_value(clockSecondArc, (int)s);
+  if (level != clockSweepLevel) {
+    Serial.printf("[Clock] sweep %lu -> %lu FPS (frame %lu.%lu ms avg, budget %lu ms)\n",
+                  (unsigned long)(1000 / CLOCK_SWEEP_PERIODS_MS[clockSweepLevel]),
+                  (unsigned long)(1000 / CLOCK_SWEEP_PERIODS_MS[level]), (unsigned long)(frameMs / frames),
+                  (unsigned long)(frameMs * 10 / frames % 10), (unsigned long)CLOCK_SWEEP_FRAME_BUDGET_MS);
+    clockSweepLevel = level;
+    lv_timer_set_period(clockSweepTimer, CLOCK_SWEEP_PERIODS_MS[level]);
   }
 }
 
-static void clockTimerCallback(lv_timer_t *timer) {
+static void clockSweepTimerCallback(lv_timer_t *timer) {
   (void)timer;
-  updateClockDisplay();
-}
-
-static void gestureEventCallback(lv_event_t *e) {
-  lv_event_code_t code = lv_event_get_code(e);
-
-  if (code == LV_EVENT_PRESSED) {
-    pauseDynamicWallpapersForMs(DYNAMIC_WALLPAPER_TOUCH_PAUSE_MS);
-    gestureState.pressed = true;
-    gestureState.longPressHandled = false;
-    gestureState.startMs = millis();
-    lv_point_t start = {0, 0};
-    if (getActiveTouchPoint(&start)) {
-      gestureState.startPoint = start;
-    } else {
-      gestureState.startPoint = lv_point_t{0, 0};
-    }
+  if (!clockSweepEnabled || currentPage != UI_PAGE_CLOCK || clockSecondArc == nullptr) {
+    clockSweepWindowStartMs = 0;
     return;
   }
+  clockSweepGovern();
 
-  if (code == LV_EVENT_PRESSING) {
-    pauseDynamicWallpapersForMs(DYNAMIC_WALLPAPER_TOUCH_PAUSE_MS);
-    if (!gestureState.pressed || gestureState.longPressHandled) {
-      return;
-    }
-
-    if ((millis() - gestureState.startMs) < LONG_PRESS_MS) {
-      return;
-    }
+  const uint32_t ms = clockMinuteMs();
+  const int second = (int)(ms / 1000);
+  if (second != clockSweepLastSecond) {
+    // Keeps the digits in step with the hand instead of the 1 s timer's phase.
+    clockSweepLastSecond = second;
+    updateClockDisplay();
+  }
+  uiBindArcValue(clockSecondArc, (int16_t)(ms * 6 / 1000));
 
-    gestureState.longPressHandled = true;
-    if (currentPage != UI_PAGE_HOME) {
-      showPage(UI_PAGE_HOME);
-      suppressClicksAfterHome();
-    }
-    return;
+  const float angle = (float)ms * (2.0f * (float)M_PI / 60000.0f);
+  const float radius = (CLOCK_ARC_SIZE - CLOCK_ARC_WIDTH) * 0.5f;
+  const lv_point_t pos = {(lv_coord_t)lroundf(sinf(angle) * radius),
+                          (lv_coord_t)(lroundf(-cosf(angle) * radius) + CLOCK_ARC_Y_OFFSET)};
+  if (pos.x != clockSweepTipPos.x || pos.y != clockSweepTipPos.y) {
+    clockSweepTipPos = pos;
+    lv_obj_align(clockSweepTip, LV_ALIGN_CENTER, pos.x, pos.y);
   }
+}
 
-  if (code == LV_EVENT_RELEASED) {
-    pauseDynamicWallpapersForMs(DYNAMIC_WALLPAPER_TOUCH_PAUSE_MS);
-    if (!gestureState.pressed) {
-      return;
+static void setClockSweep(bool enabled, bool persist) {
+  clockSweepEnabled = enabled;
+  clockSweepLevel = 0;
+  clockSweepLastSecond = -1;
+  clockSweepWindowStartMs = 0;
+  clockSweepTipPos = lv_point_t{INT16_MIN, INT16_MIN};
+  if (clockSweepTimer != nullptr) {
+    lv_timer_set_period(clockSweepTimer, CLOCK_SWEEP_PERIODS_MS[0]);
+  }
+  if (clockSweepTip != nullptr) {
+    if (enabled) {
+      lv_obj_clear_flag(clockSweepTip, LV_OBJ_FLAG_HIDDEN);
+    } else {
+      lv_obj_add_flag(clockSweepTip, LV_OBJ_FLAG_HIDDEN);
     }
+  }
+  updateClockDisplay();
+  if (persist && settingsStoreReady) {
+    settingsStore.putBool(PREF_KEY_CLOCK_SWEEP, enabled);
+  }
+  Serial.printf("[Clock] sweep seconds %s\n", enabled ? "on" : "off");
+}
 
-    if (!gestureState.longPressHandled) {
-      lv_point_t endPoint = gestureState.startPoint;
-      if (getActiveTouchPoint(&endPoint)) {
-        int32_t dx = (int32_t)endPoint.x - (int32_t)gestureState.startPoint.x;
-        int32_t dy = (int32_t)endPoint.y - (int32_t)gestureState.startPoint.y;
-        int32_t adx = (dx >= 0) ? dx : -dx;
-        int32_t ady = (dy >= 0) ? dy : -dy;
-
-        if (currentPage == UI_PAGE_HOME) {
-          bool swipeHorizontal = (adx >= HOME_CAROUSEL_SWIPE_THRESHOLD) &&
-                                 (adx > (ady + HOME_CAROUSEL_DIRECTION_MARGIN));
-          if (swipeHorizontal) {
-            shiftHomeCarousel((dx < 0) ? 1 : -1);
-            suppressClicksForMs(CLICK_SUPPRESS_MS_AFTER_CAROUSEL);
-          }
-        } else {
-          bool swipeUp = (dy <= -SWIPE_HOME_THRESHOLD) &&
-                         (ady > (adx + SWIPE_HOME_DIRECTION_MARGIN)) &&
-                         (adx <= SWIPE_HOME_MAX_X_DRIFT);
-          if (swipeUp) {
-            showPage(UI_PAGE_HOME);
-            suppressClicksAfterHome();
-          }
-        }
-      }
-    }
+static void clockPageClickCallback(lv_event_t *e) {
+  if (lv_event_get_code(e) != LV_EVENT_SHORT_CLICKED) return;
+  if (shouldSuppressClick()) return;
+  setClockSweep(!clockSweepEnabled, true);
+}
 
-    gestureState = TouchGestureState();
-    return;
-  }
-
-  if (code == LV_EVENT_PRESS_LOST) {
-    pauseDynamicWallpapersForMs(DYNAMIC_WALLPAPER_TOUCH_PAUSE_MS);
-    gestureState = TouchGestureState();
-  }
-}
-
-static void createUi() {
-  lv_obj_set_style_bg_color(lv_scr_act(), lv_color_hex(0x000000), LV_PART_MAIN);
-  lv_obj_set_style_text_color(lv_scr_act(), lv_color_hex(0xFFFFFF), LV_PART_MAIN);
-
-  // Page 1: Home Hub
-  pages[UI_PAGE_HOME] = createBasePage();
-
-  homeWallpaperImage = lv_img_create(pages[UI_PAGE_HOME]);
-  lv_img_set_src(homeWallpaperImage, nullptr);
-  lv_obj_set_size(homeWallpaperImage, 360, 360);
-  lv_obj_center(homeWallpaperImage);
-  lv_obj_clear_flag(homeWallpaperImage, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
-  homeWallpaper.imageObj = homeWallpaperImage;
-
-  homeWallpaperShade = lv_obj_create(pages[UI_PAGE_HOME]);
-  lv_obj_remove_style_all(homeWallpaperShade);
-  lv_obj_set_size(homeWallpaperShade, 360, 360);
-  lv_obj_center(homeWallpaperShade);
-  lv_obj_set_style_bg_opa(homeWallpaperShade, LV_OPA_20, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(homeWallpaperShade, lv_color_hex(0x000000), LV_PART_MAIN);
-  lv_obj_clear_flag(homeWallpaperShade, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
-
-  lv_obj_t *homeOuter = lv_obj_create(pages[UI_PAGE_HOME]);
-  lv_obj_set_size(homeOuter, 344, 344);
-  lv_obj_align(homeOuter, LV_ALIGN_CENTER, 0, 4);
-  lv_obj_set_style_radius(homeOuter, 172, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(homeOuter, lv_color_hex(0x0B0F20), LV_PART_MAIN);
-  lv_obj_set_style_bg_grad_color(homeOuter, lv_color_hex(0x121A3A), LV_PART_MAIN);
-  lv_obj_set_style_bg_grad_dir(homeOuter, LV_GRAD_DIR_VER, LV_PART_MAIN);
-  lv_obj_set_style_bg_opa(homeOuter, LV_OPA_60, LV_PART_MAIN);
-  lv_obj_set_style_border_width(homeOuter, 2, LV_PART_MAIN);
-  lv_obj_set_style_border_color(homeOuter, lv_color_hex(0x1C2448), LV_PART_MAIN);
-  lv_obj_clear_flag(homeOuter, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_clear_flag(homeOuter, LV_OBJ_FLAG_CLICKABLE);
-
-  lv_obj_t *homeInner = lv_obj_create(pages[UI_PAGE_HOME]);
-  lv_obj_set_size(homeInner, 304, 304);
-  lv_obj_align(homeInner, LV_ALIGN_CENTER, 0, 4);
-  lv_obj_set_style_radius(homeInner, 152, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(homeInner, lv_color_hex(0x111735), LV_PART_MAIN);
-  lv_obj_set_style_bg_grad_color(homeInner, lv_color_hex(0x191F43), LV_PART_MAIN);
-  lv_obj_set_style_bg_grad_dir(homeInner, LV_GRAD_DIR_VER, LV_PART_MAIN);
-  lv_obj_set_style_bg_opa(homeInner, LV_OPA_60, LV_PART_MAIN);
-  lv_obj_set_style_border_width(homeInner, 1, LV_PART_MAIN);
-  lv_obj_set_style_border_color(homeInner, lv_color_hex(0x222B58), LV_PART_MAIN);
-  lv_obj_clear_flag(homeInner, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_clear_flag(homeInner, LV_OBJ_FLAG_CLICKABLE);
-
-  for (uint8_t i = 0; i < HOME_VISIBLE_SLOT_COUNT; ++i) {
-    const HomeShortcutConfig &item = HOME_SHORTCUTS[i % HOME_SHORTCUT_COUNT];
-
-    homeShortcutSlots[i] = lv_obj_create(pages[UI_PAGE_HOME]);
-    lv_obj_remove_style_all(homeShortcutSlots[i]);
-    lv_obj_set_size(homeShortcutSlots[i], 64, 64);
-    lv_obj_set_style_bg_opa(homeShortcutSlots[i], LV_OPA_TRANSP, LV_PART_MAIN);
-    lv_obj_clear_flag(homeShortcutSlots[i], LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_clear_flag(homeShortcutSlots[i], LV_OBJ_FLAG_CLICKABLE);
-    lv_obj_add_flag(homeShortcutSlots[i], LV_OBJ_FLAG_GESTURE_BUBBLE);
-    attachGestureHandlers(homeShortcutSlots[i]);
-
-    homeShortcutButtons[i] = lv_btn_create(homeShortcutSlots[i]);
-    lv_obj_set_size(homeShortcutButtons[i], 52, 52);
-    lv_obj_align(homeShortcutButtons[i], LV_ALIGN_CENTER, 0, 0);
-    lv_obj_set_style_radius(homeShortcutButtons[i], 26, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(homeShortcutButtons[i], lv_color_hex(item.accentColor), LV_PART_MAIN);
-    lv_obj_set_style_bg_grad_color(homeShortcutButtons[i], lv_color_hex(0x7E57C2), LV_PART_MAIN);
-    lv_obj_set_style_bg_grad_dir(homeShortcutButtons[i], LV_GRAD_DIR_VER, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(homeShortcutButtons[i], lv_color_hex(0x4527A0), LV_PART_MAIN | LV_STATE_PRESSED);
-    lv_obj_set_style_shadow_width(homeShortcutButtons[i], 12, LV_PART_MAIN);
-    lv_obj_set_style_shadow_color(homeShortcutButtons[i], lv_color_hex(item.accentColor), LV_PART_MAIN);
-    lv_obj_set_style_shadow_opa(homeShortcutButtons[i], LV_OPA_70, LV_PART_MAIN);
-    lv_obj_set_style_border_width(homeShortcutButtons[i], 1, LV_PART_MAIN);
-    lv_obj_set_style_border_color(homeShortcutButtons[i], lv_color_hex(0xD1C4E9), LV_PART_MAIN);
-    lv_obj_add_flag(homeShortcutButtons[i], LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
-    attachGestureHandlers(homeShortcutButtons[i]);
-    lv_obj_add_event_cb(homeShortcutButtons[i], homeShortcutEventCallback, LV_EVENT_CLICKED, (void *)((intptr_t)i));
-
-    homeShortcutIcons[i] = lv_obj_create(homeShortcutButtons[i]);
-    lv_obj_remove_style_all(homeShortcutIcons[i]);
-    lv_obj_set_size(homeShortcutIcons[i], 36, 36);
-    lv_obj_center(homeShortcutIcons[i]);
-    lv_obj_set_style_bg_opa(homeShortcutIcons[i], LV_OPA_TRANSP, LV_PART_MAIN);
-    lv_obj_clear_flag(homeShortcutIcons[i], LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_clear_flag(homeShortcutIcons[i], LV_OBJ_FLAG_CLICKABLE);
-    renderHomeShortcutIcon(i, item);
-  }
-
-  lv_obj_t *homeCenter = lv_obj_create(pages[UI_PAGE_HOME]);
-  lv_obj_set_size(homeCenter, 128, 128);
-  lv_obj_align(homeCenter, LV_ALIGN_CENTER, 0, 4);
-  lv_obj_set_style_radius(homeCenter, 64, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(homeCenter, lv_color_hex(0x18305C), LV_PART_MAIN);
-  lv_obj_set_style_bg_grad_color(homeCenter, lv_color_hex(0x102242), LV_PART_MAIN);
-  lv_obj_set_style_bg_grad_dir(homeCenter, LV_GRAD_DIR_VER, LV_PART_MAIN);
-  lv_obj_set_style_border_width(homeCenter, 2, LV_PART_MAIN);
-  lv_obj_set_style_border_color(homeCenter, lv_color_hex(0x2D5AA0), LV_PART_MAIN);
-  lv_obj_set_style_shadow_width(homeCenter, 20, LV_PART_MAIN);
-  lv_obj_set_style_shadow_color(homeCenter, lv_color_hex(0x1A3B74), LV_PART_MAIN);
-  lv_obj_set_style_shadow_opa(homeCenter, LV_OPA_50, LV_PART_MAIN);
-  lv_obj_clear_flag(homeCenter, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_clear_flag(homeCenter, LV_OBJ_FLAG_CLICKABLE);
-
-  homeClockLabel = lv_label_create(homeCenter);
-  lv_label_set_text(homeClockLabel, "--:--");
-  lv_obj_set_style_text_font(homeClockLabel, &lv_font_montserrat_32, LV_PART_MAIN);
-  lv_obj_set_style_text_color(homeClockLabel, lv_color_hex(0xF2F7FF), LV_PART_MAIN);
-  lv_obj_align(homeClockLabel, LV_ALIGN_CENTER, 0, -14);
-
-  homeDateLabel = lv_label_create(homeCenter);
-  lv_label_set_text(homeDateLabel, "--/--");
-  lv_obj_set_style_text_font(homeDateLabel, &lv_font_montserrat_16, LV_PART_MAIN);
-  lv_obj_set_style_text_color(homeDateLabel, lv_color_hex(0xB7D1FF), LV_PART_MAIN);
-  lv_obj_align(homeDateLabel, LV_ALIGN_CENTER, 0, 26);
-
-  homeCurrentShortcutLabel = lv_label_create(pages[UI_PAGE_HOME]);
-  lv_label_set_text(homeCurrentShortcutLabel, "--");
-  lv_obj_set_style_text_color(homeCurrentShortcutLabel, lv_color_hex(0xD5DBFF), LV_PART_MAIN);
-  lv_obj_set_style_text_font(homeCurrentShortcutLabel, &lv_font_montserrat_16, LV_PART_MAIN);
-  lv_obj_set_style_text_align(homeCurrentShortcutLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
-  lv_obj_align(homeCurrentShortcutLabel, LV_ALIGN_BOTTOM_MID, 0, -30);
-
-  homeSwipeHintLabel = lv_label_create(pages[UI_PAGE_HOME]);
-  lv_label_set_text(homeSwipeHintLabel, "Swipe <- / ->   Tap to open");
-  lv_obj_set_style_text_color(homeSwipeHintLabel, lv_color_hex(0x8A93C8), LV_PART_MAIN);
-  lv_obj_set_style_text_font(homeSwipeHintLabel, &lv_font_montserrat_14, LV_PART_MAIN);
-  lv_obj_set_style_text_align(homeSwipeHintLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
-  lv_obj_align(homeSwipeHintLabel, LV_ALIGN_BOTTOM_MID, 0, -10);
-
-  layoutHomeShortcuts();
-
-  // Page 2: Monitor
-  pages[UI_PAGE_MONITOR] = createBasePage();
-  lv_obj_t *monitorTitle = lv_label_create(pages[UI_PAGE_MONITOR]);
-  lv_label_set_text(monitorTitle, "System Monitor");
-  lv_obj_align(monitorTitle, LV_ALIGN_TOP_MID, 0, 18);
-
-  wifiLabel = lv_label_create(pages[UI_PAGE_MONITOR]);
-  lv_label_set_text(wifiLabel, "WiFi: connecting...");
-  lv_obj_align(wifiLabel, LV_ALIGN_TOP_MID, 0, 44);
-
-  wsLabel = lv_label_create(pages[UI_PAGE_MONITOR]);
-  lv_label_set_text(wsLabel, "WS: disconnected");
-  lv_obj_align(wsLabel, LV_ALIGN_TOP_MID, 0, 62);
-
-  cpuArc = lv_arc_create(pages[UI_PAGE_MONITOR]);
-  lv_obj_set_size(cpuArc, 120, 120);
-  lv_obj_align(cpuArc, LV_ALIGN_TOP_LEFT, 34, 88);
-  lv_arc_set_rotation(cpuArc, 135);
-  lv_arc_set_bg_angles(cpuArc, 0, 270);
-  lv_arc_set_range(cpuArc, 0, 100);
-  lv_arc_set_value(cpuArc, 0);
-  lv_obj_set_style_arc_width(cpuArc, 10, LV_PART_MAIN);
-  lv_obj_set_style_arc_color(cpuArc, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
-  lv_obj_set_style_arc_width(cpuArc, 10, LV_PART_INDICATOR);
-  lv_obj_set_style_arc_color(cpuArc, lv_color_hex(0x26C6DA), LV_PART_INDICATOR);
-  lv_obj_set_style_opa(cpuArc, LV_OPA_TRANSP, LV_PART_KNOB);
-  lv_obj_clear_flag(cpuArc, LV_OBJ_FLAG_CLICKABLE);
-
-  cpuValueLabel = lv_label_create(pages[UI_PAGE_MONITOR]);
-  lv_label_set_text(cpuValueLabel, "CPU\n0%");
-  lv_obj_set_style_text_align(cpuValueLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
-  lv_obj_align(cpuValueLabel, LV_ALIGN_TOP_LEFT, 76, 128);
-
-  memArc = lv_arc_create(pages[UI_PAGE_MONITOR]);
-  lv_obj_set_size(memArc, 120, 120);
-  lv_obj_align(memArc, LV_ALIGN_TOP_RIGHT, -34, 88);
-  lv_arc_set_rotation(memArc, 135);
-  lv_arc_set_bg_angles(memArc, 0, 270);
-  lv_arc_set_range(memArc, 0, 100);
-  lv_arc_set_value(memArc, 0);
-  lv_obj_set_style_arc_width(memArc, 10, LV_PART_MAIN);
-  lv_obj_set_style_arc_color(memArc, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
-  lv_obj_set_style_arc_width(memArc, 10, LV_PART_INDICATOR);
-  lv_obj_set_style_arc_color(memArc, lv_color_hex(0x66BB6A), LV_PART_INDICATOR);
-  lv_obj_set_style_opa(memArc, LV_OPA_TRANSP, LV_PART_KNOB);
-  lv_obj_clear_flag(memArc, LV_OBJ_FLAG_CLICKABLE);
-
-  memValueLabel = lv_label_create(pages[UI_PAGE_MONITOR]);
-  lv_label_set_text(memValueLabel, "MEM\n0%");
-  lv_obj_set_style_text_align(memValueLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
-  lv_obj_align(memValueLabel, LV_ALIGN_TOP_RIGHT, -76, 128);
-
-  lv_obj_t *netPanel = lv_obj_create(pages[UI_PAGE_MONITOR]);
-  lv_obj_set_size(netPanel, 292, 62);
-  lv_obj_align(netPanel, LV_ALIGN_BOTTOM_MID, 0, -38);
-  lv_obj_set_style_radius(netPanel, 12, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(netPanel, lv_color_hex(0x111111), LV_PART_MAIN);
-  lv_obj_set_style_border_color(netPanel, lv_color_hex(0x2E2E2E), LV_PART_MAIN);
-  lv_obj_set_style_border_width(netPanel, 1, LV_PART_MAIN);
-  lv_obj_clear_flag(netPanel, LV_OBJ_FLAG_SCROLLABLE);
-
-  lv_obj_t *upLabel = lv_label_create(netPanel);
-  lv_label_set_text(upLabel, "UP");
-  lv_obj_set_style_text_color(upLabel, lv_color_hex(0x90CAF9), LV_PART_MAIN);
-  lv_obj_align(upLabel, LV_ALIGN_LEFT_MID, 14, -10);
-
-  upValueLabel = lv_label_create(netPanel);
-  lv_label_set_text(upValueLabel, "-- KB/s");
-  lv_obj_align(upValueLabel, LV_ALIGN_LEFT_MID, 44, -10);
-
-  lv_obj_t *downLabel = lv_label_create(netPanel);
-  lv_label_set_text(downLabel, "DOWN");
-  lv_obj_set_style_text_color(downLabel, lv_color_hex(0xA5D6A7), LV_PART_MAIN);
-  lv_obj_align(downLabel, LV_ALIGN_LEFT_MID, 14, 14);
-
-  downValueLabel = lv_label_create(netPanel);
-  lv_label_set_text(downValueLabel, "-- KB/s");
-  lv_obj_align(downValueLabel, LV_ALIGN_LEFT_MID, 64, 14);
-
-  statsLabel = lv_label_create(pages[UI_PAGE_MONITOR]);
-  lv_label_set_text(statsLabel, "");
-  lv_obj_add_flag(statsLabel, LV_OBJ_FLAG_HIDDEN);
-
-  // Page 3: Clock
-  pages[UI_PAGE_CLOCK] = createBasePage();
-
-  clockWallpaperImage = lv_img_create(pages[UI_PAGE_CLOCK]);
-  lv_img_set_src(clockWallpaperImage, nullptr);
-  lv_obj_set_size(clockWallpaperImage, 360, 360);
-  lv_obj_center(clockWallpaperImage);
-  lv_obj_clear_flag(clockWallpaperImage, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
-  clockWallpaper.imageObj = clockWallpaperImage;
-
-  clockWallpaperShade = lv_obj_create(pages[UI_PAGE_CLOCK]);
-  lv_obj_remove_style_all(clockWallpaperShade);
-  lv_obj_set_size(clockWallpaperShade, 360, 360);
-  lv_obj_center(clockWallpaperShade);
-  lv_obj_set_style_bg_opa(clockWallpaperShade, LV_OPA_50, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(clockWallpaperShade, lv_color_hex(0x000000), LV_PART_MAIN);
-  lv_obj_clear_flag(clockWallpaperShade, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
-
-  lv_obj_t *clockTitle = lv_label_create(pages[UI_PAGE_CLOCK]);
-  lv_label_set_text(clockTitle, "Clock");
-  lv_obj_align(clockTitle, LV_ALIGN_TOP_MID, 0, 20);
-
-  clockSecondArc = lv_arc_create(pages[UI_PAGE_CLOCK]);
-  lv_obj_set_size(clockSecondArc, 232, 232);
-  lv_obj_align(clockSecondArc, LV_ALIGN_CENTER, 0, 8);
-  lv_arc_set_rotation(clockSecondArc, 270);
-  lv_arc_set_bg_angles(clockSecondArc, 0, 360);
-  lv_arc_set_range(clockSecondArc, 0, 59);
-  lv_arc_set_value(clockSecondArc, 0);
-  lv_obj_set_style_arc_width(clockSecondArc, 8, LV_PART_MAIN);
-  lv_obj_set_style_arc_color(clockSecondArc, lv_color_hex(0x252525), LV_PART_MAIN);
-  lv_obj_set_style_arc_width(clockSecondArc, 8, LV_PART_INDICATOR);
-  lv_obj_set_style_arc_color(clockSecondArc, lv_color_hex(0xFFA726), LV_PART_INDICATOR);
-  lv_obj_set_style_opa(clockSecondArc, LV_OPA_TRANSP, LV_PART_KNOB);
-  lv_obj_clear_flag(clockSecondArc, LV_OBJ_FLAG_CLICKABLE);
-
-  clockLabel = lv_label_create(pages[UI_PAGE_CLOCK]);
-  lv_label_set_text(clockLabel, "00:00");
-  lv_obj_set_style_text_font(clockLabel, &lv_font_montserrat_32, LV_PART_MAIN);
-  lv_obj_align(clockLabel, LV_ALIGN_CENTER, 0, -6);
-
-  clockSecondLabel = lv_label_create(pages[UI_PAGE_CLOCK]);
-  lv_label_set_text(clockSecondLabel, ":00");
-  lv_obj_set_style_text_color(clockSecondLabel, lv_color_hex(0xFFCC80), LV_PART_MAIN);
-  lv_obj_align(clockSecondLabel, LV_ALIGN_CENTER, 0, 36);
-
-  clockDateLabel = lv_label_create(pages[UI_PAGE_CLOCK]);
-  lv_label_set_text(clockDateLabel, "Uptime 0d 00h 00m");
-  lv_obj_align(clockDateLabel, LV_ALIGN_BOTTOM_MID, 0, -54);
-
-  lv_obj_t *clockHint = lv_label_create(pages[UI_PAGE_CLOCK]);
-  lv_label_set_text(clockHint, "Long-press anywhere to return Home");
-  lv_obj_align(clockHint, LV_ALIGN_BOTTOM_MID, 0, -30);
-
-  // Page 4: Settings & Diagnostics
-  pages[UI_PAGE_SETTINGS] = createBasePage();
-  lv_obj_t *settingsTitle = lv_label_create(pages[UI_PAGE_SETTINGS]);
-  lv_label_set_text(settingsTitle, "Settings & Diagnostics");
-  lv_obj_align(settingsTitle, LV_ALIGN_TOP_MID, 0, 14);
-
-  lv_obj_t *diagPanel = lv_obj_create(pages[UI_PAGE_SETTINGS]);
-  lv_obj_set_size(diagPanel, 300, 124);
-  lv_obj_align(diagPanel, LV_ALIGN_TOP_MID, 0, 36);
-  lv_obj_set_style_radius(diagPanel, 12, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(diagPanel, lv_color_hex(0x111111), LV_PART_MAIN);
-  lv_obj_set_style_border_color(diagPanel, lv_color_hex(0x2E2E2E), LV_PART_MAIN);
-  lv_obj_set_style_border_width(diagPanel, 1, LV_PART_MAIN);
-  lv_obj_clear_flag(diagPanel, LV_OBJ_FLAG_SCROLLABLE);
-
-  diagWifiLabel = lv_label_create(diagPanel);
-  lv_label_set_text(diagWifiLabel, "WiFi: connecting...");
-  lv_obj_align(diagWifiLabel, LV_ALIGN_TOP_LEFT, 10, 8);
-
-  diagWsLabel = lv_label_create(diagPanel);
-  lv_label_set_text(diagWsLabel, "WS: disconnected");
-  lv_obj_align(diagWsLabel, LV_ALIGN_TOP_LEFT, 10, 26);
-
-  diagNtpLabel = lv_label_create(diagPanel);
-  lv_label_set_text(diagNtpLabel, "NTP: syncing");
-  lv_obj_align(diagNtpLabel, LV_ALIGN_TOP_LEFT, 10, 42);
-
-  diagIpLabel = lv_label_create(diagPanel);
-  lv_label_set_text(diagIpLabel, "IP: --");
-  lv_obj_align(diagIpLabel, LV_ALIGN_TOP_LEFT, 10, 58);
-
-  diagRssiLabel = lv_label_create(diagPanel);
-  lv_label_set_text(diagRssiLabel, "RSSI: --");
-  lv_obj_align(diagRssiLabel, LV_ALIGN_TOP_LEFT, 10, 74);
-
-  diagServerLabel = lv_label_create(diagPanel);
-  lv_label_set_text(diagServerLabel, "Server: --");
-  lv_obj_align(diagServerLabel, LV_ALIGN_TOP_LEFT, 148, 74);
-
-  diagSdLabel = lv_label_create(diagPanel);
-  lv_label_set_text(diagSdLabel, "SD: checking...");
-  lv_obj_align(diagSdLabel, LV_ALIGN_TOP_LEFT, 10, 90);
-
-  diagSdRootLabel = lv_label_create(diagPanel);
-  lv_label_set_text(diagSdRootLabel, "Root: --");
-  lv_obj_set_width(diagSdRootLabel, 280);
-  lv_label_set_long_mode(diagSdRootLabel, LV_LABEL_LONG_DOT);
-  lv_obj_set_style_text_color(diagSdRootLabel, lv_color_hex(0xB0B0B0), LV_PART_MAIN);
-  lv_obj_align(diagSdRootLabel, LV_ALIGN_TOP_LEFT, 10, 106);
-
-  createSettingsButton(pages[UI_PAGE_SETTINGS], "WiFi Reconnect", 34, 166, SETTINGS_ACTION_WIFI_RECONNECT);
-  createSettingsButton(pages[UI_PAGE_SETTINGS], "WS Reconnect", 190, 166, SETTINGS_ACTION_WS_RECONNECT);
-  createSettingsButton(pages[UI_PAGE_SETTINGS], "NTP Sync", 34, 206, SETTINGS_ACTION_NTP_SYNC);
-  createSettingsButton(pages[UI_PAGE_SETTINGS], "Reboot", 190, 206, SETTINGS_ACTION_REBOOT);
-
-  lv_obj_t *brightnessPanel = lv_obj_create(pages[UI_PAGE_SETTINGS]);
-  lv_obj_set_size(brightnessPanel, 300, 54);
-  lv_obj_align(brightnessPanel, LV_ALIGN_TOP_MID, 0, 246);
-  lv_obj_set_style_radius(brightnessPanel, 12, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(brightnessPanel, lv_color_hex(0x111111), LV_PART_MAIN);
-  lv_obj_set_style_border_color(brightnessPanel, lv_color_hex(0x2E2E2E), LV_PART_MAIN);
-  lv_obj_set_style_border_width(brightnessPanel, 1, LV_PART_MAIN);
-  lv_obj_clear_flag(brightnessPanel, LV_OBJ_FLAG_SCROLLABLE);
-
-  lv_obj_t *brightnessText = lv_label_create(brightnessPanel);
-  lv_label_set_text(brightnessText, "Brightness");
-  lv_obj_align(brightnessText, LV_ALIGN_TOP_LEFT, 10, 6);
-
-  brightnessSlider = lv_slider_create(brightnessPanel);
-  lv_obj_set_size(brightnessSlider, 192, 12);
-  lv_obj_align(brightnessSlider, LV_ALIGN_TOP_LEFT, 90, 10);
-  lv_slider_set_range(brightnessSlider, 5, 100);
-  lv_slider_set_value(brightnessSlider, screenBrightness, LV_ANIM_OFF);
-  lv_obj_add_flag(brightnessSlider, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  attachGestureHandlers(brightnessSlider);
-  lv_obj_add_event_cb(brightnessSlider, brightnessSliderEventCallback, LV_EVENT_VALUE_CHANGED, nullptr);
-  lv_obj_add_event_cb(brightnessSlider, brightnessSliderEventCallback, LV_EVENT_RELEASED, nullptr);
-
-  brightnessValueLabel = lv_label_create(brightnessPanel);
-  lv_label_set_text(brightnessValueLabel, "100%");
-  lv_obj_align(brightnessValueLabel, LV_ALIGN_TOP_RIGHT, -10, 4);
-
-  diagActionLabel = lv_label_create(brightnessPanel);
-  lv_label_set_text(diagActionLabel, "Ready");
-  lv_obj_set_style_text_color(diagActionLabel, lv_color_hex(0xAFAFAF), LV_PART_MAIN);
-  lv_obj_align(diagActionLabel, LV_ALIGN_BOTTOM_LEFT, 10, -4);
-
-  diagUptimeLabel = lv_label_create(pages[UI_PAGE_SETTINGS]);
-  lv_label_set_text(diagUptimeLabel, "Uptime: 00:00:00");
-  lv_obj_align(diagUptimeLabel, LV_ALIGN_TOP_MID, 0, 306);
-
-  // Page 5: Inbox & Tasks
-  pages[UI_PAGE_INBOX] = createBasePage();
-  lv_obj_t *inboxPageTitle = lv_label_create(pages[UI_PAGE_INBOX]);
-  lv_label_set_text(inboxPageTitle, "Inbox & Tasks");
-  lv_obj_align(inboxPageTitle, LV_ALIGN_TOP_MID, 0, 14);
-
-  lv_obj_t *inboxCard = lv_obj_create(pages[UI_PAGE_INBOX]);
-  lv_obj_set_size(inboxCard, 300, 170);
-  lv_obj_align(inboxCard, LV_ALIGN_TOP_MID, 0, 36);
-  lv_obj_set_style_radius(inboxCard, 12, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(inboxCard, lv_color_hex(0x111111), LV_PART_MAIN);
-  lv_obj_set_style_border_color(inboxCard, lv_color_hex(0x2E2E2E), LV_PART_MAIN);
-  lv_obj_set_style_border_width(inboxCard, 1, LV_PART_MAIN);
-  lv_obj_clear_flag(inboxCard, LV_OBJ_FLAG_SCROLLABLE);
-
-  inboxTypeLabel = lv_label_create(inboxCard);
-  lv_label_set_text(inboxTypeLabel, "[info]");
-  lv_obj_set_style_text_color(inboxTypeLabel, lv_color_hex(0x90CAF9), LV_PART_MAIN);
-  lv_obj_align(inboxTypeLabel, LV_ALIGN_TOP_LEFT, 10, 8);
-
-  inboxIndexLabel = lv_label_create(inboxCard);
-  lv_label_set_text(inboxIndexLabel, "0/0");
-  lv_obj_set_style_text_color(inboxIndexLabel, lv_color_hex(0x9E9E9E), LV_PART_MAIN);
-  lv_obj_align(inboxIndexLabel, LV_ALIGN_TOP_RIGHT, -10, 8);
-
-  inboxTitleLabel = lv_label_create(inboxCard);
-  lv_label_set_text(inboxTitleLabel, "No messages");
-  lv_obj_set_style_text_font(inboxTitleLabel, &lv_font_montserrat_22, LV_PART_MAIN);
-  lv_obj_align(inboxTitleLabel, LV_ALIGN_TOP_LEFT, 10, 30);
-
-  inboxBodyLabel = lv_label_create(inboxCard);
-  lv_obj_set_width(inboxBodyLabel, 280);
-  lv_label_set_long_mode(inboxBodyLabel, LV_LABEL_LONG_WRAP);
-  lv_label_set_text(inboxBodyLabel, "Incoming notifications and tasks\nwill appear here.");
-  lv_obj_align(inboxBodyLabel, LV_ALIGN_TOP_LEFT, 10, 66);
-
-  inboxMetaLabel = lv_label_create(inboxCard);
-  lv_label_set_text(inboxMetaLabel, "waiting for events");
-  lv_obj_set_style_text_color(inboxMetaLabel, lv_color_hex(0xA0A0A0), LV_PART_MAIN);
-  lv_obj_align(inboxMetaLabel, LV_ALIGN_BOTTOM_LEFT, 10, -10);
-
-  createInboxButton(pages[UI_PAGE_INBOX], "Prev", 34, 214, 96, INBOX_ACTION_PREV);
-  createInboxButton(pages[UI_PAGE_INBOX], "Next", 230, 214, 96, INBOX_ACTION_NEXT);
-  inboxAckBtn = createInboxButton(pages[UI_PAGE_INBOX], "Acknowledge", 34, 254, 136, INBOX_ACTION_ACK);
-  inboxDoneBtn = createInboxButton(pages[UI_PAGE_INBOX], "Mark Done", 190, 254, 136, INBOX_ACTION_DONE);
-
-  inboxActionLabel = lv_label_create(pages[UI_PAGE_INBOX]);
-  lv_label_set_text(inboxActionLabel, "Use buttons | long-press for Home");
-  lv_obj_set_style_text_color(inboxActionLabel, lv_color_hex(0xAFAFAF), LV_PART_MAIN);
-  lv_obj_align(inboxActionLabel, LV_ALIGN_TOP_MID, 0, 296);
-
-  // Page 6: Pomodoro Timer
-  pages[UI_PAGE_POMODORO] = createBasePage();
-  lv_obj_t *pomodoroTitle = lv_label_create(pages[UI_PAGE_POMODORO]);
-  lv_label_set_text(pomodoroTitle, "Pomodoro Timer");
-  lv_obj_align(pomodoroTitle, LV_ALIGN_TOP_MID, 0, 14);
-
-  pomodoroModeLabel = lv_label_create(pages[UI_PAGE_POMODORO]);
-  lv_label_set_text(pomodoroModeLabel, getPomodoroModeText(pomodoroMode));
-  lv_obj_set_style_text_font(pomodoroModeLabel, &lv_font_montserrat_22, LV_PART_MAIN);
-  lv_obj_align(pomodoroModeLabel, LV_ALIGN_TOP_MID, 0, 40);
-
-  pomodoroArc = lv_arc_create(pages[UI_PAGE_POMODORO]);
-  lv_obj_set_size(pomodoroArc, 200, 200);
-  lv_obj_align(pomodoroArc, LV_ALIGN_CENTER, 0, 0);
-  lv_arc_set_rotation(pomodoroArc, 270);
-  lv_arc_set_bg_angles(pomodoroArc, 0, 360);
-  lv_arc_set_range(pomodoroArc, 0, 100);
-  lv_arc_set_value(pomodoroArc, 0);
-  lv_obj_set_style_arc_width(pomodoroArc, 12, LV_PART_MAIN);
-  lv_obj_set_style_arc_color(pomodoroArc, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
-  lv_obj_set_style_arc_width(pomodoroArc, 12, LV_PART_INDICATOR);
-  lv_obj_set_style_arc_color(pomodoroArc, lv_color_hex(getPomodoroColor(pomodoroMode)), LV_PART_INDICATOR);
-  lv_obj_set_style_opa(pomodoroArc, LV_OPA_TRANSP, LV_PART_KNOB);
-  lv_obj_clear_flag(pomodoroArc, LV_OBJ_FLAG_CLICKABLE);
-
-  pomodoroTimeLabel = lv_label_create(pages[UI_PAGE_POMODORO]);
-  lv_label_set_text(pomodoroTimeLabel, "25:00");
-  lv_obj_set_style_text_font(pomodoroTimeLabel, &lv_font_montserrat_32, LV_PART_MAIN);
-  lv_obj_align(pomodoroTimeLabel, LV_ALIGN_CENTER, 0, 0);
-
-  pomodoroStatusLabel = lv_label_create(pages[UI_PAGE_POMODORO]);
-  lv_label_set_text(pomodoroStatusLabel, "Tap to Start");
-  lv_obj_set_style_text_color(pomodoroStatusLabel, lv_color_hex(0xA0A0A0), LV_PART_MAIN);
-  lv_obj_align(pomodoroStatusLabel, LV_ALIGN_CENTER, 0, 50);
-
-  pomodoroCountLabel = lv_label_create(pages[UI_PAGE_POMODORO]);
-  lv_label_set_text(pomodoroCountLabel, "Completed: 0");
-  lv_obj_set_style_text_color(pomodoroCountLabel, lv_color_hex(0x90CAF9), LV_PART_MAIN);
-  lv_obj_align(pomodoroCountLabel, LV_ALIGN_BOTTOM_MID, 0, -80);
-
-  // Control buttons
-  lv_obj_t *startBtn = lv_btn_create(pages[UI_PAGE_POMODORO]);
-  lv_obj_set_size(startBtn, 90, 36);
-  lv_obj_align(startBtn, LV_ALIGN_BOTTOM_LEFT, 30, -36);
-  lv_obj_set_style_radius(startBtn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(startBtn, lv_color_hex(0x1E1E1E), LV_PART_MAIN);
-  lv_obj_add_flag(startBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
-  attachGestureHandlers(startBtn);
-  lv_obj_add_event_cb(startBtn, pomodoroControlCallback, LV_EVENT_CLICKED, (void*)0);
-  lv_obj_t *startLabel = lv_label_create(startBtn);
-  lv_label_set_text(startLabel, "Start");
-  lv_obj_center(startLabel);
-
-  lv_obj_t *resetBtn = lv_btn_create(pages[UI_PAGE_POMODORO]);
-  lv_obj_set_size(resetBtn, 90, 36);
-  lv_obj_align(resetBtn, LV_ALIGN_BOTTOM_MID, 0, -36);
-  lv_obj_set_style_radius(resetBtn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(resetBtn, lv_color_hex(0x1E1E1E), LV_PART_MAIN);
-  lv_obj_add_flag(resetBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
-  attachGestureHandlers(resetBtn);
-  lv_obj_add_event_cb(resetBtn, pomodoroControlCallback, LV_EVENT_CLICKED, (void*)1);
-  lv_obj_t *resetLabel = lv_label_create(resetBtn);
-  lv_label_set_text(resetLabel, "Reset");
-  lv_obj_center(resetLabel);
-
-  lv_obj_t *skipBtn = lv_btn_create(pages[UI_PAGE_POMODORO]);
-  lv_obj_set_size(skipBtn, 90, 36);
-  lv_obj_align(skipBtn, LV_ALIGN_BOTTOM_RIGHT, -30, -36);
-  lv_obj_set_style_radius(skipBtn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(skipBtn, lv_color_hex(0x1E1E1E), LV_PART_MAIN);
-  lv_obj_add_flag(skipBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
-  attachGestureHandlers(skipBtn);
-  lv_obj_add_event_cb(skipBtn, pomodoroControlCallback, LV_EVENT_CLICKED, (void*)2);
-  lv_obj_t *skipLabel = lv_label_create(skipBtn);
-  lv_label_set_text(skipLabel, "Skip");
-  lv_obj_center(skipLabel);
-
-  // Page 7: Weather
-  pages[UI_PAGE_WEATHER] = createBasePage();
-
-  weatherCityLabel = lv_label_create(pages[UI_PAGE_WEATHER]);
-  lv_label_set_text(weatherCityLabel, currentWeather.city);
-  lv_obj_set_style_text_color(weatherCityLabel, lv_color_hex(0x90CAF9), LV_PART_MAIN);
-  lv_obj_set_style_text_font(weatherCityLabel, &lv_font_montserrat_16, LV_PART_MAIN);
-  lv_obj_align(weatherCityLabel, LV_ALIGN_TOP_MID, 0, 30);
-
-  weatherTempLabel = lv_label_create(pages[UI_PAGE_WEATHER]);
-  lv_label_set_text(weatherTempLabel, "--");
-  lv_obj_set_style_text_font(weatherTempLabel, &lv_font_montserrat_32, LV_PART_MAIN);
-  lv_obj_align(weatherTempLabel, LV_ALIGN_CENTER, 0, -20);
-
-  lv_obj_t *degreeLabel = lv_label_create(pages[UI_PAGE_WEATHER]);
-  lv_label_set_text(degreeLabel, "°C");
-  lv_obj_set_style_text_font(degreeLabel, &lv_font_montserrat_22, LV_PART_MAIN);
-  lv_obj_align(degreeLabel, LV_ALIGN_CENTER, 40, -30);
-
-  weatherConditionLabel = lv_label_create(pages[UI_PAGE_WEATHER]);
-  lv_label_set_text(weatherConditionLabel, "Loading...");
-  lv_obj_set_style_text_color(weatherConditionLabel, lv_color_hex(0xC0C0C0), LV_PART_MAIN);
-  lv_obj_align(weatherConditionLabel, LV_ALIGN_CENTER, 0, 30);
-
-  // Bottom info panel
-  lv_obj_t *weatherInfoPanel = lv_obj_create(pages[UI_PAGE_WEATHER]);
-  lv_obj_set_size(weatherInfoPanel, 280, 80);
-  lv_obj_align(weatherInfoPanel, LV_ALIGN_BOTTOM_MID, 0, -40);
-  lv_obj_set_style_radius(weatherInfoPanel, 12, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(weatherInfoPanel, lv_color_hex(0x1A1A1A), LV_PART_MAIN);
-  lv_obj_set_style_border_width(weatherInfoPanel, 0, LV_PART_MAIN);
-  lv_obj_clear_flag(weatherInfoPanel, LV_OBJ_FLAG_SCROLLABLE);
-
-  // Feels Like (left)
-  lv_obj_t *feelsLikeTitle = lv_label_create(weatherInfoPanel);
-  lv_label_set_text(feelsLikeTitle, "FEELS LIKE");
-  lv_obj_set_style_text_color(feelsLikeTitle, lv_color_hex(0x808080), LV_PART_MAIN);
-  lv_obj_align(feelsLikeTitle, LV_ALIGN_TOP_LEFT, 20, 12);
-
-  weatherFeelsLikeLabel = lv_label_create(weatherInfoPanel);
-  lv_label_set_text(weatherFeelsLikeLabel, "--°");
-  lv_obj_set_style_text_font(weatherFeelsLikeLabel, &lv_font_montserrat_22, LV_PART_MAIN);
-  lv_obj_align(weatherFeelsLikeLabel, LV_ALIGN_TOP_LEFT, 20, 35);
-
-  // Humidity (right)
-  lv_obj_t *humidityTitle = lv_label_create(weatherInfoPanel);
-  lv_label_set_text(humidityTitle, "HUMIDITY");
-  lv_obj_set_style_text_color(humidityTitle, lv_color_hex(0x808080), LV_PART_MAIN);
-  lv_obj_align(humidityTitle, LV_ALIGN_TOP_RIGHT, -20, 12);
-
-  weatherHumidityLabel = lv_label_create(weatherInfoPanel);
-  lv_label_set_text(weatherHumidityLabel, "--%");
-  lv_obj_set_style_text_font(weatherHumidityLabel, &lv_font_montserrat_22, LV_PART_MAIN);
-  lv_obj_align(weatherHumidityLabel, LV_ALIGN_TOP_RIGHT, -20, 35);
-
-  // Page 8: App Launcher
-  pages[UI_PAGE_APP_LAUNCHER] = createBasePage();
-
-  appLauncherTitle = lv_label_create(pages[UI_PAGE_APP_LAUNCHER]);
-  lv_label_set_text(appLauncherTitle, "App Launcher");
-  lv_obj_set_style_text_color(appLauncherTitle, lv_color_hex(0x90CAF9), LV_PART_MAIN);
-  lv_obj_align(appLauncherTitle, LV_ALIGN_TOP_MID, 0, 14);
-
-  // App list container
-  appLauncherList = lv_obj_create(pages[UI_PAGE_APP_LAUNCHER]);
-  lv_obj_set_size(appLauncherList, 300, 216);
-  lv_obj_align(appLauncherList, LV_ALIGN_TOP_MID, 0, 66);
-  lv_obj_set_style_bg_color(appLauncherList, lv_color_hex(0x000000), LV_PART_MAIN);
-  lv_obj_set_style_border_width(appLauncherList, 1, LV_PART_MAIN);
-  lv_obj_set_style_border_color(appLauncherList, lv_color_hex(0x202020), LV_PART_MAIN);
-  lv_obj_set_style_radius(appLauncherList, 12, LV_PART_MAIN);
-  lv_obj_clear_flag(appLauncherList, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_add_flag(appLauncherList, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  lv_obj_set_flex_flow(appLauncherList, LV_FLEX_FLOW_COLUMN);
-  lv_obj_set_flex_align(appLauncherList, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-  lv_obj_set_style_pad_row(appLauncherList, 6, LV_PART_MAIN);
-  lv_obj_set_style_pad_all(appLauncherList, 10, LV_PART_MAIN);
-  attachGestureHandlers(appLauncherList);
-
-  // Status label for launch feedback
-  appLauncherStatusLabel = lv_label_create(pages[UI_PAGE_APP_LAUNCHER]);
-  lv_label_set_text(appLauncherStatusLabel, "Ready");
-  lv_obj_set_style_text_color(appLauncherStatusLabel, lv_color_hex(0xAFAFAF), LV_PART_MAIN);
-  lv_obj_set_style_text_font(appLauncherStatusLabel, &lv_font_montserrat_14, LV_PART_MAIN);
-  lv_obj_align(appLauncherStatusLabel, LV_ALIGN_TOP_MID, 0, 42);
-  lv_obj_add_flag(appLauncherStatusLabel, LV_OBJ_FLAG_HIDDEN);
-
-  // Navigation bar (moved inward for easier tapping on circular screen)
-  lv_obj_t *appNavBar = lv_obj_create(pages[UI_PAGE_APP_LAUNCHER]);
-  lv_obj_set_size(appNavBar, 280, 46);
-  lv_obj_align(appNavBar, LV_ALIGN_BOTTOM_MID, 0, -30);
-  lv_obj_set_style_radius(appNavBar, 14, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(appNavBar, lv_color_hex(0x141414), LV_PART_MAIN);
-  lv_obj_set_style_border_color(appNavBar, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
-  lv_obj_set_style_border_width(appNavBar, 1, LV_PART_MAIN);
-  lv_obj_clear_flag(appNavBar, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_add_flag(appNavBar, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  attachGestureHandlers(appNavBar);
-
-  appLauncherPrevBtn = lv_btn_create(appNavBar);
-  lv_obj_set_size(appLauncherPrevBtn, 94, 34);
-  lv_obj_align(appLauncherPrevBtn, LV_ALIGN_LEFT_MID, 6, 0);
-  lv_obj_set_style_radius(appLauncherPrevBtn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(appLauncherPrevBtn, lv_color_hex(0x222222), LV_PART_MAIN);
-  lv_obj_add_flag(appLauncherPrevBtn, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  attachGestureHandlers(appLauncherPrevBtn);
-  lv_obj_add_event_cb(appLauncherPrevBtn, appLauncherPageCallback, LV_EVENT_CLICKED, (void*)0);
-  lv_obj_t *prevLabel = lv_label_create(appLauncherPrevBtn);
-  lv_label_set_text(prevLabel, "Prev");
-  lv_obj_center(prevLabel);
-
-  appLauncherPageLabel = lv_label_create(appNavBar);
-  lv_label_set_text(appLauncherPageLabel, "1/1");
-  lv_obj_set_style_text_color(appLauncherPageLabel, lv_color_hex(0xC2C2C2), LV_PART_MAIN);
-  lv_obj_align(appLauncherPageLabel, LV_ALIGN_CENTER, 0, 0);
-
-  appLauncherNextBtn = lv_btn_create(appNavBar);
-  lv_obj_set_size(appLauncherNextBtn, 94, 34);
-  lv_obj_align(appLauncherNextBtn, LV_ALIGN_RIGHT_MID, -6, 0);
-  lv_obj_set_style_radius(appLauncherNextBtn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(appLauncherNextBtn, lv_color_hex(0x222222), LV_PART_MAIN);
-  lv_obj_add_flag(appLauncherNextBtn, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  attachGestureHandlers(appLauncherNextBtn);
-  lv_obj_add_event_cb(appLauncherNextBtn, appLauncherPageCallback, LV_EVENT_CLICKED, (void*)1);
-  lv_obj_t *nextLabel = lv_label_create(appLauncherNextBtn);
-  lv_label_set_text(nextLabel, "Next");
-  lv_obj_center(nextLabel);
-
-  // Page 9: Photo Frame (SD)
-  pages[UI_PAGE_PHOTO_FRAME] = createBasePage();
-
-  lv_obj_t *photoTitle = lv_label_create(pages[UI_PAGE_PHOTO_FRAME]);
-  lv_label_set_text(photoTitle, "Photo Frame (SD)");
-  lv_obj_set_style_text_color(photoTitle, lv_color_hex(0x90CAF9), LV_PART_MAIN);
-  lv_obj_align(photoTitle, LV_ALIGN_TOP_MID, 0, 14);
-
-  photoFrameRootLabel = lv_label_create(pages[UI_PAGE_PHOTO_FRAME]);
-  lv_label_set_text(photoFrameRootLabel, "Root: --");
-  lv_obj_set_width(photoFrameRootLabel, 300);
-  lv_label_set_long_mode(photoFrameRootLabel, LV_LABEL_LONG_DOT);
-  lv_obj_set_style_text_color(photoFrameRootLabel, lv_color_hex(0xAFAFAF), LV_PART_MAIN);
-  lv_obj_align(photoFrameRootLabel, LV_ALIGN_TOP_MID, 0, 36);
-
-  lv_obj_t *photoCard = lv_obj_create(pages[UI_PAGE_PHOTO_FRAME]);
-  lv_obj_set_size(photoCard, 300, 208);
-  lv_obj_align(photoCard, LV_ALIGN_TOP_MID, 0, 58);
-  lv_obj_set_style_radius(photoCard, 12, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(photoCard, lv_color_hex(0x101010), LV_PART_MAIN);
-  lv_obj_set_style_border_color(photoCard, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
-  lv_obj_set_style_border_width(photoCard, 1, LV_PART_MAIN);
-  lv_obj_set_style_pad_all(photoCard, 6, LV_PART_MAIN);
-  lv_obj_clear_flag(photoCard, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_add_flag(photoCard, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  attachGestureHandlers(photoCard);
-
-  photoFrameViewport = lv_obj_create(photoCard);
-  lv_obj_set_size(photoFrameViewport, 286, 194);
-  lv_obj_center(photoFrameViewport);
-  lv_obj_set_style_radius(photoFrameViewport, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_opa(photoFrameViewport, LV_OPA_TRANSP, LV_PART_MAIN);
-  lv_obj_set_style_border_width(photoFrameViewport, 0, LV_PART_MAIN);
-  lv_obj_set_style_pad_all(photoFrameViewport, 0, LV_PART_MAIN);
-  lv_obj_set_style_clip_corner(photoFrameViewport, true, LV_PART_MAIN);
-  lv_obj_clear_flag(photoFrameViewport, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_add_flag(photoFrameViewport, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  attachGestureHandlers(photoFrameViewport);
-
-  photoFrameImage = lv_img_create(photoFrameViewport);
-  lv_img_set_src(photoFrameImage, nullptr);
-  lv_obj_center(photoFrameImage);
-
-  photoFrameStatusLabel = lv_label_create(pages[UI_PAGE_PHOTO_FRAME]);
-  lv_label_set_text(photoFrameStatusLabel, "Waiting SD scan...");
-  lv_obj_set_style_text_color(photoFrameStatusLabel, lv_color_hex(0xAFAFAF), LV_PART_MAIN);
-  lv_obj_align(photoFrameStatusLabel, LV_ALIGN_TOP_MID, 0, 266);
-
-  photoFrameNameLabel = lv_label_create(pages[UI_PAGE_PHOTO_FRAME]);
-  lv_label_set_text(photoFrameNameLabel, "--");
-  lv_obj_set_width(photoFrameNameLabel, 280);
-  lv_label_set_long_mode(photoFrameNameLabel, LV_LABEL_LONG_DOT);
-  lv_obj_align(photoFrameNameLabel, LV_ALIGN_TOP_MID, 0, 284);
-
-  lv_obj_t *photoNavBar = lv_obj_create(pages[UI_PAGE_PHOTO_FRAME]);
-  lv_obj_set_size(photoNavBar, 304, 50);
-  lv_obj_align(photoNavBar, LV_ALIGN_TOP_MID, 0, 292);
-  lv_obj_set_style_radius(photoNavBar, 14, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(photoNavBar, lv_color_hex(0x151515), LV_PART_MAIN);
-  lv_obj_set_style_border_color(photoNavBar, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
-  lv_obj_set_style_border_width(photoNavBar, 1, LV_PART_MAIN);
-  lv_obj_set_style_pad_all(photoNavBar, 5, LV_PART_MAIN);
-  lv_obj_clear_flag(photoNavBar, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_add_flag(photoNavBar, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  attachGestureHandlers(photoNavBar);
-
-  photoFramePrevBtn = lv_btn_create(photoNavBar);
-  lv_obj_set_size(photoFramePrevBtn, 94, 38);
-  lv_obj_align(photoFramePrevBtn, LV_ALIGN_LEFT_MID, 6, 0);
-  lv_obj_set_style_radius(photoFramePrevBtn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(photoFramePrevBtn, lv_color_hex(0x252525), LV_PART_MAIN);
-  lv_obj_add_flag(photoFramePrevBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
-  attachGestureHandlers(photoFramePrevBtn);
-  lv_obj_add_event_cb(photoFramePrevBtn, photoFrameControlCallback, LV_EVENT_CLICKED, (void *)0);
-  lv_obj_t *photoPrevLabel = lv_label_create(photoFramePrevBtn);
-  lv_label_set_text(photoPrevLabel, "Prev");
-  lv_obj_center(photoPrevLabel);
-
-  photoFrameReloadBtn = lv_btn_create(photoNavBar);
-  lv_obj_set_size(photoFrameReloadBtn, 94, 38);
-  lv_obj_align(photoFrameReloadBtn, LV_ALIGN_CENTER, 0, 0);
-  lv_obj_set_style_radius(photoFrameReloadBtn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(photoFrameReloadBtn, lv_color_hex(0x252525), LV_PART_MAIN);
-  lv_obj_add_flag(photoFrameReloadBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
-  attachGestureHandlers(photoFrameReloadBtn);
-  lv_obj_add_event_cb(photoFrameReloadBtn, photoFrameControlCallback, LV_EVENT_CLICKED, (void *)1);
-  lv_obj_t *photoReloadLabel = lv_label_create(photoFrameReloadBtn);
-  lv_label_set_text(photoReloadLabel, "Reload");
-  lv_obj_center(photoReloadLabel);
-
-  photoFrameNextBtn = lv_btn_create(photoNavBar);
-  lv_obj_set_size(photoFrameNextBtn, 94, 38);
-  lv_obj_align(photoFrameNextBtn, LV_ALIGN_RIGHT_MID, -6, 0);
-  lv_obj_set_style_radius(photoFrameNextBtn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(photoFrameNextBtn, lv_color_hex(0x252525), LV_PART_MAIN);
-  lv_obj_add_flag(photoFrameNextBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
-  attachGestureHandlers(photoFrameNextBtn);
-  lv_obj_add_event_cb(photoFrameNextBtn, photoFrameControlCallback, LV_EVENT_CLICKED, (void *)2);
-  lv_obj_t *photoNextLabel = lv_label_create(photoFrameNextBtn);
-  lv_label_set_text(photoNextLabel, "Next");
-  lv_obj_center(photoNextLabel);
-
-  photoFrameIndexLabel = lv_label_create(pages[UI_PAGE_PHOTO_FRAME]);
-  lv_label_set_text(photoFrameIndexLabel, "0/0");
-  lv_obj_set_style_text_color(photoFrameIndexLabel, lv_color_hex(0xBFBFBF), LV_PART_MAIN);
-  lv_obj_align(photoFrameIndexLabel, LV_ALIGN_BOTTOM_MID, 0, -12);
-
-  // Page 10: Audio Player (SD)
-  pages[UI_PAGE_AUDIO_PLAYER] = createBasePage();
-
-  lv_obj_t *audioTitle = lv_label_create(pages[UI_PAGE_AUDIO_PLAYER]);
-  lv_label_set_text(audioTitle, "Music Player (SD)");
-  lv_obj_set_style_text_color(audioTitle, lv_color_hex(0x90CAF9), LV_PART_MAIN);
-  lv_obj_align(audioTitle, LV_ALIGN_TOP_MID, 0, 14);
-
-  lv_obj_t *audioCard = lv_obj_create(pages[UI_PAGE_AUDIO_PLAYER]);
-  lv_obj_set_size(audioCard, 300, 186);
-  lv_obj_align(audioCard, LV_ALIGN_TOP_MID, 0, 54);
-  lv_obj_set_style_radius(audioCard, 12, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(audioCard, lv_color_hex(0x111111), LV_PART_MAIN);
-  lv_obj_set_style_border_color(audioCard, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
-  lv_obj_set_style_border_width(audioCard, 1, LV_PART_MAIN);
-  lv_obj_set_style_pad_all(audioCard, 8, LV_PART_MAIN);
-  lv_obj_clear_flag(audioCard, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_add_flag(audioCard, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  attachGestureHandlers(audioCard);
-
-  lv_obj_t *audioIcon = lv_label_create(audioCard);
-  lv_label_set_text(audioIcon, LV_SYMBOL_AUDIO);
-  lv_obj_set_style_text_font(audioIcon, &lv_font_montserrat_32, LV_PART_MAIN);
-  lv_obj_set_style_text_color(audioIcon, lv_color_hex(0xB39DDB), LV_PART_MAIN);
-  lv_obj_align(audioIcon, LV_ALIGN_TOP_MID, 0, 2);
-
-  audioTrackLabel = lv_label_create(audioCard);
-  lv_label_set_text(audioTrackLabel, "Scanning SD...");
-  lv_obj_set_width(audioTrackLabel, 260);
-  lv_label_set_long_mode(audioTrackLabel, LV_LABEL_LONG_SCROLL_CIRCULAR);
-  lv_obj_set_style_text_font(audioTrackLabel, &lv_font_montserrat_16, LV_PART_MAIN);
-  lv_obj_set_style_text_align(audioTrackLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
-  lv_obj_align(audioTrackLabel, LV_ALIGN_TOP_MID, 0, 56);
-
-  audioTimeLabel = lv_label_create(audioCard);
-  lv_label_set_text(audioTimeLabel, "00:00 / --:--");
-  lv_obj_set_style_text_font(audioTimeLabel, &lv_font_montserrat_14, LV_PART_MAIN);
-  lv_obj_set_style_text_color(audioTimeLabel, lv_color_hex(0xC5CAE9), LV_PART_MAIN);
-  lv_obj_set_style_text_align(audioTimeLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
-  lv_obj_align(audioTimeLabel, LV_ALIGN_TOP_MID, 0, 86);
-
-  audioIndexLabel = lv_label_create(audioCard);
-  lv_label_set_text(audioIndexLabel, "0/0");
-  lv_obj_set_style_text_color(audioIndexLabel, lv_color_hex(0xBDBDBD), LV_PART_MAIN);
-  lv_obj_align(audioIndexLabel, LV_ALIGN_BOTTOM_MID, 0, -10);
-
-  lv_obj_t *audioRescanBtn = lv_btn_create(audioCard);
-  lv_obj_set_size(audioRescanBtn, 86, 32);
-  lv_obj_align(audioRescanBtn, LV_ALIGN_BOTTOM_RIGHT, -6, -6);
-  lv_obj_set_style_radius(audioRescanBtn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(audioRescanBtn, lv_color_hex(0x252525), LV_PART_MAIN);
-  lv_obj_add_flag(audioRescanBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
-  attachGestureHandlers(audioRescanBtn);
-  lv_obj_add_event_cb(audioRescanBtn, audioControlCallback, LV_EVENT_CLICKED, (void *)3);
-  lv_obj_t *audioRescanLabel = lv_label_create(audioRescanBtn);
-  lv_label_set_text(audioRescanLabel, "Rescan");
-  lv_obj_center(audioRescanLabel);
-
-  audioStatusLabel = lv_label_create(pages[UI_PAGE_AUDIO_PLAYER]);
-  lv_label_set_text(audioStatusLabel, "Ready");
-  lv_obj_set_style_text_color(audioStatusLabel, lv_color_hex(0x90CAF9), LV_PART_MAIN);
-  lv_obj_align(audioStatusLabel, LV_ALIGN_TOP_MID, 0, 248);
-
-  lv_obj_t *audioNavBar = lv_obj_create(pages[UI_PAGE_AUDIO_PLAYER]);
-  lv_obj_set_size(audioNavBar, 304, 50);
-  lv_obj_align(audioNavBar, LV_ALIGN_TOP_MID, 0, 292);
-  lv_obj_set_style_radius(audioNavBar, 14, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(audioNavBar, lv_color_hex(0x151515), LV_PART_MAIN);
-  lv_obj_set_style_border_color(audioNavBar, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
-  lv_obj_set_style_border_width(audioNavBar, 1, LV_PART_MAIN);
-  lv_obj_set_style_pad_all(audioNavBar, 5, LV_PART_MAIN);
-  lv_obj_clear_flag(audioNavBar, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_add_flag(audioNavBar, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  attachGestureHandlers(audioNavBar);
-
-  audioPrevBtn = lv_btn_create(audioNavBar);
-  lv_obj_set_size(audioPrevBtn, 94, 38);
-  lv_obj_align(audioPrevBtn, LV_ALIGN_LEFT_MID, 6, 0);
-  lv_obj_set_style_radius(audioPrevBtn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(audioPrevBtn, lv_color_hex(0x252525), LV_PART_MAIN);
-  lv_obj_add_flag(audioPrevBtn, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  attachGestureHandlers(audioPrevBtn);
-  lv_obj_add_event_cb(audioPrevBtn, audioControlCallback, LV_EVENT_CLICKED, (void *)0);
-  lv_obj_t *audioPrevLabel = lv_label_create(audioPrevBtn);
-  lv_label_set_text(audioPrevLabel, "Prev");
-  lv_obj_center(audioPrevLabel);
-
-  audioPlayBtn = lv_btn_create(audioNavBar);
-  lv_obj_set_size(audioPlayBtn, 94, 38);
-  lv_obj_align(audioPlayBtn, LV_ALIGN_CENTER, 0, 0);
-  lv_obj_set_style_radius(audioPlayBtn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(audioPlayBtn, lv_color_hex(0x2E7D32), LV_PART_MAIN);
-  lv_obj_set_style_bg_color(audioPlayBtn, lv_color_hex(0x1B5E20), LV_PART_MAIN | LV_STATE_PRESSED);
-  lv_obj_add_flag(audioPlayBtn, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  attachGestureHandlers(audioPlayBtn);
-  lv_obj_add_event_cb(audioPlayBtn, audioControlCallback, LV_EVENT_CLICKED, (void *)1);
-  audioPlayBtnLabel = lv_label_create(audioPlayBtn);
-  lv_label_set_text(audioPlayBtnLabel, "Play");
-  lv_obj_center(audioPlayBtnLabel);
-
-  audioNextBtn = lv_btn_create(audioNavBar);
-  lv_obj_set_size(audioNextBtn, 94, 38);
-  lv_obj_align(audioNextBtn, LV_ALIGN_RIGHT_MID, -6, 0);
-  lv_obj_set_style_radius(audioNextBtn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(audioNextBtn, lv_color_hex(0x252525), LV_PART_MAIN);
-  lv_obj_add_flag(audioNextBtn, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  attachGestureHandlers(audioNextBtn);
-  lv_obj_add_event_cb(audioNextBtn, audioControlCallback, LV_EVENT_CLICKED, (void *)2);
-  lv_obj_t *audioNextLabel = lv_label_create(audioNextBtn);
-  lv_label_set_text(audioNextLabel, "Next");
-  lv_obj_center(audioNextLabel);
-
-  updateAudioControlButtons(false, false);
-
-  // Page 11: Video Player (SD, MJPEG MVP)
-  pages[UI_PAGE_VIDEO_PLAYER] = createBasePage();
-
-  lv_obj_t *videoTitle = lv_label_create(pages[UI_PAGE_VIDEO_PLAYER]);
-  lv_label_set_text(videoTitle, "Video Player (SD)");
-  lv_obj_set_style_text_color(videoTitle, lv_color_hex(0x90CAF9), LV_PART_MAIN);
-  lv_obj_align(videoTitle, LV_ALIGN_TOP_MID, 0, 14);
-
-  lv_obj_t *videoCard = lv_obj_create(pages[UI_PAGE_VIDEO_PLAYER]);
-  lv_obj_set_size(videoCard, 300, 196);
-  lv_obj_align(videoCard, LV_ALIGN_TOP_MID, 0, 54);
-  lv_obj_set_style_radius(videoCard, 12, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(videoCard, lv_color_hex(0x101010), LV_PART_MAIN);
-  lv_obj_set_style_border_color(videoCard, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
-  lv_obj_set_style_border_width(videoCard, 1, LV_PART_MAIN);
-  lv_obj_set_style_pad_all(videoCard, 6, LV_PART_MAIN);
-  lv_obj_clear_flag(videoCard, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_add_flag(videoCard, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  attachGestureHandlers(videoCard);
-
-  videoViewport = lv_obj_create(videoCard);
-  lv_obj_set_size(videoViewport, 286, 148);
-  lv_obj_align(videoViewport, LV_ALIGN_TOP_MID, 0, 2);
-  lv_obj_set_style_radius(videoViewport, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(videoViewport, lv_color_hex(0x050505), LV_PART_MAIN);
-  lv_obj_set_style_border_color(videoViewport, lv_color_hex(0x202020), LV_PART_MAIN);
-  lv_obj_set_style_border_width(videoViewport, 1, LV_PART_MAIN);
-  lv_obj_set_style_pad_all(videoViewport, 0, LV_PART_MAIN);
-  lv_obj_set_style_clip_corner(videoViewport, true, LV_PART_MAIN);
-  lv_obj_clear_flag(videoViewport, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_add_flag(videoViewport, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  attachGestureHandlers(videoViewport);
-
-  videoImage = lv_img_create(videoViewport);
-  lv_img_set_src(videoImage, nullptr);
-  lv_obj_center(videoImage);
-
-  videoTrackLabel = lv_label_create(videoCard);
-  lv_label_set_text(videoTrackLabel, "Scanning SD...");
-  lv_obj_set_width(videoTrackLabel, 276);
-  lv_label_set_long_mode(videoTrackLabel, LV_LABEL_LONG_SCROLL_CIRCULAR);
-  lv_obj_set_style_text_font(videoTrackLabel, &lv_font_montserrat_14, LV_PART_MAIN);
-  lv_obj_set_style_text_align(videoTrackLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
-  lv_obj_align(videoTrackLabel, LV_ALIGN_TOP_MID, 0, 154);
-
-  videoHintLabel = lv_label_create(videoCard);
-  lv_label_set_text(videoHintLabel, "MJPEG only (.mjpeg/.mjpg)");
-  lv_obj_set_style_text_color(videoHintLabel, lv_color_hex(0xAFAFAF), LV_PART_MAIN);
-  lv_obj_set_style_text_font(videoHintLabel, &lv_font_montserrat_14, LV_PART_MAIN);
-  lv_obj_set_width(videoHintLabel, 276);
-  lv_obj_set_style_text_align(videoHintLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
-  lv_obj_align(videoHintLabel, LV_ALIGN_TOP_MID, 0, 172);
-
-  lv_obj_t *videoRescanBtn = lv_btn_create(videoCard);
-  lv_obj_set_size(videoRescanBtn, 74, 28);
-  lv_obj_align(videoRescanBtn, LV_ALIGN_TOP_RIGHT, -8, 8);
-  lv_obj_set_style_radius(videoRescanBtn, 8, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(videoRescanBtn, lv_color_hex(0x252525), LV_PART_MAIN);
-  lv_obj_add_flag(videoRescanBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
-  attachGestureHandlers(videoRescanBtn);
-  lv_obj_add_event_cb(videoRescanBtn, videoControlCallback, LV_EVENT_CLICKED, (void *)VIDEO_CONTROL_RESCAN);
-  lv_obj_t *videoRescanLabel = lv_label_create(videoRescanBtn);
-  lv_label_set_text(videoRescanLabel, "Rescan");
-  lv_obj_set_style_text_font(videoRescanLabel, &lv_font_montserrat_14, LV_PART_MAIN);
-  lv_obj_center(videoRescanLabel);
-
-  videoStatusLabel = lv_label_create(pages[UI_PAGE_VIDEO_PLAYER]);
-  lv_label_set_text(videoStatusLabel, "Ready");
-  lv_obj_set_style_text_color(videoStatusLabel, lv_color_hex(0x90CAF9), LV_PART_MAIN);
-  lv_obj_align(videoStatusLabel, LV_ALIGN_TOP_MID, 0, 252);
-
-  lv_obj_t *videoNavBar = lv_obj_create(pages[UI_PAGE_VIDEO_PLAYER]);
-  lv_obj_set_size(videoNavBar, 304, 50);
-  lv_obj_align(videoNavBar, LV_ALIGN_TOP_MID, 0, 292);
-  lv_obj_set_style_radius(videoNavBar, 14, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(videoNavBar, lv_color_hex(0x151515), LV_PART_MAIN);
-  lv_obj_set_style_border_color(videoNavBar, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
-  lv_obj_set_style_border_width(videoNavBar, 1, LV_PART_MAIN);
-  lv_obj_set_style_pad_all(videoNavBar, 5, LV_PART_MAIN);
-  lv_obj_clear_flag(videoNavBar, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_add_flag(videoNavBar, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  attachGestureHandlers(videoNavBar);
-
-  videoPrevBtn = lv_btn_create(videoNavBar);
-  lv_obj_set_size(videoPrevBtn, 94, 38);
-  lv_obj_align(videoPrevBtn, LV_ALIGN_LEFT_MID, 6, 0);
-  lv_obj_set_style_radius(videoPrevBtn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(videoPrevBtn, lv_color_hex(0x252525), LV_PART_MAIN);
-  lv_obj_add_flag(videoPrevBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
-  attachGestureHandlers(videoPrevBtn);
-  lv_obj_add_event_cb(videoPrevBtn, videoControlCallback, LV_EVENT_CLICKED, (void *)VIDEO_CONTROL_PREV);
-  lv_obj_t *videoPrevLabel = lv_label_create(videoPrevBtn);
-  lv_label_set_text(videoPrevLabel, "Prev");
-  lv_obj_center(videoPrevLabel);
-
-  videoPlayBtn = lv_btn_create(videoNavBar);
-  lv_obj_set_size(videoPlayBtn, 94, 38);
-  lv_obj_align(videoPlayBtn, LV_ALIGN_CENTER, 0, 0);
-  lv_obj_set_style_radius(videoPlayBtn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(videoPlayBtn, lv_color_hex(0x2E7D32), LV_PART_MAIN);
-  lv_obj_set_style_bg_color(videoPlayBtn, lv_color_hex(0x1B5E20), LV_PART_MAIN | LV_STATE_PRESSED);
-  lv_obj_add_flag(videoPlayBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
-  attachGestureHandlers(videoPlayBtn);
-  lv_obj_add_event_cb(videoPlayBtn, videoControlCallback, LV_EVENT_CLICKED, (void *)VIDEO_CONTROL_TOGGLE);
-  videoPlayBtnLabel = lv_label_create(videoPlayBtn);
-  lv_label_set_text(videoPlayBtnLabel, "Play");
-  lv_obj_center(videoPlayBtnLabel);
-
-  videoNextBtn = lv_btn_create(videoNavBar);
-  lv_obj_set_size(videoNextBtn, 94, 38);
-  lv_obj_align(videoNextBtn, LV_ALIGN_RIGHT_MID, -6, 0);
-  lv_obj_set_style_radius(videoNextBtn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(videoNextBtn, lv_color_hex(0x252525), LV_PART_MAIN);
-  lv_obj_add_flag(videoNextBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
-  attachGestureHandlers(videoNextBtn);
-  lv_obj_add_event_cb(videoNextBtn, videoControlCallback, LV_EVENT_CLICKED, (void *)VIDEO_CONTROL_NEXT);
-  lv_obj_t *videoNextLabel = lv_label_create(videoNextBtn);
-  lv_label_set_text(videoNextLabel, "Next");
-  lv_obj_center(videoNextLabel);
-
-  videoIndexLabel = lv_label_create(pages[UI_PAGE_VIDEO_PLAYER]);
-  lv_label_set_text(videoIndexLabel, "0/0");
-  lv_obj_set_style_text_color(videoIndexLabel, lv_color_hex(0xBFBFBF), LV_PART_MAIN);
-  lv_obj_align(videoIndexLabel, LV_ALIGN_BOTTOM_MID, 0, -12);
-
-  updateVideoControlButtons(false);
-
-  // Page 12: Voice Commands (phase-1 bridge)
-  pages[UI_PAGE_VOICE] = createBasePage();
-
-  lv_obj_t *voiceTitle = lv_label_create(pages[UI_PAGE_VOICE]);
-  lv_label_set_text(voiceTitle, "Voice Commands");
-  lv_obj_set_style_text_color(voiceTitle, lv_color_hex(0x80CBC4), LV_PART_MAIN);
-  lv_obj_align(voiceTitle, LV_ALIGN_TOP_MID, 0, 14);
-
-  lv_obj_t *voiceHint = lv_label_create(pages[UI_PAGE_VOICE]);
-  lv_label_set_text(voiceHint, "Preset commands + live mic stream");
-  lv_obj_set_style_text_color(voiceHint, lv_color_hex(0xB0BEC5), LV_PART_MAIN);
-  lv_obj_set_style_text_font(voiceHint, &lv_font_montserrat_14, LV_PART_MAIN);
-  lv_obj_align(voiceHint, LV_ALIGN_TOP_MID, 0, 38);
-
-  lv_obj_t *voiceCard = lv_obj_create(pages[UI_PAGE_VOICE]);
-  lv_obj_set_size(voiceCard, 312, 236);
-  lv_obj_align(voiceCard, LV_ALIGN_TOP_MID, 0, 66);
-  lv_obj_set_style_radius(voiceCard, 14, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(voiceCard, lv_color_hex(0x111111), LV_PART_MAIN);
-  lv_obj_set_style_border_color(voiceCard, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
-  lv_obj_set_style_border_width(voiceCard, 1, LV_PART_MAIN);
-  lv_obj_clear_flag(voiceCard, LV_OBJ_FLAG_SCROLLABLE);
-  lv_obj_add_flag(voiceCard, LV_OBJ_FLAG_GESTURE_BUBBLE);
-  attachGestureHandlers(voiceCard);
-
-  const int buttonW = 140;
-  const int buttonH = 42;
-  const int startX = 10;
-  const int startY = 12;
-  const int gapX = 12;
-  const int gapY = 12;
-  for (int i = 0; i < (int)(sizeof(VOICE_PRESET_COMMANDS) / sizeof(VOICE_PRESET_COMMANDS[0])); ++i) {
-    int row = i / 2;
-    int col = i % 2;
-    lv_obj_t *btn = lv_btn_create(voiceCard);
-    lv_obj_set_size(btn, buttonW, buttonH);
-    lv_obj_set_pos(btn, startX + col * (buttonW + gapX), startY + row * (buttonH + gapY));
-    lv_obj_set_style_radius(btn, 10, LV_PART_MAIN);
-    lv_obj_set_style_bg_color(btn, lv_color_hex(0x1F2A44), LV_PART_MAIN);
-    lv_obj_set_style_bg_color(btn, lv_color_hex(0x263859), LV_PART_MAIN | LV_STATE_PRESSED);
-    lv_obj_add_flag(btn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
-    attachGestureHandlers(btn);
-    lv_obj_add_event_cb(btn, voiceCommandButtonCallback, LV_EVENT_CLICKED, (void *)((intptr_t)i));
-
-    lv_obj_t *label = lv_label_create(btn);
-    lv_label_set_text(label, VOICE_PRESET_COMMANDS[i].label);
-    lv_obj_set_style_text_color(label, lv_color_hex(0xE3F2FD), LV_PART_MAIN);
-    lv_obj_set_style_text_font(label, &lv_font_montserrat_16, LV_PART_MAIN);
-    lv_obj_center(label);
-  }
-
-  voiceMicToggleBtn = lv_btn_create(voiceCard);
-  lv_obj_set_size(voiceMicToggleBtn, 108, 38);
-  lv_obj_align(voiceMicToggleBtn, LV_ALIGN_BOTTOM_RIGHT, -10, -8);
-  lv_obj_set_style_radius(voiceMicToggleBtn, 10, LV_PART_MAIN);
-  lv_obj_set_style_bg_color(voiceMicToggleBtn, lv_color_hex(0x00695C), LV_PART_MAIN);
-  lv_obj_set_style_bg_color(voiceMicToggleBtn, lv_color_hex(0x00796B), LV_PART_MAIN | LV_STATE_PRESSED);
-  lv_obj_add_flag(voiceMicToggleBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
-  attachGestureHandlers(voiceMicToggleBtn);
-  lv_obj_add_event_cb(voiceMicToggleBtn, voiceMicToggleCallback, LV_EVENT_CLICKED, nullptr);
-
-  voiceMicToggleLabel = lv_label_create(voiceMicToggleBtn);
-  lv_label_set_text(voiceMicToggleLabel, "Start Mic");
-  lv_obj_set_style_text_font(voiceMicToggleLabel, &lv_font_montserrat_16, LV_PART_MAIN);
-  lv_obj_center(voiceMicToggleLabel);
-
-  voiceStatusLabel = lv_label_create(voiceCard);
-  lv_label_set_text(voiceStatusLabel, "Ready");
-  lv_obj_set_style_text_color(voiceStatusLabel, lv_color_hex(0x80CBC4), LV_PART_MAIN);
-  lv_obj_set_style_text_font(voiceStatusLabel, &lv_font_montserrat_14, LV_PART_MAIN);
-  lv_obj_align(voiceStatusLabel, LV_ALIGN_BOTTOM_LEFT, 10, -56);
-
-  voiceResultLabel = lv_label_create(voiceCard);
-  lv_label_set_text(voiceResultLabel, "Result: --");
-  lv_obj_set_width(voiceResultLabel, 176);
-  lv_label_set_long_mode(voiceResultLabel, LV_LABEL_LONG_DOT);
-  lv_obj_set_style_text_color(voiceResultLabel, lv_color_hex(0xCFD8DC), LV_PART_MAIN);
-  lv_obj_set_style_text_font(voiceResultLabel, &lv_font_montserrat_14, LV_PART_MAIN);
-  lv_obj_align(voiceResultLabel, LV_ALIGN_BOTTOM_LEFT, 10, -30);
-
-  // Global page indicator
-  pageIndicatorLabel = lv_label_create(lv_scr_act());
-  lv_obj_set_style_text_color(pageIndicatorLabel, lv_color_hex(0x8F8F8F), LV_PART_MAIN);
-  lv_obj_align(pageIndicatorLabel, LV_ALIGN_BOTTOM_MID, 0, -10);
-
-  lv_obj_move_foreground(pageIndicatorLabel);
-  showPage(UI_PAGE_HOME);
-  applyBrightness(screenBrightness, false);
-  updateDiagnosticStatus();
-  refreshInboxView();
+static void clockTimerCallback(lv_timer_t *timer) {
+  (void)timer;
   updateClockDisplay();
-  lv_timer_create(clockTimerCallback, 1000, nullptr);
-  lv_timer_create(diagnosticsTimerCallback, 1000, nullptr);
-  lv_timer_create(pomodoroTimerCallback, 100, nullptr);
-  lv_timer_create(weatherTimerCallback, 60000, nullptr); // Check every minute
-
-  // Initialize weather display
-  updateWeatherDisplay();
 }
 
 static void setWifiStatus(const String &text) {
+  wifiStatusText = text;
   if (homeWifiLabel != nullptr) {
     lv_label_set_text(homeWifiLabel, text.c_str());
   }
@@ -7088,6 +7424,7 @@ static void setWifiStatus(const String &text) {
 }
 
 static void setWsStatus(const String &text) {
+  wsStatusText = text;
   if (homeWsLabel != nullptr) {
     lv_label_set_text(homeWsLabel, text.c_str());
   }
@@ -7100,42 +7437,33 @@ static void setWsStatus(const String &text) {
 }
 
 static void setStats(float cpu, float memory, float upload, float download) {
+  uiLastStats.cpu = cpu;
+  uiLastStats.memory = memory;
+  uiLastStats.upload = upload;
+  uiLastStats.download = download;
+  uiLastStats.valid = true;
+
   int cpuPercent = clampPercent(cpu);
   int memPercent = clampPercent(memory);
 
-  if (cpuArc != nullptr) {
-    lv_arc_set_value(cpuArc, cpuPercent);
-  }
-  if (memArc != nullptr) {
-    lv_arc_set_value(memArc, memPercent);
-  }
-  if (cpuValueLabel != nullptr) {
-    lv_label_set_text_fmt(cpuValueLabel, "CPU\n%d%%", cpuPercent);
-  }
-  if (memValueLabel != nullptr) {
-    lv_label_set_text_fmt(memValueLabel, "MEM\n%d%%", memPercent);
-  }
-  if (upValueLabel != nullptr) {
-    lv_label_set_text_fmt(upValueLabel, "%.1f KB/s", upload);
-  }
-  if (downValueLabel != nullptr) {
-    lv_label_set_text_fmt(downValueLabel, "%.1f KB/s", download);
-  }
-
-  if (statsLabel != nullptr) {
-    lv_label_set_text_fmt(
-      statsLabel,
-      "CPU : %.1f%%\nMEM : %.1f%%\nUP  : %.1f KB/s\nDOWN: %.1f KB/s",
-      cpu,
-      memory,
-      upload,
-      download
-    );
-  }
+  uiBindArcValue(cpuArc, cpuPercent);
+  uiBindArcValue(memArc, memPercent);
+  uiBindLabelFmt(cpuValueLabel, "CPU\n%d%%", cpuPercent);
+  uiBindLabelFmt(memValueLabel, "MEM\n%d%%", memPercent);
+  uiBindLabelFmt(upValueLabel, "%.1f KB/s", upload);
+  uiBindLabelFmt(downValueLabel, "%.1f KB/s", download);
+  uiBindLabelFmt(
+    statsLabel,
+    "CPU : %.1f%%\nMEM : %.1f%%\nUP  : %.1f KB/s\nDOWN: %.1f KB/s",
+    cpu,
+    memory,
+    upload,
+    download
+  );
 }
 
 static void sendHandshake() {
-  StaticJsonDocument<384> doc;
+  StaticJsonDocument<768> doc;
   doc["type"] = "handshake";
   doc["clientType"] = "esp32_device";
   doc["deviceId"] = DEVICE_ID;
@@ -7144,6 +7472,19 @@ static void sendHandshake() {
   data["firmwareVersion"] = FIRMWARE_VERSION;
   data["screenResolution"] = "360x360";
   data["screenShape"] = "circular";
+  JsonObject statsCaps = data.createNestedObject("capabilities").createNestedObject("statsStream");
+  statsCaps["version"] = STATS_STREAM_VERSION;
+  statsCaps["maxRateHz"] = STATS_STREAM_MAX_RATE_HZ;
+  statsCaps["rateHz"] = (currentPage == UI_PAGE_MONITOR) ? STATS_STREAM_MONITOR_RATE_HZ : STATS_STREAM_IDLE_RATE_HZ;
+  JsonObject compressionCaps = data["capabilities"].createNestedObject("compression");
+  compressionCaps["version"] = WS_COMPRESSION_VERSION;
+  compressionCaps.createNestedArray("codecs").add("lz4");
+  compressionCaps["maxRawBytes"] = WS_COMPRESSION_MAX_RAW_BYTES;
+  JsonObject audioCaps = data["capabilities"].createNestedObject("audioStream");
+  audioCaps["version"] = AUDIO_STREAM_VERSION;
+  audioCaps.createNestedArray("codecs").add("ima_adpcm");
+  audioCaps["maxSampleRate"] = AUDIO_STREAM_MAX_SAMPLE_RATE;
+  audioCaps["frameMs"] = AUDIO_STREAM_FRAME_MS;
 
   String output;
   serializeJson(doc, output);
@@ -7151,17 +7492,39 @@ static void sendHandshake() {
 }
 
 static void sendHeartbeat() {
-  StaticJsonDocument<256> doc;
-  doc["type"] = "heartbeat";
-
-  JsonObject data = doc.createNestedObject("data");
-  data["deviceId"] = DEVICE_ID;
-  data["uptime"] = millis() / 1000;
-  data["wifiSignal"] = WiFi.RSSI();
-
-  String output;
-  serializeJson(doc, output);
-  webSocket.sendTXT(output);
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_TELEMETRY, WS_COALESCE_HEARTBEAT);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "heartbeat");
+
+  json.beginObject("data");
+  json.field("deviceId", DEVICE_ID);
+  json.field("uptime", millis() / 1000);
+  json.field("wifiSignal", WiFi.RSSI());
+  json.field("jsonPeakBytes", ws_json_peak_bytes);
+  json.field("jsonPeakFragments", ws_json_peak_fragments);
+  json.field("txQueueDepth", wsOutboxDepth());
+  json.field("txQueuePeak", ws_outbox_stats.peakDepth);
+  json.field("txDropped", wsOutboxDropped());
+  json.field("txCoalesced", ws_outbox_stats.coalesced);
+  json.field("txDeferredLoops", ws_outbox_stats.deferredLoops);
+  json.field("statsFrames", statsStreamDecoder.frames);
+  json.field("statsGaps", statsStreamDecoder.gaps);
+  json.field("rxCompressedFrames", ws_compression_stats.frames);
+  json.field("rxCompressedRawBytes", ws_compression_stats.rawBytes);
+  json.field("rxCompressedWireBytes", ws_compression_stats.wireBytes);
+  json.field("rxDecodeUs", ws_compression_stats.decodeUs);
+  json.field("uiPagesResident", uiResidentPageCount());
+  json.field("uiPagesBytes", uiResidentPageBytes());
+  json.field("uiWidgetWrites", ui_bind_stats.applied);
+  json.field("uiWidgetSkipped", ui_bind_stats.skippedSame + ui_bind_stats.skippedHidden);
+
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
 }
 
 static void sendVoiceCommand(const char *text) {
@@ -7178,15 +7541,20 @@ static void sendVoiceCommand(const char *text) {
     return;
   }
 
-  StaticJsonDocument<256> doc;
-  doc["type"] = "voice_command";
-  JsonObject data = doc.createNestedObject("data");
-  data["text"] = text;
-  data["source"] = "esp32_ui";
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_CONTROL, WS_COALESCE_NONE);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "voice_command");
+  json.beginObject("data");
+  json.field("text", text);
+  json.field("source", "esp32_ui");
 
-  String output;
-  serializeJson(doc, output);
-  webSocket.sendTXT(output);
+  json.endObject();
+  json.endObject();
+  wsOutboxCommit(slot, json);
 
   if (voiceStatusLabel != nullptr) {
     lv_label_set_text_fmt(voiceStatusLabel, "Sending: %s", text);
@@ -7214,6 +7582,66 @@ static int parseUiPageFromVoiceName(const char *name) {
   return -1;
 }
 
+// Gauges only need the fast rate while the monitor page is visible.
+static void sendStatsStreamConfig(bool keyframe) {
+  if (!isConnected || !statsStreamActive) {
+    return;
+  }
+
+  const uint8_t rateHz = (currentPage == UI_PAGE_MONITOR) ? STATS_STREAM_MONITOR_RATE_HZ : STATS_STREAM_IDLE_RATE_HZ;
+  if (!keyframe && rateHz == statsStreamRateHz) {
+    return;
+  }
+
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_CONTROL, WS_COALESCE_STATS_STREAM_CONFIG);
+  if (slot == nullptr) {
+    return;
+  }
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "stats_stream_config");
+  json.beginObject("data");
+  json.field("deviceId", DEVICE_ID);
+  json.field("rateHz", rateHz);
+  json.field("keyframe", keyframe);
+  json.endObject();
+  json.endObject();
+  if (wsOutboxCommit(slot, json)) {
+    statsStreamRateHz = rateHz;
+  }
+}
+
+static void handleStatsStreamFrame(const uint8_t *payload, size_t length) {
+  StatsFrameResult result = statsStreamDecode(&statsStreamDecoder, payload, length);
+  if (result == STATS_FRAME_APPLIED) {
+    setStats(
+      statsStreamCpu(&statsStreamDecoder),
+      statsStreamMemory(&statsStreamDecoder),
+      statsStreamUpload(&statsStreamDecoder),
+      statsStreamDownload(&statsStreamDecoder)
+    );
+  } else if (result == STATS_FRAME_NEED_KEYFRAME) {
+    sendStatsStreamConfig(true);
+  }
+}
+
+static void handleCompressedTextFrame(const uint8_t *payload, size_t length) {
+  if (wsCompressionBuffer == nullptr) {
+    wsCompressionBuffer = (uint8_t *)heap_caps_malloc(WS_COMPRESSION_MAX_RAW_BYTES + 1, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (wsCompressionBuffer == nullptr) {
+      Serial.println("[WebSocket] compression buffer alloc failed");
+      return;
+    }
+  }
+
+  size_t rawLen = wsCompressionDecode(payload, length, wsCompressionBuffer, WS_COMPRESSION_MAX_RAW_BYTES + 1);
+  if (rawLen == 0) {
+    Serial.printf("[WebSocket] compressed frame rejected len=%u\n", (unsigned)length);
+    return;
+  }
+  webSocketEvent(WStype_TEXT, wsCompressionBuffer, rawLen);
+}
+
 static void handleSystemStats(const JsonObjectConst &data) {
   float cpu = data["cpu"] | 0;
   float memory = data["memory"] | 0;
@@ -7228,7 +7656,12 @@ void webSocketEvent(WStype_t type, uint8_t *payload, size_t length) {
     case WStype_DISCONNECTED:
       Serial.println("[WebSocket] disconnected");
       isConnected = false;
+      sdChangeSubscribed = false;
+      statsStreamActive = false;
+      wsCompressionActive = false;
+      wsOutboxClear();
       resetSdUploadSession(true);
+      stopNetAudioStream("WS disconnected", false);
       setWsStatus("WS: disconnected");
       if (voiceMicStreaming) {
         setVoiceMicStreaming(false, "WS disconnected", false);
@@ -7263,6 +7696,21 @@ void webSocketEvent(WStype_t type, uint8_t *payload, size_t length) {
       break;
 
     case WStype_BIN: {
+      if (!sdUploadSession.waitingBinary && audioStreamIsFrame(payload, length)) {
+        // Frames still in flight after a local stop are dropped quietly.
+        if (netAudioActive) {
+          handleNetAudioFrame(payload, length);
+        }
+        break;
+      }
+      if (statsStreamActive && !sdUploadSession.waitingBinary && statsStreamIsFrame(payload, length)) {
+        handleStatsStreamFrame(payload, length);
+        break;
+      }
+      if (wsCompressionActive && !sdUploadSession.waitingBinary && wsCompressionIsFrame(payload, length)) {
+        handleCompressedTextFrame(payload, length);
+        break;
+      }
       if (!sdUploadSession.active || !sdUploadSession.waitingBinary) {
         Serial.printf("[SD upload] unexpected binary frame len=%u\n", (unsigned)length);
         break;
@@ -7323,6 +7771,26 @@ void webSocketEvent(WStype_t type, uint8_t *payload, size_t length) {
         char body[96];
         snprintf(body, sizeof(body), "Server %s, interval %ldms", serverVersion, updateInterval);
         pushInboxMessage("event", "Handshake OK", body);
+
+        int statsVersion = data["statsStream"]["version"] | 0;
+        statsStreamActive = (statsVersion == STATS_STREAM_VERSION);
+        statsStreamRateHz = data["statsStream"]["rateHz"] | 0;
+        statsStreamReset(&statsStreamDecoder);
+        if (statsStreamActive) {
+          Serial.printf("[WebSocket] stats stream v%d at %uHz\n", statsVersion, (unsigned)statsStreamRateHz);
+          sendStatsStreamConfig(false);
+        }
+
+        int compressionVersion = data["compression"]["version"] | 0;
+        const char *codec = data["compression"]["codec"] | "";
+        wsCompressionActive = (compressionVersion == WS_COMPRESSION_VERSION) && strcmp(codec, "lz4") == 0;
+        if (wsCompressionActive) {
+          Serial.printf("[WebSocket] compression %s, minBytes=%d\n", codec, (int)(data["compression"]["minBytes"] | 0));
+        }
+      } else if (strcmp(messageType, "audio_stream_start") == 0) {
+        handleAudioStreamStart(doc["data"].as<JsonObjectConst>());
+      } else if (strcmp(messageType, "audio_stream_stop") == 0) {
+        handleAudioStreamStop(doc["data"].as<JsonObjectConst>());
       } else if (strcmp(messageType, "system_stats") == 0) {
         handleSystemStats(doc["data"].as<JsonObjectConst>());
       } else if (strcmp(messageType, "system_info") == 0) {
@@ -7412,6 +7880,9 @@ void webSocketEvent(WStype_t type, uint8_t *payload, size_t length) {
           voiceStreamStartAcked = true;
         } else if (strcmp(status, "accepted") == 0) {
           voiceStreamStartAcked = false;
+          const char *format = data["format"] | "pcm_s16le";
+          voiceStreamFormat = (strcmp(format, "ima_adpcm") == 0) ? VOICE_FORMAT_IMA_ADPCM : VOICE_FORMAT_PCM;
+          imaAdpcmReset(&voiceAdpcmState);
         }
 
         if (!success) {
@@ -7565,10 +8036,27 @@ void webSocketEvent(WStype_t type, uint8_t *payload, size_t length) {
       } else if (strcmp(messageType, "sd_list_request") == 0) {
         JsonObjectConst data = doc["data"].as<JsonObjectConst>();
         const char *requestId = data["requestId"] | "";
+        const char *dirPath = data["dir"] | "/";
+        bool recursive = data["recursive"] | true;
+        const char *cursor = data["cursor"] | "";
         int offset = data["offset"] | 0;
         int limit = data["limit"] | SD_BROWSER_RESPONSE_MAX_FILES;
-        Serial.printf("[SD] list request: requestId=%s offset=%d limit=%d\n", requestId, offset, limit);
-        sendSdListResponse(requestId, offset, limit);
+        bool refresh = data["refresh"] | false;
+        Serial.printf(
+          "[SD] list request: requestId=%s dir=%s cursor=%s offset=%d limit=%d\n",
+          requestId,
+          dirPath,
+          cursor[0] == '\0' ? "-" : cursor,
+          offset,
+          limit
+        );
+        sendSdListResponse(requestId, dirPath, recursive, cursor, offset, limit, refresh);
+      } else if (strcmp(messageType, "sd_subscribe") == 0) {
+        JsonObjectConst data = doc["data"].as<JsonObjectConst>();
+        const char *requestId = data["requestId"] | "";
+        sdChangeSubscribed = data["subscribe"] | true;
+        Serial.printf("[SD] change notifications %s\n", sdChangeSubscribed ? "on" : "off");
+        sendSdSubscribeAck(requestId);
       } else if (strcmp(messageType, "sd_preview_request") == 0) {
         JsonObjectConst data = doc["data"].as<JsonObjectConst>();
         const char *requestId = data["requestId"] | "";
@@ -7613,6 +8101,7 @@ void webSocketEvent(WStype_t type, uint8_t *payload, size_t length) {
 
         sendSdPreviewResponse(requestId, targetPath, true, (uint32_t)frameSize, "");
         webSocket.sendBIN(videoFrameData, frameSize);
+        wsOutboxNoteSent(WS_CLASS_CONTROL, frameSize);
         Serial.printf("[SD] preview sent requestId=%s path=%s bytes=%u\n", requestId, targetPath, (unsigned)frameSize);
       } else if (strcmp(messageType, "sd_delete_request") == 0) {
         JsonObjectConst data = doc["data"].as<JsonObjectConst>();
@@ -7629,6 +8118,7 @@ void webSocketEvent(WStype_t type, uint8_t *payload, size_t length) {
           } else if (!SD_MMC.remove(targetPath)) {
             sendSdDeleteResponse(requestId, targetPath, false, "delete failed");
           } else {
+            markSdBrowserSnapshotStale("deleted", targetPath);
             loadSdPhotoList();
             showCurrentPhotoFrame();
             loadSdAudioList();
@@ -7782,6 +8272,7 @@ void webSocketEvent(WStype_t type, uint8_t *payload, size_t length) {
           break;
         }
 
+        markSdBrowserSnapshotStale("uploaded", sdUploadSession.targetPath);
         sendSdUploadCommitAck(uploadId, true, sdUploadSession.targetPath, "");
         Serial.printf(
           "[SD upload] commit ok id=%s path=%s size=%u\n",
@@ -7822,6 +8313,7 @@ void setup() {
   settingsStoreReady = settingsStore.begin(PREF_NAMESPACE, false);
   if (settingsStoreReady) {
     screenBrightness = settingsStore.getUChar(PREF_KEY_BRIGHTNESS, 100);
+    clockSweepEnabled = settingsStore.getBool(PREF_KEY_CLOCK_SWEEP, false);
   }
   if (screenBrightness < 5 || screenBrightness > 100) {
     screenBrightness = 100;
@@ -7836,7 +8328,10 @@ void setup() {
     detectAndScanSdCard();
   }
   bool bootSplashShown = showBootSplashFromSd(1800);
+  loadUiTextFonts();
+  const uint32_t createUiStartUs = micros();
   createUi();
+  const uint32_t createUiUs = micros() - createUiStartUs;
   clearBootSplashOverlay();
   if (!bootSplashShown) {
     if (!sdMounted) {
@@ -7850,6 +8345,8 @@ void setup() {
   }
   refreshDynamicWallpaperSources();
   prepareDynamicWallpaperForPage(currentPage, true);
+  lv_refr_now(nullptr);
+  const uint32_t firstFrameMs = millis();
   if (sdMounted) {
     char body[128];
     snprintf(
@@ -7871,6 +8368,17 @@ void setup() {
   showCurrentPhotoFrame();
   loadSdAudioList();
   loadSdVideoList();
+  prepareNetAudio();
+  initWakeWord();
+
+  // Touch is served from here on, by the lv_timer_handler() calls below.
+  Serial.printf("[UI] boot: createUi %lu.%lu ms, first frame at %lu ms, interactive at %lu ms, %lu pages built (%ld B)\n",
+                (unsigned long)(createUiUs / 1000),
+                (unsigned long)(createUiUs % 1000 / 100),
+                (unsigned long)firstFrameMs,
+                (unsigned long)millis(),
+                (unsigned long)uiResidentPageCount(),
+                (long)uiResidentPageBytes());
 
   Serial.printf("Connecting WiFi: %s\n", WIFI_SSID);
   setWifiStatus("WiFi: connecting...");
@@ -7911,6 +8419,7 @@ void setup() {
 void loop() {
   webSocket.loop();
   processPendingAction();
+  processWakeWord();
   processVoiceMicStreaming();
 
   static unsigned long lastHeartbeat = 0;
@@ -7938,12 +8447,17 @@ void loop() {
     sendPhotoFrameState("periodic", true);
   }
 
+  wsOutboxDrain(webSocket);
+
   lv_timer_handler();
   processDynamicWallpapers();
   processPendingVideoControl();
   processVideoPlayback();
   processPendingAudioControl();
   processAudioPlayback();
-  bool mediaBusy = (isAudioRunning() && !audioPaused) || (videoPlaying && !videoPaused);
+  processAudioIndexScan();
+  processNetAudioStream();
+  processSpectrumView();
+  bool mediaBusy = (isAudioRunning() && !audioPaused) || netAudioActive || (videoPlaying && !videoPaused);
   delay(mediaBusy ? 1 : 5);
 }
@@ -0,0 +1,50 @@
+#ifndef _AUDIO_STREAM_H_
+#define _AUDIO_STREAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Desktop -> device audio stream, opened with an audio_stream_start message.
+// Must match the encoder in electron-app/src/main/audioStream.ts.
+//   [0]    tag 0x41
+//   [1]    stream id (from audio_stream_start)
+//   [2]    flags: bit0 last frame of the stream
+//   [3]    reserved (0)
+//   [4..7] frame number (uint32 LE); frame n starts at sender sample n * frameSamples
+//   then one IMA-ADPCM chunk (audio/ima_adpcm.h), mono, frameSamples long
+//   except possibly the last frame.
+#define AUDIO_STREAM_VERSION 1
+#define AUDIO_STREAM_FRAME_TAG 0x41
+#define AUDIO_STREAM_HEADER_BYTES 8
+#define AUDIO_STREAM_FLAG_LAST 0x01
+#define AUDIO_STREAM_FRAME_MS 20
+#define AUDIO_STREAM_MIN_SAMPLE_RATE 8000
+#define AUDIO_STREAM_MAX_SAMPLE_RATE 48000
+
+struct AudioStreamFrame {
+  uint8_t streamId;
+  uint8_t flags;
+  uint32_t frame;
+  const uint8_t *chunk;
+  size_t chunkLen;
+};
+
+static inline bool audioStreamIsFrame(const uint8_t *data, size_t len)
+{
+  return data != nullptr && len > AUDIO_STREAM_HEADER_BYTES && data[0] == AUDIO_STREAM_FRAME_TAG;
+}
+
+static inline bool audioStreamParseFrame(const uint8_t *data, size_t len, AudioStreamFrame *out)
+{
+  if (!audioStreamIsFrame(data, len)) {
+    return false;
+  }
+  out->streamId = data[1];
+  out->flags = data[2];
+  out->frame = (uint32_t)data[4] | ((uint32_t)data[5] << 8) | ((uint32_t)data[6] << 16) | ((uint32_t)data[7] << 24);
+  out->chunk = data + AUDIO_STREAM_HEADER_BYTES;
+  out->chunkLen = len - AUDIO_STREAM_HEADER_BYTES;
+  return true;
+}
+
+#endif
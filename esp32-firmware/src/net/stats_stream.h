@@ -0,0 +1,121 @@
+#ifndef _STATS_STREAM_H_
+#define _STATS_STREAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Compact system-stats stream negotiated in the handshake. Must match the
+// encoder in electron-app/src/main/statsStream.ts.
+//   [0] tag 0x53
+//   [1] flags: bit0 keyframe, bit1..4 field present (cpu, mem, up, down)
+//   [2] seq (uint8)
+//   keyframe fields: unsigned LEB128 absolute; delta fields: zigzag LEB128
+// Quantization: cpu/mem in 0.5 % steps, up/down in 0.1 KB/s steps.
+#define STATS_STREAM_VERSION 1
+#define STATS_STREAM_MAX_RATE_HZ 10
+#define STATS_FRAME_TAG 0x53
+#define STATS_FLAG_KEYFRAME 0x01
+#define STATS_FIELD_COUNT 4
+
+enum StatsFrameResult {
+  STATS_FRAME_APPLIED = 0,
+  STATS_FRAME_NEED_KEYFRAME,
+  STATS_FRAME_INVALID,
+};
+
+struct StatsStreamDecoder {
+  int32_t q[STATS_FIELD_COUNT];
+  uint8_t nextSeq;
+  bool synced;
+  uint32_t frames;
+  uint32_t gaps;
+  uint32_t errors;
+};
+
+static inline bool statsStreamIsFrame(const uint8_t *data, size_t len)
+{
+  return data != nullptr && len >= 3 && data[0] == STATS_FRAME_TAG;
+}
+
+static inline void statsStreamReset(StatsStreamDecoder *dec)
+{
+  dec->synced = false;
+  dec->nextSeq = 0;
+  for (int i = 0; i < STATS_FIELD_COUNT; ++i) {
+    dec->q[i] = 0;
+  }
+}
+
+static bool statsStreamReadVarint(const uint8_t **cursor, const uint8_t *end, uint32_t *out)
+{
+  uint32_t value = 0;
+  for (uint8_t shift = 0; shift < 35; shift += 7) {
+    if (*cursor >= end) {
+      return false;
+    }
+    const uint8_t b = *(*cursor)++;
+    value |= (uint32_t)(b & 0x7F) << shift;
+    if ((b & 0x80) == 0) {
+      *out = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Applies one frame to dec->q. A delta frame is only accepted on top of the
+// frame right before it; after a gap the caller should ask for a keyframe.
+static StatsFrameResult statsStreamDecode(StatsStreamDecoder *dec, const uint8_t *data, size_t len)
+{
+  if (!statsStreamIsFrame(data, len)) {
+    dec->errors++;
+    return STATS_FRAME_INVALID;
+  }
+
+  const uint8_t flags = data[1];
+  const uint8_t seq = data[2];
+  const bool keyframe = (flags & STATS_FLAG_KEYFRAME) != 0;
+  if (!keyframe && (!dec->synced || seq != dec->nextSeq)) {
+    if (dec->synced) {
+      dec->gaps++;
+    }
+    dec->synced = false;
+    return STATS_FRAME_NEED_KEYFRAME;
+  }
+
+  int32_t next[STATS_FIELD_COUNT];
+  const uint8_t *cursor = data + 3;
+  const uint8_t *end = data + len;
+  for (int i = 0; i < STATS_FIELD_COUNT; ++i) {
+    next[i] = keyframe ? 0 : dec->q[i];
+    if ((flags & (1 << (i + 1))) == 0) {
+      continue;
+    }
+    uint32_t raw = 0;
+    if (!statsStreamReadVarint(&cursor, end, &raw)) {
+      dec->errors++;
+      dec->synced = false;
+      return STATS_FRAME_INVALID;
+    }
+    if (keyframe) {
+      next[i] = (int32_t)raw;
+    } else {
+      next[i] += (int32_t)(raw >> 1) ^ -(int32_t)(raw & 1);
+    }
+  }
+
+  for (int i = 0; i < STATS_FIELD_COUNT; ++i) {
+    dec->q[i] = next[i];
+  }
+  dec->synced = true;
+  dec->nextSeq = (uint8_t)(seq + 1);
+  dec->frames++;
+  return STATS_FRAME_APPLIED;
+}
+
+static inline float statsStreamCpu(const StatsStreamDecoder *dec) { return dec->q[0] * 0.5f; }
+static inline float statsStreamMemory(const StatsStreamDecoder *dec) { return dec->q[1] * 0.5f; }
+static inline float statsStreamUpload(const StatsStreamDecoder *dec) { return dec->q[2] * 0.1f; }
+static inline float statsStreamDownload(const StatsStreamDecoder *dec) { return dec->q[3] * 0.1f; }
+
+#endif
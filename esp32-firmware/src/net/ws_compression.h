@@ -0,0 +1,166 @@
+#ifndef _WS_COMPRESSION_H_
+#define _WS_COMPRESSION_H_
+
+#ifdef UI_SIM_HOST
+#include <time.h>
+#else
+#include <Arduino.h>
+#endif
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Server -> device compressed text messages, negotiated in the handshake.
+// Must match electron-app/src/main/wsCompression.ts.
+//   [0] tag 0x5A
+//   [1] codec (1 = LZ4 block)
+//   [2..] raw length, unsigned LEB128
+//   LZ4 block payload
+// The decoded bytes are a normal JSON text message.
+#define WS_COMPRESSION_VERSION 1
+#define WS_COMPRESSION_FRAME_TAG 0x5A
+#define WS_COMPRESSION_CODEC_LZ4 1
+#define WS_COMPRESSION_MAX_RAW_BYTES 16384
+
+struct WsCompressionStats {
+  uint32_t frames;
+  uint32_t rawBytes;
+  uint32_t wireBytes;
+  uint32_t decodeUs;
+  uint32_t errors;
+};
+
+static WsCompressionStats ws_compression_stats;
+
+static inline uint32_t wsCompressionNowUs()
+{
+#ifdef UI_SIM_HOST
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL);
+#else
+  return micros();
+#endif
+}
+
+static inline bool wsCompressionIsFrame(const uint8_t *data, size_t len)
+{
+  return data != nullptr && len >= 3 && data[0] == WS_COMPRESSION_FRAME_TAG;
+}
+
+static bool wsCompressionReadLength(const uint8_t **cursor, const uint8_t *end, size_t *out)
+{
+  size_t value = 0;
+  for (uint8_t shift = 0; shift < 28; shift += 7) {
+    if (*cursor >= end) {
+      return false;
+    }
+    const uint8_t b = *(*cursor)++;
+    value |= (size_t)(b & 0x7F) << shift;
+    if ((b & 0x80) == 0) {
+      *out = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+// Safe LZ4 block decoder: every read and write is bounds-checked, so a
+// corrupt frame fails instead of overrunning dst.
+static bool wsLz4DecodeBlock(const uint8_t *src, size_t srcLen, uint8_t *dst, size_t dstLen)
+{
+  const uint8_t *ip = src;
+  const uint8_t *const ipEnd = src + srcLen;
+  uint8_t *op = dst;
+  uint8_t *const opEnd = dst + dstLen;
+
+  while (ip < ipEnd) {
+    const uint8_t token = *ip++;
+
+    size_t literalLen = token >> 4;
+    if (literalLen == 15) {
+      uint8_t b;
+      do {
+        if (ip >= ipEnd) {
+          return false;
+        }
+        b = *ip++;
+        literalLen += b;
+      } while (b == 255);
+    }
+    if ((size_t)(ipEnd - ip) < literalLen || (size_t)(opEnd - op) < literalLen) {
+      return false;
+    }
+    memcpy(op, ip, literalLen);
+    ip += literalLen;
+    op += literalLen;
+
+    if (ip == ipEnd) {
+      break;  // last sequence carries literals only
+    }
+
+    if (ipEnd - ip < 2) {
+      return false;
+    }
+    const size_t offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > (size_t)(op - dst)) {
+      return false;
+    }
+
+    size_t matchLen = (token & 0x0F) + 4;
+    if ((token & 0x0F) == 15) {
+      uint8_t b;
+      do {
+        if (ip >= ipEnd) {
+          return false;
+        }
+        b = *ip++;
+        matchLen += b;
+      } while (b == 255);
+    }
+    if ((size_t)(opEnd - op) < matchLen) {
+      return false;
+    }
+
+    const uint8_t *match = op - offset;
+    if (offset >= matchLen) {
+      memcpy(op, match, matchLen);
+      op += matchLen;
+    } else {
+      // Overlapping copy repeats the last `offset` bytes.
+      for (size_t i = 0; i < matchLen; ++i) {
+        *op++ = *match++;
+      }
+    }
+  }
+
+  return op == opEnd;
+}
+
+// Decodes one frame into dst (dstCap must leave room for a trailing NUL).
+// Returns the raw length, or 0 if the frame is malformed or too large.
+static size_t wsCompressionDecode(const uint8_t *frame, size_t len, uint8_t *dst, size_t dstCap)
+{
+  const uint32_t startedUs = wsCompressionNowUs();
+  const uint8_t *cursor = frame + 2;
+  const uint8_t *end = frame + len;
+  size_t rawLen = 0;
+  if (!wsCompressionIsFrame(frame, len) ||
+      frame[1] != WS_COMPRESSION_CODEC_LZ4 ||
+      !wsCompressionReadLength(&cursor, end, &rawLen) ||
+      rawLen == 0 || rawLen + 1 > dstCap ||
+      !wsLz4DecodeBlock(cursor, (size_t)(end - cursor), dst, rawLen)) {
+    ws_compression_stats.errors++;
+    return 0;
+  }
+
+  dst[rawLen] = '\0';
+  ws_compression_stats.frames++;
+  ws_compression_stats.rawBytes += rawLen;
+  ws_compression_stats.wireBytes += len;
+  ws_compression_stats.decodeUs += wsCompressionNowUs() - startedUs;
+  return rawLen;
+}
+
+#endif
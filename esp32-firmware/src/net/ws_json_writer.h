@@ -0,0 +1,213 @@
+#ifndef _WS_JSON_WRITER_H_
+#define _WS_JSON_WRITER_H_
+
+#ifndef UI_SIM_HOST
+#include <Arduino.h>
+#include <WebSocketsClient.h>
+#endif
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <type_traits>
+
+// Payload bytes per WebSocket fragment. Messages larger than this go out as a
+// text frame followed by continuation frames; the server reassembles them.
+#define WS_JSON_FRAGMENT_BYTES 1024
+#define WS_JSON_MAX_DEPTH 16
+
+#ifdef UI_SIM_HOST
+// Host builds (native-test) have no socket: fragments go to a callback that
+// gets the payload only.
+#define WEBSOCKETS_MAX_HEADER_SIZE 14
+class FragmentWebSocketsClient {
+ public:
+  bool (*onFragment)(void *ctx, bool firstFragment, const uint8_t *payload, size_t length, bool fin) = nullptr;
+  void *ctx = nullptr;
+
+  bool sendFragment(bool firstFragment, uint8_t *frame, size_t length, bool fin) {
+    return onFragment != nullptr && onFragment(ctx, firstFragment, frame + WEBSOCKETS_MAX_HEADER_SIZE, length, fin);
+  }
+};
+#else
+// WebSocketsClient keeps sendFrame() protected; this exposes just enough of it
+// to push text + continuation fragments straight from a caller-owned buffer.
+class FragmentWebSocketsClient : public WebSocketsClient {
+ public:
+  // frame must start with WEBSOCKETS_MAX_HEADER_SIZE spare bytes for the header.
+  bool sendFragment(bool firstFragment, uint8_t *frame, size_t length, bool fin) {
+    if (!isConnected()) {
+      return false;
+    }
+    return sendFrame(&_client, firstFragment ? WSop_text : WSop_continuation, frame, length, fin, true);
+  }
+};
+#endif
+
+// One shared frame buffer: all JSON senders run on the loop task, one at a time.
+static uint8_t ws_json_frame[WEBSOCKETS_MAX_HEADER_SIZE + WS_JSON_FRAGMENT_BYTES];
+static uint32_t ws_json_peak_bytes = 0;
+static uint32_t ws_json_peak_fragments = 0;
+
+// Streaming JSON writer: serializes directly into ws_json_frame and flushes a
+// fragment whenever it fills. No String, no heap, no document capacity limit.
+// The buffer constructor writes into caller storage instead (queued messages);
+// overflowing it fails the message rather than fragmenting.
+class WsJsonWriter {
+ public:
+  explicit WsJsonWriter(FragmentWebSocketsClient &ws)
+    : ws_(&ws), buf_(ws_json_frame + WEBSOCKETS_MAX_HEADER_SIZE), cap_(WS_JSON_FRAGMENT_BYTES) {}
+  WsJsonWriter(uint8_t *buffer, size_t capacity) : ws_(nullptr), buf_(buffer), cap_(capacity) {}
+
+  void beginObject(const char *key = nullptr) { open(key, '{'); }
+  void endObject() { close('}'); }
+  void beginArray(const char *key = nullptr) { open(key, '['); }
+  void endArray() { close(']'); }
+
+  void field(const char *key, const char *value) {
+    writeKey(key);
+    writeString(value == nullptr ? "" : value);
+  }
+
+  void field(const char *key, bool value) {
+    writeKey(key);
+    writeRaw(value ? "true" : "false");
+  }
+
+  void field(const char *key, double value, uint8_t decimals = 2) {
+    writeKey(key);
+    if (isnan(value) || isinf(value)) {
+      writeRaw("null");
+      return;
+    }
+    char text[32];
+    snprintf(text, sizeof(text), "%.*f", (int)decimals, value);
+    writeRaw(text);
+  }
+
+  template <typename T>
+  typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type
+  field(const char *key, T value) {
+    writeKey(key);
+    char text[24];
+    if (std::is_signed<T>::value) {
+      snprintf(text, sizeof(text), "%lld", (long long)value);
+    } else {
+      snprintf(text, sizeof(text), "%llu", (unsigned long long)value);
+    }
+    writeRaw(text);
+  }
+
+  // Array elements.
+  template <typename T>
+  void value(T v) { field(nullptr, v); }
+
+  // Sends the final fragment. Returns false if any fragment failed to send.
+  bool finish() {
+    if (ws_ != nullptr) {
+      flush(true);
+    }
+    if (total_ > ws_json_peak_bytes) {
+      ws_json_peak_bytes = total_;
+    }
+    if (fragments_ > ws_json_peak_fragments) {
+      ws_json_peak_fragments = fragments_;
+    }
+    return !failed_;
+  }
+
+  uint32_t bytesWritten() const { return total_; }
+  uint32_t fragments() const { return fragments_; }
+
+ private:
+  void open(const char *key, char bracket) {
+    writeKey(key);
+    put(bracket);
+    if (depth_ < WS_JSON_MAX_DEPTH) {
+      depth_++;
+      hasItem_ &= ~(1UL << depth_);
+    }
+  }
+
+  void close(char bracket) {
+    put(bracket);
+    if (depth_ > 0) {
+      depth_--;
+    }
+  }
+
+  void writeKey(const char *key) {
+    const uint32_t bit = 1UL << depth_;
+    if (hasItem_ & bit) {
+      put(',');
+    }
+    hasItem_ |= bit;
+    if (key != nullptr) {
+      writeString(key);
+      put(':');
+    }
+  }
+
+  void writeString(const char *text) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    put('"');
+    for (const uint8_t *p = (const uint8_t *)text; *p != '\0'; ++p) {
+      const uint8_t c = *p;
+      if (c == '"' || c == '\\') {
+        put('\\');
+        put((char)c);
+      } else if (c == '\n') {
+        writeRaw("\\n");
+      } else if (c == '\r') {
+        writeRaw("\\r");
+      } else if (c == '\t') {
+        writeRaw("\\t");
+      } else if (c < 0x20) {
+        writeRaw("\\u00");
+        put(HEX_DIGITS[c >> 4]);
+        put(HEX_DIGITS[c & 0x0F]);
+      } else {
+        put((char)c);
+      }
+    }
+    put('"');
+  }
+
+  void writeRaw(const char *text) {
+    while (*text != '\0') {
+      put(*text++);
+    }
+  }
+
+  void put(char c) {
+    if (len_ == cap_) {
+      if (ws_ == nullptr) {
+        failed_ = true;
+        return;
+      }
+      flush(false);
+    }
+    buf_[len_] = (uint8_t)c;
+    len_++;
+    total_++;
+  }
+
+  void flush(bool fin) {
+    if (!failed_ && !ws_->sendFragment(fragments_ == 0, ws_json_frame, len_, fin)) {
+      failed_ = true;
+    }
+    fragments_++;
+    len_ = 0;
+  }
+
+  FragmentWebSocketsClient *ws_;
+  uint8_t *buf_;
+  size_t cap_;
+  size_t len_ = 0;
+  uint32_t total_ = 0;
+  uint32_t fragments_ = 0;
+  uint32_t hasItem_ = 0;
+  uint8_t depth_ = 0;
+  bool failed_ = false;
+};
+
+#endif
@@ -0,0 +1,252 @@
+#ifndef _WS_OUTBOX_H_
+#define _WS_OUTBOX_H_
+
+#include <string.h>
+#include "ws_json_writer.h"
+
+// Outbound scheduler. Realtime traffic (voice) is written directly and only
+// charged against the per-loop budget; control and telemetry messages are
+// queued in fixed slots and drained in priority order from loop().
+enum WsOutboxClass : uint8_t {
+  WS_CLASS_REALTIME = 0,
+  WS_CLASS_CONTROL = 1,
+  WS_CLASS_TELEMETRY = 2,
+  WS_CLASS_COUNT = 3,
+};
+
+#define WS_OUTBOX_SLOTS 12
+#define WS_OUTBOX_SLOT_BYTES 640
+#define WS_OUTBOX_LOOP_BUDGET_BYTES 4096
+
+struct WsOutboxSlot {
+  uint8_t frame[WEBSOCKETS_MAX_HEADER_SIZE + WS_OUTBOX_SLOT_BYTES];
+  uint16_t len;
+  uint8_t cls;
+  uint8_t key;      // non-zero: a newer message with the same key replaces this one
+  uint32_t order;
+  bool used;
+  bool ready;
+};
+
+struct WsOutboxStats {
+  uint16_t depth[WS_CLASS_COUNT];
+  uint16_t peakDepth;
+  uint32_t sent[WS_CLASS_COUNT];
+  uint32_t sentBytes[WS_CLASS_COUNT];
+  uint32_t dropped[WS_CLASS_COUNT];
+  uint32_t coalesced;
+  uint32_t deferredLoops;
+};
+
+static WsOutboxSlot ws_outbox_slots[WS_OUTBOX_SLOTS];
+// A message that supersedes a queued one is written here and copied over
+// it on commit, so a failed rewrite leaves the queued message in place.
+static WsOutboxSlot ws_outbox_scratch;
+static WsOutboxSlot *ws_outbox_scratch_target = nullptr;
+static WsOutboxStats ws_outbox_stats;
+static uint32_t ws_outbox_order = 0;
+static uint32_t ws_outbox_loop_bytes = 0;
+
+static inline uint8_t *wsOutboxPayload(WsOutboxSlot *slot)
+{
+  return slot->frame + WEBSOCKETS_MAX_HEADER_SIZE;
+}
+
+static inline uint16_t wsOutboxDepth()
+{
+  return ws_outbox_stats.depth[WS_CLASS_CONTROL] + ws_outbox_stats.depth[WS_CLASS_TELEMETRY];
+}
+
+static inline uint32_t wsOutboxDropped()
+{
+  uint32_t total = 0;
+  for (uint8_t cls = 0; cls < WS_CLASS_COUNT; ++cls) {
+    total += ws_outbox_stats.dropped[cls];
+  }
+  return total;
+}
+
+static void wsOutboxRelease(WsOutboxSlot *slot)
+{
+  if (slot == nullptr || !slot->used) {
+    return;
+  }
+  slot->used = false;
+  slot->ready = false;
+  slot->len = 0;
+  if (ws_outbox_stats.depth[slot->cls] > 0) {
+    ws_outbox_stats.depth[slot->cls]--;
+  }
+}
+
+// Returns a slot to serialize into, or nullptr if the message was dropped.
+static WsOutboxSlot *wsOutboxAcquire(uint8_t cls, uint8_t key)
+{
+  if (cls == WS_CLASS_REALTIME || cls >= WS_CLASS_COUNT) {
+    return nullptr;
+  }
+
+  if (key != 0) {
+    for (int i = 0; i < WS_OUTBOX_SLOTS; ++i) {
+      WsOutboxSlot &slot = ws_outbox_slots[i];
+      if (slot.used && slot.key == key) {
+        // Superseded state: the replacement keeps the queue position once
+        // committed.
+        ws_outbox_scratch.used = true;
+        ws_outbox_scratch.ready = false;
+        ws_outbox_scratch.len = 0;
+        ws_outbox_scratch.cls = slot.cls;
+        ws_outbox_scratch.key = key;
+        ws_outbox_scratch_target = &slot;
+        return &ws_outbox_scratch;
+      }
+    }
+  }
+
+  WsOutboxSlot *target = nullptr;
+  for (int i = 0; i < WS_OUTBOX_SLOTS && target == nullptr; ++i) {
+    if (!ws_outbox_slots[i].used) {
+      target = &ws_outbox_slots[i];
+    }
+  }
+
+  if (target == nullptr && cls == WS_CLASS_CONTROL) {
+    // Full: control traffic evicts the oldest telemetry entry.
+    for (int i = 0; i < WS_OUTBOX_SLOTS; ++i) {
+      WsOutboxSlot &slot = ws_outbox_slots[i];
+      if (slot.used && slot.cls == WS_CLASS_TELEMETRY && (target == nullptr || slot.order < target->order)) {
+        target = &slot;
+      }
+    }
+    if (target != nullptr) {
+      ws_outbox_stats.dropped[WS_CLASS_TELEMETRY]++;
+      wsOutboxRelease(target);
+    }
+  }
+
+  if (target == nullptr) {
+    ws_outbox_stats.dropped[cls]++;
+    return nullptr;
+  }
+
+  target->used = true;
+  target->ready = false;
+  target->len = 0;
+  target->cls = cls;
+  target->key = key;
+  target->order = ++ws_outbox_order;
+  ws_outbox_stats.depth[cls]++;
+  if (wsOutboxDepth() > ws_outbox_stats.peakDepth) {
+    ws_outbox_stats.peakDepth = wsOutboxDepth();
+  }
+  return target;
+}
+
+static bool wsOutboxCommit(WsOutboxSlot *slot, WsJsonWriter &json)
+{
+  if (slot == nullptr) {
+    return false;
+  }
+  if (slot == &ws_outbox_scratch) {
+    WsOutboxSlot *target = ws_outbox_scratch_target;
+    ws_outbox_scratch.used = false;
+    ws_outbox_scratch_target = nullptr;
+    if (!json.finish()) {
+      ws_outbox_stats.dropped[slot->cls]++;
+      return false;
+    }
+    if (target == nullptr || !target->used || target->key != slot->key) {
+      // The queued message went out (or was cleared) meanwhile.
+      ws_outbox_stats.dropped[slot->cls]++;
+      return false;
+    }
+    target->len = (uint16_t)json.bytesWritten();
+    memcpy(wsOutboxPayload(target), wsOutboxPayload(slot), target->len);
+    target->ready = true;
+    ws_outbox_stats.coalesced++;
+    return true;
+  }
+  if (!json.finish()) {
+    ws_outbox_stats.dropped[slot->cls]++;
+    wsOutboxRelease(slot);
+    return false;
+  }
+  slot->len = (uint16_t)json.bytesWritten();
+  slot->ready = true;
+  return true;
+}
+
+// Account for a message that bypassed the queue (voice, binary previews, large
+// streamed responses) so queued traffic yields to it within the same loop.
+static void wsOutboxNoteSent(uint8_t cls, size_t bytes)
+{
+  if (cls >= WS_CLASS_COUNT) {
+    return;
+  }
+  ws_outbox_stats.sent[cls]++;
+  ws_outbox_stats.sentBytes[cls] += bytes;
+  ws_outbox_loop_bytes += bytes;
+}
+
+static WsOutboxSlot *wsOutboxOldestReady(uint8_t cls)
+{
+  WsOutboxSlot *oldest = nullptr;
+  for (int i = 0; i < WS_OUTBOX_SLOTS; ++i) {
+    WsOutboxSlot &slot = ws_outbox_slots[i];
+    if (slot.used && slot.ready && slot.cls == cls && (oldest == nullptr || slot.order < oldest->order)) {
+      oldest = &slot;
+    }
+  }
+  return oldest;
+}
+
+// Call once per loop(). Control always gets at least one message out so a
+// saturated voice stream cannot starve acks; telemetry only uses leftover budget.
+static void wsOutboxDrain(FragmentWebSocketsClient &ws)
+{
+  bool controlSent = false;
+  bool deferred = false;
+
+  for (uint8_t cls = WS_CLASS_CONTROL; cls < WS_CLASS_COUNT && !deferred; ++cls) {
+    WsOutboxSlot *slot = wsOutboxOldestReady(cls);
+    while (slot != nullptr) {
+      const bool overBudget = (ws_outbox_loop_bytes + slot->len) > WS_OUTBOX_LOOP_BUDGET_BYTES;
+      if (overBudget && (cls != WS_CLASS_CONTROL || controlSent)) {
+        deferred = true;
+        break;
+      }
+
+      const uint16_t len = slot->len;
+      if (ws.sendFragment(true, slot->frame, len, true)) {
+        wsOutboxNoteSent(cls, len);
+      } else {
+        ws_outbox_stats.dropped[cls]++;
+      }
+      wsOutboxRelease(slot);
+      if (cls == WS_CLASS_CONTROL) {
+        controlSent = true;
+      }
+      slot = wsOutboxOldestReady(cls);
+    }
+  }
+
+  if (deferred) {
+    ws_outbox_stats.deferredLoops++;
+  }
+  ws_outbox_loop_bytes = 0;
+}
+
+// Connection lost: queued messages are stale for the next session.
+static inline void wsOutboxClear()
+{
+  for (int i = 0; i < WS_OUTBOX_SLOTS; ++i) {
+    WsOutboxSlot &slot = ws_outbox_slots[i];
+    if (slot.used) {
+      ws_outbox_stats.dropped[slot.cls]++;
+      wsOutboxRelease(&slot);
+    }
+  }
+  ws_outbox_loop_bytes = 0;
+}
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef _SIM_CLOCK_H_
+#define _SIM_CLOCK_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// LVGL tick for the host simulator (lv_conf.h, UI_SIM_HOST). Only the
+// benchmark script advances it, so animations step the same on every run.
+uint32_t sim_millis(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
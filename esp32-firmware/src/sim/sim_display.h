@@ -0,0 +1,153 @@
+#ifndef _SIM_DISPLAY_H_
+#define _SIM_DISPLAY_H_
+
+#include <lvgl.h>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "display/round_refr.h"
+
+// In-memory stand-in for scr_st77916.h: the same resolution, two 40-row
+// draw buffers and the same round-panel clipping, but flushes are copied
+// into a frame buffer and complete at once. Counts what the panel driver
+// would render and send.
+#define SIM_RES 360
+#define SIM_DRAW_BUF_ROWS 40    // LCD_DRAW_BUF_ROWS
+
+struct SimFrameStats
+{
+  uint32_t frames;
+  uint64_t render_us;
+  uint32_t render_us_max;
+  uint64_t px_rendered;
+  uint64_t px_sent;
+  uint32_t flushes;
+  uint32_t transfers;         // drawBitmap() calls on the device
+  uint32_t unaligned;         // strips sent whole: bands could not be packed aligned
+};
+
+static std::vector<lv_color_t> sim_fb(SIM_RES * SIM_RES);
+static std::vector<lv_color_t> sim_buf1(SIM_RES * SIM_DRAW_BUF_ROWS);
+static std::vector<lv_color_t> sim_buf2(SIM_RES * SIM_DRAW_BUF_ROWS);
+static lv_disp_draw_buf_t sim_draw_buf;
+static lv_disp_drv_t sim_disp_drv;
+static lv_disp_t *sim_disp = NULL;
+static bool sim_round = true;
+static bool sim_frame_done = false;
+static SimFrameStats sim_stats;
+
+static void sim_copy_rect(const lv_color_t *src, int x1, int y1, int w, int h)
+{
+  for (int y = 0; y < h; ++y)
+  {
+    memcpy(&sim_fb[(size_t)(y1 + y) * SIM_RES + x1], src + (size_t)y * w, w * sizeof(lv_color_t));
+  }
+}
+
+static void sim_disp_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+  sim_stats.flushes++;
+  const int w = area->x2 - area->x1 + 1;
+  const int h = area->y2 - area->y1 + 1;
+  if (sim_round)
+  {
+    // Same plan and in-place packing as my_disp_flush().
+    const RoundClipRect rect = {(int16_t)area->x1, (int16_t)area->y1, (int16_t)area->x2, (int16_t)area->y2};
+    RoundClipRect bands[LCD_ROUND_FLUSH_MAX_BANDS];
+    size_t offsets[LCD_ROUND_FLUSH_MAX_BANDS];
+    int count = roundClipPlanBands(&lcd_round, &rect, LCD_ROUND_FLUSH_MAX_BANDS, LCD_ROUND_FLUSH_COST_PX, 1, bands);
+    if (count > 0 && !roundClipPackBands((uint8_t *)color_p, sizeof(lv_color_t), &rect, bands, count,
+                                         LCD_ROUND_FLUSH_ALIGN, offsets))
+    {
+      sim_stats.unaligned++;
+      bands[0] = rect;
+      offsets[0] = 0;
+      count = 1;
+    }
+    for (int i = 0; i < count; ++i)
+    {
+      sim_stats.transfers++;
+      sim_stats.px_sent += roundClipRectSize(&bands[i]);
+      sim_copy_rect((const lv_color_t *)((const uint8_t *)color_p + offsets[i]), bands[i].x1, bands[i].y1,
+                    bands[i].x2 - bands[i].x1 + 1, bands[i].y2 - bands[i].y1 + 1);
+    }
+  }
+  else
+  {
+    sim_stats.transfers++;
+    sim_stats.px_sent += (uint32_t)w * (uint32_t)h;
+    sim_copy_rect(color_p, area->x1, area->y1, w, h);
+  }
+  lv_disp_flush_ready(drv);
+}
+
+static void sim_disp_monitor(lv_disp_drv_t *drv, uint32_t time_ms, uint32_t px)
+{
+  (void)drv;
+  (void)time_ms;     // virtual clock, always 0; the script times the frame
+  sim_stats.px_rendered += px;
+  sim_frame_done = true;
+}
+
+static void sim_display_init()
+{
+  roundClipInit(&lcd_round, SIM_RES, LCD_ROUND_MARGIN_PX);
+  lv_disp_draw_buf_init(&sim_draw_buf, sim_buf1.data(), sim_buf2.data(), SIM_RES * SIM_DRAW_BUF_ROWS);
+  lv_disp_drv_init(&sim_disp_drv);
+  sim_disp_drv.hor_res = SIM_RES;
+  sim_disp_drv.ver_res = SIM_RES;
+  sim_disp_drv.flush_cb = sim_disp_flush;
+  sim_disp_drv.monitor_cb = sim_disp_monitor;
+  sim_disp_drv.draw_buf = &sim_draw_buf;
+  sim_disp = lv_disp_drv_register(&sim_disp_drv);
+}
+
+static void sim_set_round_clip(bool on)
+{
+  sim_round = on;
+  lv_timer_set_cb(sim_disp->refr_timer, on ? lcd_round_refr_timer : _lv_disp_refr_timer);
+}
+
+// Runs one LVGL handler pass; when it refreshed the screen, adds the wall
+// time of the pass to the stats.
+static bool sim_step()
+{
+  sim_frame_done = false;
+  const auto t0 = std::chrono::steady_clock::now();
+  lv_timer_handler();
+  const auto t1 = std::chrono::steady_clock::now();
+  if (!sim_frame_done)
+  {
+    return false;
+  }
+  const uint32_t us = (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count();
+  sim_stats.frames++;
+  sim_stats.render_us += us;
+  if (us > sim_stats.render_us_max)
+  {
+    sim_stats.render_us_max = us;
+  }
+  return true;
+}
+
+// Binary PPM of the frame buffer, for eyeballing a scene.
+static bool sim_dump_ppm(const char *path)
+{
+  FILE *f = fopen(path, "wb");
+  if (f == NULL)
+  {
+    return false;
+  }
+  fprintf(f, "P6\n%d %d\n255\n", SIM_RES, SIM_RES);
+  for (const lv_color_t &c : sim_fb)
+  {
+    const uint32_t rgb = lv_color_to32(c);
+    const uint8_t px[3] = {(uint8_t)(rgb >> 16), (uint8_t)(rgb >> 8), (uint8_t)rgb};
+    fwrite(px, 1, 3, f);
+  }
+  fclose(f);
+  return true;
+}
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef _SIM_FIRMWARE_H_
+#define _SIM_FIRMWARE_H_
+
+#include <Arduino.h>
+#include <lvgl.h>
+#include <vector>
+#include "display/img_transform.h"
+#include "sim/sim_display.h"
+#include "ui/ui_widgets.h"
+
+// The firmware's pages (ui/ui_pages.h) on the host, with stand-ins for the
+// main.cpp functions they call. The stand-ins leave the widgets as the
+// builders made them, except the photo frame, which shows a generated photo
+// the way showCurrentPhotoFrame() shows a decoded one, so the photo page
+// renders a real image. The scenarios in sim_main.cpp drive the rest.
+
+// Firmware state the builders read.
+static uint8_t screenBrightness = 100;
+static PomodoroMode pomodoroMode = POMODORO_WORK;
+static WeatherData currentWeather;
+static bool voiceMicStreaming = false;
+
+#include "ui/ui_pages.h"
+
+// Photo stand-in: a seeded gradient with some texture, so consecutive loads
+// differ everywhere like decoded JPEGs do.
+static std::vector<lv_color_t> simPhotoPixels(SIM_RES * SIM_RES);
+static lv_img_dsc_t simPhotoDsc;
+static uint32_t simPhotoGen = 0;
+static ImgTransformCache simPhotoTransform = imgTransformCache(IMG_SCALE_BILINEAR);    // as photoFrameTransform
+
+static void renderSimPhoto(uint32_t seed) {
+  for (int y = 0; y < SIM_RES; ++y) {
+    for (int x = 0; x < SIM_RES; ++x) {
+      const uint32_t n = (uint32_t)(x * 73856093u) ^ (uint32_t)(y * 19349663u) ^ (seed * 83492791u);
+      const uint8_t r = (uint8_t)((x + seed * 40) & 0xFF);
+      const uint8_t g = (uint8_t)((y + seed * 90) & 0xFF);
+      const uint8_t b = (uint8_t)(((x + y) / 2 + (n & 0x1F)) & 0xFF);
+      simPhotoPixels[(size_t)y * SIM_RES + x] = lv_color_make(r, g, b);
+    }
+  }
+  simPhotoDsc.header.always_zero = 0;
+  simPhotoDsc.header.cf = LV_IMG_CF_TRUE_COLOR;
+  simPhotoDsc.header.w = SIM_RES;
+  simPhotoDsc.header.h = SIM_RES;
+  simPhotoDsc.data_size = simPhotoPixels.size() * sizeof(lv_color_t);
+  simPhotoDsc.data = (const uint8_t *)simPhotoPixels.data();
+  simPhotoGen++;
+}
+
+// Fit into the viewport through the transform cache, as
+// showCurrentPhotoFrame() and showZoomedImage().
+static void showSimPhoto() {
+  if (photoFrameImage == nullptr || simPhotoGen == 0) {
+    return;
+  }
+  const int32_t viewportW = lv_obj_get_content_width(photoFrameViewport);
+  const int32_t viewportH = lv_obj_get_content_height(photoFrameViewport);
+  int32_t zoom = viewportW * 256 / SIM_RES;
+  if (viewportH * 256 / SIM_RES < zoom) {
+    zoom = viewportH * 256 / SIM_RES;
+  }
+  const lv_img_dsc_t *shown = imgTransformGet(&simPhotoTransform, &simPhotoDsc, simPhotoGen, (uint16_t)zoom,
+                                              viewportW, viewportH);
+  lv_img_set_src(photoFrameImage, nullptr);
+  if (shown != nullptr && shown != &simPhotoDsc) {
+    lv_img_set_src(photoFrameImage, shown);
+    lv_obj_set_size(photoFrameImage, shown->header.w, shown->header.h);
+    lv_img_set_zoom(photoFrameImage, LV_IMG_ZOOM_NONE);
+  } else {
+    lv_img_set_src(photoFrameImage, &simPhotoDsc);
+    lv_obj_set_size(photoFrameImage, SIM_RES, SIM_RES);
+    lv_img_set_pivot(photoFrameImage, SIM_RES / 2, SIM_RES / 2);
+    lv_img_set_zoom(photoFrameImage, (uint16_t)zoom);
+  }
+  lv_obj_center(photoFrameImage);
+}
+
+static void pageLeaving(int previousPage, int nextPage) {
+  (void)previousPage;
+  (void)nextPage;
+}
+
+static void pageEntered(int previousPage, int page) {
+  (void)previousPage;
+  if (page == UI_PAGE_PHOTO_FRAME) {
+    showSimPhoto();
+  }
+}
+
+static void releasePhotoFrameMedia() {
+  imgTransformFree(&simPhotoTransform);
+}
+
+static void releaseVideoPlayerMedia() {}
+
+static const lv_font_t *uiTextFont(uint8_t size) {
+  switch (size) {
+    case 14: return &lv_font_montserrat_14;
+    case 16: return &lv_font_montserrat_16;
+    case 22: return &lv_font_montserrat_22;
+    case 32: return &lv_font_montserrat_32;
+    default: return LV_FONT_DEFAULT;
+  }
+}
+
+static const char *getPomodoroModeText(PomodoroMode mode) {
+  switch (mode) {
+    case POMODORO_SHORT_BREAK: return "Short Break";
+    case POMODORO_LONG_BREAK: return "Long Break";
+    default: return "Work";
+  }
+}
+
+static uint32_t getPomodoroColor(PomodoroMode mode) {
+  switch (mode) {
+    case POMODORO_SHORT_BREAK: return 0x66BB6A;
+    case POMODORO_LONG_BREAK: return 0x42A5F5;
+    default: return 0xEF5350;
+  }
+}
+
+static void clockPageClickCallback(lv_event_t *e) { (void)e; }
+static void brightnessSliderEventCallback(lv_event_t *e) { (void)e; }
+static void settingsActionEventCallback(lv_event_t *e) { (void)e; }
+static void inboxActionEventCallback(lv_event_t *e) { (void)e; }
+static void pomodoroControlCallback(lv_event_t *e) { (void)e; }
+static void appLauncherPageCallback(lv_event_t *e) { (void)e; }
+static void photoFrameControlCallback(lv_event_t *e) { (void)e; }
+static void audioSeekSliderCallback(lv_event_t *e) { (void)e; }
+static void audioControlCallback(lv_event_t *e) { (void)e; }
+static void videoControlCallback(lv_event_t *e) { (void)e; }
+static void voiceCommandButtonCallback(lv_event_t *e) { (void)e; }
+static void voiceMicToggleCallback(lv_event_t *e) { (void)e; }
+static void clockTimerCallback(lv_timer_t *timer) { (void)timer; }
+static void clockSweepTimerCallback(lv_timer_t *timer) { (void)timer; }
+static void diagnosticsTimerCallback(lv_timer_t *timer) { (void)timer; }
+static void pomodoroTimerCallback(lv_timer_t *timer) { (void)timer; }
+static void weatherTimerCallback(lv_timer_t *timer) { (void)timer; }
+
+static void updateClockDisplay() {}
+static void setStats(float cpu, float memory, float upload, float download) {
+  (void)cpu;
+  (void)memory;
+  (void)upload;
+  (void)download;
+}
+static void setWifiStatus(const String &text) { (void)text; }
+static void setWsStatus(const String &text) { (void)text; }
+static void setActionStatus(const String &text) { (void)text; }
+static void applyBrightness(uint8_t brightness, bool persist) {
+  (void)brightness;
+  (void)persist;
+}
+static void updateDiagnosticStatus() {}
+static void refreshInboxView() {}
+static void updatePomodoroDisplay() {}
+static void updateWeatherDisplay() {}
+static void updateAppLauncherDisplay() {}
+static void updatePhotoFrameNavButtons() {}
+static void refreshAudioTimeLabel(bool force) { (void)force; }
+static void updateAudioControlButtons(bool hasTracks, bool canStepTrack) {
+  (void)hasTracks;
+  (void)canStepTrack;
+}
+static void updateVideoControlButtons(bool hasTracks) { (void)hasTracks; }
+static void setSpectrumVisible(bool visible) { (void)visible; }
+static void pauseDynamicWallpapersForMs(uint32_t durationMs) { (void)durationMs; }
+
+#endif
@@ -0,0 +1,681 @@
+// Headless rendering benchmark (env:native-sim).
+//
+//   pio run -e native-sim && .pio/build/native-sim/program [--dump DIR]
+//       [--font cjk_16.bin [--font-cache BYTES]]
+//
+// Renders the firmware's own pages: createUi(), showPage() and the page
+// builders are ui/ui_pages.h, compiled here as in main.cpp. The main.cpp
+// functions they call (SD card, WebSocket, I2S, settings) are replaced by
+// the stand-ins in sim/sim_firmware.h, so the pages show what their builders
+// put in them plus what the scenarios below write; the photo frame shows a
+// generated photo. Pages are built when first shown and the heavy ones
+// released when left, as on the device. Times are for the host CPU; compare
+// runs, not absolute numbers against the device.
+//
+// Scripts page switches (home, monitor, photo), carousel swipes, photo
+// loads, a home clock tick and the monitor arcs. The clock page (over the
+// photo, as with a dynamic wallpaper) runs its seconds once with labels,
+// once with the digit sprites from display/clock_face.h, and once as a
+// 30 FPS sweep. Each scenario runs with and without the round-panel
+// clipping and reports render time per frame and the pixels rendered and
+// sent.
+//
+// Then benchmarks the image scaler (display/img_scale.h) on wallpaper,
+// video and photo geometries: the one-off rebuild per filter, and a full
+// redraw of the image with LVGL's zoom against the cached result.
+//
+// Then plays wallpaper frames under the home and clock pages, once redrawn
+// by LVGL and once through the overlay compositor (display/layer_compose.h),
+// and reports the time per frame, the one-off overlay rebuild and how far
+// the composed frame is from LVGL's.
+//
+// Then counts, for a few fixed invalidated areas, the pixels the round
+// clipping renders and sends out of the original area, and times the band
+// planning and the aligned in-place packing per strip.
+//
+// Then times the spectrum analyzer (audio/spectrum.h): the Q15 FFT alone
+// and a whole analysis pass per window, with the FFT's error against a
+// double-precision DFT of the same windowed input.
+//
+// With --font, also renders inbox/weather-style Chinese labels through the
+// SD font path (display/sd_font.h) and reports render time per label, cold
+// and warm, and the glyph cache hit rate.
+#include <lvgl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "audio/spectrum.h"
+#include "display/clock_face.h"
+#include "display/img_transform.h"
+#include "display/layer_compose.h"
+#include "display/sd_font.h"
+#include "sim/sim_clock.h"
+#include "sim/sim_display.h"
+#include "sim/sim_firmware.h"
+
+static uint32_t simNowMs = 0;
+
+extern "C" uint32_t sim_millis(void)
+{
+  return simNowMs;
+}
+
+static constexpr int SIM_FRAME_MS = 16;
+static const int SIM_SWITCH_PAGES[] = {UI_PAGE_HOME, UI_PAGE_MONITOR, UI_PAGE_PHOTO_FRAME};
+static constexpr int SIM_SWITCH_PAGE_COUNT = sizeof(SIM_SWITCH_PAGES) / sizeof(SIM_SWITCH_PAGES[0]);
+
+// The clock in labels, for comparison with the sprite rows buildClockPage()
+// makes. Created on the clock page the first time it is needed.
+static lv_obj_t *simClockTimeLabel = nullptr;
+static lv_obj_t *simClockSecondLabel = nullptr;
+
+// Hides every page, for the benchmarks that draw on a page of their own.
+// The next showPage() brings the current one back.
+static void hideSimPages() {
+  for (int i = 0; i < UI_PAGE_COUNT; ++i) {
+    if (pages[i] != nullptr) {
+      lv_obj_add_flag(pages[i], LV_OBJ_FLAG_HIDDEN);
+    }
+  }
+}
+
+static lv_obj_t *createBenchPage() {
+  hideSimPages();
+  lv_obj_t *page = lv_obj_create(lv_scr_act());
+  lv_obj_remove_style_all(page);
+  lv_obj_set_size(page, lv_pct(100), lv_pct(100));
+  lv_obj_clear_flag(page, LV_OBJ_FLAG_SCROLLABLE);
+  return page;
+}
+
+// Advances the virtual clock frame by frame until LVGL has nothing left to
+// redraw (and at least one frame was drawn, if anything was invalidated).
+static void settle() {
+  for (int i = 0; i < 200; ++i) {
+    simNowMs += SIM_FRAME_MS;
+    const bool drew = sim_step();
+    if (!drew && sim_disp->inv_p == 0 && lv_anim_count_running() == 0) {
+      return;
+    }
+  }
+}
+
+struct SimScenario {
+  const char *name;
+  void (*setup)();
+  void (*step)(int i);
+  int steps;
+};
+
+static void setupHome() { showPage(UI_PAGE_HOME); }
+static void setupPhoto() { showPage(UI_PAGE_PHOTO_FRAME); }
+static void setupMonitor() { showPage(UI_PAGE_MONITOR); }
+static void stepPageSwitch(int i) { showPage(SIM_SWITCH_PAGES[(i + 1) % SIM_SWITCH_PAGE_COUNT]); }
+static void stepSwipe(int i) {
+  (void)i;
+  shiftHomeCarousel(1);
+}
+static void stepPhotoLoad(int i) {
+  renderSimPhoto((uint32_t)i + 1);
+  showSimPhoto();
+}
+static void stepClock(int i) { lv_label_set_text_fmt(homeClockLabel, "12:%02d", (i + 1) % 60); }
+static void stepMonitor(int i) {
+  lv_arc_set_value(cpuArc, (int16_t)(20 + (i * 7) % 70));
+  lv_arc_set_value(memArc, (int16_t)(50 + (i * 3) % 30));
+}
+
+static void setSimHidden(lv_obj_t *obj, bool hidden) {
+  if (obj == nullptr) {
+    return;
+  }
+  if (hidden) {
+    lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+  } else {
+    lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+  }
+}
+
+static void showSimClock(bool sprites, bool sweep) {
+  showPage(UI_PAGE_CLOCK);
+  lv_img_set_src(clockWallpaperImage, &simPhotoDsc);
+  if (simClockTimeLabel == nullptr) {
+    simClockTimeLabel = lv_label_create(pages[UI_PAGE_CLOCK]);
+    lv_obj_set_style_text_font(simClockTimeLabel, &lv_font_montserrat_32, LV_PART_MAIN);
+    lv_obj_align(simClockTimeLabel, LV_ALIGN_CENTER, 0, -6);
+    simClockSecondLabel = lv_label_create(pages[UI_PAGE_CLOCK]);
+    lv_obj_set_style_text_color(simClockSecondLabel, lv_color_hex(0xFFCC80), LV_PART_MAIN);
+    lv_obj_align(simClockSecondLabel, LV_ALIGN_CENTER, 0, 36);
+  }
+  setSimHidden(simClockTimeLabel, sprites);
+  setSimHidden(simClockSecondLabel, sprites);
+  setSimHidden(clockTimeRow.cont, !sprites);
+  setSimHidden(clockSecondRow.cont, !sprites);
+  setSimHidden(clockSweepTip, !sweep);
+  lv_label_set_text(simClockTimeLabel, "12:00");
+  lv_label_set_text(simClockSecondLabel, ":00");
+  clockFaceSetText(&clockTimeRow, &clockDigitSprites, "12:00");
+  clockFaceSetText(&clockSecondRow, &clockSecondSprites, ":00");
+  lv_arc_set_value(clockSecondArc, 0);
+}
+static void setupClockLabels() { showSimClock(false, false); }
+static void setupClockSprites() { showSimClock(true, false); }
+static void setupClockSweep() { showSimClock(true, true); }
+
+// One step is one second, as updateClockDisplay() before and after.
+static void stepClockLabels(int i) {
+  const int t = i + 1;
+  lv_label_set_text_fmt(simClockTimeLabel, "12:%02d", (t / 60) % 60);
+  lv_label_set_text_fmt(simClockSecondLabel, ":%02d", t % 60);
+  lv_arc_set_value(clockSecondArc, (int16_t)((t % 60) * 6));
+}
+static void stepClockSprites(int i) {
+  const int t = i + 1;
+  char text[16];
+  snprintf(text, sizeof(text), "12:%02d", (t / 60) % 60);
+  clockFaceSetText(&clockTimeRow, &clockDigitSprites, text);
+  snprintf(text, sizeof(text), ":%02d", t % 60);
+  clockFaceSetText(&clockSecondRow, &clockSecondSprites, text);
+  lv_arc_set_value(clockSecondArc, (int16_t)((t % 60) * 6));
+}
+// One step is one sweep tick at the top rate, as clockSweepTimerCallback().
+static void stepClockSweep(int i) {
+  const uint32_t ms = (uint32_t)(i + 1) * CLOCK_SWEEP_PERIODS_MS[0];
+  char text[16];
+  snprintf(text, sizeof(text), ":%02lu", (unsigned long)(ms / 1000 % 60));
+  clockFaceSetText(&clockSecondRow, &clockSecondSprites, text);
+  const int16_t deg = (int16_t)(ms % 60000 * 6 / 1000);
+  if (lv_arc_get_value(clockSecondArc) != deg) {
+    lv_arc_set_value(clockSecondArc, deg);
+  }
+  const float angle = (float)(ms % 60000) * (2.0f * 3.14159265f / 60000.0f);
+  const float radius = (CLOCK_ARC_SIZE - CLOCK_ARC_WIDTH) * 0.5f;
+  const lv_coord_t x = (lv_coord_t)lroundf(sinf(angle) * radius);
+  const lv_coord_t y = (lv_coord_t)lroundf(-cosf(angle) * radius) + CLOCK_ARC_Y_OFFSET;
+  if (x != lv_obj_get_style_x(clockSweepTip, LV_PART_MAIN) || y != lv_obj_get_style_y(clockSweepTip, LV_PART_MAIN)) {
+    lv_obj_align(clockSweepTip, LV_ALIGN_CENTER, x, y);
+  }
+}
+
+static const SimScenario SIM_SCENARIOS[] = {
+  {"page switch", setupHome, stepPageSwitch, 30},
+  {"carousel swipe", setupHome, stepSwipe, 32},
+  {"photo load", setupPhoto, stepPhotoLoad, 10},
+  {"clock tick", setupHome, stepClock, 60},
+  {"monitor arcs", setupMonitor, stepMonitor, 60},
+  {"clock labels", setupClockLabels, stepClockLabels, 60},
+  {"clock sprites", setupClockSprites, stepClockSprites, 60},
+  {"clock sweep", setupClockSweep, stepClockSweep, 90},
+};
+
+static void report(const char *name, bool round, const SimFrameStats &s) {
+  const uint32_t frames = s.frames ? s.frames : 1;
+  printf("%-15s %-5s %4lu frames  render %6.1f us avg %6lu max  px/frame %7.0f drawn %7.0f sent  %5.1f tx/frame\n", name,
+         round ? "round" : "rect", (unsigned long)s.frames, (double)s.render_us / frames, (unsigned long)s.render_us_max,
+         (double)s.px_rendered / frames, (double)s.px_sent / frames, (double)s.transfers / frames);
+}
+
+static const char *const SIM_CJK_LABELS[] = {
+  "北京 多云转晴 18°",
+  "明天有小雨，出门记得带伞",
+  "会议改到下午三点，三楼东侧会议室",
+  "快递已放到楼下驿站，取件码 3-2-1047",
+  "上海 阴 23°",
+  "提醒：周报请在周五下班前提交",
+  "晚上七点羽毛球，别迟到",
+  "北京 多云转晴 18°",
+  "明天有小雨，出门记得带伞",
+};
+static constexpr int SIM_CJK_LABEL_COUNT = sizeof(SIM_CJK_LABELS) / sizeof(SIM_CJK_LABELS[0]);
+
+static bool simFontRead(void *ctx, uint32_t offset, void *dst, uint32_t len) {
+  FILE *f = (FILE *)ctx;
+  return fseek(f, (long)offset, SEEK_SET) == 0 && fread(dst, 1, len, f) == len;
+}
+
+// Same chaining as loadUiTextFonts(): Montserrat first, the SD font for
+// what it lacks. Each label is shown on an otherwise empty page, so the
+// frame time is that label's.
+static void runFontBench(const char *path, uint32_t cacheBytes) {
+  FILE *file = fopen(path, "rb");
+  if (file == nullptr) {
+    fprintf(stderr, "cannot open %s\n", path);
+    return;
+  }
+  static SdFont sdFont;
+  char reason[48];
+  if (!sdFontOpen(&sdFont, SdFontReader{file, simFontRead}, cacheBytes, nullptr, reason, sizeof(reason))) {
+    fprintf(stderr, "%s: %s\n", path, reason);
+    fclose(file);
+    return;
+  }
+  static lv_font_t textFont;
+  textFont = lv_font_montserrat_16;
+  textFont.fallback = &sdFont.font;
+  printf("\n%s: %u glyphs, %u px, %u KB RAM, %u cache slots of %u B\n", path, (unsigned)(sdFont.glyphCount - 1),
+         (unsigned)sdFont.head.fontSize, (unsigned)(sdFontRamBytes(&sdFont) / 1024), (unsigned)sdFont.slotCount,
+         (unsigned)sdFont.slotBytes);
+
+  lv_obj_t *page = createBenchPage();
+  lv_obj_t *label = lv_label_create(page);
+  lv_obj_set_width(label, 280);
+  lv_label_set_long_mode(label, LV_LABEL_LONG_WRAP);
+  lv_obj_set_style_text_font(label, &textFont, LV_PART_MAIN);
+  lv_obj_center(label);
+  sim_set_round_clip(true);
+  settle();
+
+  for (int pass = 0; pass < 2; ++pass) {
+    const SdFontStats before = sdFont.stats;
+    uint64_t totalUs = 0;
+    for (int i = 0; i < SIM_CJK_LABEL_COUNT; ++i) {
+      memset(&sim_stats, 0, sizeof(sim_stats));
+      lv_label_set_text(label, SIM_CJK_LABELS[i]);
+      settle();
+      totalUs += sim_stats.render_us;
+      printf("  %-4s label %d  %7lu us  %s\n", pass == 0 ? "cold" : "warm", i, (unsigned long)sim_stats.render_us,
+             SIM_CJK_LABELS[i]);
+    }
+    const uint32_t hits = sdFont.stats.hits - before.hits;
+    const uint32_t misses = sdFont.stats.misses - before.misses;
+    printf("  %-4s total %7lu us  glyph cache %lu hits %lu misses (%.1f%% hit) %lu evictions\n", pass == 0 ? "cold" : "warm",
+           (unsigned long)totalUs, (unsigned long)hits, (unsigned long)misses,
+           (hits + misses) ? 100.0 * hits / (hits + misses) : 0.0,
+           (unsigned long)(sdFont.stats.evictions - before.evictions));
+  }
+
+  lv_obj_del(page);
+  settle();
+  sdFontClose(&sdFont);
+  fclose(file);
+}
+
+struct SimScaleCase {
+  const char *name;
+  uint16_t srcW, srcH;
+  uint16_t viewW, viewH;
+  bool cover;    // wallpapers fill the screen, photo and video fit inside
+};
+
+static const SimScaleCase SIM_SCALE_CASES[] = {
+  {"wallpaper", 240, 240, 360, 360, true},
+  {"video", 320, 240, 288, 196, false},
+  {"photo", 640, 480, 288, 202, false},
+};
+
+// Redraws img from scratch `count` times and returns the average render us.
+static double simRedrawUs(lv_obj_t *img, int count) {
+  settle();
+  memset(&sim_stats, 0, sizeof(sim_stats));
+  for (int i = 0; i < count; ++i) {
+    lv_obj_invalidate(img);
+    settle();
+  }
+  return sim_stats.frames ? (double)sim_stats.render_us / sim_stats.frames : 0.0;
+}
+
+static void runScaleBench() {
+  static constexpr int kRuns = 40;
+  printf("\n%-10s %-9s %-9s %-5s %9s %9s  %14s %14s\n", "scale", "source", "output", "zoom", "nearest", "bilinear",
+         "lvgl zoom/draw", "cached/draw");
+  lv_obj_t *page = createBenchPage();
+  lv_obj_t *img = lv_img_create(page);
+  sim_set_round_clip(true);
+  for (const SimScaleCase &sc : SIM_SCALE_CASES) {
+    std::vector<lv_color_t> pixels((size_t)sc.srcW * sc.srcH);
+    for (int y = 0; y < sc.srcH; ++y) {
+      for (int x = 0; x < sc.srcW; ++x) {
+        pixels[(size_t)y * sc.srcW + x] = lv_color_make((uint8_t)x, (uint8_t)y, (uint8_t)((x ^ y) * 3));
+      }
+    }
+    lv_img_dsc_t src;
+    memset(&src, 0, sizeof(src));
+    src.header.cf = LV_IMG_CF_TRUE_COLOR;
+    src.header.w = sc.srcW;
+    src.header.h = sc.srcH;
+    src.data_size = (uint32_t)(pixels.size() * sizeof(lv_color_t));
+    src.data = (const uint8_t *)pixels.data();
+
+    // Same zoom rules as the firmware callers.
+    const int32_t zoomW = sc.viewW * 256 / sc.srcW;
+    const int32_t zoomH = sc.viewH * 256 / sc.srcH;
+    int32_t zoom = sc.cover ? (zoomW > zoomH ? zoomW : zoomH) : (zoomW < zoomH ? zoomW : zoomH);
+    zoom = zoom < 16 ? 16 : (zoom > 512 ? 512 : zoom);
+
+    double rebuildUs[2] = {0.0, 0.0};
+    ImgTransformCache cache;
+    memset(&cache, 0, sizeof(cache));
+    const lv_img_dsc_t *shown = nullptr;
+    for (int f = 0; f < 2; ++f) {
+      cache.filter = (ImgScaleFilter)f;
+      memset(&cache.stats, 0, sizeof(cache.stats));
+      for (int i = 0; i < kRuns; ++i) {
+        shown = imgTransformGet(&cache, &src, (uint32_t)i + 1, (uint16_t)zoom, sc.viewW, sc.viewH);
+      }
+      rebuildUs[f] = cache.stats.rebuilds ? (double)cache.stats.rebuildUsTotal / cache.stats.rebuilds : 0.0;
+    }
+
+    lv_img_set_src(img, &src);
+    lv_obj_set_size(img, sc.srcW, sc.srcH);
+    lv_img_set_pivot(img, sc.srcW / 2, sc.srcH / 2);
+    lv_img_set_zoom(img, (uint16_t)zoom);
+    lv_obj_center(img);
+    const double lvglUs = simRedrawUs(img, kRuns / 4);
+    lv_img_set_src(img, shown);
+    lv_obj_set_size(img, shown->header.w, shown->header.h);
+    lv_img_set_pivot(img, shown->header.w / 2, shown->header.h / 2);
+    lv_img_set_zoom(img, LV_IMG_ZOOM_NONE);
+    lv_obj_center(img);
+    const double cachedUs = simRedrawUs(img, kRuns / 4);
+
+    char source[16];
+    char output[16];
+    snprintf(source, sizeof(source), "%ux%u", (unsigned)sc.srcW, (unsigned)sc.srcH);
+    snprintf(output, sizeof(output), "%ux%u", (unsigned)shown->header.w, (unsigned)shown->header.h);
+    printf("%-10s %-9s %-9s %-5ld %6.0f us %6.0f us  %11.0f us %11.0f us\n", sc.name, source, output, (long)zoom,
+           rebuildUs[0], rebuildUs[1], lvglUs, cachedUs);
+    lv_img_set_src(img, nullptr);
+    imgTransformFree(&cache);
+  }
+  lv_obj_del(page);
+  settle();
+}
+
+// Plays `frames` wallpaper frames into `wallpaper` and returns the average
+// render us. With a compositor, each frame goes through it as in
+// renderNextDynamicWallpaperFrame() and its compose pass is counted too.
+static double simWallpaperUs(lv_obj_t *wallpaper, LayerCompositor *comp, int frames) {
+  settle();
+  memset(&sim_stats, 0, sizeof(sim_stats));
+  uint32_t composeUs = 0;
+  for (int i = 0; i < frames; ++i) {
+    renderSimPhoto((uint32_t)i + 1);
+    if (comp == nullptr) {
+      lv_obj_invalidate(wallpaper);
+    } else {
+      comp->quiet = true;
+      lv_obj_invalidate(wallpaper);
+      comp->quiet = false;
+      const uint32_t before = comp->stats.composeUsTotal;
+      layerComposeFrame(comp, &simPhotoDsc);
+      composeUs += comp->stats.composeUsTotal - before;
+    }
+    settle();
+  }
+  const uint32_t count = sim_stats.frames ? sim_stats.frames : 1;
+  return ((double)sim_stats.render_us + composeUs) / count;
+}
+
+static void runComposeBench() {
+  static constexpr int kFrames = 30;
+  printf("\n%-10s %14s %14s %12s %12s %8s\n", "compose", "lvgl/frame", "composed", "(pass)", "rebuild",
+         "max diff");
+  sim_set_round_clip(true);
+  for (int pass = 0; pass < 2; ++pass) {
+    const bool home = (pass == 0);
+    if (home) {
+      showPage(UI_PAGE_HOME);
+      lv_img_set_src(homeWallpaperImage, &simPhotoDsc);
+    } else {
+      showSimClock(true, false);
+    }
+    lv_obj_t *wallpaper = home ? homeWallpaperImage : clockWallpaperImage;    // built by showPage()
+    lv_obj_t *page = pages[home ? UI_PAGE_HOME : UI_PAGE_CLOCK];
+
+    const double lvglUs = simWallpaperUs(wallpaper, nullptr, kFrames);
+    const std::vector<lv_color_t> reference = sim_fb;
+
+    LayerCompositor comp;
+    memset(&comp, 0, sizeof(comp));
+    layerComposeAttach(&comp, page, wallpaper);
+    const double composedUs = simWallpaperUs(wallpaper, &comp, kFrames);
+    const double passUs = comp.stats.frames ? (double)comp.stats.composeUsTotal / comp.stats.frames : 0.0;
+    const double rebuildUs = comp.stats.rebuilds ? (double)comp.stats.rebuildUsTotal / comp.stats.rebuilds : 0.0;
+    int maxDiff = 0;
+    for (size_t i = 0; i < sim_fb.size(); ++i) {
+      const uint32_t a = lv_color_to32(sim_fb[i]);
+      const uint32_t b = lv_color_to32(reference[i]);
+      for (int shift = 0; shift < 24; shift += 8) {
+        const int d = abs((int)((a >> shift) & 0xFF) - (int)((b >> shift) & 0xFF));
+        maxDiff = d > maxDiff ? d : maxDiff;
+      }
+    }
+    printf("%-10s %11.0f us %11.0f us %9.0f us %9.0f us %8d\n", home ? "home" : "clock", lvglUs, composedUs, passUs,
+           rebuildUs, maxDiff);
+
+    layerComposeFree(&comp);
+    sim_disp_drv.rounder_cb = nullptr;
+    if (home) {
+      lv_img_set_src(wallpaper, nullptr);
+    }
+    renderSimPhoto(0);
+    settle();
+  }
+}
+
+struct SimClipCase {
+  const char *name;
+  RoundClipRect area;
+};
+
+static const SimClipCase SIM_CLIP_CASES[] = {
+  {"page", {0, 0, SIM_RES - 1, SIM_RES - 1}},
+  {"status bar", {40, 8, 319, 48}},
+  {"corner icon", {20, 20, 80, 80}},    // a shortcut on the ring, upper left
+  {"corner", {0, 0, 40, 40}},
+  {"clock", {64, 64, 295, 295}},
+};
+
+// Area bands as lcd_round_refr_timer(), each rendered in draw-buffer strips
+// and flushed as my_disp_flush() does.
+static void runRoundClipBench() {
+  static constexpr int kRuns = 200;
+  printf("\n%-11s %8s %8s %8s %7s %6s %10s %10s\n", "round clip", "before", "drawn", "sent", "strips", "whole",
+         "plan/strip", "pack/strip");
+  std::vector<uint8_t> buf((size_t)SIM_RES * SIM_DRAW_BUF_ROWS * sizeof(lv_color_t));
+  for (const SimClipCase &cc : SIM_CLIP_CASES) {
+    uint32_t drawn = 0;
+    uint32_t sent = 0;
+    uint32_t strips = 0;
+    uint32_t whole = 0;
+    double planUs = 0.0;
+    double packUs = 0.0;
+    RoundClipRect areas[LCD_ROUND_AREA_MAX_BANDS];
+    const int areaCount = roundClipPlanBands(&lcd_round, &cc.area, LCD_ROUND_AREA_MAX_BANDS, LCD_ROUND_AREA_COST_PX,
+                                             LCD_ROUND_AREA_STEP, areas);
+    for (int a = 0; a < areaCount; ++a) {
+      drawn += roundClipRectSize(&areas[a]);
+      const int w = areas[a].x2 - areas[a].x1 + 1;
+      const int stripRows = SIM_RES * SIM_DRAW_BUF_ROWS / w;
+      for (int y = areas[a].y1; y <= areas[a].y2; y += stripRows) {
+        const RoundClipRect strip = {areas[a].x1, (int16_t)y, areas[a].x2,
+                                     (int16_t)((y + stripRows - 1 < areas[a].y2) ? y + stripRows - 1 : areas[a].y2)};
+        RoundClipRect bands[LCD_ROUND_FLUSH_MAX_BANDS];
+        size_t offsets[LCD_ROUND_FLUSH_MAX_BANDS];
+        int count = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < kRuns; ++r) {
+          count = roundClipPlanBands(&lcd_round, &strip, LCD_ROUND_FLUSH_MAX_BANDS, LCD_ROUND_FLUSH_COST_PX, 1, bands);
+        }
+        planUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / kRuns;
+        bool packed = true;
+        t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < kRuns && count > 0; ++r) {
+          packed = roundClipPackBands(buf.data(), sizeof(lv_color_t), &strip, bands, count, LCD_ROUND_FLUSH_ALIGN,
+                                      offsets);
+        }
+        packUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / kRuns;
+        strips++;
+        if (!packed) {
+          whole++;
+          sent += roundClipRectSize(&strip);
+        } else {
+          for (int i = 0; i < count; ++i) {
+            sent += roundClipRectSize(&bands[i]);
+          }
+        }
+      }
+    }
+    const uint32_t n = strips ? strips : 1;
+    printf("%-11s %8lu %8lu %8lu %7lu %6lu %7.1f us %7.1f us\n", cc.name, (unsigned long)roundClipRectSize(&cc.area),
+           (unsigned long)drawn, (unsigned long)sent, (unsigned long)strips, (unsigned long)whole, planUs / n,
+           packUs / n);
+  }
+}
+
+struct SimSpectrumCase {
+  const char *name;
+  uint32_t rateHz;
+  float toneHz;    // 0: noise
+  float level;     // peak, fraction of full scale
+};
+
+static const SimSpectrumCase SIM_SPECTRUM_CASES[] = {
+  {"tone 1k", 44100, 1000.0f, 0.5f},
+  {"tone 12k", 44100, 12000.0f, 0.9f},
+  {"noise", 44100, 0.0f, 0.5f},
+  {"quiet 440", 44100, 440.0f, 0.01f},
+  {"tts 16k", 16000, 300.0f, 0.3f},
+};
+
+static void runSpectrumBench() {
+  static constexpr int kRuns = 2000;
+  static constexpr uint32_t kIntervalMs = 33;    // SPECTRUM_INTERVAL_MS
+  printf("\n%-10s %10s %10s %10s %11s %6s\n", "spectrum", "fft", "process", "(% 33ms)", "fft err lsb", "band");
+  static SpectrumAnalyzer an;
+  spectrumAnalyzerInit(&an);
+  int16_t samples[SPECTRUM_FFT_SIZE];
+  uint32_t rng = 1;
+  uint32_t sink = 0;
+  for (const SimSpectrumCase &sc : SIM_SPECTRUM_CASES) {
+    for (int i = 0; i < SPECTRUM_FFT_SIZE; ++i) {
+      float v;
+      if (sc.toneHz > 0.0f) {
+        v = sinf(2.0f * 3.14159265f * sc.toneHz * i / sc.rateHz);
+      } else {
+        rng = rng * 1664525U + 1013904223U;
+        v = (float)(int32_t)(rng >> 16) / 32768.0f - 1.0f;
+      }
+      samples[i] = spectrumQ15(v * sc.level);
+    }
+    for (int r = 0; r < kRuns / 10; ++r) {    // warm-up, also sets the band edges
+      spectrumAnalyzerProcess(&an, samples, sc.rateHz);
+    }
+
+    // Error against a double DFT of the same windowed Q15 input, X[k] / N.
+    int16_t inRe[SPECTRUM_FFT_SIZE];
+    for (int i = 0; i < SPECTRUM_FFT_SIZE; ++i) {
+      inRe[i] = (int16_t)(((int32_t)samples[i] * an.window[i]) >> 15);
+      an.re[i] = inRe[i];
+      an.im[i] = 0;
+    }
+    spectrumFft(&an);
+    double maxErr = 0.0;
+    double peakPower = -1.0;
+    int peakBin = 0;
+    for (int k = 0; k <= SPECTRUM_FFT_SIZE / 2; ++k) {
+      double re = 0.0;
+      double im = 0.0;
+      for (int i = 0; i < SPECTRUM_FFT_SIZE; ++i) {
+        const double a = -2.0 * 3.14159265358979 * k * i / SPECTRUM_FFT_SIZE;
+        re += inRe[i] * cos(a);
+        im += inRe[i] * sin(a);
+      }
+      re /= SPECTRUM_FFT_SIZE;
+      im /= SPECTRUM_FFT_SIZE;
+      maxErr = fmax(maxErr, fmax(fabs(re - an.re[k]), fabs(im - an.im[k])));
+      if (re * re + im * im > peakPower) {
+        peakPower = re * re + im * im;
+        peakBin = k;
+      }
+    }
+    int band = 0;
+    while (band < SPECTRUM_BANDS - 1 && peakBin >= an.bandEdge[band + 1]) {
+      band++;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRuns; ++r) {
+      for (int i = 0; i < SPECTRUM_FFT_SIZE; ++i) {
+        an.re[i] = inRe[i];
+        an.im[i] = 0;
+      }
+      spectrumFft(&an);
+      sink += (uint16_t)an.re[r & (SPECTRUM_FFT_SIZE - 1)];
+    }
+    const double fftUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / kRuns;
+    t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < kRuns; ++r) {
+      spectrumAnalyzerProcess(&an, samples, sc.rateHz);
+      sink += an.frame.bands[r % SPECTRUM_BANDS];
+    }
+    const double processUs =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / kRuns;
+    printf("%-10s %7.1f us %7.1f us %9.3f%% %11.1f %6d\n", sc.name, fftUs, processUs,
+           processUs * 100.0 / (kIntervalMs * 1000.0), maxErr, sc.toneHz > 0.0f ? band : -1);
+  }
+  if (sink == 0xFFFFFFFFu) {
+    printf("\n");
+  }
+}
+
+int main(int argc, char **argv) {
+  const char *dumpDir = nullptr;
+  const char *fontPath = nullptr;
+  uint32_t fontCacheBytes = 48 * 1024;    // UI_FONT_CACHE_BYTES
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], "--dump") == 0 && i + 1 < argc) {
+      dumpDir = argv[++i];
+    } else if (strcmp(argv[i], "--font") == 0 && i + 1 < argc) {
+      fontPath = argv[++i];
+    } else if (strcmp(argv[i], "--font-cache") == 0 && i + 1 < argc) {
+      fontCacheBytes = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    }
+  }
+
+  printf("native-sim: firmware pages, stand-in data; compare paths, not absolute numbers\n\n");
+  lv_init();
+  sim_display_init();
+  renderSimPhoto(0);
+  createUi();
+
+  for (const SimScenario &sc : SIM_SCENARIOS) {
+    for (int pass = 0; pass < 2; ++pass) {
+      const bool round = (pass == 0);
+      sim_set_round_clip(round);
+      sc.setup();
+      lv_obj_invalidate(lv_scr_act());
+      settle();
+      memset(&sim_stats, 0, sizeof(sim_stats));
+      for (int i = 0; i < sc.steps; ++i) {
+        sc.step(i);
+        settle();
+      }
+      report(sc.name, round, sim_stats);
+      if (dumpDir != nullptr && round) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s/%s.ppm", dumpDir, sc.name);
+        for (char *p = path + strlen(dumpDir) + 1; *p; ++p) {
+          if (*p == ' ') {
+            *p = '_';
+          }
+        }
+        if (!sim_dump_ppm(path)) {
+          fprintf(stderr, "cannot write %s\n", path);
+        }
+      }
+    }
+  }
+
+  runScaleBench();
+  runComposeBench();
+  runRoundClipBench();
+  runSpectrumBench();
+  if (fontPath != nullptr) {
+    runFontBench(fontPath, fontCacheBytes);
+  }
+  return 0;
+}
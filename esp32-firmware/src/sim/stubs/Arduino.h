@@ -0,0 +1,58 @@
+#ifndef _SIM_STUB_ARDUINO_H_
+#define _SIM_STUB_ARDUINO_H_
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+#include <string>
+#include "sim/sim_clock.h"
+
+// Just enough of the Arduino core for ui/ui_pages.h on the host
+// (env:native-sim): String, Serial and the clocks. millis() is the
+// simulator's virtual clock, the one LVGL ticks on; micros() is the host
+// clock, so build times come out real. Serial goes to stderr, out of the
+// way of the benchmark tables.
+class String {
+public:
+  String(const char *text = "") : s_(text != nullptr ? text : "") {}
+  String(const std::string &text) : s_(text) {}
+
+  unsigned int length() const { return (unsigned int)s_.size(); }
+  const char *c_str() const { return s_.c_str(); }
+
+  String operator+(const String &rhs) const { return String(s_ + rhs.s_); }
+  String operator+(const char *rhs) const { return String(s_ + (rhs != nullptr ? rhs : "")); }
+  String operator+(int rhs) const { return String(s_ + std::to_string(rhs)); }
+  bool operator==(const String &rhs) const { return s_ == rhs.s_; }
+
+private:
+  std::string s_;
+};
+
+class SimSerial {
+public:
+  int printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+    va_list args;
+    va_start(args, fmt);
+    const int n = vfprintf(stderr, fmt, args);
+    va_end(args);
+    return n;
+  }
+  void println(const char *text) { fprintf(stderr, "%s\n", text); }
+  void println(const String &text) { println(text.c_str()); }
+};
+
+static SimSerial Serial;
+
+static inline uint32_t millis() {
+  return sim_millis();
+}
+
+static inline uint32_t micros() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+#endif
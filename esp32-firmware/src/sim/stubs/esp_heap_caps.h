@@ -0,0 +1,36 @@
+#ifndef _SIM_STUB_ESP_HEAP_CAPS_H_
+#define _SIM_STUB_ESP_HEAP_CAPS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// Host stand-in for the ESP-IDF heap API used by ui/ui_pages.h. Every
+// capability maps to the one host heap, which LVGL also allocates from in
+// the simulator (lv_conf.h). With glibc the free size is derived from what
+// is in use, so the per-page build figures still add up; elsewhere it is 0.
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+static constexpr size_t SIM_HEAP_BYTES = 8u * 1024u * 1024u;
+
+static inline void *heap_caps_malloc(size_t size, uint32_t caps) {
+  (void)caps;
+  return malloc(size);
+}
+
+static inline size_t heap_caps_get_free_size(uint32_t caps) {
+  (void)caps;
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  const size_t used = mallinfo2().uordblks;
+  return used < SIM_HEAP_BYTES ? SIM_HEAP_BYTES - used : 0;
+#else
+  return 0;
+#endif
+}
+
+#endif
@@ -0,0 +1,1999 @@
+#ifndef _UI_PAGES_H_
+#define _UI_PAGES_H_
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <lvgl.h>
+#include <math.h>
+#include <stdint.h>
+#include "display/clock_face.h"
+#include "ui/ui_widgets.h"
+
+// The page layer: touch gestures, page switching, the home carousel, the
+// page builders and the build/sync/release registry. It creates and lays out
+// widgets and nothing else; what the pages show and what their buttons do
+// goes through the firmware functions declared below. main.cpp defines them;
+// the native-sim build links the same pages against stand-ins
+// (sim/sim_firmware.h), so nothing here may reach SD_MMC, the WebSocket,
+// I2S or Preferences directly.
+//
+// Included once, into the translation unit that defines those functions and
+// the state the builders read: screenBrightness, pomodoroMode,
+// currentWeather and voiceMicStreaming.
+
+// Event and timer callbacks the widgets are wired to.
+static void clockPageClickCallback(lv_event_t *e);
+static void brightnessSliderEventCallback(lv_event_t *e);
+static void settingsActionEventCallback(lv_event_t *e);
+static void inboxActionEventCallback(lv_event_t *e);
+static void pomodoroControlCallback(lv_event_t *e);
+static void appLauncherPageCallback(lv_event_t *e);
+static void photoFrameControlCallback(lv_event_t *e);
+static void audioSeekSliderCallback(lv_event_t *e);
+static void audioControlCallback(lv_event_t *e);
+static void videoControlCallback(lv_event_t *e);
+static void voiceCommandButtonCallback(lv_event_t *e);
+static void voiceMicToggleCallback(lv_event_t *e);
+static void clockTimerCallback(lv_timer_t *timer);
+static void clockSweepTimerCallback(lv_timer_t *timer);
+static void diagnosticsTimerCallback(lv_timer_t *timer);
+static void pomodoroTimerCallback(lv_timer_t *timer);
+static void weatherTimerCallback(lv_timer_t *timer);
+
+// Fonts, labels and the updaters that bring a page up to date when shown.
+static const lv_font_t *uiTextFont(uint8_t size);
+static const char *getPomodoroModeText(PomodoroMode mode);
+static uint32_t getPomodoroColor(PomodoroMode mode);
+static void updateClockDisplay();
+static void setStats(float cpu, float memory, float upload, float download);
+static void setWifiStatus(const String &text);
+static void setWsStatus(const String &text);
+static void setActionStatus(const String &text);
+static void applyBrightness(uint8_t brightness, bool persist);
+static void updateDiagnosticStatus();
+static void refreshInboxView();
+static void updatePomodoroDisplay();
+static void updateWeatherDisplay();
+static void updateAppLauncherDisplay();
+static void updatePhotoFrameNavButtons();
+static void refreshAudioTimeLabel(bool force);
+static void updateAudioControlButtons(bool hasTracks, bool canStepTrack);
+static void updateVideoControlButtons(bool hasTracks);
+static void setSpectrumVisible(bool visible);
+static void pauseDynamicWallpapersForMs(uint32_t durationMs);
+
+// Page transitions. showPage() calls pageLeaving() before it switches and
+// pageEntered() once the new page is built and synced; the release hooks of
+// the photo and video pages hand their media buffers back through
+// releasePhotoFrameMedia() and releaseVideoPlayerMedia().
+static void pageLeaving(int previousPage, int nextPage);
+static void pageEntered(int previousPage, int page);
+static void releasePhotoFrameMedia();
+static void releaseVideoPlayerMedia();
+
+static void ensurePageBuilt(int pageIndex);
+static void releasePage(int pageIndex);
+static void syncPage(int pageIndex);
+static void refreshHomeShortcutSlots();
+static void gestureEventCallback(lv_event_t *e);
+
+static bool shouldSuppressClick() {
+  return (int32_t)(millis() - suppressClickUntilMs) < 0;
+}
+
+static void suppressClicksForMs(uint32_t durationMs) {
+  suppressClickUntilMs = millis() + durationMs;
+}
+
+static bool getActiveTouchPoint(lv_point_t *point) {
+  if (point == nullptr) {
+    return false;
+  }
+  lv_indev_t *indev = lv_indev_get_act();
+  if (indev == nullptr) {
+    return false;
+  }
+  lv_indev_get_point(indev, point);
+  return true;
+}
+
+static void suppressClicksAfterHome() {
+  suppressClicksForMs(CLICK_SUPPRESS_MS_AFTER_HOME);
+}
+
+static void updatePageIndicator() {
+  if (pageIndicatorLabel != nullptr) {
+    lv_obj_add_flag(pageIndicatorLabel, LV_OBJ_FLAG_HIDDEN);
+  }
+}
+
+static void showPage(int pageIndex) {
+  if (pageIndex < 0) {
+    pageIndex += UI_PAGE_COUNT;
+  }
+  if (pageIndex >= UI_PAGE_COUNT) {
+    pageIndex %= UI_PAGE_COUNT;
+  }
+
+  int previousPage = currentPage;
+  pageLeaving(previousPage, pageIndex);
+
+  currentPage = pageIndex;
+  ensurePageBuilt(currentPage);
+  for (int i = 0; i < UI_PAGE_COUNT; ++i) {
+    if (pages[i] == nullptr) {
+      continue;
+    }
+    if (i == currentPage) {
+      lv_obj_clear_flag(pages[i], LV_OBJ_FLAG_HIDDEN);
+    } else {
+      lv_obj_add_flag(pages[i], LV_OBJ_FLAG_HIDDEN);
+    }
+  }
+  if (previousPage != currentPage) {
+    releasePage(previousPage);
+  }
+  syncPage(currentPage);
+  if (currentPage == UI_PAGE_HOME) {
+    refreshHomeShortcutSlots();
+  }
+  pageEntered(previousPage, currentPage);
+  updatePageIndicator();
+}
+
+static int wrapHomeShortcutIndex(int index) {
+  if (HOME_SHORTCUT_COUNT <= 0) {
+    return -1;
+  }
+
+  int wrapped = index % (int)HOME_SHORTCUT_COUNT;
+  if (wrapped < 0) {
+    wrapped += HOME_SHORTCUT_COUNT;
+  }
+  return wrapped;
+}
+
+static void renderHomeShortcutIcon(uint8_t slotIdx, const HomeShortcutConfig &item) {
+  if (slotIdx >= HOME_VISIBLE_SLOT_COUNT) {
+    return;
+  }
+
+  lv_obj_t *root = homeShortcutIcons[slotIdx];
+  if (root == nullptr) {
+    return;
+  }
+
+  lv_obj_clean(root);
+  lv_obj_set_style_bg_opa(root, LV_OPA_TRANSP, LV_PART_MAIN);
+
+  const lv_color_t fg = lv_color_hex(0xF5EEFF);
+
+  if (item.iconKind == HOME_ICON_SYMBOL) {
+    lv_obj_t *label = lv_label_create(root);
+    lv_label_set_text(label, item.icon);
+    lv_obj_set_style_text_color(label, fg, LV_PART_MAIN);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_22, LV_PART_MAIN);
+    lv_obj_center(label);
+    return;
+  }
+
+  if (item.iconKind == HOME_ICON_MONITOR) {
+    lv_obj_t *screen = lv_obj_create(root);
+    lv_obj_remove_style_all(screen);
+    lv_obj_set_size(screen, 24, 16);
+    lv_obj_align(screen, LV_ALIGN_CENTER, 0, -4);
+    lv_obj_set_style_radius(screen, 3, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(screen, LV_OPA_20, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(screen, fg, LV_PART_MAIN);
+    lv_obj_set_style_border_width(screen, 2, LV_PART_MAIN);
+    lv_obj_set_style_border_color(screen, fg, LV_PART_MAIN);
+
+    lv_obj_t *stem = lv_obj_create(root);
+    lv_obj_remove_style_all(stem);
+    lv_obj_set_size(stem, 4, 5);
+    lv_obj_align(stem, LV_ALIGN_CENTER, 0, 7);
+    lv_obj_set_style_bg_opa(stem, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(stem, fg, LV_PART_MAIN);
+    lv_obj_set_style_radius(stem, 1, LV_PART_MAIN);
+
+    lv_obj_t *base = lv_obj_create(root);
+    lv_obj_remove_style_all(base);
+    lv_obj_set_size(base, 16, 2);
+    lv_obj_align(base, LV_ALIGN_CENTER, 0, 11);
+    lv_obj_set_style_bg_opa(base, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(base, fg, LV_PART_MAIN);
+    lv_obj_set_style_radius(base, 1, LV_PART_MAIN);
+    return;
+  }
+
+  if (item.iconKind == HOME_ICON_POMODORO) {
+    lv_obj_t *fruit = lv_obj_create(root);
+    lv_obj_remove_style_all(fruit);
+    lv_obj_set_size(fruit, 22, 22);
+    lv_obj_align(fruit, LV_ALIGN_CENTER, 0, 2);
+    lv_obj_set_style_radius(fruit, 11, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(fruit, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(fruit, lv_color_hex(0xFF5252), LV_PART_MAIN);
+    lv_obj_set_style_border_width(fruit, 1, LV_PART_MAIN);
+    lv_obj_set_style_border_color(fruit, lv_color_hex(0xFFCDD2), LV_PART_MAIN);
+
+    lv_obj_t *leafL = lv_obj_create(root);
+    lv_obj_remove_style_all(leafL);
+    lv_obj_set_size(leafL, 7, 3);
+    lv_obj_align(leafL, LV_ALIGN_CENTER, -4, -9);
+    lv_obj_set_style_radius(leafL, 2, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(leafL, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(leafL, lv_color_hex(0x66BB6A), LV_PART_MAIN);
+
+    lv_obj_t *leafR = lv_obj_create(root);
+    lv_obj_remove_style_all(leafR);
+    lv_obj_set_size(leafR, 7, 3);
+    lv_obj_align(leafR, LV_ALIGN_CENTER, 4, -9);
+    lv_obj_set_style_radius(leafR, 2, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(leafR, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(leafR, lv_color_hex(0x66BB6A), LV_PART_MAIN);
+
+    lv_obj_t *stem = lv_obj_create(root);
+    lv_obj_remove_style_all(stem);
+    lv_obj_set_size(stem, 2, 4);
+    lv_obj_align(stem, LV_ALIGN_CENTER, 0, -11);
+    lv_obj_set_style_radius(stem, 1, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(stem, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(stem, lv_color_hex(0xA5D6A7), LV_PART_MAIN);
+    return;
+  }
+
+  if (item.iconKind == HOME_ICON_CLOCK) {
+    lv_obj_t *dial = lv_obj_create(root);
+    lv_obj_remove_style_all(dial);
+    lv_obj_set_size(dial, 24, 24);
+    lv_obj_align(dial, LV_ALIGN_CENTER, 0, 0);
+    lv_obj_set_style_radius(dial, 12, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(dial, LV_OPA_10, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(dial, fg, LV_PART_MAIN);
+    lv_obj_set_style_border_width(dial, 2, LV_PART_MAIN);
+    lv_obj_set_style_border_color(dial, fg, LV_PART_MAIN);
+
+    lv_obj_t *hourHand = lv_obj_create(root);
+    lv_obj_remove_style_all(hourHand);
+    lv_obj_set_size(hourHand, 7, 2);
+    lv_obj_align(hourHand, LV_ALIGN_CENTER, 2, 1);
+    lv_obj_set_style_radius(hourHand, 1, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(hourHand, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(hourHand, fg, LV_PART_MAIN);
+
+    lv_obj_t *minuteHand = lv_obj_create(root);
+    lv_obj_remove_style_all(minuteHand);
+    lv_obj_set_size(minuteHand, 2, 8);
+    lv_obj_align(minuteHand, LV_ALIGN_CENTER, 0, -3);
+    lv_obj_set_style_radius(minuteHand, 1, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(minuteHand, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(minuteHand, fg, LV_PART_MAIN);
+
+    lv_obj_t *centerDot = lv_obj_create(root);
+    lv_obj_remove_style_all(centerDot);
+    lv_obj_set_size(centerDot, 4, 4);
+    lv_obj_align(centerDot, LV_ALIGN_CENTER, 0, 1);
+    lv_obj_set_style_radius(centerDot, 2, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(centerDot, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(centerDot, fg, LV_PART_MAIN);
+    return;
+  }
+
+  if (item.iconKind == HOME_ICON_WEATHER) {
+    lv_obj_t *sun = lv_obj_create(root);
+    lv_obj_remove_style_all(sun);
+    lv_obj_set_size(sun, 11, 11);
+    lv_obj_align(sun, LV_ALIGN_CENTER, 7, -8);
+    lv_obj_set_style_radius(sun, 6, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(sun, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(sun, lv_color_hex(0xFFD54F), LV_PART_MAIN);
+
+    lv_obj_t *cloud1 = lv_obj_create(root);
+    lv_obj_remove_style_all(cloud1);
+    lv_obj_set_size(cloud1, 11, 11);
+    lv_obj_align(cloud1, LV_ALIGN_CENTER, -6, 1);
+    lv_obj_set_style_radius(cloud1, 6, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(cloud1, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(cloud1, fg, LV_PART_MAIN);
+
+    lv_obj_t *cloud2 = lv_obj_create(root);
+    lv_obj_remove_style_all(cloud2);
+    lv_obj_set_size(cloud2, 13, 13);
+    lv_obj_align(cloud2, LV_ALIGN_CENTER, 1, -1);
+    lv_obj_set_style_radius(cloud2, 7, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(cloud2, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(cloud2, fg, LV_PART_MAIN);
+
+    lv_obj_t *cloud3 = lv_obj_create(root);
+    lv_obj_remove_style_all(cloud3);
+    lv_obj_set_size(cloud3, 11, 11);
+    lv_obj_align(cloud3, LV_ALIGN_CENTER, 9, 2);
+    lv_obj_set_style_radius(cloud3, 6, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(cloud3, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(cloud3, fg, LV_PART_MAIN);
+
+    lv_obj_t *cloudBase = lv_obj_create(root);
+    lv_obj_remove_style_all(cloudBase);
+    lv_obj_set_size(cloudBase, 24, 8);
+    lv_obj_align(cloudBase, LV_ALIGN_CENTER, 1, 5);
+    lv_obj_set_style_radius(cloudBase, 4, LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(cloudBase, LV_OPA_COVER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(cloudBase, fg, LV_PART_MAIN);
+    return;
+  }
+
+  if (item.iconKind == HOME_ICON_APPS) {
+    static const lv_point_t line1[] = {{0, 14}, {14, 0}};
+    static const lv_point_t line2[] = {{0, 18}, {18, 0}};
+    static const lv_point_t line3[] = {{0, 22}, {22, 0}};
+
+    lv_obj_t *l1 = lv_line_create(root);
+    lv_line_set_points(l1, line1, 2);
+    lv_obj_set_size(l1, 16, 16);
+    lv_obj_align(l1, LV_ALIGN_CENTER, -4, -6);
+    lv_obj_set_style_line_color(l1, fg, LV_PART_MAIN);
+    lv_obj_set_style_line_width(l1, 2, LV_PART_MAIN);
+    lv_obj_set_style_line_rounded(l1, true, LV_PART_MAIN);
+
+    lv_obj_t *l2 = lv_line_create(root);
+    lv_line_set_points(l2, line2, 2);
+    lv_obj_set_size(l2, 20, 20);
+    lv_obj_align(l2, LV_ALIGN_CENTER, -1, -2);
+    lv_obj_set_style_line_color(l2, fg, LV_PART_MAIN);
+    lv_obj_set_style_line_width(l2, 2, LV_PART_MAIN);
+    lv_obj_set_style_line_rounded(l2, true, LV_PART_MAIN);
+
+    lv_obj_t *l3 = lv_line_create(root);
+    lv_line_set_points(l3, line3, 2);
+    lv_obj_set_size(l3, 24, 24);
+    lv_obj_align(l3, LV_ALIGN_CENTER, 2, 2);
+    lv_obj_set_style_line_color(l3, fg, LV_PART_MAIN);
+    lv_obj_set_style_line_width(l3, 2, LV_PART_MAIN);
+    lv_obj_set_style_line_rounded(l3, true, LV_PART_MAIN);
+    return;
+  }
+
+  lv_obj_t *fallback = lv_label_create(root);
+  lv_label_set_text(fallback, item.icon);
+  lv_obj_set_style_text_color(fallback, fg, LV_PART_MAIN);
+  lv_obj_set_style_text_font(fallback, &lv_font_montserrat_22, LV_PART_MAIN);
+  lv_obj_center(fallback);
+}
+
+static void refreshHomeShortcutSlots() {
+  uint8_t visible = HOME_VISIBLE_SLOT_COUNT;
+  if (visible > HOME_SHORTCUT_COUNT) {
+    visible = HOME_SHORTCUT_COUNT;
+  }
+
+  for (uint8_t i = 0; i < HOME_VISIBLE_SLOT_COUNT; ++i) {
+    if (homeShortcutSlots[i] == nullptr || homeShortcutButtons[i] == nullptr || homeShortcutIcons[i] == nullptr) {
+      continue;
+    }
+
+    if (i < visible) {
+      int shortcutIdx = wrapHomeShortcutIndex(homeCarouselOffset + i);
+      if (shortcutIdx < 0) {
+        lv_obj_add_flag(homeShortcutSlots[i], LV_OBJ_FLAG_HIDDEN);
+        homeSlotToShortcut[i] = -1;
+        continue;
+      }
+
+      const HomeShortcutConfig &item = HOME_SHORTCUTS[shortcutIdx];
+      homeSlotToShortcut[i] = (int8_t)shortcutIdx;
+      lv_obj_clear_flag(homeShortcutSlots[i], LV_OBJ_FLAG_HIDDEN);
+      lv_obj_set_style_bg_color(homeShortcutButtons[i], lv_color_hex(item.accentColor), LV_PART_MAIN);
+      lv_obj_set_style_shadow_color(homeShortcutButtons[i], lv_color_hex(item.accentColor), LV_PART_MAIN);
+      renderHomeShortcutIcon(i, item);
+
+      bool isFocused = (i == 0);
+      lv_obj_set_style_border_width(homeShortcutButtons[i], isFocused ? 2 : 1, LV_PART_MAIN);
+      lv_obj_set_style_border_color(homeShortcutButtons[i], isFocused ? lv_color_hex(0xF3E5FF) : lv_color_hex(0xD1C4E9), LV_PART_MAIN);
+      lv_obj_set_style_shadow_width(homeShortcutButtons[i], isFocused ? 18 : 12, LV_PART_MAIN);
+    } else {
+      homeSlotToShortcut[i] = -1;
+      lv_obj_add_flag(homeShortcutSlots[i], LV_OBJ_FLAG_HIDDEN);
+    }
+  }
+
+  if (homeCurrentShortcutLabel != nullptr) {
+    int idx = homeSlotToShortcut[0];
+    if (idx >= 0 && idx < HOME_SHORTCUT_COUNT) {
+      lv_label_set_text_fmt(homeCurrentShortcutLabel, "%s  (%d/%d)", HOME_SHORTCUTS[idx].label, idx + 1, HOME_SHORTCUT_COUNT);
+    } else {
+      lv_label_set_text(homeCurrentShortcutLabel, "--");
+    }
+  }
+}
+
+static void shiftHomeCarousel(int delta) {
+  if (HOME_SHORTCUT_COUNT <= 1) {
+    return;
+  }
+
+  homeCarouselOffset = wrapHomeShortcutIndex(homeCarouselOffset + delta);
+  refreshHomeShortcutSlots();
+}
+
+static void homeShortcutEventCallback(lv_event_t *e) {
+  if (lv_event_get_code(e) != LV_EVENT_CLICKED) {
+    return;
+  }
+  if (shouldSuppressClick()) {
+    return;
+  }
+
+  intptr_t slotRaw = (intptr_t)lv_event_get_user_data(e);
+  if (slotRaw < 0 || slotRaw >= HOME_VISIBLE_SLOT_COUNT) {
+    return;
+  }
+
+  int shortcutIdx = homeSlotToShortcut[slotRaw];
+  if (shortcutIdx < 0 || shortcutIdx >= HOME_SHORTCUT_COUNT) {
+    return;
+  }
+
+  UiPage page = HOME_SHORTCUTS[shortcutIdx].page;
+  if (page >= 0 && page < UI_PAGE_COUNT) {
+    showPage((int)page);
+  }
+}
+
+static void layoutHomeShortcuts() {
+  lv_disp_t *disp = lv_disp_get_default();
+  if (disp == nullptr) {
+    return;
+  }
+
+  int16_t cx = lv_disp_get_hor_res(disp) / 2;
+  int16_t cy = lv_disp_get_ver_res(disp) / 2 + 4;
+  uint8_t visible = HOME_VISIBLE_SLOT_COUNT;
+  if (visible > HOME_SHORTCUT_COUNT) {
+    visible = HOME_SHORTCUT_COUNT;
+  }
+
+  for (uint8_t i = 0; i < HOME_VISIBLE_SLOT_COUNT; ++i) {
+    if (homeShortcutSlots[i] == nullptr || homeShortcutButtons[i] == nullptr || homeShortcutIcons[i] == nullptr) {
+      continue;
+    }
+
+    if (i >= visible) {
+      homeSlotToShortcut[i] = -1;
+      lv_obj_add_flag(homeShortcutSlots[i], LV_OBJ_FLAG_HIDDEN);
+      continue;
+    }
+
+    float angleDeg = -90.0f + (360.0f * (float)i / (float)visible);
+    float rad = angleDeg * HOME_DEG_TO_RAD;
+    int16_t slotSize = 64;
+    int16_t buttonSize = 52;
+    int16_t radius = 124;
+    int16_t x = cx + (int16_t)lroundf(cosf(rad) * radius) - slotSize / 2;
+    int16_t y = cy + (int16_t)lroundf(sinf(rad) * radius) - slotSize / 2;
+
+    lv_obj_clear_flag(homeShortcutSlots[i], LV_OBJ_FLAG_HIDDEN);
+    lv_obj_set_size(homeShortcutSlots[i], slotSize, slotSize);
+    lv_obj_set_pos(homeShortcutSlots[i], x, y);
+    lv_obj_set_size(homeShortcutButtons[i], buttonSize, buttonSize);
+    lv_obj_set_style_radius(homeShortcutButtons[i], buttonSize / 2, LV_PART_MAIN);
+    lv_obj_align(homeShortcutButtons[i], LV_ALIGN_CENTER, 0, 0);
+  }
+
+  refreshHomeShortcutSlots();
+}
+
+static void attachGestureHandlers(lv_obj_t *obj) {
+  if (obj == nullptr) {
+    return;
+  }
+
+  lv_obj_add_event_cb(obj, gestureEventCallback, LV_EVENT_PRESSED, nullptr);
+  lv_obj_add_event_cb(obj, gestureEventCallback, LV_EVENT_PRESSING, nullptr);
+  lv_obj_add_event_cb(obj, gestureEventCallback, LV_EVENT_RELEASED, nullptr);
+  lv_obj_add_event_cb(obj, gestureEventCallback, LV_EVENT_PRESS_LOST, nullptr);
+}
+
+static lv_obj_t *createBasePage() {
+  lv_obj_t *page = lv_obj_create(lv_scr_act());
+  lv_obj_remove_style_all(page);
+  lv_obj_set_size(page, lv_pct(100), lv_pct(100));
+  lv_obj_set_style_bg_opa(page, LV_OPA_TRANSP, LV_PART_MAIN);
+  lv_obj_clear_flag(page, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(page, LV_OBJ_FLAG_CLICKABLE);
+  attachGestureHandlers(page);
+  return page;
+}
+
+static lv_obj_t *createInboxButton(lv_obj_t *parent, const char *text, lv_coord_t x, lv_coord_t y, lv_coord_t w, InboxAction action) {
+  lv_obj_t *btn = lv_btn_create(parent);
+  lv_obj_set_size(btn, w, 34);
+  lv_obj_align(btn, LV_ALIGN_TOP_LEFT, x, y);
+  lv_obj_set_style_radius(btn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(btn, lv_color_hex(0x1E1E1E), LV_PART_MAIN);
+  lv_obj_set_style_bg_color(btn, lv_color_hex(0x2E2E2E), LV_PART_MAIN | LV_STATE_PRESSED);
+  lv_obj_set_style_border_color(btn, lv_color_hex(0x3A3A3A), LV_PART_MAIN);
+  lv_obj_set_style_border_width(btn, 1, LV_PART_MAIN);
+  lv_obj_add_flag(btn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
+  attachGestureHandlers(btn);
+  lv_obj_add_event_cb(btn, inboxActionEventCallback, LV_EVENT_CLICKED, (void *)((intptr_t)action));
+
+  lv_obj_t *label = lv_label_create(btn);
+  lv_label_set_text(label, text);
+  lv_obj_center(label);
+  return btn;
+}
+
+static lv_obj_t *createSettingsButton(lv_obj_t *parent, const char *text, lv_coord_t x, lv_coord_t y, SettingsAction action) {
+  lv_obj_t *btn = lv_btn_create(parent);
+  lv_obj_set_size(btn, 136, 40);
+  lv_obj_align(btn, LV_ALIGN_TOP_LEFT, x, y);
+  lv_obj_set_style_radius(btn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(btn, lv_color_hex(0x1F1F1F), LV_PART_MAIN);
+  lv_obj_set_style_bg_color(btn, lv_color_hex(0x2B2B2B), LV_PART_MAIN | LV_STATE_PRESSED);
+  lv_obj_set_style_border_color(btn, lv_color_hex(0x3A3A3A), LV_PART_MAIN);
+  lv_obj_set_style_border_width(btn, 1, LV_PART_MAIN);
+  lv_obj_add_flag(btn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
+  attachGestureHandlers(btn);
+  lv_obj_add_event_cb(btn, settingsActionEventCallback, LV_EVENT_CLICKED, (void *)((intptr_t)action));
+
+  lv_obj_t *label = lv_label_create(btn);
+  lv_label_set_text(label, text);
+  lv_obj_center(label);
+  return btn;
+}
+
+static void gestureEventCallback(lv_event_t *e) {
+  lv_event_code_t code = lv_event_get_code(e);
+
+  if (code == LV_EVENT_PRESSED) {
+    pauseDynamicWallpapersForMs(DYNAMIC_WALLPAPER_TOUCH_PAUSE_MS);
+    gestureState.pressed = true;
+    gestureState.longPressHandled = false;
+    gestureState.startMs = millis();
+    lv_point_t start = {0, 0};
+    if (getActiveTouchPoint(&start)) {
+      gestureState.startPoint = start;
+    } else {
+      gestureState.startPoint = lv_point_t{0, 0};
+    }
+    return;
+  }
+
+  if (code == LV_EVENT_PRESSING) {
+    pauseDynamicWallpapersForMs(DYNAMIC_WALLPAPER_TOUCH_PAUSE_MS);
+    if (!gestureState.pressed || gestureState.longPressHandled) {
+      return;
+    }
+
+    if ((millis() - gestureState.startMs) < LONG_PRESS_MS) {
+      return;
+    }
+
+    gestureState.longPressHandled = true;
+    if (currentPage != UI_PAGE_HOME) {
+      showPage(UI_PAGE_HOME);
+      suppressClicksAfterHome();
+    }
+    return;
+  }
+
+  if (code == LV_EVENT_RELEASED) {
+    pauseDynamicWallpapersForMs(DYNAMIC_WALLPAPER_TOUCH_PAUSE_MS);
+    if (!gestureState.pressed) {
+      return;
+    }
+
+    if (!gestureState.longPressHandled) {
+      lv_point_t endPoint = gestureState.startPoint;
+      if (getActiveTouchPoint(&endPoint)) {
+        int32_t dx = (int32_t)endPoint.x - (int32_t)gestureState.startPoint.x;
+        int32_t dy = (int32_t)endPoint.y - (int32_t)gestureState.startPoint.y;
+        int32_t adx = (dx >= 0) ? dx : -dx;
+        int32_t ady = (dy >= 0) ? dy : -dy;
+
+        if (currentPage == UI_PAGE_HOME) {
+          bool swipeHorizontal = (adx >= HOME_CAROUSEL_SWIPE_THRESHOLD) &&
+                                 (adx > (ady + HOME_CAROUSEL_DIRECTION_MARGIN));
+          if (swipeHorizontal) {
+            shiftHomeCarousel((dx < 0) ? 1 : -1);
+            suppressClicksForMs(CLICK_SUPPRESS_MS_AFTER_CAROUSEL);
+          }
+        } else {
+          bool swipeUp = (dy <= -SWIPE_HOME_THRESHOLD) &&
+                         (ady > (adx + SWIPE_HOME_DIRECTION_MARGIN)) &&
+                         (adx <= SWIPE_HOME_MAX_X_DRIFT);
+          if (swipeUp) {
+            showPage(UI_PAGE_HOME);
+            suppressClicksAfterHome();
+          }
+        }
+      }
+    }
+
+    gestureState = TouchGestureState();
+    return;
+  }
+
+  if (code == LV_EVENT_PRESS_LOST) {
+    pauseDynamicWallpapersForMs(DYNAMIC_WALLPAPER_TOUCH_PAUSE_MS);
+    gestureState = TouchGestureState();
+  }
+}
+
+// Page 1: Home Hub
+static void buildHomePage() {
+  pages[UI_PAGE_HOME] = createBasePage();
+
+  homeWallpaperImage = lv_img_create(pages[UI_PAGE_HOME]);
+  lv_img_set_src(homeWallpaperImage, nullptr);
+  lv_obj_set_size(homeWallpaperImage, 360, 360);
+  lv_obj_center(homeWallpaperImage);
+  lv_obj_clear_flag(homeWallpaperImage, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+
+  homeWallpaperShade = lv_obj_create(pages[UI_PAGE_HOME]);
+  lv_obj_remove_style_all(homeWallpaperShade);
+  lv_obj_set_size(homeWallpaperShade, 360, 360);
+  lv_obj_center(homeWallpaperShade);
+  lv_obj_set_style_bg_opa(homeWallpaperShade, LV_OPA_20, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(homeWallpaperShade, lv_color_hex(0x000000), LV_PART_MAIN);
+  lv_obj_clear_flag(homeWallpaperShade, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+
+  lv_obj_t *homeOuter = lv_obj_create(pages[UI_PAGE_HOME]);
+  lv_obj_set_size(homeOuter, 344, 344);
+  lv_obj_align(homeOuter, LV_ALIGN_CENTER, 0, 4);
+  lv_obj_set_style_radius(homeOuter, 172, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(homeOuter, lv_color_hex(0x0B0F20), LV_PART_MAIN);
+  lv_obj_set_style_bg_grad_color(homeOuter, lv_color_hex(0x121A3A), LV_PART_MAIN);
+  lv_obj_set_style_bg_grad_dir(homeOuter, LV_GRAD_DIR_VER, LV_PART_MAIN);
+  lv_obj_set_style_bg_opa(homeOuter, LV_OPA_60, LV_PART_MAIN);
+  lv_obj_set_style_border_width(homeOuter, 2, LV_PART_MAIN);
+  lv_obj_set_style_border_color(homeOuter, lv_color_hex(0x1C2448), LV_PART_MAIN);
+  lv_obj_clear_flag(homeOuter, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_clear_flag(homeOuter, LV_OBJ_FLAG_CLICKABLE);
+
+  lv_obj_t *homeInner = lv_obj_create(pages[UI_PAGE_HOME]);
+  lv_obj_set_size(homeInner, 304, 304);
+  lv_obj_align(homeInner, LV_ALIGN_CENTER, 0, 4);
+  lv_obj_set_style_radius(homeInner, 152, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(homeInner, lv_color_hex(0x111735), LV_PART_MAIN);
+  lv_obj_set_style_bg_grad_color(homeInner, lv_color_hex(0x191F43), LV_PART_MAIN);
+  lv_obj_set_style_bg_grad_dir(homeInner, LV_GRAD_DIR_VER, LV_PART_MAIN);
+  lv_obj_set_style_bg_opa(homeInner, LV_OPA_60, LV_PART_MAIN);
+  lv_obj_set_style_border_width(homeInner, 1, LV_PART_MAIN);
+  lv_obj_set_style_border_color(homeInner, lv_color_hex(0x222B58), LV_PART_MAIN);
+  lv_obj_clear_flag(homeInner, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_clear_flag(homeInner, LV_OBJ_FLAG_CLICKABLE);
+
+  for (uint8_t i = 0; i < HOME_VISIBLE_SLOT_COUNT; ++i) {
+    const HomeShortcutConfig &item = HOME_SHORTCUTS[i % HOME_SHORTCUT_COUNT];
+
+    homeShortcutSlots[i] = lv_obj_create(pages[UI_PAGE_HOME]);
+    lv_obj_remove_style_all(homeShortcutSlots[i]);
+    lv_obj_set_size(homeShortcutSlots[i], 64, 64);
+    lv_obj_set_style_bg_opa(homeShortcutSlots[i], LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_clear_flag(homeShortcutSlots[i], LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_clear_flag(homeShortcutSlots[i], LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_flag(homeShortcutSlots[i], LV_OBJ_FLAG_GESTURE_BUBBLE);
+    attachGestureHandlers(homeShortcutSlots[i]);
+
+    homeShortcutButtons[i] = lv_btn_create(homeShortcutSlots[i]);
+    lv_obj_set_size(homeShortcutButtons[i], 52, 52);
+    lv_obj_align(homeShortcutButtons[i], LV_ALIGN_CENTER, 0, 0);
+    lv_obj_set_style_radius(homeShortcutButtons[i], 26, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(homeShortcutButtons[i], lv_color_hex(item.accentColor), LV_PART_MAIN);
+    lv_obj_set_style_bg_grad_color(homeShortcutButtons[i], lv_color_hex(0x7E57C2), LV_PART_MAIN);
+    lv_obj_set_style_bg_grad_dir(homeShortcutButtons[i], LV_GRAD_DIR_VER, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(homeShortcutButtons[i], lv_color_hex(0x4527A0), LV_PART_MAIN | LV_STATE_PRESSED);
+    lv_obj_set_style_shadow_width(homeShortcutButtons[i], 12, LV_PART_MAIN);
+    lv_obj_set_style_shadow_color(homeShortcutButtons[i], lv_color_hex(item.accentColor), LV_PART_MAIN);
+    lv_obj_set_style_shadow_opa(homeShortcutButtons[i], LV_OPA_70, LV_PART_MAIN);
+    lv_obj_set_style_border_width(homeShortcutButtons[i], 1, LV_PART_MAIN);
+    lv_obj_set_style_border_color(homeShortcutButtons[i], lv_color_hex(0xD1C4E9), LV_PART_MAIN);
+    lv_obj_add_flag(homeShortcutButtons[i], LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
+    attachGestureHandlers(homeShortcutButtons[i]);
+    lv_obj_add_event_cb(homeShortcutButtons[i], homeShortcutEventCallback, LV_EVENT_CLICKED, (void *)((intptr_t)i));
+
+    homeShortcutIcons[i] = lv_obj_create(homeShortcutButtons[i]);
+    lv_obj_remove_style_all(homeShortcutIcons[i]);
+    lv_obj_set_size(homeShortcutIcons[i], 36, 36);
+    lv_obj_center(homeShortcutIcons[i]);
+    lv_obj_set_style_bg_opa(homeShortcutIcons[i], LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_clear_flag(homeShortcutIcons[i], LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_clear_flag(homeShortcutIcons[i], LV_OBJ_FLAG_CLICKABLE);
+    renderHomeShortcutIcon(i, item);
+  }
+
+  lv_obj_t *homeCenter = lv_obj_create(pages[UI_PAGE_HOME]);
+  lv_obj_set_size(homeCenter, 128, 128);
+  lv_obj_align(homeCenter, LV_ALIGN_CENTER, 0, 4);
+  lv_obj_set_style_radius(homeCenter, 64, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(homeCenter, lv_color_hex(0x18305C), LV_PART_MAIN);
+  lv_obj_set_style_bg_grad_color(homeCenter, lv_color_hex(0x102242), LV_PART_MAIN);
+  lv_obj_set_style_bg_grad_dir(homeCenter, LV_GRAD_DIR_VER, LV_PART_MAIN);
+  lv_obj_set_style_border_width(homeCenter, 2, LV_PART_MAIN);
+  lv_obj_set_style_border_color(homeCenter, lv_color_hex(0x2D5AA0), LV_PART_MAIN);
+  lv_obj_set_style_shadow_width(homeCenter, 20, LV_PART_MAIN);
+  lv_obj_set_style_shadow_color(homeCenter, lv_color_hex(0x1A3B74), LV_PART_MAIN);
+  lv_obj_set_style_shadow_opa(homeCenter, LV_OPA_50, LV_PART_MAIN);
+  lv_obj_clear_flag(homeCenter, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_clear_flag(homeCenter, LV_OBJ_FLAG_CLICKABLE);
+
+  homeClockLabel = lv_label_create(homeCenter);
+  lv_label_set_text(homeClockLabel, "--:--");
+  lv_obj_set_style_text_font(homeClockLabel, &lv_font_montserrat_32, LV_PART_MAIN);
+  lv_obj_set_style_text_color(homeClockLabel, lv_color_hex(0xF2F7FF), LV_PART_MAIN);
+  lv_obj_align(homeClockLabel, LV_ALIGN_CENTER, 0, -14);
+
+  homeDateLabel = lv_label_create(homeCenter);
+  lv_label_set_text(homeDateLabel, "--/--");
+  lv_obj_set_style_text_font(homeDateLabel, &lv_font_montserrat_16, LV_PART_MAIN);
+  lv_obj_set_style_text_color(homeDateLabel, lv_color_hex(0xB7D1FF), LV_PART_MAIN);
+  lv_obj_align(homeDateLabel, LV_ALIGN_CENTER, 0, 26);
+
+  homeCurrentShortcutLabel = lv_label_create(pages[UI_PAGE_HOME]);
+  lv_label_set_text(homeCurrentShortcutLabel, "--");
+  lv_obj_set_style_text_color(homeCurrentShortcutLabel, lv_color_hex(0xD5DBFF), LV_PART_MAIN);
+  lv_obj_set_style_text_font(homeCurrentShortcutLabel, &lv_font_montserrat_16, LV_PART_MAIN);
+  lv_obj_set_style_text_align(homeCurrentShortcutLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
+  lv_obj_align(homeCurrentShortcutLabel, LV_ALIGN_BOTTOM_MID, 0, -30);
+
+  homeSwipeHintLabel = lv_label_create(pages[UI_PAGE_HOME]);
+  lv_label_set_text(homeSwipeHintLabel, "Swipe <- / ->   Tap to open");
+  lv_obj_set_style_text_color(homeSwipeHintLabel, lv_color_hex(0x8A93C8), LV_PART_MAIN);
+  lv_obj_set_style_text_font(homeSwipeHintLabel, &lv_font_montserrat_14, LV_PART_MAIN);
+  lv_obj_set_style_text_align(homeSwipeHintLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
+  lv_obj_align(homeSwipeHintLabel, LV_ALIGN_BOTTOM_MID, 0, -10);
+
+  layoutHomeShortcuts();
+}
+
+// Page 2: Monitor
+static void buildMonitorPage() {
+  pages[UI_PAGE_MONITOR] = createBasePage();
+  lv_obj_t *monitorTitle = lv_label_create(pages[UI_PAGE_MONITOR]);
+  lv_label_set_text(monitorTitle, "System Monitor");
+  lv_obj_align(monitorTitle, LV_ALIGN_TOP_MID, 0, 18);
+
+  wifiLabel = lv_label_create(pages[UI_PAGE_MONITOR]);
+  lv_label_set_text(wifiLabel, "WiFi: connecting...");
+  lv_obj_align(wifiLabel, LV_ALIGN_TOP_MID, 0, 44);
+
+  wsLabel = lv_label_create(pages[UI_PAGE_MONITOR]);
+  lv_label_set_text(wsLabel, "WS: disconnected");
+  lv_obj_align(wsLabel, LV_ALIGN_TOP_MID, 0, 62);
+
+  cpuArc = lv_arc_create(pages[UI_PAGE_MONITOR]);
+  lv_obj_set_size(cpuArc, 120, 120);
+  lv_obj_align(cpuArc, LV_ALIGN_TOP_LEFT, 34, 88);
+  lv_arc_set_rotation(cpuArc, 135);
+  lv_arc_set_bg_angles(cpuArc, 0, 270);
+  lv_arc_set_range(cpuArc, 0, 100);
+  lv_arc_set_value(cpuArc, 0);
+  lv_obj_set_style_arc_width(cpuArc, 10, LV_PART_MAIN);
+  lv_obj_set_style_arc_color(cpuArc, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
+  lv_obj_set_style_arc_width(cpuArc, 10, LV_PART_INDICATOR);
+  lv_obj_set_style_arc_color(cpuArc, lv_color_hex(0x26C6DA), LV_PART_INDICATOR);
+  lv_obj_set_style_opa(cpuArc, LV_OPA_TRANSP, LV_PART_KNOB);
+  lv_obj_clear_flag(cpuArc, LV_OBJ_FLAG_CLICKABLE);
+
+  cpuValueLabel = lv_label_create(pages[UI_PAGE_MONITOR]);
+  lv_label_set_text(cpuValueLabel, "CPU\n0%");
+  lv_obj_set_style_text_align(cpuValueLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
+  lv_obj_align(cpuValueLabel, LV_ALIGN_TOP_LEFT, 76, 128);
+
+  memArc = lv_arc_create(pages[UI_PAGE_MONITOR]);
+  lv_obj_set_size(memArc, 120, 120);
+  lv_obj_align(memArc, LV_ALIGN_TOP_RIGHT, -34, 88);
+  lv_arc_set_rotation(memArc, 135);
+  lv_arc_set_bg_angles(memArc, 0, 270);
+  lv_arc_set_range(memArc, 0, 100);
+  lv_arc_set_value(memArc, 0);
+  lv_obj_set_style_arc_width(memArc, 10, LV_PART_MAIN);
+  lv_obj_set_style_arc_color(memArc, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
+  lv_obj_set_style_arc_width(memArc, 10, LV_PART_INDICATOR);
+  lv_obj_set_style_arc_color(memArc, lv_color_hex(0x66BB6A), LV_PART_INDICATOR);
+  lv_obj_set_style_opa(memArc, LV_OPA_TRANSP, LV_PART_KNOB);
+  lv_obj_clear_flag(memArc, LV_OBJ_FLAG_CLICKABLE);
+
+  memValueLabel = lv_label_create(pages[UI_PAGE_MONITOR]);
+  lv_label_set_text(memValueLabel, "MEM\n0%");
+  lv_obj_set_style_text_align(memValueLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
+  lv_obj_align(memValueLabel, LV_ALIGN_TOP_RIGHT, -76, 128);
+
+  lv_obj_t *netPanel = lv_obj_create(pages[UI_PAGE_MONITOR]);
+  lv_obj_set_size(netPanel, 292, 62);
+  lv_obj_align(netPanel, LV_ALIGN_BOTTOM_MID, 0, -38);
+  lv_obj_set_style_radius(netPanel, 12, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(netPanel, lv_color_hex(0x111111), LV_PART_MAIN);
+  lv_obj_set_style_border_color(netPanel, lv_color_hex(0x2E2E2E), LV_PART_MAIN);
+  lv_obj_set_style_border_width(netPanel, 1, LV_PART_MAIN);
+  lv_obj_clear_flag(netPanel, LV_OBJ_FLAG_SCROLLABLE);
+
+  lv_obj_t *upLabel = lv_label_create(netPanel);
+  lv_label_set_text(upLabel, "UP");
+  lv_obj_set_style_text_color(upLabel, lv_color_hex(0x90CAF9), LV_PART_MAIN);
+  lv_obj_align(upLabel, LV_ALIGN_LEFT_MID, 14, -10);
+
+  upValueLabel = lv_label_create(netPanel);
+  lv_label_set_text(upValueLabel, "-- KB/s");
+  lv_obj_align(upValueLabel, LV_ALIGN_LEFT_MID, 44, -10);
+
+  lv_obj_t *downLabel = lv_label_create(netPanel);
+  lv_label_set_text(downLabel, "DOWN");
+  lv_obj_set_style_text_color(downLabel, lv_color_hex(0xA5D6A7), LV_PART_MAIN);
+  lv_obj_align(downLabel, LV_ALIGN_LEFT_MID, 14, 14);
+
+  downValueLabel = lv_label_create(netPanel);
+  lv_label_set_text(downValueLabel, "-- KB/s");
+  lv_obj_align(downValueLabel, LV_ALIGN_LEFT_MID, 64, 14);
+
+  statsLabel = lv_label_create(pages[UI_PAGE_MONITOR]);
+  lv_label_set_text(statsLabel, "");
+  lv_obj_add_flag(statsLabel, LV_OBJ_FLAG_HIDDEN);
+}
+
+// Page 3: Clock
+static void buildClockPage() {
+  pages[UI_PAGE_CLOCK] = createBasePage();
+
+  clockWallpaperImage = lv_img_create(pages[UI_PAGE_CLOCK]);
+  lv_img_set_src(clockWallpaperImage, nullptr);
+  lv_obj_set_size(clockWallpaperImage, 360, 360);
+  lv_obj_center(clockWallpaperImage);
+  lv_obj_clear_flag(clockWallpaperImage, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+
+  clockWallpaperShade = lv_obj_create(pages[UI_PAGE_CLOCK]);
+  lv_obj_remove_style_all(clockWallpaperShade);
+  lv_obj_set_size(clockWallpaperShade, 360, 360);
+  lv_obj_center(clockWallpaperShade);
+  lv_obj_set_style_bg_opa(clockWallpaperShade, LV_OPA_50, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(clockWallpaperShade, lv_color_hex(0x000000), LV_PART_MAIN);
+  lv_obj_clear_flag(clockWallpaperShade, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+
+  lv_obj_t *clockTitle = lv_label_create(pages[UI_PAGE_CLOCK]);
+  lv_label_set_text(clockTitle, "Clock");
+  lv_obj_align(clockTitle, LV_ALIGN_TOP_MID, 0, 20);
+
+  // Degrees rather than seconds, so sweep mode can share the arc; in tick
+  // mode each second redraws only the 6-degree segment it adds.
+  clockSecondArc = lv_arc_create(pages[UI_PAGE_CLOCK]);
+  lv_obj_set_size(clockSecondArc, CLOCK_ARC_SIZE, CLOCK_ARC_SIZE);
+  lv_obj_align(clockSecondArc, LV_ALIGN_CENTER, 0, CLOCK_ARC_Y_OFFSET);
+  lv_arc_set_rotation(clockSecondArc, 270);
+  lv_arc_set_bg_angles(clockSecondArc, 0, 360);
+  lv_arc_set_range(clockSecondArc, 0, 360);
+  lv_arc_set_value(clockSecondArc, 0);
+  lv_obj_set_style_arc_width(clockSecondArc, CLOCK_ARC_WIDTH, LV_PART_MAIN);
+  lv_obj_set_style_arc_color(clockSecondArc, lv_color_hex(0x252525), LV_PART_MAIN);
+  lv_obj_set_style_arc_width(clockSecondArc, CLOCK_ARC_WIDTH, LV_PART_INDICATOR);
+  lv_obj_set_style_arc_color(clockSecondArc, lv_color_hex(0xFFA726), LV_PART_INDICATOR);
+  lv_obj_set_style_opa(clockSecondArc, LV_OPA_TRANSP, LV_PART_KNOB);
+  lv_obj_clear_flag(clockSecondArc, LV_OBJ_FLAG_CLICKABLE);
+
+  clockSweepTip = lv_obj_create(pages[UI_PAGE_CLOCK]);
+  lv_obj_remove_style_all(clockSweepTip);
+  lv_obj_set_size(clockSweepTip, CLOCK_SWEEP_TIP_SIZE, CLOCK_SWEEP_TIP_SIZE);
+  lv_obj_set_style_radius(clockSweepTip, LV_RADIUS_CIRCLE, LV_PART_MAIN);
+  lv_obj_set_style_bg_opa(clockSweepTip, LV_OPA_COVER, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(clockSweepTip, lv_color_hex(0xFFE0B2), LV_PART_MAIN);
+  lv_obj_clear_flag(clockSweepTip, LV_OBJ_FLAG_CLICKABLE | LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_align(clockSweepTip, LV_ALIGN_CENTER, 0, CLOCK_ARC_Y_OFFSET - (CLOCK_ARC_SIZE - CLOCK_ARC_WIDTH) / 2);
+  if (!clockSweepEnabled) {
+    lv_obj_add_flag(clockSweepTip, LV_OBJ_FLAG_HIDDEN);
+  }
+
+  // The sprites outlive the page, so they are rendered once per boot.
+  if (clockDigitSprites.pixels == nullptr &&
+      !clockFaceBuildSprites(&clockDigitSprites, &lv_font_montserrat_32, lv_color_hex(0xFFFFFF), 0)) {
+    Serial.println("[Clock] digit sprites: out of memory");
+  }
+  if (clockSecondSprites.pixels == nullptr &&
+      !clockFaceBuildSprites(&clockSecondSprites, &lv_font_montserrat_14, lv_color_hex(0xFFCC80), 0)) {
+    Serial.println("[Clock] second sprites: out of memory");
+  }
+  if (clockDigitSprites.pixels != nullptr) {
+    lv_obj_align(clockFaceCreateRow(&clockTimeRow, pages[UI_PAGE_CLOCK], &clockDigitSprites, "00:00"),
+                 LV_ALIGN_CENTER, 0, -6);
+  }
+  if (clockSecondSprites.pixels != nullptr) {
+    lv_obj_align(clockFaceCreateRow(&clockSecondRow, pages[UI_PAGE_CLOCK], &clockSecondSprites, ":00"),
+                 LV_ALIGN_CENTER, 0, 36);
+  }
+  lv_obj_add_event_cb(pages[UI_PAGE_CLOCK], clockPageClickCallback, LV_EVENT_SHORT_CLICKED, nullptr);
+
+  clockDateLabel = lv_label_create(pages[UI_PAGE_CLOCK]);
+  lv_label_set_text(clockDateLabel, "Uptime 0d 00h 00m");
+  lv_obj_align(clockDateLabel, LV_ALIGN_BOTTOM_MID, 0, -54);
+
+  lv_obj_t *clockHint = lv_label_create(pages[UI_PAGE_CLOCK]);
+  lv_label_set_text(clockHint, "Long-press anywhere to return Home");
+  lv_obj_align(clockHint, LV_ALIGN_BOTTOM_MID, 0, -30);
+}
+
+// Page 4: Settings & Diagnostics
+static void buildSettingsPage() {
+  pages[UI_PAGE_SETTINGS] = createBasePage();
+  lv_obj_t *settingsTitle = lv_label_create(pages[UI_PAGE_SETTINGS]);
+  lv_label_set_text(settingsTitle, "Settings & Diagnostics");
+  lv_obj_align(settingsTitle, LV_ALIGN_TOP_MID, 0, 14);
+
+  lv_obj_t *diagPanel = lv_obj_create(pages[UI_PAGE_SETTINGS]);
+  lv_obj_set_size(diagPanel, 300, 140);
+  lv_obj_align(diagPanel, LV_ALIGN_TOP_MID, 0, 32);
+  lv_obj_set_style_radius(diagPanel, 12, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(diagPanel, lv_color_hex(0x111111), LV_PART_MAIN);
+  lv_obj_set_style_border_color(diagPanel, lv_color_hex(0x2E2E2E), LV_PART_MAIN);
+  lv_obj_set_style_border_width(diagPanel, 1, LV_PART_MAIN);
+  lv_obj_clear_flag(diagPanel, LV_OBJ_FLAG_SCROLLABLE);
+
+  diagWifiLabel = lv_label_create(diagPanel);
+  lv_label_set_text(diagWifiLabel, "WiFi: connecting...");
+  lv_obj_align(diagWifiLabel, LV_ALIGN_TOP_LEFT, 10, 8);
+
+  diagWsLabel = lv_label_create(diagPanel);
+  lv_label_set_text(diagWsLabel, "WS: disconnected");
+  lv_obj_align(diagWsLabel, LV_ALIGN_TOP_LEFT, 10, 26);
+
+  diagPacerLabel = lv_label_create(diagPanel);
+  lv_label_set_text(diagPacerLabel, "TE 0/0 St 0");
+  lv_obj_set_width(diagPacerLabel, 140);
+  lv_label_set_long_mode(diagPacerLabel, LV_LABEL_LONG_DOT);
+  lv_obj_align(diagPacerLabel, LV_ALIGN_TOP_LEFT, 148, 26);
+
+  diagNtpLabel = lv_label_create(diagPanel);
+  lv_label_set_text(diagNtpLabel, "NTP: syncing");
+  lv_obj_align(diagNtpLabel, LV_ALIGN_TOP_LEFT, 10, 42);
+
+  diagIpLabel = lv_label_create(diagPanel);
+  lv_label_set_text(diagIpLabel, "IP: --");
+  lv_obj_align(diagIpLabel, LV_ALIGN_TOP_LEFT, 10, 58);
+
+  diagRssiLabel = lv_label_create(diagPanel);
+  lv_label_set_text(diagRssiLabel, "RSSI: --");
+  lv_obj_align(diagRssiLabel, LV_ALIGN_TOP_LEFT, 10, 74);
+
+  diagServerLabel = lv_label_create(diagPanel);
+  lv_label_set_text(diagServerLabel, "Server: --");
+  lv_obj_align(diagServerLabel, LV_ALIGN_TOP_LEFT, 148, 74);
+
+  diagAudioLabel = lv_label_create(diagPanel);
+  lv_label_set_text(diagAudioLabel, "Audio: UR 0 / GL 0 / JB 0");
+  lv_obj_align(diagAudioLabel, LV_ALIGN_TOP_LEFT, 148, 42);
+
+  diagSdLabel = lv_label_create(diagPanel);
+  lv_label_set_text(diagSdLabel, "SD: checking...");
+  lv_obj_align(diagSdLabel, LV_ALIGN_TOP_LEFT, 10, 90);
+
+  diagSdRootLabel = lv_label_create(diagPanel);
+  lv_label_set_text(diagSdRootLabel, "Root: --");
+  lv_obj_set_width(diagSdRootLabel, 280);
+  lv_label_set_long_mode(diagSdRootLabel, LV_LABEL_LONG_DOT);
+  lv_obj_set_style_text_color(diagSdRootLabel, lv_color_hex(0xB0B0B0), LV_PART_MAIN);
+  lv_obj_align(diagSdRootLabel, LV_ALIGN_TOP_LEFT, 10, 106);
+
+  diagPacerHistLabel = lv_label_create(diagPanel);
+  lv_label_set_text(diagPacerHistLabel, "Jitter 0/0/0/0/0/0 max 0.0 ms");
+  lv_obj_set_width(diagPacerHistLabel, 280);
+  lv_label_set_long_mode(diagPacerHistLabel, LV_LABEL_LONG_DOT);
+  lv_obj_align(diagPacerHistLabel, LV_ALIGN_TOP_LEFT, 10, 122);
+
+  createSettingsButton(pages[UI_PAGE_SETTINGS], "WiFi Reconnect", 34, 176, SETTINGS_ACTION_WIFI_RECONNECT);
+  createSettingsButton(pages[UI_PAGE_SETTINGS], "WS Reconnect", 190, 176, SETTINGS_ACTION_WS_RECONNECT);
+  createSettingsButton(pages[UI_PAGE_SETTINGS], "NTP Sync", 34, 216, SETTINGS_ACTION_NTP_SYNC);
+  createSettingsButton(pages[UI_PAGE_SETTINGS], "Reboot", 190, 216, SETTINGS_ACTION_REBOOT);
+
+  lv_obj_t *brightnessPanel = lv_obj_create(pages[UI_PAGE_SETTINGS]);
+  lv_obj_set_size(brightnessPanel, 300, 54);
+  lv_obj_align(brightnessPanel, LV_ALIGN_TOP_MID, 0, 256);
+  lv_obj_set_style_radius(brightnessPanel, 12, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(brightnessPanel, lv_color_hex(0x111111), LV_PART_MAIN);
+  lv_obj_set_style_border_color(brightnessPanel, lv_color_hex(0x2E2E2E), LV_PART_MAIN);
+  lv_obj_set_style_border_width(brightnessPanel, 1, LV_PART_MAIN);
+  lv_obj_clear_flag(brightnessPanel, LV_OBJ_FLAG_SCROLLABLE);
+
+  lv_obj_t *brightnessText = lv_label_create(brightnessPanel);
+  lv_label_set_text(brightnessText, "Brightness");
+  lv_obj_align(brightnessText, LV_ALIGN_TOP_LEFT, 10, 6);
+
+  brightnessSlider = lv_slider_create(brightnessPanel);
+  lv_obj_set_size(brightnessSlider, 192, 12);
+  lv_obj_align(brightnessSlider, LV_ALIGN_TOP_LEFT, 90, 10);
+  lv_slider_set_range(brightnessSlider, 5, 100);
+  lv_slider_set_value(brightnessSlider, screenBrightness, LV_ANIM_OFF);
+  lv_obj_add_flag(brightnessSlider, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  attachGestureHandlers(brightnessSlider);
+  lv_obj_add_event_cb(brightnessSlider, brightnessSliderEventCallback, LV_EVENT_VALUE_CHANGED, nullptr);
+  lv_obj_add_event_cb(brightnessSlider, brightnessSliderEventCallback, LV_EVENT_RELEASED, nullptr);
+
+  brightnessValueLabel = lv_label_create(brightnessPanel);
+  lv_label_set_text(brightnessValueLabel, "100%");
+  lv_obj_align(brightnessValueLabel, LV_ALIGN_TOP_RIGHT, -10, 4);
+
+  diagActionLabel = lv_label_create(brightnessPanel);
+  lv_label_set_text(diagActionLabel, "Ready");
+  lv_obj_set_style_text_color(diagActionLabel, lv_color_hex(0xAFAFAF), LV_PART_MAIN);
+  lv_obj_align(diagActionLabel, LV_ALIGN_BOTTOM_LEFT, 10, -4);
+
+  diagUptimeLabel = lv_label_create(pages[UI_PAGE_SETTINGS]);
+  lv_label_set_text(diagUptimeLabel, "Uptime: 00:00:00");
+  lv_obj_align(diagUptimeLabel, LV_ALIGN_TOP_MID, 0, 314);
+}
+
+// Page 5: Inbox & Tasks
+static void buildInboxPage() {
+  pages[UI_PAGE_INBOX] = createBasePage();
+  lv_obj_t *inboxPageTitle = lv_label_create(pages[UI_PAGE_INBOX]);
+  lv_label_set_text(inboxPageTitle, "Inbox & Tasks");
+  lv_obj_align(inboxPageTitle, LV_ALIGN_TOP_MID, 0, 14);
+
+  lv_obj_t *inboxCard = lv_obj_create(pages[UI_PAGE_INBOX]);
+  lv_obj_set_size(inboxCard, 300, 170);
+  lv_obj_align(inboxCard, LV_ALIGN_TOP_MID, 0, 36);
+  lv_obj_set_style_radius(inboxCard, 12, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(inboxCard, lv_color_hex(0x111111), LV_PART_MAIN);
+  lv_obj_set_style_border_color(inboxCard, lv_color_hex(0x2E2E2E), LV_PART_MAIN);
+  lv_obj_set_style_border_width(inboxCard, 1, LV_PART_MAIN);
+  lv_obj_clear_flag(inboxCard, LV_OBJ_FLAG_SCROLLABLE);
+
+  inboxTypeLabel = lv_label_create(inboxCard);
+  lv_label_set_text(inboxTypeLabel, "[info]");
+  lv_obj_set_style_text_color(inboxTypeLabel, lv_color_hex(0x90CAF9), LV_PART_MAIN);
+  lv_obj_align(inboxTypeLabel, LV_ALIGN_TOP_LEFT, 10, 8);
+
+  inboxIndexLabel = lv_label_create(inboxCard);
+  lv_label_set_text(inboxIndexLabel, "0/0");
+  lv_obj_set_style_text_color(inboxIndexLabel, lv_color_hex(0x9E9E9E), LV_PART_MAIN);
+  lv_obj_align(inboxIndexLabel, LV_ALIGN_TOP_RIGHT, -10, 8);
+
+  inboxTitleLabel = lv_label_create(inboxCard);
+  lv_label_set_text(inboxTitleLabel, "No messages");
+  lv_obj_set_style_text_font(inboxTitleLabel, uiTextFont(22), LV_PART_MAIN);
+  lv_obj_align(inboxTitleLabel, LV_ALIGN_TOP_LEFT, 10, 30);
+
+  inboxBodyLabel = lv_label_create(inboxCard);
+  lv_obj_set_width(inboxBodyLabel, 280);
+  lv_label_set_long_mode(inboxBodyLabel, LV_LABEL_LONG_WRAP);
+  lv_label_set_text(inboxBodyLabel, "Incoming notifications and tasks\nwill appear here.");
+  lv_obj_align(inboxBodyLabel, LV_ALIGN_TOP_LEFT, 10, 66);
+
+  inboxMetaLabel = lv_label_create(inboxCard);
+  lv_label_set_text(inboxMetaLabel, "waiting for events");
+  lv_obj_set_style_text_color(inboxMetaLabel, lv_color_hex(0xA0A0A0), LV_PART_MAIN);
+  lv_obj_align(inboxMetaLabel, LV_ALIGN_BOTTOM_LEFT, 10, -10);
+
+  createInboxButton(pages[UI_PAGE_INBOX], "Prev", 34, 214, 96, INBOX_ACTION_PREV);
+  createInboxButton(pages[UI_PAGE_INBOX], "Next", 230, 214, 96, INBOX_ACTION_NEXT);
+  inboxAckBtn = createInboxButton(pages[UI_PAGE_INBOX], "Acknowledge", 34, 254, 136, INBOX_ACTION_ACK);
+  inboxDoneBtn = createInboxButton(pages[UI_PAGE_INBOX], "Mark Done", 190, 254, 136, INBOX_ACTION_DONE);
+
+  inboxActionLabel = lv_label_create(pages[UI_PAGE_INBOX]);
+  lv_label_set_text(inboxActionLabel, "Use buttons | long-press for Home");
+  lv_obj_set_style_text_color(inboxActionLabel, lv_color_hex(0xAFAFAF), LV_PART_MAIN);
+  lv_obj_align(inboxActionLabel, LV_ALIGN_TOP_MID, 0, 296);
+}
+
+// Page 6: Pomodoro Timer
+static void buildPomodoroPage() {
+  pages[UI_PAGE_POMODORO] = createBasePage();
+  lv_obj_t *pomodoroTitle = lv_label_create(pages[UI_PAGE_POMODORO]);
+  lv_label_set_text(pomodoroTitle, "Pomodoro Timer");
+  lv_obj_align(pomodoroTitle, LV_ALIGN_TOP_MID, 0, 14);
+
+  pomodoroModeLabel = lv_label_create(pages[UI_PAGE_POMODORO]);
+  lv_label_set_text(pomodoroModeLabel, getPomodoroModeText(pomodoroMode));
+  lv_obj_set_style_text_font(pomodoroModeLabel, &lv_font_montserrat_22, LV_PART_MAIN);
+  lv_obj_align(pomodoroModeLabel, LV_ALIGN_TOP_MID, 0, 40);
+
+  pomodoroArc = lv_arc_create(pages[UI_PAGE_POMODORO]);
+  lv_obj_set_size(pomodoroArc, 200, 200);
+  lv_obj_align(pomodoroArc, LV_ALIGN_CENTER, 0, 0);
+  lv_arc_set_rotation(pomodoroArc, 270);
+  lv_arc_set_bg_angles(pomodoroArc, 0, 360);
+  lv_arc_set_range(pomodoroArc, 0, 100);
+  lv_arc_set_value(pomodoroArc, 0);
+  lv_obj_set_style_arc_width(pomodoroArc, 12, LV_PART_MAIN);
+  lv_obj_set_style_arc_color(pomodoroArc, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
+  lv_obj_set_style_arc_width(pomodoroArc, 12, LV_PART_INDICATOR);
+  lv_obj_set_style_arc_color(pomodoroArc, lv_color_hex(getPomodoroColor(pomodoroMode)), LV_PART_INDICATOR);
+  lv_obj_set_style_opa(pomodoroArc, LV_OPA_TRANSP, LV_PART_KNOB);
+  lv_obj_clear_flag(pomodoroArc, LV_OBJ_FLAG_CLICKABLE);
+
+  pomodoroTimeLabel = lv_label_create(pages[UI_PAGE_POMODORO]);
+  lv_label_set_text(pomodoroTimeLabel, "25:00");
+  lv_obj_set_style_text_font(pomodoroTimeLabel, &lv_font_montserrat_32, LV_PART_MAIN);
+  lv_obj_align(pomodoroTimeLabel, LV_ALIGN_CENTER, 0, 0);
+
+  pomodoroStatusLabel = lv_label_create(pages[UI_PAGE_POMODORO]);
+  lv_label_set_text(pomodoroStatusLabel, "Tap to Start");
+  lv_obj_set_style_text_color(pomodoroStatusLabel, lv_color_hex(0xA0A0A0), LV_PART_MAIN);
+  lv_obj_align(pomodoroStatusLabel, LV_ALIGN_CENTER, 0, 50);
+
+  pomodoroCountLabel = lv_label_create(pages[UI_PAGE_POMODORO]);
+  lv_label_set_text(pomodoroCountLabel, "Completed: 0");
+  lv_obj_set_style_text_color(pomodoroCountLabel, lv_color_hex(0x90CAF9), LV_PART_MAIN);
+  lv_obj_align(pomodoroCountLabel, LV_ALIGN_BOTTOM_MID, 0, -80);
+
+  // Control buttons
+  lv_obj_t *startBtn = lv_btn_create(pages[UI_PAGE_POMODORO]);
+  lv_obj_set_size(startBtn, 90, 36);
+  lv_obj_align(startBtn, LV_ALIGN_BOTTOM_LEFT, 30, -36);
+  lv_obj_set_style_radius(startBtn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(startBtn, lv_color_hex(0x1E1E1E), LV_PART_MAIN);
+  lv_obj_add_flag(startBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
+  attachGestureHandlers(startBtn);
+  lv_obj_add_event_cb(startBtn, pomodoroControlCallback, LV_EVENT_CLICKED, (void*)0);
+  lv_obj_t *startLabel = lv_label_create(startBtn);
+  lv_label_set_text(startLabel, "Start");
+  lv_obj_center(startLabel);
+
+  lv_obj_t *resetBtn = lv_btn_create(pages[UI_PAGE_POMODORO]);
+  lv_obj_set_size(resetBtn, 90, 36);
+  lv_obj_align(resetBtn, LV_ALIGN_BOTTOM_MID, 0, -36);
+  lv_obj_set_style_radius(resetBtn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(resetBtn, lv_color_hex(0x1E1E1E), LV_PART_MAIN);
+  lv_obj_add_flag(resetBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
+  attachGestureHandlers(resetBtn);
+  lv_obj_add_event_cb(resetBtn, pomodoroControlCallback, LV_EVENT_CLICKED, (void*)1);
+  lv_obj_t *resetLabel = lv_label_create(resetBtn);
+  lv_label_set_text(resetLabel, "Reset");
+  lv_obj_center(resetLabel);
+
+  lv_obj_t *skipBtn = lv_btn_create(pages[UI_PAGE_POMODORO]);
+  lv_obj_set_size(skipBtn, 90, 36);
+  lv_obj_align(skipBtn, LV_ALIGN_BOTTOM_RIGHT, -30, -36);
+  lv_obj_set_style_radius(skipBtn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(skipBtn, lv_color_hex(0x1E1E1E), LV_PART_MAIN);
+  lv_obj_add_flag(skipBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
+  attachGestureHandlers(skipBtn);
+  lv_obj_add_event_cb(skipBtn, pomodoroControlCallback, LV_EVENT_CLICKED, (void*)2);
+  lv_obj_t *skipLabel = lv_label_create(skipBtn);
+  lv_label_set_text(skipLabel, "Skip");
+  lv_obj_center(skipLabel);
+}
+
+// Page 7: Weather
+static void buildWeatherPage() {
+  pages[UI_PAGE_WEATHER] = createBasePage();
+
+  weatherCityLabel = lv_label_create(pages[UI_PAGE_WEATHER]);
+  lv_label_set_text(weatherCityLabel, currentWeather.city);
+  lv_obj_set_style_text_color(weatherCityLabel, lv_color_hex(0x90CAF9), LV_PART_MAIN);
+  lv_obj_set_style_text_font(weatherCityLabel, uiTextFont(16), LV_PART_MAIN);
+  lv_obj_align(weatherCityLabel, LV_ALIGN_TOP_MID, 0, 30);
+
+  weatherTempLabel = lv_label_create(pages[UI_PAGE_WEATHER]);
+  lv_label_set_text(weatherTempLabel, "--");
+  lv_obj_set_style_text_font(weatherTempLabel, &lv_font_montserrat_32, LV_PART_MAIN);
+  lv_obj_align(weatherTempLabel, LV_ALIGN_CENTER, 0, -20);
+
+  lv_obj_t *degreeLabel = lv_label_create(pages[UI_PAGE_WEATHER]);
+  lv_label_set_text(degreeLabel, "°C");
+  lv_obj_set_style_text_font(degreeLabel, &lv_font_montserrat_22, LV_PART_MAIN);
+  lv_obj_align(degreeLabel, LV_ALIGN_CENTER, 40, -30);
+
+  weatherConditionLabel = lv_label_create(pages[UI_PAGE_WEATHER]);
+  lv_label_set_text(weatherConditionLabel, "Loading...");
+  lv_obj_set_style_text_color(weatherConditionLabel, lv_color_hex(0xC0C0C0), LV_PART_MAIN);
+  lv_obj_align(weatherConditionLabel, LV_ALIGN_CENTER, 0, 30);
+
+  // Bottom info panel
+  lv_obj_t *weatherInfoPanel = lv_obj_create(pages[UI_PAGE_WEATHER]);
+  lv_obj_set_size(weatherInfoPanel, 280, 80);
+  lv_obj_align(weatherInfoPanel, LV_ALIGN_BOTTOM_MID, 0, -40);
+  lv_obj_set_style_radius(weatherInfoPanel, 12, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(weatherInfoPanel, lv_color_hex(0x1A1A1A), LV_PART_MAIN);
+  lv_obj_set_style_border_width(weatherInfoPanel, 0, LV_PART_MAIN);
+  lv_obj_clear_flag(weatherInfoPanel, LV_OBJ_FLAG_SCROLLABLE);
+
+  // Feels Like (left)
+  lv_obj_t *feelsLikeTitle = lv_label_create(weatherInfoPanel);
+  lv_label_set_text(feelsLikeTitle, "FEELS LIKE");
+  lv_obj_set_style_text_color(feelsLikeTitle, lv_color_hex(0x808080), LV_PART_MAIN);
+  lv_obj_align(feelsLikeTitle, LV_ALIGN_TOP_LEFT, 20, 12);
+
+  weatherFeelsLikeLabel = lv_label_create(weatherInfoPanel);
+  lv_label_set_text(weatherFeelsLikeLabel, "--°");
+  lv_obj_set_style_text_font(weatherFeelsLikeLabel, &lv_font_montserrat_22, LV_PART_MAIN);
+  lv_obj_align(weatherFeelsLikeLabel, LV_ALIGN_TOP_LEFT, 20, 35);
+
+  // Humidity (right)
+  lv_obj_t *humidityTitle = lv_label_create(weatherInfoPanel);
+  lv_label_set_text(humidityTitle, "HUMIDITY");
+  lv_obj_set_style_text_color(humidityTitle, lv_color_hex(0x808080), LV_PART_MAIN);
+  lv_obj_align(humidityTitle, LV_ALIGN_TOP_RIGHT, -20, 12);
+
+  weatherHumidityLabel = lv_label_create(weatherInfoPanel);
+  lv_label_set_text(weatherHumidityLabel, "--%");
+  lv_obj_set_style_text_font(weatherHumidityLabel, &lv_font_montserrat_22, LV_PART_MAIN);
+  lv_obj_align(weatherHumidityLabel, LV_ALIGN_TOP_RIGHT, -20, 35);
+}
+
+// Page 8: App Launcher
+static void buildAppLauncherPage() {
+  pages[UI_PAGE_APP_LAUNCHER] = createBasePage();
+
+  appLauncherTitle = lv_label_create(pages[UI_PAGE_APP_LAUNCHER]);
+  lv_label_set_text(appLauncherTitle, "App Launcher");
+  lv_obj_set_style_text_color(appLauncherTitle, lv_color_hex(0x90CAF9), LV_PART_MAIN);
+  lv_obj_align(appLauncherTitle, LV_ALIGN_TOP_MID, 0, 14);
+
+  // App list container
+  appLauncherList = lv_obj_create(pages[UI_PAGE_APP_LAUNCHER]);
+  lv_obj_set_size(appLauncherList, 300, 216);
+  lv_obj_align(appLauncherList, LV_ALIGN_TOP_MID, 0, 66);
+  lv_obj_set_style_bg_color(appLauncherList, lv_color_hex(0x000000), LV_PART_MAIN);
+  lv_obj_set_style_border_width(appLauncherList, 1, LV_PART_MAIN);
+  lv_obj_set_style_border_color(appLauncherList, lv_color_hex(0x202020), LV_PART_MAIN);
+  lv_obj_set_style_radius(appLauncherList, 12, LV_PART_MAIN);
+  lv_obj_clear_flag(appLauncherList, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(appLauncherList, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  lv_obj_set_flex_flow(appLauncherList, LV_FLEX_FLOW_COLUMN);
+  lv_obj_set_flex_align(appLauncherList, LV_FLEX_ALIGN_START, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+  lv_obj_set_style_pad_row(appLauncherList, 6, LV_PART_MAIN);
+  lv_obj_set_style_pad_all(appLauncherList, 10, LV_PART_MAIN);
+  attachGestureHandlers(appLauncherList);
+
+  // Status label for launch feedback
+  appLauncherStatusLabel = lv_label_create(pages[UI_PAGE_APP_LAUNCHER]);
+  lv_label_set_text(appLauncherStatusLabel, "Ready");
+  lv_obj_set_style_text_color(appLauncherStatusLabel, lv_color_hex(0xAFAFAF), LV_PART_MAIN);
+  lv_obj_set_style_text_font(appLauncherStatusLabel, &lv_font_montserrat_14, LV_PART_MAIN);
+  lv_obj_align(appLauncherStatusLabel, LV_ALIGN_TOP_MID, 0, 42);
+  lv_obj_add_flag(appLauncherStatusLabel, LV_OBJ_FLAG_HIDDEN);
+
+  // Navigation bar (moved inward for easier tapping on circular screen)
+  lv_obj_t *appNavBar = lv_obj_create(pages[UI_PAGE_APP_LAUNCHER]);
+  lv_obj_set_size(appNavBar, 280, 46);
+  lv_obj_align(appNavBar, LV_ALIGN_BOTTOM_MID, 0, -30);
+  lv_obj_set_style_radius(appNavBar, 14, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(appNavBar, lv_color_hex(0x141414), LV_PART_MAIN);
+  lv_obj_set_style_border_color(appNavBar, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
+  lv_obj_set_style_border_width(appNavBar, 1, LV_PART_MAIN);
+  lv_obj_clear_flag(appNavBar, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(appNavBar, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  attachGestureHandlers(appNavBar);
+
+  appLauncherPrevBtn = lv_btn_create(appNavBar);
+  lv_obj_set_size(appLauncherPrevBtn, 94, 34);
+  lv_obj_align(appLauncherPrevBtn, LV_ALIGN_LEFT_MID, 6, 0);
+  lv_obj_set_style_radius(appLauncherPrevBtn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(appLauncherPrevBtn, lv_color_hex(0x222222), LV_PART_MAIN);
+  lv_obj_add_flag(appLauncherPrevBtn, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  attachGestureHandlers(appLauncherPrevBtn);
+  lv_obj_add_event_cb(appLauncherPrevBtn, appLauncherPageCallback, LV_EVENT_CLICKED, (void*)0);
+  lv_obj_t *prevLabel = lv_label_create(appLauncherPrevBtn);
+  lv_label_set_text(prevLabel, "Prev");
+  lv_obj_center(prevLabel);
+
+  appLauncherPageLabel = lv_label_create(appNavBar);
+  lv_label_set_text(appLauncherPageLabel, "1/1");
+  lv_obj_set_style_text_color(appLauncherPageLabel, lv_color_hex(0xC2C2C2), LV_PART_MAIN);
+  lv_obj_align(appLauncherPageLabel, LV_ALIGN_CENTER, 0, 0);
+
+  appLauncherNextBtn = lv_btn_create(appNavBar);
+  lv_obj_set_size(appLauncherNextBtn, 94, 34);
+  lv_obj_align(appLauncherNextBtn, LV_ALIGN_RIGHT_MID, -6, 0);
+  lv_obj_set_style_radius(appLauncherNextBtn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(appLauncherNextBtn, lv_color_hex(0x222222), LV_PART_MAIN);
+  lv_obj_add_flag(appLauncherNextBtn, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  attachGestureHandlers(appLauncherNextBtn);
+  lv_obj_add_event_cb(appLauncherNextBtn, appLauncherPageCallback, LV_EVENT_CLICKED, (void*)1);
+  lv_obj_t *nextLabel = lv_label_create(appLauncherNextBtn);
+  lv_label_set_text(nextLabel, "Next");
+  lv_obj_center(nextLabel);
+}
+
+// Page 9: Photo Frame (SD)
+static void buildPhotoFramePage() {
+  pages[UI_PAGE_PHOTO_FRAME] = createBasePage();
+
+  lv_obj_t *photoTitle = lv_label_create(pages[UI_PAGE_PHOTO_FRAME]);
+  lv_label_set_text(photoTitle, "Photo Frame (SD)");
+  lv_obj_set_style_text_color(photoTitle, lv_color_hex(0x90CAF9), LV_PART_MAIN);
+  lv_obj_align(photoTitle, LV_ALIGN_TOP_MID, 0, 14);
+
+  photoFrameRootLabel = lv_label_create(pages[UI_PAGE_PHOTO_FRAME]);
+  lv_label_set_text(photoFrameRootLabel, "Root: --");
+  lv_obj_set_width(photoFrameRootLabel, 300);
+  lv_label_set_long_mode(photoFrameRootLabel, LV_LABEL_LONG_DOT);
+  lv_obj_set_style_text_color(photoFrameRootLabel, lv_color_hex(0xAFAFAF), LV_PART_MAIN);
+  lv_obj_align(photoFrameRootLabel, LV_ALIGN_TOP_MID, 0, 36);
+
+  lv_obj_t *photoCard = lv_obj_create(pages[UI_PAGE_PHOTO_FRAME]);
+  lv_obj_set_size(photoCard, 300, 208);
+  lv_obj_align(photoCard, LV_ALIGN_TOP_MID, 0, 58);
+  lv_obj_set_style_radius(photoCard, 12, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(photoCard, lv_color_hex(0x101010), LV_PART_MAIN);
+  lv_obj_set_style_border_color(photoCard, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
+  lv_obj_set_style_border_width(photoCard, 1, LV_PART_MAIN);
+  lv_obj_set_style_pad_all(photoCard, 6, LV_PART_MAIN);
+  lv_obj_clear_flag(photoCard, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(photoCard, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  attachGestureHandlers(photoCard);
+
+  photoFrameViewport = lv_obj_create(photoCard);
+  lv_obj_set_size(photoFrameViewport, 286, 194);
+  lv_obj_center(photoFrameViewport);
+  lv_obj_set_style_radius(photoFrameViewport, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_opa(photoFrameViewport, LV_OPA_TRANSP, LV_PART_MAIN);
+  lv_obj_set_style_border_width(photoFrameViewport, 0, LV_PART_MAIN);
+  lv_obj_set_style_pad_all(photoFrameViewport, 0, LV_PART_MAIN);
+  lv_obj_set_style_clip_corner(photoFrameViewport, true, LV_PART_MAIN);
+  lv_obj_clear_flag(photoFrameViewport, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(photoFrameViewport, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  attachGestureHandlers(photoFrameViewport);
+
+  photoFrameImage = lv_img_create(photoFrameViewport);
+  lv_img_set_src(photoFrameImage, nullptr);
+  lv_obj_center(photoFrameImage);
+
+  photoFrameStatusLabel = lv_label_create(pages[UI_PAGE_PHOTO_FRAME]);
+  lv_label_set_text(photoFrameStatusLabel, "Waiting SD scan...");
+  lv_obj_set_style_text_color(photoFrameStatusLabel, lv_color_hex(0xAFAFAF), LV_PART_MAIN);
+  lv_obj_align(photoFrameStatusLabel, LV_ALIGN_TOP_MID, 0, 266);
+
+  photoFrameNameLabel = lv_label_create(pages[UI_PAGE_PHOTO_FRAME]);
+  lv_label_set_text(photoFrameNameLabel, "--");
+  lv_obj_set_width(photoFrameNameLabel, 280);
+  lv_label_set_long_mode(photoFrameNameLabel, LV_LABEL_LONG_DOT);
+  lv_obj_align(photoFrameNameLabel, LV_ALIGN_TOP_MID, 0, 284);
+
+  lv_obj_t *photoNavBar = lv_obj_create(pages[UI_PAGE_PHOTO_FRAME]);
+  lv_obj_set_size(photoNavBar, 304, 50);
+  lv_obj_align(photoNavBar, LV_ALIGN_TOP_MID, 0, 292);
+  lv_obj_set_style_radius(photoNavBar, 14, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(photoNavBar, lv_color_hex(0x151515), LV_PART_MAIN);
+  lv_obj_set_style_border_color(photoNavBar, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
+  lv_obj_set_style_border_width(photoNavBar, 1, LV_PART_MAIN);
+  lv_obj_set_style_pad_all(photoNavBar, 5, LV_PART_MAIN);
+  lv_obj_clear_flag(photoNavBar, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(photoNavBar, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  attachGestureHandlers(photoNavBar);
+
+  photoFramePrevBtn = lv_btn_create(photoNavBar);
+  lv_obj_set_size(photoFramePrevBtn, 94, 38);
+  lv_obj_align(photoFramePrevBtn, LV_ALIGN_LEFT_MID, 6, 0);
+  lv_obj_set_style_radius(photoFramePrevBtn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(photoFramePrevBtn, lv_color_hex(0x252525), LV_PART_MAIN);
+  lv_obj_add_flag(photoFramePrevBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
+  attachGestureHandlers(photoFramePrevBtn);
+  lv_obj_add_event_cb(photoFramePrevBtn, photoFrameControlCallback, LV_EVENT_CLICKED, (void *)0);
+  lv_obj_t *photoPrevLabel = lv_label_create(photoFramePrevBtn);
+  lv_label_set_text(photoPrevLabel, "Prev");
+  lv_obj_center(photoPrevLabel);
+
+  photoFrameReloadBtn = lv_btn_create(photoNavBar);
+  lv_obj_set_size(photoFrameReloadBtn, 94, 38);
+  lv_obj_align(photoFrameReloadBtn, LV_ALIGN_CENTER, 0, 0);
+  lv_obj_set_style_radius(photoFrameReloadBtn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(photoFrameReloadBtn, lv_color_hex(0x252525), LV_PART_MAIN);
+  lv_obj_add_flag(photoFrameReloadBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
+  attachGestureHandlers(photoFrameReloadBtn);
+  lv_obj_add_event_cb(photoFrameReloadBtn, photoFrameControlCallback, LV_EVENT_CLICKED, (void *)1);
+  lv_obj_t *photoReloadLabel = lv_label_create(photoFrameReloadBtn);
+  lv_label_set_text(photoReloadLabel, "Reload");
+  lv_obj_center(photoReloadLabel);
+
+  photoFrameNextBtn = lv_btn_create(photoNavBar);
+  lv_obj_set_size(photoFrameNextBtn, 94, 38);
+  lv_obj_align(photoFrameNextBtn, LV_ALIGN_RIGHT_MID, -6, 0);
+  lv_obj_set_style_radius(photoFrameNextBtn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(photoFrameNextBtn, lv_color_hex(0x252525), LV_PART_MAIN);
+  lv_obj_add_flag(photoFrameNextBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
+  attachGestureHandlers(photoFrameNextBtn);
+  lv_obj_add_event_cb(photoFrameNextBtn, photoFrameControlCallback, LV_EVENT_CLICKED, (void *)2);
+  lv_obj_t *photoNextLabel = lv_label_create(photoFrameNextBtn);
+  lv_label_set_text(photoNextLabel, "Next");
+  lv_obj_center(photoNextLabel);
+
+  photoFrameIndexLabel = lv_label_create(pages[UI_PAGE_PHOTO_FRAME]);
+  lv_label_set_text(photoFrameIndexLabel, "0/0");
+  lv_obj_set_style_text_color(photoFrameIndexLabel, lv_color_hex(0xBFBFBF), LV_PART_MAIN);
+  lv_obj_align(photoFrameIndexLabel, LV_ALIGN_BOTTOM_MID, 0, -12);
+}
+
+// Page 10: Audio Player (SD)
+static void buildAudioPlayerPage() {
+  pages[UI_PAGE_AUDIO_PLAYER] = createBasePage();
+
+  lv_obj_t *audioTitle = lv_label_create(pages[UI_PAGE_AUDIO_PLAYER]);
+  lv_label_set_text(audioTitle, "Music Player (SD)");
+  lv_obj_set_style_text_color(audioTitle, lv_color_hex(0x90CAF9), LV_PART_MAIN);
+  lv_obj_align(audioTitle, LV_ALIGN_TOP_MID, 0, 14);
+
+  lv_obj_t *audioCard = lv_obj_create(pages[UI_PAGE_AUDIO_PLAYER]);
+  lv_obj_set_size(audioCard, 300, 186);
+  lv_obj_align(audioCard, LV_ALIGN_TOP_MID, 0, 54);
+  lv_obj_set_style_radius(audioCard, 12, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(audioCard, lv_color_hex(0x111111), LV_PART_MAIN);
+  lv_obj_set_style_border_color(audioCard, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
+  lv_obj_set_style_border_width(audioCard, 1, LV_PART_MAIN);
+  lv_obj_set_style_pad_all(audioCard, 8, LV_PART_MAIN);
+  lv_obj_clear_flag(audioCard, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(audioCard, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  attachGestureHandlers(audioCard);
+
+  audioIconLabel = lv_label_create(audioCard);
+  lv_label_set_text(audioIconLabel, LV_SYMBOL_AUDIO);
+  lv_obj_set_style_text_font(audioIconLabel, &lv_font_montserrat_32, LV_PART_MAIN);
+  lv_obj_set_style_text_color(audioIconLabel, lv_color_hex(0xB39DDB), LV_PART_MAIN);
+  lv_obj_align(audioIconLabel, LV_ALIGN_TOP_MID, 0, 2);
+
+  // Takes the icon's place while something is playing.
+  // Kept across page rebuilds.
+  if (spectrumCanvasBuf == nullptr) {
+    spectrumCanvasBuf = (lv_color_t *)heap_caps_malloc(
+      (size_t)SPECTRUM_VIEW_W * SPECTRUM_VIEW_H * sizeof(lv_color_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  }
+  if (spectrumCanvasBuf != nullptr) {
+    spectrumCanvas = lv_canvas_create(audioCard);
+    lv_canvas_set_buffer(spectrumCanvas, spectrumCanvasBuf, SPECTRUM_VIEW_W, SPECTRUM_VIEW_H, LV_IMG_CF_TRUE_COLOR);
+    lv_obj_align(spectrumCanvas, LV_ALIGN_TOP_MID, 0, 0);
+    lv_obj_add_flag(spectrumCanvas, LV_OBJ_FLAG_HIDDEN);
+    for (lv_coord_t y = 0; y < SPECTRUM_BAR_H; ++y) {
+      spectrumRowColor[y] = lv_color_mix(lv_color_hex(0xB39DDB), lv_color_hex(0x4FC3F7), (uint8_t)(255 * (SPECTRUM_BAR_H - 1 - y) / (SPECTRUM_BAR_H - 1)));
+    }
+  }
+
+  audioTrackLabel = lv_label_create(audioCard);
+  lv_label_set_text(audioTrackLabel, "Scanning SD...");
+  lv_obj_set_width(audioTrackLabel, 260);
+  lv_label_set_long_mode(audioTrackLabel, LV_LABEL_LONG_SCROLL_CIRCULAR);
+  lv_obj_set_style_text_font(audioTrackLabel, &lv_font_montserrat_16, LV_PART_MAIN);
+  lv_obj_set_style_text_align(audioTrackLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
+  lv_obj_align(audioTrackLabel, LV_ALIGN_TOP_MID, 0, 56);
+
+  audioTimeLabel = lv_label_create(audioCard);
+  lv_label_set_text(audioTimeLabel, "00:00 / --:--");
+  lv_obj_set_style_text_font(audioTimeLabel, &lv_font_montserrat_14, LV_PART_MAIN);
+  lv_obj_set_style_text_color(audioTimeLabel, lv_color_hex(0xC5CAE9), LV_PART_MAIN);
+  lv_obj_set_style_text_align(audioTimeLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
+  lv_obj_align(audioTimeLabel, LV_ALIGN_TOP_MID, 0, 86);
+
+  // No gesture handlers: a horizontal drag here scrubs, it must not swipe pages.
+  audioSeekSlider = lv_slider_create(audioCard);
+  lv_obj_set_size(audioSeekSlider, 236, 8);
+  lv_obj_align(audioSeekSlider, LV_ALIGN_TOP_MID, 0, 112);
+  lv_slider_set_range(audioSeekSlider, 0, 1000);
+  lv_obj_set_ext_click_area(audioSeekSlider, 12);
+  lv_obj_add_state(audioSeekSlider, LV_STATE_DISABLED);
+  lv_obj_add_event_cb(audioSeekSlider, audioSeekSliderCallback, LV_EVENT_PRESSED, nullptr);
+  lv_obj_add_event_cb(audioSeekSlider, audioSeekSliderCallback, LV_EVENT_RELEASED, nullptr);
+  lv_obj_add_event_cb(audioSeekSlider, audioSeekSliderCallback, LV_EVENT_PRESS_LOST, nullptr);
+
+  audioIndexLabel = lv_label_create(audioCard);
+  lv_label_set_text(audioIndexLabel, "0/0");
+  lv_obj_set_style_text_color(audioIndexLabel, lv_color_hex(0xBDBDBD), LV_PART_MAIN);
+  lv_obj_align(audioIndexLabel, LV_ALIGN_BOTTOM_MID, 0, -10);
+
+  lv_obj_t *audioRescanBtn = lv_btn_create(audioCard);
+  lv_obj_set_size(audioRescanBtn, 86, 32);
+  lv_obj_align(audioRescanBtn, LV_ALIGN_BOTTOM_RIGHT, -6, -6);
+  lv_obj_set_style_radius(audioRescanBtn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(audioRescanBtn, lv_color_hex(0x252525), LV_PART_MAIN);
+  lv_obj_add_flag(audioRescanBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
+  attachGestureHandlers(audioRescanBtn);
+  lv_obj_add_event_cb(audioRescanBtn, audioControlCallback, LV_EVENT_CLICKED, (void *)3);
+  lv_obj_t *audioRescanLabel = lv_label_create(audioRescanBtn);
+  lv_label_set_text(audioRescanLabel, "Rescan");
+  lv_obj_center(audioRescanLabel);
+
+  audioStatusLabel = lv_label_create(pages[UI_PAGE_AUDIO_PLAYER]);
+  lv_label_set_text(audioStatusLabel, "Ready");
+  lv_obj_set_style_text_color(audioStatusLabel, lv_color_hex(0x90CAF9), LV_PART_MAIN);
+  lv_obj_align(audioStatusLabel, LV_ALIGN_TOP_MID, 0, 248);
+
+  lv_obj_t *audioNavBar = lv_obj_create(pages[UI_PAGE_AUDIO_PLAYER]);
+  lv_obj_set_size(audioNavBar, 304, 50);
+  lv_obj_align(audioNavBar, LV_ALIGN_TOP_MID, 0, 292);
+  lv_obj_set_style_radius(audioNavBar, 14, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(audioNavBar, lv_color_hex(0x151515), LV_PART_MAIN);
+  lv_obj_set_style_border_color(audioNavBar, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
+  lv_obj_set_style_border_width(audioNavBar, 1, LV_PART_MAIN);
+  lv_obj_set_style_pad_all(audioNavBar, 5, LV_PART_MAIN);
+  lv_obj_clear_flag(audioNavBar, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(audioNavBar, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  attachGestureHandlers(audioNavBar);
+
+  audioPrevBtn = lv_btn_create(audioNavBar);
+  lv_obj_set_size(audioPrevBtn, 94, 38);
+  lv_obj_align(audioPrevBtn, LV_ALIGN_LEFT_MID, 6, 0);
+  lv_obj_set_style_radius(audioPrevBtn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(audioPrevBtn, lv_color_hex(0x252525), LV_PART_MAIN);
+  lv_obj_add_flag(audioPrevBtn, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  attachGestureHandlers(audioPrevBtn);
+  lv_obj_add_event_cb(audioPrevBtn, audioControlCallback, LV_EVENT_CLICKED, (void *)0);
+  lv_obj_t *audioPrevLabel = lv_label_create(audioPrevBtn);
+  lv_label_set_text(audioPrevLabel, "Prev");
+  lv_obj_center(audioPrevLabel);
+
+  audioPlayBtn = lv_btn_create(audioNavBar);
+  lv_obj_set_size(audioPlayBtn, 94, 38);
+  lv_obj_align(audioPlayBtn, LV_ALIGN_CENTER, 0, 0);
+  lv_obj_set_style_radius(audioPlayBtn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(audioPlayBtn, lv_color_hex(0x2E7D32), LV_PART_MAIN);
+  lv_obj_set_style_bg_color(audioPlayBtn, lv_color_hex(0x1B5E20), LV_PART_MAIN | LV_STATE_PRESSED);
+  lv_obj_add_flag(audioPlayBtn, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  attachGestureHandlers(audioPlayBtn);
+  lv_obj_add_event_cb(audioPlayBtn, audioControlCallback, LV_EVENT_CLICKED, (void *)1);
+  audioPlayBtnLabel = lv_label_create(audioPlayBtn);
+  lv_label_set_text(audioPlayBtnLabel, "Play");
+  lv_obj_center(audioPlayBtnLabel);
+
+  audioNextBtn = lv_btn_create(audioNavBar);
+  lv_obj_set_size(audioNextBtn, 94, 38);
+  lv_obj_align(audioNextBtn, LV_ALIGN_RIGHT_MID, -6, 0);
+  lv_obj_set_style_radius(audioNextBtn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(audioNextBtn, lv_color_hex(0x252525), LV_PART_MAIN);
+  lv_obj_add_flag(audioNextBtn, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  attachGestureHandlers(audioNextBtn);
+  lv_obj_add_event_cb(audioNextBtn, audioControlCallback, LV_EVENT_CLICKED, (void *)2);
+  lv_obj_t *audioNextLabel = lv_label_create(audioNextBtn);
+  lv_label_set_text(audioNextLabel, "Next");
+  lv_obj_center(audioNextLabel);
+
+  updateAudioControlButtons(false, false);
+}
+
+// Page 11: Video Player (SD, MJPEG MVP)
+static void buildVideoPlayerPage() {
+  pages[UI_PAGE_VIDEO_PLAYER] = createBasePage();
+
+  lv_obj_t *videoTitle = lv_label_create(pages[UI_PAGE_VIDEO_PLAYER]);
+  lv_label_set_text(videoTitle, "Video Player (SD)");
+  lv_obj_set_style_text_color(videoTitle, lv_color_hex(0x90CAF9), LV_PART_MAIN);
+  lv_obj_align(videoTitle, LV_ALIGN_TOP_MID, 0, 14);
+
+  lv_obj_t *videoCard = lv_obj_create(pages[UI_PAGE_VIDEO_PLAYER]);
+  lv_obj_set_size(videoCard, 300, 196);
+  lv_obj_align(videoCard, LV_ALIGN_TOP_MID, 0, 54);
+  lv_obj_set_style_radius(videoCard, 12, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(videoCard, lv_color_hex(0x101010), LV_PART_MAIN);
+  lv_obj_set_style_border_color(videoCard, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
+  lv_obj_set_style_border_width(videoCard, 1, LV_PART_MAIN);
+  lv_obj_set_style_pad_all(videoCard, 6, LV_PART_MAIN);
+  lv_obj_clear_flag(videoCard, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(videoCard, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  attachGestureHandlers(videoCard);
+
+  videoViewport = lv_obj_create(videoCard);
+  lv_obj_set_size(videoViewport, 286, 148);
+  lv_obj_align(videoViewport, LV_ALIGN_TOP_MID, 0, 2);
+  lv_obj_set_style_radius(videoViewport, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(videoViewport, lv_color_hex(0x050505), LV_PART_MAIN);
+  lv_obj_set_style_border_color(videoViewport, lv_color_hex(0x202020), LV_PART_MAIN);
+  lv_obj_set_style_border_width(videoViewport, 1, LV_PART_MAIN);
+  lv_obj_set_style_pad_all(videoViewport, 0, LV_PART_MAIN);
+  lv_obj_set_style_clip_corner(videoViewport, true, LV_PART_MAIN);
+  lv_obj_clear_flag(videoViewport, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(videoViewport, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  attachGestureHandlers(videoViewport);
+
+  videoImage = lv_img_create(videoViewport);
+  lv_img_set_src(videoImage, nullptr);
+  lv_obj_center(videoImage);
+
+  videoTrackLabel = lv_label_create(videoCard);
+  lv_label_set_text(videoTrackLabel, "Scanning SD...");
+  lv_obj_set_width(videoTrackLabel, 276);
+  lv_label_set_long_mode(videoTrackLabel, LV_LABEL_LONG_SCROLL_CIRCULAR);
+  lv_obj_set_style_text_font(videoTrackLabel, &lv_font_montserrat_14, LV_PART_MAIN);
+  lv_obj_set_style_text_align(videoTrackLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
+  lv_obj_align(videoTrackLabel, LV_ALIGN_TOP_MID, 0, 154);
+
+  videoHintLabel = lv_label_create(videoCard);
+  lv_label_set_text(videoHintLabel, "MJPEG only (.mjpeg/.mjpg)");
+  lv_obj_set_style_text_color(videoHintLabel, lv_color_hex(0xAFAFAF), LV_PART_MAIN);
+  lv_obj_set_style_text_font(videoHintLabel, &lv_font_montserrat_14, LV_PART_MAIN);
+  lv_obj_set_width(videoHintLabel, 276);
+  lv_obj_set_style_text_align(videoHintLabel, LV_TEXT_ALIGN_CENTER, LV_PART_MAIN);
+  lv_obj_align(videoHintLabel, LV_ALIGN_TOP_MID, 0, 172);
+
+  lv_obj_t *videoRescanBtn = lv_btn_create(videoCard);
+  lv_obj_set_size(videoRescanBtn, 74, 28);
+  lv_obj_align(videoRescanBtn, LV_ALIGN_TOP_RIGHT, -8, 8);
+  lv_obj_set_style_radius(videoRescanBtn, 8, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(videoRescanBtn, lv_color_hex(0x252525), LV_PART_MAIN);
+  lv_obj_add_flag(videoRescanBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
+  attachGestureHandlers(videoRescanBtn);
+  lv_obj_add_event_cb(videoRescanBtn, videoControlCallback, LV_EVENT_CLICKED, (void *)VIDEO_CONTROL_RESCAN);
+  lv_obj_t *videoRescanLabel = lv_label_create(videoRescanBtn);
+  lv_label_set_text(videoRescanLabel, "Rescan");
+  lv_obj_set_style_text_font(videoRescanLabel, &lv_font_montserrat_14, LV_PART_MAIN);
+  lv_obj_center(videoRescanLabel);
+
+  videoStatusLabel = lv_label_create(pages[UI_PAGE_VIDEO_PLAYER]);
+  lv_label_set_text(videoStatusLabel, "Ready");
+  lv_obj_set_style_text_color(videoStatusLabel, lv_color_hex(0x90CAF9), LV_PART_MAIN);
+  lv_obj_align(videoStatusLabel, LV_ALIGN_TOP_MID, 0, 252);
+
+  lv_obj_t *videoNavBar = lv_obj_create(pages[UI_PAGE_VIDEO_PLAYER]);
+  lv_obj_set_size(videoNavBar, 304, 50);
+  lv_obj_align(videoNavBar, LV_ALIGN_TOP_MID, 0, 292);
+  lv_obj_set_style_radius(videoNavBar, 14, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(videoNavBar, lv_color_hex(0x151515), LV_PART_MAIN);
+  lv_obj_set_style_border_color(videoNavBar, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
+  lv_obj_set_style_border_width(videoNavBar, 1, LV_PART_MAIN);
+  lv_obj_set_style_pad_all(videoNavBar, 5, LV_PART_MAIN);
+  lv_obj_clear_flag(videoNavBar, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(videoNavBar, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  attachGestureHandlers(videoNavBar);
+
+  videoPrevBtn = lv_btn_create(videoNavBar);
+  lv_obj_set_size(videoPrevBtn, 94, 38);
+  lv_obj_align(videoPrevBtn, LV_ALIGN_LEFT_MID, 6, 0);
+  lv_obj_set_style_radius(videoPrevBtn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(videoPrevBtn, lv_color_hex(0x252525), LV_PART_MAIN);
+  lv_obj_add_flag(videoPrevBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
+  attachGestureHandlers(videoPrevBtn);
+  lv_obj_add_event_cb(videoPrevBtn, videoControlCallback, LV_EVENT_CLICKED, (void *)VIDEO_CONTROL_PREV);
+  lv_obj_t *videoPrevLabel = lv_label_create(videoPrevBtn);
+  lv_label_set_text(videoPrevLabel, "Prev");
+  lv_obj_center(videoPrevLabel);
+
+  videoPlayBtn = lv_btn_create(videoNavBar);
+  lv_obj_set_size(videoPlayBtn, 94, 38);
+  lv_obj_align(videoPlayBtn, LV_ALIGN_CENTER, 0, 0);
+  lv_obj_set_style_radius(videoPlayBtn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(videoPlayBtn, lv_color_hex(0x2E7D32), LV_PART_MAIN);
+  lv_obj_set_style_bg_color(videoPlayBtn, lv_color_hex(0x1B5E20), LV_PART_MAIN | LV_STATE_PRESSED);
+  lv_obj_add_flag(videoPlayBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
+  attachGestureHandlers(videoPlayBtn);
+  lv_obj_add_event_cb(videoPlayBtn, videoControlCallback, LV_EVENT_CLICKED, (void *)VIDEO_CONTROL_TOGGLE);
+  videoPlayBtnLabel = lv_label_create(videoPlayBtn);
+  lv_label_set_text(videoPlayBtnLabel, "Play");
+  lv_obj_center(videoPlayBtnLabel);
+
+  videoNextBtn = lv_btn_create(videoNavBar);
+  lv_obj_set_size(videoNextBtn, 94, 38);
+  lv_obj_align(videoNextBtn, LV_ALIGN_RIGHT_MID, -6, 0);
+  lv_obj_set_style_radius(videoNextBtn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(videoNextBtn, lv_color_hex(0x252525), LV_PART_MAIN);
+  lv_obj_add_flag(videoNextBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
+  attachGestureHandlers(videoNextBtn);
+  lv_obj_add_event_cb(videoNextBtn, videoControlCallback, LV_EVENT_CLICKED, (void *)VIDEO_CONTROL_NEXT);
+  lv_obj_t *videoNextLabel = lv_label_create(videoNextBtn);
+  lv_label_set_text(videoNextLabel, "Next");
+  lv_obj_center(videoNextLabel);
+
+  videoIndexLabel = lv_label_create(pages[UI_PAGE_VIDEO_PLAYER]);
+  lv_label_set_text(videoIndexLabel, "0/0");
+  lv_obj_set_style_text_color(videoIndexLabel, lv_color_hex(0xBFBFBF), LV_PART_MAIN);
+  lv_obj_align(videoIndexLabel, LV_ALIGN_BOTTOM_MID, 0, -12);
+
+  updateVideoControlButtons(false);
+}
+
+// Page 12: Voice Commands (phase-1 bridge)
+static void buildVoicePage() {
+  pages[UI_PAGE_VOICE] = createBasePage();
+
+  lv_obj_t *voiceTitle = lv_label_create(pages[UI_PAGE_VOICE]);
+  lv_label_set_text(voiceTitle, "Voice Commands");
+  lv_obj_set_style_text_color(voiceTitle, lv_color_hex(0x80CBC4), LV_PART_MAIN);
+  lv_obj_align(voiceTitle, LV_ALIGN_TOP_MID, 0, 14);
+
+  lv_obj_t *voiceHint = lv_label_create(pages[UI_PAGE_VOICE]);
+  lv_label_set_text(voiceHint, "Preset commands + live mic stream");
+  lv_obj_set_style_text_color(voiceHint, lv_color_hex(0xB0BEC5), LV_PART_MAIN);
+  lv_obj_set_style_text_font(voiceHint, &lv_font_montserrat_14, LV_PART_MAIN);
+  lv_obj_align(voiceHint, LV_ALIGN_TOP_MID, 0, 38);
+
+  lv_obj_t *voiceCard = lv_obj_create(pages[UI_PAGE_VOICE]);
+  lv_obj_set_size(voiceCard, 312, 236);
+  lv_obj_align(voiceCard, LV_ALIGN_TOP_MID, 0, 66);
+  lv_obj_set_style_radius(voiceCard, 14, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(voiceCard, lv_color_hex(0x111111), LV_PART_MAIN);
+  lv_obj_set_style_border_color(voiceCard, lv_color_hex(0x2A2A2A), LV_PART_MAIN);
+  lv_obj_set_style_border_width(voiceCard, 1, LV_PART_MAIN);
+  lv_obj_clear_flag(voiceCard, LV_OBJ_FLAG_SCROLLABLE);
+  lv_obj_add_flag(voiceCard, LV_OBJ_FLAG_GESTURE_BUBBLE);
+  attachGestureHandlers(voiceCard);
+
+  const int buttonW = 140;
+  const int buttonH = 42;
+  const int startX = 10;
+  const int startY = 12;
+  const int gapX = 12;
+  const int gapY = 12;
+  for (int i = 0; i < (int)(sizeof(VOICE_PRESET_COMMANDS) / sizeof(VOICE_PRESET_COMMANDS[0])); ++i) {
+    int row = i / 2;
+    int col = i % 2;
+    lv_obj_t *btn = lv_btn_create(voiceCard);
+    lv_obj_set_size(btn, buttonW, buttonH);
+    lv_obj_set_pos(btn, startX + col * (buttonW + gapX), startY + row * (buttonH + gapY));
+    lv_obj_set_style_radius(btn, 10, LV_PART_MAIN);
+    lv_obj_set_style_bg_color(btn, lv_color_hex(0x1F2A44), LV_PART_MAIN);
+    lv_obj_set_style_bg_color(btn, lv_color_hex(0x263859), LV_PART_MAIN | LV_STATE_PRESSED);
+    lv_obj_add_flag(btn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
+    attachGestureHandlers(btn);
+    lv_obj_add_event_cb(btn, voiceCommandButtonCallback, LV_EVENT_CLICKED, (void *)((intptr_t)i));
+
+    lv_obj_t *label = lv_label_create(btn);
+    lv_label_set_text(label, VOICE_PRESET_COMMANDS[i].label);
+    lv_obj_set_style_text_color(label, lv_color_hex(0xE3F2FD), LV_PART_MAIN);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_16, LV_PART_MAIN);
+    lv_obj_center(label);
+  }
+
+  voiceMicToggleBtn = lv_btn_create(voiceCard);
+  lv_obj_set_size(voiceMicToggleBtn, 108, 38);
+  lv_obj_align(voiceMicToggleBtn, LV_ALIGN_BOTTOM_RIGHT, -10, -8);
+  lv_obj_set_style_radius(voiceMicToggleBtn, 10, LV_PART_MAIN);
+  lv_obj_set_style_bg_color(voiceMicToggleBtn, lv_color_hex(0x00695C), LV_PART_MAIN);
+  lv_obj_set_style_bg_color(voiceMicToggleBtn, lv_color_hex(0x00796B), LV_PART_MAIN | LV_STATE_PRESSED);
+  lv_obj_add_flag(voiceMicToggleBtn, LV_OBJ_FLAG_GESTURE_BUBBLE | LV_OBJ_FLAG_PRESS_LOCK);
+  attachGestureHandlers(voiceMicToggleBtn);
+  lv_obj_add_event_cb(voiceMicToggleBtn, voiceMicToggleCallback, LV_EVENT_CLICKED, nullptr);
+
+  voiceMicToggleLabel = lv_label_create(voiceMicToggleBtn);
+  lv_label_set_text(voiceMicToggleLabel, "Start Mic");
+  lv_obj_set_style_text_font(voiceMicToggleLabel, &lv_font_montserrat_16, LV_PART_MAIN);
+  lv_obj_center(voiceMicToggleLabel);
+
+  voiceStatusLabel = lv_label_create(voiceCard);
+  lv_label_set_text(voiceStatusLabel, "Ready");
+  lv_obj_set_style_text_color(voiceStatusLabel, lv_color_hex(0x80CBC4), LV_PART_MAIN);
+  lv_obj_set_style_text_font(voiceStatusLabel, &lv_font_montserrat_14, LV_PART_MAIN);
+  lv_obj_align(voiceStatusLabel, LV_ALIGN_BOTTOM_LEFT, 10, -56);
+
+  voiceResultLabel = lv_label_create(voiceCard);
+  lv_label_set_text(voiceResultLabel, "Result: --");
+  lv_obj_set_width(voiceResultLabel, 176);
+  lv_label_set_long_mode(voiceResultLabel, LV_LABEL_LONG_DOT);
+  lv_obj_set_style_text_color(voiceResultLabel, lv_color_hex(0xCFD8DC), LV_PART_MAIN);
+  lv_obj_set_style_text_font(voiceResultLabel, &lv_font_montserrat_14, LV_PART_MAIN);
+  lv_obj_align(voiceResultLabel, LV_ALIGN_BOTTOM_LEFT, 10, -30);
+}
+
+static void syncHomePage() {
+  updateClockDisplay();
+}
+
+static void syncMonitorPage() {
+  if (uiLastStats.valid) {
+    setStats(uiLastStats.cpu, uiLastStats.memory, uiLastStats.upload, uiLastStats.download);
+  }
+  if (wifiStatusText.length() > 0) {
+    setWifiStatus(wifiStatusText);
+  }
+  if (wsStatusText.length() > 0) {
+    setWsStatus(wsStatusText);
+  }
+}
+
+static void syncClockPage() {
+  updateClockDisplay();
+}
+
+static void syncSettingsPage() {
+  applyBrightness(screenBrightness, false);
+  if (wifiStatusText.length() > 0) {
+    setWifiStatus(wifiStatusText);
+  }
+  if (wsStatusText.length() > 0) {
+    setWsStatus(wsStatusText);
+  }
+  if (actionStatusText.length() > 0) {
+    setActionStatus(actionStatusText);
+  }
+  updateDiagnosticStatus();
+}
+
+static void syncPomodoroPage() {
+  updatePomodoroDisplay();
+}
+
+static void syncPhotoFramePage() {
+  applyStatusText(photoFrameStatusLabel, photoFrameStatusText);
+  updatePhotoFrameNavButtons();
+}
+
+static void syncAudioPlayerPage() {
+  applyStatusText(audioStatusLabel, audioStatusText);
+  refreshAudioTimeLabel(true);
+}
+
+static void syncVideoPlayerPage() {
+  applyStatusText(videoStatusLabel, videoStatusText);
+}
+
+static void syncVoicePage() {
+  if (voiceMicToggleLabel != nullptr) {
+    lv_label_set_text(voiceMicToggleLabel, voiceMicStreaming ? "Stop Mic" : "Start Mic");
+  }
+}
+
+// Release hooks run before the page object is deleted: they detach anything
+// still drawing into the page and clear its widget pointers, which every
+// updater already treats as "page not built".
+static void releasePhotoFramePage() {
+  photoFrameViewport = nullptr;
+  photoFrameImage = nullptr;
+  photoFrameNameLabel = nullptr;
+  photoFrameIndexLabel = nullptr;
+  photoFrameRootLabel = nullptr;
+  photoFrameStatusLabel = nullptr;
+  photoFramePrevBtn = nullptr;
+  photoFrameNextBtn = nullptr;
+  photoFrameReloadBtn = nullptr;
+  releasePhotoFrameMedia();
+  lv_img_cache_invalidate_src(nullptr);
+}
+
+static void releaseAudioPlayerPage() {
+  setSpectrumVisible(false);
+  spectrumCanvas = nullptr;
+  audioIconLabel = nullptr;
+  audioTrackLabel = nullptr;
+  audioIndexLabel = nullptr;
+  audioTimeLabel = nullptr;
+  audioStatusLabel = nullptr;
+  audioSeekSlider = nullptr;
+  audioPrevBtn = nullptr;
+  audioPlayBtn = nullptr;
+  audioPlayBtnLabel = nullptr;
+  audioNextBtn = nullptr;
+}
+
+static void releaseVideoPlayerPage() {
+  releaseVideoPlayerMedia();
+  videoViewport = nullptr;
+  videoImage = nullptr;
+  videoHintLabel = nullptr;
+  videoTrackLabel = nullptr;
+  videoIndexLabel = nullptr;
+  videoStatusLabel = nullptr;
+  videoPrevBtn = nullptr;
+  videoPlayBtn = nullptr;
+  videoPlayBtnLabel = nullptr;
+  videoNextBtn = nullptr;
+  lv_img_cache_invalidate_src(nullptr);
+}
+
+// Pages are built the first time they are shown. Pages with a release hook
+// are deleted again when left; whatever they display lives outside their
+// widgets and is pushed back in by sync whenever the page is shown.
+struct UiPageSpec {
+  const char *name;
+  void (*build)();
+  void (*sync)();
+  void (*release)();
+};
+
+static const UiPageSpec UI_PAGE_SPECS[UI_PAGE_COUNT] = {
+  {"home", buildHomePage, syncHomePage, nullptr},
+  {"monitor", buildMonitorPage, syncMonitorPage, nullptr},
+  {"clock", buildClockPage, syncClockPage, nullptr},
+  {"settings", buildSettingsPage, syncSettingsPage, nullptr},
+  {"inbox", buildInboxPage, refreshInboxView, nullptr},
+  {"pomodoro", buildPomodoroPage, syncPomodoroPage, nullptr},
+  {"weather", buildWeatherPage, updateWeatherDisplay, nullptr},
+  {"apps", buildAppLauncherPage, updateAppLauncherDisplay, nullptr},
+  {"photo", buildPhotoFramePage, syncPhotoFramePage, releasePhotoFramePage},
+  {"audio", buildAudioPlayerPage, syncAudioPlayerPage, releaseAudioPlayerPage},
+  {"video", buildVideoPlayerPage, syncVideoPlayerPage, releaseVideoPlayerPage},
+  {"voice", buildVoicePage, syncVoicePage, nullptr},
+};
+
+// Set to false to keep every page resident once built.
+static constexpr bool UI_RELEASE_HEAVY_PAGES = true;
+
+struct UiPageStats {
+  uint32_t buildUs = 0;
+  int32_t heapBytes = 0;      // LVGL objects, styles and buffers of the page (PSRAM + internal)
+  int32_t internalBytes = 0;
+  uint16_t builds = 0;
+};
+static UiPageStats uiPageStats[UI_PAGE_COUNT];
+
+static void ensurePageBuilt(int pageIndex) {
+  if (pageIndex < 0 || pageIndex >= UI_PAGE_COUNT || pages[pageIndex] != nullptr) {
+    return;
+  }
+
+  const UiPageSpec &spec = UI_PAGE_SPECS[pageIndex];
+  const size_t freeBefore = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  const size_t internalBefore = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  const uint32_t startUs = micros();
+  spec.build();
+  if (pages[pageIndex] == nullptr) {
+    Serial.printf("[UI] page %s build failed\n", spec.name);
+    return;
+  }
+  lv_obj_add_flag(pages[pageIndex], LV_OBJ_FLAG_HIDDEN);
+  if (pageIndicatorLabel != nullptr) {
+    lv_obj_move_foreground(pageIndicatorLabel);
+  }
+
+  UiPageStats &stats = uiPageStats[pageIndex];
+  stats.buildUs = micros() - startUs;
+  stats.heapBytes = (int32_t)freeBefore - (int32_t)heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  stats.internalBytes = (int32_t)internalBefore - (int32_t)heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  stats.builds++;
+  Serial.printf("[UI] page %s built in %lu.%lu ms, heap %ld B (internal %ld B), build #%u\n",
+                spec.name,
+                (unsigned long)(stats.buildUs / 1000),
+                (unsigned long)(stats.buildUs % 1000 / 100),
+                (long)stats.heapBytes,
+                (long)stats.internalBytes,
+                (unsigned)stats.builds);
+}
+
+// Bound widgets skip writes while their page is hidden, so a page is brought
+// up to date each time it is shown.
+static void syncPage(int pageIndex) {
+  if (pageIndex < 0 || pageIndex >= UI_PAGE_COUNT || pages[pageIndex] == nullptr) {
+    return;
+  }
+  if (UI_PAGE_SPECS[pageIndex].sync != nullptr) {
+    UI_PAGE_SPECS[pageIndex].sync();
+  }
+}
+
+static void releasePage(int pageIndex) {
+  if (!UI_RELEASE_HEAVY_PAGES || pageIndex < 0 || pageIndex >= UI_PAGE_COUNT || pages[pageIndex] == nullptr) {
+    return;
+  }
+  const UiPageSpec &spec = UI_PAGE_SPECS[pageIndex];
+  if (spec.release == nullptr) {
+    return;
+  }
+
+  lv_obj_t *page = pages[pageIndex];
+  spec.release();
+  pages[pageIndex] = nullptr;
+  // showPage() can run from an event of one of this page's own widgets
+  // (swipe home), so the delete has to wait until the event returns.
+  lv_obj_del_async(page);
+  Serial.printf("[UI] page %s released (~%ld B)\n", spec.name, (long)uiPageStats[pageIndex].heapBytes);
+}
+
+static uint32_t uiResidentPageCount() {
+  uint32_t count = 0;
+  for (int i = 0; i < UI_PAGE_COUNT; ++i) {
+    if (pages[i] != nullptr) {
+      ++count;
+    }
+  }
+  return count;
+}
+
+static int32_t uiResidentPageBytes() {
+  int32_t bytes = 0;
+  for (int i = 0; i < UI_PAGE_COUNT; ++i) {
+    if (pages[i] != nullptr) {
+      bytes += uiPageStats[i].heapBytes;
+    }
+  }
+  return bytes;
+}
+
+static void createUi() {
+  lv_obj_set_style_bg_color(lv_scr_act(), lv_color_hex(0x000000), LV_PART_MAIN);
+  lv_obj_set_style_text_color(lv_scr_act(), lv_color_hex(0xFFFFFF), LV_PART_MAIN);
+  lv_obj_set_style_text_font(lv_scr_act(), uiTextFont(14), LV_PART_MAIN);
+
+  // Global page indicator
+  pageIndicatorLabel = lv_label_create(lv_scr_act());
+  lv_obj_set_style_text_color(pageIndicatorLabel, lv_color_hex(0x8F8F8F), LV_PART_MAIN);
+  lv_obj_align(pageIndicatorLabel, LV_ALIGN_BOTTOM_MID, 0, -10);
+
+  lv_obj_move_foreground(pageIndicatorLabel);
+  showPage(UI_PAGE_HOME);
+  applyBrightness(screenBrightness, false);
+  updateDiagnosticStatus();
+  refreshInboxView();
+  updateClockDisplay();
+  lv_timer_create(clockTimerCallback, 1000, nullptr);
+  clockSweepTimer = lv_timer_create(clockSweepTimerCallback, CLOCK_SWEEP_PERIODS_MS[0], nullptr);
+  lv_timer_create(diagnosticsTimerCallback, 1000, nullptr);
+  lv_timer_create(pomodoroTimerCallback, 100, nullptr);
+  lv_timer_create(weatherTimerCallback, 60000, nullptr); // Check every minute
+
+  // Initialize weather display
+  updateWeatherDisplay();
+}
+
+#endif
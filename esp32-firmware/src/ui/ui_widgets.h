@@ -0,0 +1,328 @@
+#ifndef _UI_WIDGETS_H_
+#define _UI_WIDGETS_H_
+
+#include <Arduino.h>
+#include <lvgl.h>
+#include <stdint.h>
+#include "audio/spectrum.h"
+#include "display/clock_face.h"
+
+// Page indices, navigation state and the widget handles of every page, and
+// the types and text the pages show. The builders in ui/ui_pages.h fill the
+// handles in; a pointer left nullptr means its page is not built, which every
+// updater checks before writing.
+enum UiPage {
+  UI_PAGE_HOME = 0,
+  UI_PAGE_MONITOR = 1,
+  UI_PAGE_CLOCK = 2,
+  UI_PAGE_SETTINGS = 3,
+  UI_PAGE_INBOX = 4,
+  UI_PAGE_POMODORO = 5,
+  UI_PAGE_WEATHER = 6,
+  UI_PAGE_APP_LAUNCHER = 7,
+  UI_PAGE_PHOTO_FRAME = 8,
+  UI_PAGE_AUDIO_PLAYER = 9,
+  UI_PAGE_VIDEO_PLAYER = 10,
+  UI_PAGE_VOICE = 11,
+  UI_PAGE_COUNT = 12
+};
+
+struct TouchGestureState {
+  bool pressed = false;
+  bool longPressHandled = false;
+  lv_point_t startPoint = {0, 0};
+  uint32_t startMs = 0;
+};
+
+static constexpr uint32_t LONG_PRESS_MS = 800;
+static constexpr int16_t SWIPE_HOME_THRESHOLD = 60;
+static constexpr int16_t SWIPE_HOME_DIRECTION_MARGIN = 12;
+static constexpr int16_t SWIPE_HOME_MAX_X_DRIFT = 120;
+static constexpr uint32_t CLICK_SUPPRESS_MS_AFTER_HOME = 320;
+static constexpr uint32_t CLICK_SUPPRESS_MS_AFTER_CAROUSEL = 220;
+static constexpr int16_t HOME_CAROUSEL_SWIPE_THRESHOLD = 42;
+static constexpr int16_t HOME_CAROUSEL_DIRECTION_MARGIN = 12;
+static constexpr float HOME_DEG_TO_RAD = 0.01745329252f;
+static constexpr uint32_t DYNAMIC_WALLPAPER_TOUCH_PAUSE_MS = 1200;
+static uint32_t suppressClickUntilMs = 0;
+
+static lv_obj_t *pages[UI_PAGE_COUNT] = {nullptr};
+static int currentPage = UI_PAGE_HOME;
+static TouchGestureState gestureState;
+
+static lv_obj_t *pageIndicatorLabel = nullptr;
+
+static lv_obj_t *homeWifiLabel = nullptr;
+static lv_obj_t *homeWsLabel = nullptr;
+static lv_obj_t *homeClockLabel = nullptr;
+static lv_obj_t *homeDateLabel = nullptr;
+
+struct HomeShortcutConfig {
+  const char *label;
+  const char *icon;
+  uint8_t iconKind;
+  UiPage page;
+  uint32_t accentColor;
+};
+
+enum HomeIconKind : uint8_t {
+  HOME_ICON_SYMBOL = 0,
+  HOME_ICON_MONITOR = 1,
+  HOME_ICON_POMODORO = 2,
+  HOME_ICON_CLOCK = 3,
+  HOME_ICON_WEATHER = 4,
+  HOME_ICON_APPS = 5
+};
+
+static const HomeShortcutConfig HOME_SHORTCUTS[] = {
+  {"Monitor", LV_SYMBOL_VIDEO, HOME_ICON_MONITOR, UI_PAGE_MONITOR, 0x3949AB},
+  {"Pomodoro", LV_SYMBOL_BELL, HOME_ICON_POMODORO, UI_PAGE_POMODORO, 0xE53935},
+  {"Settings", LV_SYMBOL_SETTINGS, HOME_ICON_SYMBOL, UI_PAGE_SETTINGS, 0x5E35B1},
+  {"Photo", LV_SYMBOL_IMAGE, HOME_ICON_SYMBOL, UI_PAGE_PHOTO_FRAME, 0x8E24AA},
+  {"Weather", LV_SYMBOL_TINT, HOME_ICON_WEATHER, UI_PAGE_WEATHER, 0x039BE5},
+  {"Clock", LV_SYMBOL_REFRESH, HOME_ICON_CLOCK, UI_PAGE_CLOCK, 0x1E88E5},
+  {"Apps", LV_SYMBOL_BARS, HOME_ICON_APPS, UI_PAGE_APP_LAUNCHER, 0x5E35B1},
+  {"Music", LV_SYMBOL_AUDIO, HOME_ICON_SYMBOL, UI_PAGE_AUDIO_PLAYER, 0x43A047},
+  {"Video", LV_SYMBOL_PLAY, HOME_ICON_SYMBOL, UI_PAGE_VIDEO_PLAYER, 0xFB8C00},
+  {"Voice", LV_SYMBOL_CALL, HOME_ICON_SYMBOL, UI_PAGE_VOICE, 0x00897B},
+  {"Inbox", LV_SYMBOL_LIST, HOME_ICON_SYMBOL, UI_PAGE_INBOX, 0x546E7A},
+};
+
+static constexpr uint8_t HOME_SHORTCUT_COUNT = sizeof(HOME_SHORTCUTS) / sizeof(HOME_SHORTCUTS[0]);
+static constexpr uint8_t HOME_VISIBLE_SLOT_COUNT = 8;
+static lv_obj_t *homeShortcutSlots[HOME_VISIBLE_SLOT_COUNT] = {nullptr};
+static lv_obj_t *homeShortcutButtons[HOME_VISIBLE_SLOT_COUNT] = {nullptr};
+static lv_obj_t *homeShortcutIcons[HOME_VISIBLE_SLOT_COUNT] = {nullptr};
+static int8_t homeSlotToShortcut[HOME_VISIBLE_SLOT_COUNT] = {-1, -1, -1, -1, -1, -1, -1, -1};
+static lv_obj_t *homeCurrentShortcutLabel = nullptr;
+static lv_obj_t *homeSwipeHintLabel = nullptr;
+static int homeCarouselOffset = 0;
+
+static lv_obj_t *wifiLabel = nullptr;
+static lv_obj_t *wsLabel = nullptr;
+static lv_obj_t *statsLabel = nullptr;
+static lv_obj_t *cpuArc = nullptr;
+static lv_obj_t *memArc = nullptr;
+static lv_obj_t *cpuValueLabel = nullptr;
+static lv_obj_t *memValueLabel = nullptr;
+static lv_obj_t *upValueLabel = nullptr;
+static lv_obj_t *downValueLabel = nullptr;
+
+static ClockFaceSprites clockDigitSprites = {};
+static ClockFaceSprites clockSecondSprites = {};
+static ClockFaceRow clockTimeRow = {};
+static ClockFaceRow clockSecondRow = {};
+static lv_obj_t *clockDateLabel = nullptr;
+static lv_obj_t *clockSecondArc = nullptr;
+static lv_obj_t *clockSweepTip = nullptr;
+static lv_timer_t *clockSweepTimer = nullptr;
+static bool clockSweepEnabled = false;
+static uint8_t clockSweepLevel = 0;
+static int clockSweepLastSecond = -1;
+static lv_point_t clockSweepTipPos = {INT16_MIN, INT16_MIN};
+static uint32_t clockSweepWindowStartMs = 0;
+static uint32_t clockSweepWindowFrames = 0;
+static uint32_t clockSweepWindowFrameMs = 0;
+
+static lv_obj_t *diagWifiLabel = nullptr;
+static lv_obj_t *diagWsLabel = nullptr;
+static lv_obj_t *diagNtpLabel = nullptr;
+static lv_obj_t *diagIpLabel = nullptr;
+static lv_obj_t *diagRssiLabel = nullptr;
+static lv_obj_t *diagUptimeLabel = nullptr;
+static lv_obj_t *diagServerLabel = nullptr;
+static lv_obj_t *diagSdLabel = nullptr;
+static lv_obj_t *diagSdRootLabel = nullptr;
+static lv_obj_t *diagAudioLabel = nullptr;
+static lv_obj_t *diagPacerLabel = nullptr;
+static lv_obj_t *diagPacerHistLabel = nullptr;
+static lv_obj_t *diagActionLabel = nullptr;
+static lv_obj_t *brightnessSlider = nullptr;
+static lv_obj_t *brightnessValueLabel = nullptr;
+
+static lv_obj_t *inboxTypeLabel = nullptr;
+static lv_obj_t *inboxIndexLabel = nullptr;
+static lv_obj_t *inboxTitleLabel = nullptr;
+static lv_obj_t *inboxBodyLabel = nullptr;
+static lv_obj_t *inboxMetaLabel = nullptr;
+static lv_obj_t *inboxActionLabel = nullptr;
+static lv_obj_t *inboxAckBtn = nullptr;
+static lv_obj_t *inboxDoneBtn = nullptr;
+
+static lv_obj_t *pomodoroArc = nullptr;
+static lv_obj_t *pomodoroTimeLabel = nullptr;
+static lv_obj_t *pomodoroModeLabel = nullptr;
+static lv_obj_t *pomodoroCountLabel = nullptr;
+static lv_obj_t *pomodoroStatusLabel = nullptr;
+
+static lv_obj_t *weatherTempLabel = nullptr;
+static lv_obj_t *weatherConditionLabel = nullptr;
+static lv_obj_t *weatherCityLabel = nullptr;
+static lv_obj_t *weatherHumidityLabel = nullptr;
+static lv_obj_t *weatherFeelsLikeLabel = nullptr;
+
+static lv_obj_t *appLauncherList = nullptr;
+static lv_obj_t *appLauncherTitle = nullptr;
+static lv_obj_t *appLauncherPageLabel = nullptr;
+static lv_obj_t *appLauncherStatusLabel = nullptr;
+static lv_obj_t *appLauncherPrevBtn = nullptr;
+static lv_obj_t *appLauncherNextBtn = nullptr;
+static lv_timer_t *appLauncherStatusTimer = nullptr;
+
+static lv_obj_t *photoFrameRootLabel = nullptr;
+static lv_obj_t *photoFrameViewport = nullptr;
+static lv_obj_t *photoFrameStatusLabel = nullptr;
+static lv_obj_t *photoFrameImage = nullptr;
+static lv_obj_t *photoFrameNameLabel = nullptr;
+static lv_obj_t *photoFrameIndexLabel = nullptr;
+static lv_obj_t *photoFramePrevBtn = nullptr;
+static lv_obj_t *photoFrameReloadBtn = nullptr;
+static lv_obj_t *photoFrameNextBtn = nullptr;
+
+static lv_obj_t *audioStatusLabel = nullptr;
+static lv_obj_t *audioIconLabel = nullptr;
+static lv_obj_t *audioTrackLabel = nullptr;
+static lv_obj_t *audioTimeLabel = nullptr;
+static lv_obj_t *audioSeekSlider = nullptr;
+static lv_obj_t *audioIndexLabel = nullptr;
+static lv_obj_t *audioPrevBtn = nullptr;
+static lv_obj_t *audioPlayBtn = nullptr;
+static lv_obj_t *audioPlayBtnLabel = nullptr;
+static lv_obj_t *audioNextBtn = nullptr;
+
+static lv_obj_t *homeWallpaperImage = nullptr;
+static lv_obj_t *clockWallpaperImage = nullptr;
+static lv_obj_t *homeWallpaperShade = nullptr;
+static lv_obj_t *clockWallpaperShade = nullptr;
+static lv_obj_t *bootSplashOverlay = nullptr;
+
+static lv_obj_t *videoStatusLabel = nullptr;
+static lv_obj_t *videoTrackLabel = nullptr;
+static lv_obj_t *videoHintLabel = nullptr;
+static lv_obj_t *videoIndexLabel = nullptr;
+static lv_obj_t *videoViewport = nullptr;
+static lv_obj_t *videoImage = nullptr;
+static lv_obj_t *videoPrevBtn = nullptr;
+static lv_obj_t *videoPlayBtn = nullptr;
+static lv_obj_t *videoPlayBtnLabel = nullptr;
+static lv_obj_t *videoNextBtn = nullptr;
+
+static lv_obj_t *voiceStatusLabel = nullptr;
+static lv_obj_t *voiceResultLabel = nullptr;
+static lv_obj_t *voiceMicToggleBtn = nullptr;
+static lv_obj_t *voiceMicToggleLabel = nullptr;
+
+// Actions carried in the user data of page buttons.
+enum VideoControlAction {
+  VIDEO_CONTROL_NONE = -1,
+  VIDEO_CONTROL_PREV = 0,
+  VIDEO_CONTROL_TOGGLE = 1,
+  VIDEO_CONTROL_NEXT = 2,
+  VIDEO_CONTROL_RESCAN = 3,
+};
+
+enum SettingsAction {
+  SETTINGS_ACTION_NONE = 0,
+  SETTINGS_ACTION_WIFI_RECONNECT = 1,
+  SETTINGS_ACTION_WS_RECONNECT = 2,
+  SETTINGS_ACTION_NTP_SYNC = 3,
+  SETTINGS_ACTION_REBOOT = 4
+};
+
+enum InboxAction {
+  INBOX_ACTION_NONE = 0,
+  INBOX_ACTION_PREV = 1,
+  INBOX_ACTION_NEXT = 2,
+  INBOX_ACTION_ACK = 3,
+  INBOX_ACTION_DONE = 4
+};
+
+enum PomodoroMode {
+  POMODORO_WORK = 0,
+  POMODORO_SHORT_BREAK = 1,
+  POMODORO_LONG_BREAK = 2
+};
+
+struct WeatherData {
+  float temperature = 0.0f;
+  float feelsLike = 0.0f;
+  int humidity = 0;
+  char condition[32] = "Loading...";
+  char city[32] = "Beijing";
+  char updateTime[32] = "";
+  bool valid = false;
+};
+
+struct VoicePresetCommand {
+  const char *label;
+  const char *text;
+};
+
+static const VoicePresetCommand VOICE_PRESET_COMMANDS[] = {
+  {"Home", "go home"},
+  {"Monitor", "open monitor"},
+  {"Weather", "open weather"},
+  {"Clock", "open clock"},
+  {"Apps", "open apps"},
+  {"Safari", "open safari"},
+};
+
+// Spectrum canvas on the audio page: one bar per band plus a VU line under it.
+static constexpr lv_coord_t SPECTRUM_BAR_W = 10;
+static constexpr lv_coord_t SPECTRUM_BAR_GAP = 2;
+static constexpr lv_coord_t SPECTRUM_BAR_H = 40;
+static constexpr lv_coord_t SPECTRUM_VU_H = 3;
+static constexpr lv_coord_t SPECTRUM_VIEW_W = SPECTRUM_BANDS * (SPECTRUM_BAR_W + SPECTRUM_BAR_GAP) - SPECTRUM_BAR_GAP;
+static constexpr lv_coord_t SPECTRUM_VIEW_H = SPECTRUM_BAR_H + 1 + SPECTRUM_VU_H;
+static lv_obj_t *spectrumCanvas = nullptr;
+static lv_color_t *spectrumCanvasBuf = nullptr;       // PSRAM
+static lv_color_t spectrumRowColor[SPECTRUM_BAR_H];
+
+// Sweep-second mode on the clock page. The timer runs at the first rate that
+// keeps the LVGL refresh (render plus waiting on the panel, per frame) under
+// CLOCK_SWEEP_FRAME_BUDGET_MS, measured over a window; below half the budget
+// it steps back up. The arc itself moves in whole degrees (about 2 px at
+// this radius), the tip dot in whole pixels; both are only touched when
+// they move.
+static constexpr uint32_t CLOCK_SWEEP_PERIODS_MS[] = {33, 66, 100};    // 30, 15, 10 FPS
+static constexpr uint8_t CLOCK_SWEEP_LEVEL_COUNT = sizeof(CLOCK_SWEEP_PERIODS_MS) / sizeof(CLOCK_SWEEP_PERIODS_MS[0]);
+static constexpr uint32_t CLOCK_SWEEP_FRAME_BUDGET_MS = 8;
+static constexpr uint32_t CLOCK_SWEEP_WINDOW_MS = 2000;
+static constexpr int CLOCK_ARC_SIZE = 232;
+static constexpr int CLOCK_ARC_WIDTH = 8;
+static constexpr int CLOCK_ARC_Y_OFFSET = 8;
+static constexpr int CLOCK_SWEEP_TIP_SIZE = 10;
+
+// Status lines are kept here as well as in their labels, so a page that is
+// built late (or rebuilt after being released) comes up showing them.
+struct UiStatusText {
+  char text[64] = "";
+  lv_color_t color = {};
+  bool set = false;
+};
+
+static UiStatusText photoFrameStatusText;
+static UiStatusText audioStatusText;
+static UiStatusText videoStatusText;
+static String wifiStatusText;
+static String wsStatusText;
+static String actionStatusText;
+
+struct UiStatsSnapshot {
+  float cpu = 0;
+  float memory = 0;
+  float upload = 0;
+  float download = 0;
+  bool valid = false;
+};
+static UiStatsSnapshot uiLastStats;
+
+static void applyStatusText(lv_obj_t *label, const UiStatusText &status) {
+  if (label == nullptr || !status.set) {
+    return;
+  }
+  lv_label_set_text(label, status.text);
+  lv_obj_set_style_text_color(label, status.color, LV_PART_MAIN);
+}
+
+#endif
@@ -0,0 +1,396 @@
+// IMA-ADPCM codec (audio/ima_adpcm.h): conformance with imaAdpcm.ts, quality
+// and cost per chunk.
+//
+//   pio test -e native-test -f test_ima_adpcm
+//   IMA_ADPCM_WAV_DIR=/path/to/clips pio test -e native-test -f test_ima_adpcm
+//
+// vectors.txt holds chunks imaAdpcm.ts encoded and the PCM it decoded them
+// to; electron-app/test-ima-adpcm.js checks the same file, so the two codecs
+// have to agree bit for bit. Quality is the SNR of a stream encoded in
+// 40 ms chunks with the state carried across, as the mic stream does, and
+// each chunk decoded on its own, as the server does. With IMA_ADPCM_WAV_DIR
+// set, every 16 kHz mono <name>.wav there is scored the same way.
+#include <unity.h>
+#include <chrono>
+#include <dirent.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "audio/ima_adpcm.h"
+
+#define SAMPLE_RATE 16000
+#define CHUNK_SAMPLES 640        // VOICE_SAMPLES_PER_CHUNK, 40 ms
+#define DESKTOP_CHUNK_SAMPLES 960  // audio stream, 20 ms at 48 kHz
+#define MIN_WAV_SNR_DB 15.0      // recorded speech
+
+struct CodecVector {
+  std::string name;
+  ImaAdpcmState start;
+  std::vector<int16_t> pcm;
+  std::vector<uint8_t> chunk;
+  std::vector<int16_t> decoded;
+};
+
+static std::vector<CodecVector> vectors;
+
+void setUp() {}
+void tearDown() {}
+
+struct Lcg {
+  uint32_t state;
+  uint32_t next(uint32_t range)
+  {
+    state = state * 1664525U + 1013904223U;
+    return (state >> 8) % range;
+  }
+};
+
+static bool parseHex(const char *hex, std::vector<uint8_t> *out)
+{
+  out->clear();
+  if (strcmp(hex, "-") == 0) {
+    return true;
+  }
+  const size_t len = strlen(hex);
+  if ((len & 1) != 0) {
+    return false;
+  }
+  for (size_t i = 0; i < len; i += 2) {
+    unsigned byte = 0;
+    if (sscanf(hex + i, "%2x", &byte) != 1) {
+      return false;
+    }
+    out->push_back((uint8_t)byte);
+  }
+  return true;
+}
+
+static bool parsePcm(const char *hex, std::vector<int16_t> *out)
+{
+  std::vector<uint8_t> bytes;
+  if (!parseHex(hex, &bytes) || (bytes.size() & 1) != 0) {
+    return false;
+  }
+  out->resize(bytes.size() / 2);
+  for (size_t i = 0; i < out->size(); ++i) {
+    (*out)[i] = (int16_t)(bytes[i * 2] | (bytes[i * 2 + 1] << 8));
+  }
+  return true;
+}
+
+static int16_t clamp16(double v)
+{
+  return (int16_t)((v > 32767.0) ? 32767 : (v < -32768.0 ? -32768 : lrint(v)));
+}
+
+// --- signals -----------------------------------------------------------------
+
+struct Signal {
+  std::string name;
+  std::vector<int16_t> pcm;
+  double minSnrDb;
+};
+
+static std::vector<Signal> syntheticSignals()
+{
+  std::vector<Signal> signals;
+  const size_t n = SAMPLE_RATE * 2;
+  // Step adaptation lags a sweep towards Nyquist, so the chirp gets less.
+  Signal tone{"tone_440", std::vector<int16_t>(n), 30.0};
+  Signal speech{"voiced_speech", std::vector<int16_t>(n), 22.0};
+  Signal chirp{"chirp_100_6000", std::vector<int16_t>(n), 15.0};
+  Signal quiet{"quiet_tone_-40dbfs", std::vector<int16_t>(n), 30.0};
+  double phase = 0.0;
+  for (size_t i = 0; i < n; ++i) {
+    const double t = (double)i / SAMPLE_RATE;
+    tone.pcm[i] = clamp16(12000 * sin(2 * M_PI * 440 * t));
+    quiet.pcm[i] = clamp16(328 * sin(2 * M_PI * 440 * t));
+    // Harmonics of a gliding pitch under a syllable envelope, as in test_voice_vad.
+    const double s = fmod(t, 0.22) / 0.22;
+    const double envelope = (s < 0.15) ? s / 0.15 : (s > 0.75 ? 0.35 + 0.65 * (1.0 - s) / 0.25 : 1.0);
+    const double pitch = 150 * (1.0 + 0.12 * sin(2 * M_PI * 1.3 * t));
+    phase += 2 * M_PI * pitch / SAMPLE_RATE;
+    double v = 0.0;
+    for (int h = 1; h * pitch < 4000; ++h) {
+      v += sin(h * phase) / (1.0 + pow((h * pitch - 900.0) / 600.0, 2.0)) / sqrt((double)h);
+    }
+    speech.pcm[i] = clamp16(5000 * envelope * v * 0.5);
+    chirp.pcm[i] = clamp16(8000 * sin(2 * M_PI * (100 * t + (6000 - 100) / 4.0 * t * t)));
+  }
+  signals.push_back(tone);
+  signals.push_back(speech);
+  signals.push_back(chirp);
+  signals.push_back(quiet);
+  return signals;
+}
+
+static bool readWav(const std::string &path, std::vector<int16_t> *pcm)
+{
+  FILE *f = fopen(path.c_str(), "rb");
+  if (f == nullptr) {
+    return false;
+  }
+  uint8_t riff[12];
+  bool ok = fread(riff, 1, 12, f) == 12 && memcmp(riff, "RIFF", 4) == 0 && memcmp(riff + 8, "WAVE", 4) == 0;
+  bool formatOk = false;
+  while (ok) {
+    uint8_t header[8];
+    if (fread(header, 1, 8, f) != 8) {
+      ok = false;
+      break;
+    }
+    const uint32_t size = header[4] | (header[5] << 8) | (header[6] << 16) | ((uint32_t)header[7] << 24);
+    if (memcmp(header, "fmt ", 4) == 0) {
+      uint8_t fmt[16];
+      ok = size >= 16 && fread(fmt, 1, 16, f) == 16;
+      const uint16_t format = fmt[0] | (fmt[1] << 8);
+      const uint16_t channels = fmt[2] | (fmt[3] << 8);
+      const uint32_t rate = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16) | ((uint32_t)fmt[7] << 24);
+      const uint16_t bits = fmt[14] | (fmt[15] << 8);
+      formatOk = ok && format == 1 && channels == 1 && rate == SAMPLE_RATE && bits == 16;
+      fseek(f, (long)(size - 16 + (size & 1)), SEEK_CUR);
+    } else if (memcmp(header, "data", 4) == 0) {
+      pcm->resize(size / 2);
+      ok = formatOk && fread(pcm->data(), 2, pcm->size(), f) == pcm->size();
+      break;
+    } else {
+      fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+    }
+  }
+  fclose(f);
+  return ok;
+}
+
+// Encodes in chunks with the state carried across, decodes every chunk on
+// its own and returns the SNR in dB. A trailing partial chunk is coded too.
+static double roundTripSnr(const std::vector<int16_t> &pcm, size_t chunkSamples)
+{
+  ImaAdpcmState state;
+  imaAdpcmReset(&state);
+  std::vector<uint8_t> chunk(IMA_ADPCM_CHUNK_BYTES(chunkSamples));
+  std::vector<int16_t> decoded(chunkSamples);
+  double signal = 0.0;
+  double noise = 0.0;
+  for (size_t at = 0; at < pcm.size(); at += chunkSamples) {
+    const size_t count = (pcm.size() - at < chunkSamples) ? pcm.size() - at : chunkSamples;
+    const size_t bytes = imaAdpcmEncodeChunk(&state, &pcm[at], count, chunk.data());
+    TEST_ASSERT_EQUAL_UINT32(IMA_ADPCM_CHUNK_BYTES(count), bytes);
+    TEST_ASSERT_TRUE(imaAdpcmDecodeChunk(chunk.data(), bytes, count, decoded.data()));
+    TEST_ASSERT_EQUAL_INT32(state.predictor, decoded[count - 1]);
+    for (size_t i = 0; i < count; ++i) {
+      const double e = (double)pcm[at + i] - decoded[i];
+      signal += (double)pcm[at + i] * pcm[at + i];
+      noise += e * e;
+    }
+  }
+  return (noise > 0.0) ? 10.0 * log10(signal / noise) : 99.0;
+}
+
+// --- tests -------------------------------------------------------------------
+
+// Runs first; the conformance test replays what it loaded.
+void test_load_vectors()
+{
+  std::string path = __FILE__;
+  const size_t slash = path.find_last_of("/\\");
+  path = (slash == std::string::npos ? std::string() : path.substr(0, slash + 1)) + "vectors.txt";
+  FILE *f = fopen(path.c_str(), "r");
+  TEST_ASSERT_NOT_NULL_MESSAGE(f, "vectors.txt not found next to test_main.cpp");
+  static char line[1 << 16];
+  static char pcm[sizeof(line)], chunk[sizeof(line)], decoded[sizeof(line)];
+  vectors.clear();
+  while (fgets(line, sizeof(line), f) != nullptr) {
+    char name[64];
+    int predictor = 0;
+    int index = 0;
+    if (sscanf(line, "vector %63s %d %d %s = %s %s", name, &predictor, &index, pcm, chunk, decoded) != 6) {
+      continue;
+    }
+    CodecVector v;
+    v.name = name;
+    v.start.predictor = predictor;
+    v.start.index = (int8_t)index;
+    TEST_ASSERT_TRUE_MESSAGE(parsePcm(pcm, &v.pcm), name);
+    TEST_ASSERT_TRUE_MESSAGE(parseHex(chunk, &v.chunk), name);
+    TEST_ASSERT_TRUE_MESSAGE(parsePcm(decoded, &v.decoded), name);
+    vectors.push_back(v);
+  }
+  fclose(f);
+  TEST_ASSERT_TRUE(vectors.size() >= 10);
+}
+
+void test_vectors_match_electron()
+{
+  for (const CodecVector &v : vectors) {
+    ImaAdpcmState state = v.start;
+    std::vector<uint8_t> chunk(IMA_ADPCM_CHUNK_BYTES(v.pcm.size()));
+    const size_t bytes = imaAdpcmEncodeChunk(&state, v.pcm.data(), v.pcm.size(), chunk.data());
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(v.chunk.size(), bytes, v.name.c_str());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY_MESSAGE(v.chunk.data(), chunk.data(), bytes, v.name.c_str());
+
+    // Decode the Electron chunk from an exact-size copy.
+    std::vector<uint8_t> wire(v.chunk);
+    std::vector<int16_t> decoded(v.pcm.size() + 1, 0x5A5A);
+    TEST_ASSERT_TRUE_MESSAGE(imaAdpcmDecodeChunk(wire.data(), wire.size(), v.pcm.size(), decoded.data()),
+                             v.name.c_str());
+    TEST_ASSERT_EQUAL_INT16_ARRAY_MESSAGE(v.decoded.data(), decoded.data(), v.pcm.size(), v.name.c_str());
+    TEST_ASSERT_EQUAL_INT16(0x5A5A, decoded[v.pcm.size()]);
+  }
+}
+
+// Odd counts leave the high nibble of the last byte empty; the chunk must
+// still be exactly IMA_ADPCM_CHUNK_BYTES long and decode to `count` samples
+// ending on the encoder's predictor.
+void test_odd_sample_counts()
+{
+  const size_t counts[] = {1, 3, 5, 17, 639, 641};
+  Lcg rng{7};
+  for (size_t count : counts) {
+    std::vector<int16_t> pcm(count);
+    for (size_t i = 0; i < count; ++i) {
+      pcm[i] = (int16_t)((int32_t)rng.next(40001) - 20000);
+    }
+    ImaAdpcmState state;
+    imaAdpcmReset(&state);
+    std::vector<uint8_t> chunk(IMA_ADPCM_CHUNK_BYTES(count));
+    TEST_ASSERT_EQUAL_UINT32(4 + (count + 1) / 2, imaAdpcmEncodeChunk(&state, pcm.data(), count, chunk.data()));
+    TEST_ASSERT_EQUAL_HEX8(0, chunk.back() & 0xF0);
+    std::vector<int16_t> decoded(count);
+    TEST_ASSERT_TRUE(imaAdpcmDecodeChunk(chunk.data(), chunk.size(), count, decoded.data()));
+    TEST_ASSERT_EQUAL_INT32(state.predictor, decoded.back());
+    // One sample more or less is a different chunk length.
+    TEST_ASSERT_FALSE(imaAdpcmDecodeChunk(chunk.data(), chunk.size(), count + 2, decoded.data()));
+    TEST_ASSERT_FALSE(imaAdpcmDecodeChunk(chunk.data(), chunk.size() - 1, count, decoded.data()));
+  }
+}
+
+void test_rejects_bad_chunks()
+{
+  int16_t pcm[CHUNK_SAMPLES];
+  for (int i = 0; i < CHUNK_SAMPLES; ++i) {
+    pcm[i] = (int16_t)(8000 * sin(i * 0.3));
+  }
+  ImaAdpcmState state;
+  imaAdpcmReset(&state);
+  uint8_t chunk[IMA_ADPCM_CHUNK_BYTES(CHUNK_SAMPLES)];
+  imaAdpcmEncodeChunk(&state, pcm, CHUNK_SAMPLES, chunk);
+  int16_t out[CHUNK_SAMPLES + 2];
+
+  for (int index = 0; index < 256; ++index) {
+    chunk[2] = (uint8_t)index;
+    const bool ok = imaAdpcmDecodeChunk(chunk, sizeof(chunk), CHUNK_SAMPLES, out);
+    TEST_ASSERT_EQUAL(index <= 88, ok);
+  }
+  chunk[2] = 0;
+  TEST_ASSERT_FALSE(imaAdpcmDecodeChunk(chunk, sizeof(chunk) - 1, CHUNK_SAMPLES, out));
+  TEST_ASSERT_FALSE(imaAdpcmDecodeChunk(chunk, sizeof(chunk) + 1, CHUNK_SAMPLES, out));
+  TEST_ASSERT_FALSE(imaAdpcmDecodeChunk(chunk, sizeof(chunk), CHUNK_SAMPLES - 2, out));
+  TEST_ASSERT_FALSE(imaAdpcmDecodeChunk(chunk, IMA_ADPCM_HEADER_BYTES - 1, 0, out));
+  // Header only: zero samples is a valid, empty chunk.
+  TEST_ASSERT_TRUE(imaAdpcmDecodeChunk(chunk, IMA_ADPCM_HEADER_BYTES, 0, out));
+}
+
+void test_round_trip_snr()
+{
+  for (const Signal &s : syntheticSignals()) {
+    const double snr = roundTripSnr(s.pcm, CHUNK_SAMPLES);
+    // Odd chunking must not change the result: the state carries over.
+    const double snrOdd = roundTripSnr(s.pcm, 641);
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%s: SNR %.1f dB (641-sample chunks %.1f dB)", s.name.c_str(), snr, snrOdd);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE_MESSAGE(snr >= s.minSnrDb, msg);
+    TEST_ASSERT_TRUE_MESSAGE(fabs(snr - snrOdd) < 0.5, msg);
+  }
+}
+
+void test_wav_corpus()
+{
+  const char *dir = getenv("IMA_ADPCM_WAV_DIR");
+  if (dir == nullptr || dir[0] == '\0') {
+    TEST_MESSAGE("IMA_ADPCM_WAV_DIR not set, no recorded clips scored");
+    return;
+  }
+  DIR *d = opendir(dir);
+  TEST_ASSERT_NOT_NULL(d);
+  uint32_t clips = 0;
+  while (dirent *entry = readdir(d)) {
+    const std::string name = entry->d_name;
+    if (name.size() < 5 || name.compare(name.size() - 4, 4, ".wav") != 0) {
+      continue;
+    }
+    std::vector<int16_t> pcm;
+    if (!readWav(std::string(dir) + "/" + name, &pcm) || pcm.empty()) {
+      continue;
+    }
+    const double snr = roundTripSnr(pcm, CHUNK_SAMPLES);
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%s: %.1f s, SNR %.1f dB", name.c_str(), (double)pcm.size() / SAMPLE_RATE, snr);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE_MESSAGE(snr >= MIN_WAV_SNR_DB, msg);
+    clips++;
+  }
+  closedir(d);
+  TEST_ASSERT_GREATER_THAN(0, clips);
+}
+
+// Host time per chunk each way. The codec has no lookahead, so the latency
+// it adds is only this time: encode on the sender plus decode on the
+// receiver, against a 40 ms (mic) or 20 ms (desktop audio) chunk.
+void test_cost_per_chunk()
+{
+  const std::vector<Signal> signals = syntheticSignals();
+  const std::vector<int16_t> &pcm = signals[1].pcm;
+  const size_t sizes[] = {CHUNK_SAMPLES, DESKTOP_CHUNK_SAMPLES};
+  for (size_t samples : sizes) {
+    const size_t chunks = pcm.size() / samples;
+    std::vector<uint8_t> encoded(chunks * IMA_ADPCM_CHUNK_BYTES(samples));
+    std::vector<int16_t> decoded(samples);
+    const int rounds = 50;
+    uint32_t sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+      ImaAdpcmState state;
+      imaAdpcmReset(&state);
+      for (size_t c = 0; c < chunks; ++c) {
+        imaAdpcmEncodeChunk(&state, &pcm[c * samples], samples, &encoded[c * IMA_ADPCM_CHUNK_BYTES(samples)]);
+      }
+      sink += encoded[(size_t)r % encoded.size()];
+    }
+    const double encodeUs =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / (rounds * chunks);
+    t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+      for (size_t c = 0; c < chunks; ++c) {
+        imaAdpcmDecodeChunk(&encoded[c * IMA_ADPCM_CHUNK_BYTES(samples)], IMA_ADPCM_CHUNK_BYTES(samples), samples,
+                            decoded.data());
+        sink += (uint16_t)decoded[c % samples];
+      }
+    }
+    const double decodeUs =
+        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / (rounds * chunks);
+    const double chunkMs = (samples == CHUNK_SAMPLES) ? 40.0 : 20.0;
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%u-sample chunk (%.0f ms): encode %.1f us, decode %.1f us, added latency %.3f ms, sink %u",
+             (unsigned)samples, chunkMs, encodeUs, decodeUs, (encodeUs + decodeUs) / 1000.0, (unsigned)sink);
+    TEST_MESSAGE(msg);
+    // Both ways within 1% of the chunk on any host.
+    TEST_ASSERT_LESS_THAN((int)(chunkMs * 10), (int)(encodeUs + decodeUs));
+  }
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_load_vectors);
+  RUN_TEST(test_vectors_match_electron);
+  RUN_TEST(test_odd_sample_counts);
+  RUN_TEST(test_rejects_bad_chunks);
+  RUN_TEST(test_round_trip_snr);
+  RUN_TEST(test_wav_corpus);
+  RUN_TEST(test_cost_per_chunk);
+  return UNITY_END();
+}
@@ -0,0 +1,255 @@
+// RGB565 scaler (display/img_scale.h): geometry, accuracy and cost per frame.
+//
+//   pio test -e native-test -f test_img_scale
+//
+// Zoom 256 has to be an exact copy with either filter, a downscale has to
+// keep every sample inside the source (the last column and row clamp), the
+// crop has to stay centred on maxW x maxH, bad sizes have to be refused,
+// and the byte-swapped path has to match the native one. Bilinear output is
+// checked against a float reference of the same sample positions. The cost
+// test scales a 480x480 photo to the 360x360 panel as img_transform.h does.
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "display/img_scale.h"
+
+void setUp() {}
+void tearDown() {}
+
+static ImgScaleMap map;
+
+struct Lcg {
+  uint32_t state;
+  uint32_t next(uint32_t range)
+  {
+    state = state * 1664525U + 1013904223U;
+    return (state >> 8) % range;
+  }
+};
+
+static std::vector<uint16_t> randomImage(uint16_t w, uint16_t h, uint32_t seed)
+{
+  std::vector<uint16_t> img((size_t)w * h);
+  Lcg rng{seed};
+  for (auto &px : img) {
+    px = (uint16_t)rng.next(0x10000);
+  }
+  return img;
+}
+
+// A smooth image, so bilinear error measures the arithmetic and not aliasing.
+static std::vector<uint16_t> gradientImage(uint16_t w, uint16_t h)
+{
+  std::vector<uint16_t> img((size_t)w * h);
+  for (uint16_t y = 0; y < h; ++y) {
+    for (uint16_t x = 0; x < w; ++x) {
+      const uint32_t r = (uint32_t)x * 31 / (w - 1);
+      const uint32_t g = (uint32_t)y * 63 / (h - 1);
+      const uint32_t b = (uint32_t)(x + y) * 31 / (w + h - 2);
+      img[(size_t)y * w + x] = (uint16_t)((r << 11) | (g << 5) | b);
+    }
+  }
+  return img;
+}
+
+void test_zoom_256_is_an_exact_copy()
+{
+  const std::vector<uint16_t> src = randomImage(97, 61, 1);
+  std::vector<uint16_t> dst(src.size());
+  TEST_ASSERT_TRUE(imgScaleMapInit(&map, 97, 61, 256, 360, 360));
+  TEST_ASSERT_EQUAL_UINT16(97, map.dstW);
+  TEST_ASSERT_EQUAL_UINT16(61, map.dstH);
+  const ImgScaleFilter filters[] = {IMG_SCALE_NEAREST, IMG_SCALE_BILINEAR};
+  for (ImgScaleFilter f : filters) {
+    for (int swapped = 0; swapped < 2; ++swapped) {
+      imgScaleRun(&map, src.data(), dst.data(), f, swapped != 0);
+      TEST_ASSERT_TRUE(dst == src);
+    }
+  }
+}
+
+// Cropped at 1:1 the output is the centre of the source.
+void test_crop_is_centred()
+{
+  const std::vector<uint16_t> src = randomImage(100, 80, 2);
+  TEST_ASSERT_TRUE(imgScaleMapInit(&map, 100, 80, 256, 60, 50));
+  TEST_ASSERT_EQUAL_UINT16(60, map.dstW);
+  TEST_ASSERT_EQUAL_UINT16(50, map.dstH);
+  std::vector<uint16_t> dst((size_t)60 * 50);
+  imgScaleRun(&map, src.data(), dst.data(), IMG_SCALE_BILINEAR, false);
+  for (int y = 0; y < 50; ++y) {
+    for (int x = 0; x < 60; ++x) {
+      TEST_ASSERT_EQUAL_HEX16(src[(size_t)(y + 15) * 100 + (x + 20)], dst[(size_t)y * 60 + x]);
+    }
+  }
+}
+
+// Every table entry, and the neighbour bilinear reads when frac > 0, lies
+// inside the source; the first and last outputs clamp to the edge pixels.
+void test_downscale_stays_inside_the_source()
+{
+  const uint16_t sizes[] = {1, 2, 7, 360, 480, 1024};
+  const uint16_t zooms[] = {1, 37, 128, 192, 255, 256, 300, 1024};
+  for (uint16_t src : sizes) {
+    for (uint16_t zoom : zooms) {
+      TEST_ASSERT_TRUE(imgScaleMapInit(&map, src, src, zoom, 360, 360));
+      TEST_ASSERT_TRUE(map.dstW >= 1 && map.dstW <= 360);
+      for (uint16_t i = 0; i < map.dstW; ++i) {
+        TEST_ASSERT_TRUE(map.x.idx[i] < src);
+        TEST_ASSERT_TRUE(map.x.frac[i] <= 32);
+        TEST_ASSERT_TRUE(map.x.frac[i] == 0 || map.x.idx[i] + 1 < src);
+        TEST_ASSERT_TRUE(i == 0 || map.x.idx[i] >= map.x.idx[i - 1]);
+      }
+    }
+  }
+
+  // 8 -> 4: output i samples source 2i + 0.5, halfway between two pixels.
+  TEST_ASSERT_TRUE(imgScaleMapInit(&map, 8, 8, 128, 360, 360));
+  TEST_ASSERT_EQUAL_UINT16(4, map.dstW);
+  for (uint16_t i = 0; i < 4; ++i) {
+    TEST_ASSERT_EQUAL_UINT16(2 * i, map.x.idx[i]);
+    TEST_ASSERT_EQUAL_UINT8(16, map.x.frac[i]);
+  }
+  // 4 -> 8: the outer samples fall before pixel 0 and past pixel 3.
+  TEST_ASSERT_TRUE(imgScaleMapInit(&map, 4, 4, 512, 360, 360));
+  TEST_ASSERT_EQUAL_UINT16(0, map.x.idx[0]);
+  TEST_ASSERT_EQUAL_UINT8(0, map.x.frac[0]);
+  TEST_ASSERT_EQUAL_UINT16(3, map.x.idx[7]);
+  TEST_ASSERT_EQUAL_UINT8(0, map.x.frac[7]);
+}
+
+void test_bilinear_matches_reference()
+{
+  const std::vector<uint16_t> src = gradientImage(480, 320);
+  const uint16_t zooms[] = {96, 192, 200, 333};
+  float worst = 0.0f;
+  for (uint16_t zoom : zooms) {
+    TEST_ASSERT_TRUE(imgScaleMapInit(&map, 480, 320, zoom, 360, 360));
+    std::vector<uint16_t> dst((size_t)map.dstW * map.dstH);
+    imgScaleRun(&map, src.data(), dst.data(), IMG_SCALE_BILINEAR, false);
+    const uint16_t zoomedW = imgScaleZoomedSize(480, zoom);
+    const uint16_t zoomedH = imgScaleZoomedSize(320, zoom);
+    const int skipX = (zoomedW - map.dstW) / 2;
+    const int skipY = (zoomedH - map.dstH) / 2;
+    for (int y = 0; y < map.dstH; ++y) {
+      float sy = (y + skipY + 0.5f) * 256.0f / zoom - 0.5f;
+      sy = sy < 0.0f ? 0.0f : (sy > 319.0f ? 319.0f : sy);
+      const int y0 = (int)sy;
+      const int y1 = y0 + 1 < 320 ? y0 + 1 : y0;
+      const float fy = sy - y0;
+      for (int x = 0; x < map.dstW; ++x) {
+        float sx = (x + skipX + 0.5f) * 256.0f / zoom - 0.5f;
+        sx = sx < 0.0f ? 0.0f : (sx > 479.0f ? 479.0f : sx);
+        const int x0 = (int)sx;
+        const int x1 = x0 + 1 < 480 ? x0 + 1 : x0;
+        const float fx = sx - x0;
+        const uint16_t got = dst[(size_t)y * map.dstW + x];
+        const int shifts[3] = {11, 5, 0};
+        const int masks[3] = {0x1F, 0x3F, 0x1F};
+        for (int c = 0; c < 3; ++c) {
+          auto ch = [&](int px, int py) {
+            return (float)((src[(size_t)py * 480 + px] >> shifts[c]) & masks[c]);
+          };
+          const float top = ch(x0, y0) + (ch(x1, y0) - ch(x0, y0)) * fx;
+          const float bottom = ch(x0, y1) + (ch(x1, y1) - ch(x0, y1)) * fx;
+          const float want = top + (bottom - top) * fy;
+          const float e = fabsf((float)((got >> shifts[c]) & masks[c]) - want);
+          worst = e > worst ? e : worst;
+        }
+      }
+    }
+  }
+  char msg[64];
+  snprintf(msg, sizeof(msg), "worst %.2f step(s) against the float reference", (double)worst);
+  TEST_MESSAGE(msg);
+  // 5-bit weights and truncation in each of the three lerps.
+  TEST_ASSERT_TRUE(worst < 2.0f);
+}
+
+void test_bad_sizes_are_refused()
+{
+  TEST_ASSERT_FALSE(imgScaleMapInit(&map, 0, 10, 256, 360, 360));
+  TEST_ASSERT_FALSE(imgScaleMapInit(&map, 10, 0, 256, 360, 360));
+  TEST_ASSERT_FALSE(imgScaleMapInit(&map, 10, 10, 0, 360, 360));
+  TEST_ASSERT_FALSE(imgScaleMapInit(&map, 10, 10, 256, 0, 360));
+  TEST_ASSERT_FALSE(imgScaleMapInit(&map, 10, 10, 256, 360, 0));
+  TEST_ASSERT_FALSE(imgScaleMapInit(&map, IMG_SCALE_MAX_DIM + 1, 10, 256, 360, 360));
+  TEST_ASSERT_FALSE(imgScaleMapInit(&map, 10, IMG_SCALE_MAX_DIM + 1, 256, 360, 360));
+  TEST_ASSERT_FALSE(imgScaleMapInit(&map, 10, 10, 256, IMG_SCALE_MAX_DIM + 1, 360));
+  TEST_ASSERT_FALSE(imgScaleMapInit(&map, 10, 10, 256, 360, IMG_SCALE_MAX_DIM + 1));
+  // A zoom past IMG_SCALE_MAX_DIM is cut to it, never past the tables.
+  TEST_ASSERT_TRUE(imgScaleMapInit(&map, IMG_SCALE_MAX_DIM, 4, 1024, IMG_SCALE_MAX_DIM, IMG_SCALE_MAX_DIM));
+  TEST_ASSERT_EQUAL_UINT16(IMG_SCALE_MAX_DIM, map.dstW);
+}
+
+void test_swapped_matches_native()
+{
+  const std::vector<uint16_t> src = randomImage(211, 157, 3);
+  std::vector<uint16_t> srcSw(src.size());
+  for (size_t i = 0; i < src.size(); ++i) {
+    srcSw[i] = imgScaleSwap(src[i]);
+  }
+  const uint16_t zooms[] = {101, 256, 419};
+  const ImgScaleFilter filters[] = {IMG_SCALE_NEAREST, IMG_SCALE_BILINEAR};
+  for (uint16_t zoom : zooms) {
+    TEST_ASSERT_TRUE(imgScaleMapInit(&map, 211, 157, zoom, 360, 360));
+    std::vector<uint16_t> out((size_t)map.dstW * map.dstH);
+    std::vector<uint16_t> outSw(out.size());
+    for (ImgScaleFilter f : filters) {
+      imgScaleRun(&map, src.data(), out.data(), f, false);
+      imgScaleRun(&map, srcSw.data(), outSw.data(), f, true);
+      for (size_t i = 0; i < out.size(); ++i) {
+        TEST_ASSERT_EQUAL_HEX16(out[i], imgScaleSwap(outSw[i]));
+      }
+    }
+  }
+}
+
+// Host cost of a 480x480 photo fitted to the panel (zoom 192), swapped as
+// on the device, table set-up included once per image as img_transform.h
+// does it.
+void test_scale_cost()
+{
+  const std::vector<uint16_t> src = randomImage(480, 480, 4);
+  std::vector<uint16_t> dst((size_t)360 * 360);
+  const int rounds = 50;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    imgScaleMapInit(&map, 480, 480, 192, 360, 360);
+  }
+  const double mapUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / rounds;
+  TEST_ASSERT_EQUAL_UINT16(360, map.dstW);
+
+  double us[2];
+  uint32_t sink = 0;
+  const ImgScaleFilter filters[] = {IMG_SCALE_NEAREST, IMG_SCALE_BILINEAR};
+  for (int f = 0; f < 2; ++f) {
+    t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+      imgScaleRun(&map, src.data(), dst.data(), filters[f], true);
+      sink += dst[(size_t)r * 997 % dst.size()];
+    }
+    us[f] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / rounds;
+  }
+  char msg[128];
+  snprintf(msg, sizeof(msg), "480->360: map %.0f us, nearest %.0f us (%.2f ns/px), bilinear %.0f us (%.2f ns/px), sink %u",
+           mapUs, us[0], us[0] * 1000.0 / dst.size(), us[1], us[1] * 1000.0 / dst.size(), (unsigned)sink);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_LESS_THAN(33000, (int)us[1]);   // a 30 FPS frame on any host
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_zoom_256_is_an_exact_copy);
+  RUN_TEST(test_crop_is_centred);
+  RUN_TEST(test_downscale_stays_inside_the_source);
+  RUN_TEST(test_bilinear_matches_reference);
+  RUN_TEST(test_bad_sizes_are_refused);
+  RUN_TEST(test_swapped_matches_native);
+  RUN_TEST(test_scale_cost);
+  return UNITY_END();
+}
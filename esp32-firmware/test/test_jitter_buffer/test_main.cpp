@@ -0,0 +1,325 @@
+// JitterBuffer (audio/jitter_buffer.h) under simulated packet timing.
+//
+//   pio test -e native-test -f test_jitter_buffer
+//
+// A sender emits 20 ms frames on its own clock, a network model delays,
+// drops, reorders, duplicates or stalls them, and the consumer pulls 128
+// samples per I2S period the way netAudioFeed() does. Arrivals and pulls
+// are merged on one microsecond timeline, so each scenario is exactly
+// reproducible. Sample rate and slot count match the firmware
+// (24 kHz TTS, NET_AUDIO_SLOTS).
+#include <unity.h>
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+#include "audio/jitter_buffer.h"
+
+#define SIM_RATE 24000
+#define SIM_FRAME_SAMPLES 480   // AUDIO_STREAM_FRAME_MS at SIM_RATE
+#define SIM_SLOTS 32            // NET_AUDIO_SLOTS
+#define SIM_PULL_SAMPLES 128    // NET_AUDIO_PULL_SAMPLES
+
+void setUp() {}
+void tearDown() {}
+
+struct Lcg {
+  uint32_t state;
+  uint32_t next(uint32_t range)
+  {
+    state = state * 1664525U + 1013904223U;
+    return (state >> 8) % range;
+  }
+};
+
+struct NetModel {
+  const char *name;
+  int32_t driftPpm;         // sender clock against the I2S clock, positive = sender fast
+  uint32_t baseDelayUs;
+  uint32_t jitterUs;        // uniform extra delay 0..jitterUs
+  uint32_t spikePermille;   // frames that get spikeUs on top
+  uint32_t spikeUs;
+  uint32_t lossPermille;
+  uint32_t reorderPermille; // frame swapped with its successor
+  uint32_t dupPermille;
+  uint32_t stallAtMs;       // Wi-Fi stall: nothing arrives in [at, at + len), then a burst
+  uint32_t stallMs;
+  uint32_t frames;
+};
+
+struct SimResult {
+  JitterBufferStats stats;
+  uint32_t firstAudioMs;
+  uint32_t maxDepthMs;
+  uint64_t depthMsSum;
+  uint32_t depthSamples;
+  uint32_t endedMs;         // 0: never reached JB_STATE_ENDED
+  uint32_t mismatches;      // only counted when checkContent is set
+  uint16_t finalTarget;
+  float finalJitterMs;
+};
+
+struct Arrival {
+  uint64_t atUs;
+  uint32_t frame;
+  uint32_t seq;             // tie-break, keeps the simulation deterministic
+};
+
+// Frame n, sample k: a pattern that makes every sample position distinct.
+static inline int16_t senderSample(uint32_t frame, uint32_t k)
+{
+  const uint32_t n = frame * SIM_FRAME_SAMPLES + k;
+  return (int16_t)((n * 37U) & 0x3FFF) - 0x2000;
+}
+
+static SimResult runSim(const NetModel &m, uint32_t seed, bool checkContent = false)
+{
+  static int16_t pcm[(SIM_SLOTS + 1) * SIM_FRAME_SAMPLES];
+  static uint32_t tags[SIM_SLOTS];
+  JitterBuffer jb;
+  jitterBufferInit(&jb, pcm, tags, SIM_SLOTS, SIM_FRAME_SAMPLES);
+  TEST_ASSERT_TRUE(jitterBufferStart(&jb, SIM_RATE, SIM_FRAME_SAMPLES));
+
+  Lcg rng{seed};
+  const double periodUs = 20000.0 / (1.0 + m.driftPpm * 1e-6);
+  std::vector<Arrival> arrivals;
+  uint32_t seq = 0;
+  for (uint32_t n = 0; n < m.frames; ++n) {
+    if (rng.next(1000) < m.lossPermille) {
+      continue;
+    }
+    uint64_t at = (uint64_t)(n * periodUs) + m.baseDelayUs + rng.next(m.jitterUs + 1);
+    if (rng.next(1000) < m.spikePermille) {
+      at += m.spikeUs;
+    }
+    const uint64_t stallFrom = (uint64_t)m.stallAtMs * 1000;
+    const uint64_t stallTo = stallFrom + (uint64_t)m.stallMs * 1000;
+    if (m.stallMs > 0 && at >= stallFrom && at < stallTo) {
+      at = stallTo + (at - stallFrom) / 50;   // queued in the AP, released back to back
+    }
+    arrivals.push_back({at, n, seq++});
+    if (rng.next(1000) < m.dupPermille) {
+      arrivals.push_back({at + 1000, n, seq++});
+    }
+  }
+  for (size_t i = 0; i + 1 < arrivals.size(); ++i) {
+    if (rng.next(1000) < m.reorderPermille) {
+      std::swap(arrivals[i].atUs, arrivals[i + 1].atUs);
+      ++i;
+    }
+  }
+  std::stable_sort(arrivals.begin(), arrivals.end(), [](const Arrival &a, const Arrival &b) {
+    return a.atUs != b.atUs ? a.atUs < b.atUs : a.seq < b.seq;
+  });
+
+  SimResult r = {};
+  int16_t frameBuf[SIM_FRAME_SAMPLES];
+  int16_t out[SIM_PULL_SAMPLES];
+  const uint64_t pullUs = (uint64_t)SIM_PULL_SAMPLES * 1000000U / SIM_RATE;
+  uint64_t nextPullUs = 0;
+  uint64_t played = 0;
+  size_t a = 0;
+  bool endMarked = false;
+  const uint64_t limitUs = (uint64_t)(m.frames * periodUs) + 10000000ULL;
+
+  while (nextPullUs < limitUs && jb.state != JB_STATE_ENDED) {
+    while (a < arrivals.size() && arrivals[a].atUs <= nextPullUs) {
+      const uint32_t n = arrivals[a].frame;
+      for (uint32_t k = 0; k < SIM_FRAME_SAMPLES; ++k) {
+        frameBuf[k] = senderSample(n, k);
+      }
+      jitterBufferPush(&jb, n, frameBuf, SIM_FRAME_SAMPLES, (uint32_t)(arrivals[a].atUs / 1000));
+      ++a;
+    }
+    if (a == arrivals.size() && !endMarked) {
+      jitterBufferMarkEnd(&jb);
+      endMarked = true;
+    }
+
+    const uint32_t playedBefore = jb.stats.samplesPlayed;
+    jitterBufferPull(&jb, out, SIM_PULL_SAMPLES);
+    if (jb.stats.samplesPlayed > 0 && r.firstAudioMs == 0) {
+      r.firstAudioMs = (uint32_t)(nextPullUs / 1000) | 1;
+    }
+    if (checkContent && jb.stats.samplesPlayed > playedBefore) {
+      for (uint32_t i = 0; i < SIM_PULL_SAMPLES && played < (uint64_t)m.frames * SIM_FRAME_SAMPLES; ++i, ++played) {
+        // The first JB_FADE_IN_SAMPLES ramp up from silence.
+        if (played >= JB_FADE_IN_SAMPLES &&
+            out[i] != senderSample((uint32_t)(played / SIM_FRAME_SAMPLES), (uint32_t)(played % SIM_FRAME_SAMPLES))) {
+          r.mismatches++;
+        }
+      }
+    }
+    if (jb.state == JB_STATE_PLAYING) {
+      const uint32_t depth = jitterBufferDepthMs(&jb);
+      r.maxDepthMs = std::max(r.maxDepthMs, depth);
+      r.depthMsSum += depth;
+      r.depthSamples++;
+    }
+    if (jb.state == JB_STATE_ENDED) {
+      r.endedMs = (uint32_t)(nextPullUs / 1000);
+    }
+    nextPullUs += pullUs;
+  }
+
+  r.stats = jb.stats;
+  r.finalTarget = jb.targetFrames;
+  r.finalJitterMs = jb.jitterMs;
+  return r;
+}
+
+static uint32_t avgDepthMs(const SimResult &r)
+{
+  return r.depthSamples ? (uint32_t)(r.depthMsSum / r.depthSamples) : 0;
+}
+
+static void report(const NetModel &m, const SimResult &r)
+{
+  char msg[256];
+  const int32_t ppm = (r.stats.samplesPlayed == 0) ? 0 :
+      (int32_t)(((int64_t)r.stats.samplesInserted - (int64_t)r.stats.samplesDropped) * 1000000LL /
+                (int64_t)r.stats.samplesPlayed);
+  snprintf(msg, sizeof(msg),
+           "%s: first audio %u ms, depth avg %u max %u ms, target %u, jitter %.1f ms, underruns %u, "
+           "concealed %u (lost %u), late %u, dup %u, skipped %u, overflows %u, correction %d ppm",
+           m.name, (unsigned)r.firstAudioMs, (unsigned)avgDepthMs(r), (unsigned)r.maxDepthMs,
+           (unsigned)r.finalTarget, r.finalJitterMs, (unsigned)r.stats.underruns, (unsigned)r.stats.concealed,
+           (unsigned)r.stats.lost, (unsigned)r.stats.late, (unsigned)r.stats.duplicates, (unsigned)r.stats.skipped,
+           (unsigned)r.stats.overflows, (int)ppm);
+  TEST_MESSAGE(msg);
+}
+
+// LAN, same clock: every sample comes out unchanged and on time.
+void test_clean_link_is_bit_exact()
+{
+  const NetModel m = {"clean", 0, 3000, 1000, 0, 0, 0, 0, 0, 0, 0, 1500};
+  const SimResult r = runSim(m, 1, true);
+  report(m, r);
+  TEST_ASSERT_EQUAL_UINT32(0, r.mismatches);
+  TEST_ASSERT_EQUAL_UINT32(0, r.stats.underruns);
+  TEST_ASSERT_EQUAL_UINT32(0, r.stats.concealed);
+  TEST_ASSERT_EQUAL_UINT32(0, r.stats.samplesDropped + r.stats.samplesInserted);
+  TEST_ASSERT_EQUAL_UINT32(m.frames * SIM_FRAME_SAMPLES, r.stats.samplesPlayed);
+  TEST_ASSERT_NOT_EQUAL(0, r.endedMs);
+  TEST_ASSERT_LESS_OR_EQUAL(60, r.firstAudioMs);
+}
+
+// Sender clock off by +/-300 ppm (two cheap crystals): the fill must not
+// creep, and the net correction has to match the drift.
+static void checkDrift(int32_t driftPpm)
+{
+  char name[32];
+  snprintf(name, sizeof(name), "drift %+d ppm", (int)driftPpm);
+  // 5 minutes: 300 ppm is 90 ms, several frames of creep if left alone.
+  const NetModel m = {name, driftPpm, 4000, 4000, 0, 0, 0, 0, 0, 0, 0, 15000};
+  const SimResult r = runSim(m, 2);
+  report(m, r);
+  TEST_ASSERT_EQUAL_UINT32(0, r.stats.underruns);
+  TEST_ASSERT_EQUAL_UINT32(0, r.stats.concealed);
+  TEST_ASSERT_EQUAL_UINT32(0, r.stats.skipped);
+  TEST_ASSERT_LESS_OR_EQUAL((r.finalTarget + 2) * 20, r.maxDepthMs);
+  const int32_t ppm = (int32_t)(((int64_t)r.stats.samplesInserted - (int64_t)r.stats.samplesDropped) * 1000000LL /
+                                (int64_t)r.stats.samplesPlayed);
+  // Sender fast means too many samples: the buffer drops (negative ppm).
+  TEST_ASSERT_INT32_WITHIN(driftPpm / 3 > 0 ? driftPpm / 3 : -driftPpm / 3, -driftPpm, ppm);
+}
+
+void test_sender_clock_fast()
+{
+  checkDrift(300);
+}
+
+void test_sender_clock_slow()
+{
+  checkDrift(-300);
+}
+
+// Busy Wi-Fi: 0-30 ms spread plus 2% of frames 120 ms late. The target
+// has to grow to cover the spread; the spikes may cost concealment but not
+// a rebuffer each.
+void test_wifi_jitter_grows_target()
+{
+  const NetModel m = {"wifi jitter", 0, 5000, 30000, 20, 120000, 0, 0, 0, 0, 0, 6000};
+  const SimResult r = runSim(m, 3);
+  report(m, r);
+  TEST_ASSERT_GREATER_OR_EQUAL(3, r.finalTarget);
+  TEST_ASSERT_LESS_OR_EQUAL(5, r.stats.underruns);
+  // Concealed frames are under 1% of the stream.
+  TEST_ASSERT_LESS_OR_EQUAL(m.frames / 100, r.stats.concealed);
+  TEST_ASSERT_LESS_OR_EQUAL(SIM_SLOTS * 20, r.maxDepthMs);
+}
+
+// 3% random loss: each gap is concealed in place, playout never stops. A
+// gap whose successor has not arrived yet counts as starvation, not loss.
+void test_random_loss_is_concealed()
+{
+  const NetModel m = {"loss 3%", 0, 4000, 5000, 0, 0, 30, 0, 0, 0, 0, 3000};
+  const SimResult r = runSim(m, 4);
+  report(m, r);
+  TEST_ASSERT_EQUAL_UINT32(0, r.stats.underruns);
+  TEST_ASSERT_UINT32_WITHIN(m.frames * 2 / 100, m.frames * 3 / 100, r.stats.lost);
+  TEST_ASSERT_GREATER_OR_EQUAL(r.stats.lost, r.stats.concealed);
+  TEST_ASSERT_LESS_OR_EQUAL(r.stats.lost + r.stats.lost / 10, r.stats.concealed);
+  TEST_ASSERT_NOT_EQUAL(0, r.endedMs);
+}
+
+// Swapped neighbours and duplicates: the buffer absorbs both. Only swaps in
+// the first second, before the jitter estimate has lifted the target off
+// the 2-frame minimum, may arrive too late.
+void test_reorder_and_duplicates()
+{
+  const NetModel m = {"reorder+dup", 0, 4000, 3000, 0, 0, 0, 50, 20, 0, 0, 3000};
+  const SimResult r = runSim(m, 5);
+  report(m, r);
+  TEST_ASSERT_LESS_OR_EQUAL(2, r.stats.late);
+  TEST_ASSERT_EQUAL_UINT32(r.stats.late, r.stats.lost);
+  TEST_ASSERT_EQUAL_UINT32(0, r.stats.underruns);
+  TEST_ASSERT_GREATER_THAN(0, r.stats.duplicates);
+  // Every sender sample is played once: a drop merges two into one output.
+  TEST_ASSERT_EQUAL_UINT32(m.frames * SIM_FRAME_SAMPLES, r.stats.samplesPlayed + r.stats.samplesDropped);
+}
+
+// A 400 ms stall (AP roaming) then everything at once: one rebuffer, the
+// backlog is trimmed instead of adding 400 ms of latency for the rest of
+// the stream, and it still plays to the end.
+void test_stall_then_burst()
+{
+  const NetModel m = {"stall 400 ms", 0, 4000, 3000, 0, 0, 0, 0, 0, 5000, 400, 1000};
+  const SimResult r = runSim(m, 6);
+  report(m, r);
+  TEST_ASSERT_LESS_OR_EQUAL(1, r.stats.underruns);
+  TEST_ASSERT_GREATER_THAN(0, r.stats.skipped + r.stats.overflows + r.stats.late);
+  TEST_ASSERT_LESS_OR_EQUAL(SIM_SLOTS * 20, r.maxDepthMs);
+  TEST_ASSERT_NOT_EQUAL(0, r.endedMs);
+  // Stream is 20 s; the stall must not push the end out by its full length
+  // on top of the buffered depth.
+  TEST_ASSERT_LESS_OR_EQUAL(m.frames * 20 + 400 + 200, r.endedMs);
+}
+
+// Everything together over 10 minutes, several seeds.
+void test_soak()
+{
+  for (uint32_t seed = 10; seed < 14; ++seed) {
+    const NetModel m = {"soak", (int32_t)(seed * 53) - 600, 6000, 20000, 5, 80000, 10, 10, 5,
+                        60000 + seed * 1000, 250, 30000};
+    const SimResult r = runSim(m, seed);
+    report(m, r);
+    TEST_ASSERT_LESS_OR_EQUAL(8, r.stats.underruns);
+    TEST_ASSERT_LESS_OR_EQUAL(m.frames * 3 / 100, r.stats.concealed);
+    TEST_ASSERT_LESS_OR_EQUAL(SIM_SLOTS * 20, r.maxDepthMs);
+    TEST_ASSERT_NOT_EQUAL(0, r.endedMs);
+  }
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_clean_link_is_bit_exact);
+  RUN_TEST(test_sender_clock_fast);
+  RUN_TEST(test_sender_clock_slow);
+  RUN_TEST(test_wifi_jitter_grows_target);
+  RUN_TEST(test_random_loss_is_concealed);
+  RUN_TEST(test_reorder_and_duplicates);
+  RUN_TEST(test_stall_then_burst);
+  RUN_TEST(test_soak);
+  return UNITY_END();
+}
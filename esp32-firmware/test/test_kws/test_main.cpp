@@ -0,0 +1,523 @@
+// Wake word front end and model (audio/kws_features.h, audio/kws_model.h):
+// MFCC accuracy, model blob parsing, detection and cost per 20 ms hop.
+//
+//   pio test -e native-test -f test_kws
+//   KWS_WAV_DIR=/path/to/clips pio test -e native-test -f test_kws
+//
+// The MFCC references are the same front end computed in double precision
+// with a direct DFT. tiny_model.bin is a 4-frame, 3-unit model in the SD
+// card format, small enough that the expected probability can be worked out
+// by hand (the weights follow the rule in tinyModelBlob()). The cost test
+// runs what kwsTask does per hop, front end and window push every hop plus
+// an inference every KWS_INFER_EVERY_HOPS, on synthetic speech or on every
+// 16 kHz mono <name>.wav in KWS_WAV_DIR, with a model of the largest size
+// the parser accepts.
+#include <unity.h>
+#include <chrono>
+#include <dirent.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "audio/kws_model.h"
+
+#define INFER_EVERY_HOPS 2       // KWS_INFER_EVERY_HOPS in main.cpp
+
+void setUp() {}
+void tearDown() {}
+
+struct Lcg {
+  uint32_t state;
+  uint32_t next(uint32_t range)
+  {
+    state = state * 1664525U + 1013904223U;
+    return (state >> 8) % range;
+  }
+};
+
+// The front end is ~13 KB, kept off the stack as on the device.
+static KwsFrontEnd frontEnd;
+
+static std::vector<int16_t> tone(double hz, double amplitude, size_t samples)
+{
+  std::vector<int16_t> pcm(samples);
+  for (size_t i = 0; i < samples; ++i) {
+    pcm[i] = (int16_t)lrint(amplitude * sin(2 * M_PI * hz * i / KWS_SAMPLE_RATE));
+  }
+  return pcm;
+}
+
+// Model blobs are built into uint32_t storage so they are 4-byte aligned,
+// as kwsModelParse() requires.
+struct ModelBlob {
+  std::vector<uint32_t> words;
+  size_t len;
+  const uint8_t *bytes() const { return (const uint8_t *)words.data(); }
+  uint8_t *bytes() { return (uint8_t *)words.data(); }
+};
+
+static void put16(std::vector<uint8_t> *b, uint16_t v)
+{
+  b->push_back((uint8_t)v);
+  b->push_back((uint8_t)(v >> 8));
+}
+
+static void putFloat(std::vector<uint8_t> *b, float v)
+{
+  uint8_t raw[4];
+  memcpy(raw, &v, 4);
+  b->insert(b->end(), raw, raw + 4);
+}
+
+static void put32(std::vector<uint8_t> *b, int32_t v)
+{
+  for (int i = 0; i < 4; ++i) {
+    b->push_back((uint8_t)((uint32_t)v >> (8 * i)));
+  }
+}
+
+static ModelBlob packModel(uint16_t frames, uint16_t hidden, float inputScale, float hiddenScale, float outputScale,
+                           float threshold, const std::vector<int8_t> &w1, const std::vector<int32_t> &b1,
+                           const std::vector<int8_t> &w2, const std::vector<int32_t> &b2)
+{
+  std::vector<uint8_t> b(KWS_MODEL_MAGIC, KWS_MODEL_MAGIC + 4);
+  put16(&b, frames);
+  put16(&b, KWS_MFCC_COUNT);
+  put16(&b, hidden);
+  put16(&b, 2);
+  putFloat(&b, inputScale);
+  putFloat(&b, hiddenScale);
+  putFloat(&b, outputScale);
+  putFloat(&b, threshold);
+  b.insert(b.end(), (const uint8_t *)w1.data(), (const uint8_t *)w1.data() + w1.size());
+  b.resize(kwsAlign4(b.size()), 0);
+  for (int32_t v : b1) {
+    put32(&b, v);
+  }
+  b.insert(b.end(), (const uint8_t *)w2.data(), (const uint8_t *)w2.data() + w2.size());
+  b.resize(kwsAlign4(b.size()), 0);
+  for (int32_t v : b2) {
+    put32(&b, v);
+  }
+  ModelBlob blob;
+  blob.len = b.size();
+  blob.words.assign((b.size() + 3) / 4, 0);
+  memcpy(blob.words.data(), b.data(), b.size());
+  return blob;
+}
+
+// tiny_model.bin: 4 frames, 3 hidden units, scales 0.5, 1/64, 1/128,
+// threshold 0.75, w1[h][i] = (31h + 7i) % 15 - 7, b1 = {-150, -50, 50},
+// w2 = {{-1, 0, 1}, {-3, 2, 0}}, b2 = {-64, 64}.
+static ModelBlob tinyModelBlob()
+{
+  std::vector<int8_t> w1;
+  for (int h = 0; h < 3; ++h) {
+    for (int i = 0; i < 4 * KWS_MFCC_COUNT; ++i) {
+      w1.push_back((int8_t)((h * 31 + i * 7) % 15 - 7));
+    }
+  }
+  return packModel(4, 3, 0.5f, 1.0f / 64, 1.0f / 128, 0.75f, w1, {-150, -50, 50}, {-1, 0, 1, -3, 2, 0}, {-64, 64});
+}
+
+static ModelBlob randomModelBlob(uint16_t frames, uint16_t hidden, uint32_t seed)
+{
+  Lcg rng{seed};
+  std::vector<int8_t> w1((size_t)hidden * frames * KWS_MFCC_COUNT);
+  for (int8_t &w : w1) {
+    w = (int8_t)((int)rng.next(255) - 127);
+  }
+  std::vector<int32_t> b1(hidden);
+  for (int32_t &b : b1) {
+    b = (int32_t)rng.next(20001) - 10000;
+  }
+  std::vector<int8_t> w2((size_t)2 * hidden);
+  for (int8_t &w : w2) {
+    w = (int8_t)((int)rng.next(255) - 127);
+  }
+  return packModel(frames, hidden, 0.25f, 1.0f / 4096, 1.0f / 256, 0.8f, w1, b1, w2, {0, 0});
+}
+
+// kwsModelRun() in double precision, rounding as lroundf does.
+static double referenceRun(const KwsModel &m, const int8_t *input)
+{
+  const size_t inputs = (size_t)m.frames * m.features;
+  std::vector<double> hidden(m.hidden);
+  for (size_t h = 0; h < m.hidden; ++h) {
+    int64_t acc = m.b1[h];
+    for (size_t i = 0; i < inputs; ++i) {
+      acc += (int64_t)m.w1[h * inputs + i] * input[i];
+    }
+    const double q = (acc > 0) ? round((double)acc * m.hiddenScale) : 0.0;
+    hidden[h] = (q > 127.0) ? 127.0 : q;
+  }
+  double logits[2];
+  for (int c = 0; c < 2; ++c) {
+    double acc = m.b2[c];
+    for (size_t h = 0; h < m.hidden; ++h) {
+      acc += m.w2[c * m.hidden + h] * hidden[h];
+    }
+    logits[c] = acc * m.outputScale;
+  }
+  return 1.0 / (1.0 + exp(logits[0] - logits[1]));
+}
+
+// --- front end ---------------------------------------------------------------
+
+// Silence floors every band at log(1e-6); the orthonormal DCT puts all of it
+// in c0 and nothing in the rest.
+void test_mfcc_silence()
+{
+  kwsFrontEndInit(&frontEnd);
+  const std::vector<int16_t> hop(KWS_HOP_SAMPLES, 0);
+  float mfcc[KWS_MFCC_COUNT];
+  kwsFrontEndProcess(&frontEnd, hop.data(), mfcc);
+  TEST_ASSERT_FLOAT_WITHIN(0.01, sqrt((double)KWS_MEL_BANDS) * log(1e-6), mfcc[0]);
+  for (int c = 1; c < KWS_MFCC_COUNT; ++c) {
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 0.0, mfcc[c]);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, frontEnd.lastEnergy);
+}
+
+struct ToneReference {
+  double hz;
+  double amplitude;
+  int peakBand;
+  float mfcc[KWS_MFCC_COUNT];
+};
+
+// Third hop of a tone starting at sample 0, so the 512-sample window is
+// samples 448..959.
+static const ToneReference TONE_REFERENCES[] = {
+  {1000, 16384, 10, {-67.0860f, 7.6690f, -7.0919f, -15.1219f, -7.9130f, 6.1746f, 13.8256f, 7.5660f, -5.0095f, -11.8240f}},
+  {250, 4096, 2, {-67.9962f, 12.5700f, 12.0513f, 9.7204f, 7.0590f, 4.2842f, 0.8124f, -1.5080f, -4.4729f, -6.4000f}},
+};
+
+void test_mfcc_tone_reference()
+{
+  for (const ToneReference &ref : TONE_REFERENCES) {
+    const std::vector<int16_t> pcm = tone(ref.hz, ref.amplitude, 3 * KWS_HOP_SAMPLES);
+    kwsFrontEndInit(&frontEnd);
+    float mfcc[KWS_MFCC_COUNT];
+    for (int h = 0; h < 3; ++h) {
+      kwsFrontEndProcess(&frontEnd, &pcm[h * KWS_HOP_SAMPLES], mfcc);
+    }
+    float worst = 0.0f;
+    for (int c = 0; c < KWS_MFCC_COUNT; ++c) {
+      TEST_ASSERT_FLOAT_WITHIN(0.005, ref.mfcc[c], mfcc[c]);
+      worst = fmaxf(worst, fabsf(mfcc[c] - ref.mfcc[c]));
+    }
+    int peak = 0;
+    for (int m = 1; m < KWS_MEL_BANDS; ++m) {
+      peak = (frontEnd.logMel[m] > frontEnd.logMel[peak]) ? m : peak;
+    }
+    TEST_ASSERT_EQUAL_INT(ref.peakBand, peak);
+
+    uint32_t absSum = 0;
+    for (int i = 2 * KWS_HOP_SAMPLES; i < 3 * KWS_HOP_SAMPLES; ++i) {
+      absSum += (uint32_t)abs(pcm[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(absSum / KWS_HOP_SAMPLES, frontEnd.lastEnergy);
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%.0f Hz: worst MFCC error %.5f, peak band %d", ref.hz, worst, peak);
+    TEST_MESSAGE(msg);
+  }
+}
+
+// --- model -------------------------------------------------------------------
+
+void test_model_parse_blob()
+{
+  std::string path = __FILE__;
+  const size_t slash = path.find_last_of("/\\");
+  path = (slash == std::string::npos ? std::string() : path.substr(0, slash + 1)) + "tiny_model.bin";
+  FILE *f = fopen(path.c_str(), "rb");
+  TEST_ASSERT_NOT_NULL_MESSAGE(f, "tiny_model.bin not found next to test_main.cpp");
+  ModelBlob blob;
+  blob.words.assign(64, 0);
+  blob.len = fread(blob.bytes(), 1, blob.words.size() * 4, f);
+  fclose(f);
+
+  // The checked-in file is exactly what the rule above describes.
+  const ModelBlob expected = tinyModelBlob();
+  TEST_ASSERT_EQUAL_UINT32(176, blob.len);
+  TEST_ASSERT_EQUAL_UINT32(expected.len, blob.len);
+  TEST_ASSERT_EQUAL_MEMORY(expected.bytes(), blob.bytes(), blob.len);
+
+  KwsModel model;
+  TEST_ASSERT_TRUE(kwsModelParse(blob.bytes(), blob.len, &model));
+  TEST_ASSERT_EQUAL_UINT16(4, model.frames);
+  TEST_ASSERT_EQUAL_UINT16(KWS_MFCC_COUNT, model.features);
+  TEST_ASSERT_EQUAL_UINT16(3, model.hidden);
+  TEST_ASSERT_EQUAL_UINT16(2, model.classes);
+  TEST_ASSERT_EQUAL_FLOAT(0.75f, model.threshold);
+  TEST_ASSERT_EQUAL_INT32(-150, model.b1[0]);
+  TEST_ASSERT_EQUAL_INT32(64, model.b2[1]);
+  TEST_ASSERT_EQUAL_INT8(-3, model.w2[3]);
+
+  // Worked by hand: hidden accumulators 2010, 2025, -1290 -> 31, 32, 0;
+  // logits -95/128 and 35/128 -> 1 / (1 + e^(-130/128)).
+  int8_t input[4 * KWS_MFCC_COUNT];
+  for (int i = 0; i < 4 * KWS_MFCC_COUNT; ++i) {
+    input[i] = (int8_t)((i * 37) % 255 - 127);
+  }
+  TEST_ASSERT_FLOAT_WITHIN(1e-5, 1.0 / (1.0 + exp(-130.0 / 128.0)), kwsModelRun(&model, input));
+
+  Lcg rng{11};
+  for (int round = 0; round < 200; ++round) {
+    for (int8_t &v : input) {
+      v = (int8_t)((int)rng.next(256) - 128);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-5, referenceRun(model, input), kwsModelRun(&model, input));
+  }
+}
+
+static void setField16(ModelBlob *blob, size_t offset, uint16_t v)
+{
+  memcpy(blob->bytes() + offset, &v, 2);
+}
+
+static void setFieldFloat(ModelBlob *blob, size_t offset, float v)
+{
+  memcpy(blob->bytes() + offset, &v, 4);
+}
+
+void test_model_parse_malformed()
+{
+  const ModelBlob good = tinyModelBlob();
+  KwsModel model;
+  TEST_ASSERT_TRUE(kwsModelParse(good.bytes(), good.len, &model));
+  TEST_ASSERT_FALSE(kwsModelParse(nullptr, good.len, &model));
+  for (size_t len = 0; len < good.len; ++len) {
+    TEST_ASSERT_FALSE(kwsModelParse(good.bytes(), len, &model));
+  }
+
+  // Misaligned: the same bytes one past a word boundary.
+  std::vector<uint32_t> shifted(good.words.size() + 1, 0);
+  memcpy((uint8_t *)shifted.data() + 1, good.bytes(), good.len);
+  TEST_ASSERT_FALSE(kwsModelParse((const uint8_t *)shifted.data() + 1, good.len, &model));
+
+  struct Mutation {
+    const char *name;
+    size_t offset;
+    bool isFloat;
+    float value;
+  };
+  const Mutation mutations[] = {
+    {"magic", 3, false, 0x3230},          // "KW02"
+    {"frames 0", 4, false, 0},
+    {"frames above max", 4, false, KWS_MAX_FRAMES + 1},
+    {"features", 6, false, KWS_MFCC_COUNT + 1},
+    {"hidden 0", 8, false, 0},
+    {"hidden above max", 8, false, KWS_MAX_HIDDEN + 1},
+    {"classes", 10, false, 3},
+    {"input scale 0", 12, true, 0.0f},
+    {"input scale NaN", 12, true, NAN},
+    {"hidden scale negative", 16, true, -1.0f / 64},
+    {"output scale NaN", 20, true, NAN},
+    {"threshold 0", 24, true, 0.0f},
+    {"threshold above 1", 24, true, 1.5f},
+  };
+  for (const Mutation &m : mutations) {
+    ModelBlob bad = good;
+    if (m.isFloat) {
+      setFieldFloat(&bad, m.offset, m.value);
+    } else {
+      setField16(&bad, m.offset, (uint16_t)m.value);
+    }
+    TEST_ASSERT_FALSE_MESSAGE(kwsModelParse(bad.bytes(), bad.len, &model), m.name);
+  }
+
+  // A header claiming more weights than the file holds.
+  ModelBlob longer = good;
+  setField16(&longer, 4, 5);
+  TEST_ASSERT_FALSE(kwsModelParse(longer.bytes(), longer.len, &model));
+  // The largest model the parser accepts is fine.
+  const ModelBlob big = randomModelBlob(KWS_MAX_FRAMES, KWS_MAX_HIDDEN, 3);
+  TEST_ASSERT_TRUE(kwsModelParse(big.bytes(), big.len, &model));
+  TEST_ASSERT_FALSE(kwsModelParse(big.bytes(), big.len - 1, &model));
+}
+
+// Four hops at 0.9 cross the 0.75 threshold on the fourth; the refractory
+// period then holds off a second trigger, and skipped hops count as 0.
+void test_detector_triggers_once()
+{
+  const ModelBlob blob = tinyModelBlob();
+  KwsModel model;
+  TEST_ASSERT_TRUE(kwsModelParse(blob.bytes(), blob.len, &model));
+  KwsDetector detector;
+  kwsDetectorReset(&detector);
+  const float mfcc[KWS_MFCC_COUNT] = {-100.0f, 1.0f, 0.26f, 0.24f, -0.25f, 0, 0, 0, 0, 63.9f};
+  kwsDetectorPush(&detector, &model, mfcc);
+  const int8_t quantized[KWS_MFCC_COUNT] = {-128, 2, 1, 0, -1, 0, 0, 0, 0, 127};
+  TEST_ASSERT_EQUAL_INT8_ARRAY(quantized, detector.window + 3 * KWS_MFCC_COUNT, KWS_MFCC_COUNT);
+  // Not scored until the window is full.
+  TEST_ASSERT_FALSE(kwsDetectorUpdate(&detector, &model, 1.0f, 0));
+  kwsDetectorReset(&detector);
+  for (int i = 0; i < 4; ++i) {
+    kwsDetectorPush(&detector, &model, mfcc);
+  }
+
+  uint32_t now = 1000;
+  TEST_ASSERT_FALSE(kwsDetectorUpdate(&detector, &model, 0.9f, now += 40));
+  TEST_ASSERT_FALSE(kwsDetectorUpdate(&detector, &model, 0.9f, now += 40));
+  TEST_ASSERT_FALSE(kwsDetectorUpdate(&detector, &model, 0.9f, now += 40));
+  TEST_ASSERT_TRUE(kwsDetectorUpdate(&detector, &model, 0.9f, now += 40));
+  const uint32_t triggeredAt = now;
+  uint32_t triggers = 0;
+  while (now - triggeredAt < KWS_REFRACTORY_MS - 40) {
+    triggers += kwsDetectorUpdate(&detector, &model, 0.9f, now += 40) ? 1 : 0;
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, triggers);
+  // Past the refractory period a skipped hop counts as 0 and holds the mean
+  // at 3 * 0.9 / 4 until it leaves the smoothing window.
+  TEST_ASSERT_FALSE(kwsDetectorUpdate(&detector, &model, -1.0f, now += 40));
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, detector.lastScore);
+  for (int i = 0; i < KWS_SMOOTH_FRAMES - 1; ++i) {
+    TEST_ASSERT_FALSE(kwsDetectorUpdate(&detector, &model, 0.9f, now += 40));
+  }
+  TEST_ASSERT_TRUE(kwsDetectorUpdate(&detector, &model, 0.9f, now += 40));
+}
+
+// --- cost --------------------------------------------------------------------
+
+static bool readWav(const std::string &path, std::vector<int16_t> *pcm)
+{
+  FILE *f = fopen(path.c_str(), "rb");
+  if (f == nullptr) {
+    return false;
+  }
+  uint8_t riff[12];
+  bool ok = fread(riff, 1, 12, f) == 12 && memcmp(riff, "RIFF", 4) == 0 && memcmp(riff + 8, "WAVE", 4) == 0;
+  bool formatOk = false;
+  while (ok) {
+    uint8_t header[8];
+    if (fread(header, 1, 8, f) != 8) {
+      ok = false;
+      break;
+    }
+    const uint32_t size = header[4] | (header[5] << 8) | (header[6] << 16) | ((uint32_t)header[7] << 24);
+    if (memcmp(header, "fmt ", 4) == 0) {
+      uint8_t fmt[16];
+      ok = size >= 16 && fread(fmt, 1, 16, f) == 16;
+      const uint16_t format = fmt[0] | (fmt[1] << 8);
+      const uint16_t channels = fmt[2] | (fmt[3] << 8);
+      const uint32_t rate = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16) | ((uint32_t)fmt[7] << 24);
+      const uint16_t bits = fmt[14] | (fmt[15] << 8);
+      formatOk = ok && format == 1 && channels == 1 && rate == KWS_SAMPLE_RATE && bits == 16;
+      fseek(f, (long)(size - 16 + (size & 1)), SEEK_CUR);
+    } else if (memcmp(header, "data", 4) == 0) {
+      pcm->resize(size / 2);
+      ok = formatOk && fread(pcm->data(), 2, pcm->size(), f) == pcm->size();
+      break;
+    } else {
+      fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+    }
+  }
+  fclose(f);
+  return ok;
+}
+
+struct Clip {
+  std::string name;
+  std::vector<int16_t> pcm;
+};
+
+static std::vector<Clip> costClips()
+{
+  std::vector<Clip> clips;
+  const char *dir = getenv("KWS_WAV_DIR");
+  if (dir != nullptr && dir[0] != '\0') {
+    DIR *d = opendir(dir);
+    TEST_ASSERT_NOT_NULL(d);
+    while (dirent *entry = readdir(d)) {
+      const std::string name = entry->d_name;
+      if (name.size() < 5 || name.compare(name.size() - 4, 4, ".wav") != 0) {
+        continue;
+      }
+      Clip clip;
+      clip.name = name;
+      if (readWav(std::string(dir) + "/" + name, &clip.pcm) && clip.pcm.size() >= KWS_HOP_SAMPLES) {
+        clips.push_back(clip);
+      }
+    }
+    closedir(d);
+    TEST_ASSERT_GREATER_THAN(0, clips.size());
+    return clips;
+  }
+  // Two seconds of a pitch glide over noise.
+  Clip clip;
+  clip.name = "synthetic";
+  clip.pcm.resize(2 * KWS_SAMPLE_RATE);
+  Lcg rng{5};
+  double phase = 0.0;
+  for (size_t i = 0; i < clip.pcm.size(); ++i) {
+    phase += 2 * M_PI * (140 + 60 * sin(i * 2e-4)) / KWS_SAMPLE_RATE;
+    clip.pcm[i] = (int16_t)(4000 * (sin(phase) + 0.4 * sin(3 * phase)) + (double)rng.next(801) - 400);
+  }
+  clips.push_back(clip);
+  return clips;
+}
+
+// Host time per 20 ms hop. The device figures are the feature and infer
+// averages kwsTask logs; these only track relative changes.
+void test_cost_per_hop()
+{
+  if (getenv("KWS_WAV_DIR") == nullptr) {
+    TEST_MESSAGE("KWS_WAV_DIR not set, timing synthetic speech");
+  }
+  const ModelBlob blob = randomModelBlob(KWS_MAX_FRAMES, KWS_MAX_HIDDEN, 7);
+  KwsModel model;
+  TEST_ASSERT_TRUE(kwsModelParse(blob.bytes(), blob.len, &model));
+  static KwsDetector detector;
+
+  for (const Clip &clip : costClips()) {
+    const size_t hops = clip.pcm.size() / KWS_HOP_SAMPLES;
+    kwsFrontEndInit(&frontEnd);
+    kwsDetectorReset(&detector);
+    float mfcc[KWS_MFCC_COUNT];
+    double featureUs = 0.0;
+    double inferUs = 0.0;
+    uint32_t inferences = 0;
+    float sink = 0.0f;
+    const int rounds = 5;
+    for (int r = 0; r < rounds; ++r) {
+      for (size_t h = 0; h < hops; ++h) {
+        auto t0 = std::chrono::steady_clock::now();
+        kwsFrontEndProcess(&frontEnd, &clip.pcm[h * KWS_HOP_SAMPLES], mfcc);
+        kwsDetectorPush(&detector, &model, mfcc);
+        auto t1 = std::chrono::steady_clock::now();
+        featureUs += std::chrono::duration<double, std::micro>(t1 - t0).count();
+        if (h % INFER_EVERY_HOPS == 0 && detector.filled >= model.frames) {
+          sink += kwsModelRun(&model, detector.window);
+          inferUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t1).count();
+          inferences++;
+        }
+      }
+    }
+    const double perHop = featureUs / (rounds * hops);
+    const double perInfer = (inferences > 0) ? inferUs / inferences : 0.0;
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "%s: %u hops, front end %.1f us/hop, %ux%u model %.1f us/inference, %.1f us/hop total, sink %.2f",
+             clip.name.c_str(), (unsigned)hops, perHop, (unsigned)model.frames, (unsigned)model.hidden, perInfer,
+             perHop + perInfer / INFER_EVERY_HOPS, sink);
+    TEST_MESSAGE(msg);
+    // 1% of the hop budget on any host.
+    TEST_ASSERT_LESS_THAN(200, (int)(perHop + perInfer / INFER_EVERY_HOPS));
+  }
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_mfcc_silence);
+  RUN_TEST(test_mfcc_tone_reference);
+  RUN_TEST(test_model_parse_blob);
+  RUN_TEST(test_model_parse_malformed);
+  RUN_TEST(test_detector_triggers_once);
+  RUN_TEST(test_cost_per_hop);
+  return UNITY_END();
+}
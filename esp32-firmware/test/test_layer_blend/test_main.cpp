@@ -0,0 +1,219 @@
+// Pre-blended overlay (display/layer_blend.h): accuracy and cost per frame.
+//
+//   pio test -e native-test -f test_layer_blend
+//
+// An overlay is "rendered" the way LVGL blends a widget of colour C and
+// opacity A over what is under it, once over black and once over white;
+// layerBlendSplit() turns the two into premul/keep, and layerBlendRun()
+// composes them over a new background. The result is compared with the
+// overlay rendered straight over that background. The cost tests time both
+// kernels on a full 360x360 frame: the split is the non-LVGL part of an
+// overlay rebuild (the rest is two snapshots), the run is the whole
+// per-frame compose pass.
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "display/layer_blend.h"
+
+#define FRAME_RES 360
+#define FRAME_PX (FRAME_RES * FRAME_RES)
+
+void setUp() {}
+void tearDown() {}
+
+struct Lcg {
+  uint32_t state;
+  uint32_t next(uint32_t range)
+  {
+    state = state * 1664525U + 1013904223U;
+    return (state >> 8) % range;
+  }
+};
+
+static inline uint16_t rgb565(uint32_t r, uint32_t g, uint32_t b)
+{
+  return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+// LVGL's blend of one channel: (fg * a + bg * (255 - a)) / 255, rounded.
+static inline uint32_t mixChannel(uint32_t fg, uint32_t bg, uint32_t a)
+{
+  return (fg * a + bg * (255 - a) + 127) / 255;
+}
+
+static uint16_t mix565(uint16_t fg, uint16_t bg, uint32_t a)
+{
+  return rgb565(mixChannel(fg >> 11, bg >> 11, a), mixChannel((fg >> 5) & 0x3F, (bg >> 5) & 0x3F, a),
+                mixChannel(fg & 0x1F, bg & 0x1F, a));
+}
+
+// A page like the home hub: a 20% black shade everywhere, and widgets of
+// every opacity on about a third of the pixels (opaque fills, anti-aliased
+// edges, translucent discs).
+struct Overlay {
+  std::vector<uint16_t> color;
+  std::vector<uint8_t> opa;
+};
+
+static Overlay makeOverlay(uint32_t seed)
+{
+  Overlay o;
+  o.color.resize(FRAME_PX);
+  o.opa.resize(FRAME_PX);
+  Lcg rng{seed};
+  for (int i = 0; i < FRAME_PX; ++i) {
+    const uint32_t kind = rng.next(100);
+    if (kind < 65) {
+      o.color[i] = 0;
+      o.opa[i] = 51;
+    } else {
+      o.color[i] = (uint16_t)rng.next(0x10000);
+      o.opa[i] = (kind < 85) ? 255 : (uint8_t)rng.next(256);
+    }
+  }
+  return o;
+}
+
+static void render(const Overlay &o, const uint16_t *bg, uint16_t *out)
+{
+  for (int i = 0; i < FRAME_PX; ++i) {
+    out[i] = mix565(o.color[i], bg[i], o.opa[i]);
+  }
+}
+
+static int channelError(uint16_t a, uint16_t b)
+{
+  const int dr = abs((int)(a >> 11) - (int)(b >> 11));
+  const int dg = abs((int)((a >> 5) & 0x3F) - (int)((b >> 5) & 0x3F));
+  const int db = abs((int)(a & 0x1F) - (int)(b & 0x1F));
+  return dr > dg ? (dr > db ? dr : db) : (dg > db ? dg : db);
+}
+
+void test_compose_matches_direct_render()
+{
+  const Overlay o = makeOverlay(3);
+  std::vector<uint16_t> black(FRAME_PX, 0);
+  std::vector<uint16_t> white(FRAME_PX, 0xFFFF);
+  std::vector<uint16_t> overBlack(FRAME_PX);
+  std::vector<uint16_t> overWhite(FRAME_PX);
+  render(o, black.data(), overBlack.data());
+  render(o, white.data(), overWhite.data());
+  std::vector<uint16_t> premul(FRAME_PX);
+  std::vector<uint8_t> keep(FRAME_PX);
+  layerBlendSplit(overBlack.data(), overWhite.data(), premul.data(), keep.data(), FRAME_PX, false);
+
+  Lcg rng{5};
+  std::vector<uint16_t> bg(FRAME_PX);
+  std::vector<uint16_t> composed(FRAME_PX);
+  std::vector<uint16_t> direct(FRAME_PX);
+  uint32_t errors[3] = {0, 0, 0};   // pixels off by 0, 1, 2+ steps
+  for (int frame = 0; frame < 4; ++frame) {
+    for (int i = 0; i < FRAME_PX; ++i) {
+      bg[i] = (frame == 0) ? 0xFFFF : (uint16_t)rng.next(0x10000);
+    }
+    layerBlendRun(bg.data(), premul.data(), keep.data(), composed.data(), FRAME_PX, false);
+    render(o, bg.data(), direct.data());
+    for (int i = 0; i < FRAME_PX; ++i) {
+      const int e = channelError(composed[i], direct[i]);
+      errors[e < 2 ? e : 2]++;
+      TEST_ASSERT_LESS_OR_EQUAL(2, e);
+    }
+  }
+  char msg[96];
+  snprintf(msg, sizeof(msg), "exact %u, 1 step %u, 2 steps %u", (unsigned)errors[0], (unsigned)errors[1],
+           (unsigned)errors[2]);
+  TEST_MESSAGE(msg);
+  // keep has 33 levels against LVGL's 256; a full-scale background can be
+  // off by one 32nd, two steps on the 6-bit green.
+  TEST_ASSERT_LESS_THAN(errors[0] + errors[1], errors[2] * 20);
+}
+
+void test_swapped_matches_native()
+{
+  const Overlay o = makeOverlay(9);
+  std::vector<uint16_t> black(FRAME_PX, 0);
+  std::vector<uint16_t> white(FRAME_PX, 0xFFFF);
+  std::vector<uint16_t> overBlack(FRAME_PX);
+  std::vector<uint16_t> overWhite(FRAME_PX);
+  render(o, black.data(), overBlack.data());
+  render(o, white.data(), overWhite.data());
+  std::vector<uint16_t> premul(FRAME_PX);
+  std::vector<uint8_t> keep(FRAME_PX);
+  layerBlendSplit(overBlack.data(), overWhite.data(), premul.data(), keep.data(), FRAME_PX, false);
+  std::vector<uint16_t> premulSw(FRAME_PX);
+  std::vector<uint8_t> keepSw(FRAME_PX);
+  for (int i = 0; i < FRAME_PX; ++i) {
+    overBlack[i] = imgScaleSwap(overBlack[i]);
+    overWhite[i] = imgScaleSwap(overWhite[i]);
+  }
+  layerBlendSplit(overBlack.data(), overWhite.data(), premulSw.data(), keepSw.data(), FRAME_PX, true);
+  TEST_ASSERT_TRUE(premul == premulSw);
+  TEST_ASSERT_TRUE(keep == keepSw);
+
+  Lcg rng{1};
+  std::vector<uint16_t> bg(FRAME_PX);
+  std::vector<uint16_t> bgSw(FRAME_PX);
+  for (int i = 0; i < FRAME_PX; ++i) {
+    bg[i] = (uint16_t)rng.next(0x10000);
+    bgSw[i] = imgScaleSwap(bg[i]);
+  }
+  std::vector<uint16_t> out(FRAME_PX);
+  std::vector<uint16_t> outSw(FRAME_PX);
+  layerBlendRun(bg.data(), premul.data(), keep.data(), out.data(), FRAME_PX, false);
+  layerBlendRun(bgSw.data(), premul.data(), keep.data(), outSw.data(), FRAME_PX, true);
+  for (int i = 0; i < FRAME_PX; ++i) {
+    TEST_ASSERT_EQUAL_HEX16(out[i], imgScaleSwap(outSw[i]));
+  }
+}
+
+// Host cost of the two kernels on a full frame, byte-swapped as on the
+// device. The layer_compose.h stats (rebuildUs, composeUs) give the device
+// figures; the sim's compose bench adds LVGL's own redraw for comparison.
+void test_kernel_cost()
+{
+  const Overlay o = makeOverlay(3);
+  std::vector<uint16_t> black(FRAME_PX, 0);
+  std::vector<uint16_t> white(FRAME_PX, 0xFFFF);
+  std::vector<uint16_t> overBlack(FRAME_PX);
+  std::vector<uint16_t> overWhite(FRAME_PX);
+  render(o, black.data(), overBlack.data());
+  render(o, white.data(), overWhite.data());
+  std::vector<uint16_t> premul(FRAME_PX);
+  std::vector<uint8_t> keep(FRAME_PX);
+  std::vector<uint16_t> bg(FRAME_PX);
+  std::vector<uint16_t> out(FRAME_PX);
+  Lcg rng{2};
+  for (int i = 0; i < FRAME_PX; ++i) {
+    bg[i] = (uint16_t)rng.next(0x10000);
+  }
+
+  const int rounds = 100;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    layerBlendSplit(overBlack.data(), overWhite.data(), premul.data(), keep.data(), FRAME_PX, true);
+  }
+  const double splitUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / rounds;
+  uint32_t sink = 0;
+  t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    layerBlendRun(bg.data(), premul.data(), keep.data(), out.data(), FRAME_PX, true);
+    sink += out[(size_t)r * 997 % FRAME_PX];
+  }
+  const double runUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / rounds;
+  char msg[128];
+  snprintf(msg, sizeof(msg), "360x360: split %.0f us (%.2f ns/px), compose %.0f us (%.2f ns/px), sink %u", splitUs,
+           splitUs * 1000.0 / FRAME_PX, runUs, runUs * 1000.0 / FRAME_PX, (unsigned)sink);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_LESS_THAN(33000, (int)runUs);   // a 30 FPS frame on any host
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_compose_matches_direct_render);
+  RUN_TEST(test_swapped_matches_native);
+  RUN_TEST(test_kernel_cost);
+  return UNITY_END();
+}
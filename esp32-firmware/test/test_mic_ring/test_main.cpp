@@ -0,0 +1,175 @@
+// MicRing (audio/mic_ring.h) under a real producer and consumer thread.
+//
+//   pio test -e native-test -f test_mic_ring
+//
+// The producer stamps each sample with a running count of the samples the
+// ring accepted, so whatever it drops on overrun, the consumer must see one
+// unbroken count; any torn index update or sample published before its
+// data shows up as a jump. Chunk sizes and pauses vary so the indices wrap
+// the storage at every offset, and one run starts the indices just below
+// 2^32 to cover the counter wrap. The memory ordering itself is only
+// checked by building this with -fsanitize=thread.
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "audio/mic_ring.h"
+
+#define RING_CAPACITY 1024
+#define STREAM_SAMPLES 1000000U
+
+static int16_t storage[RING_CAPACITY];
+
+void setUp() {}
+void tearDown() {}
+
+struct Lcg {
+  uint32_t state;
+  uint32_t next(uint32_t range)
+  {
+    state = state * 1664525U + 1013904223U;
+    return (state >> 8) % range;
+  }
+};
+
+struct StreamResult {
+  uint32_t received;
+  uint32_t breaks;
+  uint32_t trims;
+  uint32_t attempted;
+  uint32_t accepted;
+};
+
+// Runs the two threads until the producer has pushed STREAM_SAMPLES accepted
+// samples. With trimKeep > 0 the consumer sometimes trims instead of reading,
+// which may only skip forward.
+static StreamResult runStream(MicRing *ring, uint32_t trimKeep)
+{
+  std::atomic<bool> done(false);
+  StreamResult result = {};
+
+  std::thread producer([&]() {
+    Lcg rng = {12345};
+    int16_t chunk[256];
+    uint32_t count = 0;
+    while (count < STREAM_SAMPLES) {
+      const uint32_t n = 1 + rng.next(256);
+      for (uint32_t i = 0; i < n; ++i) {
+        chunk[i] = (int16_t)(uint16_t)(count + i);
+      }
+      result.attempted += n;
+      const uint32_t written = micRingWrite(ring, chunk, n);
+      count += written;
+      if (written < n || rng.next(8) == 0) {
+        std::this_thread::yield();
+      }
+    }
+    result.accepted = count;
+    done.store(true, std::memory_order_release);
+  });
+
+  Lcg rng = {777};
+  int16_t chunk[300];
+  uint16_t expected = 0;
+  for (;;) {
+    const bool finished = done.load(std::memory_order_acquire);
+    if (trimKeep > 0 && rng.next(64) == 0) {
+      micRingTrim(ring, trimKeep);
+      result.trims++;
+      // Resynchronise on the oldest sample left; it must not be older than
+      // what was already read.
+      int16_t first = 0;
+      if (micRingRead(ring, &first, 1) == 1) {
+        const uint16_t skipped = (uint16_t)((uint16_t)first - expected);
+        TEST_ASSERT_LESS_THAN(32768, skipped);
+        expected = (uint16_t)((uint16_t)first + 1);
+        result.received++;
+      }
+      continue;
+    }
+    const uint32_t n = micRingRead(ring, chunk, 1 + rng.next(300));
+    for (uint32_t i = 0; i < n; ++i) {
+      if ((uint16_t)chunk[i] != expected) {
+        result.breaks++;
+      }
+      expected = (uint16_t)((uint16_t)chunk[i] + 1);
+    }
+    result.received += n;
+    if (n == 0) {
+      if (finished) {
+        break;
+      }
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  return result;
+}
+
+void test_stream_stays_contiguous()
+{
+  MicRing ring;
+  micRingInit(&ring, storage, RING_CAPACITY);
+  const StreamResult r = runStream(&ring, 0);
+
+  TEST_ASSERT_EQUAL_UINT32(0, r.breaks);
+  TEST_ASSERT_EQUAL_UINT32(r.accepted, r.received);
+  // Every sample offered is either delivered or counted as an overrun.
+  TEST_ASSERT_EQUAL_UINT32(r.attempted, r.accepted + ring.overrunSamples.load());
+  TEST_ASSERT_LESS_OR_EQUAL(RING_CAPACITY, ring.peakFill.load());
+  TEST_ASSERT_EQUAL_UINT32(0, micRingAvailable(&ring));
+}
+
+void test_index_wrap()
+{
+  MicRing ring;
+  micRingInit(&ring, storage, RING_CAPACITY);
+  ring.head.store(0xFFFFFF00U);
+  ring.tail.store(0xFFFFFF00U);
+  const StreamResult r = runStream(&ring, 0);
+
+  TEST_ASSERT_EQUAL_UINT32(0, r.breaks);
+  TEST_ASSERT_EQUAL_UINT32(r.accepted, r.received);
+  TEST_ASSERT_EQUAL_UINT32(r.attempted, r.accepted + ring.overrunSamples.load());
+}
+
+// The wake-word pre-roll trims the ring from the consumer while capture
+// keeps writing: samples after a trim are the newest ones, still in order.
+void test_trim_while_writing()
+{
+  MicRing ring;
+  micRingInit(&ring, storage, RING_CAPACITY);
+  const StreamResult r = runStream(&ring, RING_CAPACITY / 4);
+
+  TEST_ASSERT_EQUAL_UINT32(0, r.breaks);
+  TEST_ASSERT_GREATER_THAN(0, r.trims);
+  TEST_ASSERT_LESS_OR_EQUAL(r.accepted, r.received);
+}
+
+void test_overrun_keeps_oldest()
+{
+  MicRing ring;
+  micRingInit(&ring, storage, 8);
+  const int16_t first[6] = {1, 2, 3, 4, 5, 6};
+  const int16_t second[6] = {7, 8, 9, 10, 11, 12};
+  TEST_ASSERT_EQUAL_UINT32(6, micRingWrite(&ring, first, 6));
+  TEST_ASSERT_EQUAL_UINT32(2, micRingWrite(&ring, second, 6));
+  TEST_ASSERT_EQUAL_UINT32(4, ring.overrunSamples.load());
+  TEST_ASSERT_EQUAL_UINT32(1, ring.overrunEvents.load());
+  TEST_ASSERT_EQUAL_UINT32(8, ring.peakFill.load());
+
+  int16_t out[8];
+  TEST_ASSERT_EQUAL_UINT32(8, micRingRead(&ring, out, 8));
+  const int16_t expected[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  TEST_ASSERT_EQUAL_INT16_ARRAY(expected, out, 8);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_overrun_keeps_oldest);
+  RUN_TEST(test_stream_stays_contiguous);
+  RUN_TEST(test_index_wrap);
+  RUN_TEST(test_trim_while_writing);
+  return UNITY_END();
+}
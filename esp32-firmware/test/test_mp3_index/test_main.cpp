@@ -0,0 +1,518 @@
+// MP3 duration and seek index (audio/mp3_index.h) over a corpus of files.
+//
+//   pio test -e native-test -f test_mp3_index
+//   MP3_INDEX_CORPUS_DIR=/path/to/mp3s pio test -e native-test -f test_mp3_index
+//
+// The built-in corpus is generated frame by frame, so the true frame count
+// and the offset of every frame are known: CBR with ID3v2/ID3v1, LAME-style
+// Xing VBR with a TOC, an Info tag without one, Fraunhofer VBRI, MPEG-2 and
+// 2.5, garbage between frames, a truncated tail, a long file that makes the
+// scanner thin its marks, and a file that is not MP3 at all. Each goes
+// through the same steps as probeMp3Duration()/processAudioIndexScan() in
+// main.cpp (8 KB reads) and is checked for duration and for where seeks land.
+//
+// With MP3_INDEX_CORPUS_DIR set, every .mp3 there is indexed both from its
+// tag and by a full scan; the durations must agree within 1 % and every seek
+// must land on or just before a frame header.
+#include <unity.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "audio/mp3_index.h"
+
+#define READ_BLOCK 8192    // AUDIO_INDEX_SCAN_BLOCK_BYTES
+
+void setUp() {}
+void tearDown() {}
+
+// --- corpus generation -------------------------------------------------------
+
+enum Version { MPEG1 = 3, MPEG2 = 2, MPEG25 = 0 };
+
+struct Format {
+  Version version;
+  uint32_t sampleRate;
+  bool mono;
+};
+
+static uint32_t samplesPerFrame(const Format &f)
+{
+  return (f.version == MPEG1) ? 1152 : 576;
+}
+
+static int sideInfoBytes(const Format &f)
+{
+  return (f.version == MPEG1) ? (f.mono ? 17 : 32) : (f.mono ? 9 : 17);
+}
+
+static const uint16_t MPEG1_L3_KBPS[15] = {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320};
+static const uint16_t MPEG2_L3_KBPS[15] = {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160};
+
+struct Mp3Builder {
+  Format format;
+  std::vector<uint8_t> bytes;
+  std::vector<uint32_t> frameOffsets;   // audio frames only, not the tag frame
+  uint32_t rng = 1;
+  uint32_t paddingAcc = 0;
+
+  explicit Mp3Builder(Format f) : format(f) {}
+
+  uint32_t random(uint32_t range)
+  {
+    rng = rng * 1103515245U + 12345U;
+    return (rng >> 8) % range;
+  }
+
+  int rateIndex() const
+  {
+    const uint32_t base = (format.version == MPEG1) ? format.sampleRate
+                          : (format.version == MPEG2) ? format.sampleRate * 2 : format.sampleRate * 4;
+    return (base == 44100) ? 0 : (base == 48000) ? 1 : 2;
+  }
+
+  int bitrateIndex(uint32_t kbps) const
+  {
+    const uint16_t *table = (format.version == MPEG1) ? MPEG1_L3_KBPS : MPEG2_L3_KBPS;
+    for (int i = 1; i < 15; ++i) {
+      if (table[i] == kbps) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  // Appends one frame; padding follows the encoder rule of spreading the
+  // fractional byte over frames.
+  uint32_t frame(uint32_t kbps)
+  {
+    const uint32_t coeff = (format.version == MPEG1) ? 144 : 72;
+    const uint32_t exact = coeff * kbps * 1000;
+    paddingAcc += exact % format.sampleRate;
+    const bool pad = paddingAcc >= format.sampleRate;
+    if (pad) {
+      paddingAcc -= format.sampleRate;
+    }
+    const uint32_t size = exact / format.sampleRate + (pad ? 1 : 0);
+    const uint32_t offset = (uint32_t)bytes.size();
+    bytes.push_back(0xFF);
+    bytes.push_back((uint8_t)(0xE0 | (format.version << 3) | (1 << 1) | 1));   // layer III, no CRC
+    bytes.push_back((uint8_t)((bitrateIndex(kbps) << 4) | (rateIndex() << 2) | (pad ? 2 : 0)));
+    bytes.push_back(format.mono ? 0xC0 : 0x00);
+    for (uint32_t i = 4; i < size; ++i) {
+      // Payload never forms a sync word, as in a real stream.
+      const uint8_t v = (uint8_t)random(256);
+      bytes.push_back((v == 0xFF) ? 0x7F : v);
+    }
+    return offset;
+  }
+
+  void audio(uint32_t frames, const std::vector<uint32_t> &kbpsChoices)
+  {
+    for (uint32_t i = 0; i < frames; ++i) {
+      frameOffsets.push_back(frame(kbpsChoices[random((uint32_t)kbpsChoices.size())]));
+    }
+  }
+
+  void id3v2(uint32_t tagBytes, bool footer)
+  {
+    const uint8_t head[10] = {'I', 'D', '3', 4, 0, (uint8_t)(footer ? 0x10 : 0),
+                              (uint8_t)((tagBytes >> 21) & 0x7F), (uint8_t)((tagBytes >> 14) & 0x7F),
+                              (uint8_t)((tagBytes >> 7) & 0x7F), (uint8_t)(tagBytes & 0x7F)};
+    bytes.insert(bytes.end(), head, head + 10);
+    // Frame-header-looking bytes inside the tag must not be taken for audio.
+    for (uint32_t i = 0; i < tagBytes + (footer ? 10 : 0); ++i) {
+      const uint32_t k = i % 97;
+      bytes.push_back((k == 0) ? 0xFF : (k == 1) ? 0xFB : (k == 2) ? 0x90 : (uint8_t)(i & 0x7F));
+    }
+  }
+
+  void id3v1()
+  {
+    bytes.push_back('T');
+    bytes.push_back('A');
+    bytes.push_back('G');
+    bytes.resize(bytes.size() + 125, 0x20);
+  }
+
+  void garbage(uint32_t n)
+  {
+    for (uint32_t i = 0; i < n; ++i) {
+      bytes.push_back((uint8_t)random(0xF0));
+    }
+  }
+
+  uint32_t audioEnd() const
+  {
+    return (uint32_t)bytes.size();
+  }
+};
+
+static void putBe32(uint8_t *p, uint32_t v)
+{
+  p[0] = (uint8_t)(v >> 24);
+  p[1] = (uint8_t)(v >> 16);
+  p[2] = (uint8_t)(v >> 8);
+  p[3] = (uint8_t)v;
+}
+
+static void putBe16(uint8_t *p, uint16_t v)
+{
+  p[0] = (uint8_t)(v >> 8);
+  p[1] = (uint8_t)v;
+}
+
+// Writes a LAME-style Xing/Info frame at tagOffset once the audio is known:
+// frame count, byte count including the tag frame, TOC relative to it.
+static void writeXing(Mp3Builder *b, uint32_t tagOffset, uint32_t end, bool info, bool withToc)
+{
+  const uint32_t frames = (uint32_t)b->frameOffsets.size();
+  const uint32_t total = end - tagOffset;
+  uint8_t *p = &b->bytes[tagOffset + 4 + sideInfoBytes(b->format)];
+  memcpy(p, info ? "Info" : "Xing", 4);
+  putBe32(p + 4, withToc ? 0x7 : 0x3);
+  putBe32(p + 8, frames);
+  putBe32(p + 12, total);
+  if (withToc) {
+    for (int i = 0; i < 100; ++i) {
+      const uint32_t at = b->frameOffsets[(uint64_t)frames * i / 100] - tagOffset;
+      p[16 + i] = (uint8_t)((uint64_t)at * 256 / total);
+    }
+  }
+}
+
+// Fraunhofer VBRI: bytes and frames for the whole stream, then one table
+// entry per framesPerEntry frames giving that segment's size.
+static void writeVbri(Mp3Builder *b, uint32_t tagOffset, uint32_t tagBytes, uint32_t end, uint16_t framesPerEntry)
+{
+  const uint32_t frames = (uint32_t)b->frameOffsets.size();
+  const uint16_t entries = (uint16_t)((frames + framesPerEntry - 1) / framesPerEntry);
+  uint8_t *p = &b->bytes[tagOffset + 4 + 32];
+  memcpy(p, "VBRI", 4);
+  putBe16(p + 4, 1);
+  putBe16(p + 6, 0);
+  putBe16(p + 8, 75);
+  putBe32(p + 10, end - tagOffset);
+  putBe32(p + 14, frames);
+  putBe16(p + 18, entries);
+  putBe16(p + 20, 1);
+  putBe16(p + 22, 2);
+  putBe16(p + 24, framesPerEntry);
+  TEST_ASSERT_LESS_OR_EQUAL(tagBytes, 4 + 32 + 26 + (uint32_t)entries * 2);
+  for (uint16_t e = 0; e < entries; ++e) {
+    const uint32_t first = b->frameOffsets[(size_t)e * framesPerEntry];
+    const size_t nextIndex = (size_t)(e + 1) * framesPerEntry;
+    const uint32_t next = (nextIndex < frames) ? b->frameOffsets[nextIndex] : end;
+    putBe16(p + 26 + (size_t)e * 2, (uint16_t)(next - first));
+  }
+}
+
+// --- indexing, as main.cpp does it --------------------------------------------
+
+struct IndexResult {
+  bool ok;
+  Mp3SeekIndex index;
+  uint32_t scannedFrames;
+  uint32_t resyncs;
+};
+
+static IndexResult indexFile(const std::vector<uint8_t> &file, bool forceScan)
+{
+  IndexResult r = {};
+  const uint32_t size = (uint32_t)file.size();
+  uint32_t streamEnd = size;
+  if (size > 128 && memcmp(&file[size - 128], "TAG", 3) == 0) {
+    streamEnd -= 128;
+  }
+  const uint32_t start = (size >= 10) ? mp3Id3v2Size(file.data()) : 0;
+  if (start >= streamEnd) {
+    return r;
+  }
+  const size_t n = (size - start < READ_BLOCK) ? size - start : READ_BLOCK;
+  Mp3FrameInfo info;
+  const int at = mp3FindFrame(&file[start], n, &info);
+  if (at < 0) {
+    return r;
+  }
+  const uint32_t frameOffset = start + (uint32_t)at;
+  if (!forceScan && mp3ParseVbrTag(&file[frameOffset], n - (size_t)at, info, frameOffset, streamEnd, &r.index)) {
+    r.ok = true;
+    return r;
+  }
+
+  static Mp3FrameScanner scanner;
+  mp3ScanBegin(&scanner, frameOffset, streamEnd);
+  while (!scanner.done) {
+    if (scanner.nextOffset >= size) {
+      break;
+    }
+    const size_t len = (size - scanner.nextOffset < READ_BLOCK) ? size - scanner.nextOffset : READ_BLOCK;
+    if (len < 4) {
+      break;
+    }
+    mp3ScanFeed(&scanner, &file[scanner.nextOffset], len);
+  }
+  r.ok = mp3ScanFinish(&scanner, &r.index);
+  r.scannedFrames = scanner.frames;
+  r.resyncs = scanner.resyncs;
+  return r;
+}
+
+// --- checks -----------------------------------------------------------------
+
+// Every index ends up as a 100-entry TOC of 1/256 steps of the data, so a
+// seek may be off by dataBytes/256 however exact the source was; the slack
+// on top is about one frame of rounding (two across thinned scan marks).
+struct Expect {
+  uint8_t source;
+  uint32_t frames;          // counted by the tag or the scan
+  uint32_t seekSlackBytes;
+};
+
+static void checkSeeks(const char *name, const Mp3Builder &b, const Mp3SeekIndex &index, uint32_t slack)
+{
+  const uint32_t frames = (uint32_t)b.frameOffsets.size();
+  const uint32_t tolerance = index.dataBytes / 256 + slack;
+  uint32_t worst = 0;
+  for (uint32_t step = 0; step <= 200; ++step) {
+    const uint32_t ms = (uint32_t)((uint64_t)index.durationMs * step / 200);
+    const uint64_t frame = (uint64_t)ms * b.format.sampleRate / (1000ULL * samplesPerFrame(b.format));
+    const uint32_t truth = (frame < frames) ? b.frameOffsets[frame] : b.audioEnd();
+    const uint32_t got = mp3SeekOffset(&index, ms);
+    const uint32_t err = (got > truth) ? got - truth : truth - got;
+    worst = (err > worst) ? err : worst;
+    if (err > tolerance) {
+      char msg[160];
+      snprintf(msg, sizeof(msg), "%s: seek to %lu ms landed at %lu, frame %lu is at %lu (tolerance %lu)", name,
+               (unsigned long)ms, (unsigned long)got, (unsigned long)frame, (unsigned long)truth,
+               (unsigned long)tolerance);
+      TEST_FAIL_MESSAGE(msg);
+    }
+  }
+  char msg[160];
+  snprintf(msg, sizeof(msg), "%s: %lu frames, %lu ms, worst seek error %lu B of %lu B data", name,
+           (unsigned long)frames, (unsigned long)index.durationMs, (unsigned long)worst,
+           (unsigned long)index.dataBytes);
+  TEST_MESSAGE(msg);
+}
+
+static void checkFile(const char *name, const Mp3Builder &b, const Expect &e)
+{
+  const IndexResult r = indexFile(b.bytes, false);
+  char msg[128];
+  snprintf(msg, sizeof(msg), "%s: not indexed", name);
+  TEST_ASSERT_TRUE_MESSAGE(r.ok, msg);
+  snprintf(msg, sizeof(msg), "%s: index source", name);
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(e.source, r.index.source, msg);
+  if (e.source == MP3_INDEX_SCAN) {
+    snprintf(msg, sizeof(msg), "%s: scanned frames", name);
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(e.frames, r.scannedFrames, msg);
+  }
+  const uint32_t expectedMs =
+    (uint32_t)(((uint64_t)e.frames * samplesPerFrame(b.format) * 1000ULL + b.format.sampleRate / 2) / b.format.sampleRate);
+  snprintf(msg, sizeof(msg), "%s: duration", name);
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(expectedMs, r.index.durationMs, msg);
+  checkSeeks(name, b, r.index, e.seekSlackBytes);
+}
+
+static const std::vector<uint32_t> CBR128 = {128};
+static const std::vector<uint32_t> VBR_MPEG1 = {64, 96, 128, 160, 192, 256, 320};
+static const std::vector<uint32_t> VBR_MPEG2 = {24, 32, 48, 64, 96, 128};
+
+void test_cbr_with_id3_tags()
+{
+  Mp3Builder b({MPEG1, 44100, false});
+  b.id3v2(3000, true);
+  b.audio(1500, CBR128);
+  b.id3v1();
+  checkFile("cbr128_id3", b, {MP3_INDEX_SCAN, 1500, 420});
+}
+
+void test_xing_vbr_with_toc()
+{
+  Mp3Builder b({MPEG1, 44100, false});
+  b.id3v2(700, false);
+  const uint32_t tag = b.frame(128);
+  b.audio(2400, VBR_MPEG1);
+  writeXing(&b, tag, b.audioEnd(), false, true);
+  b.id3v1();
+  checkFile("xing_vbr_toc", b, {MP3_INDEX_XING, 2400, 1045});
+}
+
+void test_info_cbr_without_toc()
+{
+  Mp3Builder b({MPEG1, 48000, false});
+  const uint32_t tag = b.frame(192);
+  b.audio(900, {192});
+  writeXing(&b, tag, b.audioEnd(), true, false);
+  checkFile("info_cbr_no_toc", b, {MP3_INDEX_XING, 900, 630});
+}
+
+void test_vbri()
+{
+  Mp3Builder b({MPEG1, 44100, false});
+  const uint32_t tag = b.frame(320);
+  b.audio(1200, VBR_MPEG1);
+  writeVbri(&b, tag, 1045, b.audioEnd(), 12);
+  checkFile("vbri", b, {MP3_INDEX_VBRI, 1200, 1045});
+}
+
+void test_mpeg2_mono_xing()
+{
+  Mp3Builder b({MPEG2, 22050, true});
+  const uint32_t tag = b.frame(64);
+  b.audio(3000, VBR_MPEG2);
+  writeXing(&b, tag, b.audioEnd(), false, true);
+  checkFile("mpeg2_mono_xing", b, {MP3_INDEX_XING, 3000, 420});
+}
+
+void test_mpeg25_scan()
+{
+  Mp3Builder b({MPEG25, 8000, true});
+  b.audio(800, {8, 16, 24, 32});
+  checkFile("mpeg25_8k_scan", b, {MP3_INDEX_SCAN, 800, 300});
+}
+
+// Junk between frames (a broken download, a glued-on second file) costs a
+// resync, not frames.
+void test_scan_resyncs_over_garbage()
+{
+  Mp3Builder b({MPEG1, 44100, false});
+  b.audio(400, VBR_MPEG1);
+  b.garbage(1500);
+  b.audio(400, VBR_MPEG1);
+  b.garbage(37);
+  b.audio(200, VBR_MPEG1);
+  const IndexResult r = indexFile(b.bytes, false);
+  TEST_ASSERT_TRUE(r.ok);
+  TEST_ASSERT_EQUAL_UINT32(1000, r.scannedFrames);
+  TEST_ASSERT_GREATER_OR_EQUAL(2, r.resyncs);
+  TEST_ASSERT_EQUAL_UINT32(MP3_INDEX_SCAN, r.index.source);
+}
+
+void test_truncated_tail()
+{
+  Mp3Builder b({MPEG1, 44100, false});
+  b.audio(600, CBR128);
+  b.bytes.resize(b.bytes.size() - 200);   // last frame cut short
+  const IndexResult r = indexFile(b.bytes, false);
+  TEST_ASSERT_TRUE(r.ok);
+  TEST_ASSERT_UINT32_WITHIN(1, 600, r.scannedFrames);
+}
+
+// Over MP3_SCAN_MARKS frames the scanner keeps every 2nd, 4th, ... frame
+// offset; seeks interpolate between the kept ones.
+void test_long_scan_thins_marks()
+{
+  Mp3Builder b({MPEG1, 44100, false});
+  b.audio(20000, VBR_MPEG1);   // ~8.7 minutes
+  checkFile("long_vbr_scan", b, {MP3_INDEX_SCAN, 20000, 1045 * 2});
+}
+
+void test_not_mp3()
+{
+  std::vector<uint8_t> wav(50000);
+  memcpy(wav.data(), "RIFF", 4);
+  uint32_t rng = 5;
+  for (size_t i = 4; i < wav.size(); ++i) {
+    rng = rng * 1103515245U + 12345U;
+    wav[i] = (uint8_t)((rng >> 16) & 0xFE);   // no 0xFF: no sync word anywhere
+  }
+  TEST_ASSERT_FALSE(indexFile(wav, false).ok);
+
+  Mp3Builder b({MPEG1, 44100, false});
+  b.id3v2(200, false);
+  TEST_ASSERT_FALSE(indexFile(b.bytes, false).ok);
+}
+
+// A tag that claims more bytes than the file holds must not seek past it.
+void test_xing_byte_count_past_end()
+{
+  Mp3Builder b({MPEG1, 44100, false});
+  const uint32_t tag = b.frame(128);
+  b.audio(500, CBR128);
+  writeXing(&b, tag, b.audioEnd() + 100000, false, false);
+  const IndexResult r = indexFile(b.bytes, false);
+  TEST_ASSERT_TRUE(r.ok);
+  TEST_ASSERT_EQUAL_UINT32(b.audioEnd() - tag, r.index.dataBytes);
+  TEST_ASSERT_LESS_OR_EQUAL(b.audioEnd(), mp3SeekOffset(&r.index, r.index.durationMs - 1));
+}
+
+// --- recorded corpus ---------------------------------------------------------
+
+static bool frameNear(const std::vector<uint8_t> &file, uint32_t offset, uint32_t window)
+{
+  for (uint32_t i = 0; i < window && offset + i + 4 <= file.size(); ++i) {
+    Mp3FrameInfo info;
+    if (mp3ParseFrameHeader(&file[offset + i], &info)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void test_recorded_corpus()
+{
+  const char *dir = getenv("MP3_INDEX_CORPUS_DIR");
+  if (dir == nullptr || dir[0] == '\0') {
+    TEST_MESSAGE("MP3_INDEX_CORPUS_DIR not set, no recorded files checked");
+    return;
+  }
+  DIR *d = opendir(dir);
+  TEST_ASSERT_NOT_NULL(d);
+  uint32_t files = 0;
+  while (dirent *entry = readdir(d)) {
+    const std::string name = entry->d_name;
+    if (name.size() < 5 || (name.compare(name.size() - 4, 4, ".mp3") != 0 && name.compare(name.size() - 4, 4, ".MP3") != 0)) {
+      continue;
+    }
+    FILE *f = fopen((std::string(dir) + "/" + name).c_str(), "rb");
+    if (f == nullptr) {
+      continue;
+    }
+    std::vector<uint8_t> file;
+    uint8_t chunk[65536];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0) {
+      file.insert(file.end(), chunk, chunk + n);
+    }
+    fclose(f);
+
+    const IndexResult tagged = indexFile(file, false);
+    const IndexResult scanned = indexFile(file, true);
+    char msg[200];
+    snprintf(msg, sizeof(msg), "%s: source %u, %lu ms (scan %lu ms, %lu frames, %lu resyncs)", name.c_str(),
+             (unsigned)tagged.index.source, (unsigned long)tagged.index.durationMs,
+             (unsigned long)scanned.index.durationMs, (unsigned long)scanned.scannedFrames,
+             (unsigned long)scanned.resyncs);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_TRUE_MESSAGE(tagged.ok && scanned.ok, msg);
+    TEST_ASSERT_UINT32_WITHIN(scanned.index.durationMs / 100 + 50, scanned.index.durationMs, tagged.index.durationMs);
+    for (int p = 1; p < 100; ++p) {
+      const uint32_t at = mp3SeekOffset(&tagged.index, tagged.index.durationMs * (uint32_t)p / 100);
+      TEST_ASSERT_TRUE_MESSAGE(frameNear(file, at, 4096), msg);
+    }
+    files++;
+  }
+  closedir(d);
+  TEST_ASSERT_GREATER_THAN(0, files);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_cbr_with_id3_tags);
+  RUN_TEST(test_xing_vbr_with_toc);
+  RUN_TEST(test_info_cbr_without_toc);
+  RUN_TEST(test_vbri);
+  RUN_TEST(test_mpeg2_mono_xing);
+  RUN_TEST(test_mpeg25_scan);
+  RUN_TEST(test_scan_resyncs_over_garbage);
+  RUN_TEST(test_truncated_tail);
+  RUN_TEST(test_long_scan_thins_marks);
+  RUN_TEST(test_not_mp3);
+  RUN_TEST(test_xing_byte_count_past_end);
+  RUN_TEST(test_recorded_corpus);
+  return UNITY_END();
+}
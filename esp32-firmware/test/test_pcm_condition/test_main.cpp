@@ -0,0 +1,245 @@
+// PcmConditioner (audio/pcm_condition.h): bit-exact output and block cost.
+//
+//   pio test -e native-test -f test_pcm_condition
+//
+// The block stage is checked sample for sample against a plain reference
+// written from the spec in the header (int64 math, explicit clamps, no
+// shared helpers), over blocks that switch channel, step level, clip,
+// carry DC and vary in length. A hash of the output for one fixed stimulus
+// is pinned as well: any other implementation of the stage (a vector path,
+// the Xtensa CLAMPS build) has to reproduce it exactly.
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "audio/pcm_condition.h"
+
+#define BLOCK_FRAMES 320    // VOICE_CAPTURE_FRAMES, 20 ms at 16 kHz
+
+void setUp() {}
+void tearDown() {}
+
+struct RefConditioner {
+  int64_t x1 = 0;
+  int64_t y1 = 0;
+  int64_t gain = ((int64_t)PCM_AGC_TARGET_PEAK << 16) / PCM_AGC_GATE_PEAK;
+  int channel = 0;
+  uint64_t clipped = 0;
+};
+
+static int64_t refAbs(int64_t v)
+{
+  return v < 0 ? -v : v;
+}
+
+// Arithmetic shift of a negative value rounds toward minus infinity; the
+// reference spells that out rather than rely on >> of a signed int64.
+static int64_t refShr(int64_t v, int n)
+{
+  const int64_t d = (int64_t)1 << n;
+  return (v >= 0) ? v / d : -((-v + d - 1) / d);
+}
+
+static void refBlock(RefConditioner *rc, const int32_t *stereo, size_t frames, int16_t *out)
+{
+  if (frames == 0) {
+    return;
+  }
+  uint64_t sum[2] = {0, 0};
+  for (size_t i = 0; i < frames; ++i) {
+    for (int ch = 0; ch < 2; ++ch) {
+      sum[ch] += (uint64_t)(refAbs(refShr(stereo[i * 2 + ch], 8)) / 16);
+    }
+  }
+  // The stage sums in uint32; with 24-bit input >> 4 that cannot wrap below
+  // 2^12 frames per block.
+  const int other = rc->channel ^ 1;
+  if (sum[other] / PCM_CHANNEL_SWITCH_RATIO > sum[rc->channel]) {
+    rc->channel = other;
+  }
+
+  std::vector<int64_t> y(frames);
+  int64_t peak = 0;
+  for (size_t i = 0; i < frames; ++i) {
+    const int64_t x = refShr(stereo[i * 2 + rc->channel], 8);
+    y[i] = x - rc->x1 + rc->y1 - refShr(rc->y1, 8);
+    rc->x1 = x;
+    rc->y1 = y[i];
+    peak = (refAbs(y[i]) > peak) ? refAbs(y[i]) : peak;
+  }
+
+  const int64_t level = (peak > PCM_AGC_GATE_PEAK) ? peak : PCM_AGC_GATE_PEAK;
+  const int64_t target = ((int64_t)PCM_AGC_TARGET_PEAK << 16) / level;
+  const int64_t from = rc->gain;
+  const int64_t to = (target < from) ? target : from + refShr(target - from, PCM_AGC_RELEASE_SHIFT);
+  rc->gain = to;
+
+  const int64_t step = (to > from) ? (to - from) / (int64_t)frames : 0;
+  for (size_t i = 0; i < frames; ++i) {
+    const int64_t gain = (to > from) ? from + step * (int64_t)(i + 1) : to;
+    const int64_t scaled = refShr(y[i] * gain, 16);
+    int64_t sat = scaled;
+    if (sat > 32767) {
+      sat = 32767;
+    }
+    if (sat < -32768) {
+      sat = -32768;
+    }
+    rc->clipped += (sat != scaled) ? 1 : 0;
+    out[i] = (int16_t)sat;
+  }
+}
+
+// 24-bit I2S mic on one slot (left-justified in 32 bits), noise on the other.
+// Integer-only, so the pinned hash does not depend on the host's libm.
+struct Stimulus {
+  uint32_t rng = 99;
+  uint32_t phase = 0;
+
+  int32_t noise(int32_t amplitude)
+  {
+    rng = rng * 1664525U + 1013904223U;
+    return (int32_t)(((int64_t)(int32_t)(rng >> 8) - (1 << 23)) * amplitude >> 24);
+  }
+
+  // Triangle at ~440 Hz plus a quieter one at ~1.36 kHz, +/-32768 peak.
+  int32_t tone()
+  {
+    phase++;
+    const int32_t a = (int32_t)((phase * 1802U) & 0xFFFF);
+    const int32_t b = (int32_t)((phase * 5586U) & 0xFFFF);
+    const int32_t triA = (a < 32768) ? a * 2 - 32768 : 98303 - a * 2;
+    const int32_t triB = (b < 32768) ? b * 2 - 32768 : 98303 - b * 2;
+    return (triA * 7 + triB * 3) / 10;
+  }
+
+  void fill(int32_t *stereo, size_t frames, int micSlot, int32_t amplitude, int32_t dc, int32_t idleNoise)
+  {
+    for (size_t i = 0; i < frames; ++i) {
+      int64_t mic = ((int64_t)tone() * amplitude >> 15) + dc + noise(200);
+      mic = (mic > 8388607) ? 8388607 : (mic < -8388608 ? -8388608 : mic);
+      stereo[i * 2 + micSlot] = (int32_t)((uint32_t)mic << 8);
+      stereo[i * 2 + (micSlot ^ 1)] = (int32_t)((uint32_t)noise(idleNoise) << 8);
+    }
+  }
+};
+
+struct Step {
+  int blocks;
+  size_t frames;
+  int micSlot;
+  int32_t amplitude;
+  int32_t dc;
+};
+
+// Silence, speech, a shout, the mic moving slot, odd read sizes, full scale.
+// Every step carries DC the blocker has to remove.
+static const Step SCRIPT[] = {
+  {20, BLOCK_FRAMES, 0, 0, 30000},
+  {30, BLOCK_FRAMES, 0, 40000, 30000},
+  {5, BLOCK_FRAMES, 0, 4000000, 30000},
+  {30, BLOCK_FRAMES, 0, 20000, 30000},
+  {20, BLOCK_FRAMES, 1, 300000, -50000},
+  {40, 1, 1, 300000, -50000},
+  {20, 77, 1, 300000, -50000},
+  {10, BLOCK_FRAMES, 1, 8388607, 20000},
+  {30, BLOCK_FRAMES, 0, 1000, 20000},
+};
+
+static uint32_t fnv1a(uint32_t hash, const int16_t *data, size_t count)
+{
+  for (size_t i = 0; i < count; ++i) {
+    const uint16_t v = (uint16_t)data[i];
+    hash = (hash ^ (v & 0xFF)) * 16777619U;
+    hash = (hash ^ (v >> 8)) * 16777619U;
+  }
+  return hash;
+}
+
+void test_matches_reference()
+{
+  PcmConditioner pc;
+  pcmConditionReset(&pc);
+  RefConditioner rc;
+  Stimulus stim;
+  int32_t stereo[BLOCK_FRAMES * 2];
+  int16_t out[BLOCK_FRAMES];
+  int16_t expected[BLOCK_FRAMES];
+  uint32_t hash = 2166136261U;
+  uint32_t blocks = 0;
+
+  for (const Step &step : SCRIPT) {
+    for (int b = 0; b < step.blocks; ++b) {
+      stim.fill(stereo, step.frames, step.micSlot, step.amplitude, step.dc, 3000);
+      refBlock(&rc, stereo, step.frames, expected);
+      pcmConditionBlock(&pc, stereo, step.frames, out);
+      char msg[64];
+      snprintf(msg, sizeof(msg), "block %u", (unsigned)blocks);
+      TEST_ASSERT_EQUAL_INT16_ARRAY_MESSAGE(expected, out, step.frames, msg);
+      TEST_ASSERT_EQUAL_INT_MESSAGE(rc.channel, pc.channel, msg);
+      TEST_ASSERT_EQUAL_INT_MESSAGE((int32_t)rc.gain, pc.gainQ16, msg);
+      hash = fnv1a(hash, out, step.frames);
+      blocks++;
+    }
+  }
+  // The gain comes from the block's own peak, so even full scale after a
+  // long silence must not clip.
+  TEST_ASSERT_EQUAL_UINT32(0, rc.clipped);
+  TEST_ASSERT_EQUAL_UINT32(0, pc.clipped);
+
+  char msg[64];
+  snprintf(msg, sizeof(msg), "output hash 0x%08x over %u blocks", (unsigned)hash, (unsigned)blocks);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL_HEX32(0x0925FBD1U, hash);
+}
+
+void test_saturate_edges()
+{
+  const int32_t inputs[] = {0, 1, -1, 32767, 32768, -32768, -32769, 65535, -65536, INT32_MAX, INT32_MIN};
+  for (int32_t v : inputs) {
+    const int32_t expected = (v > 32767) ? 32767 : ((v < -32768) ? -32768 : v);
+    TEST_ASSERT_EQUAL_INT32(expected, pcmSat16(v));
+  }
+  TEST_ASSERT_EQUAL_INT32(INT32_MAX, pcmAbs32(INT32_MAX));
+  TEST_ASSERT_EQUAL_INT32(8388608, pcmAbs32(-8388608));
+}
+
+// Host cost of one 20 ms block. The capture task logs the device figure
+// (conditionUs on mic release); this one tracks changes to the loops.
+void test_block_cost()
+{
+  PcmConditioner pc;
+  pcmConditionReset(&pc);
+  Stimulus stim;
+  const int kinds = 8;
+  std::vector<int32_t> input((size_t)kinds * BLOCK_FRAMES * 2);
+  for (int k = 0; k < kinds; ++k) {
+    stim.fill(&input[(size_t)k * BLOCK_FRAMES * 2], BLOCK_FRAMES, k & 1, 20000 * (k + 1), 10000, 3000);
+  }
+  int32_t stereo[BLOCK_FRAMES * 2];
+  int16_t out[BLOCK_FRAMES];
+  const int rounds = 20000;
+  uint32_t sink = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    memcpy(stereo, &input[(size_t)(r % kinds) * BLOCK_FRAMES * 2], sizeof(stereo));
+    pcmConditionBlock(&pc, stereo, BLOCK_FRAMES, out);
+    sink += (uint16_t)out[r % BLOCK_FRAMES];
+  }
+  const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds;
+  char msg[112];
+  snprintf(msg, sizeof(msg), "%.0f ns per %d-frame block (%.2f ns/frame, incl. 2.5 KB copy), sink %u", ns,
+           BLOCK_FRAMES, ns / BLOCK_FRAMES, (unsigned)sink);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_LESS_THAN(200000.0, ns);   // 1% of the 20 ms block on any host
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_saturate_edges);
+  RUN_TEST(test_matches_reference);
+  RUN_TEST(test_block_cost);
+  return UNITY_END();
+}
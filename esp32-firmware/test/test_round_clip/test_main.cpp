@@ -0,0 +1,160 @@
+// Round-panel clipping (display/round_clip.h): band plans and in-place packing.
+//
+//   pio test -e native-test -f test_round_clip
+//
+// Random strips over the 360x360 panel, planned with the flush settings
+// from display/round_refr.h: every visible pixel has to be covered by
+// exactly one band, and after packing each band has to hold its own pixels
+// at a 4-byte aligned offset. A strip the packer refuses must come back
+// untouched, since the driver then sends it whole.
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "display/round_clip.h"
+
+#define PANEL_RES 360
+#define FLUSH_MAX_BANDS 4     // LCD_ROUND_FLUSH_MAX_BANDS
+#define FLUSH_COST_PX 800     // LCD_ROUND_FLUSH_COST_PX
+#define FLUSH_ALIGN 4         // LCD_ROUND_FLUSH_ALIGN
+#define MARGIN_PX 1.0f        // LCD_ROUND_MARGIN_PX
+
+static RoundClip rc;
+
+void setUp() {}
+void tearDown() {}
+
+struct Lcg {
+  uint32_t state;
+  uint32_t next(uint32_t range)
+  {
+    state = state * 1664525U + 1013904223U;
+    return (state >> 8) % range;
+  }
+};
+
+// RGB565 pixel that encodes its own frame-buffer position.
+static inline uint16_t pixelAt(int x, int y)
+{
+  return (uint16_t)(x * 31 + y * 977);
+}
+
+static RoundClipRect randomStrip(Lcg &rng)
+{
+  RoundClipRect r;
+  r.x1 = (int16_t)rng.next(PANEL_RES);
+  r.x2 = (int16_t)(r.x1 + rng.next(PANEL_RES - r.x1));
+  r.y1 = (int16_t)rng.next(PANEL_RES);
+  // LVGL strips are at most 40 rows of a full-width buffer, taller when narrower.
+  const int maxRows = 40 * PANEL_RES / (r.x2 - r.x1 + 1);
+  r.y2 = (int16_t)(r.y1 + rng.next((maxRows < PANEL_RES - r.y1) ? maxRows : PANEL_RES - r.y1));
+  return r;
+}
+
+void test_bands_cover_the_visible_pixels()
+{
+  roundClipInit(&rc, PANEL_RES, MARGIN_PX);
+  Lcg rng{7};
+  for (int n = 0; n < 5000; ++n) {
+    const RoundClipRect strip = randomStrip(rng);
+    RoundClipRect bands[FLUSH_MAX_BANDS];
+    const int count = roundClipPlanBands(&rc, &strip, FLUSH_MAX_BANDS, FLUSH_COST_PX, 1, bands);
+    TEST_ASSERT_LESS_OR_EQUAL(FLUSH_MAX_BANDS, count);
+    for (int y = strip.y1; y <= strip.y2; ++y) {
+      int a, b;
+      const bool visible = roundClipRowSpan(&rc, y, strip.x1, strip.x2, &a, &b);
+      int covering = 0;
+      for (int i = 0; i < count; ++i) {
+        if (y >= bands[i].y1 && y <= bands[i].y2) {
+          covering++;
+          TEST_ASSERT_TRUE(bands[i].x1 >= strip.x1 && bands[i].x2 <= strip.x2);
+          TEST_ASSERT_TRUE(!visible || (bands[i].x1 <= a && bands[i].x2 >= b));
+        }
+      }
+      TEST_ASSERT_TRUE(visible ? covering == 1 : covering <= 1);
+    }
+  }
+}
+
+void test_packed_bands_are_aligned_and_intact()
+{
+  roundClipInit(&rc, PANEL_RES, MARGIN_PX);
+  Lcg rng{11};
+  std::vector<uint16_t> buf;
+  std::vector<uint16_t> before;
+  uint32_t packed = 0;
+  uint32_t refused = 0;
+  for (int n = 0; n < 20000; ++n) {
+    const RoundClipRect strip = randomStrip(rng);
+    const int w = strip.x2 - strip.x1 + 1;
+    const int h = strip.y2 - strip.y1 + 1;
+    buf.assign((size_t)w * h, 0);
+    for (int y = 0; y < h; ++y) {
+      for (int x = 0; x < w; ++x) {
+        buf[(size_t)y * w + x] = pixelAt(strip.x1 + x, strip.y1 + y);
+      }
+    }
+    before = buf;
+
+    RoundClipRect bands[FLUSH_MAX_BANDS];
+    size_t offsets[FLUSH_MAX_BANDS];
+    const int count = roundClipPlanBands(&rc, &strip, FLUSH_MAX_BANDS, FLUSH_COST_PX, 1, bands);
+    if (!roundClipPackBands((uint8_t *)buf.data(), sizeof(uint16_t), &strip, bands, count, FLUSH_ALIGN, offsets)) {
+      refused++;
+      TEST_ASSERT_TRUE(buf == before);
+      continue;
+    }
+    packed++;
+    for (int i = 0; i < count; ++i) {
+      TEST_ASSERT_EQUAL_UINT32(0, offsets[i] % FLUSH_ALIGN);
+      if (i > 0) {
+        TEST_ASSERT_TRUE(offsets[i] >= offsets[i - 1] + roundClipRectSize(&bands[i - 1]) * sizeof(uint16_t));
+      }
+      const uint16_t *band = (const uint16_t *)((const uint8_t *)buf.data() + offsets[i]);
+      const int bw = bands[i].x2 - bands[i].x1 + 1;
+      for (int y = bands[i].y1; y <= bands[i].y2; ++y) {
+        for (int x = bands[i].x1; x <= bands[i].x2; ++x) {
+          if (band[(size_t)(y - bands[i].y1) * bw + (x - bands[i].x1)] != pixelAt(x, y)) {
+            char msg[96];
+            snprintf(msg, sizeof(msg), "strip %d band %d pixel %d,%d", n, i, x, y);
+            TEST_FAIL_MESSAGE(msg);
+          }
+        }
+      }
+    }
+  }
+  char msg[96];
+  snprintf(msg, sizeof(msg), "%u strips packed, %u sent whole", (unsigned)packed, (unsigned)refused);
+  TEST_MESSAGE(msg);
+  // Refusals need a band flush against everything before it; keep them rare.
+  TEST_ASSERT_LESS_OR_EQUAL((packed + refused) / 50, refused);
+}
+
+// The case that cannot be packed in place: the first band is full width, so
+// the second starts right where its rows already are, two bytes off.
+void test_unaligned_in_place_band_is_refused()
+{
+  const RoundClipRect strip = {0, 0, 4, 3};   // 5 px wide: row 1 starts at byte 10
+  const RoundClipRect bands[2] = {{0, 0, 4, 0}, {0, 1, 2, 3}};
+  uint16_t buf[20];
+  for (int i = 0; i < 20; ++i) {
+    buf[i] = (uint16_t)i;
+  }
+  uint16_t before[20];
+  memcpy(before, buf, sizeof(buf));
+  size_t offsets[2];
+  TEST_ASSERT_FALSE(roundClipPackBands((uint8_t *)buf, 2, &strip, bands, 2, 4, offsets));
+  TEST_ASSERT_EQUAL_MEMORY(before, buf, sizeof(buf));
+  // Byte alignment never refuses.
+  TEST_ASSERT_TRUE(roundClipPackBands((uint8_t *)buf, 2, &strip, bands, 2, 1, offsets));
+  TEST_ASSERT_EQUAL_UINT32(10, offsets[1]);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_bands_cover_the_visible_pixels);
+  RUN_TEST(test_packed_bands_are_aligned_and_intact);
+  RUN_TEST(test_unaligned_in_place_band_is_refused);
+  return UNITY_END();
+}
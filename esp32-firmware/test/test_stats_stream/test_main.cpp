@@ -0,0 +1,229 @@
+// Stats stream decoder (net/stats_stream.h) against the Electron encoder.
+//
+//   pio test -e native-test -f test_stats_stream
+//
+// vectors.txt holds the frames StatsStreamEncoder produced for a scripted
+// sample sequence, together with the quantized values it encoded; the
+// electron-app side checks the same file with test-stats-stream.js, so a
+// change to either end that breaks the wire format fails one of the two.
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "net/stats_stream.h"
+
+struct StatsVector {
+  int32_t q[STATS_FIELD_COUNT];
+  std::vector<uint8_t> frame;   // empty: the encoder had nothing to send
+  bool keyframe;
+};
+
+static std::vector<StatsVector> vectors;
+
+void setUp() {}
+void tearDown() {}
+
+static std::string vectorsPath()
+{
+  std::string path = __FILE__;
+  const size_t slash = path.find_last_of("/\\");
+  return (slash == std::string::npos ? std::string() : path.substr(0, slash + 1)) + "vectors.txt";
+}
+
+static bool parseHex(const char *hex, std::vector<uint8_t> *out)
+{
+  out->clear();
+  if (strcmp(hex, "-") == 0) {
+    return true;
+  }
+  const size_t len = strlen(hex);
+  if (len == 0 || (len & 1) != 0) {
+    return false;
+  }
+  for (size_t i = 0; i < len; i += 2) {
+    unsigned byte = 0;
+    if (sscanf(hex + i, "%2x", &byte) != 1) {
+      return false;
+    }
+    out->push_back((uint8_t)byte);
+  }
+  return true;
+}
+
+// Runs first; the other tests replay what it loaded.
+void test_load_vectors()
+{
+  vectors.clear();
+  FILE *f = fopen(vectorsPath().c_str(), "r");
+  TEST_ASSERT_NOT_NULL_MESSAGE(f, "vectors.txt not found next to test_main.cpp");
+  char line[256];
+  while (fgets(line, sizeof(line), f) != nullptr) {
+    if (strncmp(line, "sample ", 7) != 0) {
+      continue;
+    }
+    const char *expected = strchr(line, '=');
+    TEST_ASSERT_NOT_NULL(expected);
+    StatsVector v;
+    char hex[128];
+    const int n = sscanf(expected + 1, "%d %d %d %d %127s", (int *)&v.q[0], (int *)&v.q[1], (int *)&v.q[2],
+                         (int *)&v.q[3], hex);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(5, n, line);
+    TEST_ASSERT_TRUE_MESSAGE(parseHex(hex, &v.frame), line);
+    v.keyframe = !v.frame.empty() && (v.frame[1] & STATS_FLAG_KEYFRAME) != 0;
+    vectors.push_back(v);
+  }
+  fclose(f);
+  TEST_ASSERT_GREATER_OR_EQUAL(10, vectors.size());
+}
+
+static void assertValues(const StatsStreamDecoder &dec, const StatsVector &v, size_t index)
+{
+  char msg[48];
+  snprintf(msg, sizeof(msg), "vector %u", (unsigned)index);
+  TEST_ASSERT_EQUAL_INT32_ARRAY_MESSAGE(v.q, dec.q, STATS_FIELD_COUNT, msg);
+}
+
+void test_vectors_cover_the_format()
+{
+  size_t keyframes = 0;
+  size_t deltas = 0;
+  size_t skipped = 0;
+  size_t multiByte = 0;
+  for (const StatsVector &v : vectors) {
+    if (v.frame.empty()) {
+      skipped++;
+      continue;
+    }
+    if (v.keyframe) {
+      keyframes++;
+    } else {
+      deltas++;
+    }
+    for (size_t i = 3; i < v.frame.size(); ++i) {
+      if (v.frame[i] & 0x80) {
+        multiByte++;
+        break;
+      }
+    }
+  }
+  TEST_ASSERT_GREATER_OR_EQUAL(3, keyframes);
+  TEST_ASSERT_GREATER_OR_EQUAL(6, deltas);
+  TEST_ASSERT_GREATER_OR_EQUAL(2, skipped);
+  TEST_ASSERT_GREATER_OR_EQUAL(4, multiByte);
+}
+
+void test_replay_matches_encoder()
+{
+  StatsStreamDecoder dec = {};
+  statsStreamReset(&dec);
+  uint32_t applied = 0;
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    const StatsVector &v = vectors[i];
+    if (!v.frame.empty()) {
+      TEST_ASSERT_TRUE(statsStreamIsFrame(v.frame.data(), v.frame.size()));
+      TEST_ASSERT_EQUAL_INT(STATS_FRAME_APPLIED, statsStreamDecode(&dec, v.frame.data(), v.frame.size()));
+      applied++;
+    }
+    // A skipped sample quantized to the values the device already holds.
+    assertValues(dec, v, i);
+  }
+  TEST_ASSERT_EQUAL_UINT32(applied, dec.frames);
+  TEST_ASSERT_EQUAL_UINT32(0, dec.gaps);
+  TEST_ASSERT_EQUAL_UINT32(0, dec.errors);
+}
+
+// Losing a delta frame must not leave wrong values on screen: every delta
+// after it is refused until the next keyframe, which restores the stream.
+void test_lost_delta_waits_for_keyframe()
+{
+  for (size_t drop = 0; drop < vectors.size(); ++drop) {
+    if (vectors[drop].frame.empty() || vectors[drop].keyframe) {
+      continue;
+    }
+    StatsStreamDecoder dec = {};
+    statsStreamReset(&dec);
+    bool waiting = false;
+    uint32_t refused = 0;
+    for (size_t i = 0; i < vectors.size(); ++i) {
+      const StatsVector &v = vectors[i];
+      if (i == drop) {
+        waiting = true;
+        continue;
+      }
+      if (v.frame.empty()) {
+        continue;
+      }
+      const StatsFrameResult r = statsStreamDecode(&dec, v.frame.data(), v.frame.size());
+      if (waiting && !v.keyframe) {
+        TEST_ASSERT_EQUAL_INT(STATS_FRAME_NEED_KEYFRAME, r);
+        refused++;
+        continue;
+      }
+      TEST_ASSERT_EQUAL_INT(STATS_FRAME_APPLIED, r);
+      waiting = false;
+      assertValues(dec, v, i);
+    }
+    // Only the first refused delta counts as a gap; a keyframe right after
+    // the lost frame hides it.
+    TEST_ASSERT_EQUAL_UINT32(refused > 0 ? 1 : 0, dec.gaps);
+  }
+}
+
+// Every frame, cut one byte short where it would otherwise apply, is
+// rejected as a whole and leaves the decoder waiting for a keyframe.
+void test_truncated_frame_is_invalid()
+{
+  for (size_t cut = 0; cut < vectors.size(); ++cut) {
+    const StatsVector &bad = vectors[cut];
+    if (bad.frame.size() < 4) {
+      continue;
+    }
+    StatsStreamDecoder dec = {};
+    statsStreamReset(&dec);
+    for (size_t i = 0; i < cut; ++i) {
+      if (!vectors[i].frame.empty()) {
+        statsStreamDecode(&dec, vectors[i].frame.data(), vectors[i].frame.size());
+      }
+    }
+    int32_t before[STATS_FIELD_COUNT];
+    memcpy(before, dec.q, sizeof(before));
+    TEST_ASSERT_EQUAL_INT(STATS_FRAME_INVALID, statsStreamDecode(&dec, bad.frame.data(), bad.frame.size() - 1));
+    TEST_ASSERT_EQUAL_UINT32(1, dec.errors);
+    TEST_ASSERT_FALSE(dec.synced);
+    TEST_ASSERT_EQUAL_INT32_ARRAY(before, dec.q, STATS_FIELD_COUNT);
+  }
+
+  StatsStreamDecoder dec = {};
+  statsStreamReset(&dec);
+  const uint8_t notStats[] = {'{', '"', 't'};
+  TEST_ASSERT_FALSE(statsStreamIsFrame(notStats, sizeof(notStats)));
+  TEST_ASSERT_EQUAL_INT(STATS_FRAME_INVALID, statsStreamDecode(&dec, notStats, sizeof(notStats)));
+}
+
+// seq is a uint8 on both ends: a delta right after seq 255 carries seq 0.
+void test_seq_wraps()
+{
+  StatsStreamDecoder dec = {};
+  statsStreamReset(&dec);
+  const uint8_t keyframe[] = {STATS_FRAME_TAG, 0x1F, 0xFF, 10, 20, 30, 40};
+  const uint8_t delta[] = {STATS_FRAME_TAG, 0x02, 0x00, 0x03};   // cpu -2
+  const uint8_t stale[] = {STATS_FRAME_TAG, 0x02, 0xFF, 0x03};
+  TEST_ASSERT_EQUAL_INT(STATS_FRAME_APPLIED, statsStreamDecode(&dec, keyframe, sizeof(keyframe)));
+  TEST_ASSERT_EQUAL_INT(STATS_FRAME_APPLIED, statsStreamDecode(&dec, delta, sizeof(delta)));
+  TEST_ASSERT_EQUAL_INT32(8, dec.q[0]);
+  TEST_ASSERT_EQUAL_INT(STATS_FRAME_NEED_KEYFRAME, statsStreamDecode(&dec, stale, sizeof(stale)));
+  TEST_ASSERT_EQUAL_INT32(8, dec.q[0]);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_load_vectors);
+  RUN_TEST(test_vectors_cover_the_format);
+  RUN_TEST(test_replay_matches_encoder);
+  RUN_TEST(test_lost_delta_waits_for_keyframe);
+  RUN_TEST(test_truncated_frame_is_invalid);
+  RUN_TEST(test_seq_wraps);
+  return UNITY_END();
+}
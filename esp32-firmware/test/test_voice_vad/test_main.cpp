@@ -0,0 +1,453 @@
+// VoiceVad (audio/voice_vad.h): frame accuracy and cost on labelled audio.
+//
+//   pio test -e native-test -f test_voice_vad
+//   VOICE_VAD_WAV_DIR=/path/to/clips pio test -e native-test -f test_voice_vad
+//
+// Clips are 16 kHz mono PCM with the speech marked in seconds. The built-in
+// ones are synthesized: voiced syllables (harmonics of a gliding pitch under
+// a syllable envelope) and fricative bursts over room noise, hum or a noise
+// step. With VOICE_VAD_WAV_DIR set, every <name>.wav there that has an
+// Audacity label file <name>.txt ("start<TAB>end<TAB>text" per line) is
+// scored the same way and must meet the same bounds.
+//
+// A frame is speech when at least half of it is inside a label. It counts as
+// sent when the stream would carry it, live or as the pre-roll main.cpp sends
+// on onset. Recall is the share of speech frames sent; false alarms are sent
+// frames outside every label, not counting the pre-roll and hangover that
+// are sent by design around each segment.
+#include <unity.h>
+#include <chrono>
+#include <dirent.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "audio/voice_vad.h"
+
+#define SAMPLE_RATE 16000
+#define FRAME_SAMPLES 640        // VOICE_SAMPLES_PER_CHUNK
+#define PREROLL_FRAMES 3         // VOICE_PREROLL_CHUNKS
+#define MIN_RECALL 0.95
+#define MAX_FALSE_ALARM 0.03
+
+struct Label {
+  double start;
+  double end;
+};
+
+struct Clip {
+  std::string name;
+  std::vector<int16_t> pcm;
+  std::vector<Label> labels;
+  uint32_t spuriousSegments = 0;           // allowed, each must still end
+  double maxFalseAlarm = MAX_FALSE_ALARM;
+  double scoreFrom = 0.0;                  // seconds; earlier frames only feed the detector
+};
+
+struct Score {
+  uint32_t speechFrames;
+  uint32_t speechSent;
+  uint32_t silenceFrames;
+  uint32_t falseAlarms;
+  uint32_t segmentsStarted;
+  uint32_t segmentsEnded;
+  double recall;
+  double falseAlarmRate;
+};
+
+void setUp() {}
+void tearDown() {}
+
+// --- synthesis ---------------------------------------------------------------
+
+struct Noise {
+  uint32_t state;
+  double uniform()
+  {
+    state = state * 1664525U + 1013904223U;
+    return (double)(state >> 8) / (double)(1U << 24) - 0.5;
+  }
+  // Roughly gaussian, unit RMS.
+  double gauss()
+  {
+    double sum = 0.0;
+    for (int i = 0; i < 12; ++i) {
+      sum += uniform();
+    }
+    return sum;
+  }
+};
+
+struct ClipBuilder {
+  std::vector<double> signal;
+  std::vector<Label> labels;
+  Noise noise = {2024};
+  double phase = 0.0;
+
+  explicit ClipBuilder(double seconds) : signal((size_t)(seconds * SAMPLE_RATE), 0.0) {}
+
+  void addNoise(double from, double to, double rms)
+  {
+    for (size_t i = (size_t)(from * SAMPLE_RATE); i < (size_t)(to * SAMPLE_RATE) && i < signal.size(); ++i) {
+      signal[i] += rms * noise.gauss();
+    }
+  }
+
+  void addHum(double from, double to, double amplitude)
+  {
+    for (size_t i = (size_t)(from * SAMPLE_RATE); i < (size_t)(to * SAMPLE_RATE) && i < signal.size(); ++i) {
+      const double t = (double)i / SAMPLE_RATE;
+      signal[i] += amplitude * (sin(2 * M_PI * 50 * t) + 0.3 * sin(2 * M_PI * 150 * t));
+    }
+  }
+
+  // Voiced speech: 4-5 syllables per second, pitch gliding around f0, the
+  // harmonics weighted towards a 500-1500 Hz formant region.
+  void addSpeech(double from, double to, double peak, double f0)
+  {
+    labels.push_back({from, to});
+    const double syllable = 0.22;
+    for (size_t i = (size_t)(from * SAMPLE_RATE); i < (size_t)(to * SAMPLE_RATE) && i < signal.size(); ++i) {
+      const double t = (double)i / SAMPLE_RATE - from;
+      const double s = fmod(t, syllable) / syllable;
+      const double envelope = (s < 0.15) ? s / 0.15 : (s > 0.75 ? 0.35 + 0.65 * (1.0 - s) / 0.25 : 1.0);
+      const double pitch = f0 * (1.0 + 0.12 * sin(2 * M_PI * 1.3 * t));
+      phase += 2 * M_PI * pitch / SAMPLE_RATE;
+      double v = 0.0;
+      for (int h = 1; h <= 24; ++h) {
+        const double freq = h * pitch;
+        if (freq > 4000) {
+          break;
+        }
+        const double formant = 1.0 / (1.0 + pow((freq - 900.0) / 600.0, 2.0));
+        v += formant * sin(h * phase) / sqrt((double)h);
+      }
+      signal[i] += peak * envelope * v * 0.5;
+    }
+  }
+
+  // Unvoiced fricative ("s", "f"): high-passed noise, quiet compared to vowels.
+  void addFricative(double from, double to, double rms)
+  {
+    double prev = 0.0;
+    for (size_t i = (size_t)(from * SAMPLE_RATE); i < (size_t)(to * SAMPLE_RATE) && i < signal.size(); ++i) {
+      const double n = noise.gauss();
+      signal[i] += rms * (n - prev) * 0.7;
+      prev = n;
+    }
+  }
+
+  // Marks a span as speech without adding voiced sound, for a fricative tail
+  // that belongs to the word before it.
+  void extendLabel(double to)
+  {
+    labels.back().end = to;
+  }
+
+  Clip build(const char *name) const
+  {
+    Clip clip;
+    clip.name = name;
+    clip.labels = labels;
+    clip.pcm.resize(signal.size());
+    for (size_t i = 0; i < signal.size(); ++i) {
+      const double v = signal[i];
+      clip.pcm[i] = (int16_t)((v > 32767.0) ? 32767 : (v < -32768.0 ? -32768 : lrint(v)));
+    }
+    return clip;
+  }
+};
+
+static std::vector<Clip> syntheticClips()
+{
+  std::vector<Clip> clips;
+  {
+    ClipBuilder b(4.0);
+    b.addNoise(0, 4.0, 40);
+    b.addSpeech(1.0, 2.2, 6000, 130);
+    clips.push_back(b.build("quiet_room"));
+  }
+  {
+    ClipBuilder b(4.5);
+    b.addNoise(0, 4.5, 350);
+    b.addSpeech(1.2, 2.6, 5000, 210);
+    clips.push_back(b.build("fan_noise_12db"));
+  }
+  {
+    ClipBuilder b(6.0);
+    b.addNoise(0, 6.0, 350);
+    b.addSpeech(1.0, 4.5, 5000, 160);
+    clips.push_back(b.build("long_utterance_in_noise"));
+  }
+  {
+    ClipBuilder b(6.0);
+    b.addNoise(0, 6.0, 40);
+    b.addSpeech(1.0, 4.5, 5000, 110);
+    clips.push_back(b.build("long_utterance_quiet"));
+  }
+  {
+    ClipBuilder b(6.0);
+    b.addNoise(0, 6.0, 60);
+    b.addSpeech(0.8, 1.8, 5000, 120);
+    b.addSpeech(3.0, 4.4, 4000, 180);
+    clips.push_back(b.build("two_utterances"));
+  }
+  {
+    ClipBuilder b(4.0);
+    b.addNoise(0, 4.0, 40);
+    b.addSpeech(1.0, 1.9, 5000, 140);
+    b.addFricative(1.9, 2.2, 900);
+    b.extendLabel(2.2);
+    clips.push_back(b.build("fricative_tail"));
+  }
+  {
+    // A wake-word stream starts on the pre-roll: the tail of the keyword,
+    // a pause, then the command. The keyword must not set the floor so high
+    // that the command is missed.
+    ClipBuilder b(4.5);
+    b.addNoise(0, 4.5, 40);
+    b.addSpeech(0, 0.45, 6000, 150);
+    b.addSpeech(1.1, 2.6, 5000, 150);
+    Clip clip = b.build("wake_preroll_then_command");
+    clip.labels.erase(clip.labels.begin());
+    clip.scoreFrom = 0.45;
+    clips.push_back(clip);
+  }
+  {
+    ClipBuilder b(4.0);
+    b.addNoise(0, 4.0, 30);
+    b.addHum(0, 4.0, 2500);
+    clips.push_back(b.build("mains_hum_only"));
+  }
+  {
+    // A fan switching on (+14 dB) looks like an onset; the floor has to
+    // catch up so the segment ends instead of streaming noise for good.
+    ClipBuilder b(6.0);
+    b.addNoise(0, 2.0, 50);
+    b.addNoise(2.0, 6.0, 250);
+    Clip clip = b.build("noise_step_only");
+    clip.spuriousSegments = 1;
+    clip.maxFalseAlarm = 0.2;
+    clips.push_back(clip);
+  }
+  return clips;
+}
+
+// --- labelled WAV corpus -----------------------------------------------------
+
+static bool readWav(const std::string &path, std::vector<int16_t> *pcm)
+{
+  FILE *f = fopen(path.c_str(), "rb");
+  if (f == nullptr) {
+    return false;
+  }
+  uint8_t riff[12];
+  bool ok = fread(riff, 1, 12, f) == 12 && memcmp(riff, "RIFF", 4) == 0 && memcmp(riff + 8, "WAVE", 4) == 0;
+  bool formatOk = false;
+  while (ok) {
+    uint8_t header[8];
+    if (fread(header, 1, 8, f) != 8) {
+      ok = false;
+      break;
+    }
+    const uint32_t size = header[4] | (header[5] << 8) | (header[6] << 16) | ((uint32_t)header[7] << 24);
+    if (memcmp(header, "fmt ", 4) == 0) {
+      uint8_t fmt[16];
+      ok = size >= 16 && fread(fmt, 1, 16, f) == 16;
+      const uint16_t format = fmt[0] | (fmt[1] << 8);
+      const uint16_t channels = fmt[2] | (fmt[3] << 8);
+      const uint32_t rate = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16) | ((uint32_t)fmt[7] << 24);
+      const uint16_t bits = fmt[14] | (fmt[15] << 8);
+      formatOk = ok && format == 1 && channels == 1 && rate == SAMPLE_RATE && bits == 16;
+      fseek(f, (long)(size - 16 + (size & 1)), SEEK_CUR);
+    } else if (memcmp(header, "data", 4) == 0) {
+      pcm->resize(size / 2);
+      ok = formatOk && fread(pcm->data(), 2, pcm->size(), f) == pcm->size();
+      break;
+    } else {
+      fseek(f, (long)(size + (size & 1)), SEEK_CUR);
+    }
+  }
+  fclose(f);
+  return ok;
+}
+
+static std::vector<Label> readLabels(const std::string &path)
+{
+  std::vector<Label> labels;
+  FILE *f = fopen(path.c_str(), "r");
+  if (f == nullptr) {
+    return labels;
+  }
+  char line[256];
+  while (fgets(line, sizeof(line), f) != nullptr) {
+    Label label;
+    if (sscanf(line, "%lf %lf", &label.start, &label.end) == 2 && label.end > label.start) {
+      labels.push_back(label);
+    }
+  }
+  fclose(f);
+  return labels;
+}
+
+static std::vector<Clip> corpusClips(const char *dir)
+{
+  std::vector<Clip> clips;
+  DIR *d = opendir(dir);
+  if (d == nullptr) {
+    return clips;
+  }
+  while (dirent *entry = readdir(d)) {
+    const std::string name = entry->d_name;
+    if (name.size() < 5 || name.compare(name.size() - 4, 4, ".wav") != 0) {
+      continue;
+    }
+    const std::string base = std::string(dir) + "/" + name.substr(0, name.size() - 4);
+    Clip clip;
+    clip.name = name;
+    clip.labels = readLabels(base + ".txt");
+    if (readWav(base + ".wav", &clip.pcm)) {
+      clips.push_back(clip);
+    }
+  }
+  closedir(d);
+  return clips;
+}
+
+// --- scoring -----------------------------------------------------------------
+
+static Score scoreClip(const Clip &clip)
+{
+  const size_t frames = clip.pcm.size() / FRAME_SAMPLES;
+  std::vector<bool> truth(frames, false);
+  std::vector<bool> sent(frames, false);
+  std::vector<bool> byDesign(frames, false);   // pre-roll and hangover
+
+  for (size_t f = 0; f < frames; ++f) {
+    const double start = (double)(f * FRAME_SAMPLES) / SAMPLE_RATE;
+    const double end = (double)((f + 1) * FRAME_SAMPLES) / SAMPLE_RATE;
+    double covered = 0.0;
+    for (const Label &label : clip.labels) {
+      const double lo = (label.start > start) ? label.start : start;
+      const double hi = (label.end < end) ? label.end : end;
+      if (hi > lo) {
+        covered += hi - lo;
+      }
+    }
+    truth[f] = covered * 2 >= end - start;
+  }
+
+  Score score = {};
+  VoiceVad vad;
+  voiceVadReset(&vad);
+  uint32_t prerollCount = 0;
+  for (size_t f = 0; f < frames; ++f) {
+    const VoiceVadEvent event = voiceVadProcess(&vad, &clip.pcm[f * FRAME_SAMPLES], FRAME_SAMPLES);
+    const bool scored = (double)(f * FRAME_SAMPLES) / SAMPLE_RATE >= clip.scoreFrom;
+    if (event == VOICE_VAD_SPEECH_START && scored) {
+      score.segmentsStarted++;
+    }
+    if (event == VOICE_VAD_SPEECH_START) {
+      for (uint32_t i = 1; i <= prerollCount && i <= f; ++i) {
+        sent[f - i] = true;
+        byDesign[f - i] = true;
+      }
+      prerollCount = 0;
+    }
+    if (voiceVadShouldSend(&vad)) {
+      sent[f] = true;
+      byDesign[f] = vad.silenceRun > 0;
+    } else if (!vad.inSpeech) {
+      prerollCount = (prerollCount < PREROLL_FRAMES) ? prerollCount + 1 : PREROLL_FRAMES;
+    }
+    if (event == VOICE_VAD_SPEECH_END && scored) {
+      score.segmentsEnded++;
+    }
+  }
+
+  for (size_t f = (size_t)(clip.scoreFrom * SAMPLE_RATE + FRAME_SAMPLES - 1) / FRAME_SAMPLES; f < frames; ++f) {
+    if (truth[f]) {
+      score.speechFrames++;
+      score.speechSent += sent[f] ? 1 : 0;
+    } else {
+      score.silenceFrames++;
+      score.falseAlarms += (sent[f] && !byDesign[f]) ? 1 : 0;
+    }
+  }
+  score.recall = (score.speechFrames > 0) ? (double)score.speechSent / score.speechFrames : 1.0;
+  score.falseAlarmRate = (score.silenceFrames > 0) ? (double)score.falseAlarms / score.silenceFrames : 0.0;
+  return score;
+}
+
+static void assertClip(const Clip &clip)
+{
+  const Score s = scoreClip(clip);
+  char msg[200];
+  snprintf(msg, sizeof(msg), "%s: recall %.3f (%u/%u), false alarms %.3f (%u/%u), segments %u/%u, labels %u",
+           clip.name.c_str(), s.recall, (unsigned)s.speechSent, (unsigned)s.speechFrames, s.falseAlarmRate,
+           (unsigned)s.falseAlarms, (unsigned)s.silenceFrames, (unsigned)s.segmentsStarted,
+           (unsigned)s.segmentsEnded, (unsigned)clip.labels.size());
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_TRUE_MESSAGE(s.recall >= MIN_RECALL, msg);
+  TEST_ASSERT_TRUE_MESSAGE(s.falseAlarmRate <= clip.maxFalseAlarm, msg);
+  TEST_ASSERT_TRUE_MESSAGE(s.segmentsStarted >= clip.labels.size(), msg);
+  TEST_ASSERT_TRUE_MESSAGE(s.segmentsStarted <= clip.labels.size() + clip.spuriousSegments, msg);
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(s.segmentsStarted, s.segmentsEnded, msg);
+}
+
+void test_synthetic_clips()
+{
+  for (const Clip &clip : syntheticClips()) {
+    assertClip(clip);
+  }
+}
+
+void test_wav_corpus()
+{
+  const char *dir = getenv("VOICE_VAD_WAV_DIR");
+  if (dir == nullptr || dir[0] == '\0') {
+    TEST_MESSAGE("VOICE_VAD_WAV_DIR not set, no recorded clips scored");
+    return;
+  }
+  const std::vector<Clip> clips = corpusClips(dir);
+  TEST_ASSERT_GREATER_THAN(0, clips.size());
+  for (const Clip &clip : clips) {
+    assertClip(clip);
+  }
+}
+
+// Host time per 40 ms frame. The device figure is vadUsAvg in
+// voice_stream_stop; this one only tracks relative changes to the loop.
+void test_cost_per_frame()
+{
+  const std::vector<Clip> clips = syntheticClips();
+  uint32_t frames = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < 20; ++round) {
+    for (const Clip &clip : clips) {
+      VoiceVad vad;
+      voiceVadReset(&vad);
+      for (size_t i = 0; i + FRAME_SAMPLES <= clip.pcm.size(); i += FRAME_SAMPLES) {
+        voiceVadProcess(&vad, &clip.pcm[i], FRAME_SAMPLES);
+        frames++;
+      }
+    }
+  }
+  const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  char msg[96];
+  snprintf(msg, sizeof(msg), "%.0f ns per %d-sample frame over %u frames", ns / frames, FRAME_SAMPLES, (unsigned)frames);
+  TEST_MESSAGE(msg);
+  // One sum and one compare per sample: anything near 1% of the 40 ms frame
+  // on a host means the loop stopped being linear.
+  TEST_ASSERT_LESS_THAN(400000.0, ns / frames);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_synthetic_clips);
+  RUN_TEST(test_wav_corpus);
+  RUN_TEST(test_cost_per_frame);
+  return UNITY_END();
+}
@@ -0,0 +1,309 @@
+// Compressed server messages (net/ws_compression.h) against the Electron encoder.
+//
+//   pio test -e native-test -f test_ws_compression
+//
+// vectors.txt holds frames compressLz4Block() produced for edge-case inputs
+// and for every message in trace.jsonl, a device session as the server sends
+// it; the electron-app side checks the same file with test-ws-compression.js,
+// so a change to either end that breaks the wire format fails one of the two.
+// Frames are decoded from exact-size heap copies, so a decoder overread
+// shows up under -fsanitize=address. The last test replays the trace and
+// reports bytes on air and decode time per message type.
+#include <unity.h>
+#include <chrono>
+#include <map>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "net/ws_compression.h"
+
+struct CompressionVector {
+  std::string name;
+  std::vector<uint8_t> raw;
+  std::vector<uint8_t> frame;
+};
+
+static std::vector<CompressionVector> vectors;
+static std::vector<CompressionVector> traceFrames;   // name is the message type
+
+void setUp()
+{
+  memset(&ws_compression_stats, 0, sizeof(ws_compression_stats));
+}
+
+void tearDown() {}
+
+static std::string testFile(const char *name)
+{
+  std::string path = __FILE__;
+  const size_t slash = path.find_last_of("/\\");
+  return (slash == std::string::npos ? std::string() : path.substr(0, slash + 1)) + name;
+}
+
+static bool parseHex(const char *hex, std::vector<uint8_t> *out)
+{
+  out->clear();
+  if (strcmp(hex, "-") == 0) {
+    return true;
+  }
+  const size_t len = strlen(hex);
+  if (len == 0 || (len & 1) != 0) {
+    return false;
+  }
+  for (size_t i = 0; i < len; i += 2) {
+    unsigned byte = 0;
+    if (sscanf(hex + i, "%2x", &byte) != 1) {
+      return false;
+    }
+    out->push_back((uint8_t)byte);
+  }
+  return true;
+}
+
+static std::string messageType(const std::string &text)
+{
+  const char *key = "\"type\":\"";
+  const size_t at = text.find(key);
+  if (at == std::string::npos) {
+    return "?";
+  }
+  const size_t start = at + strlen(key);
+  return text.substr(start, text.find('"', start) - start);
+}
+
+// Decodes from an exact-size copy into an exact-size buffer (raw + NUL).
+static size_t decode(const std::vector<uint8_t> &frame, size_t rawCap, std::vector<uint8_t> *out)
+{
+  std::vector<uint8_t> wire(frame);
+  out->assign(rawCap + 1, 0xEE);
+  return wsCompressionDecode(wire.data(), wire.size(), out->data(), out->size());
+}
+
+// Runs first; the other tests replay what it loaded.
+void test_load_vectors()
+{
+  vectors.clear();
+  traceFrames.clear();
+  std::vector<std::string> trace;
+  FILE *f = fopen(testFile("trace.jsonl").c_str(), "r");
+  TEST_ASSERT_NOT_NULL_MESSAGE(f, "trace.jsonl not found next to test_main.cpp");
+  std::string line;
+  for (int c = fgetc(f); c != EOF; c = fgetc(f)) {
+    if (c == '\n') {
+      if (!line.empty()) {
+        trace.push_back(line);
+      }
+      line.clear();
+    } else {
+      line += (char)c;
+    }
+  }
+  fclose(f);
+
+  f = fopen(testFile("vectors.txt").c_str(), "r");
+  TEST_ASSERT_NOT_NULL_MESSAGE(f, "vectors.txt not found next to test_main.cpp");
+  static char buf[1 << 16];
+  while (fgets(buf, sizeof(buf), f) != nullptr) {
+    char kind[16], name[64], raw[sizeof(buf)], frame[sizeof(buf)];
+    if (sscanf(buf, "vector %63s %s = %s", name, raw, frame) == 3) {
+      CompressionVector v;
+      v.name = name;
+      TEST_ASSERT_TRUE(parseHex(raw, &v.raw));
+      TEST_ASSERT_TRUE(parseHex(frame, &v.frame));
+      vectors.push_back(v);
+    } else if (sscanf(buf, "%15s", kind) == 1 && strcmp(kind, "trace") == 0) {
+      unsigned index = 0;
+      TEST_ASSERT_EQUAL_INT(2, sscanf(buf, "trace %u = %s", &index, frame));
+      TEST_ASSERT_TRUE(index >= 1 && index <= trace.size());
+      CompressionVector v;
+      v.name = messageType(trace[index - 1]);
+      v.raw.assign(trace[index - 1].begin(), trace[index - 1].end());
+      TEST_ASSERT_TRUE(parseHex(frame, &v.frame));
+      traceFrames.push_back(v);
+    }
+  }
+  fclose(f);
+  TEST_ASSERT_TRUE(vectors.size() >= 10);
+  TEST_ASSERT_EQUAL_UINT32(trace.size(), traceFrames.size());
+}
+
+void test_vectors_decode()
+{
+  for (const CompressionVector &v : vectors) {
+    TEST_ASSERT_TRUE_MESSAGE(wsCompressionIsFrame(v.frame.data(), v.frame.size()), v.name.c_str());
+    std::vector<uint8_t> out;
+    if (v.raw.empty()) {
+      // The encoder's empty block is one zero token; the device refuses
+      // zero-length messages, and the server never compresses them.
+      TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, decode(v.frame, 0, &out), v.name.c_str());
+      TEST_ASSERT_TRUE(wsLz4DecodeBlock(v.frame.data() + 3, v.frame.size() - 3, out.data(), 0));
+      continue;
+    }
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(v.raw.size(), decode(v.frame, v.raw.size(), &out), v.name.c_str());
+    TEST_ASSERT_EQUAL_MEMORY(v.raw.data(), out.data(), v.raw.size());
+    TEST_ASSERT_EQUAL_UINT8(0, out[v.raw.size()]);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, ws_compression_stats.errors - 1);   // only "empty"
+}
+
+// Inputs with nothing to match come out larger, so the server sends them as
+// text; long runs and repeats must shrink by far more than the header.
+void test_compression_shape()
+{
+  for (const CompressionVector &v : vectors) {
+    if (v.name == "incompressible") {
+      TEST_ASSERT_TRUE_MESSAGE(v.frame.size() > v.raw.size(), v.name.c_str());
+    } else if (v.name == "run_5000" || v.name == "period_2" || v.name == "long_match") {
+      TEST_ASSERT_TRUE_MESSAGE(v.frame.size() * 4 < v.raw.size(), v.name.c_str());
+    }
+  }
+}
+
+void test_truncated_frames_fail()
+{
+  std::vector<const CompressionVector *> all;
+  for (const CompressionVector &v : vectors) {
+    all.push_back(&v);
+  }
+  for (const CompressionVector &v : traceFrames) {
+    all.push_back(&v);
+  }
+  uint32_t checked = 0;
+  for (const CompressionVector *v : all) {
+    for (size_t len = 0; len < v->frame.size(); ++len) {
+      std::vector<uint8_t> prefix(v->frame.begin(), v->frame.begin() + len);
+      std::vector<uint8_t> out;
+      if (decode(prefix, v->raw.size(), &out) != 0) {
+        char msg[96];
+        snprintf(msg, sizeof(msg), "%s decoded from %u of %u bytes", v->name.c_str(), (unsigned)len,
+                 (unsigned)v->frame.size());
+        TEST_FAIL_MESSAGE(msg);
+      }
+      checked++;
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT32(checked, ws_compression_stats.errors);
+}
+
+static std::vector<uint8_t> withRawLength(const std::vector<uint8_t> &frame, size_t rawLen)
+{
+  const uint8_t *cursor = frame.data() + 2;
+  size_t oldLen = 0;
+  wsCompressionReadLength(&cursor, frame.data() + frame.size(), &oldLen);
+  std::vector<uint8_t> out = {WS_COMPRESSION_FRAME_TAG, WS_COMPRESSION_CODEC_LZ4};
+  do {
+    out.push_back((uint8_t)((rawLen & 0x7F) | (rawLen > 0x7F ? 0x80 : 0)));
+    rawLen >>= 7;
+  } while (rawLen > 0);
+  out.insert(out.end(), cursor, frame.data() + frame.size());
+  return out;
+}
+
+void test_length_mismatch_fails()
+{
+  for (const CompressionVector &v : vectors) {
+    if (v.raw.empty()) {
+      continue;
+    }
+    std::vector<uint8_t> out;
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, decode(withRawLength(v.frame, v.raw.size() - 1), v.raw.size(), &out),
+                                     v.name.c_str());
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, decode(withRawLength(v.frame, v.raw.size() + 1), v.raw.size() + 1, &out),
+                                     v.name.c_str());
+    // Right length, but no room for it (and the NUL).
+    std::vector<uint8_t> wire(v.frame);
+    std::vector<uint8_t> small(v.raw.size());
+    TEST_ASSERT_EQUAL_UINT32(0, wsCompressionDecode(wire.data(), wire.size(), small.data(), small.size()));
+    // Unknown codec or tag.
+    wire[1] = 2;
+    TEST_ASSERT_EQUAL_UINT32(0, decode(wire, v.raw.size(), &out));
+    wire[1] = WS_COMPRESSION_CODEC_LZ4;
+    wire[0] = '{';
+    TEST_ASSERT_EQUAL_UINT32(0, decode(wire, v.raw.size(), &out));
+  }
+  // A length that never ends.
+  const std::vector<uint8_t> endless = {WS_COMPRESSION_FRAME_TAG, WS_COMPRESSION_CODEC_LZ4, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x00};
+  std::vector<uint8_t> out;
+  TEST_ASSERT_EQUAL_UINT32(0, decode(endless, 16, &out));
+}
+
+void test_bad_matches_fail()
+{
+  uint8_t out[32];
+  // One literal, then a match reaching two bytes back.
+  const uint8_t tooFar[] = {0x10, 'a', 0x02, 0x00};
+  TEST_ASSERT_FALSE(wsLz4DecodeBlock(tooFar, sizeof(tooFar), out, 5));
+  const uint8_t zeroOffset[] = {0x10, 'a', 0x00, 0x00};
+  TEST_ASSERT_FALSE(wsLz4DecodeBlock(zeroOffset, sizeof(zeroOffset), out, 5));
+  // Offset 1 repeats: 'a' then 4 more, exactly filling dst.
+  const uint8_t repeat[] = {0x10, 'a', 0x01, 0x00};
+  TEST_ASSERT_TRUE(wsLz4DecodeBlock(repeat, sizeof(repeat), out, 5));
+  TEST_ASSERT_EQUAL_MEMORY("aaaaa", out, 5);
+  // The same match into a buffer one byte short.
+  TEST_ASSERT_FALSE(wsLz4DecodeBlock(repeat, sizeof(repeat), out, 4));
+  // Literal length extension that runs off the end.
+  const uint8_t runOff[] = {0xF0, 0xFF};
+  TEST_ASSERT_FALSE(wsLz4DecodeBlock(runOff, sizeof(runOff), out, sizeof(out)));
+}
+
+// The device side of the replay: every trace frame decoded back to the
+// message, then bytes on air (the frame when it is smaller, as the server
+// picks) and decode time per message type.
+void test_trace_replay()
+{
+  struct TypeTotals {
+    uint32_t messages;
+    uint32_t rawBytes;
+    uint32_t wireBytes;
+    double decodeUs;
+  };
+  std::map<std::string, TypeTotals> totals;
+  const int rounds = 200;
+  std::vector<uint8_t> out(WS_COMPRESSION_MAX_RAW_BYTES + 1);
+  uint32_t rawAll = 0;
+  uint32_t wireAll = 0;
+  for (const CompressionVector &v : traceFrames) {
+    std::vector<uint8_t> exact;
+    TEST_ASSERT_EQUAL_UINT32(v.raw.size(), decode(v.frame, v.raw.size(), &exact));
+    TEST_ASSERT_EQUAL_MEMORY(v.raw.data(), exact.data(), v.raw.size());
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+      wsCompressionDecode(v.frame.data(), v.frame.size(), out.data(), out.size());
+    }
+    const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / rounds;
+    TypeTotals &t = totals[v.name];
+    const uint32_t wire = (uint32_t)(v.frame.size() < v.raw.size() ? v.frame.size() : v.raw.size());
+    t.messages++;
+    t.rawBytes += (uint32_t)v.raw.size();
+    t.wireBytes += wire;
+    t.decodeUs += us;
+    rawAll += (uint32_t)v.raw.size();
+    wireAll += wire;
+  }
+  printf("[ws_compression] %-26s %5s %7s %7s %6s %14s\n", "type", "msgs", "raw B", "wire B", "ratio", "decode us/msg");
+  for (const auto &entry : totals) {
+    const TypeTotals &t = entry.second;
+    printf("[ws_compression] %-26s %5u %7u %7u %6.3f %14.2f\n", entry.first.c_str(), (unsigned)t.messages,
+           (unsigned)t.rawBytes, (unsigned)t.wireBytes, (double)t.wireBytes / t.rawBytes, t.decodeUs / t.messages);
+  }
+  char msg[96];
+  snprintf(msg, sizeof(msg), "trace: %u of %u bytes on air if every type were compressed", (unsigned)wireAll,
+           (unsigned)rawAll);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_EQUAL_UINT32(0, ws_compression_stats.errors);
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_load_vectors);
+  RUN_TEST(test_vectors_decode);
+  RUN_TEST(test_compression_shape);
+  RUN_TEST(test_truncated_frames_fail);
+  RUN_TEST(test_length_mismatch_fails);
+  RUN_TEST(test_bad_matches_fail);
+  RUN_TEST(test_trace_replay);
+  return UNITY_END();
+}
@@ -0,0 +1,493 @@
+// WsJsonWriter (net/ws_json_writer.h): output and heap use per message type.
+//
+//   pio test -e native-test -f test_ws_json_writer
+//
+// Each message is written with the same fields and worst-case values as its
+// sender in main.cpp. Streamed messages are reassembled from the fragments;
+// queued ones go through a real outbox slot. Heap use is counted around the
+// writer: malloc/free are wrapped on glibc, operator new everywhere.
+#include <unity.h>
+#include <new>
+#include <stdlib.h>
+#include "net/ws_outbox.h"
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+static bool heapCounting = false;
+static size_t heapLive = 0;
+static size_t heapPeak = 0;
+static uint32_t heapAllocs = 0;
+
+static void noteAlloc(void *p)
+{
+  if (heapCounting && p != nullptr) {
+    heapAllocs++;
+#if defined(__GLIBC__)
+    heapLive += malloc_usable_size(p);
+#else
+    heapLive += 1;
+#endif
+    if (heapLive > heapPeak) {
+      heapPeak = heapLive;
+    }
+  }
+}
+
+static void noteFree(void *p)
+{
+#if defined(__GLIBC__)
+  if (heapCounting && p != nullptr) {
+    const size_t n = malloc_usable_size(p);
+    heapLive = (n > heapLive) ? 0 : heapLive - n;
+  }
+#else
+  (void)p;
+#endif
+}
+
+#if defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *p, size_t size);
+void __libc_free(void *p);
+
+void *malloc(size_t size)
+{
+  void *p = __libc_malloc(size);
+  noteAlloc(p);
+  return p;
+}
+
+void *calloc(size_t count, size_t size)
+{
+  void *p = __libc_calloc(count, size);
+  noteAlloc(p);
+  return p;
+}
+
+void *realloc(void *p, size_t size)
+{
+  noteFree(p);
+  void *q = __libc_realloc(p, size);
+  noteAlloc(q);
+  return q;
+}
+
+void free(void *p)
+{
+  noteFree(p);
+  __libc_free(p);
+}
+}
+#else
+void *operator new(size_t size)
+{
+  void *p = malloc(size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  noteAlloc(p);
+  return p;
+}
+
+void operator delete(void *p) noexcept
+{
+  free(p);
+}
+#endif
+
+static void heapBegin()
+{
+  heapLive = 0;
+  heapPeak = 0;
+  heapAllocs = 0;
+  heapCounting = true;
+}
+
+static void heapEnd()
+{
+  heapCounting = false;
+}
+
+// Fragment sink: reassembles the message and checks the frame sequence.
+struct Received {
+  char text[16384];
+  size_t len;
+  uint32_t fragments;
+  bool sawFin;
+  bool badSequence;
+};
+
+static Received received;
+
+static bool collectFragment(void *ctx, bool firstFragment, const uint8_t *payload, size_t length, bool fin)
+{
+  Received *r = (Received *)ctx;
+  if (firstFragment != (r->fragments == 0) || r->sawFin || length > WS_JSON_FRAGMENT_BYTES) {
+    r->badSequence = true;
+  }
+  if (r->len + length < sizeof(r->text)) {
+    memcpy(r->text + r->len, payload, length);
+    r->len += length;
+  }
+  r->fragments++;
+  r->sawFin = fin;
+  return true;
+}
+
+static FragmentWebSocketsClient socket;
+
+void setUp()
+{
+  memset(&received, 0, sizeof(received));
+  socket.onFragment = collectFragment;
+  socket.ctx = &received;
+  memset(ws_outbox_slots, 0, sizeof(ws_outbox_slots));
+  memset(&ws_outbox_stats, 0, sizeof(ws_outbox_stats));
+  ws_outbox_scratch.used = false;
+  ws_outbox_scratch_target = nullptr;
+}
+
+void tearDown() {}
+
+static void report(const char *type, uint32_t bytes, uint32_t fragments)
+{
+  printf("[ws_json] %-24s %6u bytes %3u fragments  heap peak %u bytes in %u allocations\n", type, (unsigned)bytes,
+         (unsigned)fragments, (unsigned)heapPeak, (unsigned)heapAllocs);
+}
+
+// Just enough of a JSON reader to check the output is well-formed.
+static const char *skipValue(const char *p);
+
+static const char *skipString(const char *p)
+{
+  if (*p != '"') {
+    return nullptr;
+  }
+  for (++p; *p != '\0' && *p != '"'; ++p) {
+    if (*p == '\\') {
+      ++p;
+    } else if ((uint8_t)*p < 0x20) {
+      return nullptr;
+    }
+  }
+  return (*p == '"') ? p + 1 : nullptr;
+}
+
+static const char *skipContainer(const char *p, char close, bool keyed)
+{
+  ++p;
+  if (*p == close) {
+    return p + 1;
+  }
+  for (;;) {
+    if (keyed) {
+      p = skipString(p);
+      if (p == nullptr || *p != ':') {
+        return nullptr;
+      }
+      ++p;
+    }
+    p = skipValue(p);
+    if (p == nullptr) {
+      return nullptr;
+    }
+    if (*p == close) {
+      return p + 1;
+    }
+    if (*p != ',') {
+      return nullptr;
+    }
+    ++p;
+  }
+}
+
+static const char *skipValue(const char *p)
+{
+  if (*p == '{') {
+    return skipContainer(p, '}', true);
+  }
+  if (*p == '[') {
+    return skipContainer(p, ']', false);
+  }
+  if (*p == '"') {
+    return skipString(p);
+  }
+  const char *start = p;
+  while (*p != '\0' && strchr(",}]", *p) == nullptr) {
+    ++p;
+  }
+  return (p > start) ? p : nullptr;
+}
+
+static bool isWellFormed(const char *text)
+{
+  const char *end = skipValue(text);
+  return end != nullptr && *end == '\0';
+}
+
+static void test_fields_and_escapes()
+{
+  uint8_t buf[512];
+  WsJsonWriter json(buf, sizeof(buf));
+  json.beginObject();
+  json.field("s", "a\"b\\c\nd\te\x01");
+  json.field("t", true);
+  json.field("f", false);
+  json.field("d", 1.25);
+  json.field("nan", (double)NAN);
+  json.field("min", (int64_t)INT64_MIN);
+  json.field("max", (uint64_t)UINT64_MAX);
+  json.beginArray("a");
+  json.value(1);
+  json.value("x");
+  json.beginObject();
+  json.endObject();
+  json.endArray();
+  json.beginObject("o");
+  json.field("k", (uint8_t)7);
+  json.endObject();
+  json.endObject();
+  TEST_ASSERT_TRUE(json.finish());
+  buf[json.bytesWritten()] = '\0';
+  TEST_ASSERT_EQUAL_STRING("{\"s\":\"a\\\"b\\\\c\\nd\\te\\u0001\",\"t\":true,\"f\":false,\"d\":1.25,\"nan\":null,"
+                           "\"min\":-9223372036854775808,\"max\":18446744073709551615,\"a\":[1,\"x\",{}],"
+                           "\"o\":{\"k\":7}}",
+                           (const char *)buf);
+}
+
+static void test_buffer_overflow_fails_message()
+{
+  uint8_t buf[16];
+  WsJsonWriter json(buf, sizeof(buf));
+  json.beginObject();
+  json.field("key", "a value longer than the buffer");
+  json.endObject();
+  TEST_ASSERT_FALSE(json.finish());
+  TEST_ASSERT_EQUAL_UINT32(0, json.fragments());
+}
+
+// sendSdListResponse(): a full 64-entry page of long UTF-8 names.
+static void test_sd_list_response()
+{
+  heapBegin();
+  WsJsonWriter json(socket);
+  json.beginObject();
+  json.field("type", "sd_list_response");
+  json.beginObject("data");
+  json.field("requestId", "req-0123456789abcdef");
+  json.field("deviceId", "esp32_s3_001");
+  json.field("sdMounted", true);
+  json.field("root", "/");
+  json.field("dir", "/photos/2024 \xE6\x97\x85\xE8\xA1\x8C");
+  json.field("recursive", true);
+  json.field("generation", (uint32_t)UINT32_MAX);
+  json.field("snapshotAgeMs", (uint32_t)UINT32_MAX);
+  json.field("offset", 0);
+  json.field("limit", 64);
+  json.field("total", 120);
+  json.field("imageCount", 100);
+  json.field("audioCount", 10);
+  json.field("videoCount", 5);
+  json.field("otherCount", 5);
+  json.field("timestamp", (uint32_t)UINT32_MAX);
+  json.beginArray("files");
+  char name[64];
+  char path[192];
+  for (int i = 0; i < 64; ++i) {
+    snprintf(name, sizeof(name), "%02d \xE6\x97\x85\xE8\xA1\x8C \"quoted\" \\ long file name padding.jpg", i);
+    snprintf(path, sizeof(path), "/photos/2024 \xE6\x97\x85\xE8\xA1\x8C/sub folder with a long name/%s", name);
+    json.beginObject();
+    json.field("name", name);
+    json.field("path", path);
+    json.field("type", "image");
+    json.field("size", (uint32_t)UINT32_MAX);
+    json.endObject();
+  }
+  json.endArray();
+  json.field("returned", 64);
+  json.field("truncated", true);
+  json.field("nextCursor", "g4294967295-119");
+  json.endObject();
+  json.endObject();
+  const bool ok = json.finish();
+  heapEnd();
+  report("sd_list_response", json.bytesWritten(), json.fragments());
+
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_EQUAL_UINT32(0, heapAllocs);
+  TEST_ASSERT_FALSE(received.badSequence);
+  TEST_ASSERT_TRUE(received.sawFin);
+  TEST_ASSERT_EQUAL_UINT32(json.fragments(), received.fragments);
+  TEST_ASSERT_GREATER_THAN(WS_JSON_FRAGMENT_BYTES * 4, json.bytesWritten());
+  TEST_ASSERT_EQUAL_UINT32(json.bytesWritten(), received.len);
+  TEST_ASSERT_TRUE(isWellFormed(received.text));
+  TEST_ASSERT_GREATER_OR_EQUAL(json.bytesWritten(), ws_json_peak_bytes);
+}
+
+// sendVoiceStreamStop(): streamed directly, one fragment.
+static void test_voice_stream_stop()
+{
+  heapBegin();
+  WsJsonWriter json(socket);
+  json.beginObject();
+  json.field("type", "voice_stream_stop");
+  json.beginObject("data");
+  json.field("deviceId", "esp32_s3_001");
+  json.field("streamId", "vs-4294967295-ffffffff");
+  json.field("reason", "No speech detected");
+  json.field("chunksSent", (uint32_t)UINT32_MAX);
+  json.field("bytesSent", (uint32_t)UINT32_MAX);
+  json.field("format", "ima_adpcm");
+  json.field("encodeUsAvg", (uint32_t)UINT32_MAX);
+  json.field("encodeUsMax", (uint32_t)UINT32_MAX);
+  json.field("vadFrames", (uint32_t)UINT32_MAX);
+  json.field("speechFrames", (uint32_t)UINT32_MAX);
+  json.field("segments", (uint32_t)UINT32_MAX);
+  json.field("vadUsAvg", (uint32_t)UINT32_MAX);
+  json.field("timestamp", (uint32_t)UINT32_MAX);
+  json.endObject();
+  json.endObject();
+  const bool ok = json.finish();
+  heapEnd();
+  report("voice_stream_stop", json.bytesWritten(), json.fragments());
+
+  TEST_ASSERT_TRUE(ok);
+  TEST_ASSERT_EQUAL_UINT32(0, heapAllocs);
+  TEST_ASSERT_EQUAL_UINT32(1, received.fragments);
+  TEST_ASSERT_TRUE(isWellFormed(received.text));
+}
+
+// Queued telemetry has to fit one outbox slot or it is dropped.
+static void commitQueued(const char *type, WsOutboxSlot *slot, WsJsonWriter &json)
+{
+  const bool ok = wsOutboxCommit(slot, json);
+  heapEnd();
+  report(type, json.bytesWritten(), 1);
+  TEST_ASSERT_TRUE_MESSAGE(ok, "message does not fit WS_OUTBOX_SLOT_BYTES");
+  TEST_ASSERT_EQUAL_UINT32(0, heapAllocs);
+
+  wsOutboxDrain(socket);
+  TEST_ASSERT_EQUAL_UINT32(1, received.fragments);
+  TEST_ASSERT_TRUE(received.sawFin);
+  TEST_ASSERT_TRUE(isWellFormed(received.text));
+}
+
+// sendHeartbeat()
+static void test_heartbeat_fits_slot()
+{
+  heapBegin();
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_TELEMETRY, 1);
+  TEST_ASSERT_NOT_NULL(slot);
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  json.beginObject();
+  json.field("type", "heartbeat");
+  json.beginObject("data");
+  json.field("deviceId", "esp32_s3_001");
+  const char *const counters[] = {"uptime", "jsonPeakBytes", "jsonPeakFragments", "txQueuePeak", "txDropped",
+                                  "txCoalesced", "txDeferredLoops", "statsFrames", "statsGaps", "rxCompressedFrames",
+                                  "rxCompressedRawBytes", "rxCompressedWireBytes", "rxDecodeUs", "uiPagesBytes",
+                                  "uiWidgetWrites", "uiWidgetSkipped"};
+  json.field("wifiSignal", -127);
+  json.field("txQueueDepth", 65535);
+  json.field("uiPagesResident", 255);
+  for (const char *key : counters) {
+    json.field(key, (uint32_t)UINT32_MAX);
+  }
+  json.endObject();
+  json.endObject();
+  commitQueued("heartbeat", slot, json);
+}
+
+// sendPhotoFrameState()
+static void test_photo_state_fits_slot()
+{
+  heapBegin();
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_TELEMETRY, 2);
+  TEST_ASSERT_NOT_NULL(slot);
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  char name[64];
+  memset(name, '\"', sizeof(name) - 1);    // every byte escaped
+  name[sizeof(name) - 1] = '\0';
+  json.beginObject();
+  json.field("type", "photo_state");
+  json.beginObject("data");
+  json.field("deviceId", "esp32_s3_001");
+  json.field("reason", "remote_control");
+  json.field("pageActive", true);
+  json.field("sdMounted", true);
+  json.field("total", 20);
+  json.field("index", 20);
+  json.field("autoPlay", true);
+  json.field("slideshowInterval", 65535);
+  json.field("theme", "dark-gallery-xxxxxxxxxx");
+  json.field("settingsSynced", true);
+  json.field("currentPhoto", name);
+  json.field("decoder", "rgb565");
+  json.field("valid", true);
+  json.field("maxPhotoCount", 65535);
+  json.field("skippedByLimit", 65535);
+  json.field("uptime", (uint32_t)UINT32_MAX);
+  json.endObject();
+  json.endObject();
+  commitQueued("photo_state", slot, json);
+}
+
+static bool queueState(uint8_t key, int value, size_t padding)
+{
+  WsOutboxSlot *slot = wsOutboxAcquire(WS_CLASS_TELEMETRY, key);
+  TEST_ASSERT_NOT_NULL(slot);
+  WsJsonWriter json(wsOutboxPayload(slot), WS_OUTBOX_SLOT_BYTES);
+  char pad[WS_OUTBOX_SLOT_BYTES + 1];
+  memset(pad, 'x', padding);
+  pad[padding] = '\0';
+  json.beginObject();
+  json.field("type", "state");
+  json.field("value", value);
+  json.field("pad", pad);
+  json.endObject();
+  return wsOutboxCommit(slot, json);
+}
+
+// A newer message with the same key replaces the queued one in its queue
+// position; one that does not fit the slot is dropped on its own.
+static void test_coalesce_keeps_queued_message_on_overflow()
+{
+  TEST_ASSERT_TRUE(queueState(3, 1, 0));
+  TEST_ASSERT_TRUE(queueState(4, 9, 0));
+  TEST_ASSERT_FALSE(queueState(3, 2, WS_OUTBOX_SLOT_BYTES));
+  TEST_ASSERT_EQUAL_UINT32(0, ws_outbox_stats.coalesced);
+  TEST_ASSERT_EQUAL_UINT32(1, ws_outbox_stats.dropped[WS_CLASS_TELEMETRY]);
+  TEST_ASSERT_EQUAL_UINT32(2, ws_outbox_stats.depth[WS_CLASS_TELEMETRY]);
+  WsOutboxSlot *oldest = wsOutboxOldestReady(WS_CLASS_TELEMETRY);
+  TEST_ASSERT_NOT_NULL(oldest);
+  TEST_ASSERT_EQUAL_UINT8(3, oldest->key);
+  TEST_ASSERT_TRUE(strstr((const char *)wsOutboxPayload(oldest), "\"value\":1") != nullptr);
+
+  TEST_ASSERT_TRUE(queueState(3, 2, 0));
+  TEST_ASSERT_EQUAL_UINT32(1, ws_outbox_stats.coalesced);
+  TEST_ASSERT_EQUAL_UINT32(2, ws_outbox_stats.depth[WS_CLASS_TELEMETRY]);
+  oldest = wsOutboxOldestReady(WS_CLASS_TELEMETRY);
+  TEST_ASSERT_EQUAL_UINT8(3, oldest->key);
+  const uint16_t len = oldest->len;
+  wsOutboxDrain(socket);
+  TEST_ASSERT_EQUAL_UINT32(2, received.fragments);
+  TEST_ASSERT_EQUAL_UINT32(len, strchr(received.text, '}') - received.text + 1);
+  TEST_ASSERT_TRUE(strstr(received.text, "\"value\":2") != nullptr);
+  TEST_ASSERT_EQUAL_UINT32(0, wsOutboxDepth());
+}
+
+int main()
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_fields_and_escapes);
+  RUN_TEST(test_buffer_overflow_fails_message);
+  RUN_TEST(test_sd_list_response);
+  RUN_TEST(test_voice_stream_stop);
+  RUN_TEST(test_heartbeat_fits_slot);
+  RUN_TEST(test_photo_state_fits_slot);
+  RUN_TEST(test_coalesce_keeps_queued_message_on_overflow);
+  return UNITY_END();
+}